@@ -0,0 +1,66 @@
+// BenchFramework.h - Self-registering micro-benchmarks for the portable modules (no dependencies)
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// A benchmark is a function registered under a suite name that times its own loops
+// and prints one Report line per result. In quick mode (--quick, used by ctest) it
+// should shrink its sizes so the whole suite just proves it still runs.
+struct Benchmark {
+    const char* suite;
+    const char* name;
+    void (*run)();
+};
+
+class BenchRegistry {
+public:
+    static std::vector<Benchmark>& GetBenchmarks();
+    static int Register(const char* suite, const char* name, void (*run)());
+    
+    static bool IsQuick();
+    static void SetQuick(bool quick);
+    
+    // Pick the full or the quick value of a size or iteration count
+    static int Scale(int full, int quick) { return IsQuick() ? quick : full; }
+    
+    // One result line: label, value and unit, aligned with the others
+    static void Report(const std::string& label, double value, const char* unit);
+    
+    // Directory of the source tree, for benchmarks that read files from data/
+    static std::string GetSourceDir();
+};
+
+// Best (least disturbed) wall time of repeats calls of work, in seconds
+template <typename Work>
+double TimeBest(int repeats, Work&& work) {
+    double best = 0;
+    for (int i = 0; i < repeats; i++) {
+        auto start = std::chrono::steady_clock::now();
+        work();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+// Keep a computed value alive so the optimizer cannot drop the work producing it. The
+// value's address escapes into an empty asm statement that may read all memory; MSVC has
+// no inline asm on x64, so there it is read through a volatile pointer instead.
+template <typename T>
+void KeepAlive(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    const volatile char* bytes = reinterpret_cast<const volatile char*>(&value);
+    (void)bytes[0];
+#endif
+}
+
+#define BENCHMARK(suite, name) \
+    static void suite##_##name(); \
+    static const int suite##_##name##_registered = BenchRegistry::Register(#suite, #name, suite##_##name); \
+    static void suite##_##name()
@@ -0,0 +1,68 @@
+// BenchMain.cpp - Runs the registered benchmarks, optionally only some suites
+//
+// Usage: launcher_bench [--quick] [suite...]
+#include "BenchFramework.h"
+#include <cstdio>
+#include <cstring>
+
+#ifndef LAUNCHER_SOURCE_DIR
+#define LAUNCHER_SOURCE_DIR "."
+#endif
+
+namespace {
+    bool quickMode = false;
+}
+
+std::vector<Benchmark>& BenchRegistry::GetBenchmarks() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+int BenchRegistry::Register(const char* suite, const char* name, void (*run)()) {
+    GetBenchmarks().push_back({suite, name, run});
+    return 0;
+}
+
+bool BenchRegistry::IsQuick() {
+    return quickMode;
+}
+
+void BenchRegistry::SetQuick(bool quick) {
+    quickMode = quick;
+}
+
+void BenchRegistry::Report(const std::string& label, double value, const char* unit) {
+    std::printf("  %-44s %12.3f %s\n", label.c_str(), value, unit);
+    std::fflush(stdout);
+}
+
+std::string BenchRegistry::GetSourceDir() {
+    return LAUNCHER_SOURCE_DIR;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<const char*> suites;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            BenchRegistry::SetQuick(true);
+        } else {
+            suites.push_back(argv[i]);
+        }
+    }
+    
+    int run = 0;
+    for (const Benchmark& benchmark : BenchRegistry::GetBenchmarks()) {
+        bool selected = suites.empty();
+        for (size_t i = 0; i < suites.size() && !selected; i++) {
+            selected = std::strcmp(suites[i], benchmark.suite) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+        
+        std::printf("%s.%s\n", benchmark.suite, benchmark.name);
+        benchmark.run();
+        run++;
+    }
+    return run > 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+// CatalogBench.cpp - Cold start from the catalog against a full rescan, on 10k shortcuts
+//
+// Startup with a valid catalog reads one file and builds the model from it (as
+// LoadCatalog does), where without one every .lnk is parsed and every icon decoded.
+#include "BenchFramework.h"
+#include "ShortcutCatalog.h"
+#include "SyntheticLibrary.h"
+#include "WorkerPool.h"
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+    const int TARGET_SIZE = 192;   // 256 * IconScale 0.75
+    
+    // The catalog a finished scan would save: one tab per folder, in scan order
+    std::vector<uint8_t> WriteCatalog(const std::vector<ScannedShortcut>& shortcuts) {
+        CatalogWriter writer;
+        fs::path currentFolder;
+        for (const ScannedShortcut& scanned : shortcuts) {
+            fs::path folder = fs::path(scanned.shortcutPath).parent_path();
+            if (folder != currentFolder) {
+                writer.AddTab(folder.filename().wstring(), folder.wstring());
+                currentFolder = folder;
+            }
+            CatalogShortcut shortcut;
+            shortcut.shortcutPath = scanned.shortcutPath;
+            shortcut.displayName = scanned.displayName;
+            shortcut.targetPath = scanned.targetPath;
+            shortcut.arguments = scanned.arguments;
+            shortcut.workingDirectory = scanned.workingDirectory;
+            shortcut.iconPath = scanned.iconPath;
+            shortcut.iconIndex = scanned.iconIndex;
+            shortcut.isValid = scanned.parsed;
+            shortcut.fileSize = scanned.fileSize;
+            writer.AddShortcut(shortcut);
+        }
+        return writer.Finish();
+    }
+    
+    // Read, validate and materialize every string, as LoadCatalog builds the tabs
+    size_t LoadCatalog(const fs::path& path) {
+        std::vector<uint8_t> data = SyntheticLibrary::ReadFile(path);
+        ShortcutCatalog catalog;
+        if (!catalog.Open(data.data(), data.size())) {
+            return 0;
+        }
+        std::vector<ScannedShortcut> shortcuts(catalog.GetShortcutCount());
+        for (uint32_t i = 0; i < catalog.GetShortcutCount(); i++) {
+            CatalogShortcutView view = catalog.GetShortcut(i);
+            ScannedShortcut& shortcut = shortcuts[i];
+            shortcut.shortcutPath = view.shortcutPath.ToWString();
+            shortcut.displayName = view.displayName.ToWString();
+            shortcut.targetPath = view.targetPath.ToWString();
+            shortcut.arguments = view.arguments.ToWString();
+            shortcut.workingDirectory = view.workingDirectory.ToWString();
+            shortcut.iconPath = view.iconPath.ToWString();
+            shortcut.iconIndex = view.iconIndex;
+            shortcut.parsed = view.isValid;
+        }
+        return shortcuts.size();
+    }
+}
+
+BENCHMARK(Catalog, ColdStart) {
+    int folderCount = BenchRegistry::Scale(10, 2);
+    int perFolder = BenchRegistry::Scale(1000, 25);
+    fs::path root = SyntheticLibrary::Build("launcher_catalog_bench", folderCount, perFolder);
+    size_t total = static_cast<size_t>(folderCount) * perFolder;
+    WorkerPool pool(0);
+    
+    double lnkSeconds = TimeBest(BenchRegistry::Scale(3, 1), [&]() {
+        KeepAlive(SyntheticLibrary::Scan(root, pool, false, TARGET_SIZE).size());
+    });
+    std::vector<ScannedShortcut> scanned;
+    double fullSeconds = TimeBest(1, [&]() {
+        scanned = SyntheticLibrary::Scan(root, pool, true, TARGET_SIZE);
+    });
+    
+    std::vector<uint8_t> catalog = WriteCatalog(scanned);
+    fs::path catalogPath = root / "catalog.bin";
+    {
+        std::ofstream file(catalogPath, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(catalog.data()), static_cast<std::streamsize>(catalog.size()));
+    }
+    size_t loaded = 0;
+    double catalogSeconds = TimeBest(BenchRegistry::Scale(20, 3), [&]() {
+        loaded = LoadCatalog(catalogPath);
+    });
+    if (loaded != total) {
+        BenchRegistry::Report("shortcuts lost by the catalog", static_cast<double>(total) - loaded, "");
+    }
+    
+    BenchRegistry::Report("catalog size", catalog.size() / 1024.0, "KiB");
+    BenchRegistry::Report("catalog load", catalogSeconds * 1e3, "ms");
+    BenchRegistry::Report("rescan, shortcuts only", lnkSeconds * 1e3, "ms");
+    BenchRegistry::Report("rescan with icons", fullSeconds * 1e3, "ms");
+    BenchRegistry::Report("catalog speedup over shortcut rescan", lnkSeconds / catalogSeconds, "x");
+    
+    fs::remove_all(root);
+}
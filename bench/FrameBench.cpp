@@ -0,0 +1,164 @@
+// FrameBench.cpp - Whole frames through the headless renderer: tab size, threads and selection
+#include "BenchFramework.h"
+#include "FrameBenchmark.h"
+#include "HeadlessRenderer.h"
+#include "Settings.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    int GetIconSize() {
+        return static_cast<int>(DesignConstants::TARGET_ICON_SIZE_PIXELS * Settings::Instance().GetIconScale());
+    }
+    
+    // One tab of count shortcuts. Only the first withIcons get icon pixels (256 KB each);
+    // the rest are named placeholders, so huge tabs fit in memory.
+    void BuildTab(int count, int withIcons, std::vector<TabInfo>& tabs) {
+        FrameBenchmark::BuildTabs({std::min(count, withIcons)}, GetIconSize(), tabs);
+        std::vector<ShortcutInfo>& shortcuts = tabs[0].shortcuts;
+        for (int i = static_cast<int>(shortcuts.size()); i < count; i++) {
+            shortcuts.emplace_back();
+            shortcuts.back().displayName = L"Shortcut " + std::to_wstring(i);
+            shortcuts.back().isValid = true;
+        }
+    }
+    
+    std::string Count(int count) {
+        return std::to_string(count);
+    }
+}
+
+// Paint cost against tab size. Every size shows the same first screen of icons, so a
+// renderer that only touches visible items takes the same time at 100 or 100k items.
+BENCHMARK(Frame, LargeTab) {
+    int width = BenchRegistry::Scale(1920, 640);
+    int height = BenchRegistry::Scale(1080, 400);
+    int frames = BenchRegistry::Scale(20, 2);
+    std::vector<int> counts = {100, 1000, 10000, BenchRegistry::Scale(100000, 20000)};
+    
+    double smallest = 0;
+    double largest = 0;
+    for (int count : counts) {
+        std::vector<TabInfo> tabs;
+        BuildTab(count, 64, tabs);
+        HeadlessRenderer renderer;
+        renderer.SetSize(width, height);
+        renderer.Render(renderer.MakeState(tabs, 0, 0, 0, 1.0f));
+        
+        double full = TimeBest(frames, [&]() {
+            renderer.InvalidateAll();
+            renderer.Render(renderer.MakeState(tabs, 0, 0, 0, 1.0f));
+        });
+        BenchRegistry::Report("full repaint, " + Count(count) + " items", full * 1e3, "ms");
+        
+        // Wheel notches down and back within the first screen: blit plus exposed band
+        int scrollOffset = 0;
+        int step = 48;
+        double scroll = TimeBest(frames, [&]() {
+            step = scrollOffset + step > height / 2 || scrollOffset + step < 0 ? -step : step;
+            scrollOffset += step;
+            FrameState state = renderer.MakeState(tabs, 0, scrollOffset, 0, 1.0f);
+            renderer.Scroll(state, step);
+            renderer.Render(state);
+        });
+        BenchRegistry::Report("scroll frame, " + Count(count) + " items", scroll * 1e3, "ms");
+        
+        if (count == counts.front()) {
+            smallest = full;
+        }
+        largest = full;
+    }
+    BenchRegistry::Report("full repaint, largest / smallest tab", largest / smallest, "x");
+}
+
+// Full repaints of a 4K window at 200% DPI, as WM_SIZE causes, split into tiles over
+// 1, 2, 4, ... workers up to the core count. Every count must paint the same frame.
+BENCHMARK(Frame, Threads) {
+    int width = BenchRegistry::Scale(3840, 960);
+    int height = BenchRegistry::Scale(2160, 540);
+    int frames = BenchRegistry::Scale(10, 2);
+    std::vector<TabInfo> tabs;
+    BuildTab(120, 120, tabs);
+    
+    size_t cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < cores; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+    
+    double single = 0;
+    std::vector<uint32_t> reference;
+    for (size_t threads : threadCounts) {
+        HeadlessRenderer renderer;
+        renderer.GetComposer().SetRenderThreadCount(threads);
+        renderer.SetSize(width, height);
+        FrameState state = renderer.MakeState(tabs, 0, 0, 0, 2.0f);
+        renderer.Render(state);
+        
+        double seconds = TimeBest(frames, [&]() {
+            renderer.InvalidateAll();
+            renderer.Render(state);
+        });
+        
+        RasterImage frame = renderer.GetFrame();
+        std::vector<uint32_t> pixels(frame.pixels, frame.pixels + static_cast<size_t>(frame.stride) * frame.height);
+        if (reference.empty()) {
+            reference = pixels;
+        } else if (pixels != reference) {
+            BenchRegistry::Report("frame differs from 1 thread, threads", static_cast<double>(threads), "");
+        }
+        if (threads == 1) {
+            single = seconds;
+        }
+        std::string label = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+        BenchRegistry::Report(label + " full repaint", seconds * 1e3, "ms");
+        BenchRegistry::Report(label + " speedup", single / seconds, "x");
+    }
+}
+
+// D-pad selection moves at 4K: the old and new icon outlines repainted. Without the
+// content layer the icons and labels under them are drawn again; with it they are
+// copied back from the layer and only the border is drawn.
+BENCHMARK(Frame, Selection) {
+    int width = BenchRegistry::Scale(3840, 960);
+    int height = BenchRegistry::Scale(2160, 540);
+    int moves = BenchRegistry::Scale(200, 10);
+    std::vector<TabInfo> tabs;
+    BuildTab(60, 60, tabs);
+    
+    double withoutLayer = 0;
+    for (int layer = 0; layer < 2; layer++) {
+        HeadlessRenderer renderer;
+        renderer.GetComposer().SetContentLayerEnabled(layer != 0);
+        renderer.SetSize(width, height);
+        int selected = 0;
+        renderer.Render(renderer.MakeState(tabs, 0, 0, selected, 1.0f));
+        
+        // Walk right along the first rows, like holding the D-pad
+        std::vector<double> times;
+        for (int move = 0; move < moves; move++) {
+            auto start = std::chrono::steady_clock::now();
+            renderer.InvalidateIcon(renderer.MakeState(tabs, 0, 0, selected, 1.0f), selected);
+            selected = (selected + 1) % 24;
+            FrameState state = renderer.MakeState(tabs, 0, 0, selected, 1.0f);
+            renderer.InvalidateIcon(state, selected);
+            renderer.Render(state);
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        double median = times[times.size() / 2];
+        
+        const char* label = layer ? "with content layer" : "without content layer";
+        BenchRegistry::Report(std::string("selection move p50, ") + label, median, "ms");
+        BenchRegistry::Report(std::string("selection move p90, ") + label, times[times.size() * 9 / 10], "ms");
+        if (layer) {
+            BenchRegistry::Report("selection move, layer speedup", withoutLayer / median, "x");
+        } else {
+            withoutLayer = median;
+        }
+    }
+}
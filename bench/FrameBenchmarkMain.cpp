@@ -0,0 +1,25 @@
+// FrameBenchmarkMain.cpp - The launcher's --benchmark mode as a standalone tool
+//
+// Usage: frame_benchmark [--size WxH] [--dpi percent] [--frames n] [--shortcuts n]
+//                        [--no-atlas] [--no-layer] [--dump folder] [--report file] [--replay file]
+#include "FrameBenchmark.h"
+#include <clocale>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    // Arguments arrive in the locale's multibyte encoding
+    std::setlocale(LC_CTYPE, "");
+    std::vector<std::wstring> args = {L"frame_benchmark", L"--benchmark"};
+    for (int i = 1; i < argc; i++) {
+        std::wstring arg(std::mbstowcs(nullptr, argv[i], 0) + 1, L'\0');
+        size_t length = std::mbstowcs(&arg[0], argv[i], arg.size());
+        arg.resize(length == static_cast<size_t>(-1) ? 0 : length);
+        args.push_back(arg);
+    }
+    
+    FrameBenchmarkOptions options;
+    FrameBenchmark::ParseCommandLine(args, options);
+    return FrameBenchmark::WriteReport(options, FrameBenchmark::Run(options)) ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+// GridLayoutBench.cpp - Hover hit tests on a large tab, constant time against the linear scan
+#include "BenchFramework.h"
+#include "GridLayout.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Point {
+        int x;
+        int y;
+        int scrollOffset;
+    };
+    
+    // The launcher at 100% DPI in a 1080p window
+    GridLayout MakeLayout(int count) {
+        GridMetrics metrics;
+        metrics.iconSize = 256;
+        metrics.spacingHorizontal = 12;
+        metrics.spacingVertical = 20;
+        metrics.labelHeight = 92;
+        metrics.verticalPadding = 10;
+        metrics.borderPadding = 4;
+        metrics.borderExtension = 5;
+        return GridLayout(PixelRect(24, 64, 1896, 1056), count, metrics);
+    }
+    
+    // Mouse positions spread over the whole scroll range, as a WM_MOUSEMOVE stream sees
+    std::vector<Point> MakePoints(const GridLayout& layout, int count) {
+        std::mt19937 random(23);
+        const PixelRect& area = layout.GetArea();
+        std::vector<Point> points(count);
+        for (Point& point : points) {
+            point.x = area.left + static_cast<int>(random() % area.Width());
+            point.y = area.top + static_cast<int>(random() % area.Height());
+            point.scrollOffset = static_cast<int>(random() % (layout.GetMaxScroll() + 1));
+        }
+        return points;
+    }
+    
+    // How hover worked before GridLayout: every item's icon and label tested in turn
+    int LinearHitTest(const GridLayout& layout, const Point& point) {
+        const GridMetrics& metrics = layout.GetMetrics();
+        for (int i = 0; i < layout.GetItemCount(); i++) {
+            PixelRect hit = layout.IndexToRect(i, point.scrollOffset);
+            hit.bottom += metrics.labelHeight + metrics.borderPadding;
+            if (point.x >= hit.left && point.x < hit.right && point.y >= hit.top && point.y < hit.bottom) {
+                return i;
+            }
+        }
+        return -1;
+    }
+}
+
+// One hover hit test on a 10k item tab. PointToIndex is a few divisions whatever the
+// tab size; the linear scan it replaced averages half the items per mouse move.
+BENCHMARK(GridLayout, HoverHitTest) {
+    int count = BenchRegistry::Scale(10000, 2000);
+    int moves = BenchRegistry::Scale(100000, 1000);
+    int scannedMoves = BenchRegistry::Scale(2000, 100);
+    GridLayout layout = MakeLayout(count);
+    std::vector<Point> points = MakePoints(layout, moves);
+    
+    int hits = 0;
+    double direct = TimeBest(5, [&]() {
+        for (const Point& point : points) {
+            hits += layout.PointToIndex(point.x, point.y, point.scrollOffset) >= 0;
+        }
+    });
+    double scanned = TimeBest(3, [&]() {
+        for (int i = 0; i < scannedMoves; i++) {
+            hits += LinearHitTest(layout, points[i]) >= 0;
+        }
+    });
+    KeepAlive(hits);
+    
+    double directNs = direct / moves * 1e9;
+    double scannedNs = scanned / scannedMoves * 1e9;
+    BenchRegistry::Report("PointToIndex, " + std::to_string(count) + " items", directNs, "ns");
+    BenchRegistry::Report("linear scan, " + std::to_string(count) + " items", scannedNs, "ns");
+    BenchRegistry::Report("PointToIndex speedup", scannedNs / directNs, "x");
+}
@@ -0,0 +1,94 @@
+// IconCacheBench.cpp - Thumbnail cache hit against the miss path it saves
+//
+// A miss is what ProcessIcon does without the cache: read the .ico, decode the best
+// entry, resample to the display size, then Store. A hit is one Read into the bitmap.
+// Hits are served from the OS file cache here, as they are on a warm start.
+#include "BenchFramework.h"
+#include "IconCache.h"
+#include "IconDecoder.h"
+#include "SyntheticLibrary.h"
+#include "stb_image_resize2.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    std::vector<fs::path> DataIcons() {
+        std::vector<fs::path> icons;
+        for (const auto& folder : fs::directory_iterator(fs::path(BenchRegistry::GetSourceDir()) / "data")) {
+            if (fs::is_directory(folder.path() / "icons")) {
+                for (const auto& entry : fs::directory_iterator(folder.path() / "icons")) {
+                    icons.push_back(entry.path());
+                }
+            }
+        }
+        return icons;
+    }
+    
+    IconCacheKey MakeKey(const fs::path& icon, size_t index, int targetSize) {
+        IconCacheKey key;
+        key.sourcePath = L"data\\icons\\" + std::to_wstring(index) + L".ico";
+        key.sourceSize = fs::file_size(icon);
+        key.sourceWriteTime = static_cast<uint64_t>(fs::last_write_time(icon).time_since_epoch().count());
+        key.targetSize = targetSize;
+        return key;
+    }
+    
+    bool ExtractAndScale(const fs::path& icon, int targetSize, std::vector<uint32_t>& thumbnail) {
+        std::vector<uint8_t> data = SyntheticLibrary::ReadFile(icon);
+        DecodedImage decoded;
+        if (!IconDecoder::DecodeIco(data.data(), data.size(), targetSize, decoded)) {
+            return false;
+        }
+        stbir_resize_uint8_linear(
+            reinterpret_cast<const unsigned char*>(decoded.pixels.data()), decoded.width, decoded.height, decoded.width * 4,
+            reinterpret_cast<unsigned char*>(thumbnail.data()), targetSize, targetSize, targetSize * 4,
+            STBIR_RGBA_PM);
+        return true;
+    }
+}
+
+// Per icon at IconScale 0.75, 1 and 2 (192, 256 and 512 px thumbnails)
+BENCHMARK(IconCache, HitVersusMiss) {
+    std::vector<fs::path> icons = DataIcons();
+    if (BenchRegistry::IsQuick() && icons.size() > 4) {
+        icons.resize(4);
+    }
+    fs::path path = fs::temp_directory_path() / "launcher_iconcache_bench.bin";
+    
+    for (int targetSize : {192, 256, 512}) {
+        fs::remove(path);
+        IconCache cache;
+        if (!cache.Open(path.wstring(), 1024ULL * 1024 * 1024)) {
+            BenchRegistry::Report("cache file could not be opened", 0, "");
+            return;
+        }
+        std::vector<uint32_t> thumbnail(static_cast<size_t>(targetSize) * targetSize);
+        
+        // The miss path, ending in the Store that makes the next start a hit
+        double missSeconds = TimeBest(BenchRegistry::Scale(3, 1), [&]() {
+            for (size_t i = 0; i < icons.size(); i++) {
+                if (ExtractAndScale(icons[i], targetSize, thumbnail)) {
+                    cache.Store(MakeKey(icons[i], i, targetSize), thumbnail.data());
+                }
+            }
+        });
+        cache.Flush();
+        
+        size_t hits = 0;
+        double hitSeconds = TimeBest(BenchRegistry::Scale(20, 2), [&]() {
+            hits = 0;
+            for (size_t i = 0; i < icons.size(); i++) {
+                hits += cache.Read(MakeKey(icons[i], i, targetSize), thumbnail.data()) ? 1 : 0;
+            }
+        });
+        if (hits != icons.size()) {
+            BenchRegistry::Report("icons missing from the cache", static_cast<double>(icons.size() - hits), "");
+        }
+        
+        std::string label = std::to_string(targetSize) + "px";
+        BenchRegistry::Report(label + " miss (decode, resample, store)", missSeconds / icons.size() * 1e6, "us/icon");
+        BenchRegistry::Report(label + " hit", hitSeconds / icons.size() * 1e6, "us/icon");
+        BenchRegistry::Report(label + " hit speedup", missSeconds / hitSeconds, "x");
+    }
+    fs::remove(path);
+}
@@ -0,0 +1,123 @@
+// IconDecoderBench.cpp - Icon decode throughput on the data/ icons
+#include "BenchFramework.h"
+#include "IconDecoder.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+namespace {
+    std::vector<std::vector<uint8_t>> LoadDataIcons() {
+        std::vector<std::vector<uint8_t>> icons;
+        for (const auto& folder : fs::directory_iterator(fs::path(BenchRegistry::GetSourceDir()) / "data")) {
+            if (!fs::is_directory(folder.path() / "icons")) {
+                continue;
+            }
+            for (const auto& entry : fs::directory_iterator(folder.path() / "icons")) {
+                std::ifstream file(entry.path(), std::ios::binary);
+                icons.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            }
+        }
+        return icons;
+    }
+    
+    void PutLe16(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+    
+    void PutLe32(std::vector<uint8_t>& out, uint32_t value) {
+        PutLe16(out, value & 0xFFFF);
+        PutLe16(out, value >> 16);
+    }
+    
+    // An opaque 32 bpp DIB entry with its AND mask
+    std::vector<uint8_t> MakeDib(int size) {
+        std::vector<uint8_t> out;
+        uint32_t header[10] = {40, static_cast<uint32_t>(size), static_cast<uint32_t>(size) * 2, 1 | (32 << 16)};
+        for (uint32_t field : header) {
+            PutLe32(out, field);
+        }
+        for (int i = 0; i < size * size; i++) {
+            PutLe32(out, 0xFF000000 | (i * 2654435761u >> 8));
+        }
+        out.resize(out.size() + static_cast<size_t>((size + 31) / 32) * 4 * size, 0);
+        return out;
+    }
+    
+    // The typical multi-size layout: 16, 32 and 48 DIBs ahead of the 256 PNG of icon
+    std::vector<uint8_t> WithSmallEntries(const std::vector<uint8_t>& icon) {
+        const uint8_t* pngEntry = icon.data() + 6;
+        uint32_t pngSize = pngEntry[8] | (pngEntry[9] << 8) | (pngEntry[10] << 16) | (static_cast<uint32_t>(pngEntry[11]) << 24);
+        uint32_t pngOffset = pngEntry[12] | (pngEntry[13] << 8) | (pngEntry[14] << 16) | (static_cast<uint32_t>(pngEntry[15]) << 24);
+        
+        std::vector<std::vector<uint8_t>> images = {MakeDib(16), MakeDib(32), MakeDib(48),
+                                                    std::vector<uint8_t>(icon.begin() + pngOffset, icon.begin() + pngOffset + pngSize)};
+        const int sizes[4] = {16, 32, 48, 0};
+        std::vector<uint8_t> out;
+        PutLe16(out, 0);
+        PutLe16(out, 1);
+        PutLe16(out, 4);
+        size_t offset = 6 + 4 * 16;
+        for (int i = 0; i < 4; i++) {
+            out.push_back(static_cast<uint8_t>(sizes[i]));
+            out.push_back(static_cast<uint8_t>(sizes[i]));
+            PutLe16(out, 0);
+            PutLe16(out, 1);
+            PutLe16(out, 32);
+            PutLe32(out, static_cast<uint32_t>(images[i].size()));
+            PutLe32(out, static_cast<uint32_t>(offset));
+            offset += images[i].size();
+        }
+        for (const std::vector<uint8_t>& image : images) {
+            out.insert(out.end(), image.begin(), image.end());
+        }
+        return out;
+    }
+    
+    // Decode every icon at targetSize and report icons/s, with the input and output rates
+    void ReportDecode(const char* label, const std::vector<std::vector<uint8_t>>& icons, int targetSize) {
+        size_t inputBytes = 0;
+        size_t outputPixels = 0;
+        double seconds = TimeBest(BenchRegistry::Scale(5, 1), [&]() {
+            inputBytes = 0;
+            outputPixels = 0;
+            for (const std::vector<uint8_t>& icon : icons) {
+                DecodedImage image;
+                if (IconDecoder::DecodeIco(icon.data(), icon.size(), targetSize, image)) {
+                    outputPixels += image.pixels.size();
+                }
+                inputBytes += icon.size();
+                KeepAlive(image.pixels.data());
+            }
+        });
+        std::string name = label;
+        BenchRegistry::Report(name, icons.size() / seconds, "icons/s");
+        BenchRegistry::Report(name + " file bytes", inputBytes / seconds / 1e6, "MB/s");
+        BenchRegistry::Report(name + " output", outputPixels / seconds / 1e6, "Mpx/s");
+    }
+}
+
+// 256px PNG entries, the data/ icons as they are: inflate, unfilter and premultiply
+BENCHMARK(IconDecoder, Png256) {
+    std::vector<std::vector<uint8_t>> icons = LoadDataIcons();
+    if (BenchRegistry::IsQuick() && icons.size() > 4) {
+        icons.resize(4);
+    }
+    ReportDecode("256px png", icons, 256);
+}
+
+// Multi-size files: a small target decodes only its DIB entry and skips the PNG
+BENCHMARK(IconDecoder, EntrySelection) {
+    std::vector<std::vector<uint8_t>> icons;
+    for (const std::vector<uint8_t>& icon : LoadDataIcons()) {
+        icons.push_back(WithSmallEntries(icon));
+    }
+    if (BenchRegistry::IsQuick() && icons.size() > 4) {
+        icons.resize(4);
+    }
+    ReportDecode("target 32 (32px dib)", icons, 32);
+    ReportDecode("target 48 (48px dib)", icons, 48);
+    ReportDecode("target 96 (256px png)", icons, 96);
+}
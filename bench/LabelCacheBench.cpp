@@ -0,0 +1,122 @@
+// LabelCacheBench.cpp - Shadowed label building, and frames of cached labels against rebuilding them
+#include "BenchFramework.h"
+#include "DataModels.h"
+#include "LabelCache.h"
+#include "Raster.h"
+#include "TextRasterizer.h"
+#include <string>
+#include <vector>
+
+namespace {
+    const int BOX_WIDTH = 192;      // 256 * IconScale 0.75
+    const int BOX_HEIGHT = DesignConstants::LABEL_HEIGHT;
+    const int FONT_SIZE = 36;       // GridRenderer's label font at 100% DPI
+    
+    // Display names of the length the data/ shortcuts have, one or two lines when wrapped
+    std::vector<std::wstring> MakeNames(int count) {
+        const wchar_t* games[] = {L"Alien Isolation", L"Assassin's Creed Black Flag", L"Disco Elysium",
+                                  L"Fallout New Vegas", L"Mario Kart 8 Deluxe", L"Outer Wilds",
+                                  L"Star Trek - Judgment Rites", L"The Legend of Zelda - Tears of the Kingdom"};
+        std::vector<std::wstring> names;
+        for (int i = 0; i < count; i++) {
+            names.push_back(std::wstring(games[i % 8]) + L" " + std::to_wstring(i));
+        }
+        return names;
+    }
+    
+    LabelCache::RasterizeFunction MakeRasterizer(TextRasterizer& text) {
+        text.SetFont(FONT_SIZE, false);
+        return [&text](const std::wstring& name, int width, int height, std::vector<uint8_t>& coverage) {
+            return text.Rasterize(name, width, height, TextLayout::WrappedTop, coverage);
+        };
+    }
+}
+
+// One label miss: text into coverage, then the shadow composed and trimmed, as
+// LabelCache::Get does the first time a name is drawn
+BENCHMARK(LabelCache, BuildShadowedLabel) {
+    int count = BenchRegistry::Scale(2000, 50);
+    std::vector<std::wstring> names = MakeNames(count);
+    TextRasterizer text;
+    LabelCache::RasterizeFunction rasterize = MakeRasterizer(text);
+    
+    std::vector<std::vector<uint8_t>> coverages(count);
+    double rasterizeSeconds = TimeBest(3, [&]() {
+        for (int i = 0; i < count; i++) {
+            coverages[i].assign(static_cast<size_t>(BOX_WIDTH) * BOX_HEIGHT, 0);
+            rasterize(names[i], BOX_WIDTH, BOX_HEIGHT, coverages[i]);
+        }
+    });
+    
+    size_t pixels = 0;
+    double buildSeconds = TimeBest(3, [&]() {
+        pixels = 0;
+        for (int i = 0; i < count; i++) {
+            LabelBitmap label;
+            LabelCache::BuildShadowedLabel(coverages[i].data(), BOX_WIDTH, BOX_HEIGHT, label);
+            pixels += label.pixels.size();
+            KeepAlive(label.pixels.data());
+        }
+    });
+    KeepAlive(pixels);
+    
+    BenchRegistry::Report("rasterize text", count / rasterizeSeconds, "labels/s");
+    BenchRegistry::Report("build shadowed label", count / buildSeconds, "labels/s");
+    BenchRegistry::Report("label miss (both)", (rasterizeSeconds + buildSeconds) / count * 1e6, "us");
+    BenchRegistry::Report("trimmed label size", static_cast<double>(pixels) / count, "px");
+}
+
+// A 4K window of labels on an icon grid, each frame blending every label. With the
+// cache a frame only looks up and blends finished labels; rebuilding rasterizes and
+// shadows each one again, as labels were drawn before LabelCache.
+BENCHMARK(LabelCache, CompositeFrame) {
+    int width = BenchRegistry::Scale(3840, 960);
+    int height = BenchRegistry::Scale(2160, 540);
+    int frames = BenchRegistry::Scale(20, 2);
+    int cellWidth = BOX_WIDTH + DesignConstants::ICON_PADDING;
+    int cellHeight = BOX_WIDTH + DesignConstants::LABEL_SPACING + BOX_HEIGHT + DesignConstants::ICON_PADDING;
+    int columns = width / cellWidth;
+    int rows = height / cellHeight;
+    int count = columns * rows;
+    std::vector<std::wstring> names = MakeNames(count);
+    
+    std::vector<uint32_t> frame(static_cast<size_t>(width) * height);
+    RasterSurface surface{frame.data(), width, height, width};
+    TextRasterizer text;
+    LabelCache cache(MakeRasterizer(text));
+    
+    auto drawFrame = [&]() {
+        Raster::FillRect(surface, surface.Bounds(), 0xFF1C1C1E, surface.Bounds());
+        cache.SetLayout(FONT_SIZE, 100, BOX_WIDTH, BOX_HEIGHT);
+        for (int i = 0; i < count; i++) {
+            const LabelBitmap* label = cache.Get(names[i]);
+            if (!label) {
+                continue;
+            }
+            int x = (i % columns) * cellWidth + label->x;
+            int y = (i / columns) * cellHeight + BOX_WIDTH + DesignConstants::LABEL_SPACING + label->y;
+            RasterImage image{label->pixels.data(), label->width, label->height, label->width};
+            Raster::BlendOver(surface, x, y, image, surface.Bounds());
+        }
+    };
+    
+    drawFrame();
+    double cached = TimeBest(3, [&]() {
+        for (int f = 0; f < frames; f++) {
+            drawFrame();
+        }
+    });
+    double rebuilt = TimeBest(3, [&]() {
+        for (int f = 0; f < frames; f++) {
+            cache.Clear();
+            drawFrame();
+        }
+    });
+    KeepAlive(frame.data());
+    
+    std::string labels = std::to_string(count) + " labels";
+    BenchRegistry::Report("cached, " + labels, cached / frames * 1e3, "ms/frame");
+    BenchRegistry::Report("rebuilt every frame, " + labels, rebuilt / frames * 1e3, "ms/frame");
+    BenchRegistry::Report("cache speedup", rebuilt / cached, "x");
+    BenchRegistry::Report("cache memory", cache.GetMemoryUsage() / 1024.0, "KB");
+}
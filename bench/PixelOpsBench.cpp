@@ -0,0 +1,102 @@
+// PixelOpsBench.cpp - PixelOps kernels in Mpixels/s, per instruction set
+#include "BenchFramework.h"
+#include "PixelOps.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const PixelIsa ALL_ISAS[] = {PixelIsa::Scalar, PixelIsa::SSE2, PixelIsa::AVX2, PixelIsa::NEON};
+    
+    // Straight-alpha pixels with every alpha value, like decoded icons
+    std::vector<uint32_t> MakeStraight(size_t count) {
+        std::vector<uint32_t> pixels(count);
+        std::mt19937 random(42);
+        for (uint32_t& pixel : pixels) {
+            pixel = static_cast<uint32_t>(random());
+        }
+        return pixels;
+    }
+    
+    template <typename Work>
+    void ReportPerIsa(const std::string& label, double pixels, int repeats, Work&& work) {
+        PixelIsa detected = PixelOps::GetActiveIsa();
+        for (PixelIsa isa : ALL_ISAS) {
+            if (!PixelOps::SetActiveIsa(isa)) {
+                continue;
+            }
+            double seconds = TimeBest(repeats, work);
+            BenchRegistry::Report(label + " " + PixelOps::GetIsaName(isa), pixels / seconds / 1e6, "Mpx/s");
+        }
+        PixelOps::SetActiveIsa(detected);
+    }
+    
+    // Every kernel on count pixels, repeated until about total pixels have been processed
+    void RunKernels(const char* size, size_t count, size_t total) {
+        std::vector<uint32_t> straight = MakeStraight(count);
+        std::vector<uint32_t> premultiplied(count);
+        std::vector<uint32_t> dst(count);
+        PixelOps::Premultiply(straight.data(), premultiplied.data(), count);
+        size_t rounds = total / count ? total / count : 1;
+        double pixels = static_cast<double>(count) * rounds;
+        int repeats = BenchRegistry::Scale(5, 1);
+        std::string prefix = std::string(size) + " ";
+        
+        // The loop ShortcutScanner used before PixelOps, for comparison
+        double seconds = TimeBest(repeats, [&]() {
+            for (size_t round = 0; round < rounds; round++) {
+                for (size_t i = 0; i < count; i++) {
+                    uint32_t a = straight[i] >> 24;
+                    uint32_t r = ((straight[i] >> 16) & 0xFF) * a / 255;
+                    uint32_t g = ((straight[i] >> 8) & 0xFF) * a / 255;
+                    uint32_t b = (straight[i] & 0xFF) * a / 255;
+                    dst[i] = (a << 24) | (r << 16) | (g << 8) | b;
+                }
+                KeepAlive(dst.data());
+            }
+        });
+        BenchRegistry::Report(prefix + "premultiply, divide loop", pixels / seconds / 1e6, "Mpx/s");
+        
+        ReportPerIsa(prefix + "premultiply", pixels, repeats, [&]() {
+            for (size_t round = 0; round < rounds; round++) {
+                PixelOps::Premultiply(straight.data(), dst.data(), count);
+                KeepAlive(dst.data());
+            }
+        });
+        ReportPerIsa(prefix + "unpremultiply", pixels, repeats, [&]() {
+            for (size_t round = 0; round < rounds; round++) {
+                PixelOps::Unpremultiply(premultiplied.data(), dst.data(), count);
+                KeepAlive(dst.data());
+            }
+        });
+        ReportPerIsa(prefix + "blend over", pixels, repeats, [&]() {
+            for (size_t round = 0; round < rounds; round++) {
+                PixelOps::BlendOver(premultiplied.data(), dst.data(), count);
+                KeepAlive(dst.data());
+            }
+        });
+        ReportPerIsa(prefix + "blend opacity", pixels, repeats, [&]() {
+            for (size_t round = 0; round < rounds; round++) {
+                PixelOps::BlendOverOpacity(premultiplied.data(), dst.data(), count, 160);
+                KeepAlive(dst.data());
+            }
+        });
+        ReportPerIsa(prefix + "fill", pixels, repeats, [&]() {
+            for (size_t round = 0; round < rounds; round++) {
+                PixelOps::Fill(dst.data(), 0xFF202020, count);
+                KeepAlive(dst.data());
+            }
+        });
+    }
+}
+
+// One 256px icon at a time: the working set stays in cache, as when icons are decoded
+BENCHMARK(PixelOps, Icon) {
+    RunKernels("256px icon", 256 * 256, BenchRegistry::Scale(64, 4) * 256 * 256);
+}
+
+// A 4K frame streams through memory
+BENCHMARK(PixelOps, Frame) {
+    size_t count = BenchRegistry::Scale(3840 * 2160, 384 * 216);
+    RunKernels("4K frame", count, count * BenchRegistry::Scale(4, 1));
+}
@@ -0,0 +1,105 @@
+// RasterBench.cpp - Raster primitives at window sizes, per PixelOps instruction set
+#include "BenchFramework.h"
+#include "PixelOps.h"
+#include "Raster.h"
+#include <string>
+#include <vector>
+
+namespace {
+    const PixelIsa ALL_ISAS[] = {PixelIsa::Scalar, PixelIsa::SSE2, PixelIsa::AVX2, PixelIsa::NEON};
+    
+    // Premultiplied test pattern: alpha ramps so blends see every kind of pixel
+    std::vector<uint32_t> MakePattern(int width, int height) {
+        std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                uint32_t a = (x * 7 + y * 3) & 0xFF;
+                uint32_t c = PixelOps::MultiplyAlpha((x ^ y) & 0xFF, a);
+                pixels[static_cast<size_t>(y) * width + x] = (a << 24) | (c << 16) | (c << 8) | c;
+            }
+        }
+        return pixels;
+    }
+    
+    // Mpixels/s of work on pixels pixels per call, for every instruction set available
+    template <typename Work>
+    void ReportPerIsa(const char* label, double pixels, int repeats, Work&& work) {
+        PixelIsa detected = PixelOps::GetActiveIsa();
+        for (PixelIsa isa : ALL_ISAS) {
+            if (!PixelOps::SetActiveIsa(isa)) {
+                continue;
+            }
+            double seconds = TimeBest(repeats, work);
+            BenchRegistry::Report(std::string(label) + " " + PixelOps::GetIsaName(isa), pixels / seconds / 1e6, "Mpx/s");
+        }
+        PixelOps::SetActiveIsa(detected);
+    }
+}
+
+// A 4K frame: the clear and the full-window copy that a repaint starts with
+BENCHMARK(Raster, FullFrame) {
+    int width = BenchRegistry::Scale(3840, 384);
+    int height = BenchRegistry::Scale(2160, 216);
+    int repeats = BenchRegistry::Scale(20, 2);
+    std::vector<uint32_t> frame(static_cast<size_t>(width) * height);
+    std::vector<uint32_t> source = MakePattern(width, height);
+    RasterSurface surface{frame.data(), width, height, width};
+    RasterImage image{source.data(), width, height, width};
+    double pixels = static_cast<double>(width) * height;
+    
+    ReportPerIsa("fill", pixels, repeats, [&]() {
+        Raster::FillRect(surface, surface.Bounds(), 0xFF202020, surface.Bounds());
+    });
+    ReportPerIsa("copy", pixels, repeats, [&]() {
+        Raster::Copy(surface, 0, 0, image, surface.Bounds());
+    });
+    ReportPerIsa("blend", pixels, repeats, [&]() {
+        Raster::BlendOver(surface, 0, 0, image, surface.Bounds());
+    });
+    ReportPerIsa("blend opacity", pixels, repeats, [&]() {
+        Raster::BlendOpacity(surface, 0, 0, image, 160, surface.Bounds());
+    });
+}
+
+// 512px icons (256 * IconScale 2) blended into a 4K frame, as the grid draws them
+BENCHMARK(Raster, IconBlend) {
+    int width = BenchRegistry::Scale(3840, 768);
+    int height = BenchRegistry::Scale(2160, 512);
+    int iconSize = BenchRegistry::Scale(512, 128);
+    int repeats = BenchRegistry::Scale(20, 2);
+    std::vector<uint32_t> frame(static_cast<size_t>(width) * height, 0xFF202020);
+    std::vector<uint32_t> icon = MakePattern(iconSize, iconSize);
+    RasterSurface surface{frame.data(), width, height, width};
+    RasterImage image{icon.data(), iconSize, iconSize, iconSize};
+    
+    // Odd positions keep the rows unaligned, like icons in a centered grid
+    int columns = width / (iconSize + 13);
+    int rows = height / (iconSize + 13);
+    double pixels = static_cast<double>(columns) * rows * iconSize * iconSize;
+    ReportPerIsa("icon grid blend", pixels, repeats, [&]() {
+        for (int row = 0; row < rows; row++) {
+            for (int column = 0; column < columns; column++) {
+                Raster::BlendOver(surface, 7 + column * (iconSize + 13), 5 + row * (iconSize + 13), image, surface.Bounds());
+            }
+        }
+    });
+}
+
+// Selection borders: thin outlines are short rows, where per-row overhead shows
+BENCHMARK(Raster, Outline) {
+    int width = BenchRegistry::Scale(3840, 640);
+    int height = BenchRegistry::Scale(2160, 480);
+    int count = BenchRegistry::Scale(2000, 50);
+    std::vector<uint32_t> frame(static_cast<size_t>(width) * height);
+    RasterSurface surface{frame.data(), width, height, width};
+    PixelRect rect(100, 100, 100 + 560, 100 + 600);
+    if (rect.right > width || rect.bottom > height) {
+        rect = PixelRect(10, 10, width - 10, height - 10);
+    }
+    double pixels = static_cast<double>(count) * (rect.Width() + rect.Height()) * 2 * 4;
+    ReportPerIsa("4px outline", pixels, BenchRegistry::Scale(10, 2), [&]() {
+        for (int i = 0; i < count; i++) {
+            Raster::OutlineRect(surface, rect, 4, 0xFFFFFFFF, surface.Bounds());
+        }
+    });
+}
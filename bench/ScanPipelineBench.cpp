@@ -0,0 +1,53 @@
+// ScanPipelineBench.cpp - Scan pipeline throughput on a synthetic 10k-shortcut tree
+//
+// ShortcutScanner itself reads through Win32, so this runs the same stages on the same
+// portable parts (SyntheticLibrary::Scan) with 1 thread up to the core count.
+#include "BenchFramework.h"
+#include "SyntheticLibrary.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+    const int TARGET_SIZE = 192;   // 256 * IconScale 0.75: every icon is resampled
+}
+
+BENCHMARK(ScanPipeline, Threads) {
+    int folderCount = BenchRegistry::Scale(10, 2);
+    int perFolder = BenchRegistry::Scale(1000, 25);
+    fs::path root = SyntheticLibrary::Build("launcher_scan_bench", folderCount, perFolder);
+    size_t total = static_cast<size_t>(folderCount) * perFolder;
+    
+    // 1, 2, 4, ... up to the core count, and the core count itself
+    size_t cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < cores; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+    
+    double single = 0;
+    for (size_t threads : threadCounts) {
+        WorkerPool pool(threads);
+        size_t scanned = 0;
+        double seconds = TimeBest(1, [&]() {
+            scanned = 0;
+            for (const ScannedShortcut& shortcut : SyntheticLibrary::Scan(root, pool, true, TARGET_SIZE)) {
+                scanned += shortcut.parsed && !shortcut.icon.empty() ? 1 : 0;
+            }
+        });
+        if (scanned != total) {
+            BenchRegistry::Report("shortcuts lost by the scan", static_cast<double>(total - scanned), "");
+        }
+        if (threads == 1) {
+            single = seconds;
+        }
+        std::string label = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+        BenchRegistry::Report(label, total / seconds, "shortcuts/s");
+        BenchRegistry::Report(label + " speedup", single / seconds, "x");
+    }
+    
+    fs::remove_all(root);
+}
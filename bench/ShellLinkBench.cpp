@@ -0,0 +1,70 @@
+// ShellLinkBench.cpp - Shortcut parse throughput on the data/ links
+#include "BenchFramework.h"
+#include "ShellLinkReader.h"
+#include "SyntheticLibrary.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    std::vector<std::vector<uint8_t>> LoadDataLinks() {
+        std::vector<std::vector<uint8_t>> links;
+        for (const auto& folder : fs::directory_iterator(fs::path(BenchRegistry::GetSourceDir()) / "data")) {
+            if (!fs::is_directory(folder.path())) {
+                continue;
+            }
+            for (const auto& entry : fs::directory_iterator(folder.path())) {
+                if (entry.path().extension() == ".lnk") {
+                    links.push_back(SyntheticLibrary::ReadFile(entry.path()));
+                }
+            }
+        }
+        return links;
+    }
+}
+
+// Parse alone, then parse and widen the strings a scan keeps, as ShortcutParser does.
+// Reading the file is left out: this is the cost per shortcut once it is in memory.
+BENCHMARK(ShellLink, Parse) {
+    std::vector<std::vector<uint8_t>> links = LoadDataLinks();
+    int rounds = BenchRegistry::Scale(2000, 20);
+    size_t bytes = 0;
+    for (const std::vector<uint8_t>& link : links) {
+        bytes += link.size();
+    }
+    
+    int parsed = 0;
+    double parseOnly = TimeBest(5, [&]() {
+        for (int round = 0; round < rounds; round++) {
+            for (const std::vector<uint8_t>& data : links) {
+                ShellLinkData link;
+                parsed += ShellLinkReader::Parse(data.data(), data.size(), link);
+                KeepAlive(link.iconLocation.data);
+            }
+        }
+    });
+    size_t characters = 0;
+    double withStrings = TimeBest(5, [&]() {
+        for (int round = 0; round < rounds; round++) {
+            for (const std::vector<uint8_t>& data : links) {
+                ShellLinkData link;
+                if (!ShellLinkReader::Parse(data.data(), data.size(), link)) {
+                    continue;
+                }
+                std::wstring target = link.localBasePath.ToWString() + link.commonPathSuffix.ToWString();
+                std::wstring arguments = link.arguments.ToWString();
+                std::wstring workingDirectory = link.workingDirectory.ToWString();
+                std::wstring iconPath = link.iconEnvironmentPath.empty() ? link.iconLocation.ToWString()
+                                                                         : link.iconEnvironmentPath.ToWString();
+                characters += target.size() + arguments.size() + workingDirectory.size() + iconPath.size();
+            }
+        }
+    });
+    KeepAlive(parsed);
+    KeepAlive(characters);
+    
+    double count = static_cast<double>(links.size()) * rounds;
+    BenchRegistry::Report("parse, " + std::to_string(links.size()) + " links", count / parseOnly, "links/s");
+    BenchRegistry::Report("parse file bytes", bytes * static_cast<double>(rounds) / parseOnly / 1e6, "MB/s");
+    BenchRegistry::Report("parse and widen strings", count / withStrings, "links/s");
+    BenchRegistry::Report("parse and widen strings, per link", withStrings / count * 1e9, "ns");
+}
@@ -0,0 +1,39 @@
+// SyntheticLibrary.h - Large shortcut trees built from the data/ samples, and a portable scan of them
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class WorkerPool;
+
+// A shortcut as the scan pipeline produces it
+struct ScannedShortcut {
+    std::wstring shortcutPath;
+    std::wstring displayName;
+    std::wstring targetPath;
+    std::wstring arguments;
+    std::wstring workingDirectory;
+    std::wstring iconPath;
+    int32_t iconIndex = 0;
+    uint64_t fileSize = 0;
+    bool parsed = false;
+    std::vector<uint32_t> icon;     // Resampled icon, if icons were decoded
+};
+
+class SyntheticLibrary {
+public:
+    // folderCount tab folders of perFolder shortcuts each, copied round-robin from data/
+    // into a fresh directory under the temp path. Every shortcut has an icon file of its
+    // own name in the folder's icons/ (hard links where the file system allows).
+    static std::filesystem::path Build(const std::string& name, int folderCount, int perFolder);
+    
+    // ShortcutScanner's stages on portable parts: folders enumerated on the pool, then per
+    // shortcut read and parse the .lnk and, with decodeIcons, decode its .ico and resample
+    // it to iconSize. Results are in sorted folder and file order.
+    static std::vector<ScannedShortcut> Scan(const std::filesystem::path& root, WorkerPool& pool, bool decodeIcons,
+                                             int iconSize);
+    
+    static std::vector<uint8_t> ReadFile(const std::filesystem::path& path);
+};
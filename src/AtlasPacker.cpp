@@ -0,0 +1,102 @@
+// AtlasPacker.cpp - Skyline rectangle packer implementation
+#include "AtlasPacker.h"
+#include <algorithm>
+
+AtlasPacker::AtlasPacker(int width, int height)
+    : width(std::max(0, width))
+    , height(std::max(0, height))
+    , usedArea(0)
+{
+    Reset();
+}
+
+void AtlasPacker::Reset() {
+    skyline.clear();
+    skyline.push_back(Segment{0, 0, width});
+    usedArea = 0;
+}
+
+bool AtlasPacker::Insert(int rectWidth, int rectHeight, PixelRect& placed) {
+    if (rectWidth <= 0 || rectHeight <= 0 || rectWidth > width || rectHeight > height) {
+        return false;
+    }
+    
+    // Lowest bottom edge wins; ties go to the narrower segment to keep wide gaps open
+    size_t bestIndex = skyline.size();
+    int bestY = 0;
+    int bestBottom = height + 1;
+    int bestSegmentWidth = 0;
+    for (size_t i = 0; i < skyline.size(); i++) {
+        int y = FitAt(i, rectWidth, rectHeight);
+        if (y < 0) {
+            continue;
+        }
+        int bottom = y + rectHeight;
+        if (bottom < bestBottom || (bottom == bestBottom && skyline[i].width < bestSegmentWidth)) {
+            bestIndex = i;
+            bestY = y;
+            bestBottom = bottom;
+            bestSegmentWidth = skyline[i].width;
+        }
+    }
+    if (bestIndex == skyline.size()) {
+        return false;
+    }
+    
+    placed = PixelRect(skyline[bestIndex].x, bestY, skyline[bestIndex].x + rectWidth, bestBottom);
+    AddSegment(bestIndex, placed);
+    usedArea += static_cast<int64_t>(rectWidth) * rectHeight;
+    return true;
+}
+
+double AtlasPacker::GetOccupancy() const {
+    int64_t belowSkyline = 0;
+    for (const Segment& segment : skyline) {
+        belowSkyline += static_cast<int64_t>(segment.width) * segment.y;
+    }
+    return belowSkyline > 0 ? static_cast<double>(usedArea) / belowSkyline : 1.0;
+}
+
+int AtlasPacker::FitAt(size_t index, int rectWidth, int rectHeight) const {
+    if (skyline[index].x + rectWidth > width) {
+        return -1;
+    }
+    
+    // The rectangle rests on the highest segment it spans
+    int y = 0;
+    int remaining = rectWidth;
+    for (size_t i = index; remaining > 0 && i < skyline.size(); i++) {
+        y = std::max(y, skyline[i].y);
+        if (y + rectHeight > height) {
+            return -1;
+        }
+        remaining -= skyline[i].width;
+    }
+    return y;
+}
+
+void AtlasPacker::AddSegment(size_t index, const PixelRect& placed) {
+    skyline.insert(skyline.begin() + index, Segment{placed.left, placed.bottom, placed.Width()});
+    
+    // Cut the segments now hidden under the new one
+    size_t next = index + 1;
+    while (next < skyline.size() && skyline[next].x < placed.right) {
+        int overlap = placed.right - skyline[next].x;
+        if (overlap < skyline[next].width) {
+            skyline[next].x += overlap;
+            skyline[next].width -= overlap;
+            break;
+        }
+        skyline.erase(skyline.begin() + next);
+    }
+    
+    // Merge neighbours at the same height
+    for (size_t i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+// AtlasPacker.h - Skyline rectangle packer for texture atlases (portable, no Win32)
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "DamageRegion.h"
+
+// Places rectangles in a fixed-size page with the skyline bottom-left rule: the page
+// is tracked as the top edge of what is packed so far, and each rectangle goes where
+// that edge stays lowest. Equal-sized icons end up in rows in insertion order, mixed
+// sizes fill the gaps next to taller neighbours. Rectangles cannot be removed; Reset
+// starts the page over.
+class AtlasPacker {
+public:
+    AtlasPacker(int width, int height);
+    
+    // Find room for a width x height rectangle. False if the page has none left.
+    bool Insert(int width, int height, PixelRect& placed);
+    void Reset();
+    
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    int64_t GetUsedArea() const { return usedArea; }
+    
+    // Packed area over the area below the skyline (0..1); 1 means no holes were left
+    double GetOccupancy() const;
+
+private:
+    struct Segment {
+        int x;
+        int y;                      // Top of the packed area over [x, x + width)
+        int width;
+    };
+    
+    int width;
+    int height;
+    std::vector<Segment> skyline;   // Left to right, covering the page width
+    int64_t usedArea;
+    
+    // Lowest y a rectangle of the given width can sit at starting on segment index,
+    // or -1 if it does not fit there
+    int FitAt(size_t index, int rectWidth, int rectHeight) const;
+    void AddSegment(size_t index, const PixelRect& placed);
+};
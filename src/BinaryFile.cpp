@@ -0,0 +1,204 @@
+// BinaryFile.cpp - Positional binary file I/O implementation
+#include "BinaryFile.h"
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+BinaryFile::BinaryFile()
+    : handle(INVALID_HANDLE_VALUE)
+{
+}
+
+BinaryFile::~BinaryFile() {
+    Close();
+}
+
+bool BinaryFile::Open(const std::wstring& path, bool truncate) {
+    Close();
+    handle = CreateFile(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                        truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    return handle != INVALID_HANDLE_VALUE;
+}
+
+bool BinaryFile::OpenForReading(const std::wstring& path) {
+    Close();
+    handle = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    return handle != INVALID_HANDLE_VALUE;
+}
+
+void BinaryFile::Close() {
+    if (handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(handle);
+        handle = INVALID_HANDLE_VALUE;
+    }
+}
+
+bool BinaryFile::IsOpen() const {
+    return handle != INVALID_HANDLE_VALUE;
+}
+
+bool BinaryFile::ReadAt(uint64_t offset, void* buffer, size_t size) const {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    
+    DWORD bytesRead = 0;
+    return ReadFile(handle, buffer, static_cast<DWORD>(size), &bytesRead, &overlapped) && bytesRead == size;
+}
+
+bool BinaryFile::WriteAt(uint64_t offset, const void* buffer, size_t size) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    
+    DWORD bytesWritten = 0;
+    return WriteFile(handle, buffer, static_cast<DWORD>(size), &bytesWritten, &overlapped) && bytesWritten == size;
+}
+
+bool BinaryFile::GetSize(uint64_t& size) const {
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        return false;
+    }
+    size = static_cast<uint64_t>(fileSize.QuadPart);
+    return true;
+}
+
+bool BinaryFile::Truncate(uint64_t size) {
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(size);
+    return SetFilePointerEx(handle, end, nullptr, FILE_BEGIN) && SetEndOfFile(handle);
+}
+
+bool BinaryFile::Replace(const std::wstring& source, const std::wstring& target) {
+    return MoveFileEx(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+}
+
+void BinaryFile::Delete(const std::wstring& path) {
+    DeleteFile(path.c_str());
+}
+
+#else
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    // Paths are UTF-8 on disk; wchar_t holds UTF-32 code points here
+    std::string NativePath(const std::wstring& path) {
+        std::string utf8;
+        for (wchar_t c : path) {
+            uint32_t code = static_cast<uint32_t>(c);
+            if (code < 0x80) {
+                utf8 += static_cast<char>(code);
+            } else if (code < 0x800) {
+                utf8 += static_cast<char>(0xC0 | (code >> 6));
+                utf8 += static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                utf8 += static_cast<char>(0xE0 | (code >> 12));
+                utf8 += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                utf8 += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                utf8 += static_cast<char>(0xF0 | (code >> 18));
+                utf8 += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                utf8 += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                utf8 += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+        return utf8;
+    }
+}
+
+BinaryFile::BinaryFile()
+    : descriptor(-1)
+{
+}
+
+BinaryFile::~BinaryFile() {
+    Close();
+}
+
+bool BinaryFile::Open(const std::wstring& path, bool truncate) {
+    Close();
+    descriptor = open(NativePath(path).c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+    return descriptor >= 0;
+}
+
+bool BinaryFile::OpenForReading(const std::wstring& path) {
+    Close();
+    descriptor = open(NativePath(path).c_str(), O_RDONLY | O_CLOEXEC);
+    return descriptor >= 0;
+}
+
+void BinaryFile::Close() {
+    if (descriptor >= 0) {
+        close(descriptor);
+        descriptor = -1;
+    }
+}
+
+bool BinaryFile::IsOpen() const {
+    return descriptor >= 0;
+}
+
+bool BinaryFile::ReadAt(uint64_t offset, void* buffer, size_t size) const {
+    uint8_t* bytes = static_cast<uint8_t*>(buffer);
+    while (size > 0) {
+        ssize_t done = pread(descriptor, bytes, size, static_cast<off_t>(offset));
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            return false;
+        }
+        bytes += done;
+        offset += static_cast<uint64_t>(done);
+        size -= static_cast<size_t>(done);
+    }
+    return true;
+}
+
+bool BinaryFile::WriteAt(uint64_t offset, const void* buffer, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(buffer);
+    while (size > 0) {
+        ssize_t done = pwrite(descriptor, bytes, size, static_cast<off_t>(offset));
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            return false;
+        }
+        bytes += done;
+        offset += static_cast<uint64_t>(done);
+        size -= static_cast<size_t>(done);
+    }
+    return true;
+}
+
+bool BinaryFile::GetSize(uint64_t& size) const {
+    struct stat status;
+    if (fstat(descriptor, &status) != 0) {
+        return false;
+    }
+    size = static_cast<uint64_t>(status.st_size);
+    return true;
+}
+
+bool BinaryFile::Truncate(uint64_t size) {
+    return ftruncate(descriptor, static_cast<off_t>(size)) == 0;
+}
+
+bool BinaryFile::Replace(const std::wstring& source, const std::wstring& target) {
+    return rename(NativePath(source).c_str(), NativePath(target).c_str()) == 0;
+}
+
+void BinaryFile::Delete(const std::wstring& path) {
+    unlink(NativePath(path).c_str());
+}
+
+#endif
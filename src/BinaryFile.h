@@ -0,0 +1,45 @@
+// BinaryFile.h - Positional binary file I/O on Win32 and POSIX
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A read-write file accessed only by offset, so concurrent readers don't share a
+// file pointer. Opened files may be read by other processes but not written.
+class BinaryFile {
+public:
+    BinaryFile();
+    ~BinaryFile();
+    
+    // Delete copy/move
+    BinaryFile(const BinaryFile&) = delete;
+    BinaryFile& operator=(const BinaryFile&) = delete;
+    
+    // Open for reading and writing, creating the file if needed. With truncate an
+    // existing file is emptied first.
+    bool Open(const std::wstring& path, bool truncate);
+    
+    // Open an existing file for reading only; writes fail
+    bool OpenForReading(const std::wstring& path);
+    void Close();
+    bool IsOpen() const;
+    
+    // Exactly size bytes at offset; false on a short read or write
+    bool ReadAt(uint64_t offset, void* buffer, size_t size) const;
+    bool WriteAt(uint64_t offset, const void* buffer, size_t size);
+    
+    bool GetSize(uint64_t& size) const;
+    bool Truncate(uint64_t size);
+    
+    // Replace target with source (atomically where the file system allows)
+    static bool Replace(const std::wstring& source, const std::wstring& target);
+    static void Delete(const std::wstring& path);
+
+private:
+#ifdef _WIN32
+    void* handle;                  // HANDLE, INVALID_HANDLE_VALUE when closed
+#else
+    int descriptor;                // -1 when closed
+#endif
+};
@@ -2,6 +2,7 @@
 #pragma once
 #include <windows.h>
 #include <xinput.h>
+#include "InputEvent.h"
 
 #pragma comment(lib, "xinput.lib")
 
@@ -10,44 +11,23 @@ public:
     ControllerManager();
     ~ControllerManager();
     
-    // Initialize controller support
-    bool Initialize();
-    
-    // Update controller state (call this regularly)
-    void Update();
-    
-    // Check if specific buttons were just pressed (not held)
-    bool IsButtonPressed(WORD button);
-    
-    // Get directional input - returns true only on initial press (not held)
-    bool IsDPadPressed(int direction); // 0=up, 1=right, 2=down, 3=left
-    bool IsLeftStickPressed(int direction); // 0=up, 1=right, 2=down, 3=left
-    bool IsRightStickPressed(int direction); // 0=up, 1=right, 2=down, 3=left
-    
-    // Get directional input (-1, 0, 1 for each axis) - for continuous movement
-    int GetDPadX();
-    int GetDPadY();
-    int GetLeftStickX();
-    int GetLeftStickY();
-    int GetRightStickX();
-    int GetRightStickY();
-    
-    // Get raw analog stick values (for magnitude comparison)
-    SHORT GetLeftStickRawX() const { return currentState.Gamepad.sThumbLX; }
-    SHORT GetLeftStickRawY() const { return currentState.Gamepad.sThumbLY; }
+    // Read the controller (call this regularly). While none is connected, the empty
+    // slots are probed with exponential backoff, because probing an empty slot can
+    // stall for milliseconds. now is in microseconds on any monotonic clock.
+    void Poll(int64_t now, GamepadState& state);
     
     // Check if controller is connected
     bool IsConnected() const { return connected; }
-    
+
 private:
-    XINPUT_STATE currentState;
-    XINPUT_STATE previousState;
     bool connected;
     DWORD controllerIndex;
+    int64_t nextProbeTime;          // When to look for a controller again
+    int64_t probeInterval;          // Doubles after each failed probe
     
-    // Deadzone for analog stick (reduced for better sensitivity)
-    static const int STICK_DEADZONE = 4000;
+    // Try to find the first connected controller
+    bool Probe(XINPUT_STATE& state);
     
-    // Helper to normalize stick input to -1, 0, 1
-    int NormalizeStickInput(SHORT value);
-};
\ No newline at end of file
+    static const int64_t MIN_PROBE_INTERVAL = 100000;   // Microseconds
+    static const int64_t MAX_PROBE_INTERVAL = 3200000;
+};
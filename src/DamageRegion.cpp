@@ -0,0 +1,243 @@
+// DamageRegion.cpp - Dirty rectangle accumulation implementation
+#include "DamageRegion.h"
+#include <algorithm>
+
+bool PixelRect::Intersects(const PixelRect& other) const {
+    return !IsEmpty() && !other.IsEmpty() &&
+           left < other.right && other.left < right &&
+           top < other.bottom && other.top < bottom;
+}
+
+bool PixelRect::Contains(const PixelRect& other) const {
+    if (other.IsEmpty()) {
+        return true;
+    }
+    return !IsEmpty() &&
+           left <= other.left && top <= other.top &&
+           right >= other.right && bottom >= other.bottom;
+}
+
+PixelRect PixelRect::Intersect(const PixelRect& a, const PixelRect& b) {
+    PixelRect result(std::max(a.left, b.left), std::max(a.top, b.top),
+                     std::min(a.right, b.right), std::min(a.bottom, b.bottom));
+    return result.IsEmpty() ? PixelRect() : result;
+}
+
+PixelRect PixelRect::Union(const PixelRect& a, const PixelRect& b) {
+    if (a.IsEmpty()) {
+        return b.IsEmpty() ? PixelRect() : b;
+    }
+    if (b.IsEmpty()) {
+        return a;
+    }
+    return PixelRect(std::min(a.left, b.left), std::min(a.top, b.top),
+                     std::max(a.right, b.right), std::max(a.bottom, b.bottom));
+}
+
+int PixelRect::Subtract(const PixelRect& a, const PixelRect& b, PixelRect pieces[4]) {
+    if (a.IsEmpty()) {
+        return 0;
+    }
+    
+    PixelRect overlap = Intersect(a, b);
+    if (overlap.IsEmpty()) {
+        pieces[0] = a;
+        return 1;
+    }
+    
+    int count = 0;
+    PixelRect candidates[4] = {
+        PixelRect(a.left, a.top, a.right, overlap.top),
+        PixelRect(a.left, overlap.bottom, a.right, a.bottom),
+        PixelRect(a.left, overlap.top, overlap.left, overlap.bottom),
+        PixelRect(overlap.right, overlap.top, a.right, overlap.bottom)
+    };
+    for (const PixelRect& candidate : candidates) {
+        if (!candidate.IsEmpty()) {
+            pieces[count++] = candidate;
+        }
+    }
+    return count;
+}
+
+DamageRegion::DamageRegion() {
+}
+
+void DamageRegion::Add(const PixelRect& rect) {
+    if (rect.IsEmpty()) {
+        return;
+    }
+    
+    PixelRect pending = rect;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < rects.size(); i++) {
+            if (rects[i].Contains(pending)) {
+                return;
+            }
+            
+            // Absorb rectangles the new one covers, and merge with any that are close
+            // enough that drawing the union wastes little
+            if (pending.Contains(rects[i]) ||
+                MergeWaste(pending, rects[i]) * MERGE_WASTE_DIVISOR <= PixelRect::Union(pending, rects[i]).Area()) {
+                pending = PixelRect::Union(pending, rects[i]);
+                rects[i] = rects.back();
+                rects.pop_back();
+                changed = true;
+                break;
+            }
+        }
+    }
+    
+    // Keep the list disjoint: add only the parts no rectangle covers yet
+    std::vector<PixelRect> pieces(1, pending);
+    std::vector<PixelRect> remaining;
+    for (const PixelRect& existing : rects) {
+        remaining.clear();
+        for (const PixelRect& piece : pieces) {
+            PixelRect split[4];
+            int count = PixelRect::Subtract(piece, existing, split);
+            remaining.insert(remaining.end(), split, split + count);
+        }
+        pieces.swap(remaining);
+    }
+    rects.insert(rects.end(), pieces.begin(), pieces.end());
+    
+    while (rects.size() > MAX_RECTS) {
+        MergeClosestPair();
+    }
+}
+
+void DamageRegion::Clear() {
+    rects.clear();
+}
+
+void DamageRegion::ClipTo(const PixelRect& bounds) {
+    size_t kept = 0;
+    for (size_t i = 0; i < rects.size(); i++) {
+        PixelRect clipped = PixelRect::Intersect(rects[i], bounds);
+        if (!clipped.IsEmpty()) {
+            rects[kept++] = clipped;
+        }
+    }
+    rects.resize(kept);
+}
+
+void DamageRegion::Remove(const PixelRect& rect) {
+    if (rect.IsEmpty()) {
+        return;
+    }
+    
+    // Pieces of disjoint rectangles stay disjoint, so they can be added back as they are
+    std::vector<PixelRect> pending;
+    pending.swap(rects);
+    for (const PixelRect& existing : pending) {
+        PixelRect pieces[4];
+        int count = PixelRect::Subtract(existing, rect, pieces);
+        rects.insert(rects.end(), pieces, pieces + count);
+    }
+    while (rects.size() > MAX_RECTS) {
+        MergeClosestPair();
+    }
+}
+
+void DamageRegion::Scroll(const PixelRect& area, int dy) {
+    if (dy == 0 || area.IsEmpty()) {
+        return;
+    }
+    
+    std::vector<PixelRect> pending;
+    pending.swap(rects);
+    for (const PixelRect& rect : pending) {
+        PixelRect outside[4];
+        int outsideCount = PixelRect::Subtract(rect, area, outside);
+        for (int i = 0; i < outsideCount; i++) {
+            Add(outside[i]);
+        }
+        PixelRect moved = PixelRect::Intersect(rect, area).Offset(0, -dy);
+        Add(PixelRect::Intersect(moved, area));
+    }
+}
+
+bool DamageRegion::Contains(const PixelRect& rect) const {
+    for (const PixelRect& damaged : rects) {
+        if (damaged.Contains(rect)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PixelRect DamageRegion::GetBounds() const {
+    PixelRect bounds;
+    for (const PixelRect& rect : rects) {
+        bounds = PixelRect::Union(bounds, rect);
+    }
+    return bounds;
+}
+
+int64_t DamageRegion::GetArea() const {
+    int64_t area = 0;
+    for (const PixelRect& rect : rects) {
+        area += rect.Area();
+    }
+    return area;
+}
+
+void DamageRegion::GetTiles(int tileHeight, std::vector<PixelRect>& tiles) const {
+    tiles.clear();
+    if (tileHeight <= 0) {
+        tiles = rects;
+        return;
+    }
+    
+    for (const PixelRect& rect : rects) {
+        for (int top = rect.top; top < rect.bottom; top += tileHeight) {
+            tiles.push_back(PixelRect(rect.left, top, rect.right, std::min(top + tileHeight, rect.bottom)));
+        }
+    }
+}
+
+int64_t DamageRegion::MergeWaste(const PixelRect& a, const PixelRect& b) {
+    int64_t covered = a.Area() + b.Area() - PixelRect::Intersect(a, b).Area();
+    return PixelRect::Union(a, b).Area() - covered;
+}
+
+void DamageRegion::MergeClosestPair() {
+    size_t bestA = 0;
+    size_t bestB = 1;
+    int64_t bestWaste = -1;
+    for (size_t a = 0; a < rects.size(); a++) {
+        for (size_t b = a + 1; b < rects.size(); b++) {
+            int64_t waste = MergeWaste(rects[a], rects[b]);
+            if (bestWaste < 0 || waste < bestWaste) {
+                bestWaste = waste;
+                bestA = a;
+                bestB = b;
+            }
+        }
+    }
+    
+    PixelRect merged = PixelRect::Union(rects[bestA], rects[bestB]);
+    rects[bestB] = rects.back();
+    rects.pop_back();
+    rects[bestA] = rects.back();
+    rects.pop_back();
+    
+    // Swallow everything the union touches so the list stays disjoint
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        for (size_t i = 0; i < rects.size(); i++) {
+            if (rects[i].Intersects(merged)) {
+                merged = PixelRect::Union(merged, rects[i]);
+                rects[i] = rects.back();
+                rects.pop_back();
+                grew = true;
+                break;
+            }
+        }
+    }
+    rects.push_back(merged);
+}
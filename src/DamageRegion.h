@@ -0,0 +1,82 @@
+// DamageRegion.h - Dirty rectangle accumulation for partial repaints (portable, no Win32)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Half-open pixel rectangle [left, right) x [top, bottom), same layout as a Win32 RECT
+struct PixelRect {
+    int left = 0;
+    int top = 0;
+    int right = 0;
+    int bottom = 0;
+    
+    PixelRect() {}
+    PixelRect(int l, int t, int r, int b) : left(l), top(t), right(r), bottom(b) {}
+    
+    int Width() const { return right - left; }
+    int Height() const { return bottom - top; }
+    bool IsEmpty() const { return right <= left || bottom <= top; }
+    int64_t Area() const { return IsEmpty() ? 0 : static_cast<int64_t>(Width()) * Height(); }
+    
+    bool Intersects(const PixelRect& other) const;
+    bool Contains(const PixelRect& other) const;
+    PixelRect Offset(int dx, int dy) const { return PixelRect(left + dx, top + dy, right + dx, bottom + dy); }
+    
+    // Empty rectangles are ignored by Union; Intersect returns an empty rectangle
+    // when the two do not overlap
+    static PixelRect Intersect(const PixelRect& a, const PixelRect& b);
+    static PixelRect Union(const PixelRect& a, const PixelRect& b);
+    
+    // Split a minus b into up to 4 rectangles (above, below, left, right); returns the count
+    static int Subtract(const PixelRect& a, const PixelRect& b, PixelRect pieces[4]);
+};
+
+// Collects the rectangles invalidated since the last paint. Rectangles that mostly
+// overlap are merged and the list is capped at MAX_RECTS, so the paint loop visits
+// a few compact areas instead of the whole window. The rectangles never overlap, so
+// every pixel that was added is covered by exactly one of them and blending passes
+// touch it once.
+class DamageRegion {
+public:
+    DamageRegion();
+    
+    void Add(const PixelRect& rect);
+    void Clear();
+    bool IsEmpty() const { return rects.empty(); }
+    
+    // Drop everything outside bounds (e.g. the back buffer)
+    void ClipTo(const PixelRect& bounds);
+    
+    // Take rect out of the region, e.g. once it has been redrawn. Merging to stay
+    // under MAX_RECTS may keep part of it.
+    void Remove(const PixelRect& rect);
+    
+    // The pixels of area moved up by dy rows: damage inside area moves with them and
+    // stays clipped to area, damage outside it stays where it is
+    void Scroll(const PixelRect& area, int dy);
+    
+    // True if a single damage rectangle covers all of rect
+    bool Contains(const PixelRect& rect) const;
+    
+    const std::vector<PixelRect>& GetRects() const { return rects; }
+    PixelRect GetBounds() const;
+    
+    // Pixels covered by the rectangles, counting overlaps more than once
+    int64_t GetArea() const;
+    
+    // Cut every rectangle into horizontal bands of at most tileHeight rows. The tiles
+    // don't overlap either, so they can be rendered on separate threads.
+    void GetTiles(int tileHeight, std::vector<PixelRect>& tiles) const;
+    
+    static const size_t MAX_RECTS = 8;         // More than this and the closest pair is merged
+    static const int MERGE_WASTE_DIVISOR = 4;  // Merge if at most 1/4 of the union was not damaged
+
+private:
+    std::vector<PixelRect> rects;
+    
+    // Pixels in the union of a and b that neither rectangle covers
+    static int64_t MergeWaste(const PixelRect& a, const PixelRect& b);
+    void MergeClosestPair();
+};
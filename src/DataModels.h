@@ -1,77 +1,86 @@
 // DataModels.h - Core data structures
 #pragma once
 
-#include <windows.h>
+#include "PlatformTypes.h"
 #include <string>
 #include <vector>
+#include "IconPixelPool.h"
 
 // Structure to hold shortcut information
 struct ShortcutInfo {
+    std::wstring shortcutPath;     // Full path of the .lnk file
     std::wstring displayName;      // Name to show in grid
     std::wstring targetPath;       // Executable path
     std::wstring arguments;        // Command line arguments
     std::wstring workingDirectory; // Working directory
     std::wstring iconPath;         // Icon file path
     int iconIndex;                 // Icon index in file
-    HBITMAP iconBitmap;           // Cached 32-bit ARGB bitmap for alpha blending
-    int iconBitmapWidth;          // Bitmap width
-    int iconBitmapHeight;         // Bitmap height
+    IconHandle iconPixels;        // Premultiplied BGRA icon in IconPixelPool (0 if none)
+    int iconWidth;                // Icon width
+    int iconHeight;               // Icon height
     bool isValid;                 // Whether shortcut is functional
     
     // Constructor
     ShortcutInfo() 
         : iconIndex(0)
-        , iconBitmap(nullptr)
-        , iconBitmapWidth(0)
-        , iconBitmapHeight(0)
+        , iconPixels(0)
+        , iconWidth(0)
+        , iconHeight(0)
         , isValid(false) 
     {}
     
-    // Destructor to clean up bitmap handle
+    // Destructor returns the icon buffer to the pool
     ~ShortcutInfo() {
-        if (iconBitmap) {
-            DeleteObject(iconBitmap);
-            iconBitmap = nullptr;
+        SetIconPixels(0, 0, 0);
+    }
+    
+    // Take ownership of a pooled icon buffer, releasing the previous one
+    void SetIconPixels(IconHandle pixels, int width, int height) {
+        if (iconPixels) {
+            IconPixelPool::Instance().Release(iconPixels);
         }
+        iconPixels = pixels;
+        iconWidth = width;
+        iconHeight = height;
     }
     
     // Move constructor for efficient vector operations
     ShortcutInfo(ShortcutInfo&& other) noexcept
-        : displayName(std::move(other.displayName))
+        : shortcutPath(std::move(other.shortcutPath))
+        , displayName(std::move(other.displayName))
         , targetPath(std::move(other.targetPath))
         , arguments(std::move(other.arguments))
         , workingDirectory(std::move(other.workingDirectory))
         , iconPath(std::move(other.iconPath))
         , iconIndex(other.iconIndex)
-        , iconBitmap(other.iconBitmap)
-        , iconBitmapWidth(other.iconBitmapWidth)
-        , iconBitmapHeight(other.iconBitmapHeight)
+        , iconPixels(other.iconPixels)
+        , iconWidth(other.iconWidth)
+        , iconHeight(other.iconHeight)
         , isValid(other.isValid)
     {
-        other.iconBitmap = nullptr; // Transfer ownership
+        other.iconPixels = 0; // Transfer ownership
     }
     
     // Move assignment operator
     ShortcutInfo& operator=(ShortcutInfo&& other) noexcept {
         if (this != &other) {
-            // Clean up existing bitmap
-            if (iconBitmap) {
-                DeleteObject(iconBitmap);
-            }
+            // Clean up existing icon
+            SetIconPixels(0, 0, 0);
             
             // Move data
+            shortcutPath = std::move(other.shortcutPath);
             displayName = std::move(other.displayName);
             targetPath = std::move(other.targetPath);
             arguments = std::move(other.arguments);
             workingDirectory = std::move(other.workingDirectory);
             iconPath = std::move(other.iconPath);
             iconIndex = other.iconIndex;
-            iconBitmap = other.iconBitmap;
-            iconBitmapWidth = other.iconBitmapWidth;
-            iconBitmapHeight = other.iconBitmapHeight;
+            iconPixels = other.iconPixels;
+            iconWidth = other.iconWidth;
+            iconHeight = other.iconHeight;
             isValid = other.isValid;
             
-            other.iconBitmap = nullptr; // Transfer ownership
+            other.iconPixels = 0; // Transfer ownership
         }
         return *this;
     }
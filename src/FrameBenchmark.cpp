@@ -0,0 +1,617 @@
+// FrameBenchmark.cpp - Paint performance scenarios implementation
+#include "FrameBenchmark.h"
+#include "BinaryFile.h"
+#include "FrameComposer.h"
+#include "GridLayout.h"
+#include "HeadlessRenderer.h"
+#include "InputEvent.h"
+#include "InputLog.h"
+#include "InputReplay.h"
+#include "MessageLoop.h"
+#include "PixelOps.h"
+#include "ScrollPhysics.h"
+#include "Settings.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <functional>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+bool FrameBenchmark::ParseCommandLine(const std::vector<std::wstring>& args, FrameBenchmarkOptions& options) {
+    if (std::find(args.begin(), args.end(), L"--benchmark") == args.end()) {
+        return false;
+    }
+    
+    if (std::find(args.begin(), args.end(), L"--no-atlas") != args.end()) {
+        options.iconAtlas = false;
+    }
+    if (std::find(args.begin(), args.end(), L"--no-layer") != args.end()) {
+        options.contentLayer = false;
+    }
+    
+    for (size_t i = 0; i + 1 < args.size(); i++) {
+        const std::wstring& name = args[i];
+        const std::wstring& value = args[i + 1];
+        if (name == L"--size") {
+            int width = 0, height = 0;
+            if (swscanf(value.c_str(), L"%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+                options.width = width;
+                options.height = height;
+            }
+        } else if (name == L"--dpi") {
+            options.dpiPercent = max(100, static_cast<int>(wcstol(value.c_str(), nullptr, 10)));
+        } else if (name == L"--frames") {
+            options.frames = max(1, static_cast<int>(wcstol(value.c_str(), nullptr, 10)));
+        } else if (name == L"--shortcuts") {
+            options.shortcutsPerTab = max(1, static_cast<int>(wcstol(value.c_str(), nullptr, 10)));
+        } else if (name == L"--dump") {
+            options.dumpFolder = value;
+        } else if (name == L"--report") {
+            options.reportPath = value;
+        } else if (name == L"--replay") {
+            options.replayPath = value;
+        }
+    }
+    return true;
+}
+
+std::wstring FrameBenchmark::Run(const FrameBenchmarkOptions& options) {
+    if (!options.replayPath.empty()) {
+        return MeasureReplay(options);
+    }
+    
+    float dpiScaleFactor = options.dpiPercent / 100.0f;
+    int iconSize = static_cast<int>(DesignConstants::TARGET_ICON_SIZE_PIXELS * Settings::Instance().GetIconScale());
+    
+    std::vector<TabInfo> tabs;
+    BuildTabs(std::vector<int>(max(1, options.tabCount), options.shortcutsPerTab), iconSize, tabs);
+    
+    HeadlessRenderer renderer;
+    renderer.SetSize(options.width, options.height);
+    renderer.GetGridRenderer().SetIconAtlasEnabled(options.iconAtlas);
+    renderer.GetComposer().SetContentLayerEnabled(options.contentLayer);
+    
+    std::wstring line;
+    std::string isa = PixelOps::GetIsaName(PixelOps::GetActiveIsa());
+    std::wstring isaName(isa.begin(), isa.end());
+    line = Format(L"Frame benchmark: %dx%d at %d%% DPI, %d tabs of %d shortcuts, %d frames per scenario, %ls kernels, "
+                  L"icon atlas %ls, content layer %ls\n",
+                  options.width, options.height, options.dpiPercent, options.tabCount, options.shortcutsPerTab,
+                  options.frames, isaName.c_str(), options.iconAtlas ? L"on" : L"off", options.contentLayer ? L"on" : L"off");
+    std::wstring report = line;
+    
+    // Each scenario changes the state the way input would and queues the same damage
+    // WindowManager would; the timed part is that plus the repaint
+    int activeTab = 0;
+    int scrollOffset = 0;
+    int selected = -1;
+    int scrollDirection = 1;
+    auto state = [&]() { return renderer.MakeState(tabs, activeTab, scrollOffset, selected, dpiScaleFactor); };
+    
+    struct Scenario {
+        const wchar_t* name;
+        int startSelection;
+        std::function<void()> step;
+    };
+    int shortcutCount = static_cast<int>(tabs[0].shortcuts.size());
+    int scrollStep = static_cast<int>(48 * dpiScaleFactor);
+    std::vector<Scenario> scenarios = {
+        {L"idle", -1, [&]() {}},
+        {L"full", -1, [&]() { renderer.InvalidateAll(); }},
+        {L"selection", 0, [&]() {
+            renderer.InvalidateIcon(state(), selected);
+            selected = (selected + 1) % max(1, min(shortcutCount, 24));
+            renderer.InvalidateIcon(state(), selected);
+        }},
+        {L"scroll", 0, [&]() {
+            // Bounce within one screen height of content
+            if (scrollOffset + scrollDirection * scrollStep < 0 || scrollOffset + scrollDirection * scrollStep > options.height) {
+                scrollDirection = -scrollDirection;
+            }
+            int delta = scrollDirection * scrollStep;
+            scrollOffset += delta;
+            renderer.Scroll(state(), delta);
+        }},
+        {L"tabswitch", -1, [&]() {
+            activeTab = (activeTab + 1) % static_cast<int>(tabs.size());
+            scrollOffset = 0;
+            renderer.InvalidateTabs();
+        }},
+    };
+    
+    for (const Scenario& scenario : scenarios) {
+        activeTab = 0;
+        scrollOffset = 0;
+        selected = scenario.startSelection;
+        scrollDirection = 1;
+        renderer.InvalidateTabs();
+        renderer.Render(state());
+        
+        std::vector<double> times;
+        int64_t pixelsDrawn = 0;
+        for (int frame = 0; frame < options.frames; frame++) {
+            auto start = std::chrono::steady_clock::now();
+            scenario.step();
+            pixelsDrawn += renderer.Render(state());
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        
+        // The incrementally painted frame must match a repaint from scratch
+        RasterImage frame = renderer.GetFrame();
+        std::vector<uint32_t> painted(frame.pixels, frame.pixels + static_cast<size_t>(frame.stride) * frame.height);
+        renderer.InvalidateAll();
+        renderer.Render(state());
+        bool exact = std::equal(painted.begin(), painted.end(), frame.pixels);
+        
+        if (!options.dumpFolder.empty()) {
+            renderer.SavePng(GetDumpPath(options, scenario.name));
+        }
+        
+        line = Format(L"%-10ls p50 %7.3f  p90 %7.3f  p99 %7.3f  max %7.3f ms  %9lld px/frame  %ls\n",
+                      scenario.name, Percentile(times, 0.5), Percentile(times, 0.9), Percentile(times, 0.99),
+                      times.back(), static_cast<long long>(pixelsDrawn / options.frames), exact ? L"exact" : L"MISMATCH");
+        report += line;
+    }
+    
+    report += MeasureGlide(options);
+    report += MeasureHitTest(options);
+    report += MeasureTicks();
+    return report;
+}
+
+std::wstring FrameBenchmark::MeasureGlide(const FrameBenchmarkOptions& options) {
+    float dpiScaleFactor = options.dpiPercent / 100.0f;
+    int iconSize = static_cast<int>(DesignConstants::TARGET_ICON_SIZE_PIXELS * Settings::Instance().GetIconScale());
+    
+    std::vector<TabInfo> tabs;
+    BuildTabs(std::vector<int>(1, options.shortcutsPerTab), iconSize, tabs);
+    
+    HeadlessRenderer renderer;
+    renderer.SetSize(options.width, options.height);
+    renderer.GetGridRenderer().SetIconAtlasEnabled(options.iconAtlas);
+    renderer.GetComposer().SetContentLayerEnabled(options.contentLayer);
+    
+    RECT clientRect = {0, 0, options.width, options.height};
+    GridLayout layout = FrameComposer::GetGridLayout(clientRect, options.shortcutsPerTab);
+    int budget = ScrollPhysics::GetFrameBudget(layout.GetArea().Height());
+    
+    // The same physics and settings WindowManager scrolls with, on a clock that steps
+    // exactly one frame at a time
+    ScrollPhysics physics;
+    physics.SetSmoothing(static_cast<int64_t>(Settings::Instance().GetScrollSmoothing()) * 1000);
+    physics.SetRange(layout.GetMaxScroll());
+    int64_t framePeriod = TickScheduler::MICROSECONDS_PER_SECOND / GLIDE_FRAME_RATE;
+    double notch = Settings::Instance().GetMouseScrollSpeed();
+    double stickSpeed = Settings::Instance().GetJoystickScrollVelocity();
+    
+    NavigationState navigation;
+    auto state = [&]() {
+        return renderer.MakeState(tabs, 0, navigation.scrollOffset, navigation.selectedIconIndex, dpiScaleFactor);
+    };
+    renderer.Render(state());
+    
+    std::vector<double> times;
+    int64_t pixelsDrawn = 0;
+    int largestStep = 0;
+    for (int frame = 0; frame < GLIDE_SECONDS * GLIDE_FRAME_RATE; frame++) {
+        // Each second: three wheel notches down, three up, then the stick pushed down
+        // and up, each push easing to full deflection over half a second and released
+        int second = frame / GLIDE_FRAME_RATE;
+        int within = frame % GLIDE_FRAME_RATE;
+        int direction = second % 2 == 0 ? 1 : -1;
+        if (second % 4 < 2) {
+            if (within % 6 == 0 && within < 18) {
+                physics.AddDistance(direction * notch);
+            }
+        } else {
+            int deflection = within < GLIDE_FRAME_RATE * 3 / 4 ?
+                min(within, GLIDE_FRAME_RATE / 2) * GamepadEdgeDetector::STICK_RANGE / (GLIDE_FRAME_RATE / 2) : 0;
+            physics.SetStickVelocity(direction * stickSpeed * deflection / GamepadEdgeDetector::STICK_RANGE);
+        }
+        physics.Advance(framePeriod);
+        
+        int step = physics.GetFrameStep(navigation.scrollOffset, budget);
+        if (step == 0) {
+            continue;
+        }
+        
+        // Timed like the scroll scenario: the state change, its damage and the repaint
+        auto start = std::chrono::steady_clock::now();
+        int previousOffset = navigation.scrollOffset;
+        GridNavigator::ScrollBy(navigation, layout, step);
+        renderer.Scroll(state(), navigation.scrollOffset - previousOffset);
+        pixelsDrawn += renderer.Render(state());
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        largestStep = max(largestStep, abs(navigation.scrollOffset - previousOffset));
+    }
+    if (times.empty()) {
+        return L"";
+    }
+    
+    // Steady scrolling needs every frame on time, so the spread and the misses matter
+    // more than the median
+    double mean = 0;
+    for (double time : times) {
+        mean += time;
+    }
+    mean /= times.size();
+    double variance = 0;
+    for (double time : times) {
+        variance += (time - mean) * (time - mean);
+    }
+    double frameMilliseconds = 1000.0 / GLIDE_FRAME_RATE;
+    int overBudget = static_cast<int>(std::count_if(times.begin(), times.end(),
+                                                    [&](double time) { return time > frameMilliseconds; }));
+    std::sort(times.begin(), times.end());
+    
+    RasterImage frame = renderer.GetFrame();
+    std::vector<uint32_t> painted(frame.pixels, frame.pixels + static_cast<size_t>(frame.stride) * frame.height);
+    renderer.InvalidateAll();
+    renderer.Render(state());
+    bool exact = std::equal(painted.begin(), painted.end(), frame.pixels);
+    
+    if (!options.dumpFolder.empty()) {
+        renderer.SavePng(GetDumpPath(options, L"glide"));
+    }
+    
+    std::wstring line;
+    line = Format(L"%-10ls p50 %7.3f  p90 %7.3f  p99 %7.3f  max %7.3f ms  %9lld px/frame  %ls\n",
+                  L"glide", Percentile(times, 0.5), Percentile(times, 0.9), Percentile(times, 0.99), times.back(),
+                  static_cast<long long>(pixelsDrawn / static_cast<int64_t>(times.size())), exact ? L"exact" : L"MISMATCH");
+    std::wstring report = line;
+    line = Format(L"%-10ls %zu frames at %d Hz  jitter %.3f ms  %d over %.2f ms  steps up to %d of %d px\n",
+                  L"", times.size(), GLIDE_FRAME_RATE, std::sqrt(variance / times.size()), overBudget, frameMilliseconds,
+                  largestStep, budget);
+    report += line;
+    return report;
+}
+
+std::wstring FrameBenchmark::MeasureTicks() {
+    // Run the main loop's ticks without a window; nothing else wakes it
+    MessageLoop loop;
+    int rate = Settings::Instance().GetInputPollRate();
+    loop.SetTickRate(rate);
+    
+    std::vector<double> lateness;
+    int exitCode = 0;
+    int64_t start = MessageLoop::GetMicroseconds();
+    while (MessageLoop::GetMicroseconds() - start < TICK_TEST_MICROSECONDS) {
+        auto onTick = [&]() { lateness.push_back(loop.GetScheduler().GetLastLateness()); };
+        if (!loop.RunOnce(true, onTick, exitCode)) {
+            break;
+        }
+    }
+    std::sort(lateness.begin(), lateness.end());
+    if (lateness.empty()) {
+        return L"";
+    }
+    
+    std::wstring line;
+    line = Format(L"%-10ls p50 %5.0f  p99 %5.0f  max %5.0f us late  %d Hz  %.0f wakeups/s  %lld dropped\n",
+                  L"ticks", Percentile(lateness, 0.5), Percentile(lateness, 0.99), lateness.back(), rate,
+                  loop.GetScheduler().GetWakeupsPerSecond(), static_cast<long long>(loop.GetScheduler().GetMissedTicks()));
+    return line;
+}
+
+std::wstring FrameBenchmark::MeasureReplay(const FrameBenchmarkOptions& options) {
+    std::vector<uint8_t> data;
+    InputLog log;
+    if (!ReadWholeFile(options.replayPath, data) || !log.Decode(data.data(), data.size())) {
+        return L"Replay: " + options.replayPath + L" is not an input recording\n";
+    }
+    const InputLogHeader& header = log.GetHeader();
+    float dpiScaleFactor = header.dpiPercent / 100.0f;
+    
+    std::vector<TabInfo> tabs;
+    BuildTabs(header.tabItemCounts, header.metrics.iconSize, tabs);
+    
+    HeadlessRenderer renderer;
+    renderer.SetSize(header.clientWidth, header.clientHeight);
+    renderer.GetGridRenderer().SetIconAtlasEnabled(options.iconAtlas);
+    renderer.GetComposer().SetContentLayerEnabled(options.contentLayer);
+    
+    // Replay steps through the recorded layout; the frames show it only if the local
+    // settings lay the grid out the same way
+    RECT clientRect = {0, 0, header.clientWidth, header.clientHeight};
+    GridLayout localLayout = FrameComposer::GetGridLayout(clientRect, 0);
+    const PixelRect& localArea = localLayout.GetArea();
+    const GridMetrics& localMetrics = localLayout.GetMetrics();
+    bool sameLayout = localArea.left == header.gridArea.left && localArea.top == header.gridArea.top &&
+                      localArea.right == header.gridArea.right && localArea.bottom == header.gridArea.bottom &&
+                      localMetrics.iconSize == header.metrics.iconSize &&
+                      localMetrics.spacingHorizontal == header.metrics.spacingHorizontal &&
+                      localMetrics.spacingVertical == header.metrics.spacingVertical &&
+                      localMetrics.labelHeight == header.metrics.labelHeight &&
+                      localMetrics.verticalPadding == header.metrics.verticalPadding &&
+                      localMetrics.borderPadding == header.metrics.borderPadding &&
+                      localMetrics.borderExtension == header.metrics.borderExtension;
+    
+    std::wstring line;
+    std::string isa = PixelOps::GetIsaName(PixelOps::GetActiveIsa());
+    std::wstring isaName(isa.begin(), isa.end());
+    line = Format(L"Replay benchmark: %ls, %dx%d at %d%% DPI, %d tabs, %zu actions over %.1f s, %ls kernels, "
+                  L"icon atlas %ls, content layer %ls%ls\n",
+                  options.replayPath.c_str(), header.clientWidth, header.clientHeight, header.dpiPercent,
+                  static_cast<int>(tabs.size()), log.GetActions().size(), log.GetDuration() / 1e6, isaName.c_str(),
+                  options.iconAtlas ? L"on" : L"off", options.contentLayer ? L"on" : L"off",
+                  sameLayout ? L"" : L", LAYOUT DIFFERS from the recording");
+    std::wstring report = line;
+    
+    InputReplay replay(log);
+    auto state = [&]() {
+        const NavigationState& navigation = replay.GetState();
+        return renderer.MakeState(tabs, navigation.activeTabIndex, navigation.scrollOffset,
+                                  navigation.selectedIconIndex, dpiScaleFactor);
+    };
+    renderer.Render(state());
+    
+    // One frame per action, queuing the damage WindowManager::ApplyAction would
+    std::vector<double> times;
+    times.reserve(log.GetActions().size());
+    int64_t pixelsDrawn = 0;
+    double replayMilliseconds = 0;
+    uint64_t frameHash = 14695981039346656037ULL;
+    while (!replay.IsFinished()) {
+        auto start = std::chrono::steady_clock::now();
+        NavigationState previous = replay.GetState();
+        const InputAction& action = replay.Step();
+        const NavigationState& current = replay.GetState();
+        
+        switch (action.type) {
+            case InputActionType::Navigate:
+            case InputActionType::Select:
+                if (current.scrollOffset != previous.scrollOffset) {
+                    renderer.Invalidate(replay.GetLayout().GetItemsBounds());
+                }
+                if (current.scrollOffset != previous.scrollOffset || current.selectedIconIndex != previous.selectedIconIndex) {
+                    renderer.InvalidateIcon(state(), previous.selectedIconIndex);
+                    renderer.InvalidateIcon(state(), current.selectedIconIndex);
+                }
+                break;
+            
+            case InputActionType::Scroll:
+                renderer.Scroll(state(), current.scrollOffset - previous.scrollOffset);
+                break;
+            
+            case InputActionType::SelectTab:
+                if (current.activeTabIndex != previous.activeTabIndex) {
+                    renderer.InvalidateTabs();
+                }
+                break;
+            
+            case InputActionType::Resize:
+                renderer.SetSize(replay.GetClientWidth(), replay.GetClientHeight());
+                break;
+            
+            default:
+                break;
+        }
+        pixelsDrawn += renderer.Render(state());
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        times.push_back(milliseconds);
+        replayMilliseconds += milliseconds;
+        frameHash = HashFrame(renderer.GetFrame(), frameHash);
+    }
+    std::sort(times.begin(), times.end());
+    
+    // The incrementally painted frame must match a repaint from scratch
+    RasterImage frame = renderer.GetFrame();
+    std::vector<uint32_t> painted(frame.pixels, frame.pixels + static_cast<size_t>(frame.stride) * frame.height);
+    renderer.InvalidateAll();
+    renderer.Render(state());
+    bool exact = std::equal(painted.begin(), painted.end(), frame.pixels);
+    
+    if (!options.dumpFolder.empty()) {
+        renderer.SavePng(GetDumpPath(options, L"replay"));
+    }
+    
+    size_t frames = max(times.size(), static_cast<size_t>(1));
+    line = Format(L"%-10ls p50 %7.3f  p90 %7.3f  p99 %7.3f  max %7.3f ms  %9lld px/frame  %ls\n",
+                  L"replay", Percentile(times, 0.5), Percentile(times, 0.9), Percentile(times, 0.99),
+                  times.empty() ? 0.0 : times.back(), static_cast<long long>(pixelsDrawn / static_cast<int64_t>(frames)),
+                  exact ? L"exact" : L"MISMATCH");
+    report += line;
+    
+    // The speedup counts render time only; a CI run is bounded by it, not by the recording
+    double speedup = replayMilliseconds > 0 ? log.GetDuration() / 1000.0 / replayMilliseconds : 0;
+    line = Format(L"%-10ls %.0fx real time  %d launches  states %ls  frames %016llx\n",
+                  L"", speedup, replay.GetLaunchCount(), replay.IsFaithful() ? L"match" : L"DIFFER",
+                  static_cast<unsigned long long>(frameHash));
+    report += line;
+    return report;
+}
+
+bool FrameBenchmark::ReadWholeFile(const std::wstring& path, std::vector<uint8_t>& data) {
+    BinaryFile file;
+    uint64_t size = 0;
+    if (!file.OpenForReading(path) || !file.GetSize(size) || size >= static_cast<uint64_t>(MAX_REPLAY_FILE_SIZE)) {
+        return false;
+    }
+    data.resize(static_cast<size_t>(size));
+    return data.empty() || file.ReadAt(0, data.data(), data.size());
+}
+
+uint64_t FrameBenchmark::HashFrame(const RasterImage& frame, uint64_t hash) {
+    for (int y = 0; y < frame.height; y++) {
+        const uint32_t* row = frame.pixels + static_cast<size_t>(y) * frame.stride;
+        for (int x = 0; x < frame.width; x++) {
+            hash = (hash ^ row[x]) * 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+std::wstring FrameBenchmark::MeasureHitTest(const FrameBenchmarkOptions& options) {
+    // Hover over a grid far larger than any real tab, at scroll offsets all through it
+    RECT clientRect = {0, 0, options.width, options.height};
+    GridLayout layout = FrameComposer::GetGridLayout(clientRect, HIT_TEST_ITEMS);
+    const PixelRect& area = layout.GetArea();
+    if (layout.IsEmpty() || area.IsEmpty()) {
+        return L"";
+    }
+    
+    uint32_t seed = 12345;
+    auto next = [&seed]() { seed = seed * 1664525 + 1013904223; return static_cast<int>(seed >> 8); };
+    int maxScroll = layout.GetMaxScroll();
+    int64_t hits = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < HIT_TEST_QUERIES; i++) {
+        int x = area.left + next() % area.Width();
+        int y = area.top + next() % area.Height();
+        int scroll = maxScroll > 0 ? next() % (maxScroll + 1) : 0;
+        hits += layout.PointToIndex(x, y, scroll) >= 0;
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    
+    std::wstring line;
+    line = Format(L"%-10ls %7.1f ns/query  %d items  %lld of %d points on an icon\n",
+                  L"hittest", elapsed / HIT_TEST_QUERIES, HIT_TEST_ITEMS, static_cast<long long>(hits), HIT_TEST_QUERIES);
+    return line;
+}
+
+bool FrameBenchmark::WriteReport(const FrameBenchmarkOptions& options, const std::wstring& report) {
+    std::string utf8 = ToUtf8(report);
+    if (!options.reportPath.empty()) {
+        BinaryFile file;
+        return file.Open(options.reportPath, true) && file.WriteAt(0, utf8.data(), utf8.size());
+    }
+    
+#ifdef _WIN32
+    // A GUI process has no console of its own; borrow the one it was started from
+    AttachConsole(ATTACH_PARENT_PROCESS);
+    HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+    if (output == INVALID_HANDLE_VALUE || output == nullptr) {
+        return false;
+    }
+    
+    DWORD bytesWritten = 0;
+    return WriteFile(output, utf8.data(), static_cast<DWORD>(utf8.size()), &bytesWritten, nullptr) &&
+           bytesWritten == utf8.size();
+#else
+    return fwrite(utf8.data(), 1, utf8.size(), stdout) == utf8.size() && fflush(stdout) == 0;
+#endif
+}
+
+void FrameBenchmark::BuildTabs(const std::vector<int>& shortcutCounts, int iconSize, std::vector<TabInfo>& tabs) {
+    tabs.clear();
+    tabs.resize(shortcutCounts.size());
+    
+    int seed = 0;
+    for (size_t t = 0; t < tabs.size(); t++) {
+        tabs[t].name = L"Tab " + std::to_wstring(t + 1);
+        tabs[t].shortcuts.resize(max(0, shortcutCounts[t]));
+        
+        for (ShortcutInfo& shortcut : tabs[t].shortcuts) {
+            // Names of varying length, so labels wrap to one, two or three lines
+            static const wchar_t* words[] = {L"Star", L"Quest", L"Legends of the", L"Racing", L"Chronicles", L"Tactics", L"Online"};
+            shortcut.displayName = words[seed % 7];
+            for (int w = 0; w < seed % 4; w++) {
+                shortcut.displayName += L" ";
+                shortcut.displayName += words[(seed / 7 + w * 3) % 7];
+            }
+            shortcut.displayName += L" " + std::to_wstring(seed);
+            shortcut.isValid = true;
+            
+            // Every tenth shortcut has no icon and shows the placeholder
+            if (seed % 10 != 9) {
+                IconHandle handle = IconPixelPool::Instance().Allocate(iconSize, iconSize);
+                uint32_t* pixels = IconPixelPool::Instance().GetPixels(handle);
+                if (pixels) {
+                    FillIcon(pixels, iconSize, seed);
+                    shortcut.SetIconPixels(handle, iconSize, iconSize);
+                } else if (handle) {
+                    IconPixelPool::Instance().Release(handle);
+                }
+            }
+            seed++;
+        }
+    }
+}
+
+void FrameBenchmark::FillIcon(uint32_t* pixels, int size, int seed) {
+    // Disc with a soft edge over a transparent corner area, tinted per seed, premultiplied
+    uint32_t red = 64 + (seed * 53) % 192;
+    uint32_t green = 64 + (seed * 97) % 192;
+    uint32_t blue = 64 + (seed * 29) % 192;
+    float center = size / 2.0f;
+    float radius = size * 0.45f;
+    
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            float dx = x + 0.5f - center;
+            float dy = y + 0.5f - center;
+            float edge = radius - sqrtf(dx * dx + dy * dy);
+            uint32_t alpha = edge >= 1.0f ? 255 : edge <= 0.0f ? 0 : static_cast<uint32_t>(edge * 255.0f);
+            uint32_t shade = 128 + (x * 127) / size;
+            pixels[y * size + x] = (alpha << 24) |
+                                   (PixelOps::MultiplyAlpha(red * shade / 255, alpha) << 16) |
+                                   (PixelOps::MultiplyAlpha(green * shade / 255, alpha) << 8) |
+                                   PixelOps::MultiplyAlpha(blue * shade / 255, alpha);
+        }
+    }
+}
+
+double FrameBenchmark::Percentile(const std::vector<double>& sorted, double share) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(share * (sorted.size() - 1) + 0.5);
+    return sorted[min(index, sorted.size() - 1)];
+}
+
+std::wstring FrameBenchmark::Format(const wchar_t* format, ...) {
+    wchar_t buffer[512];
+    va_list args;
+    va_start(args, format);
+    int length = vswprintf(buffer, sizeof(buffer) / sizeof(buffer[0]), format, args);
+    va_end(args);
+    return length > 0 ? std::wstring(buffer, length) : std::wstring();
+}
+
+std::string FrameBenchmark::ToUtf8(const std::wstring& text) {
+    // wchar_t is UTF-16 on Windows and UTF-32 elsewhere
+    std::string utf8;
+    for (size_t i = 0; i < text.size(); i++) {
+        uint32_t code = static_cast<uint32_t>(text[i]);
+        if (code >= 0xD800 && code < 0xDC00 && i + 1 < text.size()) {
+            uint32_t low = static_cast<uint32_t>(text[i + 1]);
+            if (low >= 0xDC00 && low < 0xE000) {
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            }
+        }
+        if (code < 0x80) {
+            utf8 += static_cast<char>(code);
+        } else if (code < 0x800) {
+            utf8 += static_cast<char>(0xC0 | (code >> 6));
+            utf8 += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            utf8 += static_cast<char>(0xE0 | (code >> 12));
+            utf8 += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            utf8 += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            utf8 += static_cast<char>(0xF0 | (code >> 18));
+            utf8 += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            utf8 += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            utf8 += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+    return utf8;
+}
+
+std::wstring FrameBenchmark::GetDumpPath(const FrameBenchmarkOptions& options, const wchar_t* name) {
+#ifdef _WIN32
+    return options.dumpFolder + L"\\" + name + L".png";
+#else
+    return options.dumpFolder + L"/" + name + L".png";
+#endif
+}
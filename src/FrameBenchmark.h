@@ -0,0 +1,83 @@
+// FrameBenchmark.h - Paint performance scenarios on the headless renderer
+#pragma once
+
+#include <string>
+#include <vector>
+#include "DataModels.h"
+#include "Raster.h"
+
+struct FrameBenchmarkOptions {
+    int width = 3840;
+    int height = 2160;
+    int dpiPercent = 200;
+    int tabCount = 4;
+    int shortcutsPerTab = 200;
+    int frames = 120;               // Timed frames per scenario
+    bool iconAtlas = true;          // Draw icons from per-tab atlases (--no-atlas turns them off)
+    bool contentLayer = true;       // Reuse the frame content on selection changes (--no-layer turns it off)
+    std::wstring dumpFolder;        // Last frame of each scenario is saved here as PNG when set
+    std::wstring reportPath;        // Report goes here instead of the console when set
+    std::wstring replayPath;        // Replay this input recording instead of the scenarios when set
+};
+
+// Runs idle, full repaint, selection move, scroll and tab switch scenarios on synthetic
+// tabs and reports milliseconds per frame. After each scenario the incrementally painted
+// frame is compared with a full repaint, so damage tracking bugs show up as mismatches.
+// A scripted session of wheel flicks and stick pushes then glides through ScrollPhysics on
+// a fixed frame clock, to show how steady frame times stay while scrolling. Hover hit
+// testing on a 10k icon grid and the main loop's input tick timing come last.
+// With --replay, a session recorded from the tray menu is rendered instead, one frame per
+// input and without waiting between them, at the size and DPI it was recorded at.
+// Started with "GameLauncher.exe --benchmark [--size WxH] [--dpi percent] [--frames n]
+// [--shortcuts n] [--no-atlas] [--no-layer] [--dump folder] [--report file] [--replay file]",
+// or on any platform with the frame_benchmark tool and the same options.
+class FrameBenchmark {
+public:
+    // False if the command line does not ask for a benchmark
+    static bool ParseCommandLine(const std::vector<std::wstring>& args, FrameBenchmarkOptions& options);
+    
+    // Run every scenario and return the report
+    static std::wstring Run(const FrameBenchmarkOptions& options);
+    
+    // Write the report where the options say; false if that failed
+    static bool WriteReport(const FrameBenchmarkOptions& options, const std::wstring& report);
+    
+    // Synthetic tabs of the given sizes with names and icons of varying shapes, as the
+    // scenarios draw them
+    static void BuildTabs(const std::vector<int>& shortcutCounts, int iconSize, std::vector<TabInfo>& tabs);
+
+private:
+    static void FillIcon(uint32_t* pixels, int size, int seed);
+    
+    // Render GLIDE_SECONDS of wheel and stick scrolling at GLIDE_FRAME_RATE, one physics
+    // step per frame, and report frame times, their spread and the frames over budget
+    static std::wstring MeasureGlide(const FrameBenchmarkOptions& options);
+    
+    // Time GridLayout::PointToIndex on random points of a HIT_TEST_ITEMS grid
+    static std::wstring MeasureHitTest(const FrameBenchmarkOptions& options);
+    
+    // Time how late the main loop's input ticks run and how often it wakes
+    static std::wstring MeasureTicks();
+    
+    // Render the recorded session in options.replayPath on synthetic tabs of the recorded sizes
+    static std::wstring MeasureReplay(const FrameBenchmarkOptions& options);
+    static bool ReadWholeFile(const std::wstring& path, std::vector<uint8_t>& data);
+    
+    // FNV-1a over the frame, to tell whether two replays drew the same frames
+    static uint64_t HashFrame(const RasterImage& frame, uint64_t hash);
+    
+    // Value below which share (0..1) of the sorted samples fall
+    static double Percentile(const std::vector<double>& sorted, double share);
+    
+    // printf into a wide string; %ls for wide strings, as every platform reads it the same
+    static std::wstring Format(const wchar_t* format, ...);
+    static std::string ToUtf8(const std::wstring& text);
+    static std::wstring GetDumpPath(const FrameBenchmarkOptions& options, const wchar_t* name);
+    
+    static const int GLIDE_FRAME_RATE = 120;
+    static const int GLIDE_SECONDS = 4;
+    static const int HIT_TEST_ITEMS = 10000;
+    static const int HIT_TEST_QUERIES = 1000000;
+    static const int64_t TICK_TEST_MICROSECONDS = 2000000;
+    static const int64_t MAX_REPLAY_FILE_SIZE = 256 * 1024 * 1024;
+};
@@ -0,0 +1,300 @@
+// FrameComposer.cpp - Frame composition implementation
+#include "FrameComposer.h"
+#include "GridRenderer.h"
+#include "ScrollBlit.h"
+#include "Settings.h"
+#include "WorkerPool.h"
+
+FrameComposer::FrameComposer(GridRenderer* renderer)
+    : gridRenderer(renderer)
+    , tabBufferWidth(0)
+    , tabBufferHeight(0)
+    , tabBufferDirty(true)
+    , renderThreadCount(0)
+    , layerWidth(0)
+    , layerHeight(0)
+    , layerDirty(true)
+    , contentLayerEnabled(true)
+{
+}
+
+FrameComposer::~FrameComposer() {
+    // Out of line, where WorkerPool is complete
+}
+
+void FrameComposer::Compose(const RasterSurface& frame, const DamageRegion& damage, const FrameState& state) {
+    if (!frame.pixels || damage.IsEmpty()) {
+        return;
+    }
+    
+#ifdef _WIN32
+    // GDI batches drawing calls - make sure none is still writing a buffer we read
+    GdiFlush();
+#endif
+    
+    static const std::vector<TabInfo> noTabs;
+    const std::vector<TabInfo>& tabs = state.tabs ? *state.tabs : noTabs;
+    const RECT& clientRect = state.clientRect;
+    RECT tabBarRect = GetTabBarRect(clientRect);
+    bool hasGrid = gridRenderer && state.activeTabIndex >= 0 && state.activeTabIndex < static_cast<int>(tabs.size());
+    
+    if (!tabs.empty()) {
+        UpdateTabBuffer(tabs, state.activeTabIndex, clientRect);
+    }
+    
+    if (hasGrid) {
+        gridRenderer->SetShortcuts(&tabs[state.activeTabIndex].shortcuts);
+        gridRenderer->SetScrollOffset(state.scrollOffset);
+        gridRenderer->SetSelectedIcon(state.selectedIconIndex);
+        gridRenderer->SetDpiScaleFactor(state.dpiScaleFactor);
+        gridRenderer->SetIconLabelFontSize(Settings::Instance().GetIconLabelFontSize());
+        gridRenderer->SetLayout(GetGridLayout(clientRect, static_cast<int>(tabs[state.activeTabIndex].shortcuts.size())));
+        gridRenderer->PrepareFrame();
+    }
+    
+    // The frame is composed in premultiplied BGRA straight into the buffer, so every
+    // pixel already has its final alpha. Damage is cut into bands that never overlap;
+    // each pixel is cleared and blended over once, by one tile, in the same order
+    // whichever thread draws it, so the frame doesn't depend on the thread count.
+    PixelRect clientBounds(clientRect.left, clientRect.top, clientRect.right, clientRect.bottom);
+    RasterImage tabImage{tabBuffer.data(), tabBufferWidth, tabBufferHeight, tabBufferWidth};
+    damage.GetTiles(RENDER_TILE_HEIGHT, frameTiles);
+    
+    // Content goes to the layer when there is one; the frame gets it from there
+    bool useLayer = PrepareContentLayer(frame, state);
+    RasterSurface layer;
+    layer.pixels = contentLayer.data();
+    layer.width = layerWidth;
+    layer.height = layerHeight;
+    layer.stride = layerWidth;
+    const RasterSurface& target = useLayer ? layer : frame;
+    
+    auto drawContent = [&](const PixelRect& rect) {
+        // Clear to nearly transparent (alpha=1 for hit testing, visually transparent)
+        Raster::FillRect(target, rect, 0x01000000, rect);
+        
+        PixelRect area = PixelRect::Intersect(rect, clientBounds);
+        if (area.IsEmpty()) return;
+        
+        if (!tabs.empty()) {
+            Raster::Copy(target, tabBarRect.left, tabBarRect.top, tabImage, area);
+        }
+        
+        if (hasGrid) {
+            gridRenderer->Render(target, area);
+        }
+    };
+    
+    auto renderTile = [&](size_t index, size_t /*worker*/) {
+        const PixelRect& tile = frameTiles[index];
+        
+        if (useLayer) {
+            for (const PixelRect& stale : layerStale.GetRects()) {
+                PixelRect redraw = PixelRect::Intersect(stale, tile);
+                if (!redraw.IsEmpty()) {
+                    drawContent(redraw);
+                }
+            }
+            Raster::Copy(frame, 0, 0, layer.AsImage(), tile);
+        } else {
+            drawContent(tile);
+        }
+        
+        // Selection border last, over the finished content
+        if (hasGrid) {
+            gridRenderer->RenderSelection(frame, PixelRect::Intersect(tile, clientBounds));
+        }
+    };
+    
+    // Full repaints (resize, tab switch) are worth waking the pool for; small ones
+    // like a selection change or a scrolled-in band are not
+    if (damage.GetArea() >= PARALLEL_RENDER_MIN_PIXELS && frameTiles.size() > 1) {
+        if (!renderPool) {
+            renderPool = std::make_unique<WorkerPool>(renderThreadCount);
+        }
+        renderPool->ParallelFor(frameTiles.size(), renderTile);
+    } else {
+        for (size_t i = 0; i < frameTiles.size(); i++) {
+            renderTile(i, 0);
+        }
+    }
+    
+    if (useLayer) {
+        for (const PixelRect& rect : damage.GetRects()) {
+            layerStale.Remove(rect);
+        }
+    }
+}
+
+void FrameComposer::ScrollLayer(const PixelRect& area, int dy) {
+    if (contentLayer.empty() || dy == 0) {
+        return;
+    }
+    
+    // Same steps the caller took for the frame
+    PixelRect scrollArea = PixelRect::Intersect(area, PixelRect(0, 0, layerWidth, layerHeight));
+    layerStale.Scroll(scrollArea, dy);
+    layerStale.Add(ScrollBlit::ScrollRows(contentLayer.data(), layerWidth, scrollArea, dy));
+    
+    // Icons reach into the margin above the area, which the blit leaves behind
+    layerStale.Add(PixelRect::Intersect(PixelRect(scrollArea.left, scrollArea.top - DesignConstants::SELECTION_BORDER_EXTENSION,
+                                                  scrollArea.right, scrollArea.top),
+                                        PixelRect(0, 0, layerWidth, layerHeight)));
+    layerState.scrollOffset += dy;
+}
+
+void FrameComposer::SetContentLayerEnabled(bool enabled) {
+    contentLayerEnabled = enabled;
+    if (!enabled) {
+        std::vector<uint32_t>().swap(contentLayer);
+        layerWidth = 0;
+        layerHeight = 0;
+        layerDirty = true;
+    }
+}
+
+void FrameComposer::SetRenderThreadCount(size_t threadCount) {
+    if (threadCount != renderThreadCount) {
+        renderThreadCount = threadCount;
+        renderPool.reset();
+    }
+}
+
+bool FrameComposer::PrepareContentLayer(const RasterSurface& frame, const FrameState& state) {
+    if (!contentLayerEnabled) {
+        return false;
+    }
+    
+    if (layerWidth != frame.width || layerHeight != frame.height) {
+        contentLayer.assign(static_cast<size_t>(frame.width) * frame.height, 0);
+        layerWidth = frame.width;
+        layerHeight = frame.height;
+        layerDirty = true;
+    }
+    
+    // Anything but the selection changing makes the layer useless
+    const RECT& rect = state.clientRect;
+    const RECT& layerRect = layerState.clientRect;
+    if (layerDirty || state.tabs != layerState.tabs || state.activeTabIndex != layerState.activeTabIndex ||
+        state.scrollOffset != layerState.scrollOffset || state.dpiScaleFactor != layerState.dpiScaleFactor ||
+        rect.left != layerRect.left || rect.top != layerRect.top ||
+        rect.right != layerRect.right || rect.bottom != layerRect.bottom) {
+        layerStale.Clear();
+        layerStale.Add(PixelRect(0, 0, layerWidth, layerHeight));
+        layerState = state;
+        layerDirty = false;
+    }
+    return !contentLayer.empty();
+}
+
+void FrameComposer::UpdateTabBuffer(const std::vector<TabInfo>& tabs, int activeTabIndex, const RECT& clientRect) {
+    RECT tabBarRect = GetTabBarRect(clientRect);
+    int width = tabBarRect.right - tabBarRect.left;
+    int height = tabBarRect.bottom - tabBarRect.top;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    
+    // Resize tab buffer if needed
+    if (tabBufferWidth != width || tabBufferHeight != height) {
+        tabBuffer.assign(static_cast<size_t>(width) * height, 0);
+        tabBufferWidth = width;
+        tabBufferHeight = height;
+        tabBufferDirty = true;
+    }
+    
+    // Render tabs to buffer if dirty
+    if (tabBufferDirty) {
+        RasterSurface surface;
+        surface.pixels = tabBuffer.data();
+        surface.width = width;
+        surface.height = height;
+        surface.stride = width;
+        
+        // Fill background
+        Raster::FillRect(surface, surface.Bounds(), TAB_BAR_COLOR, surface.Bounds());
+        tabText.SetFont(Settings::Instance().GetTabFontSize(), true);
+        
+        int tabWidth = width / static_cast<int>(tabs.size());
+        
+        for (size_t i = 0; i < tabs.size(); ++i) {
+            PixelRect tabRect(static_cast<int>(i) * tabWidth, 0, static_cast<int>(i + 1) * tabWidth, height);
+            if (i == tabs.size() - 1) {
+                tabRect.right = width;
+            }
+            
+            // Draw tab background
+            bool isActiveTab = (static_cast<int>(i) == activeTabIndex);
+            COLORREF baseColor = GetTabColor(tabs[i].name, isActiveTab);
+            uint32_t tabColor = 0xFF000000 | (GetRValue(baseColor) << 16) |
+                                (GetGValue(baseColor) << 8) | GetBValue(baseColor);
+            Raster::FillRect(surface, tabRect, tabColor, surface.Bounds());
+            
+            // Draw tab border, one pixel wide along the top and left edges; like a GDI pen
+            // outline its right and bottom edges fall just outside, under the next tab
+            PixelRect borderRect(tabRect.left, tabRect.top, tabRect.right + 1, tabRect.bottom + 1);
+            Raster::OutlineRect(surface, borderRect, 1, TAB_BORDER_COLOR, surface.Bounds());
+            
+            // Draw tab text, white over the tab
+            PixelRect textRect(tabRect.left + 8, tabRect.top + 4, tabRect.right - 8, tabRect.bottom - 4);
+            if (textRect.IsEmpty() ||
+                !tabText.Rasterize(tabs[i].name, textRect.Width(), textRect.Height(), TextLayout::SingleLineCentered,
+                                   tabTextCoverage)) {
+                continue;
+            }
+            tabTextPixels.resize(tabTextCoverage.size());
+            for (size_t p = 0; p < tabTextCoverage.size(); p++) {
+                uint32_t coverage = tabTextCoverage[p];
+                tabTextPixels[p] = (coverage << 24) | (coverage << 16) | (coverage << 8) | coverage;
+            }
+            RasterImage textImage{tabTextPixels.data(), textRect.Width(), textRect.Height(), textRect.Width()};
+            Raster::BlendOver(surface, textRect.left, textRect.top, textImage, textRect);
+        }
+        
+        tabBufferDirty = false;
+    }
+}
+
+RECT FrameComposer::GetTabBarRect(const RECT& clientRect) {
+    RECT tabBarRect = clientRect;
+    tabBarRect.bottom = tabBarRect.top + Settings::Instance().GetTabHeight();
+    return tabBarRect;
+}
+
+RECT FrameComposer::GetGridRect(const RECT& clientRect) {
+    RECT gridRect = clientRect;
+    gridRect.top += Settings::Instance().GetTabHeight();
+    
+    // Apply equal margins on all sides (left, right, and additional top margin)
+    // The top already has TAB_HEIGHT, so we add GRID_MARGIN to match lateral margins
+    gridRect.top += DesignConstants::GRID_MARGIN;
+    gridRect.left += DesignConstants::GRID_MARGIN;
+    gridRect.right -= DesignConstants::GRID_MARGIN;
+    gridRect.bottom -= DesignConstants::GRID_MARGIN;
+    
+    return gridRect;
+}
+
+GridLayout FrameComposer::GetGridLayout(const RECT& clientRect, int itemCount) {
+    GridMetrics metrics;
+    metrics.iconSize = static_cast<int>(DesignConstants::TARGET_ICON_SIZE_PIXELS * Settings::Instance().GetIconScale());
+    metrics.spacingHorizontal = Settings::Instance().GetIconSpacingHorizontal();
+    metrics.spacingVertical = Settings::Instance().GetIconSpacingVertical();
+    metrics.labelHeight = DesignConstants::LABEL_HEIGHT;
+    metrics.verticalPadding = Settings::Instance().GetIconVerticalPadding();
+    metrics.borderPadding = DesignConstants::SELECTION_BORDER_PADDING;
+    metrics.borderExtension = DesignConstants::SELECTION_BORDER_EXTENSION;
+    
+    RECT gridRect = GetGridRect(clientRect);
+    return GridLayout(PixelRect(gridRect.left, gridRect.top, gridRect.right, gridRect.bottom), itemCount, metrics);
+}
+
+COLORREF FrameComposer::GetTabColor(const std::wstring& tabName, bool isActive) {
+    if (!isActive) {
+        return Settings::Instance().GetTabInactiveColor();
+    }
+    
+    // Check if this tab has a specific color defined
+    COLORREF tabColor = Settings::Instance().GetTabColor(tabName);
+    return tabColor;
+}
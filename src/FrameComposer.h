@@ -0,0 +1,101 @@
+// FrameComposer.h - Composes the launcher frame (tab bar and icon grid) into a pixel buffer
+#pragma once
+
+#include "PlatformTypes.h"
+#include <memory>
+#include <vector>
+#include "DataModels.h"
+#include "DamageRegion.h"
+#include "GridLayout.h"
+#include "Raster.h"
+#include "TextRasterizer.h"
+
+class GridRenderer;
+class WorkerPool;
+
+// Everything a frame depends on besides Settings
+struct FrameState {
+    const std::vector<TabInfo>* tabs = nullptr;  // Non-owning
+    int activeTabIndex = 0;
+    int scrollOffset = 0;
+    int selectedIconIndex = -1;
+    float dpiScaleFactor = 1.0f;
+    RECT clientRect = {0, 0, 0, 0};
+};
+
+// Draws the window contents without needing a window: the WM_PAINT path and the
+// headless renderer both go through Compose, so they produce the same pixels.
+class FrameComposer {
+public:
+    explicit FrameComposer(GridRenderer* gridRenderer);
+    ~FrameComposer();
+    
+    // Delete copy/move
+    FrameComposer(const FrameComposer&) = delete;
+    FrameComposer& operator=(const FrameComposer&) = delete;
+    
+    // The tab bar is cached; call when tab names, the active tab or tab settings change
+    void InvalidateTabs() { tabBufferDirty = true; layerDirty = true; }
+    
+    // Draw the grid from scratch on the next Compose instead of reusing the content layer
+    void InvalidateContent() { layerDirty = true; }
+    
+    // Redraw the parts of frame covered by damage for state
+    void Compose(const RasterSurface& frame, const DamageRegion& damage, const FrameState& state);
+    
+    // The frame's grid pixels in area were moved up by dy rows after the scroll offset
+    // changed by dy; move the content layer along so it stays reusable
+    void ScrollLayer(const PixelRect& area, int dy);
+    
+    // Keep a copy of the frame without the selection border (on by default)
+    void SetContentLayerEnabled(bool enabled);
+    
+    // Workers for large repaints, the calling thread included; 0 (the default) uses
+    // every hardware thread. The frame is the same whatever the count.
+    void SetRenderThreadCount(size_t threadCount);
+    
+    static RECT GetTabBarRect(const RECT& clientRect);
+    static RECT GetGridRect(const RECT& clientRect);
+    
+    // Geometry of a grid of itemCount icons with the current settings; Compose lays the
+    // grid out with this, so hit testing through it matches what was drawn
+    static GridLayout GetGridLayout(const RECT& clientRect, int itemCount);
+    static COLORREF GetTabColor(const std::wstring& tabName, bool isActive);
+    
+    static const int RENDER_TILE_HEIGHT = 64;                // Rows per parallel render tile
+    static const int PARALLEL_RENDER_MIN_PIXELS = 512 * 512; // Smaller repaints render on the calling thread alone
+
+private:
+    GridRenderer* gridRenderer;     // Non-owning pointer
+    
+    // Cached tab bar pixels
+    std::vector<uint32_t> tabBuffer;
+    int tabBufferWidth;
+    int tabBufferHeight;
+    bool tabBufferDirty;            // Track if tabs need redrawing
+    TextRasterizer tabText;         // Draws the tab names
+    std::vector<uint8_t> tabTextCoverage;
+    std::vector<uint32_t> tabTextPixels;    // A tab name in premultiplied white, ready to blend
+    
+    std::unique_ptr<WorkerPool> renderPool;  // Renders large repaints in parallel tiles, created on first use
+    size_t renderThreadCount;                // Size of renderPool, 0 for the hardware thread count
+    std::vector<PixelRect> frameTiles;       // Damage split into bands for the current frame
+    
+    // Frame content without the selection border. A selection change only copies the
+    // areas the border leaves and enters back from here and draws the border on top.
+    std::vector<uint32_t> contentLayer;
+    int layerWidth;
+    int layerHeight;
+    DamageRegion layerStale;        // Parts of contentLayer not drawn for layerState yet
+    FrameState layerState;          // State contentLayer was drawn for; the selection is ignored
+    bool layerDirty;                // All of contentLayer is stale
+    bool contentLayerEnabled;
+    
+    // Make contentLayer match frame and state, marking what can't be reused as stale
+    bool PrepareContentLayer(const RasterSurface& frame, const FrameState& state);
+    
+    void UpdateTabBuffer(const std::vector<TabInfo>& tabs, int activeTabIndex, const RECT& clientRect);
+    
+    static const uint32_t TAB_BAR_COLOR = 0xFF2D2D32;
+    static const uint32_t TAB_BORDER_COLOR = 0xFF64646B;    // RGB(100, 100, 107)
+};
@@ -1,6 +1,8 @@
 // GameLauncher.cpp - Main application entry point
 #include "GameLauncher.h"
+#include "FrameBenchmark.h"
 #include <iostream>
+#include <shellapi.h>
 #include <shellscalingapi.h>
 
 #pragma comment(lib, "shcore.lib")
@@ -9,6 +11,17 @@ int WINAPI WinMain(HINSTANCE /*hInstance*/, HINSTANCE /*hPrevInstance*/, LPSTR /
     // Set DPI awareness as the very first thing
     SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
     
+    // Headless paint benchmark: no window, no tray, no single-instance check
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    std::vector<std::wstring> args(argv, argv + (argv ? argc : 0));
+    LocalFree(argv);
+    
+    FrameBenchmarkOptions benchmarkOptions;
+    if (FrameBenchmark::ParseCommandLine(args, benchmarkOptions)) {
+        return FrameBenchmark::WriteReport(benchmarkOptions, FrameBenchmark::Run(benchmarkOptions)) ? 0 : 1;
+    }
+    
     GameLauncher launcher;
     
     // Check for single instance
@@ -5,6 +5,7 @@
 #include <string>
 #include <memory>
 #include "DataModels.h"
+#include "MessageLoop.h"
 #include "WindowManager.h"
 #include "TrayManager.h"
 #include "ShortcutScanner.h"
@@ -26,10 +27,12 @@ private:
     std::unique_ptr<WindowManager> windowManager;
     std::unique_ptr<TrayManager> trayManager;
     std::unique_ptr<ShortcutScanner> scanner;
+    MessageLoop messageLoop;
     
     // Single instance management
     HANDLE singleInstanceMutex;
     HWND messageWindow;
+    bool comInitialized;
     
     // Private methods
     void CreateMessageWindow();
@@ -18,6 +18,7 @@ const UINT GameLauncher::WM_TOGGLE_VISIBILITY = WM_USER + 1;
 GameLauncher::GameLauncher() 
     : singleInstanceMutex(nullptr)
     , messageWindow(nullptr)
+    , comInitialized(false)
 {
     instance = this;
 }
@@ -31,6 +32,10 @@ GameLauncher::~GameLauncher() {
 bool GameLauncher::Initialize() {
     // DPI awareness is now set in WinMain before this function is called
     
+    // Initialize COM for ShellExecute (shell extensions may rely on it)
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+    comInitialized = SUCCEEDED(hr);
+    
     // Get executable folder
     wchar_t buffer[MAX_PATH];
     GetModuleFileNameW(NULL, buffer, MAX_PATH);
@@ -51,8 +56,8 @@ bool GameLauncher::Initialize() {
     // Create message window for inter-process communication
     CreateMessageWindow();
     
-    // Initialize scanner with folder
-    if (!scanner->Initialize(exeFolder + L"\\Data")) {
+    // Initialize scanner with folder, plus the catalog and icon cache kept next to launcher.ini
+    if (!scanner->Initialize(exeFolder + L"\\Data", exeFolder + L"\\launcher.catalog", exeFolder + L"\\launcher.iconcache")) {
         return false;
     }
   
@@ -79,31 +84,12 @@ bool GameLauncher::Initialize() {
 }
 
 int GameLauncher::Run() {
-    // Main message loop with controller input support
-    MSG msg = {};
-    bool running = true;
-    
-    while (running) {
-        // Check for Windows messages first
-        if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
-            if (msg.message == WM_QUIT) {
-                running = false;
-            } else {
-                TranslateMessage(&msg);
-                DispatchMessage(&msg);
-            }
-        } else {
-            // No Windows messages - check controller input if window is visible and has focus
-            if (windowManager && windowManager->IsVisible()/* && windowManager->HasFocus()*/) {
-                windowManager->HandleControllerInput();
-            }
-            
-            // Small sleep to prevent excessive CPU usage
-            Sleep(1);
-        }
-    }
-    
-    return static_cast<int>(msg.wParam);
+    // Sleep until a message arrives. The controller is polled on the input thread,
+    // which posts a message when there is input to handle. Only a gliding scroll
+    // wakes the loop on its own, once per display frame.
+    messageLoop.SetTickRate(windowManager->GetRefreshRate());
+    return messageLoop.Run([this]() { return windowManager->IsScrolling(); },
+                           [this]() { windowManager->AdvanceScroll(); });
 }
 
 void GameLauncher::Shutdown() {
@@ -125,6 +111,11 @@ void GameLauncher::Shutdown() {
         CloseHandle(singleInstanceMutex);
         singleInstanceMutex = nullptr;
     }
+    
+    if (comInitialized) {
+        CoUninitialize();
+        comInitialized = false;
+    }
 }
 
 bool GameLauncher::CheckSingleInstance() {
@@ -0,0 +1,155 @@
+// GridLayout.cpp - Icon grid geometry implementation
+#include "GridLayout.h"
+#include <algorithm>
+
+namespace {
+    // Division rounding toward negative infinity, for rows above the area
+    int FloorDivide(int value, int divisor) {
+        return value >= 0 ? value / divisor : -((divisor - 1 - value) / divisor);
+    }
+}
+
+GridLayout::GridLayout()
+    : itemCount(0)
+    , columns(0)
+    , rows(0)
+    , startX(0)
+    , startY(0)
+{
+}
+
+GridLayout::GridLayout(const PixelRect& gridArea, int count, const GridMetrics& gridMetrics)
+    : area(gridArea)
+    , itemCount(std::max(0, count))
+    , metrics(gridMetrics)
+    , columns(0)
+    , rows(0)
+    , startX(gridArea.left)
+    , startY(gridArea.top + gridMetrics.borderPadding)
+{
+    if (metrics.iconSize <= 0 || GetColumnWidth() <= 0 || GetRowHeight() <= 0) {
+        itemCount = 0;
+        return;
+    }
+    
+    // As many columns as fit, at least one, centered horizontally
+    columns = std::max(1, area.Width() / GetColumnWidth());
+    rows = (itemCount + columns - 1) / columns;
+    startX = area.left + (area.Width() - GetTotalWidth()) / 2;
+}
+
+int GridLayout::GetMaxScroll() const {
+    return std::max(0, rows * GetRowHeight() - area.Height());
+}
+
+int GridLayout::ClampScroll(int scrollOffset) const {
+    return std::max(0, std::min(scrollOffset, GetMaxScroll()));
+}
+
+PixelRect GridLayout::IndexToRect(int index, int scrollOffset) const {
+    if (index < 0 || index >= itemCount || columns == 0) {
+        return PixelRect();
+    }
+    
+    int left = startX + (index % columns) * GetColumnWidth();
+    int top = startY + (index / columns) * GetRowHeight() - scrollOffset;
+    return PixelRect(left, top, left + metrics.iconSize, top + metrics.iconSize);
+}
+
+PixelRect GridLayout::GetItemBounds(int index, int scrollOffset) const {
+    PixelRect icon = IndexToRect(index, scrollOffset);
+    if (icon.IsEmpty()) {
+        return icon;
+    }
+    return PixelRect(icon.left - metrics.borderExtension, icon.top - metrics.borderExtension,
+                     icon.right + metrics.borderExtension,
+                     icon.bottom + metrics.labelHeight + metrics.verticalPadding + metrics.borderPadding);
+}
+
+int GridLayout::PointToIndex(int x, int y, int scrollOffset) const {
+    if (IsEmpty()) {
+        return -1;
+    }
+    
+    int localX = x - startX;
+    if (localX < 0) {
+        return -1;
+    }
+    int column = localX / GetColumnWidth();
+    if (column >= columns || localX - column * GetColumnWidth() >= metrics.iconSize) {
+        return -1;
+    }
+    
+    // Rows whose icon and label span [0, hitHeight) covers localY; the first one wins
+    int localY = y - startY + scrollOffset;
+    int hitHeight = metrics.iconSize + metrics.borderPadding + metrics.labelHeight;
+    if (localY < 0 || hitHeight <= 0) {
+        return -1;
+    }
+    int reach = localY - hitHeight + 1;
+    int row = reach > 0 ? (reach + GetRowHeight() - 1) / GetRowHeight() : 0;
+    if (row > localY / GetRowHeight()) {
+        return -1;
+    }
+    
+    int index = row * columns + column;
+    return index < itemCount ? index : -1;
+}
+
+void GridLayout::GetVisibleRange(int scrollOffset, int& first, int& last) const {
+    first = last = 0;
+    if (IsEmpty()) {
+        return;
+    }
+    
+    // Rows whose cell overlaps the area, plus one on each side for the selection
+    // border and label overhang
+    int firstRow = FloorDivide(area.top - startY + scrollOffset, GetRowHeight()) - 1;
+    int lastRow = FloorDivide(area.bottom - startY + scrollOffset, GetRowHeight()) + 1;
+    firstRow = std::max(0, firstRow);
+    lastRow = std::min(rows - 1, lastRow);
+    if (firstRow > lastRow) {
+        return;
+    }
+    
+    first = firstRow * columns;
+    last = std::min(itemCount, (lastRow + 1) * columns);
+}
+
+int GridLayout::GetFirstFullyVisibleIndex(int scrollOffset) const {
+    if (IsEmpty()) {
+        return -1;
+    }
+    
+    // A row partly scrolled out at the top doesn't count, so round up
+    int row = (std::max(0, scrollOffset) + GetRowHeight() - 1) / GetRowHeight();
+    return std::max(0, std::min(row * columns, itemCount - 1));
+}
+
+int GridLayout::ScrollToShow(int index, int scrollOffset) const {
+    if (index < 0 || index >= itemCount || IsEmpty()) {
+        return scrollOffset;
+    }
+    
+    // Item top relative to the area at scroll offset 0
+    int itemTop = metrics.borderPadding + (index / columns) * GetRowHeight();
+    
+    // Above the view: align the selection border with the area top
+    if (itemTop - scrollOffset - metrics.borderExtension < 0) {
+        return std::max(0, itemTop - metrics.borderExtension);
+    }
+    
+    // Below the view: align the label bottom with the area bottom
+    if (itemTop - scrollOffset + GetItemHeight() > area.Height()) {
+        return std::min(itemTop + GetItemHeight() - area.Height(), GetMaxScroll());
+    }
+    return scrollOffset;
+}
+
+PixelRect GridLayout::GetItemsBounds() const {
+    if (columns == 0) {
+        return PixelRect();
+    }
+    return PixelRect(startX - metrics.borderExtension, area.top - metrics.borderExtension,
+                     std::min(area.right, startX + GetTotalWidth() + metrics.borderExtension), area.bottom);
+}
@@ -0,0 +1,75 @@
+// GridLayout.h - Icon grid geometry with constant-time queries (portable, no Win32)
+#pragma once
+
+#include "DamageRegion.h"
+
+// Sizes the grid geometry depends on, in physical pixels
+struct GridMetrics {
+    int iconSize = 0;
+    int spacingHorizontal = 0;
+    int spacingVertical = 0;
+    int labelHeight = 0;
+    int verticalPadding = 0;        // Below each label
+    int borderPadding = 0;          // Above the first row, and between an icon and its label
+    int borderExtension = 0;        // How far the selection border reaches past an icon
+};
+
+// Where each icon of a tab goes in the grid area. A value is computed once per area,
+// item count or metrics change and never modified; every query is a few integer
+// operations, however many items there are. Rectangles are in the coordinates the
+// area is given in, with the scroll offset applied.
+class GridLayout {
+public:
+    GridLayout();
+    GridLayout(const PixelRect& area, int itemCount, const GridMetrics& metrics);
+    
+    bool IsEmpty() const { return itemCount == 0 || columns == 0; }
+    const PixelRect& GetArea() const { return area; }
+    const GridMetrics& GetMetrics() const { return metrics; }
+    int GetItemCount() const { return itemCount; }
+    int GetColumns() const { return columns; }
+    int GetRows() const { return rows; }
+    int GetIconSize() const { return metrics.iconSize; }
+    int GetColumnWidth() const { return metrics.iconSize + metrics.spacingHorizontal; }
+    int GetItemHeight() const { return metrics.iconSize + metrics.labelHeight + metrics.verticalPadding; }
+    int GetRowHeight() const { return GetItemHeight() + metrics.spacingVertical; }
+    
+    // Largest scroll offset that still fills the area, and an offset limited to it
+    int GetMaxScroll() const;
+    int ClampScroll(int scrollOffset) const;
+    
+    // Icon square of item index; empty for an index out of range
+    PixelRect IndexToRect(int index, int scrollOffset) const;
+    
+    // Icon, label and selection border of item index, which is what to repaint when
+    // it is selected or deselected
+    PixelRect GetItemBounds(int index, int scrollOffset) const;
+    
+    // Item whose icon or label is at (x, y), or -1. Where a label reaches into the next
+    // row the earlier item wins. Callers check that the point is inside the area.
+    int PointToIndex(int x, int y, int scrollOffset) const;
+    
+    // Items [first, last) that can touch the area, including the rows just outside it
+    // whose selection border or label overhang reaches in
+    void GetVisibleRange(int scrollOffset, int& first, int& last) const;
+    
+    // First item of the first row not cut off at the top
+    int GetFirstFullyVisibleIndex(int scrollOffset) const;
+    
+    // Scroll offset that brings item index fully into view with the least movement
+    int ScrollToShow(int index, int scrollOffset) const;
+    
+    // Columns in use plus the selection border, from the area top to its bottom
+    PixelRect GetItemsBounds() const;
+
+private:
+    PixelRect area;
+    int itemCount;
+    GridMetrics metrics;
+    int columns;
+    int rows;
+    int startX;                     // Left of the first column, centering the columns in the area
+    int startY;                     // Top of the first row at scroll offset 0
+    
+    int GetTotalWidth() const { return columns * GetColumnWidth() - metrics.spacingHorizontal; }
+};
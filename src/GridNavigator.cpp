@@ -0,0 +1,131 @@
+// GridNavigator.cpp - Selection, scroll and tab rules implementation
+#include "GridNavigator.h"
+#include <algorithm>
+
+bool NavigationState::operator==(const NavigationState& other) const {
+    return activeTabIndex == other.activeTabIndex &&
+           scrollOffset == other.scrollOffset &&
+           selectedIconIndex == other.selectedIconIndex &&
+           lastSelectedIconIndex == other.lastSelectedIconIndex &&
+           usingKeyboardNavigation == other.usingKeyboardNavigation;
+}
+
+void GridNavigator::Select(NavigationState& state, const GridLayout& layout, int index, bool fromKeyboard) {
+    // -1 is valid for no selection
+    if (layout.GetItemCount() == 0 || index < -1 || index >= layout.GetItemCount()) {
+        return;
+    }
+    
+    // Track last selected icon before clearing (but not when setting to -1)
+    if (state.selectedIconIndex != -1 && index == -1) {
+        state.lastSelectedIconIndex = state.selectedIconIndex;
+    } else if (index != -1) {
+        state.lastSelectedIconIndex = index;
+    }
+    
+    state.selectedIconIndex = index;
+    state.usingKeyboardNavigation = fromKeyboard;
+    
+    if (fromKeyboard && index != -1) {
+        state.scrollOffset = layout.ScrollToShow(index, state.scrollOffset);
+    }
+}
+
+void GridNavigator::Navigate(NavigationState& state, const GridLayout& layout, int moveX, int moveY) {
+    int totalIcons = layout.GetItemCount();
+    if (totalIcons == 0) {
+        return;
+    }
+    
+    state.usingKeyboardNavigation = true;
+    
+    // If no icon is selected, try to resume from last selected position
+    if (state.selectedIconIndex == -1) {
+        if (state.lastSelectedIconIndex != -1 && state.lastSelectedIconIndex < totalIcons) {
+            // Don't return - the movement below starts from there
+            state.selectedIconIndex = state.lastSelectedIconIndex;
+        } else {
+            Select(state, layout, layout.GetFirstFullyVisibleIndex(state.scrollOffset), true);
+            return;
+        }
+    }
+    
+    int selected = state.selectedIconIndex;
+    int cols = layout.GetColumns();
+    int newSelectedIndex = selected;
+    
+    // Horizontal movement
+    if (moveX < 0 && selected > 0) {
+        newSelectedIndex = selected - 1;
+    } else if (moveX > 0 && selected < totalIcons - 1) {
+        newSelectedIndex = selected + 1;
+    }
+    
+    // Vertical movement
+    if (moveY < 0 && selected >= cols) {
+        newSelectedIndex = selected - cols;
+    } else if (moveY > 0 && cols > 0) {
+        if (selected + cols < totalIcons) {
+            // There's an icon directly below
+            newSelectedIndex = selected + cols;
+        } else {
+            // No icon directly below; if there is another row, move to its last icon
+            int nextRowStart = (selected / cols + 1) * cols;
+            if (nextRowStart < totalIcons) {
+                newSelectedIndex = std::min(nextRowStart + cols - 1, totalIcons - 1);
+            }
+        }
+    }
+    
+    if (newSelectedIndex != selected) {
+        Select(state, layout, newSelectedIndex, true);
+    }
+}
+
+void GridNavigator::ScrollBy(NavigationState& state, const GridLayout& layout, int scrollDelta) {
+    if (layout.GetItemCount() == 0) {
+        return;
+    }
+    
+    int clampedScrollOffset = layout.ClampScroll(state.scrollOffset + scrollDelta);
+    if (clampedScrollOffset != state.scrollOffset) {
+        state.scrollOffset = clampedScrollOffset;
+        state.selectedIconIndex = layout.GetFirstFullyVisibleIndex(clampedScrollOffset);
+        state.usingKeyboardNavigation = true;
+    }
+}
+
+void GridNavigator::SelectTab(NavigationState& state, int tabIndex, int tabCount, int itemCount) {
+    if (tabIndex < 0 || tabIndex >= tabCount || tabIndex == state.activeTabIndex) {
+        return;
+    }
+    
+    state.activeTabIndex = tabIndex;
+    state.scrollOffset = 0;
+    if (itemCount > 0) {
+        state.selectedIconIndex = 0;
+        state.lastSelectedIconIndex = 0;
+        state.usingKeyboardNavigation = true;
+    } else {
+        state.selectedIconIndex = -1;
+        state.lastSelectedIconIndex = -1;
+        state.usingKeyboardNavigation = false;
+    }
+}
+
+void GridNavigator::ResetView(NavigationState& state) {
+    state.scrollOffset = 0;
+    state.selectedIconIndex = -1;
+    state.usingKeyboardNavigation = false;
+}
+
+uint32_t GridNavigator::Hash(const NavigationState& state, uint32_t hash) {
+    const int32_t values[] = {state.activeTabIndex, state.scrollOffset, state.selectedIconIndex,
+                              state.lastSelectedIconIndex, state.usingKeyboardNavigation ? 1 : 0};
+    for (int32_t value : values) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            hash = (hash ^ ((static_cast<uint32_t>(value) >> shift) & 0xFF)) * 16777619u;
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,45 @@
+// GridNavigator.h - Selection, scroll and tab rules of the launcher grid (portable, no Win32)
+#pragma once
+
+#include <cstdint>
+#include "GridLayout.h"
+
+// What input can change about what the launcher shows
+struct NavigationState {
+    int activeTabIndex = 0;
+    int scrollOffset = 0;
+    int selectedIconIndex = -1;
+    int lastSelectedIconIndex = -1;     // Where navigation resumes after the selection was cleared
+    bool usingKeyboardNavigation = false;
+    
+    bool operator==(const NavigationState& other) const;
+    bool operator!=(const NavigationState& other) const { return !(*this == other); }
+};
+
+// How keys, the controller, the wheel and the mouse move the selection, scroll and switch
+// tabs, without drawing anything. WindowManager repaints what a step changed; the input
+// replay runs the same steps on a recorded session. layout is the active tab's.
+class GridNavigator {
+public:
+    // Select index, or clear the selection with -1. From keys or a controller the icon
+    // is also scrolled into view.
+    static void Select(NavigationState& state, const GridLayout& layout, int index, bool fromKeyboard);
+    
+    // Move the selection one column (moveX) and/or one row (moveY). With nothing selected
+    // this resumes from the last selection, or selects the first fully visible icon.
+    static void Navigate(NavigationState& state, const GridLayout& layout, int moveX, int moveY);
+    
+    // Scroll by pixels within range; the first fully visible icon becomes selected
+    static void ScrollBy(NavigationState& state, const GridLayout& layout, int scrollDelta);
+    
+    // Show tab tabIndex from the top with its first icon selected; itemCount is its size
+    static void SelectTab(NavigationState& state, int tabIndex, int tabCount, int itemCount);
+    
+    // Back to the top with nothing selected, as after a resize
+    static void ResetView(NavigationState& state);
+    
+    // Fold state into a running FNV-1a hash, to compare two runs step by step
+    static uint32_t Hash(const NavigationState& state, uint32_t hash);
+    
+    static const uint32_t HASH_SEED = 2166136261u;
+};
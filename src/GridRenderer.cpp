@@ -2,297 +2,177 @@
 #include "GridRenderer.h"
 #include <algorithm>
 #include <cmath>
-#include <commctrl.h>
-
-#pragma comment(lib, "comctl32.lib")
 
 GridRenderer::GridRenderer() 
     : shortcuts(nullptr)
     , selectedIconIndex(-1)
     , scrollOffset(0)
     , dpiScaleFactor(1.0f)
-    , iconScale(1.0f)
     , iconLabelFontSize(36)
-    , iconSpacingHorizontal(12)
-    , iconSpacingVertical(12)
-    , iconVerticalPadding(4)
-    , cachedFont(nullptr)
-    , cachedSelectionPen(nullptr)
-    , cachedShadowPen(nullptr)
+    , labelCache([this](const std::wstring& text, int width, int height, std::vector<uint8_t>& coverage) {
+          return RasterizeLabel(text, width, height, coverage);
+      })
+    , frameFirstVisible(0)
+    , iconAtlasEnabled(true)
 {
-    // Font will be created dynamically based on iconLabelFontSize
-    
-    // Create cached pens for selection borders
-    cachedSelectionPen = CreatePen(PS_SOLID, DesignConstants::SELECTION_BORDER_PEN_WIDTH, RGB(255, 255, 255));
-    cachedShadowPen = CreatePen(PS_SOLID, DesignConstants::SELECTION_BORDER_PEN_WIDTH, RGB(32, 32, 32));
+    // Font will be created on first use based on iconLabelFontSize
 }
 
-GridRenderer::~GridRenderer() {
-    // Clean up cached GDI objects
-    if (cachedFont) {
-        DeleteObject(cachedFont);
-    }
-    if (cachedSelectionPen) {
-        DeleteObject(cachedSelectionPen);
-    }
-    if (cachedShadowPen) {
-        DeleteObject(cachedShadowPen);
-    }
-}
-
-void GridRenderer::SetShortcuts(std::vector<ShortcutInfo>* shortcutList) {
+void GridRenderer::SetShortcuts(const std::vector<ShortcutInfo>* shortcutList) {
     shortcuts = shortcutList;
 }
 
-void GridRenderer::Render(HDC hdc, const RECT& clientRect) {
+void GridRenderer::SetIconAtlasEnabled(bool enabled) {
+    iconAtlasEnabled = enabled;
+    if (!enabled) {
+        iconAtlases.clear();
+    }
+}
 
-    // Set up text rendering
-    SetBkMode(hdc, TRANSPARENT);
-    
-    // Create font dynamically based on iconLabelFontSize
-    HFONT hFont = CreateFont(iconLabelFontSize, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE,
-                            DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-                            ANTIALIASED_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Segoe UI");
-    HFONT hOldFont = (HFONT)SelectObject(hdc, hFont);
-    
+void GridRenderer::PrepareFrame() {
+    frameLabels.clear();
+    frameIcons.clear();
+    frameFirstVisible = 0;
     if (!shortcuts || shortcuts->empty()) {
-        // Draw "No shortcuts found" message
-        SetTextColor(hdc, RGB(128, 128, 128));
-        
-        std::wstring message = L"No shortcuts found in the configured folder";
-        RECT textRect = clientRect;
-        DrawText(hdc, message.c_str(), -1, &textRect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
-        
-        // Cleanup and return
-        SelectObject(hdc, hOldFont);
         return;
     }
     
-    // Set text color for icon labels
-    SetTextColor(hdc, RGB(255, 255, 255));
+    labelCache.SetLayout(iconLabelFontSize, static_cast<int>(dpiScaleFactor * 100 + 0.5f),
+                         layout.GetIconSize(), DesignConstants::LABEL_HEIGHT);
     
-    int cols, rows, startX, startY;
-    CalculateGridLayout(clientRect, cols, rows, startX, startY);
+    IconAtlas* atlas = iconAtlasEnabled ? GetIconAtlas() : nullptr;
     
-    // Render each shortcut (only render visible ones for performance)
-    for (size_t i = 0; i < shortcuts->size(); ++i) {
-        const auto& shortcut = (*shortcuts)[i];
-        
-        RECT iconRect = GetIconRect(static_cast<int>(i), cols, startX, startY);
+    int lastVisible;
+    layout.GetVisibleRange(scrollOffset, frameFirstVisible, lastVisible);
+    lastVisible = min(lastVisible, static_cast<int>(shortcuts->size()));
+    for (int i = frameFirstVisible; i < lastVisible; ++i) {
+        const ShortcutInfo& shortcut = (*shortcuts)[i];
+        frameLabels.push_back(labelCache.Get(shortcut.displayName));
         
-        // Skip rendering if icon is completely outside the visible grid area
-        if (iconRect.bottom < clientRect.top || iconRect.top > clientRect.bottom ||
-            iconRect.right < clientRect.left || iconRect.left > clientRect.right) {
-            continue;
-        }
-        
-        bool isSelected = (static_cast<int>(i) == selectedIconIndex);
-        
-        // Draw the icon with modern effects
-        if (shortcut.iconBitmap) {
-            DrawIconWithModernEffects(hdc, shortcut.iconBitmap, shortcut.iconBitmapWidth, shortcut.iconBitmapHeight, 
-                                     iconRect, false, isSelected);
-            
-            // Draw selection indicator
-            if (isSelected) {
-                RECT selectionRect = iconRect;
-                InflateRect(&selectionRect, DesignConstants::SELECTION_BORDER_INFLATE, DesignConstants::SELECTION_BORDER_INFLATE);
-                
-                // Draw interior shadow outline first
-                RECT shadowRect = selectionRect;
-                int shadowOffset = DesignConstants::SELECTION_BORDER_PEN_WIDTH;
-                shadowRect.left += shadowOffset;
-                shadowRect.top += shadowOffset;
-                shadowRect.right -= shadowOffset;
-                shadowRect.bottom -= shadowOffset;
-                HPEN oldPen = (HPEN)SelectObject(hdc, cachedShadowPen);
-                HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, GetStockObject(NULL_BRUSH));
-                int oldROP = SetROP2(hdc, R2_COPYPEN);
-                Rectangle(hdc, shadowRect.left, shadowRect.top, shadowRect.right, shadowRect.bottom);
-                
-                // Draw white selection outline on top
-                SelectObject(hdc, cachedSelectionPen);
-                Rectangle(hdc, selectionRect.left, selectionRect.top, selectionRect.right, selectionRect.bottom);
-                SetROP2(hdc, oldROP);
-                
-                SelectObject(hdc, oldPen);
-                SelectObject(hdc, oldBrush);
-            }
-        } else {
-            // Draw placeholder for missing icon
-            DrawRect(hdc, iconRect, RGB(64, 64, 64));
-        }
-        
-        // Draw label below icon
-        RECT labelRect = iconRect;
-        labelRect.top = iconRect.bottom + DesignConstants::SELECTION_BORDER_PADDING;
-        labelRect.bottom = labelRect.top + DesignConstants::LABEL_HEIGHT;
-        
-        // Only draw label if it's visible within the grid area
-        if (labelRect.top < clientRect.bottom && labelRect.bottom > clientRect.top &&
-            labelRect.right > clientRect.left && labelRect.left < clientRect.right) {
-            DrawIconLabel(hdc, shortcut.displayName, labelRect);
+        const uint32_t* iconPixels = IconPixelPool::Instance().GetPixels(shortcut.iconPixels);
+        RasterImage icon{iconPixels, shortcut.iconWidth, shortcut.iconHeight, shortcut.iconWidth};
+        if (iconPixels && atlas) {
+            icon = atlas->Get(i, shortcut.iconPixels, icon);
         }
+        frameIcons.push_back(icon);
     }
-    
-    // Cleanup
-    SelectObject(hdc, hOldFont);
-    DeleteObject(hFont);
 }
 
-int GridRenderer::GetClickedShortcut(POINT clickPoint, const RECT& clientRect) {
-    if (!shortcuts || shortcuts->empty()) {
-        return -1;
+IconAtlas* GridRenderer::GetIconAtlas() {
+    auto it = iconAtlases.begin();
+    while (it != iconAtlases.end() && it->shortcuts != shortcuts) {
+        ++it;
     }
-    
-    int cols, rows, startX, startY;
-    CalculateGridLayout(clientRect, cols, rows, startX, startY);
-    
-    for (size_t i = 0; i < shortcuts->size(); ++i) {
-        RECT iconRect = GetIconRect(static_cast<int>(i), cols, startX, startY);
-        
-        // Expand click area to include label
-        iconRect.bottom += DesignConstants::LABEL_HEIGHT + DesignConstants::SELECTION_BORDER_PADDING;
-        
-        if (PtInRect(&iconRect, clickPoint)) {
-            return static_cast<int>(i);
-        }
+    if (it != iconAtlases.end()) {
+        iconAtlases.splice(iconAtlases.begin(), iconAtlases, it);
+    } else {
+        iconAtlases.emplace_front();
+        iconAtlases.front().shortcuts = shortcuts;
     }
     
-    return -1;
-}
-
-RECT GridRenderer::GetIconBounds(int index, const RECT& clientRect) {
-    if (!shortcuts || shortcuts->empty() || index < 0 || index >= static_cast<int>(shortcuts->size())) {
-        return {0, 0, 0, 0}; // Empty rectangle
+    // A full atlas is mostly replaced icons or a scrolled-past tail; repack what is visible
+    IconAtlas& atlas = iconAtlases.front().atlas;
+    if (atlas.IsFull()) {
+        atlas.Clear();
     }
     
-    int cols, rows, startX, startY;
-    CalculateGridLayout(clientRect, cols, rows, startX, startY);
-    
-    RECT iconRect = GetIconRect(index, cols, startX, startY);
-    
-    // Expand to include label area and some padding for hover effects
-    iconRect.bottom += DesignConstants::LABEL_HEIGHT + iconVerticalPadding + DesignConstants::SELECTION_BORDER_PADDING;
-    iconRect.left -= DesignConstants::SELECTION_BORDER_PADDING;
-    iconRect.right += DesignConstants::SELECTION_BORDER_PADDING;
-    iconRect.top -= DesignConstants::SELECTION_BORDER_PADDING;
-    
-    return iconRect;
+    size_t totalBytes = 0;
+    for (const TabAtlas& tabAtlas : iconAtlases) {
+        totalBytes += tabAtlas.atlas.GetMemoryUsage();
+    }
+    while (iconAtlases.size() > 1 && totalBytes > MAX_ATLAS_BYTES) {
+        totalBytes -= iconAtlases.back().atlas.GetMemoryUsage();
+        iconAtlases.pop_back();
+    }
+    return &atlas;
 }
 
-void GridRenderer::CalculateGridLayout(const RECT& rect, int& cols, int& rows, int& startX, int& startY) {
-    if (!shortcuts || shortcuts->empty()) {
-        cols = rows = startX = startY = 0;
+void GridRenderer::Render(const RasterSurface& surface, const PixelRect& clip) {
+    if (!shortcuts || shortcuts->empty() || !surface.pixels) {
         return;
     }
     
-    // Use the full rect since WindowManager now handles margins
-    int availableWidth = rect.right - rect.left;
-    
-    // Calculate columns based on available width using DPI-aware icon size
-    int physicalIconSize = GetPhysicalIconSize();
-    int itemWidth = physicalIconSize + iconSpacingHorizontal;
-    cols = (availableWidth / itemWidth > 1) ? (availableWidth / itemWidth) : 1;
-    
-    // Calculate rows needed
-    int shortcutCount = static_cast<int>(shortcuts->size());
-    rows = (shortcutCount + cols - 1) / cols; // Ceiling division
-    
-    // Center the grid horizontally within the provided rect
-    int totalGridWidth = cols * itemWidth - iconSpacingHorizontal;
-    startX = rect.left + (availableWidth - totalGridWidth) / 2;
-    
-    // Start from top of the rect with small padding to prevent selection border clipping
-    startY = rect.top + DesignConstants::SELECTION_BORDER_PADDING;
-}
-
-RECT GridRenderer::GetIconRect(int index, int cols, int startX, int startY) {
-    int row = index / cols;
-    int col = index % cols;
-    
-    int physicalIconSize = GetPhysicalIconSize();
-    int itemWidth = physicalIconSize + iconSpacingHorizontal;
-    int itemHeight = GetTotalItemHeight() + iconSpacingVertical;
-    
-    RECT iconRect;
-    iconRect.left = startX + col * itemWidth;
-    iconRect.top = startY + row * itemHeight - scrollOffset; // Apply scroll offset
-    iconRect.right = iconRect.left + physicalIconSize;
-    iconRect.bottom = iconRect.top + physicalIconSize;
-    
-    return iconRect;
-}
-
-void GridRenderer::DrawIconWithModernEffects(HDC hdc, HBITMAP iconBitmap, int bitmapWidth, int bitmapHeight,
-                                             const RECT& iconRect, bool isHovered, bool isSelected) {
-    // Draw selection border if selected
-    if (isSelected) {
-        RECT selectionRect = iconRect;
-        InflateRect(&selectionRect, 2, 2);
-        HBRUSH selectionBrush = CreateSolidBrush(DesignConstants::ACCENT_COLOR);
-        FrameRect(hdc, &selectionRect, selectionBrush);
-        DeleteObject(selectionBrush);
+    // Icons and their selection border may reach into the margin above the grid;
+    // labels stay inside it
+    const PixelRect& gridArea = layout.GetArea();
+    PixelRect iconClip = PixelRect::Intersect(clip, PixelRect(gridArea.left, gridArea.top - DesignConstants::SELECTION_BORDER_EXTENSION,
+                                                              gridArea.right, gridArea.bottom));
+    PixelRect labelClip = PixelRect::Intersect(clip, gridArea);
+    if (iconClip.IsEmpty()) {
+        return;
     }
     
-    // Draw hover border if hovered
-    if (isHovered) {
-        RECT hoverRect = iconRect;
-        InflateRect(&hoverRect, 1, 1);
-        HBRUSH hoverBrush = CreateSolidBrush(DesignConstants::HOVER_COLOR);
-        FrameRect(hdc, &hoverRect, hoverBrush);
-        DeleteObject(hoverBrush);
+    // Render only the icons PrepareFrame found to intersect the grid area
+    int lastVisible = frameFirstVisible + static_cast<int>(frameIcons.size());
+    for (int i = frameFirstVisible; i < lastVisible; ++i) {
+        PixelRect iconRect = layout.IndexToRect(i, scrollOffset);
+        int labelTop = iconRect.bottom + DesignConstants::SELECTION_BORDER_PADDING;
+        
+        // Skip icons outside the area being repainted: selection border around the
+        // icon, label and its shadow below it
+        int extension = DesignConstants::SELECTION_BORDER_EXTENSION;
+        PixelRect selectionBounds(iconRect.left - extension, iconRect.top - extension,
+                                  iconRect.right + extension, iconRect.bottom + extension);
+        PixelRect labelBounds(iconRect.left, labelTop, iconRect.right + LabelCache::SHADOW_FAR,
+                              labelTop + DesignConstants::LABEL_HEIGHT + LabelCache::SHADOW_FAR);
+        if (!PixelRect::Union(selectionBounds, labelBounds).Intersects(iconClip)) {
+            continue;
+        }
+        
+        // Icons, like labels, come from PrepareFrame so tiles can be drawn in parallel
+        int frameIndex = i - frameFirstVisible;
+        RasterImage icon = frameIcons[frameIndex];
+        if (icon.pixels) {
+            // Icon is already scaled to physicalIconSize during load, so this is a 1:1 blend
+            Raster::BlendOver(surface, iconRect.left, iconRect.top, icon, PixelRect::Intersect(iconClip, iconRect));
+        } else {
+            // Placeholder for missing icon
+            Raster::FillRect(surface, PixelRect(iconRect.left + 1, iconRect.top + 1, iconRect.right - 1, iconRect.bottom - 1),
+                             PLACEHOLDER_COLOR, iconClip);
+        }
+        
+        // Pre-rasterized label, shadow included
+        const LabelBitmap* label = frameLabels[frameIndex];
+        if (label) {
+            RasterImage image{label->pixels.data(), label->width, label->height, label->width};
+            Raster::BlendOver(surface, iconRect.left + label->x, labelTop + label->y, image, labelClip);
+        }
     }
-    
-    // Draw the icon using pre-scaled bitmap with AlphaBlend for alpha compositing
-    // Note: Icon is already scaled to physicalIconSize during load, so no scaling needed
-    int physicalIconSize = GetPhysicalIconSize();
-    
-    HDC hdcMem = CreateCompatibleDC(hdc);
-    HBITMAP hbmOld = (HBITMAP)SelectObject(hdcMem, iconBitmap);
-    
-    // Use AlphaBlend for proper alpha compositing (no scaling - 1:1 copy)
-    BLENDFUNCTION blend = {AC_SRC_OVER, 0, 255, AC_SRC_ALPHA};
-    AlphaBlend(hdc, iconRect.left, iconRect.top, physicalIconSize, physicalIconSize,
-              hdcMem, 0, 0, bitmapWidth, bitmapHeight, blend);
-    
-    // Cleanup
-    SelectObject(hdcMem, hbmOld);
-    DeleteDC(hdcMem);
 }
 
-void GridRenderer::DrawIconLabel(HDC hdc, const std::wstring& text, const RECT& labelRect) {
-    if (text.empty()) {
+void GridRenderer::RenderSelection(const RasterSurface& surface, const PixelRect& clip) {
+    // Missing icons show the placeholder without a border
+    int frameIndex = selectedIconIndex - frameFirstVisible;
+    if (!shortcuts || !surface.pixels || selectedIconIndex < 0 || frameIndex < 0 ||
+        frameIndex >= static_cast<int>(frameIcons.size()) || !frameIcons[frameIndex].pixels) {
         return;
     }
     
-    // Draw thicker shadow by calling DrawShadowText twice with different offsets
-    RECT textRect = labelRect;
-    int textLength = static_cast<int>(text.length());
-    
-    // First shadow layer (larger offset)
-    DrawShadowText(hdc, text.c_str(), textLength, &textRect,
-                   DT_CENTER | DT_TOP | DT_WORDBREAK | DT_NOPREFIX,
-                   RGB(255, 255, 255),  // White text
-                   RGB(0, 0, 0),        // Black shadow
-                   3, 3);               // Larger offset
+    const PixelRect& gridArea = layout.GetArea();
+    PixelRect iconClip = PixelRect::Intersect(clip, PixelRect(gridArea.left, gridArea.top - DesignConstants::SELECTION_BORDER_EXTENSION,
+                                                              gridArea.right, gridArea.bottom));
+    if (iconClip.IsEmpty()) {
+        return;
+    }
     
-    // Second shadow layer (smaller offset for thickness)
-    DrawShadowText(hdc, text.c_str(), textLength, &textRect,
-                   DT_CENTER | DT_TOP | DT_WORDBREAK | DT_NOPREFIX,
-                   RGB(255, 255, 255),  // White text
-                   RGB(0, 0, 0),        // Black shadow
-                   1, 1);               // Smaller offset
+    DrawSelection(surface, layout.IndexToRect(selectedIconIndex, scrollOffset), iconClip);
 }
 
-void GridRenderer::DrawRect(HDC hdc, const RECT& rect, COLORREF color) {
-    
-    HBRUSH brush = CreateSolidBrush(color);
-    HBRUSH oldBrush = (HBRUSH)SelectObject(hdc, brush);
-    
-    // Simple rectangle for now - can be enhanced with rounded corners later
-    Rectangle(hdc, rect.left, rect.top, rect.right, rect.bottom);
-    
-    SelectObject(hdc, oldBrush);
-    DeleteObject(brush);
-}
\ No newline at end of file
+void GridRenderer::DrawSelection(const RasterSurface& surface, const PixelRect& iconRect, const PixelRect& clip) {
+    // White border SELECTION_BORDER_EXTENSION past the icon, with a dark ring of the
+    // same width just inside it that overlaps the icon edge
+    int outer = DesignConstants::SELECTION_BORDER_EXTENSION;
+    int width = DesignConstants::SELECTION_BORDER_PEN_WIDTH;
+    
+    PixelRect selectionRect(iconRect.left - outer, iconRect.top - outer, iconRect.right + outer, iconRect.bottom + outer);
+    PixelRect shadowRect(selectionRect.left + width, selectionRect.top + width,
+                         selectionRect.right - width, selectionRect.bottom - width);
+    
+    Raster::OutlineRect(surface, shadowRect, width, SELECTION_SHADOW_COLOR, clip);
+    Raster::OutlineRect(surface, selectionRect, width, SELECTION_COLOR, clip);
+}
+
+bool GridRenderer::RasterizeLabel(const std::wstring& text, int width, int height, std::vector<uint8_t>& coverage) {
+    labelText.SetFont(iconLabelFontSize, false);
+    return labelText.Rasterize(text, width, height, TextLayout::WrappedTop, coverage);
+}
@@ -1,60 +1,75 @@
 // GridRenderer.h - Grid rendering with modern aesthetics
 #pragma once
 
-#include <windows.h>
+#include <list>
 #include <vector>
 #include "DataModels.h"
+#include "GridLayout.h"
+#include "IconAtlas.h"
+#include "LabelCache.h"
+#include "Raster.h"
+#include "TextRasterizer.h"
 
 class GridRenderer {
 public:
     GridRenderer();
-    ~GridRenderer();
 
-    void SetShortcuts(std::vector<ShortcutInfo>* shortcuts);
+    void SetShortcuts(const std::vector<ShortcutInfo>* shortcuts);
+    void SetLayout(const GridLayout& gridLayout) { layout = gridLayout; }
+    const GridLayout& GetLayout() const { return layout; }
     void SetScrollOffset(int offset) { scrollOffset = offset; }
     void SetSelectedIcon(int index) { selectedIconIndex = index; }
     void SetDpiScaleFactor(float scaleFactor) { dpiScaleFactor = scaleFactor; }
-    void SetIconScale(float scale) { iconScale = scale; }
     void SetIconLabelFontSize(int fontSize) { iconLabelFontSize = fontSize; }
-    void SetIconSpacingHorizontal(int spacing) { iconSpacingHorizontal = spacing; }
-    void SetIconSpacingVertical(int spacing) { iconSpacingVertical = spacing; }
-    void SetIconVerticalPadding(int padding) { iconVerticalPadding = padding; }
-    void Render(HDC hdc, const RECT& clientRect);
-    int GetClickedShortcut(POINT clickPoint, const RECT& clientRect);
-    
-    // Get the rectangle for a specific icon (including label area)
-    RECT GetIconBounds(int index, const RECT& clientRect);
+    void SetIconAtlasEnabled(bool enabled);
+    
+    // Resolve the icons and labels of the visible shortcuts, packing new icons into the
+    // tab's atlas and rasterizing new labels with labelText. Call on the UI thread after
+    // changing any setting and before Render.
+    void PrepareFrame();
+    
+    // Draw the visible icons and labels straight into a premultiplied surface, touching
+    // only pixels inside clip. Icons whose cell misses clip are skipped. Calls with
+    // non-overlapping clips may run on several threads at once.
+    void Render(const RasterSurface& surface, const PixelRect& clip);
+    
+    // Draw the selection border over what Render drew, inside clip. It is opaque, so
+    // it can go over a cached copy of the grid without redrawing the icons under it.
+    void RenderSelection(const RasterSurface& surface, const PixelRect& clip);
 
 private:
-    std::vector<ShortcutInfo>* shortcuts; // Non-owning pointer
+    const std::vector<ShortcutInfo>* shortcuts; // Non-owning pointer
     int selectedIconIndex;
+    GridLayout layout; // Where each icon goes
     int scrollOffset; // Vertical scroll offset in pixels
     float dpiScaleFactor; // DPI scaling factor for this window
-    float iconScale; // Icon scale factor (0.25 to 2.0)
     int iconLabelFontSize; // Icon label font size (configurable)
-    int iconSpacingHorizontal; // Horizontal spacing between icons
-    int iconSpacingVertical; // Vertical spacing between icons
-    int iconVerticalPadding; // Vertical padding for icon labels
     
-    // Cached GDI objects for performance
-    HFONT cachedFont;
-    HPEN cachedSelectionPen;
-    HPEN cachedShadowPen;
+    TextRasterizer labelText;       // Draws labels before they are cached
+    
+    // Labels rasterized once per display name and font, with their shadow baked in
+    LabelCache labelCache;
+    std::vector<const LabelBitmap*> frameLabels;    // Labels of the visible icons, from PrepareFrame
+    std::vector<RasterImage> frameIcons;            // Icons of the visible shortcuts, from PrepareFrame
+    int frameFirstVisible;                          // Icon index of frameLabels[0] and frameIcons[0]
     
-    // Layout calculation
-    void CalculateGridLayout(const RECT& rect, int& cols, int& rows, int& startX, int& startY);
-    RECT GetIconRect(int index, int cols, int startX, int startY);
+    // Icons of recently drawn tabs, most recent first
+    struct TabAtlas {
+        const std::vector<ShortcutInfo>* shortcuts = nullptr;
+        IconAtlas atlas;
+    };
+    std::list<TabAtlas> iconAtlases;
+    bool iconAtlasEnabled;
     
-    // Modern rendering effects
-    void DrawIconWithModernEffects(HDC hdc, HBITMAP iconBitmap, int bitmapWidth, int bitmapHeight, 
-                                   const RECT& iconRect, bool isHovered, bool isSelected);
-    void DrawIconLabel(HDC hdc, const std::wstring& text, const RECT& iconRect);
+    // Rendering helpers
+    void DrawSelection(const RasterSurface& surface, const PixelRect& iconRect, const PixelRect& clip);
+    bool RasterizeLabel(const std::wstring& text, int width, int height, std::vector<uint8_t>& coverage);
     
     // Helper functions
-    void DrawRect(HDC hdc, const RECT& rect, COLORREF color);
+    IconAtlas* GetIconAtlas();      // Atlas of the current shortcuts; drops old ones past MAX_ATLAS_BYTES
     
-    // Constants from design - now DPI-aware and scale-aware
-    int GetPhysicalIconSize() const { return static_cast<int>(DesignConstants::TARGET_ICON_SIZE_PIXELS * iconScale); }
-    static const int GRID_MARGIN = DesignConstants::GRID_MARGIN;
-    int GetTotalItemHeight() const { return GetPhysicalIconSize() + DesignConstants::LABEL_HEIGHT + iconVerticalPadding; }
+    static const uint32_t SELECTION_COLOR = 0xFFFFFFFF;
+    static const uint32_t SELECTION_SHADOW_COLOR = 0xFF202020;
+    static const uint32_t PLACEHOLDER_COLOR = 0xFF404040;
+    static const size_t MAX_ATLAS_BYTES = 96 * 1024 * 1024;
 };
\ No newline at end of file
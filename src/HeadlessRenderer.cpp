@@ -0,0 +1,111 @@
+// HeadlessRenderer.cpp - Windowless frame rendering implementation
+#include "HeadlessRenderer.h"
+#include "BinaryFile.h"
+#include "PngWriter.h"
+#include "ScrollBlit.h"
+#include <string>
+
+HeadlessRenderer::HeadlessRenderer()
+    : width(0)
+    , height(0)
+    , composer(&gridRenderer)
+    , renderedSelectedIndex(-1)
+{
+}
+
+void HeadlessRenderer::SetSize(int newWidth, int newHeight) {
+    width = max(0, newWidth);
+    height = max(0, newHeight);
+    pixels.assign(static_cast<size_t>(width) * height, 0);
+    composer.InvalidateTabs();
+    damage.Clear();
+    InvalidateAll();
+}
+
+void HeadlessRenderer::Invalidate(const PixelRect& rect) {
+    damage.Add(rect);
+}
+
+void HeadlessRenderer::InvalidateAll() {
+    composer.InvalidateContent();
+    damage.Add(PixelRect(0, 0, width, height));
+}
+
+void HeadlessRenderer::InvalidateTabs() {
+    composer.InvalidateTabs();
+    damage.Add(PixelRect(0, 0, width, height));
+}
+
+void HeadlessRenderer::InvalidateIcon(const FrameState& state, int index) {
+    damage.Add(GetIconBounds(state, index));
+}
+
+void HeadlessRenderer::Scroll(const FrameState& state, int scrollDelta) {
+    if (scrollDelta == 0) {
+        return;
+    }
+    
+    // Same steps as WindowManager::ScrollBuffer, minus the window invalidation
+    RECT gridRect = FrameComposer::GetGridRect(state.clientRect);
+    PixelRect scrollArea = PixelRect::Intersect(PixelRect(gridRect.left, gridRect.top, gridRect.right, gridRect.bottom),
+                                                PixelRect(0, 0, width, height));
+    if (damage.Contains(scrollArea) || scrollArea.IsEmpty()) {
+        damage.Add(scrollArea);
+        return;
+    }
+    
+    damage.Scroll(scrollArea, scrollDelta);
+    damage.Add(ScrollBlit::ScrollRows(pixels.data(), width, scrollArea, scrollDelta));
+    composer.ScrollLayer(scrollArea, scrollDelta);
+    damage.Add(PixelRect(scrollArea.left, gridRect.top - DesignConstants::SELECTION_BORDER_EXTENSION,
+                         scrollArea.right, gridRect.top));
+    damage.Add(GetIconBounds(state, renderedSelectedIndex));
+    damage.Add(GetIconBounds(state, state.selectedIconIndex));
+}
+
+int64_t HeadlessRenderer::Render(const FrameState& state) {
+    damage.ClipTo(PixelRect(0, 0, width, height));
+    int64_t area = damage.GetArea();
+    
+    RasterSurface frame;
+    frame.pixels = pixels.data();
+    frame.width = width;
+    frame.height = height;
+    frame.stride = width;
+    composer.Compose(frame, damage, state);
+    
+    damage.Clear();
+    renderedSelectedIndex = state.selectedIconIndex;
+    return area;
+}
+
+RasterImage HeadlessRenderer::GetFrame() const {
+    return RasterImage{pixels.data(), width, height, width};
+}
+
+FrameState HeadlessRenderer::MakeState(const std::vector<TabInfo>& tabs, int activeTabIndex, int scrollOffset,
+                                       int selectedIconIndex, float dpiScaleFactor) const {
+    FrameState state;
+    state.tabs = &tabs;
+    state.activeTabIndex = activeTabIndex;
+    state.scrollOffset = scrollOffset;
+    state.selectedIconIndex = selectedIconIndex;
+    state.dpiScaleFactor = dpiScaleFactor;
+    state.clientRect = {0, 0, width, height};
+    return state;
+}
+
+bool HeadlessRenderer::SavePng(const std::wstring& path) const {
+    std::vector<uint8_t> png = PngWriter::Encode(GetFrame());
+    BinaryFile file;
+    return file.Open(path, true) && file.WriteAt(0, png.data(), png.size());
+}
+
+PixelRect HeadlessRenderer::GetIconBounds(const FrameState& state, int index) const {
+    if (!state.tabs || state.activeTabIndex < 0 || state.activeTabIndex >= static_cast<int>(state.tabs->size())) {
+        return PixelRect();
+    }
+    
+    int itemCount = static_cast<int>((*state.tabs)[state.activeTabIndex].shortcuts.size());
+    return FrameComposer::GetGridLayout(state.clientRect, itemCount).GetItemBounds(index, state.scrollOffset);
+}
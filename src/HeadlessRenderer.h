@@ -0,0 +1,65 @@
+// HeadlessRenderer.h - Launcher frames rendered into memory without a window
+#pragma once
+
+#include <string>
+#include <vector>
+#include "DamageRegion.h"
+#include "FrameComposer.h"
+#include "GridRenderer.h"
+#include "Raster.h"
+
+// Keeps a frame buffer the way WindowManager keeps its offscreen DIB and repaints
+// it through the same FrameComposer. On Win32 each frame is bit-identical to what
+// WM_PAINT would hand to UpdateLayeredWindow. Elsewhere TextRasterizer draws block
+// glyphs instead of Segoe UI, so labels and tab names differ from the real window
+// while the icons, layout and damage handling are the same. Used by the frame
+// benchmark and for golden images.
+class HeadlessRenderer {
+public:
+    HeadlessRenderer();
+    
+    // Delete copy/move
+    HeadlessRenderer(const HeadlessRenderer&) = delete;
+    HeadlessRenderer& operator=(const HeadlessRenderer&) = delete;
+    
+    // Resize the frame; everything is redrawn on the next Render
+    void SetSize(int width, int height);
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    
+    // Queue an area for the next Render, like InvalidateRect. InvalidateAll also makes
+    // the next Render draw everything from scratch.
+    void Invalidate(const PixelRect& rect);
+    void InvalidateAll();
+    void InvalidateTabs();
+    
+    // Queue the outline of an icon, as a selection change does
+    void InvalidateIcon(const FrameState& state, int index);
+    
+    // Move the rendered grid after state.scrollOffset changed by scrollDelta and queue
+    // what that exposes, like WindowManager::ScrollBuffer
+    void Scroll(const FrameState& state, int scrollDelta);
+    
+    // Redraw the queued areas for state, like WM_PAINT. Returns the number of pixels redrawn.
+    int64_t Render(const FrameState& state);
+    
+    RasterImage GetFrame() const;
+    GridRenderer& GetGridRenderer() { return gridRenderer; }
+    FrameComposer& GetComposer() { return composer; }
+    FrameState MakeState(const std::vector<TabInfo>& tabs, int activeTabIndex, int scrollOffset,
+                         int selectedIconIndex, float dpiScaleFactor) const;
+    
+    // PNG of the frame as it looks over black; false if the file can't be written
+    bool SavePng(const std::wstring& path) const;
+
+private:
+    std::vector<uint32_t> pixels;
+    int width;
+    int height;
+    GridRenderer gridRenderer;
+    FrameComposer composer;
+    DamageRegion damage;
+    int renderedSelectedIndex;      // selectedIconIndex of the last Render
+    
+    PixelRect GetIconBounds(const FrameState& state, int index) const;
+};
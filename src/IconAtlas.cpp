@@ -0,0 +1,68 @@
+// IconAtlas.cpp - Per-tab icon atlas implementation
+#include "IconAtlas.h"
+#include <new>
+
+IconAtlas::IconAtlas()
+    : full(false)
+{
+}
+
+RasterImage IconAtlas::Get(int index, IconHandle handle, const RasterImage& source) {
+    if (index < 0 || !handle || !source.pixels) {
+        return source;
+    }
+    if (index >= static_cast<int>(entries.size())) {
+        entries.resize(index + 1);
+    }
+    
+    // The old copy of a replaced icon stays behind as a hole until Clear
+    Entry& entry = entries[index];
+    if (entry.handle != handle || entry.rect.Width() != source.width || entry.rect.Height() != source.height) {
+        entry.handle = 0;
+        if (!Place(source.width, source.height, entry.page, entry.rect)) {
+            full = true;
+            return source;
+        }
+        
+        RasterSurface page;
+        page.pixels = pages[entry.page]->pixels.get();
+        page.width = PAGE_WIDTH;
+        page.height = PAGE_HEIGHT;
+        page.stride = PAGE_WIDTH;
+        Raster::Copy(page, entry.rect.left, entry.rect.top, source, entry.rect);
+        entry.handle = handle;
+    }
+    
+    const uint32_t* pixels = pages[entry.page]->pixels.get() +
+                             static_cast<size_t>(entry.rect.top) * PAGE_WIDTH + entry.rect.left;
+    return RasterImage{pixels, entry.rect.Width(), entry.rect.Height(), PAGE_WIDTH};
+}
+
+void IconAtlas::Clear() {
+    pages.clear();
+    entries.clear();
+    full = false;
+}
+
+bool IconAtlas::Place(int width, int height, uint32_t& page, PixelRect& rect) {
+    // Only the newest page has room worth looking for; earlier ones filled up in order
+    if (!pages.empty() && pages.back()->packer.Insert(width, height, rect)) {
+        page = static_cast<uint32_t>(pages.size() - 1);
+        return true;
+    }
+    if (pages.size() >= MAX_PAGES || width > PAGE_WIDTH || height > PAGE_HEIGHT) {
+        return false;
+    }
+    
+    std::unique_ptr<Page> newPage(new (std::nothrow) Page());
+    if (!newPage) {
+        return false;
+    }
+    newPage->pixels.reset(new (std::nothrow) uint32_t[static_cast<size_t>(PAGE_WIDTH) * PAGE_HEIGHT]);
+    if (!newPage->pixels || !newPage->packer.Insert(width, height, rect)) {
+        return false;
+    }
+    pages.push_back(std::move(newPage));
+    page = static_cast<uint32_t>(pages.size() - 1);
+    return true;
+}
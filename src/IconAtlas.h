@@ -0,0 +1,60 @@
+// IconAtlas.h - Icons of one tab packed into a few large pages (portable, no Win32)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "AtlasPacker.h"
+#include "IconPixelPool.h"
+#include "Raster.h"
+
+// Copies a tab's icons into large premultiplied pages the first time each is drawn.
+// Icons are drawn row by row, so the icons of a visible row sit next to each other in
+// one allocation instead of in pool slots scattered by earlier scans and reloads.
+// Entries are keyed by shortcut index and checked against the pool handle, so an icon
+// that was replaced is copied again.
+class IconAtlas {
+public:
+    IconAtlas();
+    
+    // Delete copy/move
+    IconAtlas(const IconAtlas&) = delete;
+    IconAtlas& operator=(const IconAtlas&) = delete;
+    
+    // Atlas copy of the icon at index, whose pool buffer handle holds source. Returns
+    // source itself when the atlas is full. Images stay valid until Clear.
+    RasterImage Get(int index, IconHandle handle, const RasterImage& source);
+    
+    // True once an icon did not fit; Clear between frames to start over
+    bool IsFull() const { return full; }
+    void Clear();
+    
+    size_t GetPageCount() const { return pages.size(); }
+    size_t GetMemoryUsage() const { return pages.size() * PAGE_BYTES; }
+    
+    static const int PAGE_WIDTH = 2048;
+    static const int PAGE_HEIGHT = 1024;
+    static const size_t PAGE_BYTES = static_cast<size_t>(PAGE_WIDTH) * PAGE_HEIGHT * sizeof(uint32_t);
+    static const size_t MAX_PAGES = 8;
+
+private:
+    struct Page {
+        std::unique_ptr<uint32_t[]> pixels;
+        AtlasPacker packer;
+        
+        Page() : packer(PAGE_WIDTH, PAGE_HEIGHT) {}
+    };
+    
+    struct Entry {
+        IconHandle handle = 0;      // 0 = not in the atlas
+        uint32_t page = 0;
+        PixelRect rect;
+    };
+    
+    std::vector<std::unique_ptr<Page>> pages;
+    std::vector<Entry> entries;     // By shortcut index
+    bool full;
+    
+    bool Place(int width, int height, uint32_t& page, PixelRect& rect);
+};
@@ -0,0 +1,355 @@
+// IconCache.cpp - Persistent icon thumbnail cache implementation
+#include "IconCache.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+    const uint32_t ICON_CACHE_MAGIC = 0x43494C47; // "GLIC"
+    const uint32_t ICON_CACHE_VERSION = 1;
+    
+    // Stored at offset 0; the first page is reserved for it
+    struct CacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t alignment;
+        uint32_t reserved;
+        uint64_t generation;
+        uint64_t indexOffset;
+        uint64_t indexBytes;
+        uint64_t indexChecksum;
+        uint64_t entryCount;
+    };
+    
+    // One per thumbnail in the index, followed by keyLength UTF-16 units padded to 8 bytes
+    struct IndexRecord {
+        uint64_t sourceSize;
+        uint64_t sourceWriteTime;
+        uint64_t offset;
+        uint64_t checksum;
+        uint64_t lastUsed;
+        uint32_t size;
+        uint32_t keyLength;
+    };
+    
+    uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+IconCache::IconCache()
+    : maxSize(0)
+    , dataEnd(RECORD_ALIGNMENT)
+    , generation(1)
+    , dirty(false)
+{
+}
+
+IconCache::~IconCache() {
+    Close();
+}
+
+bool IconCache::Open(const std::wstring& path, uint64_t maxSizeBytes) {
+    Close();
+    
+    if (!file.Open(path, false)) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    filePath = path;
+    maxSize = maxSizeBytes;
+    
+    // A new, truncated or corrupt file simply starts out empty
+    if (!LoadIndex()) {
+        Reset();
+    }
+    return true;
+}
+
+void IconCache::Close() {
+    if (!file.IsOpen()) {
+        return;
+    }
+    
+    Flush();
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    file.Close();
+    entries.clear();
+}
+
+bool IconCache::Read(const IconCacheKey& key, void* pixels) {
+    std::wstring cacheKey = MakeKey(key);
+    Entry entry;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(cacheKey);
+        if (!file.IsOpen() || it == entries.end()) {
+            return false;
+        }
+        
+        // A changed source is a miss; Store replaces the stale record
+        if (it->second.sourceSize != key.sourceSize || it->second.sourceWriteTime != key.sourceWriteTime ||
+            it->second.size != static_cast<uint32_t>(key.targetSize)) {
+            return false;
+        }
+        
+        if (it->second.lastUsed != generation) {
+            it->second.lastUsed = generation;
+            dirty = true;
+        }
+        entry = it->second;
+    }
+    
+    // Read straight into the destination and verify it
+    uint64_t bytes = RecordBytes(entry.size);
+    if (file.ReadAt(entry.offset, pixels, static_cast<size_t>(bytes)) &&
+        Checksum(pixels, static_cast<size_t>(bytes)) == entry.checksum) {
+        return true;
+    }
+    
+    // Corrupt record - drop it so the icon is extracted and stored again
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(cacheKey);
+    if (it != entries.end() && it->second.offset == entry.offset) {
+        entries.erase(it);
+        dirty = true;
+    }
+    return false;
+}
+
+void IconCache::Store(const IconCacheKey& key, const void* pixels) {
+    if (key.targetSize <= 0) {
+        return;
+    }
+    
+    uint32_t size = static_cast<uint32_t>(key.targetSize);
+    uint64_t bytes = RecordBytes(size);
+    uint64_t checksum = Checksum(pixels, static_cast<size_t>(bytes));
+    
+    // Reserve space at the end of the record area, then write outside the lock
+    uint64_t offset = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.IsOpen()) {
+            return;
+        }
+        offset = dataEnd;
+        dataEnd += AlignUp(bytes, RECORD_ALIGNMENT);
+    }
+    
+    if (!file.WriteAt(offset, pixels, static_cast<size_t>(bytes))) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry entry = {key.sourceSize, key.sourceWriteTime, offset, checksum, generation, size};
+    entries[MakeKey(key)] = entry;
+    dirty = true;
+}
+
+void IconCache::Flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.IsOpen() || !dirty) {
+        return;
+    }
+    
+    // Over the size limit: keep the most recently used thumbnails
+    if (dataEnd - RECORD_ALIGNMENT > maxSize && !Compact()) {
+        Reset();
+    }
+    
+    // Serialize the index
+    std::vector<uint8_t> index;
+    for (const auto& pair : entries) {
+        IndexRecord record = {pair.second.sourceSize, pair.second.sourceWriteTime, pair.second.offset,
+                              pair.second.checksum, pair.second.lastUsed, pair.second.size,
+                              static_cast<uint32_t>(pair.first.length())};
+        size_t keyBytes = pair.first.length() * sizeof(wchar_t);
+        size_t position = index.size();
+        index.resize(position + static_cast<size_t>(AlignUp(sizeof(IndexRecord) + keyBytes, 8)), 0);
+        memcpy(&index[position], &record, sizeof(record));
+        memcpy(&index[position + sizeof(record)], pair.first.data(), keyBytes);
+    }
+    
+    // Index goes after the records. New records are appended over it, which invalidates
+    // its checksum until the next Flush, so a crash in between only loses the cache.
+    CacheHeader header = {};
+    header.magic = ICON_CACHE_MAGIC;
+    header.version = ICON_CACHE_VERSION;
+    header.alignment = RECORD_ALIGNMENT;
+    header.generation = generation;
+    header.indexOffset = dataEnd;
+    header.indexBytes = index.size();
+    header.indexChecksum = Checksum(index.data(), index.size());
+    header.entryCount = entries.size();
+    
+    if (!file.WriteAt(dataEnd, index.data(), index.size()) || !file.WriteAt(0, &header, sizeof(header))) {
+        return;
+    }
+    
+    file.Truncate(dataEnd + index.size());
+    
+    dirty = false;
+}
+
+size_t IconCache::GetEntryCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+bool IconCache::LoadIndex() {
+    CacheHeader header = {};
+    uint64_t size = 0;
+    if (!file.GetSize(size) || !file.ReadAt(0, &header, sizeof(header))) {
+        return false;
+    }
+    
+    if (header.magic != ICON_CACHE_MAGIC || header.version != ICON_CACHE_VERSION ||
+        header.alignment != RECORD_ALIGNMENT || header.indexOffset < RECORD_ALIGNMENT ||
+        header.indexOffset % RECORD_ALIGNMENT != 0 || header.indexOffset + header.indexBytes > size ||
+        header.indexBytes > 64 * 1024 * 1024) {
+        return false;
+    }
+    
+    std::vector<uint8_t> index(static_cast<size_t>(header.indexBytes));
+    if (!index.empty() && !file.ReadAt(header.indexOffset, index.data(), index.size())) {
+        return false;
+    }
+    if (Checksum(index.data(), index.size()) != header.indexChecksum) {
+        return false;
+    }
+    
+    // Every record must lie in the record area, page-aligned
+    std::unordered_map<std::wstring, Entry> loaded;
+    size_t position = 0;
+    while (position < index.size()) {
+        IndexRecord record;
+        if (position + sizeof(record) > index.size()) {
+            return false;
+        }
+        memcpy(&record, &index[position], sizeof(record));
+        
+        size_t keyBytes = static_cast<size_t>(record.keyLength) * sizeof(wchar_t);
+        size_t recordBytes = static_cast<size_t>(AlignUp(sizeof(record) + keyBytes, 8));
+        if (position + sizeof(record) + keyBytes > index.size() ||
+            record.offset < RECORD_ALIGNMENT || record.offset % RECORD_ALIGNMENT != 0 ||
+            record.offset + RecordBytes(record.size) > header.indexOffset) {
+            return false;
+        }
+        
+        std::wstring key(reinterpret_cast<const wchar_t*>(&index[position + sizeof(record)]), record.keyLength);
+        Entry entry = {record.sourceSize, record.sourceWriteTime, record.offset, record.checksum, record.lastUsed, record.size};
+        loaded[key] = entry;
+        position += recordBytes;
+    }
+    
+    if (loaded.size() != header.entryCount) {
+        return false;
+    }
+    
+    entries = std::move(loaded);
+    dataEnd = header.indexOffset;
+    generation = header.generation + 1;
+    dirty = false;
+    return true;
+}
+
+void IconCache::Reset() {
+    entries.clear();
+    dataEnd = RECORD_ALIGNMENT;
+    generation = 1;
+    dirty = true;
+}
+
+bool IconCache::Compact() {
+    // Most recently used first; fill up to three quarters of the limit so the next
+    // few sessions don't compact again straight away
+    std::vector<std::unordered_map<std::wstring, Entry>::iterator> order;
+    order.reserve(entries.size());
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        order.push_back(it);
+    }
+    std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+        return a->second.lastUsed > b->second.lastUsed;
+    });
+    
+    std::wstring tempPath = filePath + L".tmp";
+    BinaryFile compacted;
+    if (!compacted.Open(tempPath, true)) {
+        return false;
+    }
+    
+    uint64_t budget = maxSize / 4 * 3;
+    uint64_t newEnd = RECORD_ALIGNMENT;
+    std::unordered_map<std::wstring, Entry> kept;
+    std::vector<uint8_t> buffer;
+    bool success = true;
+    
+    for (const auto& it : order) {
+        uint64_t bytes = RecordBytes(it->second.size);
+        uint64_t alignedBytes = AlignUp(bytes, RECORD_ALIGNMENT);
+        if (newEnd - RECORD_ALIGNMENT + alignedBytes > budget) {
+            continue;
+        }
+        
+        buffer.resize(static_cast<size_t>(bytes));
+        if (!file.ReadAt(it->second.offset, buffer.data(), buffer.size()) ||
+            !compacted.WriteAt(newEnd, buffer.data(), buffer.size())) {
+            success = false;
+            break;
+        }
+        
+        Entry entry = it->second;
+        entry.offset = newEnd;
+        kept[it->first] = entry;
+        newEnd += alignedBytes;
+    }
+    
+    compacted.Close();
+    file.Close();
+    
+    if (success) {
+        success = BinaryFile::Replace(tempPath, filePath);
+    }
+    if (!success) {
+        BinaryFile::Delete(tempPath);
+    }
+    
+    if (!file.Open(filePath, false) || !success) {
+        return false;
+    }
+    
+    entries = std::move(kept);
+    dataEnd = newEnd;
+    return true;
+}
+
+std::wstring IconCache::MakeKey(const IconCacheKey& key) {
+    return key.sourcePath + L"|" + std::to_wstring(key.iconIndex) + L"|" + std::to_wstring(key.targetSize);
+}
+
+uint64_t IconCache::RecordBytes(uint32_t size) {
+    return static_cast<uint64_t>(size) * size * 4;
+}
+
+uint64_t IconCache::Checksum(const void* data, size_t size) {
+    // FNV-1a style mix over 64-bit words - fast enough to verify every hit
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = 14695981039346656037ULL;
+    size_t words = size / 8;
+    
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word;
+        memcpy(&word, bytes + i * 8, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ULL;
+        hash ^= hash >> 29;
+    }
+    for (size_t i = words * 8; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    
+    return hash;
+}
@@ -0,0 +1,75 @@
+// IconCache.h - Persistent cache of pre-scaled, premultiplied icon thumbnails
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "BinaryFile.h"
+
+// Identity of a thumbnail: the file the icon came from and the size it was scaled to.
+// A source that changes size or write time no longer matches its old thumbnail.
+struct IconCacheKey {
+    std::wstring sourcePath;
+    int iconIndex = 0;
+    uint64_t sourceSize = 0;
+    uint64_t sourceWriteTime = 0;
+    int targetSize = 0;            // Width and height in pixels (256 * IconScale)
+};
+
+// Thumbnails are stored as page-aligned BGRA records in a single file, followed by an
+// index that is rewritten by Flush. A hit is one positional read straight into the
+// destination bitmap. Read and Store may be called from any thread; Open, Flush and
+// Close must not run concurrently with them.
+class IconCache {
+public:
+    IconCache();
+    ~IconCache();
+    
+    // Delete copy/move
+    IconCache(const IconCache&) = delete;
+    IconCache& operator=(const IconCache&) = delete;
+    
+    // Open or create the cache file. A missing or corrupt index starts an empty cache.
+    bool Open(const std::wstring& path, uint64_t maxSizeBytes);
+    void Close();
+    
+    // Copy a thumbnail (targetSize * targetSize premultiplied BGRA) into pixels.
+    // Returns false on a miss or if the record fails its checksum.
+    bool Read(const IconCacheKey& key, void* pixels);
+    void Store(const IconCacheKey& key, const void* pixels);
+    
+    // Write the index, evicting least recently used thumbnails when over the size limit
+    void Flush();
+    
+    size_t GetEntryCount();
+
+private:
+    struct Entry {
+        uint64_t sourceSize;
+        uint64_t sourceWriteTime;
+        uint64_t offset;           // Page-aligned record offset in the file
+        uint64_t checksum;         // Checksum of the record's pixels
+        uint64_t lastUsed;         // Session generation of the last hit or store
+        uint32_t size;             // Thumbnail width and height
+    };
+    
+    BinaryFile file;
+    std::wstring filePath;
+    uint64_t maxSize;
+    uint64_t dataEnd;              // End of the record area, where the index is written
+    uint64_t generation;           // Incremented every time the cache is opened
+    bool dirty;
+    std::unordered_map<std::wstring, Entry> entries;
+    std::mutex mutex;
+    
+    bool LoadIndex();
+    void Reset();
+    bool Compact();
+    
+    static std::wstring MakeKey(const IconCacheKey& key);
+    static uint64_t RecordBytes(uint32_t size);
+    static uint64_t Checksum(const void* data, size_t size);
+    
+    static const uint32_t RECORD_ALIGNMENT = 4096; // Records start on page boundaries
+};
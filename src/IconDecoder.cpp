@@ -0,0 +1,783 @@
+// IconDecoder.cpp - ICO/PNG/DIB icon image decoder implementation
+#include "IconDecoder.h"
+#include "PixelOps.h"
+#include <cstring>
+
+namespace {
+    const uint8_t PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    
+    uint16_t ReadU16(const uint8_t* p) {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+    
+    uint32_t ReadU32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+    
+    // PNG stores integers big-endian
+    uint32_t ReadU32BE(const uint8_t* p) {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+               (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+    }
+    
+    uint32_t MakePixel(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+        return (a << 24) | (r << 16) | (g << 8) | b;
+    }
+    
+    // ---- Inflate (RFC 1950/1951) ----
+    
+    // LSB-first bit reader. Reading past the end yields zero bits and sets overrun.
+    class BitReader {
+    public:
+        BitReader(const uint8_t* data, size_t size)
+            : data(data), size(size), position(0), bitBuffer(0), bitCount(0), overrun(false) {}
+        
+        uint32_t Peek(int count) {
+            Refill();
+            return static_cast<uint32_t>(bitBuffer & ((1ULL << count) - 1));
+        }
+        
+        void Consume(int count) {
+            if (count > bitCount) {
+                overrun = true;
+                count = bitCount;
+            }
+            bitBuffer >>= count;
+            bitCount -= count;
+        }
+        
+        uint32_t Read(int count) {
+            uint32_t value = Peek(count);
+            Consume(count);
+            return value;
+        }
+        
+        void AlignToByte() {
+            Consume(bitCount % 8);
+        }
+        
+        bool Overrun() const { return overrun; }
+    
+    private:
+        const uint8_t* data;
+        size_t size;
+        size_t position;
+        uint64_t bitBuffer;
+        int bitCount;
+        bool overrun;
+        
+        void Refill() {
+            while (bitCount <= 56 && position < size) {
+                bitBuffer |= static_cast<uint64_t>(data[position++]) << bitCount;
+                bitCount += 8;
+            }
+        }
+    };
+    
+    // Canonical Huffman decoder with a direct lookup table for short codes
+    class Huffman {
+    public:
+        static const int FAST_BITS = 9;
+        static const int MAX_BITS = 15;
+        
+        bool Build(const uint8_t* lengths, int count) {
+            memset(counts, 0, sizeof(counts));
+            memset(fast, 0, sizeof(fast));
+            for (int i = 0; i < count; i++) {
+                counts[lengths[i]]++;
+            }
+            counts[0] = 0;
+            
+            // Reject over-subscribed codes (incomplete ones are legal, e.g. a single distance code)
+            int left = 1;
+            for (int len = 1; len <= MAX_BITS; len++) {
+                left = (left << 1) - counts[len];
+                if (left < 0) {
+                    return false;
+                }
+            }
+            
+            uint16_t offsets[MAX_BITS + 1];
+            uint32_t nextCode[MAX_BITS + 1];
+            offsets[1] = 0;
+            nextCode[1] = 0;
+            for (int len = 1; len < MAX_BITS; len++) {
+                offsets[len + 1] = static_cast<uint16_t>(offsets[len] + counts[len]);
+                nextCode[len + 1] = (nextCode[len] + counts[len]) << 1;
+            }
+            
+            for (int symbol = 0; symbol < count; symbol++) {
+                int len = lengths[symbol];
+                if (len == 0) {
+                    continue;
+                }
+                symbols[offsets[len]++] = static_cast<uint16_t>(symbol);
+                
+                uint32_t code = nextCode[len]++;
+                if (len <= FAST_BITS) {
+                    // Codes are stored MSB-first but read LSB-first, so index by the reversed code
+                    uint32_t reversed = 0;
+                    for (int bit = 0; bit < len; bit++) {
+                        reversed |= ((code >> bit) & 1) << (len - 1 - bit);
+                    }
+                    for (uint32_t i = reversed; i < (1u << FAST_BITS); i += (1u << len)) {
+                        fast[i] = static_cast<uint16_t>((len << 9) | symbol);
+                    }
+                }
+            }
+            return true;
+        }
+        
+        int Decode(BitReader& bits) const {
+            uint16_t entry = fast[bits.Peek(FAST_BITS)];
+            if (entry) {
+                bits.Consume(entry >> 9);
+                return entry & 0x1FF;
+            }
+            
+            // Long code - walk the canonical code one bit at a time
+            int code = 0;
+            int first = 0;
+            int index = 0;
+            for (int len = 1; len <= MAX_BITS; len++) {
+                code |= static_cast<int>(bits.Read(1));
+                int count = counts[len];
+                if (code - count < first) {
+                    return symbols[index + (code - first)];
+                }
+                index += count;
+                first = (first + count) << 1;
+                code <<= 1;
+            }
+            return -1;
+        }
+    
+    private:
+        uint16_t counts[MAX_BITS + 1];
+        uint16_t symbols[288];
+        uint16_t fast[1 << FAST_BITS];
+    };
+    
+    const uint16_t LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                      35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                      3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    const uint16_t DISTANCE_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    const uint8_t DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    const uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    
+    bool InflateBlock(BitReader& bits, const Huffman& literals, const Huffman& distances,
+                      std::vector<uint8_t>& out, size_t maxOutput) {
+        for (;;) {
+            int symbol = literals.Decode(bits);
+            if (symbol < 0 || bits.Overrun()) {
+                return false;
+            }
+            if (symbol < 256) {
+                if (out.size() >= maxOutput) {
+                    return false;
+                }
+                out.push_back(static_cast<uint8_t>(symbol));
+                continue;
+            }
+            if (symbol == 256) {
+                return true;
+            }
+            
+            symbol -= 257;
+            if (symbol >= 29) {
+                return false;
+            }
+            size_t length = LENGTH_BASE[symbol] + bits.Read(LENGTH_EXTRA[symbol]);
+            
+            int distanceSymbol = distances.Decode(bits);
+            if (distanceSymbol < 0 || distanceSymbol >= 30) {
+                return false;
+            }
+            size_t distance = DISTANCE_BASE[distanceSymbol] + bits.Read(DISTANCE_EXTRA[distanceSymbol]);
+            if (distance > out.size() || out.size() + length > maxOutput) {
+                return false;
+            }
+            
+            // Byte by byte, since the match may overlap the bytes it produces
+            size_t from = out.size() - distance;
+            for (size_t i = 0; i < length; i++) {
+                out.push_back(out[from + i]);
+            }
+        }
+    }
+    
+    // Decompress a zlib stream. maxOutput bounds the result so corrupt data can't balloon.
+    bool Inflate(const uint8_t* data, size_t size, size_t maxOutput, std::vector<uint8_t>& out) {
+        // zlib header: deflate method, no preset dictionary
+        if (size < 2 || (data[0] & 0x0F) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 0x20)) {
+            return false;
+        }
+        
+        BitReader bits(data + 2, size - 2);
+        out.clear();
+        out.reserve(maxOutput);
+        
+        Huffman literals;
+        Huffman distances;
+        bool lastBlock = false;
+        
+        while (!lastBlock) {
+            lastBlock = bits.Read(1) != 0;
+            uint32_t type = bits.Read(2);
+            
+            if (type == 0) {
+                // Stored block
+                bits.AlignToByte();
+                uint32_t length = bits.Read(16);
+                uint32_t inverse = bits.Read(16);
+                if ((length ^ 0xFFFF) != inverse || out.size() + length > maxOutput) {
+                    return false;
+                }
+                for (uint32_t i = 0; i < length; i++) {
+                    out.push_back(static_cast<uint8_t>(bits.Read(8)));
+                }
+            } else if (type == 1) {
+                // Fixed Huffman codes
+                uint8_t lengths[288 + 30];
+                memset(lengths, 8, 144);
+                memset(lengths + 144, 9, 112);
+                memset(lengths + 256, 7, 24);
+                memset(lengths + 280, 8, 8);
+                memset(lengths + 288, 5, 30);
+                literals.Build(lengths, 288);
+                distances.Build(lengths + 288, 30);
+                if (!InflateBlock(bits, literals, distances, out, maxOutput)) {
+                    return false;
+                }
+            } else if (type == 2) {
+                // Dynamic Huffman codes
+                int literalCount = static_cast<int>(bits.Read(5)) + 257;
+                int distanceCount = static_cast<int>(bits.Read(5)) + 1;
+                int codeLengthCount = static_cast<int>(bits.Read(4)) + 4;
+                if (literalCount > 286 || distanceCount > 30) {
+                    return false;
+                }
+                
+                uint8_t codeLengths[19] = {0};
+                for (int i = 0; i < codeLengthCount; i++) {
+                    codeLengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(bits.Read(3));
+                }
+                Huffman codeLengthCode;
+                if (!codeLengthCode.Build(codeLengths, 19)) {
+                    return false;
+                }
+                
+                uint8_t lengths[286 + 30] = {0};
+                int total = literalCount + distanceCount;
+                int index = 0;
+                while (index < total) {
+                    int symbol = codeLengthCode.Decode(bits);
+                    if (symbol < 0 || bits.Overrun()) {
+                        return false;
+                    }
+                    if (symbol < 16) {
+                        lengths[index++] = static_cast<uint8_t>(symbol);
+                        continue;
+                    }
+                    
+                    uint8_t value = 0;
+                    int repeat = 0;
+                    if (symbol == 16) {
+                        if (index == 0) {
+                            return false;
+                        }
+                        value = lengths[index - 1];
+                        repeat = 3 + static_cast<int>(bits.Read(2));
+                    } else if (symbol == 17) {
+                        repeat = 3 + static_cast<int>(bits.Read(3));
+                    } else {
+                        repeat = 11 + static_cast<int>(bits.Read(7));
+                    }
+                    if (index + repeat > total) {
+                        return false;
+                    }
+                    while (repeat--) {
+                        lengths[index++] = value;
+                    }
+                }
+                
+                if (lengths[256] == 0 ||
+                    !literals.Build(lengths, literalCount) ||
+                    !distances.Build(lengths + literalCount, distanceCount)) {
+                    return false;
+                }
+                if (!InflateBlock(bits, literals, distances, out, maxOutput)) {
+                    return false;
+                }
+            } else {
+                return false;
+            }
+            
+            if (bits.Overrun()) {
+                return false;
+            }
+        }
+        
+        // The Adler-32 trailer isn't verified - a damaged stream almost always fails above
+        return true;
+    }
+    
+    // ---- PNG ----
+    
+    struct PngInfo {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        int bitDepth = 0;
+        int colorType = 0;
+        int interlace = 0;
+        int channels = 0;
+        uint32_t palette[256] = {0};     // Non-premultiplied ARGB
+        int paletteSize = 0;
+        bool hasTransparentColor = false;
+        uint16_t transparentColor[3] = {0};
+    };
+    
+    uint8_t PaethPredictor(int a, int b, int c) {
+        int p = a + b - c;
+        int pa = p > a ? p - a : a - p;
+        int pb = p > b ? p - b : b - p;
+        int pc = p > c ? p - c : c - p;
+        if (pa <= pb && pa <= pc) {
+            return static_cast<uint8_t>(a);
+        }
+        return static_cast<uint8_t>(pb <= pc ? b : c);
+    }
+    
+    // Reverse the per-row filters in place. rows points at height * (1 + stride) bytes.
+    bool Unfilter(uint8_t* rows, uint32_t height, size_t stride, size_t bytesPerPixel) {
+        uint8_t* previous = nullptr;
+        for (uint32_t y = 0; y < height; y++) {
+            uint8_t filter = rows[0];
+            uint8_t* row = rows + 1;
+            
+            switch (filter) {
+                case 0:
+                    break;
+                case 1:
+                    for (size_t i = bytesPerPixel; i < stride; i++) {
+                        row[i] = static_cast<uint8_t>(row[i] + row[i - bytesPerPixel]);
+                    }
+                    break;
+                case 2:
+                    if (previous) {
+                        for (size_t i = 0; i < stride; i++) {
+                            row[i] = static_cast<uint8_t>(row[i] + previous[i]);
+                        }
+                    }
+                    break;
+                case 3:
+                    for (size_t i = 0; i < stride; i++) {
+                        int left = i >= bytesPerPixel ? row[i - bytesPerPixel] : 0;
+                        int up = previous ? previous[i] : 0;
+                        row[i] = static_cast<uint8_t>(row[i] + ((left + up) >> 1));
+                    }
+                    break;
+                case 4:
+                    for (size_t i = 0; i < stride; i++) {
+                        int left = i >= bytesPerPixel ? row[i - bytesPerPixel] : 0;
+                        int up = previous ? previous[i] : 0;
+                        int upLeft = (previous && i >= bytesPerPixel) ? previous[i - bytesPerPixel] : 0;
+                        row[i] = static_cast<uint8_t>(row[i] + PaethPredictor(left, up, upLeft));
+                    }
+                    break;
+                default:
+                    return false;
+            }
+            
+            previous = row;
+            rows += 1 + stride;
+        }
+        return true;
+    }
+    
+    // Read sample i of a row holding samples of bitDepth bits
+    uint32_t ReadSample(const uint8_t* row, size_t i, int bitDepth) {
+        switch (bitDepth) {
+            case 16:
+                return (static_cast<uint32_t>(row[i * 2]) << 8) | row[i * 2 + 1];
+            case 8:
+                return row[i];
+            default: {
+                size_t bit = i * bitDepth;
+                int shift = 8 - bitDepth - static_cast<int>(bit % 8);
+                return (row[bit / 8] >> shift) & ((1u << bitDepth) - 1);
+            }
+        }
+    }
+    
+    // Scale a sample to 8 bits (bit depths 1, 2, 4 and 16)
+    uint32_t ScaleSample(uint32_t value, int bitDepth) {
+        switch (bitDepth) {
+            case 16: return value >> 8;
+            case 8: return value;
+            case 4: return value * 0x11;
+            case 2: return value * 0x55;
+            default: return value * 0xFF;
+        }
+    }
+    
+    // Convert count pixels of an unfiltered row into straight BGRA at out[i * step]
+    void ConvertRow(const uint8_t* row, uint32_t count, const PngInfo& info, uint32_t* out, size_t step) {
+        for (uint32_t x = 0; x < count; x++) {
+            size_t sample = static_cast<size_t>(x) * info.channels;
+            uint32_t r, g, b, a = 255;
+            
+            switch (info.colorType) {
+                case 0: { // Grayscale
+                    uint32_t gray = ReadSample(row, sample, info.bitDepth);
+                    if (info.hasTransparentColor && gray == info.transparentColor[0]) {
+                        a = 0;
+                    }
+                    r = g = b = ScaleSample(gray, info.bitDepth);
+                    break;
+                }
+                case 2: { // RGB
+                    uint32_t rawR = ReadSample(row, sample, info.bitDepth);
+                    uint32_t rawG = ReadSample(row, sample + 1, info.bitDepth);
+                    uint32_t rawB = ReadSample(row, sample + 2, info.bitDepth);
+                    if (info.hasTransparentColor && rawR == info.transparentColor[0] &&
+                        rawG == info.transparentColor[1] && rawB == info.transparentColor[2]) {
+                        a = 0;
+                    }
+                    r = ScaleSample(rawR, info.bitDepth);
+                    g = ScaleSample(rawG, info.bitDepth);
+                    b = ScaleSample(rawB, info.bitDepth);
+                    break;
+                }
+                case 3: { // Palette
+                    uint32_t entry = info.palette[ReadSample(row, sample, info.bitDepth) & 0xFF];
+                    a = entry >> 24;
+                    r = (entry >> 16) & 0xFF;
+                    g = (entry >> 8) & 0xFF;
+                    b = entry & 0xFF;
+                    break;
+                }
+                case 4: // Grayscale + alpha
+                    r = g = b = ScaleSample(ReadSample(row, sample, info.bitDepth), info.bitDepth);
+                    a = ScaleSample(ReadSample(row, sample + 1, info.bitDepth), info.bitDepth);
+                    break;
+                default: // RGBA
+                    r = ScaleSample(ReadSample(row, sample, info.bitDepth), info.bitDepth);
+                    g = ScaleSample(ReadSample(row, sample + 1, info.bitDepth), info.bitDepth);
+                    b = ScaleSample(ReadSample(row, sample + 2, info.bitDepth), info.bitDepth);
+                    a = ScaleSample(ReadSample(row, sample + 3, info.bitDepth), info.bitDepth);
+                    break;
+            }
+            
+            out[x * step] = MakePixel(r, g, b, a);
+        }
+    }
+    
+    bool IsValidPngFormat(int colorType, int bitDepth) {
+        switch (colorType) {
+            case 0: return bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8 || bitDepth == 16;
+            case 3: return bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8;
+            case 2:
+            case 4:
+            case 6: return bitDepth == 8 || bitDepth == 16;
+            default: return false;
+        }
+    }
+}
+
+bool IconDecoder::DecodeIco(const uint8_t* data, size_t size, int targetSize, DecodedImage& image) {
+    // ICONDIR: reserved (0), type (1 = icon), count, then 16-byte ICONDIRENTRY records
+    if (!data || size < 6 || ReadU16(data) != 0 || ReadU16(data + 2) != 1) {
+        return false;
+    }
+    
+    size_t count = ReadU16(data + 4);
+    if (count == 0 || 6 + count * 16 > size) {
+        return false;
+    }
+    
+    std::vector<IconEntryInfo> entries(count);
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* entry = data + 6 + i * 16;
+        entries[i].width = entry[0] ? entry[0] : 256;
+        entries[i].height = entry[1] ? entry[1] : 256;
+        entries[i].bitCount = ReadU16(entry + 6);
+    }
+    
+    int best = SelectBestEntry(entries, targetSize);
+    if (best < 0) {
+        return false;
+    }
+    
+    const uint8_t* entry = data + 6 + best * 16;
+    uint32_t bytes = ReadU32(entry + 8);
+    uint32_t offset = ReadU32(entry + 12);
+    if (offset > size || bytes > size - offset) {
+        return false;
+    }
+    
+    return DecodeIconImage(data + offset, bytes, image);
+}
+
+bool IconDecoder::DecodeIconImage(const uint8_t* data, size_t size, DecodedImage& image) {
+    if (!data) {
+        return false;
+    }
+    
+    if (size >= sizeof(PNG_SIGNATURE) && memcmp(data, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) == 0) {
+        return DecodePng(data, size, image);
+    }
+    return DecodeDib(data, size, image);
+}
+
+int IconDecoder::SelectBestEntry(const std::vector<IconEntryInfo>& entries, int targetSize) {
+    int best = -1;
+    int bestSize = 0;
+    int bestBits = 0;
+    
+    for (size_t i = 0; i < entries.size(); i++) {
+        int entrySize = entries[i].width > entries[i].height ? entries[i].width : entries[i].height;
+        int entryBits = entries[i].bitCount ? entries[i].bitCount : 32;
+        
+        bool better = false;
+        if (best < 0) {
+            better = true;
+        } else if (entrySize == bestSize) {
+            better = entryBits > bestBits;
+        } else if (bestSize >= targetSize) {
+            // Already large enough - only a smaller one that still covers the target is better
+            better = entrySize >= targetSize && entrySize < bestSize;
+        } else {
+            // Too small so far - anything larger is better
+            better = entrySize > bestSize;
+        }
+        
+        if (better) {
+            best = static_cast<int>(i);
+            bestSize = entrySize;
+            bestBits = entryBits;
+        }
+    }
+    
+    return best;
+}
+
+bool IconDecoder::DecodePng(const uint8_t* data, size_t size, DecodedImage& image) {
+    PngInfo info;
+    std::vector<uint8_t> compressed;
+    bool hasHeader = false;
+    size_t position = sizeof(PNG_SIGNATURE);
+    
+    // Walk the chunks, collecting IDAT data (CRCs are not checked)
+    while (position + 12 <= size) {
+        uint32_t length = ReadU32BE(data + position);
+        const uint8_t* type = data + position + 4;
+        const uint8_t* chunk = data + position + 8;
+        if (length > size - position - 12) {
+            return false;
+        }
+        
+        if (memcmp(type, "IHDR", 4) == 0) {
+            if (length < 13) {
+                return false;
+            }
+            info.width = ReadU32BE(chunk);
+            info.height = ReadU32BE(chunk + 4);
+            info.bitDepth = chunk[8];
+            info.colorType = chunk[9];
+            info.interlace = chunk[12];
+            hasHeader = true;
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            info.paletteSize = static_cast<int>(length / 3 > 256 ? 256 : length / 3);
+            for (int i = 0; i < info.paletteSize; i++) {
+                info.palette[i] = 0xFF000000 | (chunk[i * 3] << 16) | (chunk[i * 3 + 1] << 8) | chunk[i * 3 + 2];
+            }
+        } else if (memcmp(type, "tRNS", 4) == 0) {
+            if (info.colorType == 3) {
+                // Alpha per palette entry
+                for (uint32_t i = 0; i < length && i < 256; i++) {
+                    info.palette[i] = (info.palette[i] & 0x00FFFFFF) | (static_cast<uint32_t>(chunk[i]) << 24);
+                }
+            } else if (info.colorType == 0 && length >= 2) {
+                info.hasTransparentColor = true;
+                info.transparentColor[0] = static_cast<uint16_t>((chunk[0] << 8) | chunk[1]);
+            } else if (info.colorType == 2 && length >= 6) {
+                info.hasTransparentColor = true;
+                for (int i = 0; i < 3; i++) {
+                    info.transparentColor[i] = static_cast<uint16_t>((chunk[i * 2] << 8) | chunk[i * 2 + 1]);
+                }
+            }
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            compressed.insert(compressed.end(), chunk, chunk + length);
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        
+        position += 12 + length;
+    }
+    
+    if (!hasHeader || info.width == 0 || info.height == 0 ||
+        info.width > static_cast<uint32_t>(MAX_IMAGE_SIZE) || info.height > static_cast<uint32_t>(MAX_IMAGE_SIZE) ||
+        !IsValidPngFormat(info.colorType, info.bitDepth) || info.interlace > 1 ||
+        (info.colorType == 3 && info.paletteSize == 0)) {
+        return false;
+    }
+    
+    static const int CHANNELS[7] = {1, 0, 3, 1, 2, 0, 4};
+    info.channels = CHANNELS[info.colorType];
+    size_t bitsPerPixel = static_cast<size_t>(info.channels) * info.bitDepth;
+    size_t bytesPerPixel = bitsPerPixel >= 8 ? bitsPerPixel / 8 : 1;
+    
+    // Adam7 passes: start x, start y, step x, step y. A non-interlaced image is one full pass.
+    static const int ADAM7[7][4] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4},
+                                    {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+    static const int NO_INTERLACE[1][4] = {{0, 0, 1, 1}};
+    const int (*passes)[4] = info.interlace ? ADAM7 : NO_INTERLACE;
+    int passCount = info.interlace ? 7 : 1;
+    
+    size_t expectedBytes = 0;
+    for (int pass = 0; pass < passCount; pass++) {
+        size_t passWidth = (info.width - passes[pass][0] + passes[pass][2] - 1) / passes[pass][2];
+        size_t passHeight = (info.height - passes[pass][1] + passes[pass][3] - 1) / passes[pass][3];
+        if (passWidth && passHeight) {
+            expectedBytes += passHeight * (1 + (passWidth * bitsPerPixel + 7) / 8);
+        }
+    }
+    
+    std::vector<uint8_t> raw;
+    if (!Inflate(compressed.data(), compressed.size(), expectedBytes, raw) || raw.size() != expectedBytes) {
+        return false;
+    }
+    
+    image.width = static_cast<int>(info.width);
+    image.height = static_cast<int>(info.height);
+    image.pixels.assign(static_cast<size_t>(info.width) * info.height, 0);
+    
+    uint8_t* rows = raw.data();
+    for (int pass = 0; pass < passCount; pass++) {
+        uint32_t passWidth = (info.width - passes[pass][0] + passes[pass][2] - 1) / passes[pass][2];
+        uint32_t passHeight = (info.height - passes[pass][1] + passes[pass][3] - 1) / passes[pass][3];
+        if (!passWidth || !passHeight) {
+            continue;
+        }
+        
+        size_t stride = (passWidth * bitsPerPixel + 7) / 8;
+        if (!Unfilter(rows, passHeight, stride, bytesPerPixel)) {
+            return false;
+        }
+        
+        for (uint32_t y = 0; y < passHeight; y++) {
+            size_t outY = passes[pass][1] + static_cast<size_t>(y) * passes[pass][3];
+            uint32_t* out = &image.pixels[outY * info.width + passes[pass][0]];
+            ConvertRow(rows + y * (1 + stride) + 1, passWidth, info, out, passes[pass][2]);
+        }
+        rows += passHeight * (1 + stride);
+    }
+    
+    PixelOps::Premultiply(image.pixels.data(), image.pixels.data(), image.pixels.size());
+    return true;
+}
+
+bool IconDecoder::DecodeDib(const uint8_t* data, size_t size, DecodedImage& image) {
+    // BITMAPINFOHEADER; the height covers both the color (XOR) image and the AND mask
+    if (size < 40) {
+        return false;
+    }
+    
+    uint32_t headerSize = ReadU32(data);
+    int32_t width = static_cast<int32_t>(ReadU32(data + 4));
+    int32_t doubleHeight = static_cast<int32_t>(ReadU32(data + 8));
+    uint16_t bitCount = ReadU16(data + 14);
+    uint32_t compression = ReadU32(data + 16);
+    uint32_t colorsUsed = ReadU32(data + 32);
+    
+    int32_t height = doubleHeight / 2;
+    if (headerSize < 40 || headerSize > size || width <= 0 || height <= 0 ||
+        width > MAX_IMAGE_SIZE || height > MAX_IMAGE_SIZE || compression != 0 ||
+        (bitCount != 1 && bitCount != 4 && bitCount != 8 && bitCount != 24 && bitCount != 32)) {
+        return false;
+    }
+    
+    // Color table for indexed formats
+    size_t paletteSize = 0;
+    if (bitCount <= 8) {
+        paletteSize = colorsUsed ? colorsUsed : (1u << bitCount);
+        if (paletteSize > (1u << bitCount)) {
+            return false;
+        }
+    }
+    const uint8_t* palette = data + headerSize;
+    
+    size_t colorStride = ((static_cast<size_t>(width) * bitCount + 31) / 32) * 4;
+    size_t maskStride = ((static_cast<size_t>(width) + 31) / 32) * 4;
+    size_t colorOffset = headerSize + paletteSize * 4;
+    size_t maskOffset = colorOffset + colorStride * height;
+    if (maskOffset > size) {
+        return false;
+    }
+    
+    // Some 32-bit icons omit the mask; treat a missing mask as fully opaque
+    bool hasMask = maskOffset + maskStride * height <= size;
+    const uint8_t* colors = data + colorOffset;
+    const uint8_t* mask = data + maskOffset;
+    
+    image.width = width;
+    image.height = height;
+    image.pixels.assign(static_cast<size_t>(width) * height, 0);
+    
+    // 32-bit images carry their own alpha unless every pixel is zero (pre-XP icons)
+    bool useAlpha = false;
+    if (bitCount == 32) {
+        for (int32_t y = 0; y < height && !useAlpha; y++) {
+            const uint8_t* row = colors + y * colorStride;
+            for (int32_t x = 0; x < width; x++) {
+                if (row[x * 4 + 3]) {
+                    useAlpha = true;
+                    break;
+                }
+            }
+        }
+    }
+    
+    // Rows are stored bottom-up
+    for (int32_t y = 0; y < height; y++) {
+        const uint8_t* row = colors + (height - 1 - y) * colorStride;
+        const uint8_t* maskRow = mask + (height - 1 - y) * maskStride;
+        uint32_t* out = &image.pixels[static_cast<size_t>(y) * width];
+        
+        for (int32_t x = 0; x < width; x++) {
+            uint32_t r, g, b, a;
+            
+            if (bitCount >= 24) {
+                const uint8_t* pixel = row + x * (bitCount / 8);
+                b = pixel[0];
+                g = pixel[1];
+                r = pixel[2];
+                a = useAlpha ? pixel[3] : 255;
+            } else {
+                size_t index = ReadSample(row, x, bitCount);
+                if (index >= paletteSize) {
+                    index = 0;
+                }
+                b = palette[index * 4];
+                g = palette[index * 4 + 1];
+                r = palette[index * 4 + 2];
+                a = 255;
+            }
+            
+            // A set AND-mask bit means transparent
+            if (!useAlpha && hasMask && (maskRow[x / 8] & (0x80 >> (x % 8)))) {
+                a = 0;
+            }
+            
+            out[x] = MakePixel(r, g, b, a);
+        }
+    }
+    
+    PixelOps::Premultiply(image.pixels.data(), image.pixels.data(), image.pixels.size());
+    return true;
+}
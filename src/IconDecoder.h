@@ -0,0 +1,42 @@
+// IconDecoder.h - ICO/PNG/DIB icon image decoder (portable, no Win32)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Decoded icon pixels: top-down rows of premultiplied BGRA (0xAARRGGBB words)
+struct DecodedImage {
+    std::vector<uint32_t> pixels;
+    int width = 0;
+    int height = 0;
+};
+
+// Size information from an icon directory entry (ICONDIRENTRY / GRPICONDIRENTRY)
+struct IconEntryInfo {
+    int width = 0;                 // 0 in the directory means 256
+    int height = 0;
+    int bitCount = 0;              // 0 is treated as 32 (typical for PNG entries)
+};
+
+class IconDecoder {
+public:
+    // Decode the entry of an .ico file that best fits targetSize. Only the chosen
+    // entry is decoded - every other image in the file is skipped.
+    static bool DecodeIco(const uint8_t* data, size_t size, int targetSize, DecodedImage& image);
+    
+    // Decode a single icon image as stored in an .ico entry or an RT_ICON resource:
+    // either an embedded PNG or a BITMAPINFOHEADER DIB followed by its AND mask
+    static bool DecodeIconImage(const uint8_t* data, size_t size, DecodedImage& image);
+    
+    // Pick the entry closest to targetSize: the smallest one at least that large,
+    // otherwise the largest; deeper color breaks ties. Returns -1 if entries is empty.
+    static int SelectBestEntry(const std::vector<IconEntryInfo>& entries, int targetSize);
+    
+    // Largest width or height accepted, to bound allocations from malformed files
+    static const int MAX_IMAGE_SIZE = 4096;
+
+private:
+    static bool DecodePng(const uint8_t* data, size_t size, DecodedImage& image);
+    static bool DecodeDib(const uint8_t* data, size_t size, DecodedImage& image);
+};
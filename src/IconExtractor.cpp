@@ -1,164 +1,72 @@
 // IconExtractor.cpp - Simplified icon extraction implementation
 #include "IconExtractor.h"
-#include <shellapi.h>
+#include "PeIconReader.h"
 
-IconExtractor::IconExtractor() {
+IconExtractor::IconExtractor()
+    : windowManager(nullptr)
+{
 }
 
 IconExtractor::~IconExtractor() {
-    ClearCache();
 }
 
-HICON IconExtractor::ExtractFromExecutable(const std::wstring& exePath, int iconIndex) {
-    if (exePath.empty()) {
-        return nullptr;
+bool IconExtractor::DecodeIcon(const std::wstring& path, int iconIndex, int targetSize, DecodedImage& image) {
+    if (path.empty()) {
+        return false;
     }
     
-    // Check cache first
-    std::wstring cacheKey = GenerateCacheKey(exePath, iconIndex);
-    auto cacheIt = iconCache.find(cacheKey);
-    if (cacheIt != iconCache.end()) {
-        return cacheIt->second;
+    // Random access: executables are read a few small pieces at a time
+    HANDLE file = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
     }
     
-    // Extract icon from PE resources
-    HICON icon = ExtractIconFromPE(exePath);
-    if (!icon) {
-        return nullptr;
+    // Tell .ico files from executables by their signature rather than the extension
+    bool success = false;
+    LARGE_INTEGER fileSize = {};
+    uint8_t signature[2];
+    if (GetFileSizeEx(file, &fileSize) && ReadAt(file, 0, signature, sizeof(signature))) {
+        if (PeIconReader::IsExecutable(signature, sizeof(signature))) {
+            success = DecodeExecutableIcon(file, iconIndex, targetSize, image);
+        } else {
+            success = DecodeIconFile(file, static_cast<uint64_t>(fileSize.QuadPart), targetSize, image);
+        }
     }
     
-    // Cache and return
-    iconCache[cacheKey] = icon;
-    return icon;
+    CloseHandle(file);
+    return success;
 }
 
-HICON IconExtractor::ExtractFromIconFile(const std::wstring& iconPath) {
-    if (iconPath.empty()) {
-        return nullptr;
-    }
-    
-    // Check cache first
-    std::wstring cacheKey = GenerateCacheKey(iconPath, 0);
-    auto cacheIt = iconCache.find(cacheKey);
-    if (cacheIt != iconCache.end()) {
-        return cacheIt->second;
-    }
-    
-    // Load icon from file
-    HICON icon = LoadIconFromFile(iconPath);
-    if (!icon) {
-        return nullptr;
+bool IconExtractor::DecodeIconFile(HANDLE file, uint64_t fileSize, int targetSize, DecodedImage& image) {
+    if (fileSize == 0 || fileSize > MAX_ICON_FILE_SIZE) {
+        return false;
     }
     
-    // Cache and return
-    iconCache[cacheKey] = icon;
-    return icon;
-}
-
-void IconExtractor::ClearCache() {
-    for (auto& pair : iconCache) {
-        if (pair.second) {
-            DestroyIcon(pair.second);
-        }
-    }
-    iconCache.clear();
-}
-
-HICON IconExtractor::ExtractIconFromPE(const std::wstring& filePath) {
-    // Try to load the executable as a module to access its resources
-    HMODULE hModule = LoadLibraryEx(filePath.c_str(), nullptr, LOAD_LIBRARY_AS_DATAFILE | LOAD_LIBRARY_AS_IMAGE_RESOURCE);
-    if (!hModule) {
-        return nullptr;
+    // Read the file once and decode only the entry closest to targetSize
+    std::vector<uint8_t> data(static_cast<size_t>(fileSize));
+    if (!ReadAt(file, 0, data.data(), data.size())) {
+        return false;
     }
     
-    // Enumerate icon resources properly using EnumResourceNames
-    struct EnumIconContext {
-        HMODULE hModule;
-        HICON icon256;
-        std::wofstream* debugFile;
-    };
-    
-    EnumIconContext context = { hModule, nullptr, nullptr };
-    
-    // Callback function for EnumResourceNames
-    auto enumIconProc = [](HMODULE hModule, LPCTSTR /*lpType*/, LPTSTR lpName, LONG_PTR lParam) -> BOOL {
-        EnumIconContext* ctx = reinterpret_cast<EnumIconContext*>(lParam);
-        
-        // lpName can be either a string or an integer ID (MAKEINTRESOURCE)
-        int iconId = IS_INTRESOURCE(lpName) ? (int)(UINT_PTR)lpName : 0;
-        
-        if (iconId > 0) {
-            // Try to load 256x256 icon
-            HICON icon = (HICON)LoadImage(hModule, MAKEINTRESOURCE(iconId), IMAGE_ICON, 256, 256, LR_DEFAULTCOLOR);
-            if (icon) {
-                // Verify actual size
-                ICONINFO iconInfo;
-                if (GetIconInfo(icon, &iconInfo)) {
-                    BITMAP bmp;
-                    if (GetObject(iconInfo.hbmColor, sizeof(bmp), &bmp)) {
-                        int actualSize = min(bmp.bmWidth, bmp.bmHeight);
-                        
-                        if (actualSize == 256) {
-                            ctx->icon256 = icon;
-                            DeleteObject(iconInfo.hbmColor);
-                            DeleteObject(iconInfo.hbmMask);
-                            return FALSE; // Stop enumeration - found what we need
-                        } else {
-                            DestroyIcon(icon);
-                        }
-                    }
-                    DeleteObject(iconInfo.hbmColor);
-                    DeleteObject(iconInfo.hbmMask);
-                } else {
-                    DestroyIcon(icon);
-                }
-            }
-        }
-        
-        return TRUE; // Continue enumeration
-    };
-    
-    // Enumerate all icon group resources
-    EnumResourceNames(hModule, RT_GROUP_ICON, enumIconProc, (LONG_PTR)&context);
-    
-    HICON icon256 = context.icon256;
-    
-    FreeLibrary(hModule);
-    return icon256;
+    return IconDecoder::DecodeIco(data.data(), data.size(), targetSize, image);
 }
 
-HICON IconExtractor::LoadIconFromFile(const std::wstring& iconPath) {
-    // Try to load icon directly using LoadImage with specific size
-    HICON icon = (HICON)LoadImage(
-        nullptr,
-        iconPath.c_str(),
-        IMAGE_ICON,
-        256,
-        256,
-        LR_LOADFROMFILE | LR_DEFAULTCOLOR
-    );
-    
-    return icon;
+bool IconExtractor::DecodeExecutableIcon(HANDLE file, int iconIndex, int targetSize, DecodedImage& image) {
+    // Only the headers and the resources on the way to the icon are read, so large
+    // game executables cost the same as small ones
+    PeIconReader reader([file](uint64_t offset, void* buffer, size_t size) {
+        return ReadAt(file, offset, buffer, size);
+    });
+    return reader.ReadIcon(iconIndex, targetSize, image);
 }
 
-std::wstring IconExtractor::GenerateCacheKey(const std::wstring& filePath, int iconIndex) {
-    return filePath + L":" + std::to_wstring(iconIndex);
-}
-
-bool IconExtractor::IsValidIcon(HICON icon) {
-    if (!icon) {
-        return false;
-    }
-    
-    // Try to get icon info to verify it's valid
-    ICONINFO iconInfo;
-    bool valid = GetIconInfo(icon, &iconInfo);
-    
-    if (valid) {
-        // Clean up the bitmaps
-        if (iconInfo.hbmColor) DeleteObject(iconInfo.hbmColor);
-        if (iconInfo.hbmMask) DeleteObject(iconInfo.hbmMask);
-    }
-    
-    return valid;
+bool IconExtractor::ReadAt(HANDLE file, uint64_t offset, void* buffer, size_t size) {
+    // Positional I/O, so concurrent readers don't share a file pointer
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    
+    DWORD bytesRead = 0;
+    return ReadFile(file, buffer, static_cast<DWORD>(size), &bytesRead, &overlapped) && bytesRead == size;
 }
\ No newline at end of file
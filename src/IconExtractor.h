@@ -3,10 +3,8 @@
 
 #include <windows.h>
 #include <string>
-#include <unordered_map>
-#include <shellapi.h>
-#include <shlobj.h>
-#include "DataModels.h"
+#include <vector>
+#include "IconDecoder.h"
 
 class WindowManager;
 
@@ -16,23 +14,19 @@ public:
     ~IconExtractor();
 
     void SetWindowManager(WindowManager* windowMgr) { windowManager = windowMgr; }
-    HICON ExtractFromExecutable(const std::wstring& exePath, int iconIndex = 0);
-    HICON ExtractFromIconFile(const std::wstring& iconPath);
     
-    void ClearCache();
-    size_t GetCacheSize() const { return iconCache.size(); }
+    // Decode the icon image that best fits targetSize into premultiplied BGRA. path may be
+    // an .ico file or an executable/DLL; for executables iconIndex works as in ExtractIconEx.
+    // Safe to call from several workers at once.
+    bool DecodeIcon(const std::wstring& path, int iconIndex, int targetSize, DecodedImage& image);
 
 private:
-    // Icon cache to avoid repeated extractions
-    std::unordered_map<std::wstring, HICON> iconCache;
     WindowManager* windowManager;
     
-    HICON ExtractIconFromPE(const std::wstring& filePath);
-    HICON LoadIconFromFile(const std::wstring& iconPath);
-    
-    std::wstring GenerateCacheKey(const std::wstring& filePath, int iconIndex);
-    bool IsValidIcon(HICON icon);
+    bool DecodeIconFile(HANDLE file, uint64_t fileSize, int targetSize, DecodedImage& image);
+    bool DecodeExecutableIcon(HANDLE file, int iconIndex, int targetSize, DecodedImage& image);
+    static bool ReadAt(HANDLE file, uint64_t offset, void* buffer, size_t size);
     
     // Constants
-    static const int REQUIRED_ICON_SIZE = DesignConstants::TARGET_ICON_SIZE_PIXELS;
+    static const DWORD MAX_ICON_FILE_SIZE = 16 * 1024 * 1024;
 };
\ No newline at end of file
@@ -0,0 +1,233 @@
+// IconPixelPool.cpp - Slab pool of premultiplied icon pixel buffers implementation
+#include "IconPixelPool.h"
+#include <algorithm>
+#include <new>
+
+IconPixelPool::IconPixelPool()
+    : slotCount(0)
+    , slotsInUse(0)
+    , bytesInUse(0)
+    , peakSlotsInUse(0)
+    , peakBytesInUse(0)
+{
+}
+
+IconPixelPool::~IconPixelPool() {
+}
+
+IconPixelPool& IconPixelPool::Instance() {
+    static IconPixelPool instance;
+    return instance;
+}
+
+IconHandle IconPixelPool::Allocate(int width, int height) {
+    if (width <= 0 || height <= 0 || width > 16384 || height > 16384) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    // Find or create the size class
+    uint32_t classIndex = 0;
+    while (classIndex < sizeClasses.size() &&
+           (sizeClasses[classIndex].width != width || sizeClasses[classIndex].height != height)) {
+        classIndex++;
+    }
+    if (classIndex == sizeClasses.size()) {
+        SizeClass sizeClass;
+        sizeClass.width = width;
+        sizeClass.height = height;
+        sizeClass.slotPixels = static_cast<size_t>(width) * height;
+        sizeClasses.push_back(sizeClass);
+    }
+    
+    SizeClass& sizeClass = sizeClasses[classIndex];
+    if (sizeClass.freeSlots.empty() && !AddSlab(classIndex)) {
+        return 0;
+    }
+    
+    uint32_t slotId = sizeClass.freeSlots.back();
+    sizeClass.freeSlots.pop_back();
+    
+    // Publishing the generation makes the slot's fields visible to lookups
+    Slot& slot = chunks[slotId / CHUNK_SLOTS][slotId % CHUNK_SLOTS];
+    slot.liveGeneration.store(slot.nextGeneration, std::memory_order_release);
+    slabs[slot.slab]->usedCount++;
+    
+    slotsInUse++;
+    bytesInUse += sizeClass.slotPixels * sizeof(uint32_t);
+    peakSlotsInUse = std::max(peakSlotsInUse, slotsInUse);
+    peakBytesInUse = std::max(peakBytesInUse, bytesInUse);
+    return MakeHandle(slotId, slot.nextGeneration);
+}
+
+void IconPixelPool::Release(IconHandle handle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    Slot* slot = FindSlot(handle);
+    if (!slot) {
+        return;
+    }
+    
+    // Bump the generation so any copy of the handle goes stale
+    uint32_t slotId = static_cast<uint32_t>(handle >> 32) - 1;
+    slot->liveGeneration.store(0, std::memory_order_release);
+    slot->nextGeneration = slot->nextGeneration == UINT32_MAX ? 1 : slot->nextGeneration + 1;
+    
+    SizeClass& sizeClass = sizeClasses[slot->sizeClass];
+    sizeClass.freeSlots.push_back(slotId);
+    slotsInUse--;
+    bytesInUse -= sizeClass.slotPixels * sizeof(uint32_t);
+    
+    // Give an empty slab back unless it is the only free space left for its size
+    Slab& slab = *slabs[slot->slab];
+    slab.usedCount--;
+    if (slab.usedCount == 0 && sizeClass.freeSlots.size() > slab.slotIds.size()) {
+        FreeSlab(slot->slab);
+    }
+}
+
+uint32_t* IconPixelPool::GetPixels(IconHandle handle) const {
+    Slot* slot = FindSlot(handle);
+    return slot ? slot->pixels : nullptr;
+}
+
+int IconPixelPool::GetWidth(IconHandle handle) const {
+    Slot* slot = FindSlot(handle);
+    return slot ? slot->width : 0;
+}
+
+int IconPixelPool::GetHeight(IconHandle handle) const {
+    Slot* slot = FindSlot(handle);
+    return slot ? slot->height : 0;
+}
+
+IconPixelPool::Stats IconPixelPool::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    Stats stats;
+    for (const std::unique_ptr<Slab>& slab : slabs) {
+        if (!slab) {
+            continue;
+        }
+        const Slot& first = chunks[slab->slotIds[0] / CHUNK_SLOTS][slab->slotIds[0] % CHUNK_SLOTS];
+        size_t slotBytes = sizeClasses[first.sizeClass].slotPixels * sizeof(uint32_t);
+        
+        stats.slabCount++;
+        stats.slotsInUse += slab->usedCount;
+        stats.slotsFree += slab->slotIds.size() - slab->usedCount;
+        stats.bytesReserved += slab->slotIds.size() * slotBytes;
+        stats.bytesInUse += slab->usedCount * slotBytes;
+    }
+    
+    if (stats.bytesReserved) {
+        stats.fragmentation = 1.0 - static_cast<double>(stats.bytesInUse) / stats.bytesReserved;
+    }
+    stats.peakSlotsInUse = peakSlotsInUse;
+    stats.peakBytesInUse = peakBytesInUse;
+    return stats;
+}
+
+IconPixelPool::Slot* IconPixelPool::FindSlot(IconHandle handle) const {
+    if (handle == 0) {
+        return nullptr;
+    }
+    
+    uint32_t slotId = static_cast<uint32_t>(handle >> 32) - 1;
+    uint32_t generation = static_cast<uint32_t>(handle);
+    if (generation == 0 || slotId >= slotCount.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    
+    Slot& slot = chunks[slotId / CHUNK_SLOTS][slotId % CHUNK_SLOTS];
+    if (slot.liveGeneration.load(std::memory_order_acquire) != generation) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+bool IconPixelPool::AddSlab(uint32_t classIndex) {
+    SizeClass& sizeClass = sizeClasses[classIndex];
+    size_t slotBytes = sizeClass.slotPixels * sizeof(uint32_t);
+    uint32_t slabSlots = static_cast<uint32_t>(std::max<size_t>(1, SLAB_BYTES / slotBytes));
+    
+    if (retiredSlots.size() + (MAX_SLOTS - slotCount.load(std::memory_order_relaxed)) < slabSlots) {
+        return false;
+    }
+    
+    std::unique_ptr<Slab> slab(new (std::nothrow) Slab);
+    if (!slab) {
+        return false;
+    }
+    slab->pixels.reset(new (std::nothrow) uint32_t[sizeClass.slotPixels * slabSlots]);
+    if (!slab->pixels) {
+        return false;
+    }
+    
+    // Reuse the index of a freed slab if there is one
+    uint32_t slabIndex = 0;
+    while (slabIndex < slabs.size() && slabs[slabIndex]) {
+        slabIndex++;
+    }
+    
+    // Push in reverse so slots are handed out from the start of the slab
+    slab->slotIds.resize(slabSlots);
+    for (uint32_t i = 0; i < slabSlots; i++) {
+        uint32_t slotId = NewSlotId();
+        Slot& slot = chunks[slotId / CHUNK_SLOTS][slotId % CHUNK_SLOTS];
+        slot.pixels = slab->pixels.get() + i * sizeClass.slotPixels;
+        slot.sizeClass = classIndex;
+        slot.slab = slabIndex;
+        slot.width = static_cast<uint16_t>(sizeClass.width);
+        slot.height = static_cast<uint16_t>(sizeClass.height);
+        slab->slotIds[i] = slotId;
+    }
+    for (uint32_t i = slabSlots; i > 0; i--) {
+        sizeClass.freeSlots.push_back(slab->slotIds[i - 1]);
+    }
+    
+    if (slabIndex == slabs.size()) {
+        slabs.push_back(std::move(slab));
+    } else {
+        slabs[slabIndex] = std::move(slab);
+    }
+    return true;
+}
+
+void IconPixelPool::FreeSlab(uint32_t slabIndex) {
+    Slab& slab = *slabs[slabIndex];
+    
+    // Take the slab's slots off its size class free list
+    const Slot& first = chunks[slab.slotIds[0] / CHUNK_SLOTS][slab.slotIds[0] % CHUNK_SLOTS];
+    std::vector<uint32_t>& freeSlots = sizeClasses[first.sizeClass].freeSlots;
+    freeSlots.erase(std::remove_if(freeSlots.begin(), freeSlots.end(), [&](uint32_t slotId) {
+        return chunks[slotId / CHUNK_SLOTS][slotId % CHUNK_SLOTS].slab == slabIndex;
+    }), freeSlots.end());
+    
+    for (uint32_t slotId : slab.slotIds) {
+        chunks[slotId / CHUNK_SLOTS][slotId % CHUNK_SLOTS].pixels = nullptr;
+        retiredSlots.push_back(slotId);
+    }
+    
+    slabs[slabIndex].reset();
+}
+
+uint32_t IconPixelPool::NewSlotId() {
+    if (!retiredSlots.empty()) {
+        uint32_t slotId = retiredSlots.back();
+        retiredSlots.pop_back();
+        return slotId;
+    }
+    
+    // Chunks are allocated once and never move
+    uint32_t slotId = slotCount.load(std::memory_order_relaxed);
+    if (slotId % CHUNK_SLOTS == 0) {
+        chunks[slotId / CHUNK_SLOTS].reset(new Slot[CHUNK_SLOTS]);
+    }
+    slotCount.store(slotId + 1, std::memory_order_release);
+    return slotId;
+}
+
+IconHandle IconPixelPool::MakeHandle(uint32_t slotId, uint32_t generation) {
+    return (static_cast<IconHandle>(slotId + 1) << 32) | generation;
+}
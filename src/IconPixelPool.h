@@ -0,0 +1,104 @@
+// IconPixelPool.h - Slab pool of premultiplied icon pixel buffers (portable, no Win32)
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Handle to a pooled icon buffer. 0 means no icon; a released handle goes stale and
+// GetPixels returns nullptr for it rather than another icon's pixels. The slot is in the
+// high 32 bits and its generation in the low 32, so a stale handle could only match
+// again after 2^32 reuses of the same slot.
+typedef uint64_t IconHandle;
+
+// Icon pixels live in large slabs of equally sized slots instead of one GDI bitmap per
+// shortcut, so thousands of icons cost no GDI handles or kernel paged pool.
+// Allocate and Release may be called from any thread. Lookups do not lock: the slot's
+// live generation is atomic, and its other fields only change while no handle to it is
+// live. A handle must not be released while another thread still uses it.
+class IconPixelPool {
+public:
+    IconPixelPool();
+    ~IconPixelPool();
+    
+    // Process-wide pool used by ShortcutInfo
+    static IconPixelPool& Instance();
+    
+    // Delete copy/move
+    IconPixelPool(const IconPixelPool&) = delete;
+    IconPixelPool& operator=(const IconPixelPool&) = delete;
+    
+    // Reserve a width * height buffer (contents undefined). Returns 0 on failure.
+    IconHandle Allocate(int width, int height);
+    void Release(IconHandle handle);
+    
+    // Top-down premultiplied BGRA rows, or nullptr for a stale or empty handle
+    uint32_t* GetPixels(IconHandle handle) const;
+    int GetWidth(IconHandle handle) const;
+    int GetHeight(IconHandle handle) const;
+    
+    struct Stats {
+        size_t slabCount = 0;
+        size_t slotsInUse = 0;
+        size_t slotsFree = 0;
+        size_t bytesReserved = 0;  // Memory held by slabs
+        size_t bytesInUse = 0;     // Memory backing live handles
+        double fragmentation = 0;  // Share of reserved bytes not in use (0..1)
+        size_t peakSlotsInUse = 0; // Highest slotsInUse since the pool was created
+        size_t peakBytesInUse = 0;
+    };
+    Stats GetStats() const;
+    
+    static const size_t SLAB_BYTES = 4 * 1024 * 1024;     // Target slab size
+    static const uint32_t MAX_SLOTS = 1 << 22;              // Live and free slots combined
+
+private:
+    struct Slot {
+        uint32_t* pixels = nullptr;
+        uint32_t sizeClass = 0;
+        uint32_t slab = 0;
+        uint16_t width = 0;            // Copied from the size class so lookups don't lock
+        uint16_t height = 0;
+        std::atomic<uint32_t> liveGeneration{0};  // Generation of the live handle, 0 while free
+        uint32_t nextGeneration = 1;   // Under the mutex; never 0
+    };
+    
+    struct Slab {
+        std::unique_ptr<uint32_t[]> pixels;
+        std::vector<uint32_t> slotIds;
+        uint32_t usedCount = 0;
+    };
+    
+    // All buffers of one size share slabs and a free list
+    struct SizeClass {
+        int width = 0;
+        int height = 0;
+        size_t slotPixels = 0;
+        std::vector<uint32_t> freeSlots;
+    };
+    
+    // Slots are kept in fixed chunks that are never moved, so lookups need no lock
+    static const uint32_t CHUNK_SLOTS = 4096;
+    static const uint32_t MAX_CHUNKS = MAX_SLOTS / CHUNK_SLOTS;
+    std::unique_ptr<Slot[]> chunks[MAX_CHUNKS];
+    std::atomic<uint32_t> slotCount;
+    
+    std::vector<SizeClass> sizeClasses;
+    std::vector<std::unique_ptr<Slab>> slabs;  // Indexed by Slot::slab; freed slabs leave nullptr
+    std::vector<uint32_t> retiredSlots;        // Slot IDs of freed slabs, reused by new ones
+    size_t slotsInUse;
+    size_t bytesInUse;
+    size_t peakSlotsInUse;
+    size_t peakBytesInUse;
+    mutable std::mutex mutex;
+    
+    Slot* FindSlot(IconHandle handle) const;
+    bool AddSlab(uint32_t sizeClass);
+    void FreeSlab(uint32_t slabIndex);
+    uint32_t NewSlotId();
+    
+    static IconHandle MakeHandle(uint32_t slotId, uint32_t generation);
+};
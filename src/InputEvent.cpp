@@ -0,0 +1,69 @@
+// InputEvent.cpp - Controller edge detection implementation
+#include "InputEvent.h"
+#include <cstdlib>
+
+int GamepadEdgeDetector::Update(const GamepadState& state, int64_t time, InputEvent* events) {
+    int count = 0;
+    auto add = [&](InputEventType type, uint16_t button, int dx, int dy) {
+        InputEvent& event = events[count++];
+        event.time = time;
+        event.type = type;
+        event.button = button;
+        event.dx = static_cast<int8_t>(dx);
+        event.dy = static_cast<int8_t>(dy);
+    };
+    
+    // A fresh connection only sets the baseline
+    GamepadState current = state.connected ? state : GamepadState();
+    if (current.connected && !previous.connected) {
+        previous = current;
+        return 0;
+    }
+    
+    uint16_t changed = current.buttons ^ previous.buttons;
+    for (int bit = 0; bit < 16; bit++) {
+        uint16_t button = static_cast<uint16_t>(1u << bit);
+        if (changed & button) {
+            add((current.buttons & button) ? InputEventType::ButtonDown : InputEventType::ButtonUp, button, 0, 0);
+        }
+    }
+    
+    // Only the stronger axis counts, so a diagonal flick moves one way
+    int x = NormalizeStick(current.leftX);
+    int y = NormalizeStick(current.leftY);
+    int previousX = NormalizeStick(previous.leftX);
+    int previousY = NormalizeStick(previous.leftY);
+    if (abs(current.leftY) > abs(current.leftX)) {
+        if (y != 0 && y != previousY) {
+            add(InputEventType::StickDirection, 0, 0, -y);
+        }
+    } else if (x != 0 && x != previousX) {
+        add(InputEventType::StickDirection, 0, x, 0);
+    }
+    
+    int scroll = ScaleStick(current.rightY);
+    if (scroll != ScaleStick(previous.rightY)) {
+        add(InputEventType::Scroll, 0, 0, -scroll);
+    }
+    
+    previous = current;
+    return count;
+}
+
+int GamepadEdgeDetector::NormalizeStick(int value) {
+    if (value > STICK_DEADZONE) return 1;
+    if (value < -STICK_DEADZONE) return -1;
+    return 0;
+}
+
+int GamepadEdgeDetector::ScaleStick(int value) {
+    int magnitude = abs(value) - STICK_DEADZONE;
+    if (magnitude <= 0) {
+        return 0;
+    }
+    int scaled = (magnitude * STICK_RANGE + (32767 - STICK_DEADZONE) / 2) / (32767 - STICK_DEADZONE);
+    if (scaled > STICK_RANGE) {
+        scaled = STICK_RANGE;
+    }
+    return value < 0 ? -scaled : scaled;
+}
@@ -0,0 +1,59 @@
+// InputEvent.h - Controller input events and edge detection (portable, no Win32)
+#pragma once
+
+#include <cstdint>
+
+// One controller reading. Button bits and stick ranges are XInput's.
+struct GamepadState {
+    bool connected = false;
+    uint16_t buttons = 0;
+    int16_t leftX = 0;
+    int16_t leftY = 0;              // Positive is up
+    int16_t rightX = 0;
+    int16_t rightY = 0;             // Positive is up
+};
+
+enum class InputEventType : uint8_t {
+    ButtonDown,                     // button was pressed
+    ButtonUp,                       // button was released
+    StickDirection,                 // Left stick entered direction (dx, dy)
+    Scroll                          // Right stick deflection changed; dy is -127 full up to 127 full down
+};
+
+// What changed at one poll. Directions are in screen terms: dy -1 is up.
+struct InputEvent {
+    int64_t time = 0;               // Microseconds on the poll clock
+    InputEventType type = InputEventType::ButtonDown;
+    uint16_t button = 0;
+    int8_t dx = 0;
+    int8_t dy = 0;
+};
+
+// Turns successive readings of one controller into events. Buttons report both edges.
+// The left stick reports entering a direction outside the deadzone on its stronger axis,
+// like a D-pad press. The right stick reports its deflection whenever it changes, 0 once
+// it is back in the deadzone.
+// A controller that just connected reports nothing for buttons it already holds.
+class GamepadEdgeDetector {
+public:
+    // Compare state with the previous reading and write up to MAX_EVENTS events;
+    // returns how many
+    int Update(const GamepadState& state, int64_t time, InputEvent* events);
+    
+    // Forget the previous reading, as if the controller had been disconnected
+    void Reset() { previous = GamepadState(); }
+    
+    // -1, 0 or 1 for a stick axis, with STICK_DEADZONE around the center
+    static int NormalizeStick(int value);
+    
+    // -STICK_RANGE..STICK_RANGE for a stick axis; 0 in the deadzone, which is cut out so
+    // the value grows from there
+    static int ScaleStick(int value);
+    
+    static const int MAX_EVENTS = 18;   // 16 buttons, a stick direction and a scroll change
+    static const int STICK_DEADZONE = 4000;
+    static const int STICK_RANGE = 127;
+
+private:
+    GamepadState previous;
+};
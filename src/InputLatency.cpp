@@ -0,0 +1,60 @@
+// InputLatency.cpp - Input-to-present latency implementation
+#include "InputLatency.h"
+#include <cwchar>
+
+void InputLatency::Record(InputLatencyType type, int64_t micros) {
+    histograms[static_cast<int>(type)].Record(micros);
+}
+
+void InputLatency::Reset() {
+    for (LatencyHistogram& histogram : histograms) {
+        histogram.Reset();
+    }
+}
+
+const LatencyHistogram& InputLatency::GetHistogram(InputLatencyType type) const {
+    return histograms[static_cast<int>(type)];
+}
+
+uint64_t InputLatency::GetTotalCount() const {
+    uint64_t count = 0;
+    for (const LatencyHistogram& histogram : histograms) {
+        count += histogram.GetCount();
+    }
+    return count;
+}
+
+std::wstring InputLatency::GetReport() const {
+    std::wstring report = L"Input-to-present latency (ms)\n";
+    wchar_t line[160];
+    for (int i = 0; i < static_cast<int>(InputLatencyType::Count); i++) {
+        const LatencyHistogram& histogram = histograms[i];
+        if (histogram.GetCount() == 0) {
+            continue;
+        }
+        swprintf(line, sizeof(line) / sizeof(line[0]),
+            L"%-18ls %8llu samples  p50 %7.2f  p95 %7.2f  p99 %7.2f  max %7.2f\n",
+            GetTypeName(static_cast<InputLatencyType>(i)),
+            static_cast<unsigned long long>(histogram.GetCount()),
+            histogram.GetPercentile(0.50) / 1000.0,
+            histogram.GetPercentile(0.95) / 1000.0,
+            histogram.GetPercentile(0.99) / 1000.0,
+            histogram.GetMax() / 1000.0);
+        report += line;
+    }
+    if (GetTotalCount() == 0) {
+        report += L"No samples\n";
+    }
+    return report;
+}
+
+const wchar_t* InputLatency::GetTypeName(InputLatencyType type) {
+    switch (type) {
+        case InputLatencyType::ControllerButton: return L"controller";
+        case InputLatencyType::ControllerScroll: return L"controller-scroll";
+        case InputLatencyType::Key: return L"key";
+        case InputLatencyType::MouseWheel: return L"mouse-wheel";
+        case InputLatencyType::Mouse: return L"mouse";
+        default: return L"unknown";
+    }
+}
@@ -0,0 +1,40 @@
+// InputLatency.h - Input-to-present latency per input type (portable, no Win32)
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "LatencyHistogram.h"
+
+enum class InputLatencyType {
+    ControllerButton,       // D-pad, stick and shoulder navigation
+    ControllerScroll,       // Right stick
+    Key,
+    MouseWheel,
+    Mouse,                  // Hover and clicks
+    Count
+};
+
+// One histogram per input type, from the time the input happened to the time the
+// frame showing its result was presented. Any thread may record.
+class InputLatency {
+public:
+    InputLatency() {}
+    
+    // Delete copy/move
+    InputLatency(const InputLatency&) = delete;
+    InputLatency& operator=(const InputLatency&) = delete;
+    
+    void Record(InputLatencyType type, int64_t micros);
+    void Reset();
+    
+    const LatencyHistogram& GetHistogram(InputLatencyType type) const;
+    uint64_t GetTotalCount() const;
+    
+    // One line per input type with samples: count, p50, p95, p99 and max in milliseconds
+    std::wstring GetReport() const;
+    
+    static const wchar_t* GetTypeName(InputLatencyType type);
+
+private:
+    LatencyHistogram histograms[static_cast<int>(InputLatencyType::Count)];
+};
@@ -0,0 +1,233 @@
+// InputLog.cpp - Binary input log implementation
+#include "InputLog.h"
+
+namespace {
+    // File layout: magic and version as 32-bit words, the header and the actions as
+    // variable-length integers, then the state hash and an FNV-1a checksum of all
+    // bytes before it as 32-bit words. Each action is its time since the previous one,
+    // a type byte and its two values.
+    const size_t FIXED_HEADER_SIZE = 8;
+    const size_t TRAILER_SIZE = 8;
+    
+    void WriteU32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+        }
+    }
+    
+    uint32_t ReadU32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+    
+    // Seven bits per byte, low bits first; the high bit means more follow
+    void WriteVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+    
+    // Small negative numbers stay small: 0, -1, 1, -2, ... map to 0, 1, 2, 3, ...
+    void WriteSigned(std::vector<uint8_t>& out, int64_t value) {
+        WriteVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+    
+    uint32_t Checksum(const uint8_t* data, size_t size) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ data[i]) * 16777619u;
+        }
+        return hash;
+    }
+    
+    // Reads variable-length integers until the data runs out, after which it only
+    // returns 0 and IsValid is false
+    class VarintReader {
+    public:
+        VarintReader(const uint8_t* data, size_t size) : position(data), end(data + size), valid(true) {}
+        
+        bool IsValid() const { return valid; }
+        bool AtEnd() const { return position == end; }
+        
+        uint64_t ReadUnsigned() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (position == end) {
+                    break;
+                }
+                uint8_t byte = *position++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+            valid = false;
+            return 0;
+        }
+        
+        int64_t ReadSigned() {
+            uint64_t value = ReadUnsigned();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+        
+        // Signed value that must fit an int
+        int ReadInt() {
+            int64_t value = ReadSigned();
+            if (value < INT32_MIN || value > INT32_MAX) {
+                valid = false;
+                return 0;
+            }
+            return static_cast<int>(value);
+        }
+        
+        uint8_t ReadByte() {
+            if (position == end) {
+                valid = false;
+                return 0;
+            }
+            return *position++;
+        }
+    
+    private:
+        const uint8_t* position;
+        const uint8_t* end;
+        bool valid;
+    };
+}
+
+InputLog::InputLog()
+    : stateHash(GridNavigator::HASH_SEED)
+{
+}
+
+void InputLog::Begin(const InputLogHeader& newHeader) {
+    header = newHeader;
+    actions.clear();
+    stateHash = GridNavigator::HASH_SEED;
+}
+
+void InputLog::Add(const InputAction& action, const NavigationState& after) {
+    actions.push_back(action);
+    stateHash = GridNavigator::Hash(after, stateHash);
+}
+
+std::vector<uint8_t> InputLog::Encode() const {
+    std::vector<uint8_t> out;
+    out.reserve(64 + header.tabItemCounts.size() * 2 + actions.size() * 5);
+    WriteU32(out, MAGIC);
+    WriteU32(out, VERSION);
+    
+    WriteSigned(out, header.clientWidth);
+    WriteSigned(out, header.clientHeight);
+    WriteSigned(out, header.dpiPercent);
+    const PixelRect& area = header.gridArea;
+    const int areaValues[] = {area.left, area.top, area.right, area.bottom};
+    for (int value : areaValues) {
+        WriteSigned(out, value);
+    }
+    const GridMetrics& metrics = header.metrics;
+    const int metricValues[] = {metrics.iconSize, metrics.spacingHorizontal, metrics.spacingVertical, metrics.labelHeight,
+                                metrics.verticalPadding, metrics.borderPadding, metrics.borderExtension};
+    for (int value : metricValues) {
+        WriteSigned(out, value);
+    }
+    WriteVarint(out, header.tabItemCounts.size());
+    for (int count : header.tabItemCounts) {
+        WriteSigned(out, count);
+    }
+    const NavigationState& start = header.start;
+    WriteSigned(out, start.activeTabIndex);
+    WriteSigned(out, start.scrollOffset);
+    WriteSigned(out, start.selectedIconIndex);
+    WriteSigned(out, start.lastSelectedIconIndex);
+    WriteVarint(out, start.usingKeyboardNavigation ? 1 : 0);
+    
+    WriteVarint(out, actions.size());
+    int64_t previousTime = 0;
+    for (const InputAction& action : actions) {
+        // Times only go forward; a clock step back is stored as no time passing
+        int64_t time = action.time > previousTime ? action.time : previousTime;
+        WriteVarint(out, static_cast<uint64_t>(time - previousTime));
+        previousTime = time;
+        out.push_back(static_cast<uint8_t>(action.type));
+        WriteSigned(out, action.x);
+        WriteSigned(out, action.y);
+    }
+    
+    WriteU32(out, stateHash);
+    WriteU32(out, Checksum(out.data(), out.size()));
+    return out;
+}
+
+bool InputLog::Decode(const uint8_t* data, size_t size) {
+    Begin(InputLogHeader());
+    if (!data || size < FIXED_HEADER_SIZE + TRAILER_SIZE ||
+        ReadU32(data) != MAGIC || ReadU32(data + 4) != VERSION ||
+        ReadU32(data + size - 4) != Checksum(data, size - 4)) {
+        return false;
+    }
+    
+    InputLogHeader decoded;
+    VarintReader reader(data + FIXED_HEADER_SIZE, size - FIXED_HEADER_SIZE - TRAILER_SIZE);
+    decoded.clientWidth = reader.ReadInt();
+    decoded.clientHeight = reader.ReadInt();
+    decoded.dpiPercent = reader.ReadInt();
+    decoded.gridArea.left = reader.ReadInt();
+    decoded.gridArea.top = reader.ReadInt();
+    decoded.gridArea.right = reader.ReadInt();
+    decoded.gridArea.bottom = reader.ReadInt();
+    GridMetrics& metrics = decoded.metrics;
+    int* metricFields[] = {&metrics.iconSize, &metrics.spacingHorizontal, &metrics.spacingVertical, &metrics.labelHeight,
+                           &metrics.verticalPadding, &metrics.borderPadding, &metrics.borderExtension};
+    for (int* field : metricFields) {
+        *field = reader.ReadInt();
+    }
+    uint64_t tabCount = reader.ReadUnsigned();
+    if (tabCount > MAX_TABS) {
+        return false;
+    }
+    for (uint64_t i = 0; i < tabCount && reader.IsValid(); i++) {
+        decoded.tabItemCounts.push_back(reader.ReadInt());
+    }
+    decoded.start.activeTabIndex = reader.ReadInt();
+    decoded.start.scrollOffset = reader.ReadInt();
+    decoded.start.selectedIconIndex = reader.ReadInt();
+    decoded.start.lastSelectedIconIndex = reader.ReadInt();
+    decoded.start.usingKeyboardNavigation = reader.ReadUnsigned() != 0;
+    
+    // Every action takes at least four bytes, which bounds the count before reserving
+    uint64_t actionCount = reader.ReadUnsigned();
+    if (!reader.IsValid() || actionCount > size / 4) {
+        return false;
+    }
+    std::vector<InputAction> decodedActions;
+    decodedActions.reserve(static_cast<size_t>(actionCount));
+    int64_t time = 0;
+    for (uint64_t i = 0; i < actionCount && reader.IsValid(); i++) {
+        uint64_t delta = reader.ReadUnsigned();
+        if (delta > static_cast<uint64_t>(INT64_MAX - time)) {
+            return false;
+        }
+        time += static_cast<int64_t>(delta);
+        InputAction action;
+        action.time = time;
+        uint8_t type = reader.ReadByte();
+        action.type = static_cast<InputActionType>(type);
+        action.x = reader.ReadInt();
+        action.y = reader.ReadInt();
+        if (type < static_cast<uint8_t>(InputActionType::Navigate) || type > static_cast<uint8_t>(InputActionType::Last)) {
+            return false;
+        }
+        decodedActions.push_back(action);
+    }
+    if (!reader.IsValid() || !reader.AtEnd()) {
+        return false;
+    }
+    
+    header = decoded;
+    actions.swap(decodedActions);
+    stateHash = ReadU32(data + size - TRAILER_SIZE);
+    return true;
+}
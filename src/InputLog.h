@@ -0,0 +1,71 @@
+// InputLog.h - Compact binary log of logical input for replay (portable, no Win32)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GridLayout.h"
+#include "GridNavigator.h"
+
+// What an input asked for, after keys, buttons, sticks and the mouse were interpreted
+enum class InputActionType : uint8_t {
+    Navigate = 1,       // x, y: columns and rows to move the selection
+    Scroll,             // x: pixels
+    SelectTab,          // x: tab index
+    Select,             // x: icon index or -1; y: 1 when from keys or a controller
+    Launch,
+    Resize,             // x, y: new client size
+    Last = Resize
+};
+
+struct InputAction {
+    InputActionType type = InputActionType::Navigate;
+    int32_t x = 0;
+    int32_t y = 0;
+    int64_t time = 0;               // Microseconds since the recording started
+};
+
+// The grid a session was recorded on, which replay needs to take the same steps
+struct InputLogHeader {
+    int clientWidth = 0;
+    int clientHeight = 0;
+    int dpiPercent = 100;
+    PixelRect gridArea;             // At clientWidth x clientHeight; the margins stay on resize
+    GridMetrics metrics;
+    std::vector<int> tabItemCounts;
+    NavigationState start;
+};
+
+// A recorded session: the header, then each action with the navigation state it led to
+// folded into a running hash, so a replay can tell whether it took the same steps.
+// Encoded little-endian with variable-length integers; an action takes about 5 bytes.
+class InputLog {
+public:
+    static const uint32_t MAGIC = 0x52494C47; // "GLIR"
+    static const uint32_t VERSION = 1;
+    
+    InputLog();
+    
+    // Start over with a new header and no actions
+    void Begin(const InputLogHeader& header);
+    
+    // Append action, which left the navigation in state after
+    void Add(const InputAction& action, const NavigationState& after);
+    
+    const InputLogHeader& GetHeader() const { return header; }
+    const std::vector<InputAction>& GetActions() const { return actions; }
+    uint32_t GetStateHash() const { return stateHash; }
+    int64_t GetDuration() const { return actions.empty() ? 0 : actions.back().time; }
+    
+    std::vector<uint8_t> Encode() const;
+    
+    // False, leaving the log empty, unless data is a whole log of this version
+    bool Decode(const uint8_t* data, size_t size);
+    
+    static const int MAX_TABS = 4096;
+
+private:
+    InputLogHeader header;
+    std::vector<InputAction> actions;
+    uint32_t stateHash;             // GridNavigator::Hash after each action
+};
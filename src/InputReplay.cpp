@@ -0,0 +1,82 @@
+// InputReplay.cpp - Input log replay implementation
+#include "InputReplay.h"
+
+InputReplay::InputReplay(const InputLog& log)
+    : log(log)
+    , nextAction(0)
+    , clientWidth(0)
+    , clientHeight(0)
+    , launchCount(0)
+    , stateHash(GridNavigator::HASH_SEED)
+{
+    Restart();
+}
+
+void InputReplay::Restart() {
+    const InputLogHeader& header = log.GetHeader();
+    state = header.start;
+    nextAction = 0;
+    clientWidth = header.clientWidth;
+    clientHeight = header.clientHeight;
+    launchCount = 0;
+    stateHash = GridNavigator::HASH_SEED;
+}
+
+const InputAction& InputReplay::Step() {
+    const InputAction& action = log.GetActions()[nextAction++];
+    GridLayout layout = GetLayout();
+    
+    // Same dispatch as WindowManager::ApplyAction
+    switch (action.type) {
+        case InputActionType::Navigate:
+            GridNavigator::Navigate(state, layout, action.x, action.y);
+            break;
+        
+        case InputActionType::Scroll:
+            GridNavigator::ScrollBy(state, layout, action.x);
+            break;
+        
+        case InputActionType::SelectTab:
+            GridNavigator::SelectTab(state, action.x, static_cast<int>(log.GetHeader().tabItemCounts.size()),
+                                     GetItemCount(action.x));
+            break;
+        
+        case InputActionType::Select:
+            GridNavigator::Select(state, layout, action.x, action.y != 0);
+            break;
+        
+        case InputActionType::Launch:
+            launchCount++;
+            break;
+        
+        case InputActionType::Resize:
+            clientWidth = action.x;
+            clientHeight = action.y;
+            GridNavigator::ResetView(state);
+            break;
+    }
+    
+    stateHash = GridNavigator::Hash(state, stateHash);
+    return action;
+}
+
+PixelRect InputReplay::GetGridArea() const {
+    // The margins around the grid don't change with the client size
+    const InputLogHeader& header = log.GetHeader();
+    return PixelRect(header.gridArea.left,
+                     header.gridArea.top,
+                     clientWidth - (header.clientWidth - header.gridArea.right),
+                     clientHeight - (header.clientHeight - header.gridArea.bottom));
+}
+
+GridLayout InputReplay::GetLayout() const {
+    return GridLayout(GetGridArea(), GetItemCount(state.activeTabIndex), log.GetHeader().metrics);
+}
+
+int InputReplay::GetItemCount(int tabIndex) const {
+    const std::vector<int>& counts = log.GetHeader().tabItemCounts;
+    if (tabIndex < 0 || tabIndex >= static_cast<int>(counts.size())) {
+        return 0;
+    }
+    return counts[tabIndex] > 0 ? counts[tabIndex] : 0;
+}
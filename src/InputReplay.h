@@ -0,0 +1,48 @@
+// InputReplay.h - Steps a recorded input log through the grid rules (portable, no Win32)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "GridLayout.h"
+#include "GridNavigator.h"
+#include "InputLog.h"
+
+// Replays a log action by action through GridNavigator, as fast as the caller steps it.
+// The grid is laid out from the log header, so the states match the recording whatever
+// the local settings; after the last step IsFaithful tells whether they all did.
+class InputReplay {
+public:
+    explicit InputReplay(const InputLog& log);
+    
+    // Back to the state the recording started in
+    void Restart();
+    
+    bool IsFinished() const { return nextAction >= log.GetActions().size(); }
+    size_t GetPosition() const { return nextAction; }
+    
+    // Apply the next action and return it; call only while not finished
+    const InputAction& Step();
+    
+    const NavigationState& GetState() const { return state; }
+    int GetClientWidth() const { return clientWidth; }
+    int GetClientHeight() const { return clientHeight; }
+    int GetLaunchCount() const { return launchCount; }
+    
+    // Grid area at the current client size, and the active tab's layout in it
+    PixelRect GetGridArea() const;
+    GridLayout GetLayout() const;
+    
+    // Every step so far led to the recorded state
+    bool IsFaithful() const { return IsFinished() && stateHash == log.GetStateHash(); }
+
+private:
+    const InputLog& log;
+    NavigationState state;
+    size_t nextAction;
+    int clientWidth;
+    int clientHeight;
+    int launchCount;
+    uint32_t stateHash;
+    
+    int GetItemCount(int tabIndex) const;
+};
@@ -0,0 +1,153 @@
+// InputThread.cpp - Controller polling thread implementation
+#include "InputThread.h"
+#include "MessageLoop.h"
+
+InputThread::InputThread()
+    : wakeEvent(nullptr)
+    , timer(nullptr)
+    , notifyWindow(nullptr)
+    , notifyMessage(0)
+    , active(false)
+    , stopping(false)
+    , notifyPending(false)
+    , droppedEvents(0)
+    , scrollPending(false)
+{
+}
+
+InputThread::~InputThread() {
+    Stop();
+}
+
+bool InputThread::Start(HWND window, UINT message, int pollRate) {
+    if (thread.joinable()) {
+        return true;
+    }
+    
+    wakeEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    timer = MessageLoop::CreateTickTimer();
+    if (!wakeEvent || !timer) {
+        Stop();
+        return false;
+    }
+    
+    notifyWindow = window;
+    notifyMessage = message;
+    scheduler.SetRate(pollRate);
+    stopping = false;
+    thread = std::thread(&InputThread::ThreadLoop, this);
+    return true;
+}
+
+void InputThread::Stop() {
+    if (thread.joinable()) {
+        stopping = true;
+        SetEvent(wakeEvent);
+        thread.join();
+    }
+    if (timer) {
+        CloseHandle(timer);
+        timer = nullptr;
+    }
+    if (wakeEvent) {
+        CloseHandle(wakeEvent);
+        wakeEvent = nullptr;
+    }
+}
+
+void InputThread::SetActive(bool isActive) {
+    if (isActive && !active) {
+        // Presses from before the window was hidden are stale
+        InputEvent stale;
+        while (events.TryPop(stale)) {
+        }
+    }
+    active = isActive;
+    if (wakeEvent) {
+        SetEvent(wakeEvent);
+    }
+}
+
+bool InputThread::PopEvent(InputEvent& event) {
+    // Cleared before draining, so events pushed from here on post a new notification
+    notifyPending = false;
+    return events.TryPop(event);
+}
+
+void InputThread::ThreadLoop() {
+    HANDLE handles[] = {wakeEvent, timer};
+    while (!stopping) {
+        if (!active) {
+            // Sleep until shown again; edges are measured afresh then
+            scheduler.Stop();
+            CancelWaitableTimer(timer);
+            detector.Reset();
+            scrollPending = false;
+            WaitForSingleObject(wakeEvent, INFINITE);
+            continue;
+        }
+        
+        int64_t now = MessageLoop::GetMicroseconds();
+        if (!scheduler.IsRunning()) {
+            scheduler.Start(now);
+        }
+        if (scheduler.Tick(now)) {
+            Poll(now);
+        }
+        
+        // Wake for the next poll, or earlier if active or stopping changes
+        if (MessageLoop::SetTickTimer(timer, scheduler.GetTimeout(MessageLoop::GetMicroseconds()))) {
+            WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        } else {
+            WaitForSingleObject(wakeEvent, static_cast<DWORD>(scheduler.GetTimeout(now) / 1000 + 1));
+        }
+    }
+}
+
+void InputThread::Poll(int64_t now) {
+    GamepadState state;
+    controller.Poll(now, state);
+    
+    InputEvent batch[GamepadEdgeDetector::MAX_EVENTS];
+    int count = detector.Update(state, now, batch);
+    
+    // A held-back scroll goes first, unless this poll brings a newer deflection
+    bool pushed = false;
+    if (scrollPending) {
+        bool superseded = false;
+        for (int i = 0; i < count; i++) {
+            superseded = superseded || batch[i].type == InputEventType::Scroll;
+        }
+        if (superseded) {
+            scrollPending = false;
+        } else if (events.TryPush(pendingScroll)) {
+            scrollPending = false;
+            pushed = true;
+        }
+    }
+    
+    for (int i = 0; i < count; i++) {
+        pushed = Push(batch[i]) || pushed;
+    }
+    if (pushed && !notifyPending.exchange(true)) {
+        PostMessage(notifyWindow, notifyMessage, 0, 0);
+    }
+}
+
+bool InputThread::Push(const InputEvent& event) {
+    if (scrollPending && event.type == InputEventType::Scroll) {
+        // Still no room for the last one; only the newest deflection matters
+        pendingScroll = event;
+        return false;
+    }
+    if (events.TryPush(event)) {
+        return true;
+    }
+    if (event.type == InputEventType::Scroll) {
+        pendingScroll = event;
+        scrollPending = true;
+    } else {
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+    return false;
+}
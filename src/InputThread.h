@@ -0,0 +1,65 @@
+// InputThread.h - Controller polling on a dedicated thread
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <thread>
+#include "ControllerManager.h"
+#include "InputEvent.h"
+#include "SpscRing.h"
+#include "TickScheduler.h"
+
+// Polls the controller at a fixed rate on its own thread, so slow XInput calls never
+// hold up the UI. Edges go into a lock-free ring with their poll time, and the window
+// gets one notification message per batch; it drains the ring with PopEvent.
+class InputThread {
+public:
+    InputThread();
+    ~InputThread();
+    
+    // Delete copy/move
+    InputThread(const InputThread&) = delete;
+    InputThread& operator=(const InputThread&) = delete;
+    
+    // Start polling pollRate times a second while active; notifyMessage is posted to
+    // notifyWindow when events are waiting
+    bool Start(HWND notifyWindow, UINT notifyMessage, int pollRate);
+    void Stop();
+    
+    // Poll only while the window is visible. Turning polling on discards events still
+    // queued from before. UI thread only.
+    void SetActive(bool active);
+    
+    // Next queued event, oldest first. UI thread only.
+    bool PopEvent(InputEvent& event);
+    
+    // Events lost because the UI fell a whole ring behind. Scroll events are never lost:
+    // the latest one is held back until there is room, so a released stick always stops.
+    uint64_t GetDroppedEvents() const { return droppedEvents.load(std::memory_order_relaxed); }
+    
+    static const size_t QUEUE_CAPACITY = 256;
+
+private:
+    std::thread thread;
+    HANDLE wakeEvent;               // Set when active or stopping changes
+    HANDLE timer;
+    HWND notifyWindow;
+    UINT notifyMessage;
+    
+    std::atomic<bool> active;
+    std::atomic<bool> stopping;
+    std::atomic<bool> notifyPending;    // A notification is posted and not yet handled
+    std::atomic<uint64_t> droppedEvents;
+    SpscRing<InputEvent, QUEUE_CAPACITY> events;
+    
+    // Used by the input thread only
+    ControllerManager controller;
+    GamepadEdgeDetector detector;
+    TickScheduler scheduler;
+    InputEvent pendingScroll;       // Latest stick deflection that did not fit in the ring
+    bool scrollPending;
+    
+    void ThreadLoop();
+    void Poll(int64_t now);
+    bool Push(const InputEvent& event);
+};
@@ -0,0 +1,101 @@
+// LabelCache.cpp - Pre-rasterized icon label cache implementation
+#include "LabelCache.h"
+#include "PixelOps.h"
+#include <algorithm>
+#include <utility>
+
+LabelCache::LabelCache(RasterizeFunction rasterizeFunction)
+    : rasterize(std::move(rasterizeFunction))
+    , fontSize(0)
+    , dpiPercent(0)
+    , boxWidth(0)
+    , boxHeight(0)
+    , memoryUsage(0)
+{
+}
+
+void LabelCache::SetLayout(int newFontSize, int newDpiPercent, int newBoxWidth, int newBoxHeight) {
+    if (newFontSize == fontSize && newDpiPercent == dpiPercent &&
+        newBoxWidth == boxWidth && newBoxHeight == boxHeight && memoryUsage <= MAX_CACHE_BYTES) {
+        return;
+    }
+    
+    Clear();
+    fontSize = newFontSize;
+    dpiPercent = newDpiPercent;
+    boxWidth = newBoxWidth;
+    boxHeight = newBoxHeight;
+}
+
+const LabelBitmap* LabelCache::Get(const std::wstring& text) {
+    if (text.empty() || boxWidth <= 0 || boxHeight <= 0) {
+        return nullptr;
+    }
+    
+    auto found = labels.find(text);
+    if (found == labels.end()) {
+        // Remember failures too, so a bad label isn't rasterized again every frame
+        LabelBitmap label;
+        coverage.assign(static_cast<size_t>(boxWidth) * boxHeight, 0);
+        if (rasterize && rasterize(text, boxWidth, boxHeight, coverage) &&
+            coverage.size() == static_cast<size_t>(boxWidth) * boxHeight) {
+            BuildShadowedLabel(coverage.data(), boxWidth, boxHeight, label);
+        }
+        
+        memoryUsage += label.pixels.size() * sizeof(uint32_t) + text.size() * sizeof(wchar_t);
+        found = labels.emplace(text, std::move(label)).first;
+    }
+    
+    return found->second.pixels.empty() ? nullptr : &found->second;
+}
+
+void LabelCache::Clear() {
+    labels.clear();
+    memoryUsage = 0;
+}
+
+void LabelCache::BuildShadowedLabel(const uint8_t* coverage, int width, int height, LabelBitmap& label) {
+    label = LabelBitmap();
+    
+    int outWidth = width + SHADOW_FAR;
+    int outHeight = height + SHADOW_FAR;
+    auto coverageAt = [&](int x, int y) -> uint32_t {
+        return (x >= 0 && y >= 0 && x < width && y < height) ? coverage[y * width + x] : 0;
+    };
+    
+    // Compose at full size, tracking the visible bounds
+    std::vector<uint32_t> composed(static_cast<size_t>(outWidth) * outHeight);
+    int minX = outWidth, minY = outHeight, maxX = -1, maxY = -1;
+    for (int y = 0; y < outHeight; y++) {
+        for (int x = 0; x < outWidth; x++) {
+            uint32_t text = coverageAt(x, y);
+            uint32_t nearShadow = coverageAt(x - SHADOW_NEAR, y - SHADOW_NEAR);
+            uint32_t farShadow = coverageAt(x - SHADOW_FAR, y - SHADOW_FAR);
+            
+            // Black shadows under white text, all premultiplied
+            uint32_t shadow = nearShadow + PixelOps::MultiplyAlpha(farShadow, 255 - nearShadow);
+            uint32_t alpha = text + PixelOps::MultiplyAlpha(shadow, 255 - text);
+            composed[y * outWidth + x] = (alpha << 24) | (text << 16) | (text << 8) | text;
+            
+            if (alpha) {
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+            }
+        }
+    }
+    
+    if (maxX < 0) {
+        return;
+    }
+    
+    label.x = minX;
+    label.y = minY;
+    label.width = maxX - minX + 1;
+    label.height = maxY - minY + 1;
+    label.pixels.resize(static_cast<size_t>(label.width) * label.height);
+    for (int y = 0; y < label.height; y++) {
+        std::copy_n(&composed[(minY + y) * outWidth + minX], label.width, &label.pixels[y * label.width]);
+    }
+}
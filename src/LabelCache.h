@@ -0,0 +1,62 @@
+// LabelCache.h - Pre-rasterized icon labels with baked-in shadow (portable, no Win32)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Premultiplied BGRA label image trimmed to its visible pixels. (x, y) is the offset
+// of its top-left corner from the label box.
+struct LabelBitmap {
+    std::vector<uint32_t> pixels;
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// Each display name is rasterized once into white text over a black drop shadow and
+// kept until the font or label box changes, so a frame only blends finished labels
+// instead of drawing text and guessing its alpha afterwards.
+class LabelCache {
+public:
+    // Draws text centered and word-wrapped into a width x height box as 8-bit glyph
+    // coverage (0 = background, 255 = solid glyph). Supplied by the platform renderer.
+    using RasterizeFunction = std::function<bool(const std::wstring& text, int width, int height,
+                                                 std::vector<uint8_t>& coverage)>;
+    
+    explicit LabelCache(RasterizeFunction rasterizeFunction);
+    
+    // Everything a cached label depends on besides its text. Call once per frame: a
+    // change, or a cache grown past MAX_CACHE_BYTES, empties the cache.
+    void SetLayout(int fontSize, int dpiPercent, int boxWidth, int boxHeight);
+    
+    // Label for text, rasterized on first use. nullptr for empty text or if rasterizing failed.
+    // The pointer stays valid until the next SetLayout or Clear.
+    const LabelBitmap* Get(const std::wstring& text);
+    
+    void Clear();
+    size_t GetCount() const { return labels.size(); }
+    size_t GetMemoryUsage() const { return memoryUsage; }
+    
+    // White text over black copies of itself shifted SHADOW_NEAR and SHADOW_FAR pixels down
+    // and right, for a thick drop shadow. The result is trimmed to its visible pixels.
+    static void BuildShadowedLabel(const uint8_t* coverage, int width, int height, LabelBitmap& label);
+    
+    static const int SHADOW_NEAR = 1;
+    static const int SHADOW_FAR = 3;                          // Labels extend this far past their box
+    static const size_t MAX_CACHE_BYTES = 64 * 1024 * 1024;   // SetLayout starts over past this
+
+private:
+    RasterizeFunction rasterize;
+    int fontSize;
+    int dpiPercent;
+    int boxWidth;
+    int boxHeight;
+    std::unordered_map<std::wstring, LabelBitmap> labels;    // Empty bitmap = nothing to draw
+    size_t memoryUsage;
+    std::vector<uint8_t> coverage;                            // Scratch for the rasterizer
+};
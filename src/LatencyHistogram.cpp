@@ -0,0 +1,96 @@
+// LatencyHistogram.cpp - Lock-free log-linear latency histogram implementation
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+    : totalCount(0)
+    , totalValue(0)
+    , maxValue(0)
+{
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::Record(int64_t micros) {
+    int64_t value = micros < 0 ? 0 : (micros > MAX_VALUE ? MAX_VALUE : micros);
+    counts[GetBucket(value)].fetch_add(1, std::memory_order_relaxed);
+    totalCount.fetch_add(1, std::memory_order_relaxed);
+    totalValue.fetch_add(value, std::memory_order_relaxed);
+    
+    int64_t previous = maxValue.load(std::memory_order_relaxed);
+    while (value > previous && !maxValue.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::Reset() {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+    totalCount.store(0, std::memory_order_relaxed);
+    totalValue.store(0, std::memory_order_relaxed);
+    maxValue.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::GetMean() const {
+    uint64_t count = GetCount();
+    if (count == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(totalValue.load(std::memory_order_relaxed)) / count;
+}
+
+int64_t LatencyHistogram::GetPercentile(double share) const {
+    // Sum the buckets rather than trusting totalCount, which a concurrent Record
+    // may have bumped before or after its bucket
+    uint64_t bucketCounts[BUCKET_COUNT];
+    uint64_t count = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        bucketCounts[i] = counts[i].load(std::memory_order_relaxed);
+        count += bucketCounts[i];
+    }
+    if (count == 0) {
+        return 0;
+    }
+    
+    share = std::min(std::max(share, 0.0), 1.0);
+    uint64_t rank = std::max(static_cast<uint64_t>(std::ceil(share * count)), static_cast<uint64_t>(1));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += bucketCounts[i];
+        if (seen >= rank) {
+            // The largest sample is exact, so its bucket need not round up past it
+            int64_t largest = GetMax();
+            return GetBucket(largest) == i ? largest : GetBucketTop(i);
+        }
+    }
+    return GetMax();
+}
+
+int LatencyHistogram::GetBucket(int64_t value) {
+    if (value < 2 * SUB_BUCKETS) {
+        return static_cast<int>(std::max(value, static_cast<int64_t>(0)));
+    }
+    if (value > MAX_VALUE) {
+        value = MAX_VALUE;
+    }
+    
+    // Shift that brings the value into [SUB_BUCKETS, 2 * SUB_BUCKETS)
+    int shift = 0;
+    while ((value >> shift) >= 2 * SUB_BUCKETS) {
+        shift++;
+    }
+    int sub = static_cast<int>(value >> shift) - SUB_BUCKETS;
+    return 2 * SUB_BUCKETS + (shift - 1) * SUB_BUCKETS + sub;
+}
+
+int64_t LatencyHistogram::GetBucketTop(int bucket) {
+    if (bucket < 2 * SUB_BUCKETS) {
+        return bucket;
+    }
+    int offset = bucket - 2 * SUB_BUCKETS;
+    int shift = offset / SUB_BUCKETS + 1;
+    int64_t sub = offset % SUB_BUCKETS + SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
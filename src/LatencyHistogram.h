@@ -0,0 +1,46 @@
+// LatencyHistogram.h - Lock-free log-linear latency histogram (portable, no Win32)
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Counts durations in microseconds in buckets whose width grows with the value, like an
+// HDR histogram with 5 significant bits: values below 64 are exact and larger ones fall
+// in buckets at most 1/32 of their value wide, from 1 us to over 9 hours. Record is a
+// few relaxed atomic adds, so any thread can record while another reads percentiles.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+    
+    // Delete copy/move
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+    
+    // Negative values count as 0 and values past MAX_VALUE as MAX_VALUE
+    void Record(int64_t micros);
+    void Reset();
+    
+    uint64_t GetCount() const { return totalCount.load(std::memory_order_relaxed); }
+    int64_t GetMax() const { return maxValue.load(std::memory_order_relaxed); }
+    double GetMean() const;
+    
+    // Smallest bucket value that share (0..1) of the samples are at or below; the
+    // top of the bucket, so it is never below the true percentile. 0 when empty.
+    int64_t GetPercentile(double share) const;
+    
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int MAX_SHIFT = 30;
+    static const int BUCKET_COUNT = 2 * SUB_BUCKETS + MAX_SHIFT * SUB_BUCKETS;
+    static const int64_t MAX_VALUE = (static_cast<int64_t>(2 * SUB_BUCKETS) << MAX_SHIFT) - 1;
+    
+    // Bucket of a value, and the largest value in a bucket
+    static int GetBucket(int64_t value);
+    static int64_t GetBucketTop(int bucket);
+
+private:
+    std::atomic<uint64_t> counts[BUCKET_COUNT];
+    std::atomic<uint64_t> totalCount;
+    std::atomic<int64_t> totalValue;
+    std::atomic<int64_t> maxValue;
+};
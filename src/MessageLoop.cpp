@@ -0,0 +1,256 @@
+// MessageLoop.cpp - Event-driven message loop implementation
+#include "MessageLoop.h"
+
+int MessageLoop::Run(const std::function<bool()>& wantTicks, const std::function<void()>& onTick) {
+    int exitCode = 0;
+    while (RunOnce(wantTicks(), onTick, exitCode)) {
+    }
+    return exitCode;
+}
+
+bool MessageLoop::RunOnce(bool ticking, const std::function<void()>& onTick, int& exitCode) {
+    int64_t now = GetMicroseconds();
+    if (ticking && !scheduler.IsRunning()) {
+        scheduler.Start(now);
+    } else if (!ticking && scheduler.IsRunning()) {
+        scheduler.Stop();
+        CancelTimer();
+    }
+    
+    // A tick already due skips the wait, but messages still go first
+    int64_t wait = scheduler.GetTimeout(now);
+    if (wait > 0) {
+        ArmTimer(now);
+    }
+    Wait(wait);
+    now = GetMicroseconds();
+    scheduler.CountWakeup(now);
+    
+    if (!Dispatch(exitCode)) {
+        return false;
+    }
+    
+    if (scheduler.Tick(now)) {
+        onTick();
+    }
+    return true;
+}
+
+void MessageLoop::ArmTimer(int64_t now) {
+    int64_t deadline = scheduler.GetDeadline();
+    if (armedDeadline == deadline) {
+        return;
+    }
+    if (SetTimer(deadline - now)) {
+        armedDeadline = deadline;
+    }
+}
+
+#ifdef _WIN32
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+MessageLoop::MessageLoop()
+    : timer(CreateTickTimer())
+    , armedDeadline(-1)
+{
+}
+
+MessageLoop::~MessageLoop() {
+    if (timer) {
+        CloseHandle(timer);
+    }
+}
+
+void MessageLoop::Wait(int64_t wait) {
+    DWORD timeout = INFINITE;
+    if (wait == 0) {
+        timeout = 0;
+    } else if (wait > 0 && armedDeadline < 0) {
+        timeout = static_cast<DWORD>((wait + 999) / 1000);
+    }
+    
+    DWORD handleCount = armedDeadline >= 0 ? 1 : 0;
+    DWORD result = MsgWaitForMultipleObjectsEx(handleCount, &timer, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+    if (handleCount && result == WAIT_OBJECT_0) {
+        armedDeadline = -1;     // Fired and reset; a tick not quite due yet arms it again
+    }
+}
+
+bool MessageLoop::Dispatch(int& exitCode) {
+    MSG msg;
+    while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+        if (msg.message == WM_QUIT) {
+            exitCode = static_cast<int>(msg.wParam);
+            return false;
+        }
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+    }
+    return true;
+}
+
+HANDLE MessageLoop::CreateTickTimer() {
+    // High resolution timers (Windows 10 1803+) fire on time without raising the
+    // system timer resolution; older systems get a plain one
+    HANDLE tickTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!tickTimer) {
+        tickTimer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+    }
+    return tickTimer;
+}
+
+bool MessageLoop::SetTickTimer(HANDLE tickTimer, int64_t microseconds) {
+    // Relative due time, in negative 100 ns units
+    LARGE_INTEGER dueTime;
+    dueTime.QuadPart = -max(static_cast<int64_t>(1), microseconds * 10);
+    return SetWaitableTimer(tickTimer, &dueTime, 0, nullptr, nullptr, FALSE) != FALSE;
+}
+
+int64_t MessageLoop::GetMicroseconds() {
+    static LARGE_INTEGER frequency = []() {
+        LARGE_INTEGER value;
+        QueryPerformanceFrequency(&value);
+        return value;
+    }();
+    
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    int64_t seconds = counter.QuadPart / frequency.QuadPart;
+    int64_t remainder = counter.QuadPart % frequency.QuadPart;
+    return seconds * TickScheduler::MICROSECONDS_PER_SECOND + remainder * TickScheduler::MICROSECONDS_PER_SECOND / frequency.QuadPart;
+}
+
+bool MessageLoop::SetTimer(int64_t microseconds) {
+    return timer && SetTickTimer(timer, microseconds);
+}
+
+void MessageLoop::CancelTimer() {
+    if (timer) {
+        CancelWaitableTimer(timer);
+    }
+    armedDeadline = -1;
+}
+
+#else
+
+#include <ctime>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+MessageLoop::MessageLoop()
+    : timer(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC))
+    , wakeEvent(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    , quitRequested(false)
+    , quitCode(0)
+    , armedDeadline(-1)
+{
+}
+
+MessageLoop::~MessageLoop() {
+    if (timer >= 0) {
+        close(timer);
+    }
+    if (wakeEvent >= 0) {
+        close(wakeEvent);
+    }
+}
+
+void MessageLoop::Post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(postedLock);
+        posted.push_back(std::move(task));
+    }
+    uint64_t one = 1;
+    ssize_t written = write(wakeEvent, &one, sizeof(one));
+    (void)written;              // Only fails when the counter is already signalled
+}
+
+void MessageLoop::Quit(int exitCode) {
+    {
+        std::lock_guard<std::mutex> lock(postedLock);
+        quitRequested = true;
+        quitCode = exitCode;
+    }
+    uint64_t one = 1;
+    ssize_t written = write(wakeEvent, &one, sizeof(one));
+    (void)written;
+}
+
+void MessageLoop::Wait(int64_t wait) {
+    int timeout = -1;
+    if (wait == 0) {
+        timeout = 0;
+    } else if (wait > 0 && armedDeadline < 0) {
+        timeout = static_cast<int>((wait + 999) / 1000);
+    }
+    
+    pollfd handles[2] = {{wakeEvent, POLLIN, 0}, {timer, POLLIN, 0}};
+    nfds_t handleCount = armedDeadline >= 0 ? 2 : 1;
+    int result = poll(handles, handleCount, timeout);
+    if (result > 0 && handleCount == 2 && (handles[1].revents & POLLIN)) {
+        uint64_t expirations = 0;
+        ssize_t readBytes = read(timer, &expirations, sizeof(expirations));
+        (void)readBytes;
+        armedDeadline = -1;     // Fired and reset; a tick not quite due yet arms it again
+    }
+}
+
+bool MessageLoop::Dispatch(int& exitCode) {
+    // Reset the event before taking the tasks, so a Post racing with this wakes the
+    // next wait instead of being lost
+    uint64_t count = 0;
+    ssize_t readBytes = read(wakeEvent, &count, sizeof(count));
+    (void)readBytes;
+    
+    std::vector<std::function<void()>> tasks;
+    bool quit;
+    int code;
+    {
+        std::lock_guard<std::mutex> lock(postedLock);
+        tasks.swap(posted);
+        quit = quitRequested;
+        code = quitCode;
+    }
+    for (const std::function<void()>& task : tasks) {
+        task();
+    }
+    if (quit) {
+        exitCode = code;
+        return false;
+    }
+    return true;
+}
+
+int64_t MessageLoop::GetMicroseconds() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int64_t>(now.tv_sec) * TickScheduler::MICROSECONDS_PER_SECOND + now.tv_nsec / 1000;
+}
+
+bool MessageLoop::SetTimer(int64_t microseconds) {
+    if (timer < 0) {
+        return false;
+    }
+    
+    // One shot, relative; a zero it_value would disarm it instead
+    microseconds = microseconds > 1 ? microseconds : 1;
+    itimerspec dueTime = {};
+    dueTime.it_value.tv_sec = static_cast<time_t>(microseconds / TickScheduler::MICROSECONDS_PER_SECOND);
+    dueTime.it_value.tv_nsec = static_cast<long>(microseconds % TickScheduler::MICROSECONDS_PER_SECOND) * 1000;
+    return timerfd_settime(timer, 0, &dueTime, nullptr) == 0;
+}
+
+void MessageLoop::CancelTimer() {
+    if (timer >= 0) {
+        itimerspec disarm = {};
+        timerfd_settime(timer, 0, &disarm, nullptr);
+    }
+    armedDeadline = -1;
+}
+
+#endif
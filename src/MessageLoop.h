@@ -0,0 +1,83 @@
+// MessageLoop.h - Event-driven message loop with fixed-rate ticks
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <mutex>
+#include <vector>
+#endif
+#include <cstdint>
+#include <functional>
+#include "TickScheduler.h"
+
+// Sleeps in MsgWaitForMultipleObjectsEx until a message arrives or a high-resolution
+// waitable timer fires for the next tick. With ticks off nothing wakes the thread but
+// messages, so a launcher hidden in the tray costs no wakeups at all.
+// Without Win32 the loop sleeps in poll on a timerfd for the ticks and an eventfd that
+// Post and Quit signal, which stand in for the message queue.
+class MessageLoop {
+public:
+    MessageLoop();
+    ~MessageLoop();
+    
+    // Delete copy/move
+    MessageLoop(const MessageLoop&) = delete;
+    MessageLoop& operator=(const MessageLoop&) = delete;
+    
+    // Takes effect the next time ticks are turned on
+    void SetTickRate(int ticksPerSecond) { scheduler.SetRate(ticksPerSecond); }
+    
+    // Dispatch messages until WM_QUIT and return its exit code. wantTicks is asked after
+    // every wakeup; while it says yes, onTick runs at the tick rate.
+    int Run(const std::function<bool()>& wantTicks, const std::function<void()>& onTick);
+    int Run() { return Run([]() { return false; }, []() {}); }
+    
+    // Wait for one wakeup, dispatch the queued messages and run onTick if a tick is due.
+    // False once WM_QUIT was seen, with its exit code in exitCode.
+    bool RunOnce(bool ticking, const std::function<void()>& onTick, int& exitCode);
+    
+    const TickScheduler& GetScheduler() const { return scheduler; }
+    
+    // Monotonic clock the ticks are scheduled on
+    static int64_t GetMicroseconds();
+
+#ifdef _WIN32
+    // Waitable timer as precise as the system allows, and setting it to fire once
+    // after a number of microseconds. The caller closes the timer.
+    static HANDLE CreateTickTimer();
+    static bool SetTickTimer(HANDLE tickTimer, int64_t microseconds);
+#else
+    // Run task on the loop's thread at its next wakeup, in the order posted, like
+    // PostMessage. Both may be called from any thread.
+    void Post(std::function<void()> task);
+    
+    // End the loop after the tasks posted before, like PostQuitMessage
+    void Quit(int exitCode);
+#endif
+
+private:
+#ifdef _WIN32
+    HANDLE timer;                   // Waitable timer; without one the wait times out instead
+#else
+    int timer;                      // timerfd, -1 if none; without one the wait times out instead
+    int wakeEvent;                  // eventfd signalled by Post and Quit
+    std::mutex postedLock;          // Guards posted, quitRequested and quitCode
+    std::vector<std::function<void()>> posted;
+    bool quitRequested;
+    int quitCode;
+#endif
+    int64_t armedDeadline;          // Deadline the timer is set for, -1 when not set
+    TickScheduler scheduler;
+    
+    // Sleep until a message arrives, the armed timer fires or wait microseconds pass
+    // (-1 waits without a limit, 0 doesn't sleep)
+    void Wait(int64_t wait);
+    
+    // Handle what arrived; false once the loop should end, with its exit code
+    bool Dispatch(int& exitCode);
+    
+    bool SetTimer(int64_t microseconds);
+    void ArmTimer(int64_t now);
+    void CancelTimer();
+};
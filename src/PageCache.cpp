@@ -0,0 +1,91 @@
+// PageCache.cpp - Rendered grid page cache implementation
+#include "PageCache.h"
+
+PageCache::PageCache(size_t maxBytes)
+    : maxBytes(maxBytes)
+    , memoryUsage(0)
+{
+}
+
+void PageCache::SetMaxBytes(size_t newMaxBytes) {
+    maxBytes = newMaxBytes;
+    Evict(maxBytes);
+}
+
+void PageCache::Store(int tabIndex, int dpiPercent, int selectedIndex, const RasterImage& frame, const PixelRect& area) {
+    Remove(tabIndex);
+    
+    size_t pageBytes = GetPageBytes(area);
+    if (area.IsEmpty() || pageBytes > maxBytes || !PixelRect(0, 0, frame.width, frame.height).Contains(area)) {
+        return;
+    }
+    Evict(maxBytes - pageBytes);
+    
+    Page page;
+    page.tabIndex = tabIndex;
+    page.dpiPercent = dpiPercent;
+    page.selectedIndex = selectedIndex;
+    page.area = area;
+    page.pixels.resize(pageBytes / sizeof(uint32_t));
+    
+    RasterSurface pageSurface;
+    pageSurface.pixels = page.pixels.data();
+    pageSurface.width = area.Width();
+    pageSurface.height = area.Height();
+    pageSurface.stride = area.Width();
+    Raster::Copy(pageSurface, -area.left, -area.top, frame, pageSurface.Bounds());
+    
+    pages.push_front(std::move(page));
+    memoryUsage += pageBytes;
+}
+
+bool PageCache::Restore(int tabIndex, int dpiPercent, const RasterSurface& frame, const PixelRect& area, int& selectedIndex) {
+    for (auto it = pages.begin(); it != pages.end(); ++it) {
+        if (it->tabIndex != tabIndex) {
+            continue;
+        }
+        
+        // A page laid out for another size or DPI is of no use again until it is replaced
+        const PixelRect& pageArea = it->area;
+        bool sameArea = pageArea.left == area.left && pageArea.top == area.top &&
+                        pageArea.right == area.right && pageArea.bottom == area.bottom;
+        if (it->dpiPercent != dpiPercent || !sameArea || !frame.Bounds().Contains(area)) {
+            memoryUsage -= GetPageBytes(it->area);
+            pages.erase(it);
+            return false;
+        }
+        
+        pages.splice(pages.begin(), pages, it);
+        RasterImage page{it->pixels.data(), area.Width(), area.Height(), area.Width()};
+        Raster::Copy(frame, area.left, area.top, page, area);
+        selectedIndex = it->selectedIndex;
+        return true;
+    }
+    return false;
+}
+
+void PageCache::Remove(int tabIndex) {
+    for (auto it = pages.begin(); it != pages.end(); ++it) {
+        if (it->tabIndex == tabIndex) {
+            memoryUsage -= GetPageBytes(it->area);
+            pages.erase(it);
+            return;
+        }
+    }
+}
+
+void PageCache::Clear() {
+    pages.clear();
+    memoryUsage = 0;
+}
+
+size_t PageCache::GetPageBytes(const PixelRect& area) {
+    return area.IsEmpty() ? 0 : static_cast<size_t>(area.Width()) * area.Height() * sizeof(uint32_t);
+}
+
+void PageCache::Evict(size_t keepBytes) {
+    while (!pages.empty() && memoryUsage > keepBytes) {
+        memoryUsage -= GetPageBytes(pages.back().area);
+        pages.pop_back();
+    }
+}
@@ -0,0 +1,50 @@
+// PageCache.h - Rendered grid pages kept per tab for instant tab switching (portable, no Win32)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <vector>
+#include "DamageRegion.h"
+#include "Raster.h"
+
+// Copy of the grid area of a finished frame showing the top of a tab. Switching back to
+// the tab puts the page back with one copy, and only the tab bar and the selection have
+// to be drawn before the frame is complete again.
+class PageCache {
+public:
+    explicit PageCache(size_t maxBytes = 0);
+    
+    // Least recently used pages are dropped until the rest fit
+    void SetMaxBytes(size_t maxBytes);
+    size_t GetMaxBytes() const { return maxBytes; }
+    
+    // Keep area of frame as the top page of tabIndex, drawn with selectedIndex selected.
+    // Replaces an older page of the tab. A page larger than the budget is not kept.
+    void Store(int tabIndex, int dpiPercent, int selectedIndex, const RasterImage& frame, const PixelRect& area);
+    
+    // Copy the page of tabIndex back into frame if it was kept for the same area and DPI.
+    // selectedIndex receives the icon that is drawn selected in it.
+    bool Restore(int tabIndex, int dpiPercent, const RasterSurface& frame, const PixelRect& area, int& selectedIndex);
+    
+    void Remove(int tabIndex);
+    void Clear();
+    size_t GetCount() const { return pages.size(); }
+    size_t GetMemoryUsage() const { return memoryUsage; }
+
+private:
+    struct Page {
+        int tabIndex;
+        int dpiPercent;
+        int selectedIndex;
+        PixelRect area;
+        std::vector<uint32_t> pixels;
+    };
+    
+    std::list<Page> pages;          // Most recently used first
+    size_t maxBytes;
+    size_t memoryUsage;
+    
+    static size_t GetPageBytes(const PixelRect& area);
+    void Evict(size_t keepBytes);
+};
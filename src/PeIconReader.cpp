@@ -0,0 +1,257 @@
+// PeIconReader.cpp - PE resource section icon reader implementation
+#include "PeIconReader.h"
+#include <utility>
+
+namespace {
+    uint16_t ReadU16(const uint8_t* p) {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+    
+    uint32_t ReadU32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+    
+    const uint16_t OPTIONAL_MAGIC_PE32 = 0x10B;
+    const uint16_t OPTIONAL_MAGIC_PE32_PLUS = 0x20B;
+    const uint32_t RESOURCE_DIRECTORY_INDEX = 2;   // IMAGE_DIRECTORY_ENTRY_RESOURCE
+    const uint32_t HIGH_BIT = 0x80000000;
+}
+
+PeIconReader::PeIconReader(ReadFunction readFunction)
+    : read(std::move(readFunction))
+    , resourceRva(0)
+    , resourceSize(0)
+{
+}
+
+bool PeIconReader::IsExecutable(const uint8_t* data, size_t size) {
+    return data && size >= 2 && data[0] == 'M' && data[1] == 'Z';
+}
+
+bool PeIconReader::ReadIcon(int iconIndex, int targetSize, DecodedImage& image) {
+    if (!read || !LoadHeaders()) {
+        return false;
+    }
+    
+    // Choose the icon group
+    std::vector<DirectoryEntry> groups;
+    if (!FindTypeDirectory(RESOURCE_TYPE_GROUP_ICON, groups)) {
+        return false;
+    }
+    
+    const DirectoryEntry* group = nullptr;
+    if (iconIndex >= 0) {
+        // Directory order (named entries first, then ascending IDs) is the order
+        // EnumResourceNames and ExtractIconEx use
+        if (static_cast<size_t>(iconIndex) < groups.size()) {
+            group = &groups[iconIndex];
+        }
+    } else {
+        uint32_t id = static_cast<uint32_t>(-static_cast<int64_t>(iconIndex));
+        for (const DirectoryEntry& entry : groups) {
+            if (!entry.named && entry.id == id) {
+                group = &entry;
+                break;
+            }
+        }
+    }
+    
+    std::vector<uint8_t> groupData;
+    if (!group || !ReadResourceData(*group, groupData)) {
+        return false;
+    }
+    
+    // GRPICONDIR: reserved, type (1), count, then 14-byte GRPICONDIRENTRY records
+    if (groupData.size() < 6 || ReadU16(groupData.data() + 2) != 1) {
+        return false;
+    }
+    size_t count = ReadU16(groupData.data() + 4);
+    if (count == 0 || 6 + count * 14 > groupData.size()) {
+        return false;
+    }
+    
+    std::vector<IconEntryInfo> entries(count);
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* entry = groupData.data() + 6 + i * 14;
+        entries[i].width = entry[0] ? entry[0] : 256;
+        entries[i].height = entry[1] ? entry[1] : 256;
+        entries[i].bitCount = ReadU16(entry + 6);
+    }
+    
+    int best = IconDecoder::SelectBestEntry(entries, targetSize);
+    if (best < 0) {
+        return false;
+    }
+    uint32_t iconId = ReadU16(groupData.data() + 6 + best * 14 + 12);
+    
+    // Find the RT_ICON resource the group entry refers to and decode only that image
+    std::vector<DirectoryEntry> icons;
+    if (!FindTypeDirectory(RESOURCE_TYPE_ICON, icons)) {
+        return false;
+    }
+    
+    for (const DirectoryEntry& entry : icons) {
+        if (!entry.named && entry.id == iconId) {
+            std::vector<uint8_t> iconData;
+            return ReadResourceData(entry, iconData) &&
+                   IconDecoder::DecodeIconImage(iconData.data(), iconData.size(), image);
+        }
+    }
+    
+    return false;
+}
+
+bool PeIconReader::LoadHeaders() {
+    if (!sections.empty()) {
+        return resourceSize != 0;
+    }
+    
+    // DOS header: "MZ" and the offset of the PE header at 0x3C
+    uint8_t dosHeader[64];
+    if (!read(0, dosHeader, sizeof(dosHeader)) || !IsExecutable(dosHeader, sizeof(dosHeader))) {
+        return false;
+    }
+    uint32_t peOffset = ReadU32(dosHeader + 0x3C);
+    
+    // "PE\0\0" followed by the 20-byte COFF file header
+    uint8_t fileHeader[24];
+    if (!read(peOffset, fileHeader, sizeof(fileHeader)) ||
+        fileHeader[0] != 'P' || fileHeader[1] != 'E' || fileHeader[2] != 0 || fileHeader[3] != 0) {
+        return false;
+    }
+    uint32_t sectionCount = ReadU16(fileHeader + 6);
+    uint32_t optionalHeaderSize = ReadU16(fileHeader + 20);
+    if (sectionCount == 0 || sectionCount > MAX_SECTIONS || optionalHeaderSize < 2) {
+        return false;
+    }
+    
+    // Optional header: the data directories start at 96 (PE32) or 112 (PE32+)
+    std::vector<uint8_t> optionalHeader(optionalHeaderSize);
+    uint64_t optionalOffset = static_cast<uint64_t>(peOffset) + sizeof(fileHeader);
+    if (!read(optionalOffset, optionalHeader.data(), optionalHeader.size())) {
+        return false;
+    }
+    
+    uint16_t magic = ReadU16(optionalHeader.data());
+    size_t directoryCountOffset;
+    if (magic == OPTIONAL_MAGIC_PE32) {
+        directoryCountOffset = 92;
+    } else if (magic == OPTIONAL_MAGIC_PE32_PLUS) {
+        directoryCountOffset = 108;
+    } else {
+        return false;
+    }
+    
+    size_t resourceOffset = directoryCountOffset + 4 + RESOURCE_DIRECTORY_INDEX * 8;
+    if (resourceOffset + 8 > optionalHeader.size() ||
+        ReadU32(optionalHeader.data() + directoryCountOffset) <= RESOURCE_DIRECTORY_INDEX) {
+        return false;
+    }
+    resourceRva = ReadU32(optionalHeader.data() + resourceOffset);
+    resourceSize = ReadU32(optionalHeader.data() + resourceOffset + 4);
+    
+    // Section table, used to map RVAs to file offsets
+    std::vector<uint8_t> sectionTable(sectionCount * 40);
+    if (!read(optionalOffset + optionalHeaderSize, sectionTable.data(), sectionTable.size())) {
+        return false;
+    }
+    
+    sections.resize(sectionCount);
+    for (uint32_t i = 0; i < sectionCount; i++) {
+        const uint8_t* header = sectionTable.data() + i * 40;
+        sections[i].virtualSize = ReadU32(header + 8);
+        sections[i].virtualAddress = ReadU32(header + 12);
+        sections[i].rawSize = ReadU32(header + 16);
+        sections[i].rawOffset = ReadU32(header + 20);
+    }
+    
+    return resourceRva != 0 && resourceSize != 0;
+}
+
+bool PeIconReader::ReadRva(uint32_t rva, void* buffer, size_t size) {
+    for (const Section& section : sections) {
+        uint32_t extent = section.virtualSize > section.rawSize ? section.virtualSize : section.rawSize;
+        if (rva < section.virtualAddress || rva - section.virtualAddress >= extent) {
+            continue;
+        }
+        
+        // The bytes must lie in the section's file data, not its zero-filled tail
+        uint64_t delta = rva - section.virtualAddress;
+        if (delta + size > section.rawSize) {
+            return false;
+        }
+        return read(section.rawOffset + delta, buffer, size);
+    }
+    return false;
+}
+
+bool PeIconReader::ReadDirectory(uint32_t offset, std::vector<DirectoryEntry>& entries) {
+    // IMAGE_RESOURCE_DIRECTORY: 16-byte header, then named entries followed by ID entries
+    uint8_t header[16];
+    if (offset > resourceSize || !ReadRva(resourceRva + offset, header, sizeof(header))) {
+        return false;
+    }
+    
+    uint32_t count = static_cast<uint32_t>(ReadU16(header + 12)) + ReadU16(header + 14);
+    if (count > MAX_DIRECTORY_ENTRIES) {
+        return false;
+    }
+    
+    std::vector<uint8_t> raw(count * 8);
+    if (count && !ReadRva(resourceRva + offset + sizeof(header), raw.data(), raw.size())) {
+        return false;
+    }
+    
+    entries.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t name = ReadU32(raw.data() + i * 8);
+        uint32_t target = ReadU32(raw.data() + i * 8 + 4);
+        entries[i].named = (name & HIGH_BIT) != 0;
+        entries[i].id = name & ~HIGH_BIT;
+        entries[i].isDirectory = (target & HIGH_BIT) != 0;
+        entries[i].offset = target & ~HIGH_BIT;
+    }
+    return true;
+}
+
+bool PeIconReader::FindTypeDirectory(uint32_t type, std::vector<DirectoryEntry>& entries) {
+    std::vector<DirectoryEntry> types;
+    if (!ReadDirectory(0, types)) {
+        return false;
+    }
+    
+    for (const DirectoryEntry& entry : types) {
+        if (!entry.named && entry.id == type && entry.isDirectory) {
+            return ReadDirectory(entry.offset, entries);
+        }
+    }
+    return false;
+}
+
+bool PeIconReader::ReadResourceData(const DirectoryEntry& entry, std::vector<uint8_t>& data) {
+    // Below the name level is a language directory; take its first language
+    DirectoryEntry current = entry;
+    for (int depth = 0; current.isDirectory; depth++) {
+        std::vector<DirectoryEntry> children;
+        if (depth >= 2 || !ReadDirectory(current.offset, children) || children.empty()) {
+            return false;
+        }
+        current = children[0];
+    }
+    
+    // IMAGE_RESOURCE_DATA_ENTRY: data RVA and size (the RVA is image-relative)
+    uint8_t dataEntry[16];
+    if (current.offset > resourceSize || !ReadRva(resourceRva + current.offset, dataEntry, sizeof(dataEntry))) {
+        return false;
+    }
+    
+    uint32_t dataRva = ReadU32(dataEntry);
+    uint32_t dataSize = ReadU32(dataEntry + 4);
+    if (dataSize == 0 || dataSize > MAX_RESOURCE_SIZE) {
+        return false;
+    }
+    
+    data.resize(dataSize);
+    return ReadRva(dataRva, data.data(), data.size());
+}
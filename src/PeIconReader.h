@@ -0,0 +1,62 @@
+// PeIconReader.h - Icon extraction from PE resource sections (portable, no Win32)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "IconDecoder.h"
+
+// Reads icons from an executable or DLL without loading it. Only the PE headers, the
+// section table and the parts of the .rsrc directory tree on the way to the chosen
+// icon are read - never the code or data sections, however large the file is.
+class PeIconReader {
+public:
+    // Positional read of exactly size bytes at a file offset. Returns false on a short read.
+    using ReadFunction = std::function<bool(uint64_t offset, void* buffer, size_t size)>;
+    
+    explicit PeIconReader(ReadFunction readFunction);
+    
+    // Decode the image of an icon group that best fits targetSize. As with ExtractIconEx,
+    // iconIndex >= 0 selects the nth RT_GROUP_ICON in resource order and a negative
+    // iconIndex selects the group whose resource ID is -iconIndex.
+    bool ReadIcon(int iconIndex, int targetSize, DecodedImage& image);
+    
+    // True if data starts with the "MZ" signature of a DOS/PE executable
+    static bool IsExecutable(const uint8_t* data, size_t size);
+    
+    // Resource types (winuser.h)
+    static const uint32_t RESOURCE_TYPE_ICON = 3;
+    static const uint32_t RESOURCE_TYPE_GROUP_ICON = 14;
+
+private:
+    struct Section {
+        uint32_t virtualAddress;
+        uint32_t virtualSize;
+        uint32_t rawOffset;
+        uint32_t rawSize;
+    };
+    
+    // IMAGE_RESOURCE_DIRECTORY_ENTRY with its flag bits split out
+    struct DirectoryEntry {
+        uint32_t id;               // Integer ID, or the name string offset when named
+        uint32_t offset;           // Subdirectory or data entry, relative to the resource section
+        bool named;
+        bool isDirectory;
+    };
+    
+    ReadFunction read;
+    std::vector<Section> sections;
+    uint32_t resourceRva;
+    uint32_t resourceSize;
+    
+    bool LoadHeaders();
+    bool ReadRva(uint32_t rva, void* buffer, size_t size);
+    bool ReadDirectory(uint32_t offset, std::vector<DirectoryEntry>& entries);
+    bool FindTypeDirectory(uint32_t type, std::vector<DirectoryEntry>& entries);
+    bool ReadResourceData(const DirectoryEntry& entry, std::vector<uint8_t>& data);
+    
+    static const uint32_t MAX_SECTIONS = 96;               // PE loader limit
+    static const uint32_t MAX_DIRECTORY_ENTRIES = 4096;
+    static const uint32_t MAX_RESOURCE_SIZE = 16 * 1024 * 1024;
+};
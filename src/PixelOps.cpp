@@ -0,0 +1,645 @@
+// PixelOps.cpp - Premultiplied-alpha pixel kernel implementation
+#include "PixelOps.h"
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PIXELOPS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define PIXELOPS_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC and Clang only emit AVX2 instructions in functions marked for it; MSVC always can
+#if defined(__GNUC__) || defined(__clang__)
+#define PIXELOPS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PIXELOPS_TARGET(isa)
+#endif
+
+namespace {
+    // ---- Scalar reference ----
+    
+    void PremultiplyScalar(const uint32_t* src, uint32_t* dst, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t pixel = src[i];
+            uint32_t a = pixel >> 24;
+            uint32_t r = PixelOps::MultiplyAlpha((pixel >> 16) & 0xFF, a);
+            uint32_t g = PixelOps::MultiplyAlpha((pixel >> 8) & 0xFF, a);
+            uint32_t b = PixelOps::MultiplyAlpha(pixel & 0xFF, a);
+            dst[i] = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+    
+    uint32_t UnpremultiplyChannel(uint32_t c, uint32_t a) {
+        uint32_t value = (c * 255 + a / 2) / a;
+        return value > 255 ? 255 : value;
+    }
+    
+    void UnpremultiplyScalar(const uint32_t* src, uint32_t* dst, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t pixel = src[i];
+            uint32_t a = pixel >> 24;
+            if (a == 0) {
+                dst[i] = 0;
+                continue;
+            }
+            uint32_t r = UnpremultiplyChannel((pixel >> 16) & 0xFF, a);
+            uint32_t g = UnpremultiplyChannel((pixel >> 8) & 0xFF, a);
+            uint32_t b = UnpremultiplyChannel(pixel & 0xFF, a);
+            dst[i] = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+
+    void FillScalar(uint32_t* dst, uint32_t color, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            dst[i] = color;
+        }
+    }
+    
+    uint32_t BlendPixel(uint32_t src, uint32_t dst) {
+        uint32_t inverse = 255 - (src >> 24);
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t c = ((src >> shift) & 0xFF) + PixelOps::MultiplyAlpha((dst >> shift) & 0xFF, inverse);
+            result |= (c > 255 ? 255 : c) << shift;
+        }
+        return result;
+    }
+    
+    uint32_t ScalePixel(uint32_t pixel, uint32_t opacity) {
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            result |= PixelOps::MultiplyAlpha((pixel >> shift) & 0xFF, opacity) << shift;
+        }
+        return result;
+    }
+    
+    void BlendOverScalar(const uint32_t* src, uint32_t* dst, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            dst[i] = BlendPixel(src[i], dst[i]);
+        }
+    }
+    
+    void BlendOverOpacityScalar(const uint32_t* src, uint32_t* dst, size_t count, uint32_t opacity) {
+        for (size_t i = 0; i < count; i++) {
+            dst[i] = BlendPixel(ScalePixel(src[i], opacity), dst[i]);
+        }
+    }
+
+#ifdef PIXELOPS_X86
+    // ---- SSE2 / AVX2 ----
+    //
+    // Premultiply widens to 16 bits and uses t = c * a + 128, (t + (t >> 8)) >> 8, the
+    // same identity as MultiplyAlpha. Unpremultiply divides in float: the numerator and
+    // alpha are small integers, so a correctly rounded quotient truncates to the exact
+    // integer result.
+    
+    PIXELOPS_TARGET("sse2")
+    __m128i PremultiplyWords(__m128i words) {
+        // Broadcast each pixel's alpha word across its four channels
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(words, 0xFF), 0xFF);
+        __m128i t = _mm_add_epi16(_mm_mullo_epi16(words, alpha), _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+    
+    PIXELOPS_TARGET("sse2")
+    void PremultiplySSE2(const uint32_t* src, uint32_t* dst, size_t count) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i low = PremultiplyWords(_mm_unpacklo_epi8(pixels, zero));
+            __m128i high = PremultiplyWords(_mm_unpackhi_epi8(pixels, zero));
+            __m128i result = _mm_packus_epi16(low, high);
+            // Alpha was multiplied by itself above - put the original back
+            result = _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, pixels));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+        }
+        PremultiplyScalar(src + i, dst + i, count - i);
+    }
+    
+    template <int SHIFT>
+    PIXELOPS_TARGET("sse2")
+    __m128i UnpremultiplyChannelSSE2(__m128i pixels, __m128 alpha, __m128 halfAlpha) {
+        __m128i channel = _mm_and_si128(_mm_srli_epi32(pixels, SHIFT), _mm_set1_epi32(0xFF));
+        __m128 numerator = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(channel), _mm_set1_ps(255.0f)), halfAlpha);
+        __m128 quotient = _mm_min_ps(_mm_div_ps(numerator, alpha), _mm_set1_ps(255.0f));
+        return _mm_slli_epi32(_mm_cvttps_epi32(quotient), SHIFT);
+    }
+    
+    PIXELOPS_TARGET("sse2")
+    void UnpremultiplySSE2(const uint32_t* src, uint32_t* dst, size_t count) {
+        const __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i alphaBits = _mm_srli_epi32(pixels, 24);
+            __m128 alpha = _mm_cvtepi32_ps(alphaBits);
+            __m128 halfAlpha = _mm_cvtepi32_ps(_mm_srli_epi32(alphaBits, 1));
+            
+            __m128i result = _mm_slli_epi32(alphaBits, 24);
+            result = _mm_or_si128(result, UnpremultiplyChannelSSE2<16>(pixels, alpha, halfAlpha));
+            result = _mm_or_si128(result, UnpremultiplyChannelSSE2<8>(pixels, alpha, halfAlpha));
+            result = _mm_or_si128(result, UnpremultiplyChannelSSE2<0>(pixels, alpha, halfAlpha));
+            
+            // Zero alpha divided by zero above; those pixels become 0
+            result = _mm_andnot_si128(_mm_cmpeq_epi32(alphaBits, zero), result);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+        }
+        UnpremultiplyScalar(src + i, dst + i, count - i);
+    }
+    
+    PIXELOPS_TARGET("avx2")
+    __m256i PremultiplyWordsAVX2(__m256i words) {
+        __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(words, 0xFF), 0xFF);
+        __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(words, alpha), _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+    
+    PIXELOPS_TARGET("avx2")
+    void PremultiplyAVX2(const uint32_t* src, uint32_t* dst, size_t count) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            // Unpack and pack both work within 128-bit lanes, so pixel order is kept
+            __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i low = PremultiplyWordsAVX2(_mm256_unpacklo_epi8(pixels, zero));
+            __m256i high = PremultiplyWordsAVX2(_mm256_unpackhi_epi8(pixels, zero));
+            __m256i result = _mm256_packus_epi16(low, high);
+            result = _mm256_or_si256(_mm256_andnot_si256(alphaMask, result), _mm256_and_si256(alphaMask, pixels));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), result);
+        }
+        PremultiplySSE2(src + i, dst + i, count - i);
+    }
+    
+    template <int SHIFT>
+    PIXELOPS_TARGET("avx2")
+    __m256i UnpremultiplyChannelAVX2(__m256i pixels, __m256 alpha, __m256 halfAlpha) {
+        __m256i channel = _mm256_and_si256(_mm256_srli_epi32(pixels, SHIFT), _mm256_set1_epi32(0xFF));
+        __m256 numerator = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(channel), _mm256_set1_ps(255.0f)), halfAlpha);
+        __m256 quotient = _mm256_min_ps(_mm256_div_ps(numerator, alpha), _mm256_set1_ps(255.0f));
+        return _mm256_slli_epi32(_mm256_cvttps_epi32(quotient), SHIFT);
+    }
+    
+    PIXELOPS_TARGET("avx2")
+    void UnpremultiplyAVX2(const uint32_t* src, uint32_t* dst, size_t count) {
+        const __m256i zero = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i alphaBits = _mm256_srli_epi32(pixels, 24);
+            __m256 alpha = _mm256_cvtepi32_ps(alphaBits);
+            __m256 halfAlpha = _mm256_cvtepi32_ps(_mm256_srli_epi32(alphaBits, 1));
+            
+            __m256i result = _mm256_slli_epi32(alphaBits, 24);
+            result = _mm256_or_si256(result, UnpremultiplyChannelAVX2<16>(pixels, alpha, halfAlpha));
+            result = _mm256_or_si256(result, UnpremultiplyChannelAVX2<8>(pixels, alpha, halfAlpha));
+            result = _mm256_or_si256(result, UnpremultiplyChannelAVX2<0>(pixels, alpha, halfAlpha));
+            
+            result = _mm256_andnot_si256(_mm256_cmpeq_epi32(alphaBits, zero), result);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), result);
+        }
+        UnpremultiplySSE2(src + i, dst + i, count - i);
+    }
+    
+    // Blends unpack to 16-bit words like Premultiply and add the source back with
+    // unsigned saturation, matching the scalar clamp. Blocks whose source is entirely
+    // transparent or entirely opaque skip the arithmetic; the result is the same.
+    
+    PIXELOPS_TARGET("sse2")
+    __m128i MultiplyWords(__m128i words, __m128i factors) {
+        __m128i t = _mm_add_epi16(_mm_mullo_epi16(words, factors), _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+    
+    PIXELOPS_TARGET("sse2")
+    __m128i InverseAlphaWords(__m128i words) {
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(words, 0xFF), 0xFF);
+        return _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+    }
+    
+    PIXELOPS_TARGET("sse2")
+    __m128i BlendOverBlockSSE2(__m128i src, __m128i dst) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i low = MultiplyWords(_mm_unpacklo_epi8(dst, zero), InverseAlphaWords(_mm_unpacklo_epi8(src, zero)));
+        __m128i high = MultiplyWords(_mm_unpackhi_epi8(dst, zero), InverseAlphaWords(_mm_unpackhi_epi8(src, zero)));
+        return _mm_adds_epu8(src, _mm_packus_epi16(low, high));
+    }
+    
+    PIXELOPS_TARGET("sse2")
+    void FillSSE2(uint32_t* dst, uint32_t color, size_t count) {
+        const __m128i value = _mm_set1_epi32(static_cast<int>(color));
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), value);
+        }
+        FillScalar(dst + i, color, count - i);
+    }
+    
+    PIXELOPS_TARGET("sse2")
+    void BlendOverSSE2(const uint32_t* src, uint32_t* dst, size_t count) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(pixels, zero)) == 0xFFFF) {
+                continue;
+            }
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(pixels, alphaMask), alphaMask)) == 0xFFFF) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), pixels);
+                continue;
+            }
+            __m128i background = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), BlendOverBlockSSE2(pixels, background));
+        }
+        BlendOverScalar(src + i, dst + i, count - i);
+    }
+    
+    PIXELOPS_TARGET("sse2")
+    void BlendOverOpacitySSE2(const uint32_t* src, uint32_t* dst, size_t count, uint32_t opacity) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i factor = _mm_set1_epi16(static_cast<short>(opacity));
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i scaled = _mm_packus_epi16(MultiplyWords(_mm_unpacklo_epi8(pixels, zero), factor),
+                                              MultiplyWords(_mm_unpackhi_epi8(pixels, zero), factor));
+            __m128i background = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), BlendOverBlockSSE2(scaled, background));
+        }
+        BlendOverOpacityScalar(src + i, dst + i, count - i, opacity);
+    }
+    
+    PIXELOPS_TARGET("avx2")
+    __m256i MultiplyWordsAVX2(__m256i words, __m256i factors) {
+        __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(words, factors), _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+    
+    PIXELOPS_TARGET("avx2")
+    __m256i InverseAlphaWordsAVX2(__m256i words) {
+        __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(words, 0xFF), 0xFF);
+        return _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+    }
+    
+    PIXELOPS_TARGET("avx2")
+    __m256i BlendOverBlockAVX2(__m256i src, __m256i dst) {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i low = MultiplyWordsAVX2(_mm256_unpacklo_epi8(dst, zero), InverseAlphaWordsAVX2(_mm256_unpacklo_epi8(src, zero)));
+        __m256i high = MultiplyWordsAVX2(_mm256_unpackhi_epi8(dst, zero), InverseAlphaWordsAVX2(_mm256_unpackhi_epi8(src, zero)));
+        return _mm256_adds_epu8(src, _mm256_packus_epi16(low, high));
+    }
+    
+    PIXELOPS_TARGET("avx2")
+    void FillAVX2(uint32_t* dst, uint32_t color, size_t count) {
+        const __m256i value = _mm256_set1_epi32(static_cast<int>(color));
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), value);
+        }
+        FillSSE2(dst + i, color, count - i);
+    }
+    
+    PIXELOPS_TARGET("avx2")
+    void BlendOverAVX2(const uint32_t* src, uint32_t* dst, size_t count) {
+        const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            if (_mm256_testz_si256(pixels, pixels)) {
+                continue;
+            }
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(pixels, alphaMask), alphaMask)) == -1) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), pixels);
+                continue;
+            }
+            __m256i background = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), BlendOverBlockAVX2(pixels, background));
+        }
+        BlendOverSSE2(src + i, dst + i, count - i);
+    }
+    
+    PIXELOPS_TARGET("avx2")
+    void BlendOverOpacityAVX2(const uint32_t* src, uint32_t* dst, size_t count, uint32_t opacity) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i factor = _mm256_set1_epi16(static_cast<short>(opacity));
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i scaled = _mm256_packus_epi16(MultiplyWordsAVX2(_mm256_unpacklo_epi8(pixels, zero), factor),
+                                                 MultiplyWordsAVX2(_mm256_unpackhi_epi8(pixels, zero), factor));
+            __m256i background = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), BlendOverBlockAVX2(scaled, background));
+        }
+        BlendOverOpacitySSE2(src + i, dst + i, count - i, opacity);
+    }
+    
+    bool CpuHasSSE2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#else
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+    
+    bool CpuHasAVX2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        // The OS must also save the YMM registers (OSXSAVE and XCR0 bits 1-2)
+        __cpuid(info, 1);
+        if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+#ifdef PIXELOPS_NEON
+    // ---- NEON ----
+    //
+    // vld4 splits 16 pixels into channel planes. vrshr gives (t + 128) >> 8 and vraddhn
+    // adds it back with another +128 before narrowing - the same rounding identity.
+    
+    uint8x8_t MultiplyAlphaNEON(uint8x8_t c, uint8x8_t a) {
+        uint16x8_t t = vmull_u8(c, a);
+        return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+    }
+    
+    uint8x16_t MultiplyAlphaNEON(uint8x16_t c, uint8x16_t a) {
+        return vcombine_u8(MultiplyAlphaNEON(vget_low_u8(c), vget_low_u8(a)),
+                           MultiplyAlphaNEON(vget_high_u8(c), vget_high_u8(a)));
+    }
+    
+    void PremultiplyNEON(const uint32_t* src, uint32_t* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            uint8x16x4_t pixels = vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+            pixels.val[0] = MultiplyAlphaNEON(pixels.val[0], pixels.val[3]);
+            pixels.val[1] = MultiplyAlphaNEON(pixels.val[1], pixels.val[3]);
+            pixels.val[2] = MultiplyAlphaNEON(pixels.val[2], pixels.val[3]);
+            vst4q_u8(reinterpret_cast<uint8_t*>(dst + i), pixels);
+        }
+        PremultiplyScalar(src + i, dst + i, count - i);
+    }
+    
+    template <int SHIFT>
+    uint32x4_t UnpremultiplyChannelNEON(uint32x4_t pixels, float32x4_t alpha, float32x4_t halfAlpha) {
+        uint32x4_t channel = vandq_u32(vshlq_u32(pixels, vdupq_n_s32(-SHIFT)), vdupq_n_u32(0xFF));
+        float32x4_t numerator = vaddq_f32(vmulq_n_f32(vcvtq_f32_u32(channel), 255.0f), halfAlpha);
+        float32x4_t quotient = vminq_f32(vdivq_f32(numerator, alpha), vdupq_n_f32(255.0f));
+        return vshlq_u32(vcvtq_u32_f32(quotient), vdupq_n_s32(SHIFT));
+    }
+    
+    void UnpremultiplyNEON(const uint32_t* src, uint32_t* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            uint32x4_t pixels = vld1q_u32(src + i);
+            uint32x4_t alphaBits = vshrq_n_u32(pixels, 24);
+            float32x4_t alpha = vcvtq_f32_u32(alphaBits);
+            float32x4_t halfAlpha = vcvtq_f32_u32(vshrq_n_u32(alphaBits, 1));
+            
+            uint32x4_t result = vshlq_n_u32(alphaBits, 24);
+            result = vorrq_u32(result, UnpremultiplyChannelNEON<16>(pixels, alpha, halfAlpha));
+            result = vorrq_u32(result, UnpremultiplyChannelNEON<8>(pixels, alpha, halfAlpha));
+            result = vorrq_u32(result, UnpremultiplyChannelNEON<0>(pixels, alpha, halfAlpha));
+            
+            // vminq_f32 passes NaN (0 / 0) through; clear zero-alpha pixels explicitly
+            result = vbicq_u32(result, vceqq_u32(alphaBits, vdupq_n_u32(0)));
+            vst1q_u32(dst + i, result);
+        }
+        UnpremultiplyScalar(src + i, dst + i, count - i);
+    }
+    
+    void FillNEON(uint32_t* dst, uint32_t color, size_t count) {
+        uint32x4_t value = vdupq_n_u32(color);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            vst1q_u32(dst + i, value);
+        }
+        FillScalar(dst + i, color, count - i);
+    }
+    
+    // 255 - alpha is ~alpha; vqadd saturates like the scalar clamp
+    void BlendOverPlanesNEON(const uint8x16x4_t& src, uint8x16x4_t& dst) {
+        uint8x16_t inverse = vmvnq_u8(src.val[3]);
+        for (int c = 0; c < 4; c++) {
+            dst.val[c] = vqaddq_u8(src.val[c], MultiplyAlphaNEON(dst.val[c], inverse));
+        }
+    }
+    
+    void BlendOverNEON(const uint32_t* src, uint32_t* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            uint8x16x4_t pixels = vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+            uint8x16x4_t background = vld4q_u8(reinterpret_cast<const uint8_t*>(dst + i));
+            BlendOverPlanesNEON(pixels, background);
+            vst4q_u8(reinterpret_cast<uint8_t*>(dst + i), background);
+        }
+        BlendOverScalar(src + i, dst + i, count - i);
+    }
+    
+    void BlendOverOpacityNEON(const uint32_t* src, uint32_t* dst, size_t count, uint32_t opacity) {
+        uint8x16_t factor = vdupq_n_u8(static_cast<uint8_t>(opacity));
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            uint8x16x4_t pixels = vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+            for (int c = 0; c < 4; c++) {
+                pixels.val[c] = MultiplyAlphaNEON(pixels.val[c], factor);
+            }
+            uint8x16x4_t background = vld4q_u8(reinterpret_cast<const uint8_t*>(dst + i));
+            BlendOverPlanesNEON(pixels, background);
+            vst4q_u8(reinterpret_cast<uint8_t*>(dst + i), background);
+        }
+        BlendOverOpacityScalar(src + i, dst + i, count - i, opacity);
+    }
+#endif
+
+    PixelIsa DetectIsa() {
+#if defined(PIXELOPS_X86)
+        if (CpuHasAVX2()) {
+            return PixelIsa::AVX2;
+        }
+        if (CpuHasSSE2()) {
+            return PixelIsa::SSE2;
+        }
+#elif defined(PIXELOPS_NEON)
+        return PixelIsa::NEON;
+#endif
+        return PixelIsa::Scalar;
+    }
+    
+    // -1 until the first call detects the CPU
+    std::atomic<int> activeIsa(-1);
+}
+
+PixelIsa PixelOps::GetActiveIsa() {
+    int isa = activeIsa.load(std::memory_order_relaxed);
+    if (isa < 0) {
+        isa = static_cast<int>(DetectIsa());
+        activeIsa.store(isa, std::memory_order_relaxed);
+    }
+    return static_cast<PixelIsa>(isa);
+}
+
+bool PixelOps::IsIsaSupported(PixelIsa isa) {
+    switch (isa) {
+        case PixelIsa::Scalar:
+            return true;
+#ifdef PIXELOPS_X86
+        case PixelIsa::SSE2:
+            return CpuHasSSE2();
+        case PixelIsa::AVX2:
+            return CpuHasAVX2();
+#endif
+#ifdef PIXELOPS_NEON
+        case PixelIsa::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+bool PixelOps::SetActiveIsa(PixelIsa isa) {
+    if (!IsIsaSupported(isa)) {
+        return false;
+    }
+    activeIsa.store(static_cast<int>(isa), std::memory_order_relaxed);
+    return true;
+}
+
+const char* PixelOps::GetIsaName(PixelIsa isa) {
+    switch (isa) {
+        case PixelIsa::SSE2: return "SSE2";
+        case PixelIsa::AVX2: return "AVX2";
+        case PixelIsa::NEON: return "NEON";
+        default: return "Scalar";
+    }
+}
+
+void PixelOps::Premultiply(const uint32_t* src, uint32_t* dst, size_t count) {
+    switch (GetActiveIsa()) {
+#ifdef PIXELOPS_X86
+        case PixelIsa::AVX2:
+            PremultiplyAVX2(src, dst, count);
+            break;
+        case PixelIsa::SSE2:
+            PremultiplySSE2(src, dst, count);
+            break;
+#endif
+#ifdef PIXELOPS_NEON
+        case PixelIsa::NEON:
+            PremultiplyNEON(src, dst, count);
+            break;
+#endif
+        default:
+            PremultiplyScalar(src, dst, count);
+            break;
+    }
+}
+
+void PixelOps::Unpremultiply(const uint32_t* src, uint32_t* dst, size_t count) {
+    switch (GetActiveIsa()) {
+#ifdef PIXELOPS_X86
+        case PixelIsa::AVX2:
+            UnpremultiplyAVX2(src, dst, count);
+            break;
+        case PixelIsa::SSE2:
+            UnpremultiplySSE2(src, dst, count);
+            break;
+#endif
+#ifdef PIXELOPS_NEON
+        case PixelIsa::NEON:
+            UnpremultiplyNEON(src, dst, count);
+            break;
+#endif
+        default:
+            UnpremultiplyScalar(src, dst, count);
+            break;
+    }
+}
+
+void PixelOps::Fill(uint32_t* dst, uint32_t color, size_t count) {
+    switch (GetActiveIsa()) {
+#ifdef PIXELOPS_X86
+        case PixelIsa::AVX2:
+            FillAVX2(dst, color, count);
+            break;
+        case PixelIsa::SSE2:
+            FillSSE2(dst, color, count);
+            break;
+#endif
+#ifdef PIXELOPS_NEON
+        case PixelIsa::NEON:
+            FillNEON(dst, color, count);
+            break;
+#endif
+        default:
+            FillScalar(dst, color, count);
+            break;
+    }
+}
+
+void PixelOps::BlendOver(const uint32_t* src, uint32_t* dst, size_t count) {
+    switch (GetActiveIsa()) {
+#ifdef PIXELOPS_X86
+        case PixelIsa::AVX2:
+            BlendOverAVX2(src, dst, count);
+            break;
+        case PixelIsa::SSE2:
+            BlendOverSSE2(src, dst, count);
+            break;
+#endif
+#ifdef PIXELOPS_NEON
+        case PixelIsa::NEON:
+            BlendOverNEON(src, dst, count);
+            break;
+#endif
+        default:
+            BlendOverScalar(src, dst, count);
+            break;
+    }
+}
+
+void PixelOps::BlendOverOpacity(const uint32_t* src, uint32_t* dst, size_t count, uint32_t opacity) {
+    if (opacity >= 255) {
+        BlendOver(src, dst, count);
+        return;
+    }
+    
+    switch (GetActiveIsa()) {
+#ifdef PIXELOPS_X86
+        case PixelIsa::AVX2:
+            BlendOverOpacityAVX2(src, dst, count, opacity);
+            break;
+        case PixelIsa::SSE2:
+            BlendOverOpacitySSE2(src, dst, count, opacity);
+            break;
+#endif
+#ifdef PIXELOPS_NEON
+        case PixelIsa::NEON:
+            BlendOverOpacityNEON(src, dst, count, opacity);
+            break;
+#endif
+        default:
+            BlendOverOpacityScalar(src, dst, count, opacity);
+            break;
+    }
+}
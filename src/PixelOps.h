@@ -0,0 +1,51 @@
+// PixelOps.h - Premultiplied-alpha pixel kernels with runtime CPU dispatch (portable)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Instruction sets a kernel can be built for
+enum class PixelIsa {
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON
+};
+
+// Bulk kernels on BGRA (0xAARRGGBB words): conversions between straight and
+// premultiplied alpha, fills and premultiplied blends. Every path rounds exactly
+// like the scalar reference, so results never depend on the CPU. src and dst may
+// be the same buffer.
+class PixelOps {
+public:
+    // c' = (c * a + 127) / 255 for each color channel; alpha is unchanged
+    static void Premultiply(const uint32_t* src, uint32_t* dst, size_t count);
+    
+    // c' = min(255, (c * 255 + a / 2) / a); pixels with zero alpha become 0
+    static void Unpremultiply(const uint32_t* src, uint32_t* dst, size_t count);
+    
+    // dst = color for count pixels
+    static void Fill(uint32_t* dst, uint32_t color, size_t count);
+    
+    // Premultiplied source-over: dst = src + dst * (255 - srcAlpha) / 255 on all four
+    // channels, saturating at 255
+    static void BlendOver(const uint32_t* src, uint32_t* dst, size_t count);
+    
+    // Source-over with src first scaled by opacity (0..255) on all four channels
+    static void BlendOverOpacity(const uint32_t* src, uint32_t* dst, size_t count, uint32_t opacity);
+    
+    // Single channel version of the premultiply rounding, for per-pixel code
+    static uint32_t MultiplyAlpha(uint32_t c, uint32_t a) {
+        uint32_t t = c * a + 128;
+        return (t + (t >> 8)) >> 8;    // Equals (c * a + 127) / 255 for 8-bit inputs
+    }
+    
+    // The instruction set picked at startup (the best one the CPU supports)
+    static PixelIsa GetActiveIsa();
+    static bool IsIsaSupported(PixelIsa isa);
+    
+    // Force a specific path, for tests and benchmarks. Returns false if unsupported.
+    static bool SetActiveIsa(PixelIsa isa);
+    
+    static const char* GetIsaName(PixelIsa isa);
+};
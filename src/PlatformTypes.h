@@ -0,0 +1,31 @@
+// PlatformTypes.h - Win32 RECT, COLORREF and min/max for code that also builds without Win32
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <algorithm>
+#include <cstdint>
+
+// Same layout and meaning as the Win32 definitions, so the frame and settings code
+// reads the same on every platform
+struct RECT {
+    int32_t left;
+    int32_t top;
+    int32_t right;
+    int32_t bottom;
+};
+
+typedef uint32_t COLORREF;      // 0x00BBGGRR
+
+constexpr COLORREF RGB(uint32_t r, uint32_t g, uint32_t b) {
+    return (r & 0xFF) | ((g & 0xFF) << 8) | ((b & 0xFF) << 16);
+}
+constexpr uint32_t GetRValue(COLORREF color) { return color & 0xFF; }
+constexpr uint32_t GetGValue(COLORREF color) { return (color >> 8) & 0xFF; }
+constexpr uint32_t GetBValue(COLORREF color) { return (color >> 16) & 0xFF; }
+
+// windows.h provides these as macros
+using std::max;
+using std::min;
+#endif
@@ -0,0 +1,234 @@
+// PngWriter.cpp - PNG encoding implementation
+#include "PngWriter.h"
+#include <algorithm>
+
+namespace {
+    void AppendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+    
+    // Deflate bit stream: values go in least significant bit first, Huffman codes most
+    // significant bit first
+    class BitWriter {
+    public:
+        explicit BitWriter(std::vector<uint8_t>& output) : out(output), buffer(0), count(0) {}
+        
+        void Write(uint32_t value, int bits) {
+            buffer |= static_cast<uint64_t>(value) << count;
+            count += bits;
+            while (count >= 8) {
+                out.push_back(static_cast<uint8_t>(buffer));
+                buffer >>= 8;
+                count -= 8;
+            }
+        }
+        
+        void WriteCode(uint32_t code, int bits) {
+            uint32_t reversed = 0;
+            for (int i = 0; i < bits; i++) {
+                reversed |= ((code >> i) & 1) << (bits - 1 - i);
+            }
+            Write(reversed, bits);
+        }
+        
+        void Flush() {
+            if (count > 0) {
+                out.push_back(static_cast<uint8_t>(buffer));
+            }
+            buffer = 0;
+            count = 0;
+        }
+    
+    private:
+        std::vector<uint8_t>& out;
+        uint64_t buffer;
+        int count;
+    };
+    
+    // Fixed literal/length code (RFC 1951, 3.2.6)
+    void WriteSymbol(BitWriter& bits, int symbol) {
+        if (symbol < 144) {
+            bits.WriteCode(0x30 + symbol, 8);
+        } else if (symbol < 256) {
+            bits.WriteCode(0x190 + symbol - 144, 9);
+        } else if (symbol < 280) {
+            bits.WriteCode(symbol - 256, 7);
+        } else {
+            bits.WriteCode(0xC0 + symbol - 280, 8);
+        }
+    }
+    
+    const int LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    const int LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    const int DISTANCE_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                   257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    const int DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    
+    void WriteMatch(BitWriter& bits, int length, int distance) {
+        int code = 28;
+        while (LENGTH_BASE[code] > length) {
+            code--;
+        }
+        WriteSymbol(bits, 257 + code);
+        bits.Write(length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+        
+        code = 29;
+        while (DISTANCE_BASE[code] > distance) {
+            code--;
+        }
+        bits.WriteCode(code, 5);
+        bits.Write(distance - DISTANCE_BASE[code], DISTANCE_EXTRA[code]);
+    }
+}
+
+std::vector<uint8_t> PngWriter::Encode(const RasterImage& image) {
+    // Filtered scanlines: a filter type byte, then each RGB byte minus the one to its left
+    size_t rowBytes = static_cast<size_t>(image.width) * 3;
+    std::vector<uint8_t> raw((rowBytes + 1) * image.height);
+    std::vector<uint8_t> row(rowBytes);
+    for (int y = 0; y < image.height; y++) {
+        // Premultiplied over black is just the color channels
+        const uint32_t* pixels = image.pixels + static_cast<size_t>(y) * image.stride;
+        for (int x = 0; x < image.width; x++) {
+            row[x * 3] = static_cast<uint8_t>(pixels[x] >> 16);
+            row[x * 3 + 1] = static_cast<uint8_t>(pixels[x] >> 8);
+            row[x * 3 + 2] = static_cast<uint8_t>(pixels[x]);
+        }
+        
+        uint8_t* filtered = &raw[(rowBytes + 1) * y];
+        filtered[0] = 1;
+        for (size_t i = 0; i < rowBytes; i++) {
+            filtered[1 + i] = static_cast<uint8_t>(row[i] - (i >= 3 ? row[i - 3] : 0));
+        }
+    }
+    
+    std::vector<uint8_t> header;
+    AppendBigEndian(header, static_cast<uint32_t>(image.width));
+    AppendBigEndian(header, static_cast<uint32_t>(image.height));
+    header.push_back(8);        // Bit depth
+    header.push_back(2);        // Truecolor
+    header.push_back(0);        // Deflate
+    header.push_back(0);        // Adaptive filtering
+    header.push_back(0);        // Not interlaced
+    
+    std::vector<uint8_t> compressed;
+    Compress(raw.data(), raw.size(), compressed);
+    
+    static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<uint8_t> png(SIGNATURE, SIGNATURE + 8);
+    AppendChunk(png, "IHDR", header);
+    AppendChunk(png, "IDAT", compressed);
+    AppendChunk(png, "IEND", std::vector<uint8_t>());
+    return png;
+}
+
+void PngWriter::Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    out.push_back(0x78);        // Deflate, 32K window
+    out.push_back(0x01);        // Fastest compression; header check bits make 0x7801 a multiple of 31
+    
+    // One final block with the fixed codes. The hash table holds the last position of
+    // each 3-byte prefix; a match is taken greedily when it reaches MIN_MATCH bytes.
+    BitWriter bits(out);
+    bits.Write(1, 1);
+    bits.Write(1, 2);
+    
+    std::vector<int64_t> head(static_cast<size_t>(1) << HASH_BITS, -1);
+    auto hash = [&](size_t position) {
+        uint32_t key = data[position] | (data[position + 1] << 8) | (data[position + 2] << 16);
+        return (key * 2654435761u) >> (32 - HASH_BITS);
+    };
+    
+    size_t position = 0;
+    while (position < size) {
+        int length = 0;
+        size_t distance = 0;
+        if (position + MIN_MATCH <= size) {
+            uint32_t key = hash(position);
+            int64_t candidate = head[key];
+            head[key] = static_cast<int64_t>(position);
+            if (candidate >= 0 && position - static_cast<size_t>(candidate) <= WINDOW_SIZE) {
+                size_t limit = std::min(size - position, static_cast<size_t>(MAX_MATCH));
+                const uint8_t* a = data + candidate;
+                const uint8_t* b = data + position;
+                size_t matched = 0;
+                while (matched < limit && a[matched] == b[matched]) {
+                    matched++;
+                }
+                if (matched >= static_cast<size_t>(MIN_MATCH)) {
+                    length = static_cast<int>(matched);
+                    distance = position - static_cast<size_t>(candidate);
+                }
+            }
+        }
+        
+        if (length > 0) {
+            WriteMatch(bits, length, static_cast<int>(distance));
+            
+            // Keep the table current at the end of the match, so the next one can
+            // continue a run from there
+            size_t last = position + length - 1;
+            if (last + MIN_MATCH <= size) {
+                head[hash(last)] = static_cast<int64_t>(last);
+            }
+            position += length;
+        } else {
+            WriteSymbol(bits, data[position]);
+            position++;
+        }
+    }
+    WriteSymbol(bits, 256);
+    bits.Flush();
+    AppendBigEndian(out, Adler32(data, size));
+}
+
+void PngWriter::AppendChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data) {
+    AppendBigEndian(png, static_cast<uint32_t>(data.size()));
+    size_t typeOffset = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data.begin(), data.end());
+    AppendBigEndian(png, Crc32(&png[typeOffset], png.size() - typeOffset));
+}
+
+uint32_t PngWriter::Crc32(const uint8_t* data, size_t size, uint32_t crc) {
+    static const std::vector<uint32_t> table = []() {
+        std::vector<uint32_t> entries(256);
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[n] = c;
+        }
+        return entries;
+    }();
+    
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t PngWriter::Adler32(const uint8_t* data, size_t size, uint32_t adler) {
+    // Sums stay below 2^32 for 5552 bytes between reductions
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    while (size > 0) {
+        size_t block = size < 5552 ? size : 5552;
+        for (size_t i = 0; i < block; i++) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+        data += block;
+        size -= block;
+    }
+    return (b << 16) | a;
+}
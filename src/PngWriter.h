@@ -0,0 +1,30 @@
+// PngWriter.h - PNG encoding of rendered frames (portable, no Win32)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Raster.h"
+
+// Encodes a premultiplied frame as an 8-bit RGB PNG of how it looks over black, for
+// frame dumps and golden images. Rows use the Sub filter and deflate uses fixed
+// Huffman codes with greedy matching: no zlib needed, and the mostly flat frames
+// still shrink many times over.
+class PngWriter {
+public:
+    static std::vector<uint8_t> Encode(const RasterImage& image);
+    
+    // The checksums PNG chunks and zlib streams end with; pass the previous result to continue
+    static uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+    static uint32_t Adler32(const uint8_t* data, size_t size, uint32_t adler = 1);
+
+private:
+    // zlib stream of size bytes at data, appended to out
+    static void Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+    static void AppendChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data);
+    
+    static const int MIN_MATCH = 3;
+    static const int MAX_MATCH = 258;
+    static const int WINDOW_SIZE = 32768;
+    static const int HASH_BITS = 15;
+};
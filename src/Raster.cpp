@@ -0,0 +1,80 @@
+// Raster.cpp - Surface fill, copy and blend implementation
+#include "Raster.h"
+#include "PixelOps.h"
+#include <cstring>
+
+void Raster::FillRect(const RasterSurface& dst, const PixelRect& rect, uint32_t color, const PixelRect& clip) {
+    PixelRect area = PixelRect::Intersect(PixelRect::Intersect(rect, clip), dst.Bounds());
+    if (area.IsEmpty()) {
+        return;
+    }
+    
+    for (int y = area.top; y < area.bottom; y++) {
+        PixelOps::Fill(dst.Row(y) + area.left, color, area.Width());
+    }
+}
+
+void Raster::OutlineRect(const RasterSurface& dst, const PixelRect& rect, int thickness, uint32_t color,
+                         const PixelRect& clip) {
+    if (rect.IsEmpty() || thickness <= 0) {
+        return;
+    }
+    
+    // Thick enough to meet in the middle means solid
+    if (thickness * 2 >= rect.Width() || thickness * 2 >= rect.Height()) {
+        FillRect(dst, rect, color, clip);
+        return;
+    }
+    
+    FillRect(dst, PixelRect(rect.left, rect.top, rect.right, rect.top + thickness), color, clip);
+    FillRect(dst, PixelRect(rect.left, rect.bottom - thickness, rect.right, rect.bottom), color, clip);
+    FillRect(dst, PixelRect(rect.left, rect.top + thickness, rect.left + thickness, rect.bottom - thickness), color, clip);
+    FillRect(dst, PixelRect(rect.right - thickness, rect.top + thickness, rect.right, rect.bottom - thickness), color, clip);
+}
+
+void Raster::Copy(const RasterSurface& dst, int x, int y, const RasterImage& src, const PixelRect& clip) {
+    Draw(dst, x, y, src, Op::Copy, 255, clip);
+}
+
+void Raster::BlendOver(const RasterSurface& dst, int x, int y, const RasterImage& src, const PixelRect& clip) {
+    Draw(dst, x, y, src, Op::Blend, 255, clip);
+}
+
+void Raster::BlendOpacity(const RasterSurface& dst, int x, int y, const RasterImage& src, uint32_t opacity,
+                          const PixelRect& clip) {
+    if (opacity == 0) {
+        return;
+    }
+    Draw(dst, x, y, src, opacity >= 255 ? Op::Blend : Op::BlendOpacity, opacity, clip);
+}
+
+void Raster::Draw(const RasterSurface& dst, int x, int y, const RasterImage& src, Op op, uint32_t opacity,
+                  const PixelRect& clip) {
+    if (!src.pixels || !dst.pixels) {
+        return;
+    }
+    
+    PixelRect target(x, y, x + src.width, y + src.height);
+    PixelRect area = PixelRect::Intersect(PixelRect::Intersect(target, clip), dst.Bounds());
+    if (area.IsEmpty()) {
+        return;
+    }
+    
+    size_t count = area.Width();
+    for (int row = area.top; row < area.bottom; row++) {
+        const uint32_t* from = src.pixels + static_cast<size_t>(row - y) * src.stride + (area.left - x);
+        uint32_t* to = dst.Row(row) + area.left;
+        
+        switch (op) {
+            case Op::Copy:
+                memcpy(to, from, count * sizeof(uint32_t));
+                break;
+            case Op::Blend:
+                PixelOps::BlendOver(from, to, count);
+                break;
+            case Op::BlendOpacity:
+                PixelOps::BlendOverOpacity(from, to, count, opacity);
+                break;
+        }
+    }
+}
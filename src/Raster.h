@@ -0,0 +1,50 @@
+// Raster.h - Fills, copies and blends on premultiplied BGRA surfaces (portable, no Win32)
+#pragma once
+
+#include <cstdint>
+#include "DamageRegion.h"
+
+// Read-only top-down pixel image, stride pixels per row
+struct RasterImage {
+    const uint32_t* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+};
+
+// Writable top-down pixel buffer, such as the window's back buffer
+struct RasterSurface {
+    uint32_t* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+    
+    PixelRect Bounds() const { return PixelRect(0, 0, width, height); }
+    RasterImage AsImage() const { return RasterImage{pixels, width, height, stride}; }
+    uint32_t* Row(int y) const { return pixels + static_cast<size_t>(y) * stride; }
+};
+
+// Rectangle primitives for composing a frame on the CPU. Each one writes only pixels
+// inside both clip and the surface, and hands whole rows to the PixelOps kernels, so
+// the per-pixel work runs on the widest instruction set the CPU has.
+class Raster {
+public:
+    static void FillRect(const RasterSurface& dst, const PixelRect& rect, uint32_t color, const PixelRect& clip);
+    
+    // Ring of the given thickness just inside rect
+    static void OutlineRect(const RasterSurface& dst, const PixelRect& rect, int thickness, uint32_t color,
+                            const PixelRect& clip);
+    
+    // Place src with its top-left corner at (x, y): Copy replaces the pixels, the blends
+    // composite premultiplied src over them
+    static void Copy(const RasterSurface& dst, int x, int y, const RasterImage& src, const PixelRect& clip);
+    static void BlendOver(const RasterSurface& dst, int x, int y, const RasterImage& src, const PixelRect& clip);
+    static void BlendOpacity(const RasterSurface& dst, int x, int y, const RasterImage& src, uint32_t opacity,
+                             const PixelRect& clip);
+
+private:
+    enum class Op { Copy, Blend, BlendOpacity };
+    
+    static void Draw(const RasterSurface& dst, int x, int y, const RasterImage& src, Op op, uint32_t opacity,
+                     const PixelRect& clip);
+};
@@ -0,0 +1,40 @@
+// ScrollBlit.cpp - In-place pixel scrolling implementation
+#include "ScrollBlit.h"
+#include <cstring>
+
+PixelRect ScrollBlit::ExposedBand(const PixelRect& area, int dy) {
+    if (area.IsEmpty() || dy == 0) {
+        return PixelRect();
+    }
+    if (dy >= area.Height() || -dy >= area.Height()) {
+        return area;
+    }
+    if (dy > 0) {
+        return PixelRect(area.left, area.bottom - dy, area.right, area.bottom);
+    }
+    return PixelRect(area.left, area.top, area.right, area.top - dy);
+}
+
+PixelRect ScrollBlit::ScrollRows(uint32_t* pixels, int stride, const PixelRect& area, int dy) {
+    PixelRect exposed = ExposedBand(area, dy);
+    if (exposed.IsEmpty() || exposed.Height() == area.Height()) {
+        return exposed;
+    }
+    
+    size_t rowBytes = static_cast<size_t>(area.Width()) * sizeof(uint32_t);
+    uint32_t* origin = pixels + area.left;
+    
+    // Walk away from the rows being overwritten so every source row is read before it changes
+    if (dy > 0) {
+        for (int y = area.top; y < area.bottom - dy; y++) {
+            memcpy(origin + static_cast<size_t>(y) * stride,
+                   origin + static_cast<size_t>(y + dy) * stride, rowBytes);
+        }
+    } else {
+        for (int y = area.bottom - 1; y >= area.top - dy; y--) {
+            memcpy(origin + static_cast<size_t>(y) * stride,
+                   origin + static_cast<size_t>(y + dy) * stride, rowBytes);
+        }
+    }
+    return exposed;
+}
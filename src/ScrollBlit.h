@@ -0,0 +1,20 @@
+// ScrollBlit.h - Scrolling an already composited pixel area in place (portable, no Win32)
+#pragma once
+
+#include <cstdint>
+#include "DamageRegion.h"
+
+// Moves the rows of a rectangle inside a 32-bit pixel buffer so a scroll only has
+// to render the band it uncovers. dy is the change in scroll offset: positive dy
+// moves the content up and exposes rows at the bottom.
+class ScrollBlit {
+public:
+    // Rows of area left without valid content after scrolling by dy. This is all of
+    // area when |dy| is at least its height, and empty when dy is 0.
+    static PixelRect ExposedBand(const PixelRect& area, int dy);
+    
+    // Shift the pixels of area (in a top-down buffer of stride pixels per row) up by
+    // dy rows and return the exposed band. Pixels outside area are not touched; the
+    // exposed band keeps stale pixels until it is redrawn.
+    static PixelRect ScrollRows(uint32_t* pixels, int stride, const PixelRect& area, int dy);
+};
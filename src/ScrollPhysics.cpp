@@ -0,0 +1,115 @@
+// ScrollPhysics.cpp - Inertial scrolling implementation
+#include "ScrollPhysics.h"
+#include <cmath>
+
+namespace {
+    // Below this many pixels per second coasting jumps to where it was heading
+    const double STOP_VELOCITY = 10.0;
+    const double MICROSECONDS_PER_SECOND = 1000000.0;
+}
+
+ScrollPhysics::ScrollPhysics()
+    : smoothing(0)
+    , maxOffset(0)
+    , position(0)
+    , velocity(0)
+    , stickVelocity(0)
+{
+}
+
+void ScrollPhysics::SetSmoothing(int64_t microseconds) {
+    smoothing = microseconds > 0 ? microseconds : 0;
+}
+
+void ScrollPhysics::SetRange(int newMaxOffset) {
+    maxOffset = newMaxOffset > 0 ? newMaxOffset : 0;
+    Clamp();
+}
+
+void ScrollPhysics::Reset(int offset) {
+    // Not clamped: the offset comes from a grid the range may not have caught up with yet
+    position = offset;
+    velocity = 0;
+}
+
+void ScrollPhysics::AddDistance(double pixels) {
+    if (smoothing == 0) {
+        position += pixels;
+        Clamp();
+        return;
+    }
+    
+    // Coasting from velocity v with rate r = 1 / smoothing covers v / r pixels
+    velocity += pixels * MICROSECONDS_PER_SECOND / smoothing;
+}
+
+void ScrollPhysics::SetStickVelocity(double pixelsPerSecond) {
+    stickVelocity = pixelsPerSecond;
+}
+
+void ScrollPhysics::Advance(int64_t microseconds) {
+    if (microseconds <= 0) {
+        return;
+    }
+    if (microseconds > MAX_STEP) {
+        microseconds = MAX_STEP;
+    }
+    double seconds = microseconds / MICROSECONDS_PER_SECOND;
+    
+    if (smoothing == 0) {
+        velocity = stickVelocity;
+        position += stickVelocity * seconds;
+        Clamp();
+        return;
+    }
+    
+    // v' = r (stick - v): the excess over the stick's speed decays exponentially, and
+    // the distance is its closed-form integral
+    double rate = MICROSECONDS_PER_SECOND / smoothing;
+    double decay = std::exp(-rate * seconds);
+    double excess = velocity - stickVelocity;
+    position += stickVelocity * seconds + excess * (1.0 - decay) / rate;
+    velocity = stickVelocity + excess * decay;
+    
+    if (stickVelocity == 0 && std::fabs(velocity) < STOP_VELOCITY) {
+        position = std::round(position + velocity / rate);
+        velocity = 0;
+    }
+    Clamp();
+}
+
+bool ScrollPhysics::IsMoving() const {
+    if (velocity != 0) {
+        return true;
+    }
+    // A stick pushing against the end of the range has nowhere to go
+    return (stickVelocity < 0 && position > 0) || (stickVelocity > 0 && position < maxOffset);
+}
+
+int ScrollPhysics::GetOffset() const {
+    return static_cast<int>(std::lround(position));
+}
+
+int ScrollPhysics::GetFrameStep(int shownOffset, int budget) const {
+    int step = GetOffset() - shownOffset;
+    if (step > budget) {
+        return budget;
+    }
+    return step < -budget ? -budget : step;
+}
+
+int ScrollPhysics::GetFrameBudget(int viewHeight) {
+    int budget = viewHeight * FRAME_BUDGET_PERCENT / 100;
+    return budget > 1 ? budget : 1;
+}
+
+void ScrollPhysics::Clamp() {
+    if (position <= 0) {
+        position = 0;
+        velocity = velocity < 0 ? 0 : velocity;
+    }
+    if (position >= maxOffset) {
+        position = maxOffset;
+        velocity = velocity > 0 ? 0 : velocity;
+    }
+}
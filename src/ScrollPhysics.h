@@ -0,0 +1,62 @@
+// ScrollPhysics.h - Inertial scrolling advanced by a frame clock (portable, no Win32)
+#pragma once
+
+#include <cstdint>
+
+// Scroll position with momentum. The wheel adds a distance to coast, the right stick holds
+// a speed proportional to its deflection, and the velocity settles toward the stick's with
+// the smoothing time constant. Advance integrates this exactly, so where the scroll goes
+// does not depend on how its time is split into frames. Moving keeps the position in
+// 0..maxOffset, and coasting comes to rest on the pixel it was heading for.
+class ScrollPhysics {
+public:
+    ScrollPhysics();
+    
+    // Microseconds for the speed to settle; 0 makes the wheel jump and the stick start and
+    // stop at once
+    void SetSmoothing(int64_t microseconds);
+    int64_t GetSmoothing() const { return smoothing; }
+    
+    // Scrollable distance; the position is clamped to it
+    void SetRange(int maxOffset);
+    
+    // Jump to offset and stop coasting; a held stick keeps scrolling from there
+    void Reset(int offset);
+    
+    // Coast pixels further (wheel), on top of any coasting still going on
+    void AddDistance(double pixels);
+    
+    // Scroll at this speed until it changes (stick deflection times full speed)
+    void SetStickVelocity(double pixelsPerSecond);
+    double GetStickVelocity() const { return stickVelocity; }
+    
+    // Move microseconds on; longer steps than MAX_STEP count as MAX_STEP, so a stalled
+    // frame does not throw the scroll a long way
+    void Advance(int64_t microseconds);
+    
+    // Would move if advanced
+    bool IsMoving() const;
+    
+    double GetPosition() const { return position; }
+    double GetVelocity() const { return velocity; }
+    int GetOffset() const;                  // Position rounded to a whole pixel
+    
+    // Pixels to scroll a frame that shows shownOffset, at most budget either way. What the
+    // budget leaves is caught up on the next frames.
+    int GetFrameStep(int shownOffset, int budget) const;
+    
+    // Budget for a view viewHeight pixels tall: FRAME_BUDGET_PERCENT of it, at least a pixel
+    static int GetFrameBudget(int viewHeight);
+    
+    static const int64_t MAX_STEP = 100000;
+    static const int FRAME_BUDGET_PERCENT = 50;
+
+private:
+    int64_t smoothing;
+    int maxOffset;
+    double position;
+    double velocity;                        // Pixels per second
+    double stickVelocity;
+    
+    void Clamp();
+};
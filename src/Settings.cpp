@@ -4,6 +4,8 @@
 Settings::Settings() {
 }
 
+#ifdef _WIN32
+
 void Settings::Load(const std::wstring& path) {
 
     iniPath = path + L"\\launcher.ini";
@@ -49,6 +51,19 @@ void Settings::Load(const std::wstring& path) {
     // Scrolling settings
     mouseScrollSpeed = GetPrivateProfileInt(L"Scrolling", L"MouseScrollSpeed", 60, iniPathPtr);
     joystickScrollSpeed = GetPrivateProfileInt(L"Scrolling", L"JoystickScrollSpeed", 120, iniPathPtr);
+    scrollSmoothing = GetPrivateProfileInt(L"Scrolling", L"ScrollSmoothing", 80, iniPathPtr);
+    scrollSmoothing = max(0, min(1000, scrollSmoothing));
+    
+    // Input settings
+    inputPollRate = GetPrivateProfileInt(L"Input", L"PollRate", 120, iniPathPtr);
+    inputPollRate = max(10, min(1000, inputPollRate));
+    latencyReportOnExit = GetPrivateProfileInt(L"Input", L"LatencyReport", 0, iniPathPtr) != 0;
+    
+    // Cache settings
+    iconCacheMaxSizeMB = GetPrivateProfileInt(L"Cache", L"IconCacheMaxSizeMB", 256, iniPathPtr);
+    iconCacheMaxSizeMB = max(16, min(4096, iconCacheMaxSizeMB));
+    pageCacheMaxSizeMB = GetPrivateProfileInt(L"Cache", L"PageCacheMaxSizeMB", 128, iniPathPtr);
+    pageCacheMaxSizeMB = max(0, min(2048, pageCacheMaxSizeMB));
     
     // Tab-specific colors
     tabSpecificColors.clear();
@@ -110,6 +125,15 @@ void Settings::Save() {
     // Scrolling settings
     WritePrivateProfileString(L"Scrolling", L"MouseScrollSpeed", std::to_wstring(mouseScrollSpeed).c_str(), iniPathPtr);
     WritePrivateProfileString(L"Scrolling", L"JoystickScrollSpeed", std::to_wstring(joystickScrollSpeed).c_str(), iniPathPtr);
+    WritePrivateProfileString(L"Scrolling", L"ScrollSmoothing", std::to_wstring(scrollSmoothing).c_str(), iniPathPtr);
+    
+    // Input settings
+    WritePrivateProfileString(L"Input", L"PollRate", std::to_wstring(inputPollRate).c_str(), iniPathPtr);
+    WritePrivateProfileString(L"Input", L"LatencyReport", latencyReportOnExit ? L"1" : L"0", iniPathPtr);
+    
+    // Cache settings
+    WritePrivateProfileString(L"Cache", L"IconCacheMaxSizeMB", std::to_wstring(iconCacheMaxSizeMB).c_str(), iniPathPtr);
+    WritePrivateProfileString(L"Cache", L"PageCacheMaxSizeMB", std::to_wstring(pageCacheMaxSizeMB).c_str(), iniPathPtr);
     
     // Tab-specific colors
     for (const auto& pair : tabSpecificColors) {
@@ -120,6 +144,18 @@ void Settings::Save() {
     }
 }
 
+#else
+
+// The profile API is Win32's; elsewhere the launcher runs on the defaults in Settings.h
+void Settings::Load(const std::wstring& path) {
+    iniPath = path + L"/launcher.ini";
+}
+
+void Settings::Save() {
+}
+
+#endif
+
 COLORREF Settings::GetTabColor(const std::wstring& tabName) const {
     auto it = tabSpecificColors.find(tabName);
     if (it != tabSpecificColors.end()) {
@@ -1,7 +1,7 @@
 // Settings.h - Centralized configuration management
 #pragma once
 
-#include <windows.h>
+#include "PlatformTypes.h"
 #include <string>
 #include <map>
 
@@ -62,10 +62,27 @@ public:
     // Scrolling settings
     int GetMouseScrollSpeed() const { return mouseScrollSpeed; }
     int GetJoystickScrollSpeed() const { return joystickScrollSpeed; }
+    int GetScrollSmoothing() const { return scrollSmoothing; }
+    int GetJoystickScrollVelocity() const { return joystickScrollSpeed * 120; } // Pixels per second at full deflection
     
     void SetMouseScrollSpeed(int speed) { mouseScrollSpeed = speed; }
     void SetJoystickScrollSpeed(int speed) { joystickScrollSpeed = speed; }
+    void SetScrollSmoothing(int milliseconds) { scrollSmoothing = milliseconds; }
     
+    // Input settings
+    int GetInputPollRate() const { return inputPollRate; }
+    bool GetLatencyReportOnExit() const { return latencyReportOnExit; }
+    
+    void SetInputPollRate(int rate) { inputPollRate = rate; }
+    void SetLatencyReportOnExit(bool enabled) { latencyReportOnExit = enabled; }
+    
+    // Cache settings
+    int GetIconCacheMaxSizeMB() const { return iconCacheMaxSizeMB; }
+    int GetPageCacheMaxSizeMB() const { return pageCacheMaxSizeMB; }
+    
+    void SetIconCacheMaxSizeMB(int size) { iconCacheMaxSizeMB = size; }
+    void SetPageCacheMaxSizeMB(int size) { pageCacheMaxSizeMB = size; }
+
 private:
     Settings();
     
@@ -94,5 +111,14 @@ private:
     
     // Scrolling
     int mouseScrollSpeed = 60;
-    int joystickScrollSpeed = 120;
+    int joystickScrollSpeed = 120;  // Pixels per 1/120 s at full stick deflection
+    int scrollSmoothing = 80;       // Milliseconds for the scroll speed to settle; 0 scrolls in steps
+    
+    // Input
+    int inputPollRate = 120;
+    bool latencyReportOnExit = false;
+    
+    // Cache
+    int iconCacheMaxSizeMB = 256;
+    int pageCacheMaxSizeMB = 128;
 };
@@ -0,0 +1,248 @@
+// ShellLinkReader.cpp - Native [MS-SHLLINK] binary parser implementation
+#include "ShellLinkReader.h"
+
+namespace {
+    // Fixed header layout ([MS-SHLLINK] 2.1)
+    const uint32_t SHELL_LINK_HEADER_SIZE = 0x4C;
+    const uint8_t SHELL_LINK_CLSID[16] = {
+        0x01, 0x14, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46
+    };
+    
+    // LinkInfo flags ([MS-SHLLINK] 2.3)
+    const uint32_t VOLUME_ID_AND_LOCAL_BASE_PATH = 0x00000001;
+    const uint32_t COMMON_NETWORK_RELATIVE_LINK_AND_PATH_SUFFIX = 0x00000002;
+    
+    // ExtraData block signatures ([MS-SHLLINK] 2.5)
+    const uint32_t ENVIRONMENT_VARIABLE_DATA_BLOCK = 0xA0000001;
+    const uint32_t ICON_ENVIRONMENT_DATA_BLOCK = 0xA0000007;
+    const uint32_t ENVIRONMENT_DATA_BLOCK_SIZE = 0x00000314;
+    const size_t ENVIRONMENT_TARGET_ANSI_SIZE = 260;
+    const size_t ENVIRONMENT_TARGET_UNICODE_SIZE = 520;
+    
+    // Little-endian reads that don't assume alignment
+    uint16_t ReadU16(const uint8_t* p) {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+    
+    uint32_t ReadU32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+}
+
+std::wstring LnkString::ToWString() const {
+    std::wstring result;
+    result.resize(length);
+    
+    if (unicode) {
+        for (size_t i = 0; i < length; i++) {
+            result[i] = static_cast<wchar_t>(ReadU16(data + i * 2));
+        }
+    } else {
+        for (size_t i = 0; i < length; i++) {
+            result[i] = static_cast<wchar_t>(data[i]);
+        }
+    }
+    
+    return result;
+}
+
+bool ShellLinkReader::Parse(const uint8_t* data, size_t size, ShellLinkData& link) {
+    link = ShellLinkData();
+    
+    // Validate the fixed-size header
+    if (!data || size < SHELL_LINK_HEADER_SIZE || ReadU32(data) != SHELL_LINK_HEADER_SIZE) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < sizeof(SHELL_LINK_CLSID); i++) {
+        if (data[4 + i] != SHELL_LINK_CLSID[i]) {
+            return false;
+        }
+    }
+    
+    link.linkFlags = ReadU32(data + 0x14);
+    link.fileAttributes = ReadU32(data + 0x18);
+    link.fileSize = ReadU32(data + 0x34);
+    link.iconIndex = static_cast<int32_t>(ReadU32(data + 0x38));
+    link.showCommand = ReadU32(data + 0x3C);
+    
+    size_t offset = SHELL_LINK_HEADER_SIZE;
+    
+    // LinkTargetIDList - we only need to skip it
+    if (link.linkFlags & HAS_LINK_TARGET_ID_LIST) {
+        if (offset + 2 > size) {
+            return false;
+        }
+        offset += 2 + ReadU16(data + offset);
+    }
+    
+    // LinkInfo
+    if (link.linkFlags & HAS_LINK_INFO) {
+        if (offset + 4 > size) {
+            return false;
+        }
+        
+        uint32_t linkInfoSize = ReadU32(data + offset);
+        if (linkInfoSize < 4 || offset + linkInfoSize > size) {
+            return false;
+        }
+        
+        if (!(link.linkFlags & FORCE_NO_LINK_INFO) &&
+            !ParseLinkInfo(data + offset, linkInfoSize, link)) {
+            return false;
+        }
+        offset += linkInfoSize;
+    }
+    
+    // StringData - always stored in this order when present
+    bool unicode = (link.linkFlags & IS_UNICODE) != 0;
+    
+    if ((link.linkFlags & HAS_NAME) && !ParseStringData(data, size, offset, unicode, link.name)) {
+        return false;
+    }
+    if ((link.linkFlags & HAS_RELATIVE_PATH) && !ParseStringData(data, size, offset, unicode, link.relativePath)) {
+        return false;
+    }
+    if ((link.linkFlags & HAS_WORKING_DIR) && !ParseStringData(data, size, offset, unicode, link.workingDirectory)) {
+        return false;
+    }
+    if ((link.linkFlags & HAS_ARGUMENTS) && !ParseStringData(data, size, offset, unicode, link.arguments)) {
+        return false;
+    }
+    if ((link.linkFlags & HAS_ICON_LOCATION) && !ParseStringData(data, size, offset, unicode, link.iconLocation)) {
+        return false;
+    }
+    
+    // ExtraData is optional and malformed blocks are ignored rather than failing the link
+    ParseExtraData(data, size, offset, link);
+    
+    return true;
+}
+
+bool ShellLinkReader::ParseLinkInfo(const uint8_t* info, size_t size, ShellLinkData& link) {
+    if (size < 0x1C) {
+        return false;
+    }
+    
+    uint32_t headerSize = ReadU32(info + 4);
+    uint32_t flags = ReadU32(info + 8);
+    uint32_t localBasePathOffset = ReadU32(info + 16);
+    uint32_t networkLinkOffset = ReadU32(info + 20);
+    uint32_t commonPathSuffixOffset = ReadU32(info + 24);
+    
+    // Optional unicode offsets are present when the header is at least 0x24 bytes
+    bool hasUnicodeOffsets = headerSize >= 0x24 && size >= 0x24;
+    uint32_t localBasePathOffsetUnicode = hasUnicodeOffsets ? ReadU32(info + 28) : 0;
+    uint32_t commonPathSuffixOffsetUnicode = hasUnicodeOffsets ? ReadU32(info + 32) : 0;
+    
+    if (flags & VOLUME_ID_AND_LOCAL_BASE_PATH) {
+        if (localBasePathOffsetUnicode) {
+            link.localBasePath = ReadNullTerminated(info, size, localBasePathOffsetUnicode, true);
+        } else if (localBasePathOffset) {
+            link.localBasePath = ReadNullTerminated(info, size, localBasePathOffset, false);
+        }
+    }
+    
+    if ((flags & COMMON_NETWORK_RELATIVE_LINK_AND_PATH_SUFFIX) && networkLinkOffset &&
+        networkLinkOffset + 0x14 <= size) {
+        const uint8_t* networkLink = info + networkLinkOffset;
+        size_t networkLinkSize = size - networkLinkOffset;
+        uint32_t netNameOffset = ReadU32(networkLink + 8);
+        
+        // NetNameOffsetUnicode exists only when NetNameOffset is past the base structure
+        if (netNameOffset > 0x14 && networkLinkSize >= 0x18 && ReadU32(networkLink + 20)) {
+            link.netName = ReadNullTerminated(networkLink, networkLinkSize, ReadU32(networkLink + 20), true);
+        } else if (netNameOffset) {
+            link.netName = ReadNullTerminated(networkLink, networkLinkSize, netNameOffset, false);
+        }
+    }
+    
+    if (commonPathSuffixOffsetUnicode) {
+        link.commonPathSuffix = ReadNullTerminated(info, size, commonPathSuffixOffsetUnicode, true);
+    } else if (commonPathSuffixOffset) {
+        link.commonPathSuffix = ReadNullTerminated(info, size, commonPathSuffixOffset, false);
+    }
+    
+    return true;
+}
+
+bool ShellLinkReader::ParseStringData(const uint8_t* data, size_t size, size_t& offset, bool unicode, LnkString& out) {
+    if (offset + 2 > size) {
+        return false;
+    }
+    
+    size_t count = ReadU16(data + offset);
+    size_t byteLength = unicode ? count * 2 : count;
+    offset += 2;
+    
+    if (offset + byteLength > size) {
+        return false;
+    }
+    
+    out.data = data + offset;
+    out.length = count;
+    out.unicode = unicode;
+    offset += byteLength;
+    
+    return true;
+}
+
+void ShellLinkReader::ParseExtraData(const uint8_t* data, size_t size, size_t offset, ShellLinkData& link) {
+    while (offset + 4 <= size) {
+        uint32_t blockSize = ReadU32(data + offset);
+        
+        // TerminalBlock (size < 4) or a block that runs past the buffer ends the list
+        if (blockSize < 8 || offset + blockSize > size) {
+            break;
+        }
+        
+        uint32_t signature = ReadU32(data + offset + 4);
+        
+        if ((signature == ENVIRONMENT_VARIABLE_DATA_BLOCK || signature == ICON_ENVIRONMENT_DATA_BLOCK) &&
+            blockSize >= ENVIRONMENT_DATA_BLOCK_SIZE) {
+            const uint8_t* block = data + offset + 8;
+            size_t unicodeOffset = ENVIRONMENT_TARGET_ANSI_SIZE;
+            
+            // Prefer the unicode target, fall back to the ANSI one
+            LnkString target = ReadNullTerminated(block, unicodeOffset + ENVIRONMENT_TARGET_UNICODE_SIZE, unicodeOffset, true);
+            if (target.empty()) {
+                target = ReadNullTerminated(block, ENVIRONMENT_TARGET_ANSI_SIZE, 0, false);
+            }
+            
+            if (signature == ENVIRONMENT_VARIABLE_DATA_BLOCK) {
+                link.environmentTarget = target;
+            } else {
+                link.iconEnvironmentPath = target;
+            }
+        }
+        
+        offset += blockSize;
+    }
+}
+
+LnkString ShellLinkReader::ReadNullTerminated(const uint8_t* data, size_t size, size_t offset, bool unicode) {
+    LnkString result;
+    if (offset >= size) {
+        return result;
+    }
+    
+    result.data = data + offset;
+    result.unicode = unicode;
+    
+    // Strings that are not terminated inside the structure are truncated at its end
+    if (unicode) {
+        size_t maxChars = (size - offset) / 2;
+        while (result.length < maxChars && ReadU16(result.data + result.length * 2) != 0) {
+            result.length++;
+        }
+    } else {
+        size_t maxChars = size - offset;
+        while (result.length < maxChars && result.data[result.length] != 0) {
+            result.length++;
+        }
+    }
+    
+    return result;
+}
@@ -0,0 +1,71 @@
+// ShellLinkReader.h - Native [MS-SHLLINK] binary parser (portable, no COM)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Non-owning view of a string stored inside a .lnk buffer.
+// Strings are either UTF-16LE (unicode) or bytes in the system code page.
+struct LnkString {
+    const uint8_t* data = nullptr; // Points into the caller's buffer
+    size_t length = 0;             // Length in characters (not bytes)
+    bool unicode = false;          // UTF-16LE if true, code page bytes otherwise
+    
+    bool empty() const { return length == 0; }
+    
+    // Widen to std::wstring (code page bytes are widened as Latin-1)
+    std::wstring ToWString() const;
+};
+
+// Fields extracted from a shell link. All strings reference the parsed buffer,
+// so the buffer must outlive this structure.
+struct ShellLinkData {
+    uint32_t linkFlags = 0;
+    uint32_t fileAttributes = 0;
+    uint32_t fileSize = 0;
+    int32_t iconIndex = 0;
+    uint32_t showCommand = 0;
+    
+    // LinkInfo
+    LnkString localBasePath;       // LocalBasePath (unicode variant preferred when present)
+    LnkString commonPathSuffix;    // CommonPathSuffix (unicode variant preferred when present)
+    LnkString netName;             // CommonNetworkRelativeLink NetName
+    
+    // StringData
+    LnkString name;
+    LnkString relativePath;
+    LnkString workingDirectory;
+    LnkString arguments;
+    LnkString iconLocation;
+    
+    // ExtraData
+    LnkString environmentTarget;   // EnvironmentVariableDataBlock target (unexpanded)
+    LnkString iconEnvironmentPath; // IconEnvironmentDataBlock target (unexpanded)
+};
+
+class ShellLinkReader {
+public:
+    // LinkFlags from [MS-SHLLINK] 2.1.1
+    static const uint32_t HAS_LINK_TARGET_ID_LIST = 0x00000001;
+    static const uint32_t HAS_LINK_INFO = 0x00000002;
+    static const uint32_t HAS_NAME = 0x00000004;
+    static const uint32_t HAS_RELATIVE_PATH = 0x00000008;
+    static const uint32_t HAS_WORKING_DIR = 0x00000010;
+    static const uint32_t HAS_ARGUMENTS = 0x00000020;
+    static const uint32_t HAS_ICON_LOCATION = 0x00000040;
+    static const uint32_t IS_UNICODE = 0x00000080;
+    static const uint32_t FORCE_NO_LINK_INFO = 0x00000100;
+    static const uint32_t HAS_EXP_STRING = 0x00000200;
+    static const uint32_t HAS_EXP_ICON = 0x00004000;
+    
+    // Parse a complete .lnk file held in memory. Returns false if the header
+    // is invalid or any structure runs past the end of the buffer.
+    static bool Parse(const uint8_t* data, size_t size, ShellLinkData& link);
+
+private:
+    static bool ParseLinkInfo(const uint8_t* data, size_t size, ShellLinkData& link);
+    static bool ParseStringData(const uint8_t* data, size_t size, size_t& offset, bool unicode, LnkString& out);
+    static void ParseExtraData(const uint8_t* data, size_t size, size_t offset, ShellLinkData& link);
+    static LnkString ReadNullTerminated(const uint8_t* data, size_t size, size_t offset, bool unicode);
+};
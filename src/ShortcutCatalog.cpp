@@ -0,0 +1,317 @@
+// ShortcutCatalog.cpp - Versioned binary catalog implementation
+#include "ShortcutCatalog.h"
+
+namespace {
+    // File layout: header, tab records, shortcut records, UTF-16LE string table.
+    // Every section starts on an 8-byte boundary.
+    const size_t HEADER_SIZE = 64;
+    const size_t TAB_RECORD_SIZE = 24;
+    const size_t SHORTCUT_RECORD_SIZE = 80;
+    const size_t SHORTCUT_STRING_COUNT = 6;
+    
+    // Header field offsets
+    const size_t HEADER_MAGIC = 0;
+    const size_t HEADER_VERSION = 4;
+    const size_t HEADER_HEADER_SIZE = 8;
+    const size_t HEADER_TAB_COUNT = 12;
+    const size_t HEADER_SHORTCUT_COUNT = 16;
+    const size_t HEADER_STRING_UNITS = 20;
+    const size_t HEADER_TABS_OFFSET = 24;
+    const size_t HEADER_SHORTCUTS_OFFSET = 32;
+    const size_t HEADER_STRINGS_OFFSET = 40;
+    const size_t HEADER_FILE_SIZE = 48;
+    const size_t HEADER_CHECKSUM = 56;
+    
+    // Tab record: name ref, folder ref, first shortcut, shortcut count
+    const size_t TAB_NAME = 0;
+    const size_t TAB_FOLDER_PATH = 8;
+    const size_t TAB_FIRST_SHORTCUT = 16;
+    const size_t TAB_SHORTCUT_COUNT = 20;
+    
+    // Shortcut record: six string refs, then icon index, flags and the manifest
+    const size_t SHORTCUT_ICON_INDEX = 48;
+    const size_t SHORTCUT_FLAGS = 52;
+    const size_t SHORTCUT_FILE_SIZE = 56;
+    const size_t SHORTCUT_LAST_WRITE_TIME = 64;
+    const size_t SHORTCUT_CONTENT_HASH = 72;
+    
+    const uint32_t SHORTCUT_FLAG_VALID = 0x00000001;
+    
+    uint16_t ReadU16(const uint8_t* p) {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+    
+    uint32_t ReadU32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+    
+    uint64_t ReadU64(const uint8_t* p) {
+        return static_cast<uint64_t>(ReadU32(p)) | (static_cast<uint64_t>(ReadU32(p + 4)) << 32);
+    }
+    
+    void WriteU32(uint8_t* p, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            p[i] = static_cast<uint8_t>(value >> (i * 8));
+        }
+    }
+    
+    void WriteU64(uint8_t* p, uint64_t value) {
+        WriteU32(p, static_cast<uint32_t>(value));
+        WriteU32(p + 4, static_cast<uint32_t>(value >> 32));
+    }
+    
+    size_t AlignUp(size_t value) {
+        return (value + 7) & ~static_cast<size_t>(7);
+    }
+    
+    // 64-bit FNV-1a over the whole file except the checksum field itself, so a damaged
+    // count or offset in the header is caught like a damaged record
+    uint64_t Checksum(const uint8_t* data, size_t size) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; i++) {
+            if (i == HEADER_CHECKSUM) {
+                i += 7;
+                continue;
+            }
+            hash ^= data[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+std::wstring CatalogString::ToWString() const {
+    std::wstring result;
+    result.resize(length);
+    
+    for (uint32_t i = 0; i < length; i++) {
+        result[i] = static_cast<wchar_t>(ReadU16(data + i * 2));
+    }
+    
+    return result;
+}
+
+ShortcutCatalog::ShortcutCatalog()
+    : base(nullptr)
+    , tabCount(0)
+    , shortcutCount(0)
+    , tabRecords(nullptr)
+    , shortcutRecords(nullptr)
+    , strings(nullptr)
+    , stringUnits(0)
+{
+}
+
+bool ShortcutCatalog::Open(const uint8_t* data, size_t size) {
+    base = nullptr;
+    
+    // Validate the header
+    if (!data || size < HEADER_SIZE ||
+        ReadU32(data + HEADER_MAGIC) != MAGIC ||
+        ReadU32(data + HEADER_VERSION) != VERSION ||
+        ReadU32(data + HEADER_HEADER_SIZE) != HEADER_SIZE ||
+        ReadU64(data + HEADER_FILE_SIZE) != size) {
+        return false;
+    }
+    
+    uint64_t tabCount64 = ReadU32(data + HEADER_TAB_COUNT);
+    uint64_t shortcutCount64 = ReadU32(data + HEADER_SHORTCUT_COUNT);
+    uint64_t stringUnits64 = ReadU32(data + HEADER_STRING_UNITS);
+    uint64_t tabsOffset = ReadU64(data + HEADER_TABS_OFFSET);
+    uint64_t shortcutsOffset = ReadU64(data + HEADER_SHORTCUTS_OFFSET);
+    uint64_t stringsOffset = ReadU64(data + HEADER_STRINGS_OFFSET);
+    
+    // Every section must lie inside the file (counts are 32-bit, so these can't overflow)
+    if (tabsOffset < HEADER_SIZE || tabsOffset + tabCount64 * TAB_RECORD_SIZE > size ||
+        shortcutsOffset < HEADER_SIZE || shortcutsOffset + shortcutCount64 * SHORTCUT_RECORD_SIZE > size ||
+        stringsOffset < HEADER_SIZE || stringsOffset + stringUnits64 * 2 > size) {
+        return false;
+    }
+    
+    // A truncated or partially written file fails here
+    if (Checksum(data, size) != ReadU64(data + HEADER_CHECKSUM)) {
+        return false;
+    }
+    
+    tabCount = static_cast<uint32_t>(tabCount64);
+    shortcutCount = static_cast<uint32_t>(shortcutCount64);
+    stringUnits = static_cast<uint32_t>(stringUnits64);
+    tabRecords = data + tabsOffset;
+    shortcutRecords = data + shortcutsOffset;
+    strings = data + stringsOffset;
+    
+    // Check every reference once so the accessors don't have to
+    auto validString = [this](const uint8_t* ref) {
+        uint64_t offset = ReadU32(ref);
+        uint64_t length = ReadU32(ref + 4);
+        return offset + length <= stringUnits;
+    };
+    
+    for (uint32_t i = 0; i < tabCount; i++) {
+        const uint8_t* record = tabRecords + i * TAB_RECORD_SIZE;
+        uint64_t first = ReadU32(record + TAB_FIRST_SHORTCUT);
+        uint64_t count = ReadU32(record + TAB_SHORTCUT_COUNT);
+        if (!validString(record + TAB_NAME) || !validString(record + TAB_FOLDER_PATH) ||
+            first + count > shortcutCount) {
+            return false;
+        }
+    }
+    
+    for (uint32_t i = 0; i < shortcutCount; i++) {
+        const uint8_t* record = shortcutRecords + i * SHORTCUT_RECORD_SIZE;
+        for (size_t field = 0; field < SHORTCUT_STRING_COUNT; field++) {
+            if (!validString(record + field * 8)) {
+                return false;
+            }
+        }
+    }
+    
+    base = data;
+    return true;
+}
+
+CatalogTabView ShortcutCatalog::GetTab(uint32_t index) const {
+    CatalogTabView tab;
+    if (!base || index >= tabCount) {
+        return tab;
+    }
+    
+    const uint8_t* record = tabRecords + index * TAB_RECORD_SIZE;
+    tab.name = GetString(record, TAB_NAME);
+    tab.folderPath = GetString(record, TAB_FOLDER_PATH);
+    tab.firstShortcut = ReadU32(record + TAB_FIRST_SHORTCUT);
+    tab.shortcutCount = ReadU32(record + TAB_SHORTCUT_COUNT);
+    return tab;
+}
+
+CatalogShortcutView ShortcutCatalog::GetShortcut(uint32_t index) const {
+    CatalogShortcutView shortcut;
+    if (!base || index >= shortcutCount) {
+        return shortcut;
+    }
+    
+    const uint8_t* record = shortcutRecords + index * SHORTCUT_RECORD_SIZE;
+    shortcut.shortcutPath = GetString(record, 0);
+    shortcut.displayName = GetString(record, 8);
+    shortcut.targetPath = GetString(record, 16);
+    shortcut.arguments = GetString(record, 24);
+    shortcut.workingDirectory = GetString(record, 32);
+    shortcut.iconPath = GetString(record, 40);
+    shortcut.iconIndex = static_cast<int32_t>(ReadU32(record + SHORTCUT_ICON_INDEX));
+    shortcut.isValid = (ReadU32(record + SHORTCUT_FLAGS) & SHORTCUT_FLAG_VALID) != 0;
+    shortcut.fileSize = ReadU64(record + SHORTCUT_FILE_SIZE);
+    shortcut.lastWriteTime = ReadU64(record + SHORTCUT_LAST_WRITE_TIME);
+    shortcut.contentHash = ReadU64(record + SHORTCUT_CONTENT_HASH);
+    return shortcut;
+}
+
+CatalogString ShortcutCatalog::GetString(const uint8_t* record, size_t fieldOffset) const {
+    CatalogString str;
+    str.data = strings + static_cast<size_t>(ReadU32(record + fieldOffset)) * 2;
+    str.length = ReadU32(record + fieldOffset + 4);
+    return str;
+}
+
+CatalogWriter::CatalogWriter() {
+}
+
+void CatalogWriter::AddTab(const std::wstring& name, const std::wstring& folderPath) {
+    TabEntry tab;
+    tab.name = AddString(name);
+    tab.folderPath = AddString(folderPath);
+    tab.firstShortcut = static_cast<uint32_t>(shortcuts.size());
+    tab.shortcutCount = 0;
+    tabs.push_back(tab);
+}
+
+void CatalogWriter::AddShortcut(const CatalogShortcut& shortcut) {
+    ShortcutEntry entry;
+    entry.strings[0] = AddString(shortcut.shortcutPath);
+    entry.strings[1] = AddString(shortcut.displayName);
+    entry.strings[2] = AddString(shortcut.targetPath);
+    entry.strings[3] = AddString(shortcut.arguments);
+    entry.strings[4] = AddString(shortcut.workingDirectory);
+    entry.strings[5] = AddString(shortcut.iconPath);
+    entry.iconIndex = shortcut.iconIndex;
+    entry.flags = shortcut.isValid ? SHORTCUT_FLAG_VALID : 0;
+    entry.fileSize = shortcut.fileSize;
+    entry.lastWriteTime = shortcut.lastWriteTime;
+    entry.contentHash = shortcut.contentHash;
+    shortcuts.push_back(entry);
+    
+    if (!tabs.empty()) {
+        tabs.back().shortcutCount++;
+    }
+}
+
+std::vector<uint8_t> CatalogWriter::Finish() const {
+    size_t tabsOffset = HEADER_SIZE;
+    size_t shortcutsOffset = AlignUp(tabsOffset + tabs.size() * TAB_RECORD_SIZE);
+    size_t stringsOffset = AlignUp(shortcutsOffset + shortcuts.size() * SHORTCUT_RECORD_SIZE);
+    size_t fileSize = AlignUp(stringsOffset + stringTable.size() * 2);
+    
+    std::vector<uint8_t> file(fileSize, 0);
+    uint8_t* data = file.data();
+    
+    for (size_t i = 0; i < tabs.size(); i++) {
+        uint8_t* record = data + tabsOffset + i * TAB_RECORD_SIZE;
+        WriteU32(record + TAB_NAME, tabs[i].name.offset);
+        WriteU32(record + TAB_NAME + 4, tabs[i].name.length);
+        WriteU32(record + TAB_FOLDER_PATH, tabs[i].folderPath.offset);
+        WriteU32(record + TAB_FOLDER_PATH + 4, tabs[i].folderPath.length);
+        WriteU32(record + TAB_FIRST_SHORTCUT, tabs[i].firstShortcut);
+        WriteU32(record + TAB_SHORTCUT_COUNT, tabs[i].shortcutCount);
+    }
+    
+    for (size_t i = 0; i < shortcuts.size(); i++) {
+        const ShortcutEntry& entry = shortcuts[i];
+        uint8_t* record = data + shortcutsOffset + i * SHORTCUT_RECORD_SIZE;
+        for (size_t field = 0; field < SHORTCUT_STRING_COUNT; field++) {
+            WriteU32(record + field * 8, entry.strings[field].offset);
+            WriteU32(record + field * 8 + 4, entry.strings[field].length);
+        }
+        WriteU32(record + SHORTCUT_ICON_INDEX, static_cast<uint32_t>(entry.iconIndex));
+        WriteU32(record + SHORTCUT_FLAGS, entry.flags);
+        WriteU64(record + SHORTCUT_FILE_SIZE, entry.fileSize);
+        WriteU64(record + SHORTCUT_LAST_WRITE_TIME, entry.lastWriteTime);
+        WriteU64(record + SHORTCUT_CONTENT_HASH, entry.contentHash);
+    }
+    
+    for (size_t i = 0; i < stringTable.size(); i++) {
+        data[stringsOffset + i * 2] = static_cast<uint8_t>(stringTable[i]);
+        data[stringsOffset + i * 2 + 1] = static_cast<uint8_t>(stringTable[i] >> 8);
+    }
+    
+    // Header last, with the checksum over everything else
+    WriteU32(data + HEADER_MAGIC, ShortcutCatalog::MAGIC);
+    WriteU32(data + HEADER_VERSION, ShortcutCatalog::VERSION);
+    WriteU32(data + HEADER_HEADER_SIZE, static_cast<uint32_t>(HEADER_SIZE));
+    WriteU32(data + HEADER_TAB_COUNT, static_cast<uint32_t>(tabs.size()));
+    WriteU32(data + HEADER_SHORTCUT_COUNT, static_cast<uint32_t>(shortcuts.size()));
+    WriteU32(data + HEADER_STRING_UNITS, static_cast<uint32_t>(stringTable.size()));
+    WriteU64(data + HEADER_TABS_OFFSET, tabsOffset);
+    WriteU64(data + HEADER_SHORTCUTS_OFFSET, shortcutsOffset);
+    WriteU64(data + HEADER_STRINGS_OFFSET, stringsOffset);
+    WriteU64(data + HEADER_FILE_SIZE, fileSize);
+    WriteU64(data + HEADER_CHECKSUM, Checksum(data, fileSize));
+    
+    return file;
+}
+
+CatalogWriter::StringRef CatalogWriter::AddString(const std::wstring& str) {
+    auto it = stringLookup.find(str);
+    if (it != stringLookup.end()) {
+        return it->second;
+    }
+    
+    StringRef ref;
+    ref.offset = static_cast<uint32_t>(stringTable.size());
+    ref.length = static_cast<uint32_t>(str.length());
+    for (wchar_t ch : str) {
+        stringTable.push_back(static_cast<uint16_t>(ch));
+    }
+    
+    stringLookup.emplace(str, ref);
+    return ref;
+}
@@ -0,0 +1,129 @@
+// ShortcutCatalog.h - Versioned binary catalog of the tab/shortcut model (portable, no Win32)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Non-owning view of a UTF-16 string in the catalog's string table
+struct CatalogString {
+    const uint8_t* data = nullptr;  // UTF-16LE, points into the catalog buffer
+    uint32_t length = 0;            // Length in UTF-16 code units
+    
+    bool empty() const { return length == 0; }
+    std::wstring ToWString() const;
+};
+
+// A shortcut as read from the catalog. Strings reference the catalog buffer,
+// so the buffer (or mapping) must outlive this structure.
+struct CatalogShortcutView {
+    CatalogString shortcutPath;
+    CatalogString displayName;
+    CatalogString targetPath;
+    CatalogString arguments;
+    CatalogString workingDirectory;
+    CatalogString iconPath;        // Icon reference: custom icon file, or empty for the target's icon
+    int32_t iconIndex = 0;
+    bool isValid = false;
+    
+    // Change-detection manifest for the .lnk file
+    uint64_t fileSize = 0;
+    uint64_t lastWriteTime = 0;
+    uint64_t contentHash = 0;
+};
+
+struct CatalogTabView {
+    CatalogString name;
+    CatalogString folderPath;
+    uint32_t firstShortcut = 0;    // Index of the tab's first shortcut
+    uint32_t shortcutCount = 0;    // Shortcuts [firstShortcut, firstShortcut + shortcutCount)
+};
+
+// A shortcut as handed to the writer
+struct CatalogShortcut {
+    std::wstring shortcutPath;
+    std::wstring displayName;
+    std::wstring targetPath;
+    std::wstring arguments;
+    std::wstring workingDirectory;
+    std::wstring iconPath;
+    int32_t iconIndex = 0;
+    bool isValid = false;
+    uint64_t fileSize = 0;
+    uint64_t lastWriteTime = 0;
+    uint64_t contentHash = 0;
+};
+
+// Reads a catalog in place. The whole file is validated by Open (bounds and checksum),
+// after which every accessor is a direct read from the buffer. Fields are little-endian
+// and read byte-wise, so the buffer needs no particular alignment.
+class ShortcutCatalog {
+public:
+    static const uint32_t MAGIC = 0x54434C47; // "GLCT"
+    static const uint32_t VERSION = 2;    // 2: checksum covers the header
+    
+    ShortcutCatalog();
+    
+    bool Open(const uint8_t* data, size_t size);
+    bool IsOpen() const { return base != nullptr; }
+    
+    uint32_t GetTabCount() const { return tabCount; }
+    uint32_t GetShortcutCount() const { return shortcutCount; }
+    CatalogTabView GetTab(uint32_t index) const;
+    CatalogShortcutView GetShortcut(uint32_t index) const;
+
+private:
+    const uint8_t* base;
+    uint32_t tabCount;
+    uint32_t shortcutCount;
+    const uint8_t* tabRecords;
+    const uint8_t* shortcutRecords;
+    const uint8_t* strings;
+    uint32_t stringUnits;
+    
+    CatalogString GetString(const uint8_t* record, size_t fieldOffset) const;
+};
+
+// Builds a catalog file in memory. Identical strings are stored once.
+class CatalogWriter {
+public:
+    CatalogWriter();
+    
+    // Shortcuts added after AddTab belong to that tab
+    void AddTab(const std::wstring& name, const std::wstring& folderPath);
+    void AddShortcut(const CatalogShortcut& shortcut);
+    
+    // Serialize everything added so far into a complete catalog file
+    std::vector<uint8_t> Finish() const;
+
+private:
+    struct StringRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+    
+    struct TabEntry {
+        StringRef name;
+        StringRef folderPath;
+        uint32_t firstShortcut;
+        uint32_t shortcutCount;
+    };
+    
+    struct ShortcutEntry {
+        StringRef strings[6];
+        int32_t iconIndex;
+        uint32_t flags;
+        uint64_t fileSize;
+        uint64_t lastWriteTime;
+        uint64_t contentHash;
+    };
+    
+    std::vector<TabEntry> tabs;
+    std::vector<ShortcutEntry> shortcuts;
+    std::vector<uint16_t> stringTable;
+    std::unordered_map<std::wstring, StringRef> stringLookup;
+    
+    StringRef AddString(const std::wstring& str);
+};
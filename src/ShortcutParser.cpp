@@ -1,87 +1,43 @@
 // ShortcutParser.cpp - Windows shortcut (.lnk) file parser implementation
 #include "ShortcutParser.h"
-#include <comdef.h>
-#include <filesystem>
+#include "ShellLinkReader.h"
 
-ShortcutParser::ShortcutParser() 
-    : comInitialized(false)
-    , shellLink(nullptr)
-    , persistFile(nullptr)
-{
+ShortcutParser::ShortcutParser() {
 }
 
 ShortcutParser::~ShortcutParser() {
-    Cleanup();
-}
-
-bool ShortcutParser::Initialize() {
-    if (!InitializeCOM()) {
-        return false;
-    }
-    
-    if (!CreateShellLinkInterface()) {
-        CleanupCOM();
-        return false;
-    }
-    
-    return true;
-}
-
-void ShortcutParser::Cleanup() {
-    ReleaseShellLinkInterface();
-    CleanupCOM();
 }
 
 bool ShortcutParser::ParseShortcut(const std::wstring& shortcutPath, ShortcutInfo& info) {
-    if (!shellLink || !persistFile) {
-        return false;
-    }
-    
-    // Check if shortcut file exists
-    if (!FileExists(shortcutPath)) {
+    // Read the whole shortcut in a single call (also fails if the file doesn't exist)
+    if (!ReadShortcutFile(shortcutPath)) {
         return false;
     }
     
-    // Load the shortcut file
-    HRESULT hr = persistFile->Load(shortcutPath.c_str(), STGM_READ);
-    if (FAILED(hr)) {
+    // Parse the [MS-SHLLINK] structures directly from the buffer
+    ShellLinkData link;
+    if (!ShellLinkReader::Parse(readBuffer.data(), readBuffer.size(), link)) {
         return false;
     }
-    
-    // Resolve the shortcut to get the target
-    hr = shellLink->Resolve(nullptr, SLR_NO_UI | SLR_NOSEARCH);
-    if (FAILED(hr)) {
-        // Continue anyway - we might still get some information
-    }
-    
+
     // Get target path
-    wchar_t targetPath[MAX_PATH] = {0};
-    hr = shellLink->GetPath(targetPath, MAX_PATH, nullptr, SLGP_UNCPRIORITY);
-    if (SUCCEEDED(hr) && wcslen(targetPath) > 0) {
-        info.targetPath = targetPath;
-    }
-    
-    // Get arguments
-    wchar_t arguments[MAX_PATH] = {0};
-    hr = shellLink->GetArguments(arguments, MAX_PATH);
-    if (SUCCEEDED(hr)) {
-        info.arguments = arguments;
-    }
-    
-    // Get working directory
-    wchar_t workingDir[MAX_PATH] = {0};
-    hr = shellLink->GetWorkingDirectory(workingDir, MAX_PATH);
-    if (SUCCEEDED(hr)) {
-        info.workingDirectory = workingDir;
+    info.targetPath = ResolveTargetPath(link, shortcutPath);
+
+    // Get arguments and working directory
+    info.arguments = ToWideString(link.arguments);
+    info.workingDirectory = ToWideString(link.workingDirectory);
+    
+    // Get icon location - the environment block holds the portable (unexpanded) form
+    std::wstring iconPath;
+    if ((link.linkFlags & ShellLinkReader::HAS_EXP_ICON) && !link.iconEnvironmentPath.empty()) {
+        iconPath = ToWideString(link.iconEnvironmentPath);
+    } else {
+        iconPath = ToWideString(link.iconLocation);
     }
     
-    // Get icon location
-    wchar_t iconPath[MAX_PATH] = {0};
-    int iconIndex = 0;
-    hr = shellLink->GetIconLocation(iconPath, MAX_PATH, &iconIndex);
-    if (SUCCEEDED(hr) && wcslen(iconPath) > 0) {
-        info.iconPath = iconPath;
-        info.iconIndex = iconIndex;
+    if (!iconPath.empty()) {
+        info.iconPath = ExpandEnvironment(iconPath);
+        info.iconIndex = link.iconIndex;
     } else {
         // If no specific icon, leave iconPath empty so we extract from target executable
         info.iconPath.clear();
@@ -103,68 +59,104 @@ bool ShortcutParser::ParseShortcut(const std::wstring& shortcutPath, ShortcutInf
     return true;
 }
 
-bool ShortcutParser::InitializeCOM() {
-    if (comInitialized) {
-        return true;
+bool ShortcutParser::ReadShortcutFile(const std::wstring& path) {
+    HANDLE file = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
     }
     
-    HRESULT hr = CoInitialize(nullptr);
-    if (SUCCEEDED(hr)) {
-        comInitialized = true;
-        return true;
-    }
+    LARGE_INTEGER fileSize = {};
+    bool success = GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0 && fileSize.QuadPart <= MAX_SHORTCUT_FILE_SIZE;
     
-    // COM might already be initialized by the main application
-    if (hr == RPC_E_CHANGED_MODE) {
-        comInitialized = false; // Don't call CoUninitialize in this case
-        return true;
+    if (success) {
+        DWORD size = static_cast<DWORD>(fileSize.QuadPart);
+        DWORD bytesRead = 0;
+        readBuffer.resize(size);
+        success = ReadFile(file, readBuffer.data(), size, &bytesRead, nullptr) && bytesRead == size;
     }
     
-    return false;
+    CloseHandle(file);
+    return success;
 }
 
-void ShortcutParser::CleanupCOM() {
-    if (comInitialized) {
-        CoUninitialize();
-        comInitialized = false;
-    }
+std::wstring ShortcutParser::ResolveTargetPath(const ShellLinkData& link, const std::wstring& shortcutPath) {
+    // 1. Environment-variable target (e.g. %ProgramFiles%\Game\game.exe)
+    if ((link.linkFlags & ShellLinkReader::HAS_EXP_STRING) && !link.environmentTarget.empty()) {
+        std::wstring expanded = ExpandEnvironment(ToWideString(link.environmentTarget));
+        if (!expanded.empty()) {
+            return expanded;
+        }
+    }
+    
+    // 2. LinkInfo - UNC path takes priority (matches SLGP_UNCPRIORITY), then local path
+    std::wstring suffix = ToWideString(link.commonPathSuffix);
+    if (!link.netName.empty()) {
+        std::wstring netPath = ToWideString(link.netName);
+        if (!suffix.empty() && netPath.back() != L'\\') {
+            netPath += L'\\';
+        }
+        return netPath + suffix;
+    }
+    
+    if (!link.localBasePath.empty()) {
+        return ToWideString(link.localBasePath) + suffix;
+    }
+    
+    // 3. Relative path, resolved against the folder containing the shortcut
+    if (!link.relativePath.empty()) {
+        std::wstring shortcutFolder;
+        size_t lastSlash = shortcutPath.find_last_of(L"\\/");
+        if (lastSlash != std::wstring::npos) {
+            shortcutFolder = shortcutPath.substr(0, lastSlash + 1);
+        }
+        
+        std::wstring combined = shortcutFolder + ToWideString(link.relativePath);
+        wchar_t fullPath[MAX_PATH] = {0};
+        if (GetFullPathName(combined.c_str(), MAX_PATH, fullPath, nullptr) > 0) {
+            return fullPath;
+        }
+        return combined;
+    }
+    
+    return std::wstring();
 }
 
-bool ShortcutParser::CreateShellLinkInterface() {
-    // Create IShellLink interface
-    HRESULT hr = CoCreateInstance(
-        CLSID_ShellLink,
-        nullptr,
-        CLSCTX_INPROC_SERVER,
-        IID_IShellLink,
-        reinterpret_cast<void**>(&shellLink)
-    );
-    
-    if (FAILED(hr)) {
-        return false;
+std::wstring ShortcutParser::ToWideString(const LnkString& str) {
+    if (str.empty()) {
+        return std::wstring();
     }
     
-    // Get IPersistFile interface
-    hr = shellLink->QueryInterface(IID_IPersistFile, reinterpret_cast<void**>(&persistFile));
-    if (FAILED(hr)) {
-        shellLink->Release();
-        shellLink = nullptr;
-        return false;
+    if (str.unicode) {
+        // UTF-16LE is the native wchar_t layout on Windows
+        std::wstring result(str.length, L'\0');
+        memcpy(&result[0], str.data, str.length * sizeof(wchar_t));
+        return result;
     }
     
-    return true;
+    // Non-unicode strings are stored in the system default code page
+    int chars = MultiByteToWideChar(CP_ACP, 0, reinterpret_cast<const char*>(str.data), static_cast<int>(str.length), nullptr, 0);
+    if (chars <= 0) {
+        return str.ToWString();
+    }
+    
+    std::wstring result(chars, L'\0');
+    MultiByteToWideChar(CP_ACP, 0, reinterpret_cast<const char*>(str.data), static_cast<int>(str.length), &result[0], chars);
+    return result;
 }
 
-void ShortcutParser::ReleaseShellLinkInterface() {
-    if (persistFile) {
-        persistFile->Release();
-        persistFile = nullptr;
+std::wstring ShortcutParser::ExpandEnvironment(const std::wstring& str) {
+    if (str.find(L'%') == std::wstring::npos) {
+        return str;
     }
     
-    if (shellLink) {
-        shellLink->Release();
-        shellLink = nullptr;
+    wchar_t expanded[MAX_PATH] = {0};
+    DWORD length = ExpandEnvironmentStrings(str.c_str(), expanded, MAX_PATH);
+    if (length == 0 || length > MAX_PATH) {
+        return str;
     }
+    
+    return expanded;
 }
 
 std::wstring ShortcutParser::GetFileNameFromPath(const std::wstring& path) {
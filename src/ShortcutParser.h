@@ -2,29 +2,35 @@
 #pragma once
 
 #include <windows.h>
-#include <shlobj.h>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include "DataModels.h"
 
+struct LnkString;
+struct ShellLinkData;
+
 class ShortcutParser {
 public:
     ShortcutParser();
     ~ShortcutParser();
 
-    bool Initialize();
-    void Cleanup();
     bool ParseShortcut(const std::wstring& shortcutPath, ShortcutInfo& info);
+    
+    // Raw bytes of the last shortcut read by ParseShortcut (valid until the next call)
+    const std::vector<uint8_t>& GetFileData() const { return readBuffer; }
 
 private:
-    bool comInitialized;
-    IShellLink* shellLink;
-    IPersistFile* persistFile;
+    std::vector<uint8_t> readBuffer; // Reused between calls to avoid per-file allocations
     
-    bool InitializeCOM();
-    void CleanupCOM();
-    bool CreateShellLinkInterface();
-    void ReleaseShellLinkInterface();
+    bool ReadShortcutFile(const std::wstring& path);
+    std::wstring ResolveTargetPath(const ShellLinkData& link, const std::wstring& shortcutPath);
+    std::wstring ToWideString(const LnkString& str);
+    std::wstring ExpandEnvironment(const std::wstring& str);
     
     std::wstring GetFileNameFromPath(const std::wstring& path);
     bool FileExists(const std::wstring& path);
+    
+    // Upper bound for .lnk files - real shortcuts are a few KB
+    static const DWORD MAX_SHORTCUT_FILE_SIZE = 1024 * 1024;
 };
\ No newline at end of file
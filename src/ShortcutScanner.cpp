@@ -3,66 +3,81 @@
 #include "ShortcutParser.h"
 #include "IconExtractor.h"
 #include "Settings.h"
+#include "WorkerPool.h"
+#include "ShortcutCatalog.h"
 #include "stb_image_resize2.h"
 #include <filesystem>
 #include <algorithm>
 
 ShortcutScanner::ShortcutScanner() 
     : lastScanCount(0)
+    , lastProcessedCount(0)
 {
 }
 
 ShortcutScanner::~ShortcutScanner() {
+    WaitForValidation();
 }
 
-bool ShortcutScanner::Initialize(const std::wstring& folderPath) {
-    // Create parser and icon extractor
-    parser = std::make_unique<ShortcutParser>();
+bool ShortcutScanner::Initialize(const std::wstring& folderPath, const std::wstring& catalogFilePath,
+                                 const std::wstring& iconCacheFilePath) {
+    // Create the worker pool and one parser per worker, plus a shared icon extractor
+    workerPool = std::make_unique<WorkerPool>();
+    parsers.clear();
+    for (size_t i = 0; i < workerPool->GetWorkerCount(); i++) {
+        parsers.push_back(std::make_unique<ShortcutParser>());
+    }
     iconExtractor = std::make_unique<IconExtractor>();
     
-    // Initialize parser
-    if (!parser->Initialize()) {
-        return false;
+    // Thumbnails persist across runs; without a cache file every icon is extracted
+    if (!iconCacheFilePath.empty()) {
+        iconCache = std::make_unique<IconCache>();
+        uint64_t maxSize = static_cast<uint64_t>(Settings::Instance().GetIconCacheMaxSizeMB()) * 1024 * 1024;
+        if (!iconCache->Open(iconCacheFilePath, maxSize)) {
+            iconCache.reset();
+        }
     }
-    
-    // Clear icon cache to ensure fresh extraction
-    iconExtractor->ClearCache();
 
     scanFolder = folderPath;
+    catalogPath = catalogFilePath;
     return true;
 }
 
 std::vector<ShortcutInfo> ShortcutScanner::ScanShortcuts() {
     std::vector<ShortcutInfo> shortcuts;
     lastScanCount = 0;
+    lastProcessedCount = 0;
     
     if (scanFolder.empty()) {
         return shortcuts;
     }
     
-    // Find all .lnk files in the folder
-    std::vector<std::wstring> shortcutFiles = FindShortcutFiles();
-    
-    // Process each shortcut file
-    for (const auto& filePath : shortcutFiles) {
-        ShortcutInfo info;
-        
-        if (ProcessShortcutFile(filePath, info)) {
-            shortcuts.emplace_back(std::move(info));
-            lastScanCount++;
-        }
-    }
+    // Find all .lnk files in the folder and process them on the worker pool
+    std::vector<std::vector<ShortcutFile>> fileLists(1, FindShortcutFiles(scanFolder));
+    shortcuts = std::move(ProcessShortcutFiles(fileLists, nullptr)[0]);
+    lastScanCount = shortcuts.size();
     
     return shortcuts;
 }
 
 std::vector<TabInfo> ShortcutScanner::ScanTabs() {
+    // Full scan - forget everything processed before
+    manifest.clear();
+    return BuildTabs(nullptr);
+}
+
+std::vector<TabInfo> ShortcutScanner::RescanTabs(std::vector<TabInfo>& previousTabs) {
+    return BuildTabs(&previousTabs);
+}
+
+std::vector<TabInfo> ShortcutScanner::BuildTabs(std::vector<TabInfo>* previousTabs) {
     std::vector<TabInfo> tabs;
+    lastScanCount = 0;
+    lastProcessedCount = 0;
+    size_t previousManifestSize = manifest.size();
     
-    // Clear icon cache to force fresh extraction for debugging
-    if (iconExtractor) {
-        iconExtractor->ClearCache();
-    }
+    // The validation thread enumerates the same folders - let it finish first
+    WaitForValidation();
     
     if (scanFolder.empty()) {
         return tabs;
@@ -75,41 +90,225 @@ std::vector<TabInfo> ShortcutScanner::ScanTabs() {
         return tabs;
     }
     
-    // First, add a tab for root folder shortcuts (if any exist)
+    // Stage 1: enumerate - the root folder becomes the "All" tab, then one tab per subfolder
+    std::vector<std::wstring> folders;
+    folders.push_back(scanFolder);
+    
+    std::vector<std::wstring> subfolders = FindSubfolders();
+    folders.insert(folders.end(), subfolders.begin(), subfolders.end());
+    
+    std::vector<std::vector<ShortcutFile>> fileLists(folders.size());
+    workerPool->ParallelFor(folders.size(), [&](size_t index, size_t /*worker*/) {
+        fileLists[index] = FindShortcutFiles(folders[index]);
+    });
     
-    std::vector<ShortcutInfo> rootShortcuts = ScanFolderForShortcuts(scanFolder);
+    // Stages 2-4: parse, decode and resample every new or changed shortcut in parallel
+    std::vector<std::vector<ShortcutInfo>> folderShortcuts = ProcessShortcutFiles(fileLists, previousTabs);
     
-    if (!rootShortcuts.empty()) {
-        TabInfo rootTab;
-        rootTab.name = L"All";  // Generic name for root folder
-        rootTab.folderPath = scanFolder;
-        rootTab.shortcuts = std::move(rootShortcuts);
-        tabs.emplace_back(std::move(rootTab));
+    // Create a tab for each folder that contains shortcuts, in the enumeration order
+    for (size_t i = 0; i < folders.size(); i++) {
+        if (folderShortcuts[i].empty()) {
+            continue;
+        }
+        
+        TabInfo tab;
+        if (i == 0) {
+            tab.name = L"All";  // Generic name for root folder
+        } else {
+            // Extract folder name from path
+            std::filesystem::path path(folders[i]);
+            tab.name = path.filename().wstring();
+        }
+        tab.folderPath = folders[i];
+        tab.shortcuts = std::move(folderShortcuts[i]);
+        lastScanCount += tab.shortcuts.size();
+        
+        tabs.emplace_back(std::move(tab));
     }
     
-    // Find all subfolders
-    std::vector<std::wstring> subfolders = FindSubfolders();
+    // Keep the catalog in step with the model for the next cold start
+    if (lastProcessedCount > 0 || manifest.size() != previousManifestSize) {
+        SaveCatalog(tabs);
+    }
     
-    // Create a tab for each subfolder that contains shortcuts
-    for (const auto& folderPath : subfolders) {
-        std::vector<ShortcutInfo> folderShortcuts = ScanFolderForShortcuts(folderPath);
+    return tabs;
+}
+
+std::vector<TabInfo> ShortcutScanner::LoadCatalog() {
+    std::vector<TabInfo> tabs;
+    lastScanCount = 0;
+    lastProcessedCount = 0;
+    
+    if (catalogPath.empty()) {
+        return tabs;
+    }
+    
+    HANDLE file = CreateFile(catalogPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return tabs;
+    }
+    
+    LARGE_INTEGER fileSize = {};
+    HANDLE mapping = nullptr;
+    const uint8_t* view = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            view = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+    
+    // Build the model straight from the mapped records
+    ShortcutCatalog catalog;
+    if (view && catalog.Open(view, static_cast<size_t>(fileSize.QuadPart))) {
+        manifest.clear();
+        tabs.reserve(catalog.GetTabCount());
         
-        if (!folderShortcuts.empty()) {
+        for (uint32_t t = 0; t < catalog.GetTabCount(); t++) {
+            CatalogTabView tabView = catalog.GetTab(t);
             TabInfo tab;
+            tab.name = tabView.name.ToWString();
+            tab.folderPath = tabView.folderPath.ToWString();
+            tab.shortcuts.resize(tabView.shortcutCount);
             
-            // Extract folder name from path
-            std::filesystem::path path(folderPath);
-            tab.name = path.filename().wstring();
-            tab.folderPath = folderPath;
-            tab.shortcuts = std::move(folderShortcuts);
+            for (uint32_t i = 0; i < tabView.shortcutCount; i++) {
+                CatalogShortcutView shortcutView = catalog.GetShortcut(tabView.firstShortcut + i);
+                ShortcutInfo& info = tab.shortcuts[i];
+                info.shortcutPath = shortcutView.shortcutPath.ToWString();
+                info.displayName = shortcutView.displayName.ToWString();
+                info.targetPath = shortcutView.targetPath.ToWString();
+                info.arguments = shortcutView.arguments.ToWString();
+                info.workingDirectory = shortcutView.workingDirectory.ToWString();
+                info.iconPath = shortcutView.iconPath.ToWString();
+                info.iconIndex = shortcutView.iconIndex;
+                info.isValid = shortcutView.isValid;
+                
+                manifest[info.shortcutPath] = {shortcutView.fileSize, shortcutView.lastWriteTime, shortcutView.contentHash};
+            }
             
+            lastScanCount += tab.shortcuts.size();
             tabs.emplace_back(std::move(tab));
         }
     }
     
+    if (view) UnmapViewOfFile(view);
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    
+    // Icons are referenced by source path - thumbnail cache hits are one read each, misses are decoded
+    std::vector<ShortcutInfo*> shortcuts;
+    std::vector<IconSourceState*> iconStates;
+    shortcuts.reserve(lastScanCount);
+    iconStates.reserve(lastScanCount);
+    for (TabInfo& tab : tabs) {
+        for (ShortcutInfo& info : tab.shortcuts) {
+            shortcuts.push_back(&info);
+            iconStates.push_back(&manifest[info.shortcutPath].icon);
+        }
+    }
+    
+    workerPool->ParallelFor(shortcuts.size(), [&](size_t index, size_t /*worker*/) {
+        ProcessIcon(*shortcuts[index], *iconStates[index]);
+    });
+    
+    if (iconCache) {
+        iconCache->Flush();
+    }
+    
     return tabs;
 }
 
+void ShortcutScanner::SaveCatalog(const std::vector<TabInfo>& tabs) {
+    if (catalogPath.empty()) {
+        return;
+    }
+    
+    CatalogWriter writer;
+    for (const TabInfo& tab : tabs) {
+        writer.AddTab(tab.name, tab.folderPath);
+        
+        for (const ShortcutInfo& info : tab.shortcuts) {
+            CatalogShortcut shortcut;
+            shortcut.shortcutPath = info.shortcutPath;
+            shortcut.displayName = info.displayName;
+            shortcut.targetPath = info.targetPath;
+            shortcut.arguments = info.arguments;
+            shortcut.workingDirectory = info.workingDirectory;
+            shortcut.iconPath = info.iconPath;
+            shortcut.iconIndex = info.iconIndex;
+            shortcut.isValid = info.isValid;
+            
+            auto entry = manifest.find(info.shortcutPath);
+            if (entry != manifest.end()) {
+                shortcut.fileSize = entry->second.size;
+                shortcut.lastWriteTime = entry->second.lastWriteTime;
+                shortcut.contentHash = entry->second.contentHash;
+            }
+            
+            writer.AddShortcut(shortcut);
+        }
+    }
+    
+    std::vector<uint8_t> data = writer.Finish();
+    
+    // Write to a temporary file and swap it in, so a crash never leaves a half-written catalog
+    std::wstring tempPath = catalogPath + L".tmp";
+    HANDLE file = CreateFile(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    
+    DWORD bytesWritten = 0;
+    bool success = WriteFile(file, data.data(), static_cast<DWORD>(data.size()), &bytesWritten, nullptr) &&
+                   bytesWritten == data.size();
+    CloseHandle(file);
+    
+    if (!success || !MoveFileEx(tempPath.c_str(), catalogPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFile(tempPath.c_str());
+    }
+}
+
+void ShortcutScanner::StartCatalogValidation(HWND notifyWindow, UINT message) {
+    WaitForValidation();
+    
+    // The thread works on a snapshot, so scans on the UI thread never race with it
+    std::unordered_map<std::wstring, ManifestEntry> snapshot = manifest;
+    
+    validationThread = std::thread([this, snapshot = std::move(snapshot), notifyWindow, message]() {
+        std::vector<std::wstring> folders;
+        folders.push_back(scanFolder);
+        
+        std::vector<std::wstring> subfolders = FindSubfolders();
+        folders.insert(folders.end(), subfolders.begin(), subfolders.end());
+        
+        // Same file count and matching size/write time for every file means nothing changed
+        size_t fileCount = 0;
+        bool changed = false;
+        for (size_t i = 0; i < folders.size() && !changed; i++) {
+            for (const ShortcutFile& file : FindShortcutFiles(folders[i])) {
+                auto entry = snapshot.find(file.path);
+                if (entry == snapshot.end() || entry->second.size != file.size ||
+                    entry->second.lastWriteTime != file.lastWriteTime) {
+                    changed = true;
+                    break;
+                }
+                fileCount++;
+            }
+        }
+        
+        if (changed || fileCount != snapshot.size()) {
+            PostMessage(notifyWindow, message, 0, 0);
+        }
+    });
+}
+
+void ShortcutScanner::WaitForValidation() {
+    if (validationThread.joinable()) {
+        validationThread.join();
+    }
+}
+
 std::vector<std::wstring> ShortcutScanner::FindSubfolders() {
     std::vector<std::wstring> subfolders;
     
@@ -139,53 +338,116 @@ std::vector<std::wstring> ShortcutScanner::FindSubfolders() {
     return subfolders;
 }
 
-std::vector<ShortcutInfo> ShortcutScanner::ScanFolderForShortcuts(const std::wstring& folderPath) {
-    std::vector<ShortcutInfo> shortcuts;
-    
-    try {
-        std::filesystem::path scanPath(folderPath);
-        
-        if (!std::filesystem::exists(scanPath)) {
-            return shortcuts;
+std::vector<std::vector<ShortcutInfo>> ShortcutScanner::ProcessShortcutFiles(const std::vector<std::vector<ShortcutFile>>& fileLists,
+                                                                             std::vector<TabInfo>* previousTabs) {
+    // Index the previous results by .lnk path so unchanged shortcuts can be moved over
+    std::unordered_map<std::wstring, ShortcutInfo*> previous;
+    if (previousTabs) {
+        for (TabInfo& tab : *previousTabs) {
+            for (ShortcutInfo& shortcut : tab.shortcuts) {
+                if (!shortcut.shortcutPath.empty()) {
+                    previous[shortcut.shortcutPath] = &shortcut;
+                }
+            }
         }
-        
-        if (!std::filesystem::is_directory(scanPath)) {
-            return shortcuts;
+    }
+    
+    // Each file writes to its own pre-allocated slot, so the result order matches the
+    // sorted file order no matter which worker finishes first
+    std::vector<std::vector<ShortcutInfo>> slots(fileLists.size());
+    std::vector<std::vector<char>> succeeded(fileLists.size());
+    for (size_t list = 0; list < fileLists.size(); list++) {
+        slots[list].resize(fileLists[list].size());
+        succeeded[list].resize(fileLists[list].size(), 0);
+    }
+    
+    // Files whose size and modification time match the manifest are not parsed again; they
+    // still become jobs, because their icon source may have changed. All folders share one
+    // job list so small folders don't leave workers idle.
+    struct ScanJob {
+        size_t list;
+        size_t file;
+        ShortcutInfo* previous;        // Earlier result for this path, if any
+        const ManifestEntry* entry;    // Manifest entry for this path, if any
+        bool unchanged;                // The .lnk matches the manifest; reuse previous
+        uint64_t contentHash;
+        IconSourceState icon;
+    };
+    std::vector<ScanJob> jobs;
+    size_t parsedCount = 0;
+    
+    for (size_t list = 0; list < fileLists.size(); list++) {
+        for (size_t file = 0; file < fileLists[list].size(); file++) {
+            const ShortcutFile& shortcutFile = fileLists[list][file];
+            
+            auto previousIt = previous.find(shortcutFile.path);
+            auto entryIt = manifest.find(shortcutFile.path);
+            ShortcutInfo* previousInfo = previousIt != previous.end() ? previousIt->second : nullptr;
+            const ManifestEntry* entry = entryIt != manifest.end() ? &entryIt->second : nullptr;
+            
+            bool unchanged = previousInfo && entry && entry->size == shortcutFile.size &&
+                             entry->lastWriteTime == shortcutFile.lastWriteTime;
+            jobs.push_back({list, file, previousInfo, entry, unchanged, 0, IconSourceState()});
+            if (!unchanged) {
+                parsedCount++;
+            }
         }
+    }
+    
+    workerPool->ParallelFor(jobs.size(), [&](size_t index, size_t worker) {
+        ScanJob& job = jobs[index];
+        ShortcutInfo& info = slots[job.list][job.file];
         
-        // Find all .lnk files in this specific folder
-        std::vector<std::wstring> shortcutFiles;
-        
-        for (const auto& entry : std::filesystem::directory_iterator(scanPath)) {
-            if (entry.is_regular_file()) {
-                std::wstring filename = entry.path().filename().wstring();
-                std::wstring fullPath = entry.path().wstring();
-                
-                if (IsShortcutFile(filename)) {
-                    shortcutFiles.push_back(fullPath);
-                }
+        // Touched but byte-identical shortcuts are kept like unchanged ones
+        bool kept = job.unchanged;
+        if (job.unchanged) {
+            job.contentHash = job.entry->contentHash;
+        } else {
+            if (!ParseShortcutFile(fileLists[job.list][job.file].path, info, worker, job.contentHash)) {
+                return;
             }
+            kept = job.previous && job.entry && job.entry->contentHash == job.contentHash;
         }
+        if (kept) {
+            info = std::move(*job.previous);
+        }
+        succeeded[job.list][job.file] = 1;
         
-        // Sort files alphabetically
-        std::sort(shortcutFiles.begin(), shortcutFiles.end());
-        
-        // Process each shortcut file
-        for (const auto& filePath : shortcutFiles) {
-            ShortcutInfo info;
-            
-            if (ProcessShortcutFile(filePath, info)) {
-                shortcuts.emplace_back(std::move(info));
+        // A kept bitmap is only good while its icon file and the icon size are the same
+        IconCacheKey key;
+        GetIconSource(info, job.icon, key);
+        if (kept && job.icon == job.entry->icon) {
+            return;
+        }
+        info.SetIconPixels(0, 0, 0);
+        ProcessIcon(info, job.icon);
+    });
+    lastProcessedCount = parsedCount;
+    
+    if (iconCache) {
+        iconCache->Flush();
+    }
+    
+    std::unordered_map<std::wstring, ManifestEntry> newManifest;
+    for (const ScanJob& job : jobs) {
+        if (succeeded[job.list][job.file]) {
+            const ShortcutFile& shortcutFile = fileLists[job.list][job.file];
+            newManifest[shortcutFile.path] = {shortcutFile.size, shortcutFile.lastWriteTime, job.contentHash, job.icon};
+        }
+    }
+    manifest = std::move(newManifest);
+    
+    // Drop shortcuts that failed to parse, preserving order
+    std::vector<std::vector<ShortcutInfo>> results(fileLists.size());
+    for (size_t list = 0; list < fileLists.size(); list++) {
+        for (size_t file = 0; file < slots[list].size(); file++) {
+            if (succeeded[list][file]) {
+                results[list].emplace_back(std::move(slots[list][file]));
             }
         }
-        
-    } catch (const std::filesystem::filesystem_error&) {
-        // Ignore filesystem errors
-    } catch (const std::exception&) {
-        // Ignore errors
     }
     
-    return shortcuts;
+    return results;
 }
 
 bool ShortcutScanner::IsShortcutFile(const std::wstring& filename) {
@@ -199,11 +461,11 @@ bool ShortcutScanner::IsShortcutFile(const std::wstring& filename) {
     return extension == L".lnk";
 }
 
-std::vector<std::wstring> ShortcutScanner::FindShortcutFiles() {
-    std::vector<std::wstring> shortcutFiles;
+std::vector<ShortcutScanner::ShortcutFile> ShortcutScanner::FindShortcutFiles(const std::wstring& folderPath) {
+    std::vector<ShortcutFile> shortcutFiles;
     
     try {
-        std::filesystem::path scanPath(scanFolder);
+        std::filesystem::path scanPath(folderPath);
         
         if (!std::filesystem::exists(scanPath) || !std::filesystem::is_directory(scanPath)) {
             return shortcutFiles;
@@ -215,13 +477,20 @@ std::vector<std::wstring> ShortcutScanner::FindShortcutFiles() {
                 std::wstring filename = entry.path().filename().wstring();
                 
                 if (IsShortcutFile(filename)) {
-                    shortcutFiles.push_back(entry.path().wstring());
+                    // Size and write time come from the directory listing, so this costs no extra I/O
+                    std::error_code error;
+                    ShortcutFile file;
+                    file.path = entry.path().wstring();
+                    file.size = static_cast<uint64_t>(entry.file_size(error));
+                    file.lastWriteTime = static_cast<uint64_t>(entry.last_write_time(error).time_since_epoch().count());
+                    shortcutFiles.push_back(std::move(file));
                 }
             }
         }
         
         // Sort files alphabetically for consistent ordering
-        std::sort(shortcutFiles.begin(), shortcutFiles.end());
+        std::sort(shortcutFiles.begin(), shortcutFiles.end(),
+                  [](const ShortcutFile& a, const ShortcutFile& b) { return a.path < b.path; });
         
     } catch (const std::filesystem::filesystem_error&) {
         // Ignore filesystem errors
@@ -232,145 +501,136 @@ std::vector<std::wstring> ShortcutScanner::FindShortcutFiles() {
     return shortcutFiles;
 }
 
-bool ShortcutScanner::ProcessShortcutFile(const std::wstring& filePath, ShortcutInfo& info) {
-    if (!parser) {
+bool ShortcutScanner::ParseShortcutFile(const std::wstring& filePath, ShortcutInfo& info, size_t worker, uint64_t& contentHash) {
+    if (worker >= parsers.size() || !parsers[worker]) {
         return false;
     }
     
     // Parse the shortcut to get basic information
-    if (!parser->ParseShortcut(filePath, info)) {
+    if (!parsers[worker]->ParseShortcut(filePath, info)) {
         return false;
     }
     
-    // Extract icon if we have an icon extractor
-    if (iconExtractor) {
-        HICON icon = nullptr;
-        
-        // Simplified logic: If shortcut has custom icon, use it; otherwise use exe icon
-        if (!info.iconPath.empty()) {
-            // Custom icon specified - load from .ico file
-            icon = iconExtractor->ExtractFromIconFile(info.iconPath);
-        } else if (!info.targetPath.empty()) {
-            // No custom icon - extract from target executable
-            icon = iconExtractor->ExtractFromExecutable(info.targetPath, info.iconIndex);
-        }
-        
-        // Convert HICON to 32-bit ARGB bitmap with SIMD-accelerated resampling
-        if (icon) {
-            ICONINFO iconInfo;
-            if (GetIconInfo(icon, &iconInfo)) {
-                BITMAP bm;
-                GetObject(iconInfo.hbmColor ? iconInfo.hbmColor : iconInfo.hbmMask, sizeof(BITMAP), &bm);
-                int iconWidth = bm.bmWidth;
-                int iconHeight = bm.bmHeight;
-                
-                // Create a 32-bit ARGB DIB section for source icon
-                BITMAPINFO bmi = {};
-                bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-                bmi.bmiHeader.biWidth = iconWidth;
-                bmi.bmiHeader.biHeight = -iconHeight;  // Top-down
-                bmi.bmiHeader.biPlanes = 1;
-                bmi.bmiHeader.biBitCount = 32;
-                bmi.bmiHeader.biCompression = BI_RGB;
-                
-                void* srcBits = nullptr;
-                HDC hdcScreen = GetDC(nullptr);
-                HBITMAP hbmSrc = CreateDIBSection(hdcScreen, &bmi, DIB_RGB_COLORS, &srcBits, nullptr, 0);
-                
-                if (hbmSrc && srcBits) {
-                    // Fill with background color
-                    DWORD* srcPixels = (DWORD*)srcBits;
-                    //memset(srcPixels, 0x30, iconHeight * iconHeight * 4);
-                    /*COLORREF bgColor = RGB(28, 28, 30);
-                    BYTE bgR = GetRValue(bgColor);
-                    BYTE bgG = GetGValue(bgColor);
-                    BYTE bgB = GetBValue(bgColor);
-                    DWORD bgPixel = (bgB << 16) | (bgG << 8) | bgR;
-                    
-                    for (int i = 0; i < iconWidth * iconHeight; i++) {
-                        srcPixels[i] = bgPixel;
-                    }*/
-                    
-                    // Draw icon to source bitmap
-                    HDC hdcMem = CreateCompatibleDC(hdcScreen);
-                    HBITMAP hbmOld = (HBITMAP)SelectObject(hdcMem, hbmSrc);
-                    DrawIconEx(hdcMem, 0, 0, icon, iconWidth, iconHeight, 0, nullptr, DI_NORMAL);
-                    SelectObject(hdcMem, hbmOld);
-                    DeleteDC(hdcMem);
+    info.shortcutPath = filePath;
+    contentHash = HashContents(parsers[worker]->GetFileData());
+    return true;
+}
 
-                    // Premultiply alpha channel
-                    for (int i = 0; i < iconWidth * iconHeight; i++) {
-                        BYTE alpha = (srcPixels[i] >> 24) & 0xFF;
-                        BYTE r = (srcPixels[i] >> 16) & 0xFF;
-                        BYTE g = (srcPixels[i] >> 8) & 0xFF;
-                        BYTE b = srcPixels[i] & 0xFF;
-                        
-                        r = (r * alpha) / 255;
-                        g = (g * alpha) / 255;
-                        b = (b * alpha) / 255;
-                        
-                        srcPixels[i] = (alpha << 24) | (r << 16) | (g << 8) | b;
-                    }
-                    
-                    // Use stb_image_resize2 for high-quality SIMD-accelerated resampling
-                    float iconScale = Settings::Instance().GetIconScale();
-                    int targetWidth = static_cast<int>(256 * iconScale);
-                    int targetHeight = static_cast<int>(256 * iconScale);
-                    
-                    // Only resample if source is not already target size
-                    if (iconWidth != targetWidth || iconHeight != targetHeight) {
-                        // Create destination bitmap
-                        BITMAPINFO dstBmi = {};
-                        dstBmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-                        dstBmi.bmiHeader.biWidth = targetWidth;
-                        dstBmi.bmiHeader.biHeight = -targetHeight;
-                        dstBmi.bmiHeader.biPlanes = 1;
-                        dstBmi.bmiHeader.biBitCount = 32;
-                        dstBmi.bmiHeader.biCompression = BI_RGB;
-                        
-                        void* dstBits = nullptr;
-                        HBITMAP hbmDst = CreateDIBSection(hdcScreen, &dstBmi, DIB_RGB_COLORS, &dstBits, nullptr, 0);
-                        
-                        if (hbmDst && dstBits) {
-                            // Resample using stb with bilinear filter and premultiplied alpha (SIMD-accelerated)
-                            stbir_resize_uint8_linear(
-                                (unsigned char*)srcBits, iconWidth, iconHeight, iconWidth * 4,
-                                (unsigned char*)dstBits, targetWidth, targetHeight, targetWidth * 4,
-                                STBIR_RGBA_PM  // Premultiplied alpha - required for AlphaBlend
-                            );
-                            
-                            // Store the resampled bitmap
-                            info.iconBitmap = hbmDst;
-                            info.iconBitmapWidth = targetWidth;
-                            info.iconBitmapHeight = targetHeight;
-                            
-                            // Clean up source bitmap
-                            DeleteObject(hbmSrc);
-                        } else {
-                            // Fallback: use source bitmap if resampling fails
-                            info.iconBitmap = hbmSrc;
-                            info.iconBitmapWidth = iconWidth;
-                            info.iconBitmapHeight = iconHeight;
-                        }
-                    } else {
-                        // No resampling needed
-                        info.iconBitmap = hbmSrc;
-                        info.iconBitmapWidth = iconWidth;
-                        info.iconBitmapHeight = iconHeight;
-                    }
-                }
-                
-                // Clean up iconInfo bitmaps
-                if (iconInfo.hbmColor) DeleteObject(iconInfo.hbmColor);
-                if (iconInfo.hbmMask) DeleteObject(iconInfo.hbmMask);
-                
-                ReleaseDC(nullptr, hdcScreen);
-            }
+int ShortcutScanner::GetIconTargetSize() {
+    return static_cast<int>(256 * Settings::Instance().GetIconScale());
+}
+
+bool ShortcutScanner::GetIconSource(const ShortcutInfo& info, IconSourceState& state, IconCacheKey& key) {
+    state = IconSourceState();
+    state.targetSize = GetIconTargetSize();
+    if (!GetIconCacheKey(info, state.targetSize, key)) {
+        return false;
+    }
+    state.size = key.sourceSize;
+    state.lastWriteTime = key.sourceWriteTime;
+    return true;
+}
+
+void ShortcutScanner::ProcessIcon(ShortcutInfo& info, IconSourceState& iconState) {
+    // Remember what the bitmap is made from, so a rescan can tell when it goes stale
+    IconCacheKey key;
+    bool hasSource = GetIconSource(info, iconState, key);
+    int targetSize = iconState.targetSize;
+    
+    // Destination buffer from the shared pixel pool (no GDI handle per icon)
+    IconPixelPool& pool = IconPixelPool::Instance();
+    IconHandle iconPixels = pool.Allocate(targetSize, targetSize);
+    uint32_t* dstBits = pool.GetPixels(iconPixels);
+    if (!dstBits) {
+        return;
+    }
+    
+    // A cache hit reads the finished thumbnail straight into the pooled buffer
+    bool cacheable = iconCache && hasSource;
+    bool loaded = cacheable && iconCache->Read(key, dstBits);
+    
+    if (!loaded) {
+        // Decode the icon to premultiplied pixels, then resample to the display size
+        DecodedImage decoded;
+        if (DecodeIcon(info, targetSize, decoded)) {
+            ResampleIcon(decoded, dstBits, targetSize);
+            loaded = true;
             
-            // Destroy the HICON - we don't need it anymore
-            DestroyIcon(icon);
+            if (cacheable) {
+                iconCache->Store(key, dstBits);
+            }
         }
     }
     
+    if (!loaded) {
+        pool.Release(iconPixels);
+        return;
+    }
+    
+    // Store the resampled icon
+    info.SetIconPixels(iconPixels, targetSize, targetSize);
+}
+
+bool ShortcutScanner::GetIconCacheKey(const ShortcutInfo& info, int targetSize, IconCacheKey& key) {
+    // Same source selection as DecodeIcon: custom icon file, otherwise the target executable
+    if (!info.iconPath.empty()) {
+        key.sourcePath = info.iconPath;
+        key.iconIndex = info.iconIndex;
+    } else if (!info.targetPath.empty()) {
+        key.sourcePath = info.targetPath;
+        key.iconIndex = info.iconIndex;
+    } else {
+        return false;
+    }
+    
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesEx(key.sourcePath.c_str(), GetFileExInfoStandard, &attributes)) {
+        return false;
+    }
+    
+    key.sourceSize = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+    key.sourceWriteTime = (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) |
+                          attributes.ftLastWriteTime.dwLowDateTime;
+    key.targetSize = targetSize;
     return true;
+}
+
+bool ShortcutScanner::DecodeIcon(const ShortcutInfo& info, int targetSize, DecodedImage& decoded) {
+    if (!iconExtractor) {
+        return false;
+    }
+    
+    // Simplified logic: If shortcut has custom icon, use it; otherwise use exe icon.
+    // Either may be an .ico file or an executable - the extractor tells them apart.
+    if (!info.iconPath.empty()) {
+        return iconExtractor->DecodeIcon(info.iconPath, info.iconIndex, targetSize, decoded);
+    }
+    if (!info.targetPath.empty()) {
+        return iconExtractor->DecodeIcon(info.targetPath, info.iconIndex, targetSize, decoded);
+    }
+    return false;
+}
+
+void ShortcutScanner::ResampleIcon(const DecodedImage& decoded, void* pixels, int targetSize) {
+    // Only resample if source is not already target size
+    if (decoded.width != targetSize || decoded.height != targetSize) {
+        // Resample using stb with bilinear filter and premultiplied alpha (SIMD-accelerated)
+        stbir_resize_uint8_linear(
+            (const unsigned char*)decoded.pixels.data(), decoded.width, decoded.height, decoded.width * 4,
+            (unsigned char*)pixels, targetSize, targetSize, targetSize * 4,
+            STBIR_RGBA_PM  // Premultiplied alpha - required for AlphaBlend
+        );
+    } else {
+        memcpy(pixels, decoded.pixels.data(), decoded.pixels.size() * sizeof(uint32_t));
+    }
+}
+
+uint64_t ShortcutScanner::HashContents(const std::vector<uint8_t>& data) {
+    // 64-bit FNV-1a - shortcuts are small, so a simple byte loop is plenty
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint8_t byte : data) {
+        hash ^= byte;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
 }
\ No newline at end of file
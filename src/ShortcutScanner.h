@@ -2,38 +2,105 @@
 #pragma once
 
 #include <windows.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_map>
+#include <thread>
 #include "DataModels.h"
+#include "IconCache.h"
+#include "IconDecoder.h"
 
 class IconExtractor;
 class ShortcutParser;
 class WindowManager;
+class WorkerPool;
 
 class ShortcutScanner {
 public:
     ShortcutScanner();
     ~ShortcutScanner();
 
-    bool Initialize(const std::wstring& folderPath);
+    bool Initialize(const std::wstring& folderPath, const std::wstring& catalogFilePath = L"",
+                    const std::wstring& iconCacheFilePath = L"");
     void SetWindowManager(WindowManager* windowMgr) { windowManager = windowMgr; }
     std::vector<ShortcutInfo> ScanShortcuts();
     std::vector<TabInfo> ScanTabs();  // New method for tab scanning
     
+    // Incremental rescan: only added or changed shortcuts are processed, unchanged
+    // entries (including their icon bitmaps) are moved out of previousTabs
+    std::vector<TabInfo> RescanTabs(std::vector<TabInfo>& previousTabs);
+    
+    // Cold start from the catalog written by the last scan. Returns no tabs if the
+    // catalog is missing or invalid, in which case the caller falls back to ScanTabs.
+    std::vector<TabInfo> LoadCatalog();
+    
+    // Compare the loaded catalog against the Data folder on a background thread and
+    // post message to notifyWindow if anything was added, removed or changed
+    void StartCatalogValidation(HWND notifyWindow, UINT message);
+    
     const std::wstring& GetFolder() const { return scanFolder; }
     size_t GetLastScanCount() const { return lastScanCount; }
+    size_t GetLastProcessedCount() const { return lastProcessedCount; }
 
 private:
+    // A .lnk file found during enumeration, with the metadata used for change detection
+    struct ShortcutFile {
+        std::wstring path;
+        uint64_t size = 0;
+        uint64_t lastWriteTime = 0;
+    };
+    
+    // Icon file a shortcut's bitmap was made from, and the size it was made at
+    struct IconSourceState {
+        uint64_t size = 0;
+        uint64_t lastWriteTime = 0;
+        int targetSize = 0;
+        
+        bool operator==(const IconSourceState& other) const {
+            return size == other.size && lastWriteTime == other.lastWriteTime && targetSize == other.targetSize;
+        }
+    };
+    
+    // What the scanner knew about a shortcut the last time it was processed
+    struct ManifestEntry {
+        uint64_t size = 0;
+        uint64_t lastWriteTime = 0;
+        uint64_t contentHash = 0;
+        IconSourceState icon;
+    };
+    
     std::wstring scanFolder;
+    std::wstring catalogPath;
+    std::thread validationThread;
     std::unique_ptr<IconExtractor> iconExtractor;
-    std::unique_ptr<ShortcutParser> parser;
+    std::unique_ptr<IconCache> iconCache;  // Pre-scaled thumbnails from earlier runs
+    std::unique_ptr<WorkerPool> workerPool;
+    std::vector<std::unique_ptr<ShortcutParser>> parsers; // One per worker - parsers reuse a read buffer
     WindowManager* windowManager;
     size_t lastScanCount;
+    size_t lastProcessedCount;  // Shortcuts parsed by the last scan (the rest were reused)
+    std::unordered_map<std::wstring, ManifestEntry> manifest; // Keyed by .lnk path
     
+    std::vector<TabInfo> BuildTabs(std::vector<TabInfo>* previousTabs);
     bool IsShortcutFile(const std::wstring& filename);
-    std::vector<std::wstring> FindShortcutFiles();
+    std::vector<ShortcutFile> FindShortcutFiles(const std::wstring& folderPath);
     std::vector<std::wstring> FindSubfolders();  // New method
-    std::vector<ShortcutInfo> ScanFolderForShortcuts(const std::wstring& folderPath);  // New method
-    bool ProcessShortcutFile(const std::wstring& filePath, ShortcutInfo& info);
+    std::vector<std::vector<ShortcutInfo>> ProcessShortcutFiles(const std::vector<std::vector<ShortcutFile>>& fileLists,
+                                                                std::vector<TabInfo>* previousTabs);
+    
+    // Pipeline stages, run per file on the worker pool
+    bool ParseShortcutFile(const std::wstring& filePath, ShortcutInfo& info, size_t worker, uint64_t& contentHash);
+    void ProcessIcon(ShortcutInfo& info, IconSourceState& iconState);
+    bool GetIconSource(const ShortcutInfo& info, IconSourceState& state, IconCacheKey& key);
+    bool GetIconCacheKey(const ShortcutInfo& info, int targetSize, IconCacheKey& key);
+    static int GetIconTargetSize();
+    bool DecodeIcon(const ShortcutInfo& info, int targetSize, DecodedImage& decoded);
+    void ResampleIcon(const DecodedImage& decoded, void* pixels, int targetSize);
+    
+    void SaveCatalog(const std::vector<TabInfo>& tabs);
+    void WaitForValidation();
+    
+    static uint64_t HashContents(const std::vector<uint8_t>& data);
 };
\ No newline at end of file
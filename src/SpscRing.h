@@ -0,0 +1,72 @@
+// SpscRing.h - Lock-free single-producer single-consumer ring buffer (portable, no Win32)
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Fixed-capacity queue between exactly one producer thread and one consumer thread.
+// Neither side ever blocks or allocates: TryPush fails when the ring is full and TryPop
+// when it is empty. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscRing()
+        : writeIndex(0)
+        , cachedReadIndex(0)
+        , readIndex(0)
+        , cachedWriteIndex(0)
+    {
+    }
+    
+    // Delete copy/move
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    
+    // Producer thread only
+    bool TryPush(const T& item) {
+        size_t write = writeIndex.load(std::memory_order_relaxed);
+        if (write - cachedReadIndex == Capacity) {
+            // Looks full; see how far the consumer has got since we last checked
+            cachedReadIndex = readIndex.load(std::memory_order_acquire);
+            if (write - cachedReadIndex == Capacity) {
+                return false;
+            }
+        }
+        slots[write & (Capacity - 1)] = item;
+        writeIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumer thread only
+    bool TryPop(T& item) {
+        size_t read = readIndex.load(std::memory_order_relaxed);
+        if (read == cachedWriteIndex) {
+            cachedWriteIndex = writeIndex.load(std::memory_order_acquire);
+            if (read == cachedWriteIndex) {
+                return false;
+            }
+        }
+        item = slots[read & (Capacity - 1)];
+        readIndex.store(read + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Items queued at some moment during the call; exact only on a quiet ring
+    size_t GetSize() const {
+        return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+    }
+    
+    static size_t GetCapacity() { return Capacity; }
+
+private:
+    // Each side's index and its cached copy of the other side's share a cache line, so
+    // the two threads only touch each other's line when the cached copy runs out
+    static const size_t CACHE_LINE = 64;
+    alignas(CACHE_LINE) std::atomic<size_t> writeIndex;
+    size_t cachedReadIndex;         // Producer's last view of readIndex
+    alignas(CACHE_LINE) std::atomic<size_t> readIndex;
+    size_t cachedWriteIndex;        // Consumer's last view of writeIndex
+    alignas(CACHE_LINE) T slots[Capacity];
+};
@@ -0,0 +1,264 @@
+// TextRasterizer.cpp - Text coverage implementation, GDI or block glyphs
+#include "TextRasterizer.h"
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+
+#ifdef _WIN32
+
+TextRasterizer::TextRasterizer()
+    : fontHeight(16)
+    , fontBold(false)
+    , font(nullptr)
+    , stagingDC(nullptr)
+    , stagingBitmap(nullptr)
+    , stagingOldBitmap(nullptr)
+    , stagingBits(nullptr)
+    , stagingWidth(0)
+    , stagingHeight(0)
+{
+}
+
+TextRasterizer::~TextRasterizer() {
+    if (font) {
+        DeleteObject(font);
+    }
+    ReleaseStagingBitmap();
+}
+
+void TextRasterizer::SetFont(int height, bool bold) {
+    if (height == fontHeight && bold == fontBold) {
+        return;
+    }
+    if (font) {
+        DeleteObject(font);
+        font = nullptr;
+    }
+    fontHeight = height;
+    fontBold = bold;
+}
+
+bool TextRasterizer::Rasterize(const std::wstring& text, int width, int height, TextLayout layout,
+                               std::vector<uint8_t>& coverage) {
+    // The staging bitmap only has to be at least as large as the box
+    if (width <= 0 || height <= 0 ||
+        !EnsureStagingBitmap(max(width, stagingWidth), max(height, stagingHeight))) {
+        return false;
+    }
+    if (!font) {
+        font = CreateFont(fontHeight, 0, 0, 0, fontBold ? FW_BOLD : FW_NORMAL, FALSE, FALSE, FALSE,
+                          DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
+                          ANTIALIASED_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Segoe UI");
+    }
+    
+    // White grayscale-antialiased text on black: any channel is the glyph coverage
+    GdiFlush();
+    uint32_t* bits = static_cast<uint32_t*>(stagingBits);
+    for (int y = 0; y < height; y++) {
+        memset(bits + y * stagingWidth, 0, width * sizeof(uint32_t));
+    }
+    
+    UINT format = layout == TextLayout::WrappedTop ? DT_CENTER | DT_TOP | DT_WORDBREAK | DT_NOPREFIX
+                                                   : DT_CENTER | DT_VCENTER | DT_SINGLELINE | DT_NOPREFIX;
+    HFONT oldFont = (HFONT)SelectObject(stagingDC, font);
+    SetTextColor(stagingDC, RGB(255, 255, 255));
+    SetBkMode(stagingDC, TRANSPARENT);
+    RECT textRect = {0, 0, width, height};
+    DrawText(stagingDC, text.c_str(), static_cast<int>(text.length()), &textRect, format);
+    SelectObject(stagingDC, oldFont);
+    GdiFlush();
+    
+    coverage.resize(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++) {
+        const uint32_t* row = bits + y * stagingWidth;
+        for (int x = 0; x < width; x++) {
+            uint32_t pixel = row[x];
+            coverage[y * width + x] = static_cast<uint8_t>(max((pixel >> 16) & 0xFF, max((pixel >> 8) & 0xFF, pixel & 0xFF)));
+        }
+    }
+    return true;
+}
+
+bool TextRasterizer::EnsureStagingBitmap(int width, int height) {
+    if (stagingBitmap && stagingWidth == width && stagingHeight == height) {
+        return true;
+    }
+    ReleaseStagingBitmap();
+    
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height;  // Top-down, like the coverage rows
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    
+    stagingDC = CreateCompatibleDC(nullptr);
+    stagingBitmap = CreateDIBSection(nullptr, &bmi, DIB_RGB_COLORS, &stagingBits, nullptr, 0);
+    if (!stagingDC || !stagingBitmap || !stagingBits) {
+        ReleaseStagingBitmap();
+        return false;
+    }
+    
+    stagingOldBitmap = (HBITMAP)SelectObject(stagingDC, stagingBitmap);
+    stagingWidth = width;
+    stagingHeight = height;
+    return true;
+}
+
+void TextRasterizer::ReleaseStagingBitmap() {
+    if (stagingDC) {
+        if (stagingOldBitmap) {
+            SelectObject(stagingDC, stagingOldBitmap);
+        }
+        DeleteDC(stagingDC);
+    }
+    if (stagingBitmap) {
+        DeleteObject(stagingBitmap);
+    }
+    stagingDC = nullptr;
+    stagingBitmap = nullptr;
+    stagingOldBitmap = nullptr;
+    stagingBits = nullptr;
+    stagingWidth = 0;
+    stagingHeight = 0;
+}
+
+#else
+
+namespace {
+    bool IsOneOf(wchar_t c, const wchar_t* set) {
+        return c != 0 && wcschr(set, c) != nullptr;
+    }
+}
+
+TextRasterizer::TextRasterizer()
+    : fontHeight(16)
+    , fontBold(false)
+{
+}
+
+TextRasterizer::~TextRasterizer() {
+}
+
+void TextRasterizer::SetFont(int height, bool bold) {
+    fontHeight = height;
+    fontBold = bold;
+}
+
+bool TextRasterizer::Rasterize(const std::wstring& text, int width, int height, TextLayout layout,
+                               std::vector<uint8_t>& coverage) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    coverage.assign(static_cast<size_t>(width) * height, 0);
+    
+    if (layout == TextLayout::SingleLineCentered) {
+        int lineWidth = MeasureText(text, 0, text.size());
+        DrawLine(text, 0, text.size(), (width - lineWidth) / 2, (height - fontHeight) / 2, width, height, coverage);
+        return true;
+    }
+    
+    // Fill each line with as many words as fit; a word wider than the box gets a line
+    // to itself and is clipped, as DT_WORDBREAK does
+    size_t length = text.size();
+    size_t lineBegin = 0;
+    for (int y = 0; y < height; y += fontHeight) {
+        while (lineBegin < length && text[lineBegin] == L' ') {
+            lineBegin++;
+        }
+        if (lineBegin >= length) {
+            break;
+        }
+        
+        size_t lineEnd = text.find(L' ', lineBegin);
+        lineEnd = lineEnd == std::wstring::npos ? length : lineEnd;
+        while (lineEnd < length) {
+            size_t wordBegin = text.find_first_not_of(L' ', lineEnd);
+            if (wordBegin == std::wstring::npos) {
+                break;
+            }
+            size_t wordEnd = text.find(L' ', wordBegin);
+            wordEnd = wordEnd == std::wstring::npos ? length : wordEnd;
+            if (MeasureText(text, lineBegin, wordEnd) > width) {
+                break;
+            }
+            lineEnd = wordEnd;
+        }
+        
+        int lineWidth = MeasureText(text, lineBegin, lineEnd);
+        DrawLine(text, lineBegin, lineEnd, (width - lineWidth) / 2, y, width, height, coverage);
+        lineBegin = lineEnd;
+    }
+    return true;
+}
+
+int TextRasterizer::GetAdvance(wchar_t c) const {
+    // Rough Segoe UI proportions, in percent of the cell height
+    int percent = 56;
+    if (c == L' ') {
+        percent = 30;
+    } else if (IsOneOf(c, L"iljtfrI.,:;'!|`()[]")) {
+        percent = 28;
+    } else if (IsOneOf(c, L"mwMW@%")) {
+        percent = 78;
+    } else if (c >= L'a' && c <= L'z') {
+        percent = 50;
+    }
+    int advance = (fontHeight * percent + 50) / 100 + (fontBold ? fontHeight / 16 : 0);
+    return std::max(1, advance);
+}
+
+void TextRasterizer::GetBlockRows(wchar_t c, int& top, int& bottom) const {
+    int capTop = fontHeight * 22 / 100;
+    int xTop = fontHeight * 40 / 100;
+    int baseline = fontHeight * 78 / 100;
+    int descent = fontHeight * 92 / 100;
+    
+    top = capTop;
+    bottom = baseline;
+    if (c >= L'a' && c <= L'z') {
+        top = IsOneOf(c, L"bdfhklt") ? capTop : xTop;
+        bottom = IsOneOf(c, L"gjpqy") ? descent : baseline;
+    } else if (IsOneOf(c, L".,")) {
+        top = baseline - std::max(1, fontHeight / 10);
+        bottom = c == L',' ? descent : baseline;
+    } else if (IsOneOf(c, L"-+=~")) {
+        top = fontHeight * 46 / 100;
+        bottom = std::max(top + 1, fontHeight * 56 / 100);
+    } else if (IsOneOf(c, L"'\"`")) {
+        bottom = capTop + std::max(1, fontHeight / 5);
+    }
+}
+
+int TextRasterizer::MeasureText(const std::wstring& text, size_t begin, size_t end) const {
+    int width = 0;
+    for (size_t i = begin; i < end; i++) {
+        width += GetAdvance(text[i]);
+    }
+    return width;
+}
+
+void TextRasterizer::DrawLine(const std::wstring& text, size_t begin, size_t end, int x, int y, int width, int height,
+                              std::vector<uint8_t>& coverage) const {
+    for (size_t i = begin; i < end; i++) {
+        wchar_t c = text[i];
+        int advance = GetAdvance(c);
+        if (c != L' ') {
+            // A gap on both sides keeps neighbouring blocks apart
+            int gap = std::max(1, advance / 6);
+            int top, bottom;
+            GetBlockRows(c, top, bottom);
+            int left = std::max(0, x + gap);
+            int right = std::min(width, x + advance - gap);
+            for (int row = std::max(0, y + top); row < std::min(height, y + bottom); row++) {
+                if (left < right) {
+                    memset(&coverage[static_cast<size_t>(row) * width + left], 255, right - left);
+                }
+            }
+        }
+        x += advance;
+    }
+}
+
+#endif
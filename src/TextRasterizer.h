@@ -0,0 +1,63 @@
+// TextRasterizer.h - Text drawn into 8-bit coverage masks for labels and tabs
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Where text goes in its box
+enum class TextLayout {
+    WrappedTop,             // Centered lines broken between words, from the top (icon labels)
+    SingleLineCentered      // One line centered both ways (tab names)
+};
+
+// Draws text as coverage (0 = background, 255 = solid glyph) that callers blend in
+// their own color. On Win32, GDI draws Segoe UI with grayscale antialiasing into a
+// staging DIB section. Elsewhere every character is a solid block the size of its
+// glyph, laid out and wrapped the same way, so frames stay deterministic for golden
+// images and benchmarks without a font engine.
+class TextRasterizer {
+public:
+    TextRasterizer();
+    ~TextRasterizer();
+    
+    // Delete copy/move
+    TextRasterizer(const TextRasterizer&) = delete;
+    TextRasterizer& operator=(const TextRasterizer&) = delete;
+    
+    // Character cell height in pixels, as passed to CreateFont
+    void SetFont(int height, bool bold);
+    
+    // Draw text into a width x height box; coverage gets width * height bytes, row by
+    // row. False if the text could not be drawn.
+    bool Rasterize(const std::wstring& text, int width, int height, TextLayout layout, std::vector<uint8_t>& coverage);
+
+private:
+    int fontHeight;
+    bool fontBold;
+
+#ifdef _WIN32
+    HFONT font;                     // For fontHeight and fontBold, created on first use
+    
+    // DIB section GDI draws into; only ever grows
+    HDC stagingDC;
+    HBITMAP stagingBitmap;
+    HBITMAP stagingOldBitmap;
+    void* stagingBits;
+    int stagingWidth;
+    int stagingHeight;
+    
+    bool EnsureStagingBitmap(int width, int height);
+    void ReleaseStagingBitmap();
+#else
+    // Block glyph advance and vertical extent, in pixels for fontHeight
+    int GetAdvance(wchar_t c) const;
+    void GetBlockRows(wchar_t c, int& top, int& bottom) const;
+    int MeasureText(const std::wstring& text, size_t begin, size_t end) const;
+    void DrawLine(const std::wstring& text, size_t begin, size_t end, int x, int y, int width, int height,
+                  std::vector<uint8_t>& coverage) const;
+#endif
+};
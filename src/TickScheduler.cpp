@@ -0,0 +1,65 @@
+// TickScheduler.cpp - Fixed-rate tick scheduling implementation
+#include "TickScheduler.h"
+#include <algorithm>
+
+TickScheduler::TickScheduler(int ticksPerSecond)
+    : rate(1)
+    , running(false)
+    , startTime(0)
+    , tickIndex(0)
+    , deadline(0)
+    , lastLateness(0)
+    , missedTicks(0)
+    , wakeupWindowStart(-1)
+    , wakeupCount(0)
+    , wakeupsPerSecond(0)
+{
+    SetRate(ticksPerSecond);
+}
+
+void TickScheduler::SetRate(int ticksPerSecond) {
+    rate = std::max(1, std::min(static_cast<int>(MICROSECONDS_PER_SECOND), ticksPerSecond));
+}
+
+void TickScheduler::Start(int64_t now) {
+    running = true;
+    startTime = now;
+    tickIndex = 0;
+    deadline = now;
+}
+
+int64_t TickScheduler::GetTimeout(int64_t now) const {
+    if (!running) {
+        return -1;
+    }
+    return std::max<int64_t>(0, deadline - now);
+}
+
+bool TickScheduler::Tick(int64_t now) {
+    if (!running || now < deadline) {
+        return false;
+    }
+    lastLateness = now - deadline;
+    
+    // Skip to the first deadline after now; any passed on the way are dropped
+    int64_t next = (now - startTime) * rate / MICROSECONDS_PER_SECOND + 1;
+    missedTicks += next - tickIndex - 1;
+    tickIndex = next;
+    deadline = GetTickTime(tickIndex);
+    return true;
+}
+
+void TickScheduler::CountWakeup(int64_t now) {
+    if (wakeupWindowStart < 0) {
+        wakeupWindowStart = now;
+    }
+    wakeupCount++;
+    
+    // A long sleep spreads its one wakeup over the whole time asleep
+    int64_t elapsed = now - wakeupWindowStart;
+    if (elapsed >= MICROSECONDS_PER_SECOND) {
+        wakeupsPerSecond = static_cast<double>(wakeupCount) * MICROSECONDS_PER_SECOND / elapsed;
+        wakeupWindowStart = now;
+        wakeupCount = 0;
+    }
+}
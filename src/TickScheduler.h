@@ -0,0 +1,53 @@
+// TickScheduler.h - Fixed-rate tick deadlines and wakeup counting (portable, no Win32)
+#pragma once
+
+#include <cstdint>
+
+// Decides when a fixed-rate tick is due; the caller supplies a monotonic clock in
+// microseconds and does the waiting. Deadlines are counted from Start, so they don't
+// drift however late each wakeup is, and ticks missed by more than a period are
+// dropped instead of being run back to back.
+class TickScheduler {
+public:
+    explicit TickScheduler(int ticksPerSecond = 120);
+    
+    // Takes effect from the next Start
+    void SetRate(int ticksPerSecond);
+    int GetRate() const { return rate; }
+    
+    // The first tick is due right away
+    void Start(int64_t now);
+    void Stop() { running = false; }
+    bool IsRunning() const { return running; }
+    int64_t GetDeadline() const { return deadline; }
+    
+    // Microseconds until the next tick, 0 if one is due, -1 when stopped
+    int64_t GetTimeout(int64_t now) const;
+    
+    // True if a tick is due at now; the deadline then moves to the next period
+    bool Tick(int64_t now);
+    int64_t GetLastLateness() const { return lastLateness; }   // How late the last tick ran, in microseconds
+    int64_t GetMissedTicks() const { return missedTicks; }
+    
+    // Count one return from the wait. The rate is updated each time a second has passed.
+    void CountWakeup(int64_t now);
+    double GetWakeupsPerSecond() const { return wakeupsPerSecond; }
+    
+    static const int64_t MICROSECONDS_PER_SECOND = 1000000;
+
+private:
+    int rate;
+    bool running;
+    int64_t startTime;
+    int64_t tickIndex;              // Ticks since startTime, run or dropped
+    int64_t deadline;
+    int64_t lastLateness;
+    int64_t missedTicks;
+    
+    int64_t wakeupWindowStart;
+    int64_t wakeupCount;            // Wakeups since wakeupWindowStart
+    double wakeupsPerSecond;
+    
+    // Rounded up, so the tick after the one now falls in is always later than now
+    int64_t GetTickTime(int64_t index) const { return startTime + (index * MICROSECONDS_PER_SECOND + rate - 1) / rate; }
+};
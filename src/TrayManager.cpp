@@ -102,6 +102,12 @@ void TrayManager::HandleTrayMessage(WPARAM wParam, LPARAM lParam) {
     }
 }
 
+void TrayManager::SetRecordingChecked(bool recording) {
+    if (contextMenu) {
+        CheckMenuItem(contextMenu, ID_TRAY_RECORD, MF_BYCOMMAND | (recording ? MF_CHECKED : MF_UNCHECKED));
+    }
+}
+
 void TrayManager::CreateContextMenu() {
     contextMenu = CreatePopupMenu();
     if (!contextMenu) {
@@ -111,6 +117,8 @@ void TrayManager::CreateContextMenu() {
     // Add menu items
     AppendMenu(contextMenu, MF_STRING, ID_TRAY_SHOW, L"&Show");
     AppendMenu(contextMenu, MF_STRING, ID_TRAY_REFRESH, L"&Refresh");
+    AppendMenu(contextMenu, MF_STRING, ID_TRAY_LATENCY, L"Save &latency report");
+    AppendMenu(contextMenu, MF_STRING, ID_TRAY_RECORD, L"Record &input");
     AppendMenu(contextMenu, MF_SEPARATOR, 0, nullptr);
     AppendMenu(contextMenu, MF_STRING, ID_TRAY_EXIT, L"E&xit");
 }
\ No newline at end of file
@@ -14,6 +14,7 @@ public:
     void ShowContextMenu(POINT cursorPos);
     
     void HandleTrayMessage(WPARAM wParam, LPARAM lParam);
+    void SetRecordingChecked(bool recording);   // Check mark on "Record input"
 
 private:
     NOTIFYICONDATA trayData;
@@ -30,4 +31,6 @@ private:
     static const UINT ID_TRAY_REFRESH = 2002;
     static const UINT ID_TRAY_EXIT = 2003;
     static const UINT ID_TRAY_TOGGLE = 2004;
+    static const UINT ID_TRAY_LATENCY = 2005;
+    static const UINT ID_TRAY_RECORD = 2006;
 };
\ No newline at end of file
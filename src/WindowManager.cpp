@@ -1,11 +1,15 @@
 // WindowManager.cpp - Window management implementation
 #include "WindowManager.h"
 #include "GridRenderer.h"
+#include "FrameComposer.h"
 #include "TrayManager.h"
 #include "ShortcutScanner.h"
-#include "ControllerManager.h"
+#include "InputThread.h"
+#include "MessageLoop.h"
 #include "DataModels.h"
 #include "Settings.h"
+#include "Raster.h"
+#include "ScrollBlit.h"
 #include "resources/resource.h"
 #include <dwmapi.h>
 #include <algorithm>
@@ -19,12 +23,14 @@ const wchar_t* WindowManager::WINDOW_CLASS_NAME = L"GameLauncherWindow";
 WindowManager::WindowManager() 
     : mainWindow(nullptr)
     , gridRenderer(std::make_unique<GridRenderer>())
-    , controllerManager(std::make_unique<ControllerManager>())
+    , frameComposer(std::make_unique<FrameComposer>(gridRenderer.get()))
+    , inputThread(std::make_unique<InputThread>())
     , trayManager(nullptr)
     , shortcutScanner(nullptr)
     , isDragging(false)
     , activeTabIndex(0)
     , savedActiveTabIndex(0)
+    , initialTabApplied(false)
     , scrollOffset(0)
     , selectedIconIndex(-1)
     , lastSelectedIconIndex(-1)
@@ -36,13 +42,9 @@ WindowManager::WindowManager()
     , offscreenWidth(0)
     , offscreenHeight(0)
     , isResizing(false)
-    , tabBufferDC(nullptr)
-    , tabBufferBitmap(nullptr)
-    , oldTabBitmap(nullptr)
-    , tabBufferBits(nullptr)
-    , tabBufferWidth(0)
-    , tabBufferHeight(0)
-    , tabBufferDirty(true)
+    , renderedSelectedIndex(-1)
+    , scrollTime(0)
+    , recordingStartTime(0)
 {
 }
 
@@ -58,17 +60,6 @@ WindowManager::~WindowManager() {
         DeleteDC(offscreenDC);
     }
     
-    // Clean up tab buffer
-    if (tabBufferDC) {
-        if (oldTabBitmap) {
-            SelectObject(tabBufferDC, oldTabBitmap);
-        }
-        if (tabBufferBitmap) {
-            DeleteObject(tabBufferBitmap);
-        }
-        DeleteDC(tabBufferDC);
-    }
-    
     if (mainWindow) {
         DestroyWindow(mainWindow);
     }
@@ -84,35 +75,12 @@ std::wstring WindowManager::GetIniFilePath() const {
     return std::wstring(currentDir) + L"\\launcher.ini";
 }
 
-// Helper method to get scaled icon size
-int WindowManager::GetScaledIconSize() const {
-    return static_cast<int>(DesignConstants::TARGET_ICON_SIZE_PIXELS * Settings::Instance().GetIconScale());
-}
-
-// Helper method to calculate grid columns
-int WindowManager::CalculateGridColumns(const RECT& gridRect) const {
-    int availableWidth = gridRect.right - gridRect.left;
-    int physicalIconSize = GetScaledIconSize();
-    int itemWidth = physicalIconSize + Settings::Instance().GetIconSpacingHorizontal();
-    return (availableWidth / itemWidth > 1) ? (availableWidth / itemWidth) : 1;
-}
-
-// Helper method to get optimized grid rect for repainting
-RECT WindowManager::GetOptimizedGridRect(const RECT& gridRect, int cols, int itemWidth, int availableWidth) const {
-    int totalGridWidth = cols * itemWidth - Settings::Instance().GetIconSpacingHorizontal();
-    int startX = gridRect.left + (availableWidth - totalGridWidth) / 2;
-    
-    RECT optimizedGridRect = gridRect;
-    optimizedGridRect.left = startX - DesignConstants::SELECTION_BORDER_EXTENSION;
-    optimizedGridRect.right = min(gridRect.right, startX + totalGridWidth + DesignConstants::SELECTION_BORDER_EXTENSION);
-    optimizedGridRect.top -= DesignConstants::SELECTION_BORDER_EXTENSION;
-    
-    return optimizedGridRect;
-}
-
-// Helper method to get grid-relative rect for hit testing
-RECT WindowManager::GetGridRelativeRect(const RECT& gridRect) const {
-    return {0, 0, gridRect.right - gridRect.left, gridRect.bottom - gridRect.top};
+// Geometry of the active tab's grid as it is drawn now
+GridLayout WindowManager::GetGridLayout() const {
+    RECT clientRect;
+    GetClientRect(mainWindow, &clientRect);
+    int itemCount = IsValidTabState() ? static_cast<int>(tabs[activeTabIndex].shortcuts.size()) : 0;
+    return FrameComposer::GetGridLayout(clientRect, itemCount);
 }
 
 // Helper method to validate tab state
@@ -152,6 +120,7 @@ bool WindowManager::CreateMainWindow(HINSTANCE hInstance) {
     
     // Try to load saved window state from Settings
     Settings& settings = Settings::Instance();
+    pageCache.SetMaxBytes(static_cast<size_t>(settings.GetPageCacheMaxSizeMB()) * 1024 * 1024);
     int savedX = settings.GetWindowX();
     int savedY = settings.GetWindowY();
     int savedWidth = settings.GetWindowWidth();
@@ -241,8 +210,8 @@ bool WindowManager::CreateMainWindow(HINSTANCE hInstance) {
     // Load shortcuts initially
     LoadShortcuts();
     
-    // Initialize controller support
-    controllerManager->Initialize();
+    // Poll the controller on its own thread; it runs while the window is visible
+    inputThread->Start(mainWindow, WM_INPUT_EVENTS, Settings::Instance().GetInputPollRate());
     
     // Save initial window state to create INI file
     SaveWindowState();
@@ -298,7 +267,13 @@ void WindowManager::ToggleVisibility() {
 }
 
 void WindowManager::RefreshGrid() {
-    // Save current state
+    // A recording only replays on the shortcuts it started with
+    if (inputLog) {
+        StopInputRecording();
+    }
+    
+    // Save current state; with no tabs loaded yet there is none, and the reload applies the saved tab
+    bool hadTabs = initialTabApplied;
     int savedTabIndex = activeTabIndex;
     int savedIconIndex = selectedIconIndex;
     int savedScrollOffset = scrollOffset;
@@ -307,9 +282,10 @@ void WindowManager::RefreshGrid() {
     // Reload shortcuts
     LoadShortcuts();
     
-    // Restore state if still valid
-    if (savedTabIndex >= 0 && savedTabIndex < static_cast<int>(tabs.size())) {
-        activeTabIndex = savedTabIndex;
+    // Restore state if still valid. The tab goes through SetActiveTab so the renderer and the
+    // tab bar follow it if the reload moved off it.
+    if (hadTabs && savedTabIndex >= 0 && savedTabIndex < static_cast<int>(tabs.size())) {
+        SetActiveTab(savedTabIndex);
         
         // Restore selected icon if still valid
         if (!tabs[activeTabIndex].shortcuts.empty()) {
@@ -323,6 +299,7 @@ void WindowManager::RefreshGrid() {
             scrollOffset = savedScrollOffset;
         }
     }
+    scrollPhysics.Reset(scrollOffset); // The rescan stops a scroll in progress
     
     if (mainWindow) {
         // Use FALSE to avoid unnecessary background erasing
@@ -375,6 +352,9 @@ LRESULT CALLBACK WindowManager::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam,
 LRESULT WindowManager::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
     switch (uMsg) {
         case WM_PAINT: {
+            // Pick up the invalid area before BeginPaint validates it
+            CollectDamage(hwnd);
+            
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hwnd, &ps);
             
@@ -415,172 +395,56 @@ LRESULT WindowManager::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
                 oldBitmap = (HBITMAP)SelectObject(offscreenDC, offscreenBitmap);
                 offscreenWidth = windowWidth;
                 offscreenHeight = windowHeight;
-            }
-            
-            // Draw everything to the persistent buffer first (GDI doesn't set alpha channel)
-            // Clear entire buffer to nearly transparent (alpha=1 for hit testing, visually transparent)
-            if (offscreenBits) {
-                // Fill with 0x01000000 (alpha=1, RGB=0)
-                // Can't use memset since it fills bytes, not DWORDs
-                DWORD* pixels = (DWORD*)offscreenBits;
-                DWORD fillValue = 0x01000000;
-                int totalPixels = offscreenWidth * offscreenHeight;
                 
-                // Use rep stosd via intrinsic for fast bulk fill
-                __stosd((unsigned long*)pixels, fillValue, totalPixels);
+                // New buffer has no content yet
+                damage.Add(PixelRect(0, 0, offscreenWidth, offscreenHeight));
             }
             
-            // Draw tabs if we have any
-            RECT tabRect = {0, 0, 0, 0};
-            if (!tabs.empty()) {
-                DrawTabs(offscreenDC, clientRect);
-                tabRect = GetTabBarRect(clientRect);  // Get tab region for alpha fixing
-                
-                // Draw grid in the remaining area
-                RECT gridRect = GetGridRect(clientRect);
-                if (gridRenderer && activeTabIndex >= 0 && activeTabIndex < static_cast<int>(tabs.size())) {
-                    // Set up clipping region to prevent icons from drawing over tabs
-                    // Extend clip region upward to allow selection border to be visible
-                    HRGN clipRegion = CreateRectRgn(gridRect.left, gridRect.top - DesignConstants::SELECTION_BORDER_EXTENSION, gridRect.right, gridRect.bottom);
-                    SelectClipRgn(offscreenDC, clipRegion);
-                    
-                    gridRenderer->SetShortcuts(&tabs[activeTabIndex].shortcuts);
-                    gridRenderer->SetScrollOffset(scrollOffset);
-                    gridRenderer->SetSelectedIcon(selectedIconIndex);
-                    gridRenderer->SetDpiScaleFactor(GetDpiScaleFactor());
-                    gridRenderer->SetIconScale(Settings::Instance().GetIconScale());
-                    gridRenderer->SetIconLabelFontSize(Settings::Instance().GetIconLabelFontSize());
-                    gridRenderer->SetIconSpacingHorizontal(Settings::Instance().GetIconSpacingHorizontal());
-                    gridRenderer->SetIconSpacingVertical(Settings::Instance().GetIconSpacingVertical());
-                    gridRenderer->SetIconVerticalPadding(Settings::Instance().GetIconVerticalPadding());
-                    gridRenderer->Render(offscreenDC, gridRect);
-                    
-                    // Restore clipping region
-                    SelectClipRgn(offscreenDC, nullptr);
-                    DeleteObject(clipRegion);
-                }
-            } else {
-                // Show "No shortcuts found" message
-                SetTextColor(offscreenDC, RGB(255, 255, 255));
-                SetBkMode(offscreenDC, TRANSPARENT);
-                
-                HFONT hFont = CreateFont(18, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE,
-                                        DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-                                        CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Segoe UI");
-                HFONT hOldFont = (HFONT)SelectObject(offscreenDC, hFont);
-                
-                std::wstring noShortcutsMsg = L"No shortcuts found in Data folder";
-                DrawText(offscreenDC, noShortcutsMsg.c_str(), -1, &clientRect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
-                
-                SelectObject(offscreenDC, hOldFont);
-                DeleteObject(hFont);
+            // Only the damaged parts of the persistent buffer are redrawn; the rest still
+            // holds the last frame
+            damage.ClipTo(PixelRect(0, 0, offscreenWidth, offscreenHeight));
+            if (!offscreenBits || damage.IsEmpty()) {
+                damage.Clear();
+                pendingInputs.clear();
+                EndPaint(hwnd, &ps);
+                return 0;
             }
             
-            // Fix alpha channel after GDI drawing (GDI sets alpha to 0, we need proper alpha for visible elements)
-            // CRITICAL: AC_SRC_ALPHA requires premultiplied alpha - RGB must be multiplied by alpha
-            if (offscreenBits && offscreenDC) {
-                DWORD* pixels = (DWORD*)offscreenBits;
-                int bufferWidth = offscreenWidth;
-                int bufferHeight = offscreenHeight;
-                int bgLuminance = (28 + 28 + 30) / 3;
-                
-                int clientWidth = clientRect.right - clientRect.left;
-                int clientHeight = clientRect.bottom - clientRect.top;
-                
-                // 1. Process tab region (simple: all pixels opaque)
-                if (!tabs.empty()) {
-                    int tabTop = max(0, tabRect.top);
-                    int tabBottom = min(clientHeight, min(tabRect.bottom, bufferHeight));
-                    int tabLeft = max(0, tabRect.left);
-                    int tabRight = min(clientWidth, min(tabRect.right, bufferWidth));
-                    
-                    for (int y = tabTop; y < tabBottom; y++) {
-                        int rowOffset = y * bufferWidth;
-                        for (int x = tabLeft; x < tabRight; x++) {
-                            int i = rowOffset + x;
-                            DWORD pixel = pixels[i];
-                            BYTE currentAlpha = (pixel >> 24) & 0xFF;
-                            
-                            if (currentAlpha == 0) {
-                                // Set alpha=255 for all tab pixels
-                                pixels[i] = (255 << 24) | (pixel & 0x00FFFFFF);
-                            }
-                        }
-                    }
-                }
-                
-                // 2. Process icon label regions (text, shadows, borders)
-                if (gridRenderer && activeTabIndex >= 0 && activeTabIndex < static_cast<int>(tabs.size())) {
-                    RECT gridRect = GetGridRect(clientRect);
-                    
-                    for (size_t iconIdx = 0; iconIdx < tabs[activeTabIndex].shortcuts.size(); iconIdx++) {
-                        RECT iconBounds = gridRenderer->GetIconBounds(static_cast<int>(iconIdx), gridRect);
-                        
-                        int labelTop = max(0, min(iconBounds.top, clientHeight));
-                        int labelBottom = max(0, min(iconBounds.bottom, clientHeight));
-                        int labelLeft = max(0, min(iconBounds.left, clientWidth));
-                        int labelRight = max(0, min(iconBounds.right, clientWidth));
-                        
-                        if (labelTop >= labelBottom || labelLeft >= labelRight) continue;
-                        
-                        for (int y = labelTop; y < labelBottom && y < bufferHeight; y++) {
-                            int rowOffset = y * bufferWidth;
-                            for (int x = labelLeft; x < labelRight && x < bufferWidth; x++) {
-                                int i = rowOffset + x;
-                                DWORD pixel = pixels[i];
-                                BYTE currentAlpha = (pixel >> 24) & 0xFF;
-                                
-                                // Skip pixels with alpha already set (icons from AlphaBlend)
-                                if (currentAlpha > 0) continue;
-                                
-                                BYTE r = (pixel >> 16) & 0xFF;
-                                BYTE g = (pixel >> 8) & 0xFF;
-                                BYTE b = pixel & 0xFF;
-                                
-                                // Check for selection border pixels (grey or white)
-                                bool isGreyBorder = (r > 20 && r < 80 && g > 20 && g < 80 && b > 20 && b < 80);
-                                bool isWhiteBorder = (r > 250 && g > 250 && b > 250);
-                                if (isGreyBorder || isWhiteBorder) {
-                                    pixels[i] = (255 << 24) | (r << 16) | (g << 8) | b;
-                                    continue;
-                                }
-                                
-                                // Skip pure black (undrawn background)
-                                if (r == 0 && g == 0 && b == 0) continue;
-                                
-                                // Process text and shadow pixels
-                                int luminance = (r + g + b) / 3;
-                                bool isWhiteText = luminance > bgLuminance + 50;
-                                bool isBlackShadow = luminance < 30;
-                                
-                                if (isWhiteText || isBlackShadow) {
-                                    BYTE textAlpha;
-                                    if (isBlackShadow) {
-                                        textAlpha = (BYTE)min(255, (bgLuminance - luminance) * 255 / bgLuminance);
-                                    } else {
-                                        textAlpha = (BYTE)min(255, (luminance - bgLuminance) * 255 / (255 - bgLuminance));
-                                    }
-                                    
-                                    // Premultiply RGB by alpha
-                                    r = (r * textAlpha) / 255;
-                                    g = (g * textAlpha) / 255;
-                                    b = (b * textAlpha) / 255;
-                                    pixels[i] = (textAlpha << 24) | (r << 16) | (g << 8) | b;
-                                }
-                            }
-                        }
-                    }
-                }
-                
-                // Note: No need to clear margins or process background - everything defaults to transparent
-                
-                // Use UpdateLayeredWindow for per-pixel alpha compositing
-                POINT ptSrc = {0, 0};
-                SIZE sizeWnd = {offscreenWidth, offscreenHeight};
-                BLENDFUNCTION blend = {AC_SRC_OVER, 0, 255, AC_SRC_ALPHA};
-                UpdateLayeredWindow(hwnd, hdc, nullptr, &sizeWnd, offscreenDC, &ptSrc, 0, &blend, ULW_ALPHA);
+            RasterSurface frame;
+            frame.pixels = static_cast<uint32_t*>(offscreenBits);
+            frame.width = offscreenWidth;
+            frame.height = offscreenHeight;
+            frame.stride = offscreenWidth;
+            
+            PixelRect damageBounds = damage.GetBounds();
+            RECT dirtyRect = {damageBounds.left, damageBounds.top, damageBounds.right, damageBounds.bottom};
+            
+            frameComposer->Compose(frame, damage, GetFrameState(clientRect));
+            
+            // Per-pixel alpha compositing; prcDirty lets DWM copy only the changed area
+            POINT ptSrc = {0, 0};
+            SIZE sizeWnd = {offscreenWidth, offscreenHeight};
+            BLENDFUNCTION blend = {AC_SRC_OVER, 0, 255, AC_SRC_ALPHA};
+            
+            UPDATELAYEREDWINDOWINFO updateInfo = {};
+            updateInfo.cbSize = sizeof(updateInfo);
+            updateInfo.hdcDst = hdc;
+            updateInfo.psize = &sizeWnd;
+            updateInfo.hdcSrc = offscreenDC;
+            updateInfo.pptSrc = &ptSrc;
+            updateInfo.pblend = &blend;
+            updateInfo.dwFlags = ULW_ALPHA;
+            updateInfo.prcDirty = &dirtyRect;
+            
+            // A dirty rect is rejected when the update also resizes the window, so fall back to a full update
+            if (!UpdateLayeredWindowIndirect(hwnd, &updateInfo)) {
+                updateInfo.prcDirty = nullptr;
+                UpdateLayeredWindowIndirect(hwnd, &updateInfo);
             }
+            RecordPresentedInput();
             
+            damage.Clear();
+            renderedSelectedIndex = selectedIconIndex;
             EndPaint(hwnd, &ps);
             return 0;
         }
@@ -626,12 +490,15 @@ LRESULT WindowManager::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
             return DefWindowProc(hwnd, uMsg, wParam, lParam);
         }
         
-        case WM_LBUTTONDOWN:
+        case WM_LBUTTONDOWN: {
+            int64_t inputTime = MessageLoop::GetMicroseconds();
             HandleMouseMove(LOWORD(lParam), HIWORD(lParam));
             HandleTabClick(LOWORD(lParam), HIWORD(lParam));  // Check tab clicks first
             HandleLeftClick(LOWORD(lParam), HIWORD(lParam));
             HandleWindowDrag(uMsg, wParam, lParam);
+            TrackInput(InputLatencyType::Mouse, inputTime);
             return 0;
+        }
             
         case WM_RBUTTONDOWN:
             // Right click - hide window
@@ -643,22 +510,31 @@ LRESULT WindowManager::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
             HideWindow();
             return 0;
             
-        case WM_MOUSEMOVE:
+        case WM_MOUSEMOVE: {
+            int64_t inputTime = MessageLoop::GetMicroseconds();
             HandleMouseMove(LOWORD(lParam), HIWORD(lParam));
             HandleWindowDrag(uMsg, wParam, lParam);
+            TrackInput(InputLatencyType::Mouse, inputTime);
             return 0;
+        }
             
         case WM_LBUTTONUP:
             HandleWindowDrag(uMsg, wParam, lParam);
             return 0;
             
-        case WM_LBUTTONDBLCLK:
+        case WM_LBUTTONDBLCLK: {
+            int64_t inputTime = MessageLoop::GetMicroseconds();
             HandleDoubleClick(LOWORD(lParam), HIWORD(lParam));
+            TrackInput(InputLatencyType::Mouse, inputTime);
             return 0;
+        }
             
-        case WM_MOUSEWHEEL:
+        case WM_MOUSEWHEEL: {
+            int64_t inputTime = MessageLoop::GetMicroseconds();
             HandleMouseWheel(GET_WHEEL_DELTA_WPARAM(wParam));
+            TrackScrollInput(InputLatencyType::MouseWheel, inputTime);
             return 0;
+        }
             
         case WM_ENTERSIZEMOVE:
             // User started resizing or moving the window
@@ -682,10 +558,9 @@ LRESULT WindowManager::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
             }
             if (uMsg == WM_SIZE) {
                 // Reset scroll position and selection on window resize to keep things simple
-                scrollOffset = 0;
-                selectedIconIndex = -1;
-                usingKeyboardNavigation = false;
-                tabBufferDirty = true; // Mark tab buffer for redraw on resize
+                ApplyAction({InputActionType::Resize, LOWORD(lParam), HIWORD(lParam)});
+                frameComposer->InvalidateTabs(); // Mark tab buffer for redraw on resize
+                pageCache.Clear();
                 
                 // Invalidate to redraw grid with new size
                 InvalidateRect(mainWindow, nullptr, TRUE);
@@ -697,7 +572,9 @@ LRESULT WindowManager::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
                 HideWindow();
                 return 0;
             } else {
+                int64_t inputTime = MessageLoop::GetMicroseconds();
                 HandleKeyDown(wParam);
+                TrackInput(InputLatencyType::Key, inputTime);
                 return 0;
             }
             break;
@@ -710,6 +587,12 @@ LRESULT WindowManager::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
         case WM_DESTROY:
             // Save window state before destroying
             SaveWindowState();
+            if (Settings::Instance().GetLatencyReportOnExit()) {
+                SaveLatencyReport();
+            }
+            if (inputLog) {
+                StopInputRecording();
+            }
             PostQuitMessage(0);
             return 0;
             
@@ -723,6 +606,28 @@ LRESULT WindowManager::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
         case WM_COMMAND:
             return HandleCommand(wParam, lParam);
             
+        case WM_INPUT_EVENTS:
+            HandleControllerInput();
+            return 0;
+        
+        case WM_SHOWWINDOW:
+            if (inputThread) {
+                inputThread->SetActive(wParam != FALSE);
+            }
+            if (!wParam) {
+                // Nothing is presented while hidden, and a held stick is measured afresh when shown
+                pendingInputs.clear();
+                scrollInputs.clear();
+                scrollPhysics.SetStickVelocity(0);
+                scrollPhysics.Reset(scrollOffset);
+            }
+            return DefWindowProc(hwnd, uMsg, wParam, lParam);
+        
+        case WM_CATALOG_STALE:
+            // The Data folder changed since the catalog was written
+            RefreshGrid();
+            return 0;
+        
         case WM_TIMER:
             if (wParam == 1) { // Tray icon timer
                 KillTimer(hwnd, 1);
@@ -758,6 +663,20 @@ LRESULT WindowManager::HandleCommand(WPARAM wParam, LPARAM /*lParam*/) {
         case 2004: // ID_TRAY_TOGGLE
             ToggleVisibility();
             return 0;
+        
+        case 2005: // ID_TRAY_LATENCY
+            if (!SaveLatencyReport()) {
+                MessageBox(mainWindow, L"Could not write latency.txt.", L"Latency Report", MB_OK | MB_ICONWARNING);
+            }
+            return 0;
+        
+        case 2006: // ID_TRAY_RECORD
+            if (!inputLog) {
+                StartInputRecording();
+            } else if (!StopInputRecording()) {
+                MessageBox(mainWindow, L"Could not write input.rec.", L"Input Recording", MB_OK | MB_ICONWARNING);
+            }
+            return 0;
     }
     
     return 0;
@@ -806,24 +725,42 @@ void WindowManager::LoadShortcuts() {
         return;
     }
     
-    // Scan for tabs
-    tabs = shortcutScanner->ScanTabs();
-    tabBufferDirty = true; // Mark tab buffer for redraw since tabs changed
+    // Scan for tabs - after the first load only added or changed shortcuts are processed
+    if (tabs.empty()) {
+        // Cold start from the catalog when possible, then verify it against the Data folder
+        tabs = shortcutScanner->LoadCatalog();
+        if (!tabs.empty()) {
+            shortcutScanner->StartCatalogValidation(mainWindow, WM_CATALOG_STALE);
+        } else {
+            tabs = shortcutScanner->ScanTabs();
+        }
+    } else {
+        tabs = shortcutScanner->RescanTabs(tabs);
+    }
+    frameComposer->InvalidateTabs(); // Mark tab buffer for redraw since tabs changed
+    pageCache.Clear();                // Kept pages show the old shortcuts and icons
+    
+    // The renderer still points into the replaced tabs, which SetActiveTab below does not
+    // re-point when the tab index stays the same
+    if (activeTabIndex >= static_cast<int>(tabs.size())) {
+        activeTabIndex = 0;
+    }
+    if (gridRenderer) {
+        gridRenderer->SetShortcuts(tabs.empty() ? nullptr : &tabs[activeTabIndex].shortcuts);
+    }
     
-    // Set active tab to saved tab if valid, otherwise first tab
-    // Only do this during initial load (when activeTabIndex is 0 and tabs were empty)
-    if (!tabs.empty() && activeTabIndex == 0) {
-        int tabToActivate = 0;
+    // Switch to the tab saved in the INI file, once, on the first load that finds tabs.
+    // Reloads keep the tab the user is on, even when that is the first one.
+    if (!tabs.empty() && !initialTabApplied) {
+        initialTabApplied = true;
         if (savedActiveTabIndex >= 0 && savedActiveTabIndex < static_cast<int>(tabs.size())) {
-            tabToActivate = savedActiveTabIndex;
+            SetActiveTab(savedActiveTabIndex);
         }
-        activeTabIndex = tabToActivate;
-        SetActiveTab(tabToActivate);
     }
 }
 
 void WindowManager::HandleMouseMove(int x, int y) {
-    if (!gridRenderer || !IsValidTabState()) {
+    if (!IsValidTabState()) {
         return;
     }
     
@@ -841,12 +778,7 @@ void WindowManager::HandleMouseMove(int x, int y) {
         return;
     }
     
-    // Adjust mouse point relative to grid area
-    mousePoint.x -= gridRect.left;
-    mousePoint.y -= gridRect.top;
-    
-    RECT gridRelativeRect = GetGridRelativeRect(gridRect);
-    int hoveredIndex = gridRenderer->GetClickedShortcut(mousePoint, gridRelativeRect);
+    int hoveredIndex = GetGridLayout().PointToIndex(x, y, scrollOffset);
     
     // Always update selection based on mouse hover - this switches back to mouse mode
     if (hoveredIndex != selectedIconIndex) {
@@ -855,7 +787,7 @@ void WindowManager::HandleMouseMove(int x, int y) {
 }
 
 void WindowManager::HandleLeftClick(int x, int y) {
-    if (!gridRenderer || !IsValidTabState()) {
+    if (!IsValidTabState()) {
         return;
     }
     
@@ -869,12 +801,7 @@ void WindowManager::HandleLeftClick(int x, int y) {
         return;
     }
     
-    // Adjust click point relative to grid area
-    clickPoint.x -= gridRect.left;
-    clickPoint.y -= gridRect.top;
-    
-    RECT gridRelativeRect = GetGridRelativeRect(gridRect);
-    int clickedIndex = gridRenderer->GetClickedShortcut(clickPoint, gridRelativeRect);
+    int clickedIndex = GetGridLayout().PointToIndex(x, y, scrollOffset);
     
     if (clickedIndex >= 0 && clickedIndex < static_cast<int>(tabs[activeTabIndex].shortcuts.size())) {
         // Single click - confirm selection
@@ -883,7 +810,7 @@ void WindowManager::HandleLeftClick(int x, int y) {
 }
 
 void WindowManager::HandleDoubleClick(int x, int y) {
-    if (!gridRenderer || !IsValidTabState()) {
+    if (!IsValidTabState()) {
         return;
     }
     
@@ -897,136 +824,110 @@ void WindowManager::HandleDoubleClick(int x, int y) {
         return;
     }
     
-    // Adjust click point relative to grid area
-    clickPoint.x -= gridRect.left;
-    clickPoint.y -= gridRect.top;
-    
-    RECT gridRelativeRect = GetGridRelativeRect(gridRect);
-    int clickedIndex = gridRenderer->GetClickedShortcut(clickPoint, gridRelativeRect);
+    int clickedIndex = GetGridLayout().PointToIndex(x, y, scrollOffset);
     
     if (clickedIndex >= 0 && clickedIndex < static_cast<int>(tabs[activeTabIndex].shortcuts.size())) {
         // Double click - launch the shortcut
         SetSelectedIcon(clickedIndex, false);
-        LaunchSelectedIcon();
+        ApplyAction({InputActionType::Launch});
     }
 }
 
 void WindowManager::HandleMouseWheel(int delta) {
-    if (!IsValidTabState()) {
-        return;
-    }
-    
-    // Calculate scroll amount (negative delta means scroll down)
-    int scrollDelta = -delta / WHEEL_DELTA * Settings::Instance().GetMouseScrollSpeed();
+    // Negative delta means scroll down; high resolution wheels send fractions of a notch
+    StartScroll();
+    scrollPhysics.AddDistance(-static_cast<double>(delta) / WHEEL_DELTA * Settings::Instance().GetMouseScrollSpeed());
     
-    // Get grid area to calculate maximum scroll
-    RECT clientRect;
-    GetClientRect(mainWindow, &clientRect);
-    RECT gridRect = GetGridRect(clientRect);
-    
-    int availableWidth = gridRect.right - gridRect.left;
-    int physicalIconSize = GetScaledIconSize();
-    int itemWidth = physicalIconSize + Settings::Instance().GetIconSpacingHorizontal();
-    int cols = CalculateGridColumns(gridRect);
-    
-    // Calculate new scroll offset with bounds checking
-    int newScrollOffset = scrollOffset + scrollDelta;
-    
-    // Only calculate max scroll if we need to clamp
-    int rows = (static_cast<int>(tabs[activeTabIndex].shortcuts.size()) + cols - 1) / cols;
-    int totalItemHeight = physicalIconSize + DesignConstants::LABEL_HEIGHT + Settings::Instance().GetIconVerticalPadding();
-    int totalContentHeight = rows * (totalItemHeight + Settings::Instance().GetIconSpacingVertical());
-    int availableHeight = gridRect.bottom - gridRect.top;
-    int maxScroll = max(0, totalContentHeight - availableHeight);
-    
-    int clampedScrollOffset = max(0, min(newScrollOffset, maxScroll));
-    
-    // Only invalidate and repaint if the scroll position actually changed
-    if (clampedScrollOffset != scrollOffset) {
-        scrollOffset = clampedScrollOffset;
-        
-        // Always update selection to first FULLY visible icon after scrolling
-        // Calculate which row is at the top of the visible area
-        int rowHeight = totalItemHeight + Settings::Instance().GetIconSpacingVertical();
-        
-        // If a row is partially cut off at the top, we want the next row
-        // So we add (rowHeight - 1) before dividing to round up
-        int firstFullyVisibleRow = (scrollOffset + rowHeight - 1) / rowHeight;
-        int firstVisibleIconIndex = firstFullyVisibleRow * cols;
-        
-        // Clamp to valid icon range
-        int totalIcons = static_cast<int>(tabs[activeTabIndex].shortcuts.size());
-        firstVisibleIconIndex = max(0, min(firstVisibleIconIndex, totalIcons - 1));
-        
-        // Update selection to first visible icon and enable keyboard navigation mode
-        selectedIconIndex = firstVisibleIconIndex;
-        usingKeyboardNavigation = true;
-        
-        // Get optimized repaint rect
-        RECT optimizedGridRect = GetOptimizedGridRect(gridRect, cols, itemWidth, availableWidth);
-        
-        // Redraw only the actual grid area
-        InvalidateRect(mainWindow, &optimizedGridRect, FALSE);
+    // Without smoothing the wheel jumps right away; otherwise the frames take it from here
+    ShowScrollFrame();
+}
+
+void WindowManager::HandleJoystickScroll(int deflection) {
+    StartScroll();
+    double fullSpeed = Settings::Instance().GetJoystickScrollVelocity();
+    scrollPhysics.SetStickVelocity(fullSpeed * deflection / GamepadEdgeDetector::STICK_RANGE);
+}
+
+void WindowManager::StartScroll() {
+    int64_t now = MessageLoop::GetMicroseconds();
+    if (IsScrolling()) {
+        scrollPhysics.Advance(now - scrollTime);
+    } else {
+        // At rest it may be behind keys, clicks or resizes that moved the grid
+        scrollPhysics.Reset(scrollOffset);
     }
+    scrollTime = now;
+    scrollPhysics.SetSmoothing(Settings::Instance().GetScrollSmoothing() * 1000);
+    scrollPhysics.SetRange(GetGridLayout().GetMaxScroll());
 }
 
-void WindowManager::HandleJoystickScroll(int delta) {
-    if (!IsValidTabState()) {
-        return;
+bool WindowManager::IsScrolling() const {
+    // Also while frames are still catching up with a scroll their budget held back
+    return scrollPhysics.IsMoving() || scrollPhysics.GetOffset() != scrollOffset;
+}
+
+void WindowManager::AdvanceScroll() {
+    int64_t now = MessageLoop::GetMicroseconds();
+    scrollPhysics.Advance(now - scrollTime);
+    scrollTime = now;
+    ShowScrollFrame();
+}
+
+int WindowManager::GetRefreshRate() const {
+    HDC screenDC = GetDC(mainWindow);
+    if (!screenDC) {
+        return DEFAULT_REFRESH_RATE;
     }
+    int rate = GetDeviceCaps(screenDC, VREFRESH);
+    ReleaseDC(mainWindow, screenDC);
     
-    // Joystick scroll delta is already in pixels (no WHEEL_DELTA division needed)
-    int scrollDelta = delta;
-    
-    // Get grid area to calculate maximum scroll
-    RECT clientRect;
-    GetClientRect(mainWindow, &clientRect);
-    RECT gridRect = GetGridRect(clientRect);
-    
-    int availableWidth = gridRect.right - gridRect.left;
-    int physicalIconSize = GetScaledIconSize();
-    int itemWidth = physicalIconSize + Settings::Instance().GetIconSpacingHorizontal();
-    int cols = CalculateGridColumns(gridRect);
+    // 0 and 1 stand for the hardware's default rate
+    return rate > 1 ? rate : DEFAULT_REFRESH_RATE;
+}
+
+void WindowManager::ShowScrollFrame() {
+    if (!mainWindow || !IsValidTabState()) {
+        scrollPhysics.Reset(scrollOffset);
+        return;
+    }
     
-    // Calculate new scroll offset with bounds checking
-    int newScrollOffset = scrollOffset + scrollDelta;
+    // One step per painted frame. While the last one waits for WM_PAINT the time adds up
+    // in scrollPhysics, and the next step covers it.
+    if (GetUpdateRect(mainWindow, nullptr, FALSE)) {
+        return;
+    }
     
-    // Only calculate max scroll if we need to clamp
-    int rows = (static_cast<int>(tabs[activeTabIndex].shortcuts.size()) + cols - 1) / cols;
-    int totalItemHeight = physicalIconSize + DesignConstants::LABEL_HEIGHT + Settings::Instance().GetIconVerticalPadding();
-    int totalContentHeight = rows * (totalItemHeight + Settings::Instance().GetIconSpacingVertical());
-    int availableHeight = gridRect.bottom - gridRect.top;
-    int maxScroll = max(0, totalContentHeight - availableHeight);
+    // A step redraws the rows it scrolls into view; the budget caps them, so a fast flick
+    // spreads over several frames instead of making one slow one
+    GridLayout layout = GetGridLayout();
+    scrollPhysics.SetRange(layout.GetMaxScroll());
+    int budget = ScrollPhysics::GetFrameBudget(layout.GetArea().Height());
+    int step = scrollPhysics.GetFrameStep(scrollOffset, budget);
+    if (step == 0) {
+        if (!IsScrolling()) {
+            scrollInputs.clear(); // Came to rest without moving the grid
+        }
+        return;
+    }
     
-    int clampedScrollOffset = max(0, min(newScrollOffset, maxScroll));
+    int previousOffset = scrollOffset;
+    ScrollBy(step);
+    if (scrollOffset == previousOffset) {
+        // The grid can't go where the physics is heading
+        scrollPhysics.Reset(scrollOffset);
+        scrollInputs.clear();
+        return;
+    }
     
-    // Only invalidate and repaint if the scroll position actually changed
-    if (clampedScrollOffset != scrollOffset) {
-        scrollOffset = clampedScrollOffset;
-        
-        // Always update selection to first FULLY visible icon after scrolling
-        // Calculate which row is at the top of the visible area
-        int rowHeight = totalItemHeight + Settings::Instance().GetIconSpacingVertical();
-        
-        // If a row is partially cut off at the top, we want the next row
-        // So we add (rowHeight - 1) before dividing to round up
-        int firstFullyVisibleRow = (scrollOffset + rowHeight - 1) / rowHeight;
-        int firstVisibleIconIndex = firstFullyVisibleRow * cols;
-        
-        // Clamp to valid icon range
-        int totalIcons = static_cast<int>(tabs[activeTabIndex].shortcuts.size());
-        firstVisibleIconIndex = max(0, min(firstVisibleIconIndex, totalIcons - 1));
-        
-        // Update selection to first visible icon and enable keyboard navigation mode
-        selectedIconIndex = firstVisibleIconIndex;
-        usingKeyboardNavigation = true;
-        
-        // Get optimized repaint rect
-        RECT optimizedGridRect = GetOptimizedGridRect(gridRect, cols, itemWidth, availableWidth);
-        
-        // Redraw only the actual grid area
-        InvalidateRect(mainWindow, &optimizedGridRect, FALSE);
+    // This frame is the first result of the inputs that started the scroll
+    for (const PendingInput& input : scrollInputs) {
+        TrackInput(input.type, input.time);
     }
+    scrollInputs.clear();
+}
+
+void WindowManager::ScrollBy(int scrollDelta) {
+    ApplyAction({InputActionType::Scroll, scrollDelta});
 }
 
 void WindowManager::HandleKeyDown(WPARAM wParam) {
@@ -1042,94 +943,23 @@ void WindowManager::HandleKeyDown(WPARAM wParam) {
         return;
     }
     
-    // Switch to keyboard navigation mode for other keys
-    usingKeyboardNavigation = true;
-    
-    // If no icon is selected, try to resume from last selected position
-    if (selectedIconIndex == -1) {
-        // If we have a last selected icon, use it as the starting point
-        if (lastSelectedIconIndex != -1 && lastSelectedIconIndex < static_cast<int>(tabs[activeTabIndex].shortcuts.size())) {
-            selectedIconIndex = lastSelectedIconIndex;
-            // Don't return - let the navigation logic below handle the movement
-        } else {
-            // No previous selection - select first fully visible icon
-            RECT clientRect;
-            GetClientRect(mainWindow, &clientRect);
-            RECT gridRect = GetGridRect(clientRect);
-            int cols = CalculateGridColumns(gridRect);
-            
-            int physicalIconSize = GetScaledIconSize();
-            int totalItemHeight = physicalIconSize + DesignConstants::LABEL_HEIGHT + Settings::Instance().GetIconVerticalPadding();
-            int rowHeight = totalItemHeight + Settings::Instance().GetIconSpacingVertical();
-            
-            // Calculate first fully visible row
-            int firstFullyVisibleRow = (scrollOffset + rowHeight - 1) / rowHeight;
-            int firstVisibleIconIndex = firstFullyVisibleRow * cols;
-            
-            // Clamp to valid range
-            int totalIcons = static_cast<int>(tabs[activeTabIndex].shortcuts.size());
-            firstVisibleIconIndex = max(0, min(firstVisibleIconIndex, totalIcons - 1));
-            
-            SetSelectedIcon(firstVisibleIconIndex, true);
-            return;
-        }
-    }
-    
-    // Get grid layout information using DPI-aware sizes
-    RECT clientRect;
-    GetClientRect(mainWindow, &clientRect);
-    RECT gridRect = GetGridRect(clientRect);
-    
-    int cols = CalculateGridColumns(gridRect);
-    int totalIcons = static_cast<int>(tabs[activeTabIndex].shortcuts.size());
-    
-    int newSelectedIndex = selectedIconIndex;
-    
     switch (wParam) {
-        case VK_LEFT:
-            if (selectedIconIndex > 0) {
-                newSelectedIndex = selectedIconIndex - 1;
-            }
-            break;
-            
-        case VK_RIGHT:
-            if (selectedIconIndex < totalIcons - 1) {
-                newSelectedIndex = selectedIconIndex + 1;
-            }
-            break;
-            
-        case VK_UP:
-            if (selectedIconIndex >= cols) {
-                newSelectedIndex = selectedIconIndex - cols;
-            }
-            break;
-            
-        case VK_DOWN:
-            if (selectedIconIndex + cols < totalIcons) {
-                // There's an icon directly below
-                newSelectedIndex = selectedIconIndex + cols;
-            } else {
-                // No icon directly below, but check if there's another row
-                int currentRow = selectedIconIndex / cols;
-                int nextRow = currentRow + 1;
-                int nextRowStart = nextRow * cols;
-                
-                if (nextRowStart < totalIcons) {
-                    // There is a next row, move to the last icon on that row
-                    int nextRowEnd = min(nextRowStart + cols - 1, totalIcons - 1);
-                    newSelectedIndex = nextRowEnd;
-                }
+        case VK_LEFT:  ApplyAction({InputActionType::Navigate, -1, 0}); break;
+        case VK_RIGHT: ApplyAction({InputActionType::Navigate, 1, 0}); break;
+        case VK_UP:    ApplyAction({InputActionType::Navigate, 0, -1}); break;
+        case VK_DOWN:  ApplyAction({InputActionType::Navigate, 0, 1}); break;
+        
+        default: {
+            // Any other key switches to keyboard navigation and picks up the selection;
+            // Enter launches it unless there was none to pick up and one was just chosen
+            bool hadSelection = selectedIconIndex != -1 ||
+                (lastSelectedIconIndex != -1 && lastSelectedIconIndex < static_cast<int>(tabs[activeTabIndex].shortcuts.size()));
+            ApplyAction({InputActionType::Navigate, 0, 0});
+            if (wParam == VK_RETURN && hadSelection) {
+                ApplyAction({InputActionType::Launch});
             }
             break;
-            
-        case VK_RETURN:
-            LaunchSelectedIcon();
-            return;
-    }
-    
-    // Update selection if it changed
-    if (newSelectedIndex != selectedIconIndex) {
-        SetSelectedIcon(newSelectedIndex, true);
+        }
     }
 }
 
@@ -1182,181 +1012,157 @@ void WindowManager::HandleTabClick(int x, int y) {
 }
 
 void WindowManager::SetActiveTab(int tabIndex) {
-    if (tabIndex < 0 || tabIndex >= static_cast<int>(tabs.size())) {
+    ApplyAction({InputActionType::SelectTab, tabIndex});
+}
+
+void WindowManager::CollectDamage(HWND hwnd) {
+    HRGN updateRegion = CreateRectRgn(0, 0, 0, 0);
+    if (GetUpdateRgn(hwnd, updateRegion, FALSE) > NULLREGION) {
+        // Complex regions come back as a list of bands; the accumulator merges them
+        DWORD dataSize = GetRegionData(updateRegion, 0, nullptr);
+        std::vector<BYTE> data(dataSize);
+        RGNDATA* regionData = reinterpret_cast<RGNDATA*>(data.data());
+        if (dataSize && GetRegionData(updateRegion, dataSize, regionData)) {
+            const RECT* rects = reinterpret_cast<const RECT*>(regionData->Buffer);
+            for (DWORD i = 0; i < regionData->rdh.nCount; i++) {
+                damage.Add(PixelRect(rects[i].left, rects[i].top, rects[i].right, rects[i].bottom));
+            }
+        } else {
+            RECT bounds;
+            GetRgnBox(updateRegion, &bounds);
+            damage.Add(PixelRect(bounds.left, bounds.top, bounds.right, bounds.bottom));
+        }
+    }
+    DeleteObject(updateRegion);
+}
+
+void WindowManager::ScrollBuffer(int scrollDelta) {
+    if (scrollDelta == 0) {
         return;
     }
     
-    if (activeTabIndex == tabIndex) {
-        return; // No change needed
+    RECT clientRect;
+    GetClientRect(mainWindow, &clientRect);
+    RECT gridRect = GetGridRect(clientRect);
+    
+    if (!offscreenBits || !IsValidTabState()) {
+        InvalidateRect(mainWindow, &gridRect, FALSE);
+        return;
     }
     
-    activeTabIndex = tabIndex;
-    tabBufferDirty = true; // Mark tab buffer for redraw
+    // Take over the pending invalidations; they were computed before this scroll
+    CollectDamage(mainWindow);
+    ValidateRect(mainWindow, nullptr);
     
-    // Reset scroll offset when switching tabs
-    scrollOffset = 0;
+    PixelRect scrollArea = PixelRect::Intersect(PixelRect(gridRect.left, gridRect.top, gridRect.right, gridRect.bottom),
+                                                PixelRect(0, 0, offscreenWidth, offscreenHeight));
     
-    // Select first icon when switching tabs
-    if (!tabs[tabIndex].shortcuts.empty()) {
-        selectedIconIndex = 0;
-        lastSelectedIconIndex = 0;
-        usingKeyboardNavigation = true;
-    } else {
-        selectedIconIndex = -1;
-        lastSelectedIconIndex = -1;
-        usingKeyboardNavigation = false;
+    // Nothing to reuse if the whole grid is being redrawn anyway (tab switch, resize, reload)
+    if (damage.Contains(scrollArea) || scrollArea.IsEmpty()) {
+        damage.Add(PixelRect(gridRect.left, gridRect.top, gridRect.right, gridRect.bottom));
+        InvalidateDamage();
+        return;
     }
     
-    // Update grid renderer to point directly to the active tab's shortcuts
-    if (gridRenderer && activeTabIndex < static_cast<int>(tabs.size())) {
-        gridRenderer->SetShortcuts(&tabs[activeTabIndex].shortcuts);
-    }
+    // Stale pixels inside the grid move with it, so their damage moves too
+    damage.Scroll(scrollArea, scrollDelta);
+    damage.Add(ScrollBlit::ScrollRows(static_cast<uint32_t*>(offscreenBits), offscreenWidth, scrollArea, scrollDelta));
+    frameComposer->ScrollLayer(scrollArea, scrollDelta);
     
-    // Save the new active tab to INI file
-    SaveWindowState();
+    // The selection border overhangs the grid top and does not scroll with it
+    damage.Add(PixelRect(scrollArea.left, gridRect.top - DesignConstants::SELECTION_BORDER_EXTENSION,
+                         scrollArea.right, gridRect.top));
     
-    // Redraw window - use FALSE to avoid erasing background unnecessarily
-    if (mainWindow) {
-        InvalidateRect(mainWindow, nullptr, FALSE);
+    // Outlines of the last painted and the new selection, at their scrolled positions
+    GridLayout layout = GetGridLayout();
+    damage.Add(layout.GetItemBounds(renderedSelectedIndex, scrollOffset));
+    damage.Add(layout.GetItemBounds(selectedIconIndex, scrollOffset));
+    
+    InvalidateDamage();
+}
+
+void WindowManager::InvalidateDamage() {
+    for (const PixelRect& dirty : damage.GetRects()) {
+        RECT dirtyRect = {dirty.left, dirty.top, dirty.right, dirty.bottom};
+        InvalidateRect(mainWindow, &dirtyRect, FALSE);
     }
 }
 
-void WindowManager::DrawTabs(HDC hdc, const RECT& clientRect) {
-    if (tabs.empty()) return;
+void WindowManager::StorePage() {
+    // Only the top of the tab is kept, and only once everything queued is painted
+    if (!offscreenBits || !mainWindow || isResizing || scrollOffset != 0 || !IsValidTabState() ||
+        !damage.IsEmpty() || GetUpdateRect(mainWindow, nullptr, FALSE)) {
+        return;
+    }
+    
+    RECT clientRect;
+    GetClientRect(mainWindow, &clientRect);
+    RasterImage frame{static_cast<const uint32_t*>(offscreenBits), offscreenWidth, offscreenHeight, offscreenWidth};
+    pageCache.Store(activeTabIndex, GetDpiPercent(), renderedSelectedIndex, frame, GetPageArea(clientRect));
+}
 
-    RECT tabBarRect = GetTabBarRect(clientRect);
-    int width = tabBarRect.right - tabBarRect.left;
-    int height = tabBarRect.bottom - tabBarRect.top;
-    
-    // Create or resize tab buffer if needed
-    if (!tabBufferDC || tabBufferWidth != width || tabBufferHeight != height) {
-        // Clean up old buffer
-        if (tabBufferDC) {
-            if (oldTabBitmap) {
-                SelectObject(tabBufferDC, oldTabBitmap);
-            }
-            if (tabBufferBitmap) {
-                DeleteObject(tabBufferBitmap);
-            }
-            DeleteDC(tabBufferDC);
-        }
-        
-        // Create new buffer
-        BITMAPINFO bmi = {0};
-        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-        bmi.bmiHeader.biWidth = width;
-        bmi.bmiHeader.biHeight = -height;
-        bmi.bmiHeader.biPlanes = 1;
-        bmi.bmiHeader.biBitCount = 32;
-        bmi.bmiHeader.biCompression = BI_RGB;
-        
-        tabBufferDC = CreateCompatibleDC(hdc);
-        tabBufferBitmap = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, &tabBufferBits, nullptr, 0);
-        oldTabBitmap = (HBITMAP)SelectObject(tabBufferDC, tabBufferBitmap);
-        tabBufferWidth = width;
-        tabBufferHeight = height;
-        tabBufferDirty = true;
-    }
-    
-    // Render tabs to buffer if dirty
-    if (tabBufferDirty) {
-        DWORD* pixels = (DWORD*)tabBufferBits;
-        DWORD tabBarColor = 0xFF2D2D32;
-        
-        // Fill background
-        for (int i = 0; i < width * height; i++) {
-            pixels[i] = tabBarColor;
-        }
-        
-        // Set up text rendering
-        SetTextColor(tabBufferDC, RGB(255, 255, 255));
-        SetBkMode(tabBufferDC, TRANSPARENT);
-        
-        HFONT hFont = CreateFont(Settings::Instance().GetTabFontSize(), 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE,
-                                DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-                                ANTIALIASED_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"Segoe UI");
-        HFONT hOldFont = (HFONT)SelectObject(tabBufferDC, hFont);
-        
-        int tabWidth = width / static_cast<int>(tabs.size());
-        
-        for (size_t i = 0; i < tabs.size(); ++i) {
-            RECT tabRect;
-            tabRect.left = static_cast<int>(i) * tabWidth;
-            tabRect.right = tabRect.left + tabWidth;
-            tabRect.top = 0;
-            tabRect.bottom = height;
-            
-            if (i == tabs.size() - 1) {
-                tabRect.right = width;
-            }
-            
-            // Draw tab background
-            bool isActiveTab = (static_cast<int>(i) == activeTabIndex);
-            COLORREF baseColor = GetTabColor(tabs[i].name, isActiveTab);
-            DWORD tabColor = 0xFF000000 | (GetRValue(baseColor) << 16) | 
-                            (GetGValue(baseColor) << 8) | GetBValue(baseColor);
-            
-            for (int y = tabRect.top; y < tabRect.bottom; y++) {
-                for (int x = tabRect.left; x < tabRect.right; x++) {
-                    if (x >= 0 && x < width && y >= 0 && y < height) {
-                        pixels[y * width + x] = tabColor;
-                    }
-                }
-            }
-            
-            // Draw tab border
-            HPEN borderPen = CreatePen(PS_SOLID, 1, RGB(100, 100, 107));
-            HPEN oldPen = (HPEN)SelectObject(tabBufferDC, borderPen);
-            
-            MoveToEx(tabBufferDC, tabRect.left, tabRect.top, nullptr);
-            LineTo(tabBufferDC, tabRect.right, tabRect.top);
-            LineTo(tabBufferDC, tabRect.right, tabRect.bottom);
-            LineTo(tabBufferDC, tabRect.left, tabRect.bottom);
-            LineTo(tabBufferDC, tabRect.left, tabRect.top);
-            
-            SelectObject(tabBufferDC, oldPen);
-            DeleteObject(borderPen);
-            
-            // Draw tab text
-            RECT textRect = tabRect;
-            textRect.left += 8;
-            textRect.right -= 8;
-            textRect.top += 4;
-            textRect.bottom -= 4;
-            
-            DrawText(tabBufferDC, tabs[i].name.c_str(), -1, &textRect, 
-                    DT_CENTER | DT_VCENTER | DT_SINGLELINE | DT_NOPREFIX);
-        }
-        
-        SelectObject(tabBufferDC, hOldFont);
-        DeleteObject(hFont);
-        
-        tabBufferDirty = false;
+bool WindowManager::RestorePage() {
+    if (!offscreenBits || isResizing || scrollOffset != 0 || !IsValidTabState()) {
+        return false;
     }
     
-    // BitBlt cached buffer to main buffer
-    BitBlt(hdc, tabBarRect.left, tabBarRect.top, width, height,
-           tabBufferDC, 0, 0, SRCCOPY);
+    RECT clientRect;
+    GetClientRect(mainWindow, &clientRect);
+    PixelRect pageArea = GetPageArea(clientRect);
+    
+    RasterSurface frame;
+    frame.pixels = static_cast<uint32_t*>(offscreenBits);
+    frame.width = offscreenWidth;
+    frame.height = offscreenHeight;
+    frame.stride = offscreenWidth;
+    
+    int pageSelectedIndex = -1;
+    if (!pageCache.Restore(activeTabIndex, GetDpiPercent(), frame, pageArea, pageSelectedIndex)) {
+        return false;
+    }
+    renderedSelectedIndex = pageSelectedIndex;
+    
+    // Everything around the page, which includes the tab bar
+    PixelRect outside[4];
+    int outsideCount = PixelRect::Subtract(frame.Bounds(), pageArea, outside);
+    for (int i = 0; i < outsideCount; i++) {
+        damage.Add(outside[i]);
+    }
+    
+    // The page may have been kept with another icon selected
+    if (pageSelectedIndex != selectedIconIndex) {
+        GridLayout layout = GetGridLayout();
+        damage.Add(layout.GetItemBounds(pageSelectedIndex, scrollOffset));
+        damage.Add(layout.GetItemBounds(selectedIconIndex, scrollOffset));
+    }
+    
+    InvalidateDamage();
+    return true;
+}
+
+PixelRect WindowManager::GetPageArea(const RECT& clientRect) const {
+    RECT gridRect = FrameComposer::GetGridRect(clientRect);
+    return PixelRect::Intersect(PixelRect(gridRect.left, gridRect.top, gridRect.right, gridRect.bottom),
+                                PixelRect(0, 0, offscreenWidth, offscreenHeight));
 }
 
 RECT WindowManager::GetTabBarRect(const RECT& clientRect) {
-    RECT tabBarRect = clientRect;
-    tabBarRect.bottom = tabBarRect.top + Settings::Instance().GetTabHeight();
-    return tabBarRect;
+    return FrameComposer::GetTabBarRect(clientRect);
 }
 
 RECT WindowManager::GetGridRect(const RECT& clientRect) {
-    RECT gridRect = clientRect;
-    gridRect.top += Settings::Instance().GetTabHeight();
-    
-    // Apply equal margins on all sides (left, right, and additional top margin)
-    // The top already has TAB_HEIGHT, so we add GRID_MARGIN to match lateral margins
-    gridRect.top += DesignConstants::GRID_MARGIN;
-    gridRect.left += DesignConstants::GRID_MARGIN;
-    gridRect.right -= DesignConstants::GRID_MARGIN;
-    gridRect.bottom -= DesignConstants::GRID_MARGIN;
-    
-    return gridRect;
+    return FrameComposer::GetGridRect(clientRect);
+}
+
+FrameState WindowManager::GetFrameState(const RECT& clientRect) {
+    FrameState state;
+    state.tabs = &tabs;
+    state.activeTabIndex = activeTabIndex;
+    state.scrollOffset = scrollOffset;
+    state.selectedIconIndex = selectedIconIndex;
+    state.dpiScaleFactor = GetDpiScaleFactor();
+    state.clientRect = clientRect;
+    return state;
 }
 
 int WindowManager::GetTabAtPoint(POINT point, const RECT& clientRect) {
@@ -1380,67 +1186,8 @@ int WindowManager::GetTabAtPoint(POINT point, const RECT& clientRect) {
     return -1;
 }
 
-COLORREF WindowManager::GetTabColor(const std::wstring& tabName, bool isActive) {
-    if (!isActive) {
-        return Settings::Instance().GetTabInactiveColor();
-    }
-    
-    // Check if this tab has a specific color defined
-    COLORREF tabColor = Settings::Instance().GetTabColor(tabName);
-    return tabColor;
-}
-
 void WindowManager::SetSelectedIcon(int iconIndex, bool fromKeyboard) {
-    if (tabs.empty() || activeTabIndex >= static_cast<int>(tabs.size())) {
-        return;
-    }
-    
-    auto& currentTabShortcuts = tabs[activeTabIndex].shortcuts;
-    if (currentTabShortcuts.empty()) {
-        return;
-    }
-    
-    // Validate icon index (-1 is valid for no selection)
-    if (iconIndex < -1 || iconIndex >= static_cast<int>(currentTabShortcuts.size())) {
-        return;
-    }
-    
-    int oldSelectedIndex = selectedIconIndex;
-    
-    // Track last selected icon before clearing (but not when setting to -1)
-    if (selectedIconIndex != -1 && iconIndex == -1) {
-        lastSelectedIconIndex = selectedIconIndex;
-    } else if (iconIndex != -1) {
-        lastSelectedIconIndex = iconIndex;
-    }
-    
-    selectedIconIndex = iconIndex;
-    usingKeyboardNavigation = fromKeyboard;
-    
-    // Ensure the selected icon is visible if using keyboard
-    if (fromKeyboard && selectedIconIndex != -1) {
-        EnsureSelectedIconVisible();
-    }
-    
-    // Sync grid renderer scroll offset before computing icon bounds
-    if (gridRenderer) {
-        gridRenderer->SetScrollOffset(scrollOffset);
-    }
-    
-    // Invalidate the old and new selected icons for redraw
-    RECT clientRect;
-    GetClientRect(mainWindow, &clientRect);
-    RECT gridRect = GetGridRect(clientRect);
-    
-    if (oldSelectedIndex != -1 && gridRenderer) {
-        RECT oldIconBounds = gridRenderer->GetIconBounds(oldSelectedIndex, gridRect);
-        InvalidateRect(mainWindow, &oldIconBounds, FALSE);
-    }
-    
-    if (selectedIconIndex != -1 && gridRenderer) {
-        RECT newIconBounds = gridRenderer->GetIconBounds(selectedIconIndex, gridRect);
-        InvalidateRect(mainWindow, &newIconBounds, FALSE);
-    }
+    ApplyAction({InputActionType::Select, iconIndex, fromKeyboard ? 1 : 0});
 }
 
 void WindowManager::LaunchSelectedIcon() {
@@ -1472,54 +1219,8 @@ void WindowManager::LaunchSelectedIcon() {
     }
 }
 
-void WindowManager::EnsureSelectedIconVisible() {
-    if (!IsValidTabState() || selectedIconIndex < 0 || 
-        selectedIconIndex >= static_cast<int>(tabs[activeTabIndex].shortcuts.size())) {
-        return;
-    }
-    
-    // Get grid layout information using DPI-aware sizes
-    RECT clientRect;
-    GetClientRect(mainWindow, &clientRect);
-    RECT gridRect = GetGridRect(clientRect);
-    
-    int availableWidth = gridRect.right - gridRect.left;
-    int physicalIconSize = GetScaledIconSize();
-    int itemWidth = physicalIconSize + Settings::Instance().GetIconSpacingHorizontal();
-    int cols = CalculateGridColumns(gridRect);
-    
-    // Calculate the selected icon's position
-    int row = selectedIconIndex / cols;
-    int totalItemHeight = physicalIconSize + DesignConstants::LABEL_HEIGHT + Settings::Instance().GetIconVerticalPadding();
-    int itemHeight = totalItemHeight + Settings::Instance().GetIconSpacingVertical();
-    
-    // Account for the startY padding in GridRenderer (SELECTION_BORDER_PADDING)
-    int iconTop = DesignConstants::SELECTION_BORDER_PADDING + row * itemHeight - scrollOffset;
-    int iconBottom = iconTop + totalItemHeight;
-    
-    int viewportTop = 0;
-    int viewportBottom = gridRect.bottom - gridRect.top;
-    
-    // Get optimized repaint rect
-    RECT optimizedGridRect = GetOptimizedGridRect(gridRect, cols, itemWidth, availableWidth);
-    
-    // Check if icon is above the viewport
-    if (iconTop - DesignConstants::SELECTION_BORDER_EXTENSION < viewportTop) {
-        scrollOffset = max(0, DesignConstants::SELECTION_BORDER_PADDING + row * itemHeight - DesignConstants::SELECTION_BORDER_EXTENSION);
-        InvalidateRect(mainWindow, &optimizedGridRect, FALSE);
-    }
-    // Check if icon is below the viewport
-    else if (iconBottom > viewportBottom) {
-        scrollOffset = DesignConstants::SELECTION_BORDER_PADDING + (row * itemHeight) - viewportBottom + totalItemHeight;
-        
-        // Ensure we don't scroll past the maximum
-        int totalRows = (static_cast<int>(tabs[activeTabIndex].shortcuts.size()) + cols - 1) / cols;
-        int totalContentHeight = totalRows * itemHeight;
-        int maxScroll = max(0, totalContentHeight - viewportBottom);
-        scrollOffset = min(scrollOffset, maxScroll);
-        
-        InvalidateRect(mainWindow, &optimizedGridRect, FALSE);
-    }
+int WindowManager::GetDpiPercent() {
+    return static_cast<int>(GetDpiScaleFactor() * 100.0f + 0.5f);
 }
 
 float WindowManager::GetDpiScaleFactor() {
@@ -1537,184 +1238,295 @@ float WindowManager::GetDpiScaleFactor() {
 }
 
 void WindowManager::HandleControllerInput() {
-    if (!controllerManager) {
+    if (!inputThread) {
         return;
     }
     
-    // Update controller state
-    controllerManager->Update();
-    
-    if (!controllerManager->IsConnected()) {
+    // Events come from the input thread in the order they were polled
+    InputEvent event;
+    while (IsVisible() && inputThread->PopEvent(event)) {
+        switch (event.type) {
+            case InputEventType::ButtonDown:
+                switch (event.button) {
+                    case XINPUT_GAMEPAD_B:
+                        // Hide window; the input thread stops with it and the rest of the
+                        // queue is discarded when shown again
+                        HideWindow();
+                        break;
+                    
+                    case XINPUT_GAMEPAD_A:
+                        // Launch selected icon
+                        ApplyAction({InputActionType::Launch});
+                        break;
+                    
+                    case XINPUT_GAMEPAD_LEFT_SHOULDER:
+                    case XINPUT_GAMEPAD_RIGHT_SHOULDER:
+                        // Change tabs
+                        if (!tabs.empty()) {
+                            int step = event.button == XINPUT_GAMEPAD_LEFT_SHOULDER ? -1 : 1;
+                            int tabCount = static_cast<int>(tabs.size());
+                            SetActiveTab((activeTabIndex + step + tabCount) % tabCount);
+                        }
+                        break;
+                    
+                    case XINPUT_GAMEPAD_DPAD_LEFT:  ApplyAction({InputActionType::Navigate, -1, 0}); break;
+                    case XINPUT_GAMEPAD_DPAD_RIGHT: ApplyAction({InputActionType::Navigate, 1, 0}); break;
+                    case XINPUT_GAMEPAD_DPAD_UP:    ApplyAction({InputActionType::Navigate, 0, -1}); break;
+                    case XINPUT_GAMEPAD_DPAD_DOWN:  ApplyAction({InputActionType::Navigate, 0, 1}); break;
+                }
+                break;
+            
+            case InputEventType::StickDirection:
+                // Left stick moves like the D-pad
+                ApplyAction({InputActionType::Navigate, event.dx, event.dy});
+                break;
+            
+            case InputEventType::Scroll:
+                // Right stick scrolls at a speed set by how far it is pushed, until released
+                HandleJoystickScroll(event.dy);
+                break;
+            
+            default:
+                break;
+        }
+        
+        // Timed from the poll that saw it, so time spent queued counts too
+        if (event.type == InputEventType::Scroll) {
+            TrackScrollInput(InputLatencyType::ControllerScroll, event.time);
+        } else {
+            TrackInput(InputLatencyType::ControllerButton, event.time);
+        }
+    }
+}
+
+void WindowManager::TrackInput(InputLatencyType type, int64_t time) {
+    // Inputs that changed nothing on screen, or hid it, have no present to wait for
+    if (!IsVisible() || !GetUpdateRect(mainWindow, nullptr, FALSE)) {
         return;
     }
+    if (pendingInputs.size() < MAX_PENDING_INPUTS) {
+        pendingInputs.push_back({type, time});
+    }
+}
 
-    // Handle B button - hide window
-    if (controllerManager->IsButtonPressed(XINPUT_GAMEPAD_B)) {
-        HideWindow();
-        return;  // Exit after hiding window
+void WindowManager::TrackScrollInput(InputLatencyType type, int64_t time) {
+    // A gliding scroll shows nothing until its first frame moves the grid
+    if (mainWindow && !GetUpdateRect(mainWindow, nullptr, FALSE) && IsScrolling()) {
+        if (scrollInputs.size() < MAX_PENDING_INPUTS) {
+            scrollInputs.push_back({type, time});
+        }
+        return;
+    }
+    TrackInput(type, time);
+}
+
+void WindowManager::RecordPresentedInput() {
+    int64_t presentTime = MessageLoop::GetMicroseconds();
+    for (const PendingInput& input : pendingInputs) {
+        inputLatency.Record(input.type, presentTime - input.time);
+    }
+    pendingInputs.clear();
+}
+
+bool WindowManager::SaveLatencyReport() const {
+    std::wstring report = inputLatency.GetReport();
+    if (inputThread) {
+        report += L"Dropped controller events: " + std::to_wstring(inputThread->GetDroppedEvents()) + L"\n";
     }
     
-    // Handle A button - launch selected icon
-    if (controllerManager->IsButtonPressed(XINPUT_GAMEPAD_A)) {
-        LaunchSelectedIcon();
-        return;  // Exit after launching
+    int size = WideCharToMultiByte(CP_UTF8, 0, report.c_str(), static_cast<int>(report.size()), nullptr, 0, nullptr, nullptr);
+    std::string utf8(size, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, report.c_str(), static_cast<int>(report.size()), &utf8[0], size, nullptr, nullptr);
+    return WriteDataFile(L"latency.txt", utf8.data(), utf8.size());
+}
+
+void WindowManager::StartInputRecording() {
+    if (!mainWindow) {
+        return;
     }
     
-    // Handle shoulder buttons - change tabs (don't return, allow scrolling)
-    if (controllerManager->IsButtonPressed(XINPUT_GAMEPAD_LEFT_SHOULDER)) {
-        if (!tabs.empty()) {
-            int newTab = (activeTabIndex - 1 + static_cast<int>(tabs.size())) % static_cast<int>(tabs.size());
-            SetActiveTab(newTab);
-        }
+    // Everything replay needs to lay the grid out the same way
+    RECT clientRect;
+    GetClientRect(mainWindow, &clientRect);
+    GridLayout layout = GetGridLayout();
+    InputLogHeader header;
+    header.clientWidth = clientRect.right - clientRect.left;
+    header.clientHeight = clientRect.bottom - clientRect.top;
+    header.dpiPercent = GetDpiPercent();
+    header.gridArea = layout.GetArea();
+    header.metrics = layout.GetMetrics();
+    for (const TabInfo& tab : tabs) {
+        header.tabItemCounts.push_back(static_cast<int>(tab.shortcuts.size()));
+    }
+    header.start = GetNavigationState();
+    
+    inputLog = std::make_unique<InputLog>();
+    inputLog->Begin(header);
+    recordingStartTime = MessageLoop::GetMicroseconds();
+    if (trayManager) {
+        trayManager->SetRecordingChecked(true);
+    }
+}
+
+bool WindowManager::StopInputRecording() {
+    if (!inputLog) {
+        return false;
     }
     
-    if (controllerManager->IsButtonPressed(XINPUT_GAMEPAD_RIGHT_SHOULDER)) {
-        if (!tabs.empty()) {
-            int newTab = (activeTabIndex + 1) % static_cast<int>(tabs.size());
-            SetActiveTab(newTab);
-        }
+    std::vector<uint8_t> data = inputLog->Encode();
+    inputLog.reset();
+    if (trayManager) {
+        trayManager->SetRecordingChecked(false);
     }
+    return WriteDataFile(L"input.rec", data.data(), data.size());
+}
+
+bool WindowManager::WriteDataFile(const wchar_t* fileName, const void* data, size_t size) const {
+    // Next to launcher.ini, in the working directory
+    wchar_t currentDir[MAX_PATH];
+    GetCurrentDirectory(MAX_PATH, currentDir);
+    std::wstring path = std::wstring(currentDir) + L"\\" + fileName;
     
-    // Handle navigation - D-pad or left stick (only on initial press)
-    bool dpadLeft = controllerManager->IsDPadPressed(3);
-    bool dpadRight = controllerManager->IsDPadPressed(1);
-    bool dpadUp = controllerManager->IsDPadPressed(0);
-    bool dpadDown = controllerManager->IsDPadPressed(2);
-    bool stickLeft = controllerManager->IsLeftStickPressed(3);
-    bool stickRight = controllerManager->IsLeftStickPressed(1);
-    bool stickUp = controllerManager->IsLeftStickPressed(0);
-    bool stickDown = controllerManager->IsLeftStickPressed(2);
-    
-    bool moveLeft = dpadLeft || stickLeft;
-    bool moveRight = dpadRight || stickRight;
-    bool moveUp = dpadUp || stickUp;
-    bool moveDown = dpadDown || stickDown;
-    
-    if (moveLeft || moveRight || moveUp || moveDown) {
-        int moveX = 0;
-        int moveY = 0;
+    HANDLE file = CreateFile(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    DWORD bytesWritten = 0;
+    bool success = WriteFile(file, data, static_cast<DWORD>(size), &bytesWritten, nullptr) && bytesWritten == size;
+    CloseHandle(file);
+    return success;
+}
+
+void WindowManager::ApplyAction(InputAction action) {
+    NavigationState previous = GetNavigationState();
+    NavigationState next = previous;
+    
+    // Same dispatch as InputReplay::Step
+    switch (action.type) {
+        case InputActionType::Navigate:
+            GridNavigator::Navigate(next, GetGridLayout(), action.x, action.y);
+            break;
         
-        // D-pad has priority - it's digital so no magnitude comparison needed
-        bool usingDpad = dpadLeft || dpadRight || dpadUp || dpadDown;
+        case InputActionType::Scroll:
+            GridNavigator::ScrollBy(next, GetGridLayout(), action.x);
+            break;
         
-        if (usingDpad) {
-            // D-pad: take whatever directions are pressed (no priority)
-            if (dpadLeft) moveX = -1;
-            else if (dpadRight) moveX = 1;
-            
-            if (dpadUp) moveY = -1;
-            else if (dpadDown) moveY = 1;
-        } else {
-            // Analog stick: use magnitude comparison
-            SHORT rawX = controllerManager->GetLeftStickRawX();
-            SHORT rawY = controllerManager->GetLeftStickRawY();
-            
-            if (abs(rawY) > abs(rawX)) {
-                // Vertical movement is stronger
-                if (stickUp) moveY = -1;
-                else if (stickDown) moveY = 1;
-            } else {
-                // Horizontal movement is stronger (or equal)
-                if (stickLeft) moveX = -1;
-                else if (stickRight) moveX = 1;
+        case InputActionType::SelectTab: {
+            bool validTab = action.x >= 0 && action.x < static_cast<int>(tabs.size());
+            int itemCount = validTab ? static_cast<int>(tabs[action.x].shortcuts.size()) : 0;
+            GridNavigator::SelectTab(next, action.x, static_cast<int>(tabs.size()), itemCount);
+            if (next.activeTabIndex != previous.activeTabIndex) {
+                StorePage(); // Keep the page being left
             }
+            break;
         }
         
-        HandleControllerNavigation(moveX, moveY);
+        case InputActionType::Select:
+            GridNavigator::Select(next, GetGridLayout(), action.x, action.y != 0);
+            break;
+        
+        case InputActionType::Resize:
+            GridNavigator::ResetView(next);
+            break;
+        
+        default:
+            break;
     }
+    SetNavigationState(next);
     
-    // Handle right stick scrolling (continuous while held)
-    // Always check scrolling, even if other buttons were pressed
-    int rightStickY = controllerManager->GetRightStickY();
-    
-    if (rightStickY != 0) {
-        // Continuous scrolling based on stick position
-        // XInput: positive Y = up, negative Y = down
-        // Scroll direction: negative = scroll down (content moves up)
-        // So we need to invert: -rightStickY
-        int scrollDelta = -rightStickY * Settings::Instance().GetJoystickScrollSpeed();
-        HandleJoystickScroll(scrollDelta);
-    }
-}
-
-void WindowManager::HandleControllerNavigation(int moveX, int moveY) {
-    if (!IsValidTabState()) {
-        return;
+    // Keys, clicks, tab switches and resizes that move the grid stop a scroll gliding on;
+    // only its own steps come in as Scroll
+    if (action.type == InputActionType::SelectTab || action.type == InputActionType::Resize ||
+        (action.type != InputActionType::Scroll && next.scrollOffset != previous.scrollOffset)) {
+        scrollPhysics.Reset(next.scrollOffset);
     }
     
-    // Switch to controller navigation mode
-    usingKeyboardNavigation = true;
+    // Recorded before launching, which may hide the window
+    if (inputLog) {
+        action.time = MessageLoop::GetMicroseconds() - recordingStartTime;
+        inputLog->Add(action, next);
+    }
     
-    // If no icon is selected, try to resume from last selected position
-    if (selectedIconIndex == -1) {
-        // If we have a last selected icon, use it as the starting point
-        if (lastSelectedIconIndex != -1 && lastSelectedIconIndex < static_cast<int>(tabs[activeTabIndex].shortcuts.size())) {
-            selectedIconIndex = lastSelectedIconIndex;
-            // Don't return - let the navigation logic below handle the movement
-        } else {
-            // No previous selection - select first fully visible icon
-            RECT clientRect;
-            GetClientRect(mainWindow, &clientRect);
-            RECT gridRect = GetGridRect(clientRect);
-            int cols = CalculateGridColumns(gridRect);
-            
-            int physicalIconSize = GetScaledIconSize();
-            int totalItemHeight = physicalIconSize + DesignConstants::LABEL_HEIGHT + Settings::Instance().GetIconVerticalPadding();
-            int rowHeight = totalItemHeight + Settings::Instance().GetIconSpacingVertical();
+    switch (action.type) {
+        case InputActionType::Navigate:
+        case InputActionType::Select:
+            RepaintSelection(previous);
+            break;
+        
+        case InputActionType::Scroll:
+            // Move the already drawn grid and redraw only the rows that scrolled into view
+            ScrollBuffer(scrollOffset - previous.scrollOffset);
+            break;
+        
+        case InputActionType::SelectTab:
+            if (activeTabIndex == previous.activeTabIndex) {
+                break;
+            }
+            frameComposer->InvalidateTabs(); // Mark tab buffer for redraw
             
-            // Calculate first fully visible row
-            int firstFullyVisibleRow = (scrollOffset + rowHeight - 1) / rowHeight;
-            int firstVisibleIconIndex = firstFullyVisibleRow * cols;
+            // Update grid renderer to point directly to the active tab's shortcuts
+            if (gridRenderer) {
+                gridRenderer->SetShortcuts(&tabs[activeTabIndex].shortcuts);
+            }
             
-            // Clamp to valid range
-            int totalIcons = static_cast<int>(tabs[activeTabIndex].shortcuts.size());
-            firstVisibleIconIndex = max(0, min(firstVisibleIconIndex, totalIcons - 1));
+            // Save the new active tab to INI file
+            SaveWindowState();
             
-            SetSelectedIcon(firstVisibleIconIndex, true);
-            return;
-        }
+            // Redraw window - use FALSE to avoid erasing background unnecessarily. A kept page
+            // leaves only the tab bar and selection to draw.
+            if (mainWindow && !RestorePage()) {
+                InvalidateRect(mainWindow, nullptr, FALSE);
+            }
+            break;
+        
+        case InputActionType::Launch:
+            LaunchSelectedIcon();
+            break;
+        
+        default:
+            // A resize repaints everything from WM_SIZE
+            break;
     }
-    
-    // Get grid layout information using DPI-aware sizes
-    RECT clientRect;
-    GetClientRect(mainWindow, &clientRect);
-    RECT gridRect = GetGridRect(clientRect);
-    
-    int cols = CalculateGridColumns(gridRect);
-    int totalIcons = static_cast<int>(tabs[activeTabIndex].shortcuts.size());
-    
-    int newSelectedIndex = selectedIconIndex;
-    
-    // Handle horizontal movement
-    if (moveX == -1 && selectedIconIndex > 0) {
-        newSelectedIndex = selectedIconIndex - 1;
-    } else if (moveX == 1 && selectedIconIndex < totalIcons - 1) {
-        newSelectedIndex = selectedIconIndex + 1;
+}
+
+void WindowManager::RepaintSelection(const NavigationState& previous) {
+    if (selectedIconIndex == previous.selectedIconIndex && scrollOffset == previous.scrollOffset) {
+        return;
     }
     
-    // Handle vertical movement
-    if (moveY == -1 && selectedIconIndex >= cols) {
-        newSelectedIndex = selectedIconIndex - cols;
-    } else if (moveY == 1) {
-        if (selectedIconIndex + cols < totalIcons) {
-            // There's an icon directly below
-            newSelectedIndex = selectedIconIndex + cols;
-        } else {
-            // No icon directly below, but check if there's another row
-            int currentRow = selectedIconIndex / cols;
-            int nextRow = currentRow + 1;
-            int nextRowStart = nextRow * cols;
-            
-            if (nextRowStart < totalIcons) {
-                // There is a next row, move to the last icon on that row
-                int nextRowEnd = min(nextRowStart + cols - 1, totalIcons - 1);
-                newSelectedIndex = nextRowEnd;
-            }
-        }
+    GridLayout layout = GetGridLayout();
+    if (scrollOffset != previous.scrollOffset) {
+        // Scrolled to bring the selection into view; only the columns in use need repainting
+        PixelRect bounds = layout.GetItemsBounds();
+        RECT itemsRect = {bounds.left, bounds.top, bounds.right, bounds.bottom};
+        InvalidateRect(mainWindow, &itemsRect, FALSE);
     }
     
-    // Update selection if it changed
-    if (newSelectedIndex != selectedIconIndex) {
-        SetSelectedIcon(newSelectedIndex, true);
+    // Invalidate the old and new selected icons for redraw
+    int redrawIndices[] = {previous.selectedIconIndex, selectedIconIndex};
+    for (int index : redrawIndices) {
+        PixelRect bounds = layout.GetItemBounds(index, scrollOffset);
+        if (!bounds.IsEmpty()) {
+            RECT iconBounds = {bounds.left, bounds.top, bounds.right, bounds.bottom};
+            InvalidateRect(mainWindow, &iconBounds, FALSE);
+        }
     }
 }
+
+NavigationState WindowManager::GetNavigationState() const {
+    NavigationState state;
+    state.activeTabIndex = activeTabIndex;
+    state.scrollOffset = scrollOffset;
+    state.selectedIconIndex = selectedIconIndex;
+    state.lastSelectedIconIndex = lastSelectedIconIndex;
+    state.usingKeyboardNavigation = usingKeyboardNavigation;
+    return state;
+}
+
+void WindowManager::SetNavigationState(const NavigationState& state) {
+    activeTabIndex = state.activeTabIndex;
+    scrollOffset = state.scrollOffset;
+    selectedIconIndex = state.selectedIconIndex;
+    lastSelectedIconIndex = state.lastSelectedIconIndex;
+    usingKeyboardNavigation = state.usingKeyboardNavigation;
+}
@@ -6,11 +6,20 @@
 #include <vector>
 #include <map>
 #include "DataModels.h"
+#include "DamageRegion.h"
+#include "GridLayout.h"
+#include "GridNavigator.h"
+#include "InputLatency.h"
+#include "InputLog.h"
+#include "PageCache.h"
+#include "ScrollPhysics.h"
 
 class GridRenderer;
 class TrayManager;
 class ShortcutScanner;
-class ControllerManager;
+class InputThread;
+class FrameComposer;
+struct FrameState;
 
 class WindowManager {
 public:
@@ -31,21 +40,35 @@ public:
     void SetTrayManager(TrayManager* trayMgr) { trayManager = trayMgr; }
     void SetShortcutScanner(ShortcutScanner* scanner) { shortcutScanner = scanner; }
     
-    void HandleControllerInput();       // Controller input processing
+    void HandleControllerInput();       // Handle the events the input thread queued
+    
+    // Wheel and stick scrolling glide on, one step per frame. The message loop calls
+    // AdvanceScroll at the display refresh rate while IsScrolling.
+    bool IsScrolling() const;
+    void AdvanceScroll();
+    int GetRefreshRate() const;         // Display refresh rate in Hz, DEFAULT_REFRESH_RATE if unknown
     
     void SaveWindowState();
     void LoadWindowState();
+    bool SaveLatencyReport() const;     // Write the input latency report next to launcher.ini
+    
+    // Record navigation input from now on; stopping writes input.rec next to launcher.ini
+    void StartInputRecording();
+    bool StopInputRecording();
+    bool IsRecordingInput() const { return inputLog != nullptr; }
 
 private:
     HWND mainWindow;
     std::unique_ptr<GridRenderer> gridRenderer;
-    std::unique_ptr<ControllerManager> controllerManager;
+    std::unique_ptr<FrameComposer> frameComposer;   // Draws frames with gridRenderer
+    std::unique_ptr<InputThread> inputThread;
     TrayManager* trayManager; // Non-owning pointer
     ShortcutScanner* shortcutScanner; // Non-owning pointer
     bool isDragging;
     std::vector<TabInfo> tabs; // Tab data
     int activeTabIndex; // Currently active tab
     int savedActiveTabIndex; // Saved active tab from INI file
+    bool initialTabApplied; // The saved tab was applied by the first load that found tabs
     int scrollOffset; // Vertical scroll offset in pixels
     int selectedIconIndex; // Currently selected icon (unified for mouse and keyboard)
     int lastSelectedIconIndex; // Last selected icon before it was cleared (for resuming navigation)
@@ -59,15 +82,22 @@ private:
     int offscreenWidth;
     int offscreenHeight;
     bool isResizing;                // Track if window is being resized
+    DamageRegion damage;            // Parts of the offscreen buffer to redraw on the next WM_PAINT
+    int renderedSelectedIndex;      // selectedIconIndex the grid in the offscreen buffer was drawn with
+    PageCache pageCache;            // Top of recently shown tabs, put back on tab switch
+    ScrollPhysics scrollPhysics;    // Where wheel and stick scrolling are heading; scrollOffset follows it
+    int64_t scrollTime;             // Time scrollPhysics was advanced to
     
-    // Cached tab buffer for performance
-    HDC tabBufferDC;
-    HBITMAP tabBufferBitmap;
-    HBITMAP oldTabBitmap;
-    void* tabBufferBits;
-    int tabBufferWidth;
-    int tabBufferHeight;
-    bool tabBufferDirty;            // Track if tabs need redrawing
+    // Inputs whose result is waiting for the next present, with the time they happened
+    struct PendingInput {
+        InputLatencyType type;
+        int64_t time;
+    };
+    std::vector<PendingInput> pendingInputs;
+    std::vector<PendingInput> scrollInputs; // Started a scroll that has not moved the grid yet
+    InputLatency inputLatency;
+    std::unique_ptr<InputLog> inputLog;     // Set while recording
+    int64_t recordingStartTime;
     
     static LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
     LRESULT HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
@@ -78,30 +108,46 @@ private:
     void HandleDoubleClick(int x, int y);
     void HandleTabClick(int x, int y);  // New method for tab clicks
     void HandleMouseWheel(int delta);   // New method for mouse wheel scrolling
-    void HandleJoystickScroll(int delta); // New method for joystick scrolling (bypasses WHEEL_DELTA division)
+    void HandleJoystickScroll(int deflection); // Right stick scrolls at a speed proportional to deflection
+    void StartScroll();                 // Bring scrollPhysics up to now and to the current grid before input changes it
+    void ShowScrollFrame();             // Scroll the grid toward scrollPhysics by at most a frame's budget
+    void ScrollBy(int scrollDelta);     // Scroll by pixels within range and select the first fully visible icon
     void HandleKeyDown(WPARAM wParam);  // New method for keyboard navigation
-    void HandleControllerNavigation(int moveX, int moveY); // Helper for controller navigation
+    void ApplyAction(InputAction action); // Apply a navigation step, record it and repaint what changed
+    void RepaintSelection(const NavigationState& previous); // Invalidate a selection change and the scroll it caused
+    NavigationState GetNavigationState() const;
+    void SetNavigationState(const NavigationState& state);
+    void TrackInput(InputLatencyType type, int64_t time); // Time the next present if the input caused a repaint
+    void TrackScrollInput(InputLatencyType type, int64_t time); // Same, or from the first frame the scroll moves
+    void RecordPresentedInput();        // Add the inputs just presented to inputLatency
     void SetActiveTab(int tabIndex);    // New method to switch tabs
     void SetSelectedIcon(int iconIndex, bool fromKeyboard = false); // New method to set selected icon
     void LaunchSelectedIcon();          // New method to launch selected icon
-    void EnsureSelectedIconVisible();   // New method to scroll selected icon into view
-    void DrawTabs(HDC hdc, const RECT& clientRect);  // New method to draw tabs
+    void CollectDamage(HWND hwnd);      // Add the window's update region to damage
+    void ScrollBuffer(int scrollDelta); // Move the buffered grid pixels after scrollOffset changed
+    void InvalidateDamage();            // Make sure WM_PAINT comes for everything in damage
+    void StorePage();                   // Keep the active tab's page if the buffer shows it up to date
+    bool RestorePage();                 // Put back the active tab's kept page and damage the rest
+    PixelRect GetPageArea(const RECT& clientRect) const; // Part of the offscreen buffer a page covers
+    int GetDpiPercent();                // DPI scaling in percent, for cache keys
     void LoadShortcuts();
     
     RECT GetTabBarRect(const RECT& clientRect);      // New method
     RECT GetGridRect(const RECT& clientRect);        // New method
     int GetTabAtPoint(POINT point, const RECT& clientRect);  // New method
     bool IsWindows11OrGreater();                     // Windows version check
-    COLORREF GetTabColor(const std::wstring& tabName, bool isActive); // Get color for specific tab
     float GetDpiScaleFactor();                       // Get DPI scaling factor for this window
+    FrameState GetFrameState(const RECT& clientRect); // Current tabs, scroll and selection for FrameComposer
     
     // Helper methods to reduce code duplication
     std::wstring GetIniFilePath() const;             // Get path to launcher.ini
-    int GetScaledIconSize() const;                   // Get icon size with scale applied
-    int CalculateGridColumns(const RECT& gridRect) const; // Calculate number of grid columns
-    RECT GetOptimizedGridRect(const RECT& gridRect, int cols, int itemWidth, int availableWidth) const; // Get optimized repaint rect
-    RECT GetGridRelativeRect(const RECT& gridRect) const; // Get grid-relative rect for hit testing
+    bool WriteDataFile(const wchar_t* fileName, const void* data, size_t size) const; // Write a file next to launcher.ini
+    GridLayout GetGridLayout() const;                // Active tab's grid geometry for hit testing and scrolling
     bool IsValidTabState() const;                    // Validate tab state before operations
     
     static const wchar_t* WINDOW_CLASS_NAME;
+    static const UINT WM_CATALOG_STALE = WM_APP + 1; // Posted by the catalog validation thread
+    static const UINT WM_INPUT_EVENTS = WM_APP + 2;  // Posted by the input thread when events are queued
+    static const size_t MAX_PENDING_INPUTS = 64;
+    static const int DEFAULT_REFRESH_RATE = 60;
 };
\ No newline at end of file
@@ -0,0 +1,100 @@
+// WorkerPool.cpp - Persistent worker threads implementation
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(size_t threadCount)
+    : currentTask(nullptr)
+    , taskCount(0)
+    , nextIndex(0)
+    , busyWorkers(0)
+    , generation(0)
+    , stopping(false)
+{
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    
+    // The caller acts as worker 0, so spawn one thread fewer
+    for (size_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(&WorkerPool::WorkerLoop, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t index, size_t worker)>& task) {
+    if (count == 0) {
+        return;
+    }
+    
+    // Small jobs or single-threaded pools run inline
+    if (threads.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        taskCount = count;
+        nextIndex.store(0, std::memory_order_relaxed);
+        busyWorkers = threads.size();
+        generation++;
+    }
+    wakeCondition.notify_all();
+    
+    RunTasks(0);
+    
+    // Wait until every worker has finished its last task for this generation
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return busyWorkers == 0; });
+    currentTask = nullptr;
+    taskCount = 0;
+}
+
+void WorkerPool::WorkerLoop(size_t worker) {
+    uint64_t seenGeneration = 0;
+    
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [this, seenGeneration] { return stopping || generation != seenGeneration; });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = generation;
+        }
+        
+        RunTasks(worker);
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        doneCondition.notify_one();
+    }
+}
+
+void WorkerPool::RunTasks(size_t worker) {
+    for (;;) {
+        size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+        if (index >= taskCount) {
+            return;
+        }
+        (*currentTask)(index, worker);
+    }
+}
@@ -0,0 +1,49 @@
+// WorkerPool.h - Persistent worker threads for data-parallel loops
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+public:
+    // threadCount of 0 sizes the pool to the number of hardware threads.
+    // The thread calling ParallelFor always participates as worker 0.
+    explicit WorkerPool(size_t threadCount = 0);
+    ~WorkerPool();
+    
+    // Delete copy/move
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    
+    // Total number of workers, including the calling thread
+    size_t GetWorkerCount() const { return threads.size() + 1; }
+    
+    // Run task(index, worker) for every index in [0, count) and wait for completion.
+    // Indices are handed out dynamically, so the order of execution is unspecified;
+    // callers write results into per-index slots to keep output deterministic.
+    // Not reentrant - a task must not call ParallelFor on the same pool.
+    void ParallelFor(size_t count, const std::function<void(size_t index, size_t worker)>& task);
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    
+    // Current job (guarded by mutex, except nextIndex)
+    const std::function<void(size_t, size_t)>* currentTask;
+    size_t taskCount;
+    std::atomic<size_t> nextIndex;
+    size_t busyWorkers;
+    uint64_t generation;
+    bool stopping;
+    
+    void WorkerLoop(size_t worker);
+    void RunTasks(size_t worker);
+};
@@ -0,0 +1,259 @@
+// AtlasPackerTests.cpp - Skyline packing of icon pages, and the per-tab atlas built on it
+#include "TestFramework.h"
+#include "AtlasPacker.h"
+#include "IconAtlas.h"
+#include "IconPixelPool.h"
+#include <random>
+#include <vector>
+
+namespace {
+    bool Overlap(const PixelRect& a, const PixelRect& b) {
+        return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+    }
+    
+    // Placed rectangles that leave the page or overlap an earlier one
+    int CountBadPlacements(const AtlasPacker& packer, const std::vector<PixelRect>& placed) {
+        int bad = 0;
+        for (size_t i = 0; i < placed.size(); i++) {
+            const PixelRect& rect = placed[i];
+            bad += rect.left < 0 || rect.top < 0 || rect.right > packer.GetWidth() || rect.bottom > packer.GetHeight();
+            for (size_t j = 0; j < i; j++) {
+                bad += Overlap(rect, placed[j]);
+            }
+        }
+        return bad;
+    }
+    
+    // Insert random icon sizes, the mix a tab of mixed icon scales asks for, until the
+    // page refuses rejectLimit in a row
+    std::vector<PixelRect> FillMixed(AtlasPacker& packer, uint32_t seed, int rejectLimit) {
+        const int sizes[] = {256, 192, 144, 128, 96, 64, 48, 32};
+        std::mt19937 random(seed);
+        std::vector<PixelRect> placed;
+        int rejected = 0;
+        while (rejected < rejectLimit) {
+            int width = sizes[random() % 8];
+            int height = random() % 4 == 0 ? sizes[random() % 8] : width;
+            PixelRect rect;
+            if (packer.Insert(width, height, rect)) {
+                CHECK(rect.Width() == width && rect.Height() == height);
+                placed.push_back(rect);
+                rejected = 0;
+            } else {
+                rejected++;
+            }
+        }
+        return placed;
+    }
+    
+    // An icon-sized image whose every pixel names the icon and its position
+    std::vector<uint32_t> MakeIcon(int size, uint32_t tag) {
+        std::vector<uint32_t> pixels(static_cast<size_t>(size) * size);
+        for (size_t i = 0; i < pixels.size(); i++) {
+            pixels[i] = (tag << 24) | static_cast<uint32_t>(i);
+        }
+        return pixels;
+    }
+    
+    RasterImage AsImage(const std::vector<uint32_t>& pixels, int size) {
+        return RasterImage{pixels.data(), size, size, size};
+    }
+    
+    bool SamePixels(const RasterImage& image, const std::vector<uint32_t>& pixels, int size) {
+        if (image.width != size || image.height != size) {
+            return false;
+        }
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                if (image.pixels[static_cast<size_t>(y) * image.stride + x] != pixels[static_cast<size_t>(y) * size + x]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE(AtlasPacker, FillsAPageWith256pxIcons) {
+    // 2048x1024 holds 8 x 4 icons of 256, in rows in insertion order, with no holes
+    AtlasPacker packer(IconAtlas::PAGE_WIDTH, IconAtlas::PAGE_HEIGHT);
+    std::vector<PixelRect> placed;
+    for (int i = 0; i < 32; i++) {
+        PixelRect rect;
+        REQUIRE(packer.Insert(256, 256, rect));
+        CHECK_EQ(rect.left, (i % 8) * 256);
+        CHECK_EQ(rect.top, (i / 8) * 256);
+        placed.push_back(rect);
+    }
+    PixelRect rect;
+    CHECK(!packer.Insert(256, 256, rect));
+    CHECK_EQ(CountBadPlacements(packer, placed), 0);
+    CHECK_EQ(packer.GetUsedArea(), static_cast<int64_t>(2048) * 1024);
+    CHECK_EQ(packer.GetOccupancy(), 1.0);
+    
+    // A full page still refuses the smallest icon
+    CHECK(!packer.Insert(1, 1, rect));
+}
+
+TEST_CASE(AtlasPacker, MixedSizesStayInBoundsAndPacked) {
+    for (uint32_t seed = 1; seed <= 20; seed++) {
+        AtlasPacker packer(IconAtlas::PAGE_WIDTH, IconAtlas::PAGE_HEIGHT);
+        std::vector<PixelRect> placed = FillMixed(packer, seed, 50);
+        CHECK_EQ(CountBadPlacements(packer, placed), 0);
+        
+        int64_t area = 0;
+        for (const PixelRect& rect : placed) {
+            area += static_cast<int64_t>(rect.Width()) * rect.Height();
+        }
+        CHECK_EQ(packer.GetUsedArea(), area);
+        
+        // Holes under the skyline stay small, and the page ends up mostly used
+        double occupancy = packer.GetOccupancy();
+        CHECK(occupancy > 0.85 && occupancy <= 1.0);
+        CHECK(area > static_cast<int64_t>(2048) * 1024 * 85 / 100);
+    }
+}
+
+TEST_CASE(AtlasPacker, RefusesWhatCannotFit) {
+    AtlasPacker packer(512, 256);
+    PixelRect rect;
+    CHECK(!packer.Insert(0, 10, rect));
+    CHECK(!packer.Insert(10, -1, rect));
+    CHECK(!packer.Insert(513, 10, rect));
+    CHECK(!packer.Insert(10, 257, rect));
+    CHECK_EQ(packer.GetUsedArea(), 0);
+    
+    // The exact page size fits once; a tall icon next to a short one rests on the floor
+    REQUIRE(packer.Insert(512, 256, rect));
+    CHECK(!packer.Insert(1, 1, rect));
+    packer.Reset();
+    PixelRect shortRect;
+    PixelRect tallRect;
+    REQUIRE(packer.Insert(256, 64, shortRect));
+    REQUIRE(packer.Insert(256, 256, tallRect));
+    CHECK(tallRect.left == 256 && tallRect.top == 0);
+    
+    // Degenerate pages hold nothing
+    AtlasPacker empty(0, -5);
+    CHECK_EQ(empty.GetWidth(), 0);
+    CHECK(!empty.Insert(1, 1, rect));
+}
+
+TEST_CASE(AtlasPacker, ResetStartsThePageOver) {
+    AtlasPacker packer(IconAtlas::PAGE_WIDTH, IconAtlas::PAGE_HEIGHT);
+    std::vector<PixelRect> first = FillMixed(packer, 7, 20);
+    REQUIRE(!first.empty());
+    
+    packer.Reset();
+    CHECK_EQ(packer.GetUsedArea(), 0);
+    CHECK_EQ(packer.GetOccupancy(), 1.0);
+    
+    // The same sequence lands in the same places, and a full page of 256s fits again
+    std::vector<PixelRect> second = FillMixed(packer, 7, 20);
+    REQUIRE(second.size() == first.size());
+    int moved = 0;
+    for (size_t i = 0; i < first.size(); i++) {
+        moved += first[i].left != second[i].left || first[i].top != second[i].top;
+    }
+    CHECK_EQ(moved, 0);
+    
+    packer.Reset();
+    PixelRect rect;
+    int count = 0;
+    while (packer.Insert(256, 256, rect)) {
+        count++;
+    }
+    CHECK_EQ(count, 32);
+}
+
+TEST_CASE(IconAtlas, CopiesAgainWhenTheIconChanges) {
+    IconPixelPool pool;
+    IconAtlas atlas;
+    std::vector<uint32_t> iconA = MakeIcon(64, 1);
+    std::vector<uint32_t> iconB = MakeIcon(64, 2);
+    IconHandle handle = pool.Allocate(64, 64);
+    REQUIRE(handle != 0);
+    
+    // The first draw copies the icon into a page; later draws return that copy
+    RasterImage copy = atlas.Get(3, handle, AsImage(iconA, 64));
+    CHECK(copy.pixels != iconA.data());
+    CHECK(copy.stride == IconAtlas::PAGE_WIDTH);
+    CHECK(SamePixels(copy, iconA, 64));
+    CHECK_EQ(atlas.GetPageCount(), 1u);
+    size_t pageBytes = IconAtlas::PAGE_BYTES;
+    CHECK_EQ(atlas.GetMemoryUsage(), pageBytes);
+    
+    RasterImage again = atlas.Get(3, handle, AsImage(iconB, 64));
+    CHECK(again.pixels == copy.pixels);
+    CHECK(SamePixels(again, iconA, 64));
+    
+    // Another handle for the index: the icon was replaced and is copied again
+    IconHandle other = pool.Allocate(64, 64);
+    RasterImage replaced = atlas.Get(3, other, AsImage(iconB, 64));
+    CHECK(replaced.pixels != copy.pixels);
+    CHECK(SamePixels(replaced, iconB, 64));
+    
+    // The same slot handed out again after a release carries a new generation
+    pool.Release(other);
+    IconHandle reused = pool.Allocate(64, 64);
+    REQUIRE(reused != 0);
+    CHECK(reused != other);
+    RasterImage regenerated = atlas.Get(3, reused, AsImage(iconA, 64));
+    CHECK(regenerated.pixels != replaced.pixels);
+    CHECK(SamePixels(regenerated, iconA, 64));
+    
+    // A new size under the same handle is copied again too
+    std::vector<uint32_t> larger = MakeIcon(96, 3);
+    RasterImage resized = atlas.Get(3, reused, AsImage(larger, 96));
+    CHECK(SamePixels(resized, larger, 96));
+    
+    // Other indices keep their own copies
+    RasterImage neighbour = atlas.Get(4, handle, AsImage(iconB, 64));
+    CHECK(SamePixels(neighbour, iconB, 64));
+    CHECK(SamePixels(atlas.Get(3, reused, AsImage(iconB, 96)), larger, 96));
+}
+
+TEST_CASE(IconAtlas, FallsBackToTheSourceWhenFull) {
+    IconAtlas atlas;
+    std::vector<uint32_t> icon = MakeIcon(256, 5);
+    RasterImage source = AsImage(icon, 256);
+    
+    // Nothing to key the copy by, or too large for a page: drawn from the source
+    CHECK(atlas.Get(-1, 1, source).pixels == icon.data());
+    CHECK(atlas.Get(0, 0, source).pixels == icon.data());
+    CHECK(atlas.Get(0, 1, RasterImage()).pixels == nullptr);
+    std::vector<uint32_t> wide(static_cast<size_t>(IconAtlas::PAGE_WIDTH + 1) * 4);
+    RasterImage tooWide{wide.data(), IconAtlas::PAGE_WIDTH + 1, 4, IconAtlas::PAGE_WIDTH + 1};
+    CHECK(atlas.Get(0, 1, tooWide).pixels == wide.data());
+    CHECK(atlas.IsFull());
+    atlas.Clear();
+    
+    // MAX_PAGES pages of 32 icons each, then every further icon comes from its source
+    int capacity = static_cast<int>(IconAtlas::MAX_PAGES) * 32;
+    int copied = 0;
+    for (int i = 0; i < capacity; i++) {
+        copied += atlas.Get(i, static_cast<IconHandle>(i + 1), source).pixels != icon.data();
+    }
+    CHECK_EQ(copied, capacity);
+    CHECK(!atlas.IsFull());
+    size_t maxPages = IconAtlas::MAX_PAGES;
+    CHECK_EQ(atlas.GetPageCount(), maxPages);
+    
+    RasterImage direct = atlas.Get(capacity, static_cast<IconHandle>(capacity + 1), source);
+    CHECK(direct.pixels == icon.data());
+    CHECK(direct.stride == 256);
+    CHECK(atlas.IsFull());
+    CHECK_EQ(atlas.GetPageCount(), maxPages);
+    
+    // Icons already copied are still served from the atlas
+    RasterImage first = atlas.Get(0, 1, source);
+    CHECK(first.pixels != icon.data());
+    CHECK(SamePixels(first, icon, 256));
+    
+    // Clear drops the pages and starts over
+    atlas.Clear();
+    CHECK(!atlas.IsFull());
+    CHECK_EQ(atlas.GetPageCount(), 0u);
+    CHECK_EQ(atlas.GetMemoryUsage(), 0u);
+    CHECK(atlas.Get(capacity, static_cast<IconHandle>(capacity + 1), source).pixels != icon.data());
+}
@@ -0,0 +1,299 @@
+// DamageRegionTests.cpp - Rectangle math and damage accumulation against a per-pixel reference
+#include "TestFramework.h"
+#include "DamageRegion.h"
+#include <random>
+#include <vector>
+
+namespace {
+    const int GRID = 64;
+    
+    // One flag per pixel of a GRID x GRID area
+    struct Coverage {
+        std::vector<int> count = std::vector<int>(GRID * GRID, 0);
+        
+        void Add(const PixelRect& rect, int amount = 1) {
+            PixelRect clipped = PixelRect::Intersect(rect, PixelRect(0, 0, GRID, GRID));
+            for (int y = clipped.top; y < clipped.bottom; y++) {
+                for (int x = clipped.left; x < clipped.right; x++) {
+                    count[y * GRID + x] += amount;
+                }
+            }
+        }
+        
+        int At(int x, int y) const { return count[y * GRID + x]; }
+    };
+    
+    Coverage Cover(const DamageRegion& region) {
+        Coverage coverage;
+        for (const PixelRect& rect : region.GetRects()) {
+            coverage.Add(rect);
+        }
+        return coverage;
+    }
+    
+    // Up to 20 x 20, inside the grid
+    PixelRect RandomRect(std::mt19937& random) {
+        int left = random() % (GRID - 20);
+        int top = random() % (GRID - 20);
+        return PixelRect(left, top, left + 1 + random() % 20, top + 1 + random() % 20);
+    }
+    
+    // The invariants every operation keeps: no overlaps, no empty rectangles, at most
+    // MAX_RECTS of them, and GetArea counting each covered pixel once
+    void CheckWellFormed(const DamageRegion& region) {
+        const std::vector<PixelRect>& rects = region.GetRects();
+        CHECK(rects.size() <= DamageRegion::MAX_RECTS);
+        for (size_t a = 0; a < rects.size(); a++) {
+            CHECK(!rects[a].IsEmpty());
+            for (size_t b = a + 1; b < rects.size(); b++) {
+                CHECK(!rects[a].Intersects(rects[b]));
+            }
+        }
+        CHECK_EQ(region.IsEmpty(), rects.empty());
+        
+        Coverage coverage = Cover(region);
+        int64_t pixels = 0;
+        for (int value : coverage.count) {
+            pixels += value > 0;
+        }
+        CHECK_EQ(region.GetArea(), pixels);
+    }
+}
+
+TEST_CASE(DamageRegion, RectBasics) {
+    PixelRect a(0, 0, 10, 10);
+    PixelRect b(5, 5, 20, 20);
+    CHECK_EQ(a.Width(), 10);
+    CHECK_EQ(a.Area(), 100);
+    CHECK(PixelRect(3, 3, 3, 9).IsEmpty());
+    CHECK_EQ(PixelRect(5, 5, 2, 9).Area(), 0);
+    
+    CHECK(a.Intersects(b));
+    CHECK(!a.Intersects(PixelRect(10, 0, 20, 10)));      // Touching edges don't overlap
+    CHECK(!a.Intersects(PixelRect()));
+    CHECK(a.Contains(PixelRect(2, 2, 10, 10)));
+    CHECK(!a.Contains(b));
+    CHECK(a.Contains(PixelRect()));
+    
+    PixelRect overlap = PixelRect::Intersect(a, b);
+    CHECK_EQ(overlap.left, 5);
+    CHECK_EQ(overlap.bottom, 10);
+    CHECK(PixelRect::Intersect(a, PixelRect(30, 30, 40, 40)).IsEmpty());
+    
+    PixelRect both = PixelRect::Union(a, b);
+    CHECK_EQ(both.left, 0);
+    CHECK_EQ(both.right, 20);
+    PixelRect same = PixelRect::Union(PixelRect(), a);
+    CHECK_EQ(same.right, 10);
+    CHECK_EQ(PixelRect::Union(PixelRect(8, 8, 8, 8), a).left, 0);  // Empty rects add nothing
+}
+
+TEST_CASE(DamageRegion, SubtractMatchesPixels) {
+    std::mt19937 random(11);
+    for (int round = 0; round < 2000; round++) {
+        PixelRect a = RandomRect(random);
+        PixelRect b = RandomRect(random);
+        PixelRect pieces[4];
+        int count = PixelRect::Subtract(a, b, pieces);
+        REQUIRE(count >= 0 && count <= 4);
+        
+        // The pieces cover a minus b, each pixel once
+        Coverage expected;
+        expected.Add(a);
+        expected.Add(PixelRect::Intersect(a, b), -1);
+        Coverage actual;
+        for (int i = 0; i < count; i++) {
+            CHECK(!pieces[i].IsEmpty());
+            actual.Add(pieces[i]);
+        }
+        CHECK(actual.count == expected.count);
+    }
+}
+
+TEST_CASE(DamageRegion, AddCoversEverythingAdded) {
+    std::mt19937 random(3);
+    for (int round = 0; round < 300; round++) {
+        DamageRegion region;
+        Coverage added;
+        int adds = 1 + random() % 30;
+        for (int i = 0; i < adds; i++) {
+            PixelRect rect = RandomRect(random);
+            region.Add(rect);
+            added.Add(rect);
+            CheckWellFormed(region);
+        }
+        
+        // Merging may cover more than was added, never less
+        Coverage covered = Cover(region);
+        for (int y = 0; y < GRID; y++) {
+            for (int x = 0; x < GRID; x++) {
+                if (added.At(x, y) > 0) {
+                    CHECK(covered.At(x, y) == 1);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(DamageRegion, AddMergesOnlyWhenCheap) {
+    // Two icons far apart stay two rectangles: painting their union would waste most of it
+    DamageRegion region;
+    region.Add(PixelRect(0, 0, 10, 10));
+    region.Add(PixelRect(40, 40, 50, 50));
+    CHECK_EQ(region.GetRects().size(), 2u);
+    CHECK_EQ(region.GetArea(), 200);
+    
+    // Neighbours whose union is mostly damaged become one
+    region.Clear();
+    region.Add(PixelRect(0, 0, 10, 10));
+    region.Add(PixelRect(0, 10, 10, 18));
+    CHECK_EQ(region.GetRects().size(), 1u);
+    CHECK_EQ(region.GetArea(), 180);
+    
+    // Already covered: nothing changes
+    region.Add(PixelRect(2, 2, 5, 5));
+    CHECK_EQ(region.GetRects().size(), 1u);
+    CHECK(region.Contains(PixelRect(0, 0, 10, 18)));
+    CHECK(!region.Contains(PixelRect(0, 0, 11, 18)));
+    
+    // Empty rectangles are ignored
+    region.Clear();
+    region.Add(PixelRect(5, 5, 5, 20));
+    CHECK(region.IsEmpty());
+}
+
+TEST_CASE(DamageRegion, CapsTheRectangleCount) {
+    // A diagonal of small squares: none merge on their own, the cap forces it
+    DamageRegion region;
+    for (int i = 0; i < 20; i++) {
+        region.Add(PixelRect(i * 3, i * 3, i * 3 + 2, i * 3 + 2));
+    }
+    CheckWellFormed(region);
+    CHECK(region.GetRects().size() < 20u);
+    Coverage covered = Cover(region);
+    for (int i = 0; i < 20; i++) {
+        CHECK_EQ(covered.At(i * 3, i * 3), 1);
+    }
+}
+
+TEST_CASE(DamageRegion, RemoveTakesPixelsOut) {
+    std::mt19937 random(5);
+    for (int round = 0; round < 300; round++) {
+        DamageRegion region;
+        for (int i = 0; i < 4; i++) {
+            region.Add(RandomRect(random));
+        }
+        Coverage before = Cover(region);
+        PixelRect removed = RandomRect(random);
+        int pieceCount = 0;
+        for (const PixelRect& rect : region.GetRects()) {
+            PixelRect pieces[4];
+            pieceCount += PixelRect::Subtract(rect, removed, pieces);
+        }
+        region.Remove(removed);
+        CheckWellFormed(region);
+        
+        // Whatever was damaged outside the removed rectangle still is. Unless there
+        // were too many pieces and the cap merged some back together, nothing else is.
+        Coverage after = Cover(region);
+        bool merged = pieceCount > static_cast<int>(DamageRegion::MAX_RECTS);
+        for (int y = 0; y < GRID; y++) {
+            for (int x = 0; x < GRID; x++) {
+                bool inside = x >= removed.left && x < removed.right && y >= removed.top && y < removed.bottom;
+                if (!inside && before.At(x, y) > 0) {
+                    CHECK_EQ(after.At(x, y), 1);
+                } else if (!merged) {
+                    CHECK_EQ(after.At(x, y), 0);
+                }
+            }
+        }
+    }
+    
+    DamageRegion region;
+    region.Add(PixelRect(0, 0, 20, 20));
+    region.Remove(PixelRect(0, 0, 20, 20));
+    CHECK(region.IsEmpty());
+}
+
+TEST_CASE(DamageRegion, ScrollMovesDamageInsideTheArea) {
+    std::mt19937 random(7);
+    const PixelRect area(4, 10, 60, 54);
+    for (int round = 0; round < 300; round++) {
+        DamageRegion region;
+        for (int i = 0; i < 3; i++) {
+            region.Add(RandomRect(random));
+        }
+        Coverage before = Cover(region);
+        int dy = static_cast<int>(random() % 41) - 20;
+        region.Scroll(area, dy);
+        CheckWellFormed(region);
+        
+        // Pixels inside the area came from dy rows below; outside nothing moved
+        Coverage after = Cover(region);
+        for (int y = 0; y < GRID; y++) {
+            for (int x = 0; x < GRID; x++) {
+                bool inside = x >= area.left && x < area.right && y >= area.top && y < area.bottom;
+                int fromY = y + dy;
+                bool wasDamaged = !inside ? before.At(x, y) > 0
+                                          : fromY >= area.top && fromY < area.bottom && before.At(x, fromY) > 0;
+                if (wasDamaged) {
+                    CHECK_EQ(after.At(x, y), 1);
+                }
+            }
+        }
+    }
+    
+    // Damage scrolled out of the area is dropped
+    DamageRegion region;
+    region.Add(PixelRect(10, 12, 20, 16));
+    region.Scroll(area, 10);
+    CHECK(region.IsEmpty());
+}
+
+TEST_CASE(DamageRegion, ClipToAndBounds) {
+    DamageRegion region;
+    region.Add(PixelRect(-10, -10, 10, 10));
+    region.Add(PixelRect(50, 50, 80, 70));
+    PixelRect bounds = region.GetBounds();
+    CHECK_EQ(bounds.left, -10);
+    CHECK_EQ(bounds.bottom, 70);
+    
+    region.ClipTo(PixelRect(0, 0, GRID, GRID));
+    CheckWellFormed(region);
+    CHECK_EQ(region.GetArea(), 100 + 14 * 14);
+    bounds = region.GetBounds();
+    CHECK_EQ(bounds.left, 0);
+    CHECK_EQ(bounds.right, GRID);
+    
+    region.ClipTo(PixelRect(20, 20, 30, 30));
+    CHECK(region.IsEmpty());
+    CHECK(region.GetBounds().IsEmpty());
+}
+
+TEST_CASE(DamageRegion, TilesPartitionTheRegion) {
+    std::mt19937 random(9);
+    for (int round = 0; round < 200; round++) {
+        DamageRegion region;
+        for (int i = 0; i < 6; i++) {
+            region.Add(RandomRect(random));
+        }
+        int tileHeight = 1 + random() % 9;
+        std::vector<PixelRect> tiles;
+        region.GetTiles(tileHeight, tiles);
+        
+        Coverage covered;
+        for (const PixelRect& tile : tiles) {
+            CHECK(!tile.IsEmpty());
+            CHECK(tile.Height() <= tileHeight);
+            covered.Add(tile);
+        }
+        CHECK(covered.count == Cover(region).count);
+    }
+    
+    // No tile height: the rectangles as they are
+    DamageRegion region;
+    region.Add(PixelRect(0, 0, 10, 40));
+    std::vector<PixelRect> tiles;
+    region.GetTiles(0, tiles);
+    CHECK_EQ(tiles.size(), 1u);
+}
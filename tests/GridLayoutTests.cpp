@@ -0,0 +1,290 @@
+// GridLayoutTests.cpp - GridLayout against the linear layout code it replaced
+#include "TestFramework.h"
+#include "GridLayout.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // The layout as GridRenderer::CalculateGridLayout, GetIconRect and GetClickedShortcut
+    // and WindowManager's scroll clamping and EnsureSelectedIconVisible computed it, one
+    // item at a time
+    struct LegacyGrid {
+        PixelRect rect;
+        int count;
+        GridMetrics m;
+        int cols;
+        int startX;
+        int startY;
+        
+        LegacyGrid(const PixelRect& area, int itemCount, const GridMetrics& metrics)
+            : rect(area)
+            , count(itemCount)
+            , m(metrics)
+        {
+            int availableWidth = rect.right - rect.left;
+            int itemWidth = m.iconSize + m.spacingHorizontal;
+            cols = (availableWidth / itemWidth > 1) ? (availableWidth / itemWidth) : 1;
+            int totalGridWidth = cols * itemWidth - m.spacingHorizontal;
+            startX = rect.left + (availableWidth - totalGridWidth) / 2;
+            startY = rect.top + m.borderPadding;
+        }
+        
+        int TotalItemHeight() const { return m.iconSize + m.labelHeight + m.verticalPadding; }
+        int ItemHeight() const { return TotalItemHeight() + m.spacingVertical; }
+        int Rows() const { return (count + cols - 1) / cols; }
+        
+        PixelRect GetIconRect(int index, int scrollOffset) const {
+            int left = startX + (index % cols) * (m.iconSize + m.spacingHorizontal);
+            int top = startY + (index / cols) * ItemHeight() - scrollOffset;
+            return PixelRect(left, top, left + m.iconSize, top + m.iconSize);
+        }
+        
+        int GetClickedShortcut(int x, int y, int scrollOffset) const {
+            for (int i = 0; i < count; i++) {
+                PixelRect hit = GetIconRect(i, scrollOffset);
+                hit.bottom += m.labelHeight + m.borderPadding;
+                if (x >= hit.left && x < hit.right && y >= hit.top && y < hit.bottom) {
+                    return i;
+                }
+            }
+            return -1;
+        }
+        
+        int MaxScroll() const {
+            return std::max(0, Rows() * ItemHeight() - rect.Height());
+        }
+        
+        int FirstFullyVisibleIndex(int scrollOffset) const {
+            int row = (scrollOffset + ItemHeight() - 1) / ItemHeight();
+            return std::min(row * cols, count - 1);
+        }
+        
+        int EnsureVisible(int index, int scrollOffset) const {
+            int row = index / cols;
+            int iconTop = m.borderPadding + row * ItemHeight() - scrollOffset;
+            int iconBottom = iconTop + TotalItemHeight();
+            int viewportBottom = rect.Height();
+            if (iconTop - m.borderExtension < 0) {
+                return std::max(0, m.borderPadding + row * ItemHeight() - m.borderExtension);
+            }
+            if (iconBottom > viewportBottom) {
+                int offset = m.borderPadding + row * ItemHeight() - viewportBottom + TotalItemHeight();
+                return std::min(offset, MaxScroll());
+            }
+            return scrollOffset;
+        }
+        
+        // Everything drawn for an item: icon, selection border and the label below
+        PixelRect DrawnBounds(int index, int scrollOffset) const {
+            PixelRect icon = GetIconRect(index, scrollOffset);
+            return PixelRect(icon.left - m.borderExtension, icon.top - m.borderExtension, icon.right + m.borderExtension,
+                             icon.bottom + m.borderPadding + m.labelHeight + m.verticalPadding);
+        }
+    };
+    
+    struct Case {
+        PixelRect area;
+        int count;
+        GridMetrics metrics;
+        
+        std::string Describe() const {
+            return "area " + std::to_string(area.Width()) + "x" + std::to_string(area.Height()) + ", " +
+                   std::to_string(count) + " items, icon " + std::to_string(metrics.iconSize);
+        }
+    };
+    
+    GridMetrics LauncherMetrics(int iconSize) {
+        GridMetrics metrics;
+        metrics.iconSize = iconSize;
+        metrics.spacingHorizontal = 12;
+        metrics.spacingVertical = 20;
+        metrics.labelHeight = 60;
+        metrics.verticalPadding = 10;
+        metrics.borderPadding = 8;
+        metrics.borderExtension = 5;
+        return metrics;
+    }
+    
+    // Small grids with odd sizes, so every pixel of them can be hit-tested, plus
+    // launcher-sized ones
+    std::vector<Case> MakeCases(int smallCount) {
+        std::mt19937 random(20);
+        std::vector<Case> cases;
+        for (int i = 0; i < smallCount; i++) {
+            Case c;
+            int left = random() % 30;
+            int top = random() % 30;
+            c.area = PixelRect(left, top, left + 1 + random() % 140, top + 1 + random() % 110);
+            c.count = random() % 60;
+            c.metrics.iconSize = 1 + random() % 24;
+            c.metrics.spacingHorizontal = random() % 8;
+            c.metrics.spacingVertical = random() % 8;
+            c.metrics.labelHeight = random() % 12;
+            c.metrics.verticalPadding = random() % 4;
+            c.metrics.borderPadding = random() % 4;
+            c.metrics.borderExtension = random() % 4;
+            cases.push_back(c);
+        }
+        for (int iconSize : {64, 256, 512}) {
+            for (int width : {300, 1231, 1920, 3840}) {
+                for (int count : {1, 7, 500, 10000}) {
+                    cases.push_back({PixelRect(24, 64, 24 + width, 64 + width * 9 / 16), count, LauncherMetrics(iconSize)});
+                }
+            }
+        }
+        return cases;
+    }
+    
+    std::vector<int> ScrollOffsets(const LegacyGrid& legacy) {
+        int maxScroll = legacy.MaxScroll();
+        return {0, 1, legacy.ItemHeight() - 1, legacy.ItemHeight(), maxScroll / 3, maxScroll - 1, maxScroll};
+    }
+}
+
+TEST_CASE(GridLayout, IndexToRectMatchesLegacy) {
+    for (const Case& c : MakeCases(200)) {
+        GridLayout layout(c.area, c.count, c.metrics);
+        LegacyGrid legacy(c.area, c.count, c.metrics);
+        if (c.count == 0) {
+            CHECK(layout.IsEmpty());
+            continue;
+        }
+        CHECK_EQ(layout.GetColumns(), legacy.cols);
+        CHECK_EQ(layout.GetRows(), legacy.Rows());
+        CHECK_EQ(layout.GetMaxScroll(), legacy.MaxScroll());
+        
+        int mismatches = 0;
+        for (int scrollOffset : ScrollOffsets(legacy)) {
+            for (int i = 0; i < c.count; i++) {
+                PixelRect rect = layout.IndexToRect(i, scrollOffset);
+                PixelRect expected = legacy.GetIconRect(i, scrollOffset);
+                mismatches += rect.left != expected.left || rect.top != expected.top ||
+                              rect.right != expected.right || rect.bottom != expected.bottom;
+            }
+        }
+        if (mismatches) {
+            TestRegistry::Fail(__FILE__, __LINE__, c.Describe() + ": " + std::to_string(mismatches) + " rects differ");
+        }
+        CHECK(layout.IndexToRect(-1, 0).IsEmpty());
+        CHECK(layout.IndexToRect(c.count, 0).IsEmpty());
+    }
+}
+
+TEST_CASE(GridLayout, PointToIndexMatchesLegacyEverywhere) {
+    // Every pixel of each small grid and a margin around it, at several scroll offsets
+    for (const Case& c : MakeCases(120)) {
+        if (c.metrics.iconSize > 32) {
+            continue;
+        }
+        GridLayout layout(c.area, c.count, c.metrics);
+        LegacyGrid legacy(c.area, c.count, c.metrics);
+        int mismatches = 0;
+        for (int scrollOffset : {0, 3, legacy.MaxScroll()}) {
+            for (int y = c.area.top - 10; y < c.area.bottom + 10; y++) {
+                for (int x = c.area.left - 10; x < c.area.right + 10; x++) {
+                    mismatches += layout.PointToIndex(x, y, scrollOffset) != legacy.GetClickedShortcut(x, y, scrollOffset);
+                }
+            }
+        }
+        if (mismatches) {
+            TestRegistry::Fail(__FILE__, __LINE__, c.Describe() + ": " + std::to_string(mismatches) + " points differ");
+        }
+    }
+}
+
+TEST_CASE(GridLayout, PointToIndexMatchesLegacyOnLargeGrids) {
+    std::mt19937 random(21);
+    for (const Case& c : MakeCases(0)) {
+        GridLayout layout(c.area, c.count, c.metrics);
+        LegacyGrid legacy(c.area, c.count, c.metrics);
+        int mismatches = 0;
+        for (int sample = 0; sample < 2000; sample++) {
+            int scrollOffset = static_cast<int>(random() % (legacy.MaxScroll() + 1));
+            int x = c.area.left - 20 + static_cast<int>(random() % (c.area.Width() + 40));
+            int y = c.area.top - 20 + static_cast<int>(random() % (c.area.Height() + 40));
+            mismatches += layout.PointToIndex(x, y, scrollOffset) != legacy.GetClickedShortcut(x, y, scrollOffset);
+        }
+        if (mismatches) {
+            TestRegistry::Fail(__FILE__, __LINE__, c.Describe() + ": " + std::to_string(mismatches) + " points differ");
+        }
+    }
+}
+
+TEST_CASE(GridLayout, VisibleRangeHoldsEveryDrawnItem) {
+    for (const Case& c : MakeCases(200)) {
+        GridLayout layout(c.area, c.count, c.metrics);
+        LegacyGrid legacy(c.area, c.count, c.metrics);
+        if (c.count == 0) {
+            continue;
+        }
+        for (int scrollOffset : ScrollOffsets(legacy)) {
+            int first = 0;
+            int last = 0;
+            layout.GetVisibleRange(scrollOffset, first, last);
+            CHECK(first >= 0 && first <= last && last <= c.count);
+            
+            // Every item with a pixel in the area is in the range. The range pads whole
+            // cells by a row, so it reaches at most two rows past the drawn ones.
+            int firstDrawn = -1;
+            int lastDrawn = -1;
+            for (int i = 0; i < c.count; i++) {
+                if (legacy.DrawnBounds(i, scrollOffset).Intersects(c.area)) {
+                    firstDrawn = firstDrawn < 0 ? i : firstDrawn;
+                    lastDrawn = i;
+                    if (i < first || i >= last) {
+                        TestRegistry::Fail(__FILE__, __LINE__, c.Describe() + ": item " + std::to_string(i) +
+                                                               " is drawn but outside the visible range");
+                    }
+                }
+            }
+            if (firstDrawn >= 0) {
+                CHECK(first >= (firstDrawn / legacy.cols - 2) * legacy.cols);
+                CHECK(last <= (lastDrawn / legacy.cols + 3) * legacy.cols);
+            }
+        }
+    }
+}
+
+TEST_CASE(GridLayout, ScrollToShowMatchesLegacy) {
+    for (const Case& c : MakeCases(200)) {
+        GridLayout layout(c.area, c.count, c.metrics);
+        LegacyGrid legacy(c.area, c.count, c.metrics);
+        int mismatches = 0;
+        int step = std::max(1, c.count / 50);
+        for (int scrollOffset : ScrollOffsets(legacy)) {
+            for (int i = 0; i < c.count; i += step) {
+                mismatches += layout.ScrollToShow(i, scrollOffset) != legacy.EnsureVisible(i, scrollOffset);
+            }
+            if (c.count > 0) {
+                CHECK_EQ(layout.GetFirstFullyVisibleIndex(scrollOffset), legacy.FirstFullyVisibleIndex(scrollOffset));
+            }
+        }
+        if (mismatches) {
+            TestRegistry::Fail(__FILE__, __LINE__, c.Describe() + ": " + std::to_string(mismatches) + " offsets differ");
+        }
+        
+        // Out of range indices leave the offset alone
+        CHECK_EQ(layout.ScrollToShow(-1, 17), 17);
+        CHECK_EQ(layout.ScrollToShow(c.count, 17), 17);
+    }
+}
+
+TEST_CASE(GridLayout, ClampScroll) {
+    GridLayout layout(PixelRect(0, 0, 1000, 700), 100, LauncherMetrics(256));
+    int maxScroll = layout.GetMaxScroll();
+    CHECK(maxScroll > 0);
+    CHECK_EQ(layout.ClampScroll(-50), 0);
+    CHECK_EQ(layout.ClampScroll(maxScroll + 1), maxScroll);
+    CHECK_EQ(layout.ClampScroll(maxScroll / 2), maxScroll / 2);
+    
+    // Content shorter than the area doesn't scroll
+    GridLayout small(PixelRect(0, 0, 1000, 700), 2, LauncherMetrics(256));
+    CHECK_EQ(small.GetMaxScroll(), 0);
+    CHECK_EQ(small.ClampScroll(40), 0);
+    
+    // No icon size: nothing to lay out
+    CHECK(GridLayout(PixelRect(0, 0, 1000, 700), 10, GridMetrics()).IsEmpty());
+    CHECK_EQ(GridLayout().PointToIndex(5, 5, 0), -1);
+}
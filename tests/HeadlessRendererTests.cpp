@@ -0,0 +1,237 @@
+// HeadlessRendererTests.cpp - Composed frames against golden PNGs and full repaints
+//
+// The goldens in tests/golden were rendered by the Linux build (x86-64, GCC), with the
+// block glyph text TextRasterizer draws off Win32. They are not what the launcher window
+// shows, whose text comes from GDI, so the golden tests only run off Win32. After an
+// intended change to the look, run the suite with LAUNCHER_UPDATE_GOLDEN=1 set to write
+// them again and check the new images by eye.
+#include "TestFramework.h"
+#include "FrameBenchmark.h"
+#include "HeadlessRenderer.h"
+#include "IconDecoder.h"
+#include "PngWriter.h"
+#include "Settings.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+namespace {
+    int GetIconSize() {
+        return static_cast<int>(DesignConstants::TARGET_ICON_SIZE_PIXELS * Settings::Instance().GetIconScale());
+    }
+    
+    // Frame pixels as the PNG keeps them: the color over black, opaque
+    std::vector<uint32_t> OverBlack(const RasterImage& frame) {
+        std::vector<uint32_t> pixels;
+        pixels.reserve(static_cast<size_t>(frame.width) * frame.height);
+        for (int y = 0; y < frame.height; y++) {
+            for (int x = 0; x < frame.width; x++) {
+                pixels.push_back(frame.pixels[y * frame.stride + x] | 0xFF000000);
+            }
+        }
+        return pixels;
+    }
+    
+    bool DecodePng(const std::vector<uint8_t>& png, DecodedImage& image) {
+        return IconDecoder::DecodeIconImage(png.data(), png.size(), image);
+    }
+    
+    // Number of pixels that differ between the frame and a repaint of it from scratch
+    int CountRepaintDifferences(HeadlessRenderer& renderer, const FrameState& state) {
+        RasterImage frame = renderer.GetFrame();
+        std::vector<uint32_t> painted(frame.pixels, frame.pixels + static_cast<size_t>(frame.stride) * frame.height);
+        renderer.InvalidateAll();
+        renderer.Render(state);
+        int differences = 0;
+        for (size_t i = 0; i < painted.size(); i++) {
+            differences += painted[i] != frame.pixels[i];
+        }
+        return differences;
+    }
+}
+
+TEST_CASE(HeadlessRenderer, PngDecodesToTheFrame) {
+    std::vector<TabInfo> tabs;
+    FrameBenchmark::BuildTabs({9}, GetIconSize(), tabs);
+    HeadlessRenderer renderer;
+    renderer.SetSize(333, 257);                 // Odd sizes: rows that aren't a multiple of anything
+    renderer.Render(renderer.MakeState(tabs, 0, 0, 1, 1.0f));
+    
+    RasterImage frame = renderer.GetFrame();
+    std::vector<uint8_t> png = PngWriter::Encode(frame);
+    CHECK(png.size() < static_cast<size_t>(frame.width) * frame.height * 3);
+    
+    DecodedImage image;
+    REQUIRE(DecodePng(png, image));
+    CHECK_EQ(image.width, frame.width);
+    CHECK_EQ(image.height, frame.height);
+    CHECK(image.pixels == OverBlack(frame));
+}
+
+TEST_CASE(HeadlessRenderer, ChecksumsMatchReferenceValues) {
+    const uint8_t text[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    CHECK_EQ(PngWriter::Crc32(text, sizeof(text)), 0xCBF43926u);
+    CHECK_EQ(PngWriter::Adler32(text, sizeof(text)), 0x091E01DEu);
+    
+    // Continuing from a previous result is the same as one pass
+    CHECK_EQ(PngWriter::Crc32(text + 4, 5, PngWriter::Crc32(text, 4)), 0xCBF43926u);
+    CHECK_EQ(PngWriter::Adler32(text + 4, 5, PngWriter::Adler32(text, 4)), 0x091E01DEu);
+}
+
+TEST_CASE(HeadlessRenderer, ScrollMatchesRepaint) {
+    std::vector<TabInfo> tabs;
+    FrameBenchmark::BuildTabs({60}, GetIconSize(), tabs);
+    const int steps[] = {48, 48, 7, 130, -25, -48, 301, -1, -200, 3};
+    
+    for (int layer = 0; layer < 2; layer++) {
+        HeadlessRenderer renderer;
+        renderer.GetComposer().SetContentLayerEnabled(layer != 0);
+        renderer.SetSize(900, 560);
+        int scrollOffset = 0;
+        renderer.Render(renderer.MakeState(tabs, 0, scrollOffset, 0, 1.0f));
+        
+        for (int step : steps) {
+            scrollOffset += step;
+            FrameState state = renderer.MakeState(tabs, 0, scrollOffset, 0, 1.0f);
+            renderer.Scroll(state, step);
+            renderer.Render(state);
+            CHECK_EQ(CountRepaintDifferences(renderer, state), 0);
+        }
+    }
+}
+
+TEST_CASE(HeadlessRenderer, SelectionMatchesRepaint) {
+    std::vector<TabInfo> tabs;
+    FrameBenchmark::BuildTabs({30}, GetIconSize(), tabs);
+    
+    for (int layer = 0; layer < 2; layer++) {
+        HeadlessRenderer renderer;
+        renderer.GetComposer().SetContentLayerEnabled(layer != 0);
+        renderer.SetSize(900, 560);
+        int selected = -1;
+        renderer.Render(renderer.MakeState(tabs, 0, 40, selected, 1.0f));
+        
+        for (int next : {0, 1, 5, 4, 29, -1, 12}) {
+            renderer.InvalidateIcon(renderer.MakeState(tabs, 0, 40, selected, 1.0f), selected);
+            selected = next;
+            FrameState state = renderer.MakeState(tabs, 0, 40, selected, 1.0f);
+            renderer.InvalidateIcon(state, selected);
+            renderer.Render(state);
+            CHECK_EQ(CountRepaintDifferences(renderer, state), 0);
+        }
+    }
+}
+
+TEST_CASE(HeadlessRenderer, ThreadCountDoesNotChangeTheFrame) {
+    // Tiles are drawn by whichever worker takes them; each pixel must still come out the same
+    std::vector<TabInfo> tabs;
+    FrameBenchmark::BuildTabs({40}, GetIconSize(), tabs);
+    std::vector<uint32_t> reference;
+    for (size_t threads : {1, 3, 8}) {
+        HeadlessRenderer renderer;
+        renderer.GetComposer().SetRenderThreadCount(threads);
+        renderer.SetSize(1280, 800);
+        renderer.Render(renderer.MakeState(tabs, 0, 70, 3, 1.5f));
+        
+        RasterImage frame = renderer.GetFrame();
+        std::vector<uint32_t> pixels(frame.pixels, frame.pixels + static_cast<size_t>(frame.stride) * frame.height);
+        if (reference.empty()) {
+            reference = pixels;
+        }
+        CHECK(pixels == reference);
+    }
+}
+
+#ifndef _WIN32
+// GDI text is antialiased Segoe UI, which no golden here could match
+namespace {
+    struct GoldenScene {
+        const char* name;
+        int width;
+        int height;
+        int dpiPercent;
+        int activeTab;
+        int scrollOffset;
+        int selected;
+    };
+    
+    const GoldenScene GOLDEN_SCENES[] = {
+        {"grid", 640, 400, 100, 0, 0, -1},
+        {"scrolled_selection", 640, 400, 100, 1, 150, 2},
+        {"dpi150", 800, 500, 150, 2, 0, 0},
+    };
+    
+    bool WriteFile(const fs::path& path, const std::vector<uint8_t>& data) {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        return file.good();
+    }
+    
+    FrameState MakeSceneState(const HeadlessRenderer& renderer, const std::vector<TabInfo>& tabs,
+                              const GoldenScene& scene, int scrollOffset) {
+        return renderer.MakeState(tabs, scene.activeTab, scrollOffset, scene.selected, scene.dpiPercent / 100.0f);
+    }
+    
+    // Compare a frame with the golden of the scene, or write the golden when asked to
+    void CheckGolden(const GoldenScene& scene, const RasterImage& frame, bool mayUpdate) {
+        std::vector<uint8_t> png = PngWriter::Encode(frame);
+        fs::path goldenPath = fs::path(TestRegistry::GetSourceDir()) / "tests" / "golden" / (std::string(scene.name) + ".png");
+        if (mayUpdate && std::getenv("LAUNCHER_UPDATE_GOLDEN")) {
+            REQUIRE(WriteFile(goldenPath, png));
+            return;
+        }
+        
+        std::ifstream file(goldenPath, std::ios::binary);
+        std::vector<uint8_t> golden((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        DecodedImage expected;
+        bool same = DecodePng(golden, expected) && expected.width == frame.width && expected.height == frame.height &&
+                    expected.pixels == OverBlack(frame);
+        if (!same) {
+            // Leave the frame next to the other test output to compare by eye
+            fs::path actualPath = fs::temp_directory_path() / (std::string("launcher_golden_") + scene.name + ".actual.png");
+            WriteFile(actualPath, png);
+            TestRegistry::Fail(__FILE__, __LINE__, std::string("frame differs from ") + goldenPath.string() +
+                                                   ", rendered frame in " + actualPath.string());
+        }
+    }
+}
+
+TEST_CASE(HeadlessRenderer, MatchesGoldenFrames) {
+    for (const GoldenScene& scene : GOLDEN_SCENES) {
+        std::vector<TabInfo> tabs;
+        FrameBenchmark::BuildTabs({12, 20, 5}, GetIconSize(), tabs);
+        HeadlessRenderer renderer;
+        renderer.SetSize(scene.width, scene.height);
+        renderer.Render(MakeSceneState(renderer, tabs, scene, scene.scrollOffset));
+        CheckGolden(scene, renderer.GetFrame(), true);
+    }
+}
+
+TEST_CASE(HeadlessRenderer, ScrollsIntoGoldenFrame) {
+    // The scrolled golden reached by blitting in uneven steps, past it and back, so
+    // most of the frame comes from moved pixels and only the bands are drawn
+    const GoldenScene& scene = GOLDEN_SCENES[1];
+    const int steps[] = {48, 48, 13, 96, -30, -25};
+    std::vector<TabInfo> tabs;
+    FrameBenchmark::BuildTabs({12, 20, 5}, GetIconSize(), tabs);
+    
+    for (int layer = 0; layer < 2; layer++) {
+        HeadlessRenderer renderer;
+        renderer.GetComposer().SetContentLayerEnabled(layer != 0);
+        renderer.SetSize(scene.width, scene.height);
+        int scrollOffset = 0;
+        renderer.Render(MakeSceneState(renderer, tabs, scene, scrollOffset));
+        for (int step : steps) {
+            scrollOffset += step;
+            FrameState state = MakeSceneState(renderer, tabs, scene, scrollOffset);
+            renderer.Scroll(state, step);
+            renderer.Render(state);
+        }
+        REQUIRE(scrollOffset == scene.scrollOffset);
+        CheckGolden(scene, renderer.GetFrame(), false);
+    }
+}
+#endif
@@ -0,0 +1,271 @@
+// IconCacheTests.cpp - Thumbnail cache hits, misses, persistence, corruption and eviction
+#include "TestFramework.h"
+#include "IconCache.h"
+#include "WorkerPool.h"
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace fs = std::filesystem;
+
+namespace {
+    fs::path CachePath(const char* name) {
+        fs::path path = fs::temp_directory_path() / (std::string("launcher_iconcache_") + name + ".bin");
+        fs::remove(path);
+        fs::remove(path.string() + ".tmp");
+        return path;
+    }
+    
+    IconCacheKey MakeKey(int n, int targetSize) {
+        IconCacheKey key;
+        key.sourcePath = L"C:\\Games\\Icons\\Game " + std::to_wstring(n) + L".ico";
+        key.iconIndex = n % 3;
+        key.sourceSize = 10000 + n;
+        key.sourceWriteTime = 0x01D9000000000000ULL + n;
+        key.targetSize = targetSize;
+        return key;
+    }
+    
+    std::vector<uint32_t> MakeThumbnail(int n, int size) {
+        std::vector<uint32_t> pixels(static_cast<size_t>(size) * size);
+        for (size_t i = 0; i < pixels.size(); i++) {
+            pixels[i] = static_cast<uint32_t>((i + 1) * 2654435761u) ^ static_cast<uint32_t>(n);
+        }
+        return pixels;
+    }
+    
+    bool ReadsBack(IconCache& cache, int n, int size) {
+        std::vector<uint32_t> pixels(static_cast<size_t>(size) * size);
+        return cache.Read(MakeKey(n, size), pixels.data()) && pixels == MakeThumbnail(n, size);
+    }
+    
+    void Store(IconCache& cache, int n, int size) {
+        cache.Store(MakeKey(n, size), MakeThumbnail(n, size).data());
+    }
+    
+    void FlipByte(const fs::path& path, uint64_t offset) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(static_cast<std::streamoff>(offset));
+        char byte = 0;
+        file.read(&byte, 1);
+        byte ^= 0x40;
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(&byte, 1);
+    }
+}
+
+TEST_CASE(IconCache, StoreAndRead) {
+    fs::path path = CachePath("store");
+    IconCache cache;
+    REQUIRE(cache.Open(path.wstring(), 64 * 1024 * 1024));
+    for (int n = 0; n < 5; n++) {
+        Store(cache, n, n % 2 ? 48 : 32);
+    }
+    CHECK_EQ(cache.GetEntryCount(), 5u);
+    for (int n = 0; n < 5; n++) {
+        CHECK(ReadsBack(cache, n, n % 2 ? 48 : 32));
+    }
+    
+    std::vector<uint32_t> pixels(64 * 64);
+    CHECK(!cache.Read(MakeKey(99, 32), pixels.data()));
+    cache.Close();
+    fs::remove(path);
+}
+
+TEST_CASE(IconCache, ChangedSourceIsMiss) {
+    fs::path path = CachePath("stale");
+    IconCache cache;
+    REQUIRE(cache.Open(path.wstring(), 64 * 1024 * 1024));
+    Store(cache, 1, 32);
+    std::vector<uint32_t> pixels(48 * 48);
+    
+    IconCacheKey resized = MakeKey(1, 32);
+    resized.sourceSize++;
+    CHECK(!cache.Read(resized, pixels.data()));
+    IconCacheKey touched = MakeKey(1, 32);
+    touched.sourceWriteTime++;
+    CHECK(!cache.Read(touched, pixels.data()));
+    IconCacheKey otherIndex = MakeKey(1, 32);
+    otherIndex.iconIndex++;
+    CHECK(!cache.Read(otherIndex, pixels.data()));
+    // IconScale changed: a different thumbnail, not a scaled copy
+    CHECK(!cache.Read(MakeKey(1, 48), pixels.data()));
+    
+    // Storing the new identity replaces the stale record
+    cache.Store(touched, MakeThumbnail(2, 32).data());
+    CHECK(cache.Read(touched, pixels.data()));
+    CHECK(!cache.Read(MakeKey(1, 32), pixels.data()));
+    CHECK_EQ(cache.GetEntryCount(), 1u);
+    cache.Close();
+    fs::remove(path);
+}
+
+TEST_CASE(IconCache, PersistsAcrossSessions) {
+    fs::path path = CachePath("persist");
+    {
+        IconCache cache;
+        REQUIRE(cache.Open(path.wstring(), 64 * 1024 * 1024));
+        for (int n = 0; n < 20; n++) {
+            Store(cache, n, 64);
+        }
+    }
+    
+    // Records are page-aligned after the reserved header page
+    CHECK(fs::file_size(path) >= 4096 + 20 * 4096 * 4);
+    
+    IconCache cache;
+    REQUIRE(cache.Open(path.wstring(), 64 * 1024 * 1024));
+    CHECK_EQ(cache.GetEntryCount(), 20u);
+    for (int n = 0; n < 20; n++) {
+        CHECK(ReadsBack(cache, n, 64));
+    }
+    cache.Close();
+    fs::remove(path);
+}
+
+TEST_CASE(IconCache, CorruptRecordIsDropped) {
+    fs::path path = CachePath("record");
+    {
+        IconCache cache;
+        REQUIRE(cache.Open(path.wstring(), 64 * 1024 * 1024));
+        Store(cache, 0, 32);
+        Store(cache, 1, 32);
+    }
+    
+    // Damage a pixel in the first record (the one right after the header page)
+    FlipByte(path, 4096 + 100);
+    IconCache cache;
+    REQUIRE(cache.Open(path.wstring(), 64 * 1024 * 1024));
+    int good = ReadsBack(cache, 0, 32) + ReadsBack(cache, 1, 32);
+    CHECK_EQ(good, 1);
+    CHECK_EQ(cache.GetEntryCount(), 1u);
+    cache.Close();
+    fs::remove(path);
+}
+
+TEST_CASE(IconCache, CorruptIndexStartsEmpty) {
+    fs::path path = CachePath("index");
+    {
+        IconCache cache;
+        REQUIRE(cache.Open(path.wstring(), 64 * 1024 * 1024));
+        Store(cache, 0, 32);
+    }
+    uint64_t size = fs::file_size(path);
+    
+    // The index at the end of the file, the magic and the index offset in the header,
+    // then a cut
+    for (uint64_t offset : {size - 8, static_cast<uint64_t>(0), static_cast<uint64_t>(24)}) {
+        fs::path copy = CachePath("index_copy");
+        fs::copy_file(path, copy);
+        FlipByte(copy, offset);
+        IconCache cache;
+        REQUIRE(cache.Open(copy.wstring(), 64 * 1024 * 1024));
+        CHECK_EQ(cache.GetEntryCount(), 0u);
+        CHECK(!ReadsBack(cache, 0, 32));
+        cache.Close();
+        fs::remove(copy);
+    }
+    
+    fs::resize_file(path, size - 1);
+    IconCache cache;
+    REQUIRE(cache.Open(path.wstring(), 64 * 1024 * 1024));
+    CHECK_EQ(cache.GetEntryCount(), 0u);
+    
+    // An emptied cache is usable straight away
+    Store(cache, 3, 32);
+    CHECK(ReadsBack(cache, 3, 32));
+    cache.Close();
+    fs::remove(path);
+}
+
+TEST_CASE(IconCache, EvictsLeastRecentlyUsed) {
+    // 64px thumbnails are 16 KiB records; the limit holds six, compaction keeps
+    // three quarters of it (four records)
+    fs::path path = CachePath("evict");
+    const uint64_t LIMIT = 6 * 16384 + 1000;
+    {
+        IconCache cache;
+        REQUIRE(cache.Open(path.wstring(), LIMIT));
+        for (int n = 0; n < 4; n++) {
+            Store(cache, n, 64);
+        }
+    }
+    {
+        // Next session: two old thumbnails are used again and four new ones added
+        IconCache cache;
+        REQUIRE(cache.Open(path.wstring(), LIMIT));
+        CHECK(ReadsBack(cache, 0, 64));
+        CHECK(ReadsBack(cache, 1, 64));
+        for (int n = 10; n < 14; n++) {
+            Store(cache, n, 64);
+        }
+        cache.Flush();
+        CHECK_EQ(cache.GetEntryCount(), 4u);
+        CHECK(!ReadsBack(cache, 2, 64));
+        CHECK(!ReadsBack(cache, 3, 64));
+    }
+    CHECK(fs::file_size(path) <= 4096 + LIMIT);
+    CHECK(!fs::exists(path.string() + ".tmp"));
+    
+    IconCache cache;
+    REQUIRE(cache.Open(path.wstring(), LIMIT));
+    int kept = 0;
+    for (int n : {0, 1, 10, 11, 12, 13}) {
+        kept += ReadsBack(cache, n, 64);
+    }
+    CHECK_EQ(kept, 4);
+    cache.Close();
+    fs::remove(path);
+}
+
+TEST_CASE(IconCache, ConcurrentReadsAndStores) {
+    fs::path path = CachePath("concurrent");
+    IconCache cache;
+    REQUIRE(cache.Open(path.wstring(), 64 * 1024 * 1024));
+    for (int n = 0; n < 50; n++) {
+        Store(cache, n, 32);
+    }
+    
+    WorkerPool pool(4);
+    std::vector<int> results(200);
+    pool.ParallelFor(results.size(), [&](size_t index, size_t /*worker*/) {
+        int n = static_cast<int>(index);
+        if (n < 50) {
+            results[index] = ReadsBack(cache, n, 32);
+        } else {
+            Store(cache, n, 32);
+            results[index] = 1;
+        }
+    });
+    for (int result : results) {
+        CHECK_EQ(result, 1);
+    }
+    
+    cache.Flush();
+    CHECK_EQ(cache.GetEntryCount(), 200u);
+    for (int n = 0; n < 200; n++) {
+        CHECK(ReadsBack(cache, n, 32));
+    }
+    cache.Close();
+    fs::remove(path);
+}
+
+TEST_CASE(IconCache, NonAsciiPath) {
+    // Wide paths reach the file system as UTF-8 outside Windows
+    fs::path directory = fs::temp_directory_path();
+    fs::path path = fs::u8path(directory.u8string() + u8"/launcher_iconcache_Pok\u00E9mon \U0001F3AE.bin");
+    fs::remove(path);
+    std::wstring widePath = directory.wstring() + L"/launcher_iconcache_Pok\u00E9mon \U0001F3AE.bin";
+    {
+        IconCache cache;
+        REQUIRE(cache.Open(widePath, 64 * 1024 * 1024));
+        Store(cache, 0, 32);
+    }
+    CHECK(fs::exists(path));
+    
+    IconCache cache;
+    REQUIRE(cache.Open(widePath, 64 * 1024 * 1024));
+    CHECK(ReadsBack(cache, 0, 32));
+    cache.Close();
+    fs::remove(path);
+}
@@ -0,0 +1,773 @@
+// IconDecoderTests.cpp - Icon decoding against the data/ icons and synthetic DIB/PNG files
+#include "TestFramework.h"
+#include "IconDecoder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // FNV-1a over the decoded pixel words (little-endian) of each data/ icon. The values
+    // come from an independent decode (zlib, the PNG filters and (c * a + 127) / 255
+    // premultiplication), so a change here means the decoder output changed.
+    struct ReferenceIcon {
+        const char* path;
+        uint64_t hash;
+    };
+    
+    const ReferenceIcon REFERENCE_ICONS[] = {
+        {u8"DOS/icons/Epic Pinball.ico", 0x5DCD3E7957CE5742ULL},
+        {u8"DOS/icons/Master of Orion II.ico", 0x1803B0C7FDBF57E4ULL},
+        {u8"DOS/icons/Solar Winds.ico", 0x6B56BD80A3DD8AA9ULL},
+        {u8"DOS/icons/Star Trek - Judgment Rites.ico", 0x44ABBE010280F4A2ULL},
+        {u8"DOS/icons/Syndicate.ico", 0xB82C3525A74FCFF0ULL},
+        {u8"DOS/icons/X-Wing.ico", 0x6744B2C142BEEE32ULL},
+        {u8"DOS/icons/Zone 66.ico", 0x8C6BA0B6D947FABBULL},
+        {u8"GAMES/icons/AC Black Flag.ico", 0x4E5B6AA57B21D751ULL},
+        {u8"GAMES/icons/AC Odyssey.ico", 0x5A889847356245AAULL},
+        {u8"GAMES/icons/Alien Isolation.ico", 0xF3840C7E83C55D87ULL},
+        {u8"GAMES/icons/Book of Hours.ico", 0x2F8BCAB52B046FA7ULL},
+        {u8"GAMES/icons/Carmageddon - Max Damage.ico", 0xC785ADACF5F40286ULL},
+        {u8"GAMES/icons/Chorus.ico", 0x98AAEC90D1E3D866ULL},
+        {u8"GAMES/icons/Disco Elysium.ico", 0x9032406DFC82C197ULL},
+        {u8"GAMES/icons/Dishonored 2.ico", 0x057C012A803781A8ULL},
+        {u8"GAMES/icons/Fallout - New Vegas.ico", 0x8A5F468BEDBA3FC4ULL},
+        {u8"GAMES/icons/Fallout 4.ico", 0xFD74C2ECBD0D4F25ULL},
+        {u8"GAMES/icons/Heaven's Vault.ico", 0x0F1E8D3E19F90B41ULL},
+        {u8"GAMES/icons/Mafia II.ico", 0x67A70BFC7A4246DBULL},
+        {u8"GAMES/icons/Outer Wilds.ico", 0xD7943D96BB431CC7ULL},
+        {u8"GAMES/icons/Red Dead Redemption 2.ico", 0x5E25A7BA3FF14772ULL},
+        {u8"GAMES/icons/Uncharted 2.ico", 0x27D5C70243A4FFC6ULL},
+        {u8"GAMES/icons/Under The Waves.ico", 0x5597A3AF8CD5CE44ULL},
+        {u8"GAMES/icons/Watch_Dogs.ico", 0x37487162C2FE0E99ULL},
+        {u8"SWITCH/icons/A Highland Song.ico", 0xAC2F4F28FCD6D8CAULL},
+        {u8"SWITCH/icons/Donkey Kong Country - Tropical Freeze.ico", 0x85C6F1A856011B33ULL},
+        {u8"SWITCH/icons/Mario Kart 8 Deluxe.ico", 0xC8C073D6AA9A3936ULL},
+        {u8"SWITCH/icons/Mario Tennis Aces.ico", 0x2FC7F5F1EC19FD78ULL},
+        {u8"SWITCH/icons/New Super Mario Bros. U Deluxe.ico", 0xF200884299AD6C73ULL},
+        {u8"SWITCH/icons/Pokémon Legends - Arceus.ico", 0xDCB77E19198C1E19ULL},
+        {u8"SWITCH/icons/Prince of Persia - The Lost Crown.ico", 0x5E39232CD5886785ULL},
+        {u8"SWITCH/icons/Super Mario 3D World + Bowser's Fury.ico", 0x5393FD1FB50C4AE3ULL},
+        {u8"SWITCH/icons/Super Mario Bros. Wonder.ico", 0xF6EA8820A51C00A8ULL},
+        {u8"SWITCH/icons/Super Mario Galaxy 2.ico", 0x0C148EE62368DC83ULL},
+        {u8"SWITCH/icons/Super Mario Galaxy.ico", 0xA532BD9B998BAE6EULL},
+        {u8"SWITCH/icons/Super Mario Party Jamboree.ico", 0xDD6A0ECF61D324B7ULL},
+        {u8"SWITCH/icons/The Legend of Zelda - Breath of the Wilds.ico", 0xDC76CD41837C87FAULL},
+        {u8"SWITCH/icons/The Legend of Zelda - Tears of the Kingdom.ico", 0x2848963F40D0BE6BULL},
+    };
+    
+    std::vector<uint8_t> ReadFile(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    
+    fs::path DataDir() {
+        return fs::path(TestRegistry::GetSourceDir()) / "data";
+    }
+    
+    uint64_t HashPixels(const std::vector<uint32_t>& pixels) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (uint32_t pixel : pixels) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                hash = (hash ^ ((pixel >> shift) & 0xFF)) * 0x100000001B3ULL;
+            }
+        }
+        return hash;
+    }
+    
+    uint32_t RefMultiply(uint32_t c, uint32_t a) {
+        return (c * a + 127) / 255;
+    }
+    
+    uint32_t Premultiplied(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+        return (a << 24) | (RefMultiply(r, a) << 16) | (RefMultiply(g, a) << 8) | RefMultiply(b, a);
+    }
+    
+    void PutLe16(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+    
+    void PutLe32(std::vector<uint8_t>& out, uint32_t value) {
+        PutLe16(out, value & 0xFFFF);
+        PutLe16(out, value >> 16);
+    }
+    
+    void PutBe32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    }
+    
+    // ---- DIB (BITMAPINFOHEADER, color rows then AND mask, both bottom-up) ----
+    
+    struct DibSpec {
+        int width = 0;
+        int height = 0;
+        int bitCount = 32;
+        std::vector<uint32_t> colors;      // 0xAARRGGBB for 24/32 bpp, palette indices otherwise
+        std::vector<uint32_t> palette;     // 0x00RRGGBB
+        std::vector<bool> mask;            // true = transparent
+        bool writeMask = true;
+        uint32_t compression = 0;
+    };
+    
+    std::vector<uint8_t> MakeDib(const DibSpec& spec) {
+        std::vector<uint8_t> out;
+        PutLe32(out, 40);
+        PutLe32(out, spec.width);
+        PutLe32(out, spec.height * 2);
+        PutLe16(out, 1);
+        PutLe16(out, spec.bitCount);
+        PutLe32(out, spec.compression);
+        for (int i = 0; i < 3; i++) {
+            PutLe32(out, 0);       // Image size, resolution
+        }
+        PutLe32(out, static_cast<uint32_t>(spec.palette.size()));
+        PutLe32(out, 0);
+        for (uint32_t color : spec.palette) {
+            PutLe32(out, color);
+        }
+        
+        size_t colorStride = ((static_cast<size_t>(spec.width) * spec.bitCount + 31) / 32) * 4;
+        for (int y = spec.height - 1; y >= 0; y--) {
+            std::vector<uint8_t> row(colorStride, 0);
+            for (int x = 0; x < spec.width; x++) {
+                uint32_t value = spec.colors[static_cast<size_t>(y) * spec.width + x];
+                if (spec.bitCount >= 24) {
+                    for (int c = 0; c < spec.bitCount / 8; c++) {
+                        row[x * (spec.bitCount / 8) + c] = static_cast<uint8_t>(value >> (c * 8));
+                    }
+                } else {
+                    size_t bit = static_cast<size_t>(x) * spec.bitCount;
+                    row[bit / 8] |= static_cast<uint8_t>(value << (8 - spec.bitCount - bit % 8));
+                }
+            }
+            out.insert(out.end(), row.begin(), row.end());
+        }
+        
+        if (spec.writeMask) {
+            size_t maskStride = ((static_cast<size_t>(spec.width) + 31) / 32) * 4;
+            for (int y = spec.height - 1; y >= 0; y--) {
+                std::vector<uint8_t> row(maskStride, 0);
+                for (int x = 0; x < spec.width; x++) {
+                    if (spec.mask[static_cast<size_t>(y) * spec.width + x]) {
+                        row[x / 8] |= static_cast<uint8_t>(0x80 >> (x % 8));
+                    }
+                }
+                out.insert(out.end(), row.begin(), row.end());
+            }
+        }
+        return out;
+    }
+    
+    // Expected decode of a DIB spec, following the ICO rules: 32 bpp alpha wins unless
+    // it is all zero, otherwise the AND mask decides
+    std::vector<uint32_t> ExpectedDib(const DibSpec& spec) {
+        bool useAlpha = false;
+        if (spec.bitCount == 32) {
+            for (uint32_t color : spec.colors) {
+                useAlpha = useAlpha || (color >> 24) != 0;
+            }
+        }
+        std::vector<uint32_t> pixels;
+        for (size_t i = 0; i < spec.colors.size(); i++) {
+            uint32_t color = spec.bitCount >= 24 ? spec.colors[i] : spec.palette[spec.colors[i]];
+            uint32_t a = useAlpha ? color >> 24 : 255;
+            if (!useAlpha && spec.writeMask && spec.mask[i]) {
+                a = 0;
+            }
+            pixels.push_back(Premultiplied((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF, a));
+        }
+        return pixels;
+    }
+    
+    DibSpec RandomDib(std::mt19937& random, int width, int height, int bitCount) {
+        DibSpec spec;
+        spec.width = width;
+        spec.height = height;
+        spec.bitCount = bitCount;
+        if (bitCount <= 8) {
+            for (int i = 0; i < (1 << bitCount); i++) {
+                spec.palette.push_back(random() & 0xFFFFFF);
+            }
+        }
+        for (int i = 0; i < width * height; i++) {
+            uint32_t value = static_cast<uint32_t>(random());
+            if (bitCount <= 8) {
+                value %= 1u << bitCount;
+            } else if (bitCount == 24) {
+                value &= 0xFFFFFF;
+            }
+            spec.colors.push_back(value);
+            spec.mask.push_back(random() % 3 == 0);
+        }
+        return spec;
+    }
+    
+    // ---- PNG (zlib stored blocks; the data/ icons cover compressed streams) ----
+    
+    uint32_t Crc32(const uint8_t* data, size_t size) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (size_t i = 0; i < size; i++) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+    
+    std::vector<uint8_t> ZlibStored(const std::vector<uint8_t>& data) {
+        std::vector<uint8_t> out = {0x78, 0x01};
+        size_t position = 0;
+        do {
+            size_t length = std::min<size_t>(data.size() - position, 65535);
+            out.push_back(position + length == data.size() ? 1 : 0);
+            PutLe16(out, static_cast<uint32_t>(length));
+            PutLe16(out, static_cast<uint32_t>(~length & 0xFFFF));
+            out.insert(out.end(), data.begin() + position, data.begin() + position + length);
+            position += length;
+        } while (position < data.size());
+        
+        uint32_t a = 1, b = 0;
+        for (uint8_t byte : data) {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        PutBe32(out, (b << 16) | a);
+        return out;
+    }
+    
+    void PutChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+        PutBe32(out, static_cast<uint32_t>(data.size()));
+        size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+        PutBe32(out, Crc32(out.data() + start, out.size() - start));
+    }
+    
+    uint8_t Paeth(int a, int b, int c) {
+        int p = a + b - c;
+        int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+        return static_cast<uint8_t>(pa <= pb && pa <= pc ? a : (pb <= pc ? b : c));
+    }
+    
+    // Filter rows of stride bytes with the given filter types, cycling through them
+    std::vector<uint8_t> FilterRows(const std::vector<uint8_t>& rows, size_t stride, size_t bytesPerPixel,
+                                    const std::vector<uint8_t>& filters) {
+        std::vector<uint8_t> out;
+        size_t height = stride ? rows.size() / stride : 0;
+        for (size_t y = 0; y < height; y++) {
+            uint8_t filter = filters[y % filters.size()];
+            out.push_back(filter);
+            for (size_t i = 0; i < stride; i++) {
+                int left = i >= bytesPerPixel ? rows[y * stride + i - bytesPerPixel] : 0;
+                int up = y ? rows[(y - 1) * stride + i] : 0;
+                int upLeft = y && i >= bytesPerPixel ? rows[(y - 1) * stride + i - bytesPerPixel] : 0;
+                int predicted = 0;
+                switch (filter) {
+                    case 1: predicted = left; break;
+                    case 2: predicted = up; break;
+                    case 3: predicted = (left + up) >> 1; break;
+                    case 4: predicted = Paeth(left, up, upLeft); break;
+                    default: break;
+                }
+                out.push_back(static_cast<uint8_t>(rows[y * stride + i] - predicted));
+            }
+        }
+        return out;
+    }
+    
+    struct PngSpec {
+        int width = 0;
+        int height = 0;
+        int colorType = 6;
+        int bitDepth = 8;
+        bool interlace = false;
+        std::vector<uint32_t> samples;     // width * height * channels, at bitDepth
+        std::vector<uint8_t> palette;      // RGB triples
+        std::vector<uint8_t> transparency; // tRNS chunk, if any
+        std::vector<uint8_t> filters = {0, 1, 2, 3, 4};
+    };
+    
+    int Channels(int colorType) {
+        static const int CHANNELS[7] = {1, 0, 3, 1, 2, 0, 4};
+        return CHANNELS[colorType];
+    }
+    
+    // Pack pixels [x0, x0 + step, ...) of row y into a scanline at the spec's depth
+    std::vector<uint8_t> PackRow(const PngSpec& spec, int y, int x0, int step) {
+        int channels = Channels(spec.colorType);
+        std::vector<uint8_t> row;
+        size_t bit = 0;
+        for (int x = x0; x < spec.width; x += step) {
+            for (int c = 0; c < channels; c++) {
+                uint32_t sample = spec.samples[(static_cast<size_t>(y) * spec.width + x) * channels + c];
+                if (spec.bitDepth == 16) {
+                    row.push_back(static_cast<uint8_t>(sample >> 8));
+                    row.push_back(static_cast<uint8_t>(sample));
+                } else if (spec.bitDepth == 8) {
+                    row.push_back(static_cast<uint8_t>(sample));
+                } else {
+                    if (bit % 8 == 0) {
+                        row.push_back(0);
+                    }
+                    row.back() |= static_cast<uint8_t>(sample << (8 - spec.bitDepth - bit % 8));
+                    bit += spec.bitDepth;
+                }
+            }
+        }
+        return row;
+    }
+    
+    std::vector<uint8_t> MakePng(const PngSpec& spec) {
+        static const int ADAM7[7][4] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4},
+                                        {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+        static const int NO_INTERLACE[1][4] = {{0, 0, 1, 1}};
+        const int (*passes)[4] = spec.interlace ? ADAM7 : NO_INTERLACE;
+        int passCount = spec.interlace ? 7 : 1;
+        size_t bytesPerPixel = std::max<size_t>(1, Channels(spec.colorType) * spec.bitDepth / 8);
+        
+        std::vector<uint8_t> scanlines;
+        for (int pass = 0; pass < passCount; pass++) {
+            std::vector<uint8_t> rows;
+            size_t stride = 0;
+            for (int y = passes[pass][1]; y < spec.height; y += passes[pass][3]) {
+                std::vector<uint8_t> row = PackRow(spec, y, passes[pass][0], passes[pass][2]);
+                stride = row.size();
+                rows.insert(rows.end(), row.begin(), row.end());
+            }
+            if (stride) {
+                std::vector<uint8_t> filtered = FilterRows(rows, stride, bytesPerPixel, spec.filters);
+                scanlines.insert(scanlines.end(), filtered.begin(), filtered.end());
+            }
+        }
+        
+        std::vector<uint8_t> out = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+        std::vector<uint8_t> header;
+        PutBe32(header, spec.width);
+        PutBe32(header, spec.height);
+        header.push_back(static_cast<uint8_t>(spec.bitDepth));
+        header.push_back(static_cast<uint8_t>(spec.colorType));
+        header.push_back(0);
+        header.push_back(0);
+        header.push_back(spec.interlace ? 1 : 0);
+        PutChunk(out, "IHDR", header);
+        if (!spec.palette.empty()) {
+            PutChunk(out, "PLTE", spec.palette);
+        }
+        if (!spec.transparency.empty()) {
+            PutChunk(out, "tRNS", spec.transparency);
+        }
+        PutChunk(out, "IDAT", ZlibStored(scanlines));
+        PutChunk(out, "IEND", {});
+        return out;
+    }
+    
+    // Expected decode per the PNG specification: samples scaled to 8 bits, then premultiplied
+    std::vector<uint32_t> ExpectedPng(const PngSpec& spec) {
+        int channels = Channels(spec.colorType);
+        uint32_t maxSample = (1u << spec.bitDepth) - 1;
+        auto scale = [&](uint32_t sample) { return spec.bitDepth == 16 ? sample >> 8 : sample * 255 / maxSample; };
+        auto transparentKey = [&](int i) {
+            return static_cast<uint32_t>((spec.transparency[i * 2] << 8) | spec.transparency[i * 2 + 1]);
+        };
+        
+        std::vector<uint32_t> pixels;
+        for (size_t p = 0; p < static_cast<size_t>(spec.width) * spec.height; p++) {
+            const uint32_t* s = &spec.samples[p * channels];
+            uint32_t r, g, b, a = 255;
+            switch (spec.colorType) {
+                case 0:
+                    r = g = b = scale(s[0]);
+                    if (!spec.transparency.empty() && s[0] == transparentKey(0)) {
+                        a = 0;
+                    }
+                    break;
+                case 2:
+                    r = scale(s[0]);
+                    g = scale(s[1]);
+                    b = scale(s[2]);
+                    if (!spec.transparency.empty() && s[0] == transparentKey(0) && s[1] == transparentKey(1) &&
+                        s[2] == transparentKey(2)) {
+                        a = 0;
+                    }
+                    break;
+                case 3:
+                    r = spec.palette[s[0] * 3];
+                    g = spec.palette[s[0] * 3 + 1];
+                    b = spec.palette[s[0] * 3 + 2];
+                    a = s[0] < spec.transparency.size() ? spec.transparency[s[0]] : 255;
+                    break;
+                case 4:
+                    r = g = b = scale(s[0]);
+                    a = scale(s[1]);
+                    break;
+                default:
+                    r = scale(s[0]);
+                    g = scale(s[1]);
+                    b = scale(s[2]);
+                    a = scale(s[3]);
+                    break;
+            }
+            pixels.push_back(Premultiplied(r, g, b, a));
+        }
+        return pixels;
+    }
+    
+    PngSpec RandomPng(std::mt19937& random, int width, int height, int colorType, int bitDepth) {
+        PngSpec spec;
+        spec.width = width;
+        spec.height = height;
+        spec.colorType = colorType;
+        spec.bitDepth = bitDepth;
+        uint32_t maxSample = (1u << bitDepth) - 1;
+        if (colorType == 3) {
+            for (uint32_t i = 0; i <= maxSample; i++) {
+                for (int c = 0; c < 3; c++) {
+                    spec.palette.push_back(static_cast<uint8_t>(random()));
+                }
+            }
+            // Alpha for the first half of the palette only; the rest stay opaque
+            for (uint32_t i = 0; i < (maxSample + 1) / 2; i++) {
+                spec.transparency.push_back(static_cast<uint8_t>(random()));
+            }
+        }
+        for (int i = 0; i < width * height * Channels(colorType); i++) {
+            spec.samples.push_back(static_cast<uint32_t>(random()) & maxSample);
+        }
+        return spec;
+    }
+    
+    // ---- ICO ----
+    
+    struct IcoEntry {
+        int width;
+        int height;
+        int bitCount;
+        std::vector<uint8_t> data;
+    };
+    
+    std::vector<uint8_t> MakeIco(const std::vector<IcoEntry>& entries) {
+        std::vector<uint8_t> out;
+        PutLe16(out, 0);
+        PutLe16(out, 1);
+        PutLe16(out, static_cast<uint32_t>(entries.size()));
+        size_t offset = 6 + entries.size() * 16;
+        for (const IcoEntry& entry : entries) {
+            out.push_back(static_cast<uint8_t>(entry.width & 0xFF));
+            out.push_back(static_cast<uint8_t>(entry.height & 0xFF));
+            out.push_back(0);
+            out.push_back(0);
+            PutLe16(out, 1);
+            PutLe16(out, entry.bitCount);
+            PutLe32(out, static_cast<uint32_t>(entry.data.size()));
+            PutLe32(out, static_cast<uint32_t>(offset));
+            offset += entry.data.size();
+        }
+        for (const IcoEntry& entry : entries) {
+            out.insert(out.end(), entry.data.begin(), entry.data.end());
+        }
+        return out;
+    }
+    
+    bool Decode(const std::vector<uint8_t>& data, DecodedImage& image) {
+        return IconDecoder::DecodeIconImage(data.data(), data.size(), image);
+    }
+}
+
+TEST_CASE(IconDecoder, DataIconsMatchReference) {
+    for (const ReferenceIcon& reference : REFERENCE_ICONS) {
+        std::vector<uint8_t> file = ReadFile(fs::u8path(DataDir().u8string() + "/" + reference.path));
+        DecodedImage image;
+        if (!IconDecoder::DecodeIco(file.data(), file.size(), 256, image)) {
+            TestRegistry::Fail(__FILE__, __LINE__, std::string("failed to decode ") + reference.path);
+            continue;
+        }
+        CHECK_EQ(image.width, 256);
+        CHECK_EQ(image.height, 256);
+        if (HashPixels(image.pixels) != reference.hash) {
+            TestRegistry::Fail(__FILE__, __LINE__, std::string("pixels differ for ") + reference.path);
+        }
+    }
+}
+
+TEST_CASE(IconDecoder, EveryDataIconDecodes) {
+    // Icons added to data/ later have no reference, but must still decode to sane pixels
+    int count = 0;
+    for (const auto& folder : fs::directory_iterator(DataDir())) {
+        if (!fs::is_directory(folder.path() / "icons")) {
+            continue;
+        }
+        for (const auto& entry : fs::directory_iterator(folder.path() / "icons")) {
+            std::vector<uint8_t> file = ReadFile(entry.path());
+            DecodedImage image;
+            if (!IconDecoder::DecodeIco(file.data(), file.size(), 96, image)) {
+                TestRegistry::Fail(__FILE__, __LINE__, "failed to decode " + entry.path().u8string());
+                continue;
+            }
+            CHECK(image.width > 0 && image.width <= IconDecoder::MAX_IMAGE_SIZE);
+            REQUIRE(image.pixels.size() == static_cast<size_t>(image.width) * image.height);
+            
+            // Premultiplied: no channel exceeds its alpha
+            bool premultiplied = true;
+            for (uint32_t pixel : image.pixels) {
+                uint32_t a = pixel >> 24;
+                premultiplied = premultiplied && ((pixel >> 16) & 0xFF) <= a && ((pixel >> 8) & 0xFF) <= a &&
+                                (pixel & 0xFF) <= a;
+            }
+            CHECK(premultiplied);
+            count++;
+        }
+    }
+    CHECK(count >= static_cast<int>(sizeof(REFERENCE_ICONS) / sizeof(REFERENCE_ICONS[0])));
+}
+
+TEST_CASE(IconDecoder, SelectBestEntry) {
+    auto select = [](std::vector<IconEntryInfo> entries, int target) {
+        return IconDecoder::SelectBestEntry(entries, target);
+    };
+    
+    CHECK_EQ(select({}, 32), -1);
+    // The smallest entry that covers the target
+    CHECK_EQ(select({{16, 16, 32}, {48, 48, 32}, {32, 32, 32}, {256, 256, 32}}, 32), 2);
+    CHECK_EQ(select({{16, 16, 32}, {48, 48, 32}, {32, 32, 32}, {256, 256, 32}}, 40), 1);
+    // Nothing covers it: the largest
+    CHECK_EQ(select({{16, 16, 32}, {48, 48, 32}, {32, 32, 32}}, 256), 1);
+    // Same size: deeper color wins, and bit count 0 counts as 32
+    CHECK_EQ(select({{32, 32, 4}, {32, 32, 8}, {32, 32, 24}}, 32), 2);
+    CHECK_EQ(select({{32, 32, 24}, {32, 32, 0}}, 32), 1);
+    CHECK_EQ(select({{32, 32, 32}, {32, 32, 0}}, 32), 0);
+    // Non-square entries are measured by their larger side
+    CHECK_EQ(select({{64, 16, 32}, {32, 32, 32}}, 48), 0);
+}
+
+TEST_CASE(IconDecoder, Dib32WithAlpha) {
+    std::mt19937 random(1);
+    DibSpec spec = RandomDib(random, 7, 5, 32);
+    DecodedImage image;
+    REQUIRE(Decode(MakeDib(spec), image));
+    CHECK_EQ(image.width, 7);
+    CHECK_EQ(image.height, 5);
+    CHECK(image.pixels == ExpectedDib(spec));
+}
+
+TEST_CASE(IconDecoder, Dib32WithoutAlphaUsesMask) {
+    // Pre-XP 32-bit icons leave alpha at zero and rely on the AND mask
+    std::mt19937 random(2);
+    DibSpec spec = RandomDib(random, 9, 4, 32);
+    for (uint32_t& color : spec.colors) {
+        color &= 0xFFFFFF;
+    }
+    DecodedImage image;
+    REQUIRE(Decode(MakeDib(spec), image));
+    CHECK(image.pixels == ExpectedDib(spec));
+    CHECK((image.pixels[0] >> 24) == (spec.mask[0] ? 0u : 255u));
+}
+
+TEST_CASE(IconDecoder, DibBitDepths) {
+    // Odd widths so every row needs DWORD padding, in both the colors and the mask
+    std::mt19937 random(3);
+    for (int bitCount : {1, 4, 8, 24}) {
+        for (int width : {1, 13, 33}) {
+            DibSpec spec = RandomDib(random, width, 6, bitCount);
+            DecodedImage image;
+            if (!Decode(MakeDib(spec), image) || image.pixels != ExpectedDib(spec)) {
+                TestRegistry::Fail(__FILE__, __LINE__,
+                                   "wrong decode at " + std::to_string(bitCount) + " bpp, width " + std::to_string(width));
+            }
+        }
+    }
+}
+
+TEST_CASE(IconDecoder, DibWithoutMaskIsOpaque) {
+    std::mt19937 random(4);
+    DibSpec spec = RandomDib(random, 8, 8, 24);
+    spec.writeMask = false;
+    DecodedImage image;
+    REQUIRE(Decode(MakeDib(spec), image));
+    CHECK(image.pixels == ExpectedDib(spec));
+}
+
+TEST_CASE(IconDecoder, PngFilters) {
+    // Every filter type, on every row position, including the first row (no row above)
+    std::mt19937 random(5);
+    for (uint8_t first = 0; first < 5; first++) {
+        PngSpec spec = RandomPng(random, 17, 9, 6, 8);
+        spec.filters = {first, static_cast<uint8_t>((first + 1) % 5), static_cast<uint8_t>((first + 2) % 5),
+                        static_cast<uint8_t>((first + 3) % 5), static_cast<uint8_t>((first + 4) % 5)};
+        DecodedImage image;
+        REQUIRE(Decode(MakePng(spec), image));
+        CHECK_EQ(image.width, 17);
+        CHECK_EQ(image.height, 9);
+        CHECK(image.pixels == ExpectedPng(spec));
+    }
+}
+
+TEST_CASE(IconDecoder, PngFormats) {
+    struct Format {
+        int colorType;
+        int bitDepth;
+    };
+    const Format formats[] = {{0, 1}, {0, 2}, {0, 4}, {0, 8}, {0, 16}, {2, 8}, {2, 16}, {3, 1}, {3, 2},
+                              {3, 4}, {3, 8}, {4, 8}, {4, 16}, {6, 8}, {6, 16}};
+    std::mt19937 random(6);
+    for (const Format& format : formats) {
+        PngSpec spec = RandomPng(random, 11, 7, format.colorType, format.bitDepth);
+        DecodedImage image;
+        if (!Decode(MakePng(spec), image) || image.pixels != ExpectedPng(spec)) {
+            TestRegistry::Fail(__FILE__, __LINE__, "wrong decode for color type " + std::to_string(format.colorType) +
+                                                   ", depth " + std::to_string(format.bitDepth));
+        }
+    }
+}
+
+TEST_CASE(IconDecoder, PngTransparentColor) {
+    std::mt19937 random(7);
+    PngSpec gray = RandomPng(random, 16, 4, 0, 8);
+    gray.transparency = {0, static_cast<uint8_t>(gray.samples[3])};
+    PngSpec rgb = RandomPng(random, 16, 4, 2, 16);
+    for (int c = 0; c < 3; c++) {
+        rgb.transparency.push_back(static_cast<uint8_t>(rgb.samples[c] >> 8));
+        rgb.transparency.push_back(static_cast<uint8_t>(rgb.samples[c]));
+    }
+    for (const PngSpec* spec : {&gray, &rgb}) {
+        DecodedImage image;
+        REQUIRE(Decode(MakePng(*spec), image));
+        CHECK(image.pixels == ExpectedPng(*spec));
+    }
+    
+    DecodedImage image;
+    REQUIRE(Decode(MakePng(gray), image));
+    CHECK_EQ(image.pixels[3], 0u);
+}
+
+TEST_CASE(IconDecoder, PngInterlaced) {
+    // Sizes smaller than the 8x8 Adam7 tile leave some passes empty
+    std::mt19937 random(8);
+    for (int size : {1, 3, 8, 13}) {
+        for (int colorType : {3, 6}) {
+            PngSpec spec = RandomPng(random, size, size + 2, colorType, colorType == 3 ? 4 : 8);
+            spec.interlace = true;
+            DecodedImage image;
+            if (!Decode(MakePng(spec), image) || image.pixels != ExpectedPng(spec)) {
+                TestRegistry::Fail(__FILE__, __LINE__, "wrong interlaced decode at size " + std::to_string(size));
+            }
+        }
+    }
+}
+
+TEST_CASE(IconDecoder, IcoDecodesOnlyTheBestEntry) {
+    std::mt19937 random(9);
+    DibSpec small = RandomDib(random, 16, 16, 8);
+    DibSpec medium = RandomDib(random, 32, 32, 32);
+    PngSpec large = RandomPng(random, 48, 48, 6, 8);
+    
+    // A garbage entry that would fail to decode if it were ever picked
+    std::vector<uint8_t> garbage(200, 0xEE);
+    std::vector<uint8_t> file = MakeIco({{16, 16, 8, MakeDib(small)}, {24, 24, 32, garbage},
+                                         {32, 32, 32, MakeDib(medium)}, {48, 48, 32, MakePng(large)}});
+    
+    DecodedImage image;
+    REQUIRE(IconDecoder::DecodeIco(file.data(), file.size(), 32, image));
+    CHECK(image.pixels == ExpectedDib(medium));
+    REQUIRE(IconDecoder::DecodeIco(file.data(), file.size(), 40, image));
+    CHECK(image.pixels == ExpectedPng(large));
+    REQUIRE(IconDecoder::DecodeIco(file.data(), file.size(), 256, image));
+    CHECK(image.pixels == ExpectedPng(large));
+    REQUIRE(IconDecoder::DecodeIco(file.data(), file.size(), 8, image));
+    CHECK(image.pixels == ExpectedDib(small));
+    CHECK(!IconDecoder::DecodeIco(file.data(), file.size(), 24, image));
+}
+
+TEST_CASE(IconDecoder, RejectsMalformed) {
+    std::mt19937 random(10);
+    DibSpec dib = RandomDib(random, 8, 8, 32);
+    PngSpec png = RandomPng(random, 8, 8, 6, 8);
+    std::vector<uint8_t> ico = MakeIco({{8, 8, 32, MakeDib(dib)}});
+    DecodedImage image;
+    
+    // Directory
+    CHECK(!IconDecoder::DecodeIco(nullptr, 0, 32, image));
+    std::vector<uint8_t> cursor = ico;
+    cursor[2] = 2;
+    CHECK(!IconDecoder::DecodeIco(cursor.data(), cursor.size(), 32, image));
+    std::vector<uint8_t> empty = ico;
+    empty[4] = 0;
+    CHECK(!IconDecoder::DecodeIco(empty.data(), empty.size(), 32, image));
+    std::vector<uint8_t> pastEnd = ico;
+    pastEnd[6 + 15] = 0xFF;
+    CHECK(!IconDecoder::DecodeIco(pastEnd.data(), pastEnd.size(), 32, image));
+    
+    // DIB: compressed, oversized, and a palette larger than the bit depth allows
+    DibSpec compressed = dib;
+    compressed.compression = 1;
+    CHECK(!Decode(MakeDib(compressed), image));
+    DibSpec oversized = dib;
+    oversized.width = IconDecoder::MAX_IMAGE_SIZE + 1;
+    oversized.height = 1;
+    oversized.colors.assign(oversized.width, 0);
+    oversized.mask.assign(oversized.width, false);
+    CHECK(!Decode(MakeDib(oversized), image));
+    DibSpec indexed = RandomDib(random, 4, 4, 1);
+    indexed.palette.resize(3);
+    CHECK(!Decode(MakeDib(indexed), image));
+    
+    // PNG: bad filter type, missing palette, unsupported depth
+    PngSpec badFilter = png;
+    badFilter.filters = {5};
+    CHECK(!Decode(MakePng(badFilter), image));
+    PngSpec noPalette = RandomPng(random, 4, 4, 3, 8);
+    noPalette.palette.clear();
+    noPalette.transparency.clear();
+    CHECK(!Decode(MakePng(noPalette), image));
+    PngSpec badDepth = RandomPng(random, 4, 4, 2, 4);
+    CHECK(!Decode(MakePng(badDepth), image));
+}
+
+TEST_CASE(IconDecoder, TruncationNeverMisdecodes) {
+    // Any prefix either fails or (once the image data is complete) decodes to the full image
+    std::mt19937 random(11);
+    std::vector<uint8_t> dib = MakeDib(RandomDib(random, 16, 16, 24));
+    std::vector<uint8_t> png = MakePng(RandomPng(random, 32, 32, 6, 8));
+    for (const std::vector<uint8_t>* data : {&dib, &png}) {
+        DecodedImage full;
+        REQUIRE(Decode(*data, full));
+        for (size_t size = 0; size < data->size(); size++) {
+            DecodedImage image;
+            if (IconDecoder::DecodeIconImage(data->data(), size, image)) {
+                CHECK(image.pixels.size() == full.pixels.size());
+            }
+        }
+    }
+    
+    // A directory cut short never reaches past the end for its entries
+    std::vector<uint8_t> file = MakeIco({{16, 16, 24, dib}, {32, 32, 32, png}});
+    for (size_t size = 0; size < file.size(); size++) {
+        DecodedImage image;
+        CHECK(!IconDecoder::DecodeIco(file.data(), size, 32, image));
+    }
+}
+
+TEST_CASE(IconDecoder, SurvivesRandomDamage) {
+    // Damaged compressed streams from a real icon: decode may fail, but must stay in bounds
+    std::vector<uint8_t> file = ReadFile(fs::u8path(DataDir().u8string() + "/" + REFERENCE_ICONS[0].path));
+    REQUIRE(file.size() > 1000);
+    std::mt19937 random(12);
+    for (int round = 0; round < 200; round++) {
+        std::vector<uint8_t> damaged = file;
+        int flips = 1 + random() % 4;
+        for (int i = 0; i < flips; i++) {
+            damaged[22 + random() % (damaged.size() - 22)] = static_cast<uint8_t>(random());
+        }
+        DecodedImage image;
+        if (IconDecoder::DecodeIco(damaged.data(), damaged.size(), 256, image)) {
+            CHECK(image.pixels.size() == static_cast<size_t>(image.width) * image.height);
+        }
+    }
+}
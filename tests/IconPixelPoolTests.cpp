@@ -0,0 +1,251 @@
+// IconPixelPoolTests.cpp - Pooled icon buffers: handles, slab reuse, statistics and concurrent lookups
+#include "TestFramework.h"
+#include "IconPixelPool.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Slots of a 256x256 icon in one slab: 4 MB / 256 KB
+    const size_t LARGE_SLOTS = IconPixelPool::SLAB_BYTES / (256 * 256 * sizeof(uint32_t));
+    const size_t LARGE_BYTES = 256 * 256 * sizeof(uint32_t);
+    
+    void Fill(IconPixelPool& pool, IconHandle handle, uint32_t value) {
+        uint32_t* pixels = pool.GetPixels(handle);
+        for (int i = 0; i < pool.GetWidth(handle) * pool.GetHeight(handle); i++) {
+            pixels[i] = value;
+        }
+    }
+    
+    bool Holds(const IconPixelPool& pool, IconHandle handle, uint32_t value) {
+        const uint32_t* pixels = pool.GetPixels(handle);
+        if (!pixels) {
+            return false;
+        }
+        for (int i = 0; i < pool.GetWidth(handle) * pool.GetHeight(handle); i++) {
+            if (pixels[i] != value) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE(IconPixelPool, AllocateAndRelease) {
+    IconPixelPool pool;
+    IconHandle a = pool.Allocate(48, 32);
+    IconHandle b = pool.Allocate(48, 32);
+    REQUIRE(a != 0 && b != 0);
+    CHECK(a != b);
+    CHECK_EQ(pool.GetWidth(a), 48);
+    CHECK_EQ(pool.GetHeight(a), 32);
+    CHECK(pool.GetPixels(a) != pool.GetPixels(b));
+    
+    // Each buffer keeps its own contents
+    Fill(pool, a, 0xFF112233);
+    Fill(pool, b, 0x80402010);
+    CHECK(Holds(pool, a, 0xFF112233));
+    CHECK(Holds(pool, b, 0x80402010));
+    
+    pool.Release(a);
+    CHECK(pool.GetPixels(a) == nullptr);
+    CHECK_EQ(pool.GetWidth(a), 0);
+    CHECK_EQ(pool.GetHeight(a), 0);
+    CHECK(Holds(pool, b, 0x80402010));
+    CHECK_EQ(pool.GetStats().slotsInUse, 1u);
+    
+    // Releasing twice, or releasing nothing, changes nothing
+    pool.Release(a);
+    pool.Release(0);
+    CHECK_EQ(pool.GetStats().slotsInUse, 1u);
+    CHECK(pool.GetPixels(0) == nullptr);
+    
+    // Sizes the pool refuses
+    CHECK_EQ(pool.Allocate(0, 16), 0u);
+    CHECK_EQ(pool.Allocate(16, -1), 0u);
+    CHECK_EQ(pool.Allocate(16385, 1), 0u);
+}
+
+TEST_CASE(IconPixelPool, RejectsStaleHandles) {
+    IconPixelPool pool;
+    IconHandle first = pool.Allocate(64, 64);
+    uint32_t* firstPixels = pool.GetPixels(first);
+    pool.Release(first);
+    
+    // The slot is handed out again, far more times than an 8-bit generation could
+    // count, and the first handle never matches it again
+    int matched = 0;
+    int sameSlot = 0;
+    IconHandle previous = first;
+    for (int i = 0; i < 1000; i++) {
+        IconHandle handle = pool.Allocate(64, 64);
+        REQUIRE(handle != 0);
+        sameSlot += pool.GetPixels(handle) == firstPixels;
+        matched += pool.GetPixels(first) != nullptr || pool.GetPixels(previous) != nullptr || handle == previous;
+        pool.Release(handle);
+        previous = handle;
+    }
+    CHECK_EQ(matched, 0);
+    CHECK_EQ(sameSlot, 1000);
+    
+    // Made-up handles: an unknown slot, generation 0, and a slot number past the end
+    IconHandle live = pool.Allocate(64, 64);
+    CHECK(pool.GetPixels(live) != nullptr);
+    CHECK(pool.GetPixels(live & ~static_cast<IconHandle>(0xFFFFFFFF)) == nullptr);
+    CHECK(pool.GetPixels(live + (static_cast<IconHandle>(5000) << 32)) == nullptr);
+    CHECK(pool.GetPixels(~static_cast<IconHandle>(0)) == nullptr);
+    pool.Release(live + 1);
+    CHECK(pool.GetPixels(live) != nullptr);
+}
+
+TEST_CASE(IconPixelPool, ReusesAndFreesSlabs) {
+    IconPixelPool pool;
+    size_t largeSlots = LARGE_SLOTS;
+    
+    // One slab per LARGE_SLOTS icons of 256, handed out from the start of the slab
+    std::vector<IconHandle> handles;
+    for (size_t i = 0; i < largeSlots + 1; i++) {
+        handles.push_back(pool.Allocate(256, 256));
+        REQUIRE(handles.back() != 0);
+    }
+    CHECK(pool.GetPixels(handles[1]) == pool.GetPixels(handles[0]) + 256 * 256);
+    IconPixelPool::Stats stats = pool.GetStats();
+    CHECK_EQ(stats.slabCount, 2u);
+    CHECK_EQ(stats.slotsInUse, largeSlots + 1);
+    CHECK_EQ(stats.slotsFree, largeSlots - 1);
+    
+    // Other sizes get slabs of their own
+    IconHandle small = pool.Allocate(32, 32);
+    CHECK_EQ(pool.GetStats().slabCount, 3u);
+    
+    // An emptied slab that is its size's only free space is kept...
+    pool.Release(handles.back());
+    handles.pop_back();
+    CHECK_EQ(pool.GetStats().slabCount, 3u);
+    
+    // ...and one emptied while another has room is freed
+    for (IconHandle handle : handles) {
+        pool.Release(handle);
+    }
+    stats = pool.GetStats();
+    CHECK_EQ(stats.slabCount, 2u);
+    CHECK_EQ(stats.slotsInUse, 1u);
+    CHECK_EQ(stats.slotsFree, largeSlots + (IconPixelPool::SLAB_BYTES / (32 * 32 * 4)) - 1);
+    
+    // Refilling reuses the kept slab, then the freed slab's slot numbers; old handles stay stale
+    std::vector<IconHandle> refill;
+    for (size_t i = 0; i < 2 * largeSlots; i++) {
+        refill.push_back(pool.Allocate(256, 256));
+        REQUIRE(refill.back() != 0);
+        Fill(pool, refill.back(), static_cast<uint32_t>(i));
+    }
+    CHECK_EQ(pool.GetStats().slabCount, 3u);
+    int stale = 0;
+    for (IconHandle handle : handles) {
+        stale += pool.GetPixels(handle) == nullptr;
+    }
+    CHECK_EQ(stale, static_cast<int>(handles.size()));
+    int intact = 0;
+    for (size_t i = 0; i < refill.size(); i++) {
+        intact += Holds(pool, refill[i], static_cast<uint32_t>(i));
+    }
+    CHECK_EQ(intact, static_cast<int>(refill.size()));
+    CHECK(pool.GetPixels(small) != nullptr);
+}
+
+TEST_CASE(IconPixelPool, ReportsFragmentationAndPeak) {
+    IconPixelPool pool;
+    IconPixelPool::Stats empty = pool.GetStats();
+    CHECK_EQ(empty.slabCount, 0u);
+    CHECK_EQ(empty.bytesReserved, 0u);
+    CHECK_EQ(empty.fragmentation, 0.0);
+    CHECK_EQ(empty.peakSlotsInUse, 0u);
+    
+    // A full slab has no fragmentation
+    size_t largeSlots = LARGE_SLOTS;
+    size_t largeBytes = LARGE_BYTES;
+    std::vector<IconHandle> handles;
+    for (size_t i = 0; i < largeSlots; i++) {
+        handles.push_back(pool.Allocate(256, 256));
+    }
+    IconPixelPool::Stats stats = pool.GetStats();
+    size_t slabBytes = IconPixelPool::SLAB_BYTES;
+    CHECK_EQ(stats.bytesReserved, slabBytes);
+    CHECK_EQ(stats.bytesInUse, largeSlots * largeBytes);
+    CHECK_EQ(stats.fragmentation, 0.0);
+    
+    // Releasing every other icon leaves half the slab reserved but unused
+    for (size_t i = 0; i < handles.size(); i += 2) {
+        pool.Release(handles[i]);
+    }
+    stats = pool.GetStats();
+    CHECK_EQ(stats.slotsInUse, largeSlots / 2);
+    CHECK_EQ(stats.slotsFree, largeSlots / 2);
+    CHECK_EQ(stats.bytesInUse, largeSlots / 2 * largeBytes);
+    CHECK_EQ(stats.fragmentation, 0.5);
+    
+    // The peak remembers the full slab and the icons allocated on top of it
+    IconHandle extra = pool.Allocate(16, 16);
+    stats = pool.GetStats();
+    CHECK_EQ(stats.peakSlotsInUse, largeSlots);
+    CHECK_EQ(stats.peakBytesInUse, largeSlots * largeBytes);
+    for (size_t i = 0; i < largeSlots; i += 2) {
+        handles[i] = pool.Allocate(256, 256);
+    }
+    stats = pool.GetStats();
+    CHECK_EQ(stats.peakSlotsInUse, largeSlots + 1);
+    CHECK_EQ(stats.peakBytesInUse, largeSlots * largeBytes + 16 * 16 * 4);
+    
+    for (IconHandle handle : handles) {
+        pool.Release(handle);
+    }
+    pool.Release(extra);
+    stats = pool.GetStats();
+    CHECK_EQ(stats.slotsInUse, 0u);
+    CHECK_EQ(stats.bytesInUse, 0u);
+    CHECK_EQ(stats.fragmentation, 1.0);
+    CHECK_EQ(stats.peakSlotsInUse, largeSlots + 1);
+}
+
+TEST_CASE(IconPixelPool, LooksUpWhileOtherThreadsAllocate) {
+    // The render thread reads its own handles while scan threads allocate and release
+    // theirs; its icons never change or vanish
+    IconPixelPool pool;
+    std::vector<IconHandle> owned;
+    for (int i = 0; i < 64; i++) {
+        owned.push_back(pool.Allocate(96, 96));
+        Fill(pool, owned.back(), 0xFF000000u | i);
+    }
+    
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> scanners;
+    for (int t = 0; t < 3; t++) {
+        scanners.emplace_back([&pool, &stop, t]() {
+            std::vector<IconHandle> mine;
+            for (int i = 0; !stop.load(); i++) {
+                mine.push_back(pool.Allocate(96, 96));
+                if (mine.size() > 40 || i % 3 == t) {
+                    pool.Release(mine.front());
+                    mine.erase(mine.begin());
+                }
+            }
+            for (IconHandle handle : mine) {
+                pool.Release(handle);
+            }
+        });
+    }
+    
+    int wrong = 0;
+    for (int pass = 0; pass < 300; pass++) {
+        for (size_t i = 0; i < owned.size(); i++) {
+            const uint32_t* pixels = pool.GetPixels(owned[i]);
+            wrong += !pixels || pixels[pass % (96 * 96)] != (0xFF000000u | static_cast<uint32_t>(i));
+        }
+    }
+    stop = true;
+    for (std::thread& scanner : scanners) {
+        scanner.join();
+    }
+    CHECK_EQ(wrong, 0);
+    CHECK_EQ(pool.GetStats().slotsInUse, owned.size());
+}
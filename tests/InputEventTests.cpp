@@ -0,0 +1,203 @@
+// InputEventTests.cpp - Controller edge detection: baselines, button edges, stick directions and scaling
+#include "TestFramework.h"
+#include "InputEvent.h"
+#include <vector>
+
+namespace {
+    const uint16_t BUTTON_A = 0x1000;       // XINPUT_GAMEPAD_A
+    const uint16_t BUTTON_B = 0x2000;
+    const uint16_t DPAD_UP = 0x0001;
+    const uint16_t START = 0x0010;
+    
+    GamepadState Connected(uint16_t buttons = 0) {
+        GamepadState state;
+        state.connected = true;
+        state.buttons = buttons;
+        return state;
+    }
+    
+    std::vector<InputEvent> Poll(GamepadEdgeDetector& detector, const GamepadState& state, int64_t time = 0) {
+        InputEvent events[GamepadEdgeDetector::MAX_EVENTS];
+        int count = detector.Update(state, time, events);
+        return std::vector<InputEvent>(events, events + count);
+    }
+    
+    bool IsEvent(const InputEvent& event, InputEventType type, uint16_t button, int dx, int dy) {
+        return event.type == type && event.button == button && event.dx == dx && event.dy == dy;
+    }
+}
+
+TEST_CASE(InputEvent, ConnectSetsTheBaseline) {
+    // Buttons and sticks already held when the controller connects report nothing
+    GamepadEdgeDetector detector;
+    GamepadState held = Connected(BUTTON_A | START);
+    held.leftX = 30000;
+    held.rightY = -20000;
+    CHECK(Poll(detector, held).empty());
+    CHECK(Poll(detector, held).empty());
+    
+    // Letting go of them afterwards does report
+    std::vector<InputEvent> events = Poll(detector, Connected());
+    REQUIRE(events.size() == 3);
+    CHECK(IsEvent(events[0], InputEventType::ButtonUp, START, 0, 0));
+    CHECK(IsEvent(events[1], InputEventType::ButtonUp, BUTTON_A, 0, 0));
+    CHECK(IsEvent(events[2], InputEventType::Scroll, 0, 0, 0));
+    
+    // After Reset, which forgets the controller was there, the next reading is a baseline too
+    detector.Reset();
+    CHECK(Poll(detector, Connected(BUTTON_B)).empty());
+    
+    // Readings of a disconnected controller produce nothing
+    GamepadEdgeDetector idle;
+    GamepadState disconnected;
+    disconnected.buttons = BUTTON_A;
+    CHECK(Poll(idle, disconnected).empty());
+}
+
+TEST_CASE(InputEvent, ButtonsReportEachEdgeOnce) {
+    GamepadEdgeDetector detector;
+    Poll(detector, Connected());
+    
+    std::vector<InputEvent> down = Poll(detector, Connected(BUTTON_A), 1000);
+    REQUIRE(down.size() == 1);
+    CHECK(IsEvent(down[0], InputEventType::ButtonDown, BUTTON_A, 0, 0));
+    CHECK_EQ(down[0].time, 1000);
+    
+    // Holding repeats nothing
+    for (int i = 0; i < 10; i++) {
+        CHECK(Poll(detector, Connected(BUTTON_A)).empty());
+    }
+    
+    // One press and one release in the same poll, in bit order
+    std::vector<InputEvent> swap = Poll(detector, Connected(BUTTON_B | DPAD_UP), 2000);
+    REQUIRE(swap.size() == 3);
+    CHECK(IsEvent(swap[0], InputEventType::ButtonDown, DPAD_UP, 0, 0));
+    CHECK(IsEvent(swap[1], InputEventType::ButtonUp, BUTTON_A, 0, 0));
+    CHECK(IsEvent(swap[2], InputEventType::ButtonDown, BUTTON_B, 0, 0));
+    
+    std::vector<InputEvent> up = Poll(detector, Connected(), 3000);
+    REQUIRE(up.size() == 2);
+    CHECK(up[0].type == InputEventType::ButtonUp && up[1].type == InputEventType::ButtonUp);
+    CHECK(Poll(detector, Connected()).empty());
+    
+    // Every button at once fits in MAX_EVENTS alongside both sticks
+    GamepadState everything = Connected(0xFFFF);
+    everything.leftY = 32767;
+    everything.rightY = 32767;
+    CHECK_EQ(static_cast<int>(Poll(detector, everything).size()), 18);
+}
+
+TEST_CASE(InputEvent, StickPicksTheDominantAxis) {
+    GamepadEdgeDetector detector;
+    Poll(detector, Connected());
+    
+    // Right, then held: one event
+    GamepadState state = Connected();
+    state.leftX = 20000;
+    std::vector<InputEvent> events = Poll(detector, state);
+    REQUIRE(events.size() == 1);
+    CHECK(IsEvent(events[0], InputEventType::StickDirection, 0, 1, 0));
+    CHECK(Poll(detector, state).empty());
+    
+    // A diagonal goes the way of its stronger axis; up on the stick is up on screen
+    state.leftX = 12000;
+    state.leftY = 25000;
+    events = Poll(detector, state);
+    REQUIRE(events.size() == 1);
+    CHECK(IsEvent(events[0], InputEventType::StickDirection, 0, 0, -1));
+    
+    // Easing off the stronger axis hands over to the other one only if it changed
+    // direction; X is still right, as it was, so nothing
+    state.leftY = 5000;
+    CHECK(Poll(detector, state).empty());
+    
+    // Swinging down-left: Y dominates and it went from up to down
+    state.leftX = -15000;
+    state.leftY = -30000;
+    events = Poll(detector, state);
+    REQUIRE(events.size() == 1);
+    CHECK(IsEvent(events[0], InputEventType::StickDirection, 0, 0, 1));
+    
+    // Back to center, then a push inside the deadzone: nothing
+    CHECK(Poll(detector, Connected()).empty());
+    state = Connected();
+    state.leftX = -GamepadEdgeDetector::STICK_DEADZONE;
+    CHECK(Poll(detector, state).empty());
+    state.leftX = -GamepadEdgeDetector::STICK_DEADZONE - 1;
+    events = Poll(detector, state);
+    REQUIRE(events.size() == 1);
+    CHECK(IsEvent(events[0], InputEventType::StickDirection, 0, -1, 0));
+    
+    // The right stick reports its deflection whenever it changes
+    state = Connected();
+    state.rightY = 32767;
+    events = Poll(detector, state);
+    REQUIRE(events.size() == 1);
+    CHECK(IsEvent(events[0], InputEventType::Scroll, 0, 0, -127));
+    CHECK(Poll(detector, state).empty());
+    events = Poll(detector, Connected());
+    REQUIRE(events.size() == 1);
+    CHECK(IsEvent(events[0], InputEventType::Scroll, 0, 0, 0));
+}
+
+TEST_CASE(InputEvent, ScaleStickCutsTheDeadzoneAndClamps) {
+    const int deadzone = GamepadEdgeDetector::STICK_DEADZONE;
+    const int range = GamepadEdgeDetector::STICK_RANGE;
+    CHECK_EQ(GamepadEdgeDetector::ScaleStick(0), 0);
+    CHECK_EQ(GamepadEdgeDetector::ScaleStick(deadzone), 0);
+    CHECK_EQ(GamepadEdgeDetector::ScaleStick(-deadzone), 0);
+    
+    // Just past the deadzone it starts near 0, not at the deadzone's share of the range,
+    // and halfway out of it is half the range
+    CHECK_EQ(GamepadEdgeDetector::ScaleStick(deadzone + 1), 0);
+    CHECK_EQ(GamepadEdgeDetector::ScaleStick(deadzone + 300), 1);
+    CHECK_EQ(GamepadEdgeDetector::ScaleStick(-deadzone - 300), -1);
+    CHECK_EQ(GamepadEdgeDetector::ScaleStick(deadzone + (32767 - deadzone) / 2), range / 2);
+    
+    // Full deflection is the full range either way; -32768 does not overshoot it
+    CHECK_EQ(GamepadEdgeDetector::ScaleStick(32767), range);
+    CHECK_EQ(GamepadEdgeDetector::ScaleStick(-32767), -range);
+    CHECK_EQ(GamepadEdgeDetector::ScaleStick(-32768), -range);
+    
+    // Monotonic and odd over the whole axis
+    int previous = GamepadEdgeDetector::ScaleStick(-32768);
+    int decreasing = 0;
+    int asymmetric = 0;
+    for (int value = -32767; value <= 32767; value++) {
+        int scaled = GamepadEdgeDetector::ScaleStick(value);
+        decreasing += scaled < previous;
+        asymmetric += scaled != -GamepadEdgeDetector::ScaleStick(-value);
+        previous = scaled;
+    }
+    CHECK_EQ(decreasing, 0);
+    CHECK_EQ(asymmetric, 0);
+    
+    CHECK_EQ(GamepadEdgeDetector::NormalizeStick(deadzone), 0);
+    CHECK_EQ(GamepadEdgeDetector::NormalizeStick(deadzone + 1), 1);
+    CHECK_EQ(GamepadEdgeDetector::NormalizeStick(-deadzone - 1), -1);
+}
+
+TEST_CASE(InputEvent, DisconnectReleasesHeldButtons) {
+    GamepadEdgeDetector detector;
+    Poll(detector, Connected());
+    GamepadState held = Connected(BUTTON_A | DPAD_UP);
+    held.rightY = -32767;
+    REQUIRE(Poll(detector, held).size() == 3);
+    
+    // Pulling the controller lets go of everything it held, once
+    GamepadState gone;
+    gone.buttons = BUTTON_A;            // Stale bits of a disconnected reading are ignored
+    std::vector<InputEvent> events = Poll(detector, gone, 5000);
+    REQUIRE(events.size() == 3);
+    CHECK(IsEvent(events[0], InputEventType::ButtonUp, DPAD_UP, 0, 0));
+    CHECK(IsEvent(events[1], InputEventType::ButtonUp, BUTTON_A, 0, 0));
+    CHECK(IsEvent(events[2], InputEventType::Scroll, 0, 0, 0));
+    CHECK_EQ(events[0].time, 5000);
+    CHECK(Poll(detector, gone).empty());
+    
+    // Reconnecting with the button still down is a new baseline, not a press
+    CHECK(Poll(detector, Connected(BUTTON_A)).empty());
+    events = Poll(detector, Connected());
+    REQUIRE(events.size() == 1);
+    CHECK(IsEvent(events[0], InputEventType::ButtonUp, BUTTON_A, 0, 0));
+}
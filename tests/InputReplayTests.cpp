@@ -0,0 +1,288 @@
+// InputReplayTests.cpp - Recorded input sessions: encoding, faithful replay and replay frames
+//
+// tests/data/input_session.rec is a ten minute session recorded by the code below. It
+// pins the file format: a change that can no longer read it, or reads it differently,
+// breaks these tests. After an intended format change, run the suite with
+// LAUNCHER_UPDATE_GOLDEN=1 set to record it again.
+#include "TestFramework.h"
+#include "FrameBenchmark.h"
+#include "FrameComposer.h"
+#include "InputReplay.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace fs = std::filesystem;
+
+namespace {
+    const int TAB_ITEM_COUNTS[] = {40, 250, 7, 0, 1200};
+    
+    // Records actions the way WindowManager::ApplyAction does: each one is applied to
+    // the navigation state through the grid the composer lays out at the current
+    // client size, then logged with the state it led to
+    struct SessionRecorder {
+        InputLog log;
+        NavigationState state;
+        RECT clientRect;
+        std::vector<NavigationState> states;
+        
+        SessionRecorder(int width, int height)
+            : clientRect{0, 0, width, height}
+        {
+            InputLogHeader header;
+            header.clientWidth = width;
+            header.clientHeight = height;
+            GridLayout layout = GetLayout();
+            header.gridArea = layout.GetArea();
+            header.metrics = layout.GetMetrics();
+            header.tabItemCounts.assign(std::begin(TAB_ITEM_COUNTS), std::end(TAB_ITEM_COUNTS));
+            header.start = state;
+            log.Begin(header);
+        }
+        
+        int GetItemCount(int tabIndex) const {
+            bool validTab = tabIndex >= 0 && tabIndex < static_cast<int>(std::size(TAB_ITEM_COUNTS));
+            return validTab ? TAB_ITEM_COUNTS[tabIndex] : 0;
+        }
+        
+        GridLayout GetLayout() const {
+            return FrameComposer::GetGridLayout(clientRect, GetItemCount(state.activeTabIndex));
+        }
+        
+        void Apply(const InputAction& action) {
+            switch (action.type) {
+                case InputActionType::Navigate:
+                    GridNavigator::Navigate(state, GetLayout(), action.x, action.y);
+                    break;
+                case InputActionType::Scroll:
+                    GridNavigator::ScrollBy(state, GetLayout(), action.x);
+                    break;
+                case InputActionType::SelectTab:
+                    GridNavigator::SelectTab(state, action.x, static_cast<int>(std::size(TAB_ITEM_COUNTS)),
+                                             GetItemCount(action.x));
+                    break;
+                case InputActionType::Select:
+                    GridNavigator::Select(state, GetLayout(), action.x, action.y != 0);
+                    break;
+                case InputActionType::Resize:
+                    clientRect = {0, 0, action.x, action.y};
+                    GridNavigator::ResetView(state);
+                    break;
+                default:
+                    break;
+            }
+            log.Add(action, state);
+            states.push_back(state);
+        }
+    };
+    
+    // A session of mostly D-pad moves and wheel notches, with clicks, tab switches, the
+    // odd launch and resize, and a few actions out of range; one every 50..450 ms
+    void RecordSession(SessionRecorder& recorder, int actionCount, uint32_t seed) {
+        std::mt19937 random(seed);
+        int64_t time = 0;
+        for (int i = 0; i < actionCount; i++) {
+            time += 50000 + random() % 400000;
+            InputAction action;
+            action.time = time;
+            int kind = random() % 100;
+            if (kind < 50) {
+                const int moves[][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {0, 0}, {1, 1}};
+                int move = random() % 6;
+                action.type = InputActionType::Navigate;
+                action.x = moves[move][0];
+                action.y = moves[move][1];
+            } else if (kind < 75) {
+                action.type = InputActionType::Scroll;
+                action.x = (static_cast<int>(random() % 13) - 6) * 48;
+            } else if (kind < 87) {
+                action.type = InputActionType::Select;
+                action.x = static_cast<int>(random() % 60) - 5;
+                action.y = random() % 2;
+            } else if (kind < 95) {
+                action.type = InputActionType::SelectTab;
+                action.x = static_cast<int>(random() % (std::size(TAB_ITEM_COUNTS) + 1));
+            } else if (kind < 97) {
+                action.type = InputActionType::Launch;
+            } else {
+                const int sizes[][2] = {{960, 540}, {1280, 720}, {800, 600}, {1100, 500}};
+                int size = random() % 4;
+                action.type = InputActionType::Resize;
+                action.x = sizes[size][0];
+                action.y = sizes[size][1];
+            }
+            recorder.Apply(action);
+        }
+    }
+    
+    bool SameHeader(const InputLogHeader& a, const InputLogHeader& b) {
+        return a.clientWidth == b.clientWidth && a.clientHeight == b.clientHeight && a.dpiPercent == b.dpiPercent &&
+               a.gridArea.left == b.gridArea.left && a.gridArea.top == b.gridArea.top &&
+               a.gridArea.right == b.gridArea.right && a.gridArea.bottom == b.gridArea.bottom &&
+               a.metrics.iconSize == b.metrics.iconSize && a.metrics.labelHeight == b.metrics.labelHeight &&
+               a.metrics.borderExtension == b.metrics.borderExtension && a.tabItemCounts == b.tabItemCounts &&
+               a.start == b.start;
+    }
+    
+    fs::path GetFixturePath() {
+        return fs::path(TestRegistry::GetSourceDir()) / "tests" / "data" / "input_session.rec";
+    }
+    
+    std::vector<uint8_t> ReadFile(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+    
+    bool WriteFile(const fs::path& path, const std::vector<uint8_t>& data) {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        return file.good();
+    }
+    
+    // The "frames" hash at the end of a replay report
+    std::wstring GetFramesHash(const std::wstring& report) {
+        size_t position = report.find(L"frames ");
+        return position == std::wstring::npos ? std::wstring() : report.substr(position + 7, 16);
+    }
+}
+
+TEST_CASE(InputReplay, EncodeDecodeRoundTrip) {
+    SessionRecorder recorder(960, 540);
+    RecordSession(recorder, 500, 1);
+    std::vector<uint8_t> data = recorder.log.Encode();
+    
+    InputLog decoded;
+    REQUIRE(decoded.Decode(data.data(), data.size()));
+    CHECK(SameHeader(decoded.GetHeader(), recorder.log.GetHeader()));
+    CHECK_EQ(decoded.GetStateHash(), recorder.log.GetStateHash());
+    CHECK_EQ(decoded.GetDuration(), recorder.log.GetDuration());
+    REQUIRE(decoded.GetActions().size() == recorder.log.GetActions().size());
+    int differences = 0;
+    for (size_t i = 0; i < decoded.GetActions().size(); i++) {
+        const InputAction& a = decoded.GetActions()[i];
+        const InputAction& b = recorder.log.GetActions()[i];
+        differences += a.type != b.type || a.x != b.x || a.y != b.y || a.time != b.time;
+    }
+    CHECK_EQ(differences, 0);
+    CHECK(decoded.Encode() == data);
+    
+    // Compact: a few bytes per action
+    CHECK(data.size() < 500 * 8);
+}
+
+TEST_CASE(InputReplay, RejectsDamagedLogs) {
+    SessionRecorder recorder(960, 540);
+    RecordSession(recorder, 40, 2);
+    std::vector<uint8_t> data = recorder.log.Encode();
+    
+    // Every truncation and every single flipped bit is refused and leaves the log empty
+    InputLog decoded;
+    int accepted = 0;
+    for (size_t size = 0; size < data.size(); size++) {
+        accepted += decoded.Decode(data.data(), size);
+        CHECK(decoded.GetActions().empty());
+    }
+    for (size_t i = 0; i < data.size(); i++) {
+        for (int bit = 0; bit < 8; bit++) {
+            std::vector<uint8_t> damaged = data;
+            damaged[i] ^= static_cast<uint8_t>(1 << bit);
+            accepted += decoded.Decode(damaged.data(), damaged.size());
+        }
+    }
+    CHECK_EQ(accepted, 0);
+    CHECK(!decoded.Decode(nullptr, 0));
+}
+
+TEST_CASE(InputReplay, TakesTheRecordedSteps) {
+    SessionRecorder recorder(960, 540);
+    RecordSession(recorder, 3000, 3);
+    
+    // Step by step the same states as the recording, twice over
+    InputReplay replay(recorder.log);
+    for (int pass = 0; pass < 2; pass++) {
+        int differences = 0;
+        int launches = 0;
+        size_t step = 0;
+        while (!replay.IsFinished()) {
+            const InputAction& action = replay.Step();
+            launches += action.type == InputActionType::Launch;
+            differences += replay.GetState() != recorder.states[step++];
+        }
+        CHECK_EQ(differences, 0);
+        CHECK_EQ(step, recorder.states.size());
+        CHECK_EQ(replay.GetLaunchCount(), launches);
+        CHECK(replay.IsFaithful());
+        
+        // The grid it laid out last is the one the composer lays out at that size
+        RECT clientRect = {0, 0, replay.GetClientWidth(), replay.GetClientHeight()};
+        PixelRect expected = FrameComposer::GetGridLayout(clientRect, 0).GetArea();
+        PixelRect area = replay.GetGridArea();
+        CHECK(area.left == expected.left && area.top == expected.top && area.right == expected.right &&
+              area.bottom == expected.bottom);
+        replay.Restart();
+        CHECK_EQ(replay.GetPosition(), 0u);
+    }
+}
+
+TEST_CASE(InputReplay, NoticesADifferentGrid) {
+    SessionRecorder recorder(960, 540);
+    RecordSession(recorder, 300, 4);
+    
+    // The same actions and recorded states, but a header claiming larger icons: the
+    // replay steps through another grid and must say so
+    InputLogHeader header = recorder.log.GetHeader();
+    header.metrics.iconSize += 40;
+    InputLog log;
+    log.Begin(header);
+    for (size_t i = 0; i < recorder.states.size(); i++) {
+        log.Add(recorder.log.GetActions()[i], recorder.states[i]);
+    }
+    InputReplay replay(log);
+    while (!replay.IsFinished()) {
+        replay.Step();
+    }
+    CHECK(!replay.IsFaithful());
+    
+    // Unfinished replays are never faithful
+    InputReplay partial(recorder.log);
+    partial.Step();
+    CHECK(!partial.IsFaithful());
+}
+
+TEST_CASE(InputReplay, ReadsTheRecordedFixture) {
+    SessionRecorder recorder(960, 540);
+    RecordSession(recorder, 2400, 24);
+    if (std::getenv("LAUNCHER_UPDATE_GOLDEN")) {
+        REQUIRE(WriteFile(GetFixturePath(), recorder.log.Encode()));
+    }
+    
+    std::vector<uint8_t> data = ReadFile(GetFixturePath());
+    InputLog log;
+    REQUIRE(log.Decode(data.data(), data.size()));
+    CHECK(log.Encode() == data);
+    CHECK(log.GetDuration() > 9 * 60 * 1000000LL);
+    
+    InputReplay replay(log);
+    while (!replay.IsFinished()) {
+        replay.Step();
+    }
+    CHECK(replay.IsFaithful());
+}
+
+TEST_CASE(InputReplay, DrawsTheSameFramesEveryRun) {
+    // The fixture through the headless renderer: the incremental frames match full
+    // repaints, the states match the recording, and with or without the content layer
+    // every frame hashes the same
+    FrameBenchmarkOptions options;
+    options.replayPath = GetFixturePath().wstring();
+    std::wstring first = FrameBenchmark::Run(options);
+    CHECK(first.find(L" exact") != std::wstring::npos);
+    CHECK(first.find(L"states match") != std::wstring::npos);
+    REQUIRE(GetFramesHash(first).size() == 16);
+    
+    options.contentLayer = false;
+    std::wstring second = FrameBenchmark::Run(options);
+    CHECK(GetFramesHash(second) == GetFramesHash(first));
+}
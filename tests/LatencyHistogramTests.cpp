@@ -0,0 +1,175 @@
+// LatencyHistogramTests.cpp - Bucket layout, percentiles against sorted samples and concurrent recording
+#include "TestFramework.h"
+#include "LatencyHistogram.h"
+#include "InputLatency.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Latencies spread over six decades, as a mix of fast frames and stalls gives
+    std::vector<int64_t> MakeSamples(std::mt19937& random, int count) {
+        std::uniform_real_distribution<double> exponent(0.0, 6.5);
+        std::vector<int64_t> samples(count);
+        for (int64_t& sample : samples) {
+            sample = static_cast<int64_t>(std::pow(10.0, exponent(random)));
+        }
+        return samples;
+    }
+    
+    // The sample share of the sorted samples are at or below
+    int64_t ExactPercentile(const std::vector<int64_t>& sorted, double share) {
+        size_t rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(share * sorted.size())));
+        return sorted[rank - 1];
+    }
+}
+
+TEST_CASE(LatencyHistogram, BucketsTileTheRange) {
+    // Every bucket starts right after the previous one ends, up to MAX_VALUE
+    CHECK_EQ(LatencyHistogram::GetBucket(0), 0);
+    for (int bucket = 0; bucket < LatencyHistogram::BUCKET_COUNT; bucket++) {
+        int64_t top = LatencyHistogram::GetBucketTop(bucket);
+        CHECK_EQ(LatencyHistogram::GetBucket(top), bucket);
+        if (bucket + 1 < LatencyHistogram::BUCKET_COUNT) {
+            CHECK_EQ(LatencyHistogram::GetBucket(top + 1), bucket + 1);
+        }
+    }
+    int64_t maxValue = LatencyHistogram::MAX_VALUE;
+    CHECK_EQ(LatencyHistogram::GetBucketTop(LatencyHistogram::BUCKET_COUNT - 1), maxValue);
+    CHECK_EQ(LatencyHistogram::GetBucket(LatencyHistogram::MAX_VALUE + 1000), LatencyHistogram::BUCKET_COUNT - 1);
+    CHECK_EQ(LatencyHistogram::GetBucket(-5), 0);
+}
+
+TEST_CASE(LatencyHistogram, BucketWidthIsBounded) {
+    // Exact below 64; above, no value is more than 1/32 below its bucket top
+    for (int64_t value = 0; value < 2 * LatencyHistogram::SUB_BUCKETS; value++) {
+        CHECK_EQ(LatencyHistogram::GetBucketTop(LatencyHistogram::GetBucket(value)), value);
+    }
+    std::mt19937_64 random(31);
+    int wide = 0;
+    for (int i = 0; i < 200000; i++) {
+        int64_t value = static_cast<int64_t>(random() % (LatencyHistogram::MAX_VALUE + 1));
+        value >>= random() % 36;
+        int64_t top = LatencyHistogram::GetBucketTop(LatencyHistogram::GetBucket(value));
+        wide += top < value || top - value > value / LatencyHistogram::SUB_BUCKETS;
+    }
+    CHECK_EQ(wide, 0);
+}
+
+TEST_CASE(LatencyHistogram, PercentilesMatchSortedSamples) {
+    std::mt19937 random(37);
+    const double shares[] = {0.0, 0.01, 0.25, 0.5, 0.9, 0.95, 0.99, 0.999, 1.0};
+    for (int round = 0; round < 50; round++) {
+        std::vector<int64_t> samples = MakeSamples(random, 1 + random() % 5000);
+        LatencyHistogram histogram;
+        int64_t sum = 0;
+        for (int64_t sample : samples) {
+            histogram.Record(sample);
+            sum += sample;
+        }
+        std::sort(samples.begin(), samples.end());
+        CHECK_EQ(histogram.GetCount(), samples.size());
+        CHECK_EQ(histogram.GetMax(), samples.back());
+        CHECK(std::abs(histogram.GetMean() - static_cast<double>(sum) / samples.size()) < 1e-6 * histogram.GetMean() + 1e-9);
+        
+        // Never below the true percentile, at most a bucket above it, never past the max
+        int64_t previous = 0;
+        for (double share : shares) {
+            int64_t exact = ExactPercentile(samples, share);
+            int64_t reported = histogram.GetPercentile(share);
+            CHECK(reported >= exact);
+            CHECK(reported - exact <= exact / LatencyHistogram::SUB_BUCKETS);
+            CHECK(reported <= samples.back());
+            CHECK(reported >= previous);
+            previous = reported;
+        }
+        CHECK_EQ(histogram.GetPercentile(1.0), samples.back());
+    }
+}
+
+TEST_CASE(LatencyHistogram, EdgeValues) {
+    int64_t maxValue = LatencyHistogram::MAX_VALUE;
+    LatencyHistogram histogram;
+    CHECK_EQ(histogram.GetCount(), 0u);
+    CHECK_EQ(histogram.GetPercentile(0.5), 0);
+    CHECK_EQ(histogram.GetMean(), 0.0);
+    
+    // Negative counts as 0, past the range as MAX_VALUE
+    histogram.Record(-100);
+    histogram.Record(maxValue * 4);
+    CHECK_EQ(histogram.GetCount(), 2u);
+    CHECK_EQ(histogram.GetPercentile(0.5), 0);
+    CHECK_EQ(histogram.GetPercentile(1.0), maxValue);
+    CHECK_EQ(histogram.GetMax(), maxValue);
+    
+    // Shares outside 0..1 are clamped
+    CHECK_EQ(histogram.GetPercentile(-1.0), 0);
+    CHECK_EQ(histogram.GetPercentile(7.0), maxValue);
+    
+    histogram.Reset();
+    CHECK_EQ(histogram.GetCount(), 0u);
+    CHECK_EQ(histogram.GetMax(), 0);
+    CHECK_EQ(histogram.GetPercentile(1.0), 0);
+    
+    // One sample is every percentile
+    histogram.Record(12345);
+    CHECK_EQ(histogram.GetPercentile(0.0), 12345);
+    CHECK_EQ(histogram.GetPercentile(0.5), 12345);
+    CHECK_EQ(histogram.GetMean(), 12345.0);
+}
+
+TEST_CASE(LatencyHistogram, ConcurrentRecording) {
+    // Several threads record at once while this one reads; no sample is lost
+    const int THREADS = 4;
+    const int PER_THREAD = 100000;
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&histogram, t]() {
+            for (int i = 0; i < PER_THREAD; i++) {
+                histogram.Record(t * 1000 + i % 1000);
+            }
+        });
+    }
+    int64_t reads = 0;
+    for (int i = 0; i < 100; i++) {
+        reads += histogram.GetPercentile(0.99);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    CHECK(reads >= 0);
+    
+    CHECK_EQ(histogram.GetCount(), static_cast<uint64_t>(THREADS) * PER_THREAD);
+    CHECK_EQ(histogram.GetMax(), (THREADS - 1) * 1000 + 999);
+    double expectedMean = 0;
+    for (int t = 0; t < THREADS; t++) {
+        expectedMean += t * 1000 + 499.5;
+    }
+    expectedMean /= THREADS;
+    CHECK(std::abs(histogram.GetMean() - expectedMean) < 1e-6);
+}
+
+TEST_CASE(LatencyHistogram, InputLatencyReport) {
+    InputLatency latency;
+    CHECK(latency.GetReport().find(L"No samples") != std::wstring::npos);
+    
+    latency.Record(InputLatencyType::MouseWheel, 8000);
+    latency.Record(InputLatencyType::MouseWheel, 16000);
+    latency.Record(InputLatencyType::Key, 3000);
+    CHECK_EQ(latency.GetTotalCount(), 3u);
+    CHECK_EQ(latency.GetHistogram(InputLatencyType::MouseWheel).GetCount(), 2u);
+    CHECK_EQ(latency.GetHistogram(InputLatencyType::MouseWheel).GetMax(), 16000);
+    
+    // Only types with samples get a line
+    std::wstring report = latency.GetReport();
+    CHECK(report.find(L"mouse-wheel") != std::wstring::npos);
+    CHECK(report.find(L"key") != std::wstring::npos);
+    CHECK(report.find(L"controller") == std::wstring::npos);
+    CHECK(report.find(L"No samples") == std::wstring::npos);
+    
+    latency.Reset();
+    CHECK_EQ(latency.GetTotalCount(), 0u);
+}
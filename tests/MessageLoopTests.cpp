@@ -0,0 +1,143 @@
+// MessageLoopTests.cpp - Tick timing and wakeups of the message loop on the real clock
+//
+// Timing on a shared machine is noisy, and how late a stalled test runner wakes up
+// has no bound, so these only check that the loop ticks and doesn't spin. The tick
+// schedule itself is tested on a fake clock in TickSchedulerTests.
+#include "TestFramework.h"
+#include "MessageLoop.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Run the loop with ticks on for microseconds; the lateness of every tick and the
+    // number of wakeups go to the arguments
+    void RunTicking(MessageLoop& loop, int64_t microseconds, std::vector<int64_t>& lateness, int& wakeups) {
+        int exitCode = 0;
+        int64_t start = MessageLoop::GetMicroseconds();
+        while (MessageLoop::GetMicroseconds() - start < microseconds) {
+            auto onTick = [&]() { lateness.push_back(loop.GetScheduler().GetLastLateness()); };
+            REQUIRE(loop.RunOnce(true, onTick, exitCode));
+            wakeups++;
+        }
+    }
+}
+
+TEST_CASE(MessageLoop, ClockIsMonotonic) {
+    int64_t previous = MessageLoop::GetMicroseconds();
+    for (int i = 0; i < 100000; i++) {
+        int64_t now = MessageLoop::GetMicroseconds();
+        CHECK(now >= previous);
+        previous = now;
+    }
+    
+    // Microseconds, not some other unit
+    int64_t before = MessageLoop::GetMicroseconds();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    int64_t elapsed = MessageLoop::GetMicroseconds() - before;
+    CHECK(elapsed >= 50000);
+    CHECK(elapsed < 50000 + 500000);
+}
+
+TEST_CASE(MessageLoop, TicksAtTheRate) {
+    MessageLoop loop;
+    loop.SetTickRate(200);
+    std::vector<int64_t> lateness;
+    int wakeups = 0;
+    int64_t start = MessageLoop::GetMicroseconds();
+    RunTicking(loop, 500000, lateness, wakeups);
+    int64_t elapsed = MessageLoop::GetMicroseconds() - start;
+    
+    // Ticks ran, never ahead of their deadlines, and never more of them than the time allowed
+    int ticks = static_cast<int>(lateness.size());
+    REQUIRE(ticks > 0);
+    CHECK(ticks <= elapsed * 200 / 1000000 + 1);
+    CHECK(*std::min_element(lateness.begin(), lateness.end()) >= 0);
+}
+
+TEST_CASE(MessageLoop, WakesOncePerTick) {
+    // The timer wakes the loop for each tick and nothing else does; a loop that
+    // polled or spun would wake far more often than it ticks
+    MessageLoop loop;
+    loop.SetTickRate(100);
+    std::vector<int64_t> lateness;
+    int wakeups = 0;
+    RunTicking(loop, 1200000, lateness, wakeups);
+    
+    CHECK(!lateness.empty());
+    CHECK(wakeups <= static_cast<int>(lateness.size()) * 2 + 2);
+    double perSecond = loop.GetScheduler().GetWakeupsPerSecond();
+    CHECK(perSecond > 0);
+    CHECK(perSecond < 200);
+}
+
+#ifndef _WIN32
+TEST_CASE(MessageLoop, PostedTasksRunInOrder) {
+    MessageLoop loop;
+    std::vector<int> order;
+    std::thread poster([&]() {
+        for (int i = 0; i < 100; i++) {
+            loop.Post([&order, i]() { order.push_back(i); });
+        }
+        loop.Quit(7);
+    });
+    
+    // Without ticks only the posts wake the loop
+    int exitCode = 0;
+    int wakeups = 0;
+    while (loop.RunOnce(false, []() {}, exitCode)) {
+        wakeups++;
+    }
+    poster.join();
+    
+    CHECK_EQ(exitCode, 7);
+    REQUIRE(order.size() == 100u);
+    for (int i = 0; i < 100; i++) {
+        CHECK_EQ(order[i], i);
+    }
+    CHECK(wakeups <= 100);
+}
+
+TEST_CASE(MessageLoop, IdleLoopSleepsUntilPosted) {
+    MessageLoop loop;
+    loop.SetTickRate(500);
+    std::vector<int64_t> lateness;
+    int wakeups = 0;
+    RunTicking(loop, 50000, lateness, wakeups);
+    
+    // Ticks off: the cancelled timer must not wake the loop again, only the post does
+    std::thread poster([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        loop.Post([]() {});
+    });
+    int exitCode = 0;
+    int ticks = 0;
+    int64_t start = MessageLoop::GetMicroseconds();
+    CHECK(loop.RunOnce(false, [&]() { ticks++; }, exitCode));
+    int64_t slept = MessageLoop::GetMicroseconds() - start;
+    poster.join();
+    
+    CHECK(slept >= 150000);
+    CHECK_EQ(ticks, 0);
+}
+
+TEST_CASE(MessageLoop, QuitEndsRun) {
+    MessageLoop loop;
+    loop.SetTickRate(120);
+    int ticks = 0;
+    int64_t start = MessageLoop::GetMicroseconds();
+    std::thread quitter([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        loop.Quit(3);
+    });
+    int exitCode = loop.Run([]() { return true; }, [&]() { ticks++; });
+    int64_t elapsed = MessageLoop::GetMicroseconds() - start;
+    quitter.join();
+    
+    // Ticks ran until the quit, at no more than the rate
+    CHECK_EQ(exitCode, 3);
+    CHECK(ticks > 0);
+    CHECK(ticks <= elapsed * 120 / 1000000 + 1);
+}
+#endif
@@ -0,0 +1,465 @@
+// PeIconReaderTests.cpp - Icon groups from synthetic PE32 and PE32+ executables
+#include "TestFramework.h"
+#include "PeIconReader.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+
+namespace {
+    void PutLe16(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+    
+    void PutLe32(std::vector<uint8_t>& out, uint32_t value) {
+        PutLe16(out, value & 0xFFFF);
+        PutLe16(out, value >> 16);
+    }
+    
+    void SetLe16(std::vector<uint8_t>& out, size_t offset, uint32_t value) {
+        out[offset] = static_cast<uint8_t>(value);
+        out[offset + 1] = static_cast<uint8_t>(value >> 8);
+    }
+    
+    void SetLe32(std::vector<uint8_t>& out, size_t offset, uint32_t value) {
+        SetLe16(out, offset, value & 0xFFFF);
+        SetLe16(out, offset + 2, value >> 16);
+    }
+    
+    void Align(std::vector<uint8_t>& out, size_t alignment) {
+        out.resize((out.size() + alignment - 1) / alignment * alignment, 0);
+    }
+    
+    // A 32 bpp DIB icon image of one color, so the decoded pixels show which image was read
+    std::vector<uint8_t> MakeDib(int size, uint32_t color) {
+        std::vector<uint8_t> out;
+        PutLe32(out, 40);
+        PutLe32(out, size);
+        PutLe32(out, size * 2);
+        PutLe16(out, 1);
+        PutLe16(out, 32);
+        for (int i = 0; i < 6; i++) {
+            PutLe32(out, 0);
+        }
+        for (int i = 0; i < size * size; i++) {
+            PutLe32(out, color);
+        }
+        out.resize(out.size() + static_cast<size_t>((size + 31) / 32) * 4 * size, 0);
+        return out;
+    }
+    
+    // The PNG entry of a data/ icon, as 256px RT_ICON resources usually are
+    std::vector<uint8_t> ReadDataIcon() {
+        std::ifstream file(std::filesystem::path(TestRegistry::GetSourceDir()) / "data" / "DOS" / "icons" / "Zone 66.ico",
+                           std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    
+    std::vector<uint8_t> PngFromIco(const std::vector<uint8_t>& ico) {
+        if (ico.size() < 22) {
+            return {};
+        }
+        uint32_t size = ico[14] | (ico[15] << 8) | (ico[16] << 16) | (static_cast<uint32_t>(ico[17]) << 24);
+        uint32_t offset = ico[18] | (ico[19] << 8) | (ico[20] << 16) | (static_cast<uint32_t>(ico[21]) << 24);
+        return std::vector<uint8_t>(ico.begin() + offset, ico.begin() + offset + size);
+    }
+    
+    struct Resource {
+        uint32_t type;
+        std::string name;          // Named resource if not empty, otherwise id
+        uint32_t id;
+        std::vector<uint8_t> data;
+    };
+    
+    struct GroupEntry {
+        int size;                  // 256 is stored as 0
+        uint32_t iconId;
+        uint32_t bytes;
+    };
+    
+    std::vector<uint8_t> MakeGroup(const std::vector<GroupEntry>& entries) {
+        std::vector<uint8_t> out;
+        PutLe16(out, 0);
+        PutLe16(out, 1);
+        PutLe16(out, static_cast<uint32_t>(entries.size()));
+        for (const GroupEntry& entry : entries) {
+            out.push_back(static_cast<uint8_t>(entry.size & 0xFF));
+            out.push_back(static_cast<uint8_t>(entry.size & 0xFF));
+            out.push_back(0);
+            out.push_back(0);
+            PutLe16(out, 1);
+            PutLe16(out, 32);
+            PutLe32(out, entry.bytes);
+            PutLe16(out, entry.iconId);
+        }
+        return out;
+    }
+    
+    // The .rsrc tree: type, name and language directories, then name strings, data
+    // entries and the data itself. Within a type, named entries come first, then IDs
+    // in ascending order, as the resource compiler writes them.
+    std::vector<uint8_t> MakeResourceSection(std::vector<Resource> resources, uint32_t sectionRva) {
+        std::sort(resources.begin(), resources.end(), [](const Resource& a, const Resource& b) {
+            if (a.type != b.type) {
+                return a.type < b.type;
+            }
+            if (a.name.empty() != b.name.empty()) {
+                return !a.name.empty();
+            }
+            return a.name.empty() ? a.id < b.id : a.name < b.name;
+        });
+        std::map<uint32_t, std::vector<const Resource*>> types;
+        for (const Resource& resource : resources) {
+            types[resource.type].push_back(&resource);
+        }
+        
+        // Offsets of everything, before writing
+        uint32_t typeDirectories = 16 + 8 * static_cast<uint32_t>(types.size());
+        std::map<uint32_t, uint32_t> typeOffsets;
+        uint32_t position = typeDirectories;
+        for (const auto& type : types) {
+            typeOffsets[type.first] = position;
+            position += 16 + 8 * static_cast<uint32_t>(type.second.size());
+        }
+        uint32_t languageDirectories = position;
+        position += 24 * static_cast<uint32_t>(resources.size());
+        std::vector<uint32_t> nameOffsets;
+        for (const Resource& resource : resources) {
+            nameOffsets.push_back(position);
+            position += resource.name.empty() ? 0 : 2 + 2 * static_cast<uint32_t>(resource.name.size());
+        }
+        position = (position + 3) / 4 * 4;
+        uint32_t dataEntries = position;
+        position += 16 * static_cast<uint32_t>(resources.size());
+        std::vector<uint32_t> dataOffsets;
+        for (const Resource& resource : resources) {
+            position = (position + 7) / 8 * 8;
+            dataOffsets.push_back(position);
+            position += static_cast<uint32_t>(resource.data.size());
+        }
+        
+        auto directoryHeader = [](std::vector<uint8_t>& out, uint32_t named, uint32_t ids) {
+            for (int i = 0; i < 3; i++) {
+                PutLe32(out, 0);
+            }
+            PutLe16(out, named);
+            PutLe16(out, ids);
+        };
+        
+        std::vector<uint8_t> out;
+        directoryHeader(out, 0, static_cast<uint32_t>(types.size()));
+        for (const auto& type : types) {
+            PutLe32(out, type.first);
+            PutLe32(out, 0x80000000 | typeOffsets[type.first]);
+        }
+        size_t index = 0;
+        for (const auto& type : types) {
+            uint32_t named = 0;
+            for (const Resource* resource : type.second) {
+                named += resource->name.empty() ? 0 : 1;
+            }
+            directoryHeader(out, named, static_cast<uint32_t>(type.second.size()) - named);
+            for (const Resource* resource : type.second) {
+                PutLe32(out, resource->name.empty() ? resource->id : 0x80000000 | nameOffsets[index]);
+                PutLe32(out, 0x80000000 | (languageDirectories + 24 * static_cast<uint32_t>(index)));
+                index++;
+            }
+        }
+        for (size_t i = 0; i < resources.size(); i++) {
+            directoryHeader(out, 0, 1);
+            PutLe32(out, 0x409);
+            PutLe32(out, dataEntries + 16 * static_cast<uint32_t>(i));
+        }
+        for (const Resource& resource : resources) {
+            if (!resource.name.empty()) {
+                PutLe16(out, static_cast<uint32_t>(resource.name.size()));
+                for (char c : resource.name) {
+                    PutLe16(out, static_cast<uint8_t>(c));
+                }
+            }
+        }
+        Align(out, 4);
+        for (size_t i = 0; i < resources.size(); i++) {
+            PutLe32(out, sectionRva + dataOffsets[i]);
+            PutLe32(out, static_cast<uint32_t>(resources[i].data.size()));
+            PutLe32(out, 0);
+            PutLe32(out, 0);
+        }
+        for (size_t i = 0; i < resources.size(); i++) {
+            Align(out, 8);
+            out.insert(out.end(), resources[i].data.begin(), resources[i].data.end());
+        }
+        return out;
+    }
+    
+    struct PeFile {
+        std::vector<uint8_t> data;
+        uint64_t codeOffset;
+        uint64_t codeSize;
+        uint64_t resourceOffset;
+    };
+    
+    // An executable with a large .text section ahead of .rsrc
+    PeFile MakePe(bool pe64, const std::vector<Resource>& resources, uint32_t codeSize = 4 * 1024 * 1024) {
+        const uint32_t FILE_ALIGNMENT = 0x200;
+        const uint32_t SECTION_ALIGNMENT = 0x1000;
+        const uint32_t PE_OFFSET = 0x80;
+        uint32_t optionalSize = pe64 ? 240 : 224;
+        uint32_t codeRva = SECTION_ALIGNMENT;
+        uint32_t resourceRva = codeRva + (codeSize + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        std::vector<uint8_t> resourceSection = MakeResourceSection(resources, resourceRva);
+        
+        PeFile pe;
+        std::vector<uint8_t>& out = pe.data;
+        out.assign(PE_OFFSET, 0);
+        out[0] = 'M';
+        out[1] = 'Z';
+        SetLe32(out, 0x3C, PE_OFFSET);
+        
+        out.insert(out.end(), {'P', 'E', 0, 0});
+        PutLe16(out, pe64 ? 0x8664 : 0x14C);
+        PutLe16(out, 2);
+        for (int i = 0; i < 3; i++) {
+            PutLe32(out, 0);
+        }
+        PutLe16(out, optionalSize);
+        PutLe16(out, 0x22);
+        
+        size_t optional = out.size();
+        out.resize(optional + optionalSize, 0);
+        SetLe16(out, optional, pe64 ? 0x20B : 0x10B);
+        size_t directories = optional + (pe64 ? 112 : 96);
+        SetLe32(out, directories - 4, 16);
+        SetLe32(out, directories + 2 * 8, resourceRva);
+        SetLe32(out, directories + 2 * 8 + 4, static_cast<uint32_t>(resourceSection.size()));
+        
+        pe.codeOffset = 0x400;
+        pe.codeSize = codeSize;
+        pe.resourceOffset = pe.codeOffset + (codeSize + FILE_ALIGNMENT - 1) / FILE_ALIGNMENT * FILE_ALIGNMENT;
+        uint32_t resourceRawSize = static_cast<uint32_t>((resourceSection.size() + FILE_ALIGNMENT - 1) / FILE_ALIGNMENT * FILE_ALIGNMENT);
+        struct SectionHeader {
+            const char* name;
+            uint32_t virtualSize, rva, rawSize, rawOffset;
+        };
+        const SectionHeader headers[2] = {
+            {".text", codeSize, codeRva, static_cast<uint32_t>(pe.resourceOffset - pe.codeOffset), static_cast<uint32_t>(pe.codeOffset)},
+            {".rsrc", static_cast<uint32_t>(resourceSection.size()), resourceRva, resourceRawSize, static_cast<uint32_t>(pe.resourceOffset)}};
+        for (const SectionHeader& header : headers) {
+            size_t start = out.size();
+            out.resize(start + 40, 0);
+            std::copy(header.name, header.name + strlen(header.name), out.begin() + start);
+            SetLe32(out, start + 8, header.virtualSize);
+            SetLe32(out, start + 12, header.rva);
+            SetLe32(out, start + 16, header.rawSize);
+            SetLe32(out, start + 20, header.rawOffset);
+        }
+        
+        out.resize(pe.codeOffset, 0);
+        out.resize(pe.resourceOffset, 0xCC);
+        out.insert(out.end(), resourceSection.begin(), resourceSection.end());
+        Align(out, FILE_ALIGNMENT);
+        return pe;
+    }
+    
+    const uint32_t RED = 0xFFFF0000;
+    const uint32_t GREEN = 0xFF00FF00;
+    const uint32_t BLUE = 0xFF0000FF;
+    const uint32_t WHITE = 0xFFFFFFFF;
+    
+    // Groups in resource order: "MAIN" (48), 1 (16 and a 256 PNG), 5 (32); the icons
+    // are shared between groups like the resource compiler does with identical images
+    std::vector<Resource> MakeResources() {
+        std::vector<uint8_t> dib16 = MakeDib(16, RED);
+        std::vector<uint8_t> png = PngFromIco(ReadDataIcon());
+        std::vector<uint8_t> dib32 = MakeDib(32, GREEN);
+        std::vector<uint8_t> dib48 = MakeDib(48, BLUE);
+        std::vector<uint8_t> dib24 = MakeDib(24, WHITE);
+        uint32_t icon = PeIconReader::RESOURCE_TYPE_ICON;
+        uint32_t group = PeIconReader::RESOURCE_TYPE_GROUP_ICON;
+        return {
+            {icon, "", 1, dib16},
+            {icon, "", 2, png},
+            {icon, "", 3, dib32},
+            {icon, "", 4, dib48},
+            {icon, "", 7, dib24},
+            {group, "", 5, MakeGroup({{32, 3, static_cast<uint32_t>(dib32.size())}})},
+            {group, "", 1, MakeGroup({{16, 1, static_cast<uint32_t>(dib16.size())},
+                                      {256, 2, static_cast<uint32_t>(png.size())}})},
+            {group, "MAIN", 0, MakeGroup({{48, 4, static_cast<uint32_t>(dib48.size())}})},
+            {24, "", 1, std::vector<uint8_t>(300, 'x')},       // RT_MANIFEST, ignored
+        };
+    }
+    
+    // Reads from a PE image in memory, remembering every range that was read
+    struct Reader {
+        const std::vector<uint8_t>* data;
+        std::vector<std::pair<uint64_t, size_t>> reads;
+        
+        PeIconReader::ReadFunction Function() {
+            return [this](uint64_t offset, void* buffer, size_t size) {
+                reads.emplace_back(offset, size);
+                if (offset > data->size() || size > data->size() - offset) {
+                    return false;
+                }
+                std::copy(data->begin() + offset, data->begin() + offset + size, static_cast<uint8_t*>(buffer));
+                return true;
+            };
+        }
+    };
+    
+    bool ReadIcon(const std::vector<uint8_t>& file, int iconIndex, int targetSize, DecodedImage& image) {
+        Reader reader{&file, {}};
+        return PeIconReader(reader.Function()).ReadIcon(iconIndex, targetSize, image);
+    }
+    
+    bool IsSolid(const DecodedImage& image, int size, uint32_t color) {
+        return image.width == size && image.height == size &&
+               std::all_of(image.pixels.begin(), image.pixels.end(), [color](uint32_t pixel) { return pixel == color; });
+    }
+}
+
+TEST_CASE(PeIconReader, GroupByIndex) {
+    for (bool pe64 : {false, true}) {
+        PeFile pe = MakePe(pe64, MakeResources());
+        DecodedImage image;
+        
+        // Named groups come first, then IDs ascending: MAIN, 1, 5
+        REQUIRE(ReadIcon(pe.data, 0, 256, image));
+        CHECK(IsSolid(image, 48, BLUE));
+        REQUIRE(ReadIcon(pe.data, 1, 16, image));
+        CHECK(IsSolid(image, 16, RED));
+        REQUIRE(ReadIcon(pe.data, 2, 256, image));
+        CHECK(IsSolid(image, 32, GREEN));
+        CHECK(!ReadIcon(pe.data, 3, 256, image));
+    }
+}
+
+TEST_CASE(PeIconReader, GroupByResourceId) {
+    PeFile pe = MakePe(true, MakeResources());
+    DecodedImage image;
+    REQUIRE(ReadIcon(pe.data, -5, 256, image));
+    CHECK(IsSolid(image, 32, GREEN));
+    REQUIRE(ReadIcon(pe.data, -1, 16, image));
+    CHECK(IsSolid(image, 16, RED));
+    
+    // No group 2 (icon 2 exists, but only as an RT_ICON)
+    CHECK(!ReadIcon(pe.data, -2, 256, image));
+}
+
+TEST_CASE(PeIconReader, BestImageInTheGroup) {
+    // Group 1 holds a 16px DIB and the 256px PNG of a data/ icon
+    std::vector<uint8_t> ico = ReadDataIcon();
+    DecodedImage expected;
+    REQUIRE(IconDecoder::DecodeIco(ico.data(), ico.size(), 256, expected));
+    
+    PeFile pe = MakePe(false, MakeResources());
+    for (int target : {17, 96, 256, 1024}) {
+        DecodedImage image;
+        REQUIRE(ReadIcon(pe.data, -1, target, image));
+        CHECK_EQ(image.width, 256);
+        CHECK(image.pixels == expected.pixels);
+    }
+}
+
+TEST_CASE(PeIconReader, ReadsOnlyHeadersAndResources) {
+    PeFile pe = MakePe(true, MakeResources());
+    Reader reader{&pe.data, {}};
+    PeIconReader peReader(reader.Function());
+    DecodedImage image;
+    REQUIRE(peReader.ReadIcon(-1, 256, image));
+    
+    size_t total = 0;
+    for (const auto& read : reader.reads) {
+        bool touchesCode = read.first < pe.codeOffset + pe.codeSize && read.first + read.second > pe.codeOffset;
+        CHECK(!touchesCode);
+        total += read.second;
+    }
+    // The header, directories and the chosen PNG; not the DIBs in other groups
+    CHECK(total < PngFromIco(ReadDataIcon()).size() + 2048);
+}
+
+TEST_CASE(PeIconReader, MissingPieces) {
+    DecodedImage image;
+    
+    // The group refers to an RT_ICON that is not there
+    std::vector<Resource> dangling = MakeResources();
+    dangling.erase(std::remove_if(dangling.begin(), dangling.end(), [](const Resource& resource) {
+        return resource.type == PeIconReader::RESOURCE_TYPE_ICON && resource.id == 3;
+    }), dangling.end());
+    CHECK(!ReadIcon(MakePe(false, dangling).data, -5, 32, image));
+    CHECK(ReadIcon(MakePe(false, dangling).data, -1, 16, image));
+    
+    // No icon groups at all
+    std::vector<Resource> noGroups = MakeResources();
+    noGroups.erase(std::remove_if(noGroups.begin(), noGroups.end(), [](const Resource& resource) {
+        return resource.type == PeIconReader::RESOURCE_TYPE_GROUP_ICON;
+    }), noGroups.end());
+    CHECK(!ReadIcon(MakePe(false, noGroups, 4096).data, 0, 32, image));
+    
+    // No resource directory
+    std::vector<uint8_t> noResources = MakePe(false, MakeResources(), 4096).data;
+    SetLe32(noResources, 0x80 + 24 + 96 + 16, 0);
+    CHECK(!ReadIcon(noResources, 0, 32, image));
+}
+
+TEST_CASE(PeIconReader, RejectsNonExecutables) {
+    DecodedImage image;
+    std::vector<uint8_t> ico = ReadDataIcon();
+    CHECK(!PeIconReader::IsExecutable(ico.data(), ico.size()));
+    CHECK(!ReadIcon(ico, 0, 256, image));
+    CHECK(!ReadIcon({}, 0, 256, image));
+    CHECK(!PeIconReader(nullptr).ReadIcon(0, 256, image));
+    
+    std::vector<uint8_t> file = MakePe(false, MakeResources(), 4096).data;
+    CHECK(PeIconReader::IsExecutable(file.data(), file.size()));
+    
+    // A DOS executable: "MZ" but no PE header
+    std::vector<uint8_t> dos = file;
+    dos[0x80] = 'N';
+    CHECK(!ReadIcon(dos, 0, 256, image));
+    
+    // An optional header that is neither PE32 nor PE32+
+    std::vector<uint8_t> rom = file;
+    SetLe16(rom, 0x80 + 24, 0x107);
+    CHECK(!ReadIcon(rom, 0, 256, image));
+}
+
+TEST_CASE(PeIconReader, TruncatedFiles) {
+    // Every cut through the headers and resources fails cleanly
+    PeFile pe = MakePe(false, MakeResources(), 4096);
+    size_t full = pe.data.size();
+    DecodedImage image;
+    for (size_t size = 0; size < full; size += size < pe.resourceOffset ? 61 : 7) {
+        std::vector<uint8_t> cut(pe.data.begin(), pe.data.begin() + size);
+        if (ReadIcon(cut, -5, 32, image)) {
+            CHECK(IsSolid(image, 32, GREEN));
+        }
+    }
+}
+
+TEST_CASE(PeIconReader, SurvivesRandomDamage) {
+    PeFile pe = MakePe(true, MakeResources(), 4096);
+    std::mt19937 random(77);
+    size_t resourceEnd = pe.data.size();
+    for (int round = 0; round < 3000; round++) {
+        std::vector<uint8_t> damaged = pe.data;
+        int flips = 1 + random() % 4;
+        for (int i = 0; i < flips; i++) {
+            // Headers and the directory tree, where offsets and counts live
+            size_t offset = random() % 2 ? random() % 0x200 : pe.resourceOffset + random() % 0x200;
+            if (offset < resourceEnd) {
+                damaged[offset] = static_cast<uint8_t>(random());
+            }
+        }
+        DecodedImage image;
+        int index = static_cast<int>(random() % 5) - 2;
+        if (ReadIcon(damaged, index, 32, image)) {
+            CHECK(image.pixels.size() == static_cast<size_t>(image.width) * image.height);
+        }
+    }
+}
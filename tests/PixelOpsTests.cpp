@@ -0,0 +1,221 @@
+// PixelOpsTests.cpp - Every PixelOps path against a plain division reference
+#include "TestFramework.h"
+#include "PixelOps.h"
+#include <random>
+#include <vector>
+
+namespace {
+    const PixelIsa ALL_ISAS[] = {PixelIsa::Scalar, PixelIsa::SSE2, PixelIsa::AVX2, PixelIsa::NEON};
+    
+    // Run check once per instruction set this CPU has, then restore the detected one
+    template <typename Check>
+    void ForEachIsa(Check check) {
+        PixelIsa detected = PixelOps::GetActiveIsa();
+        for (PixelIsa isa : ALL_ISAS) {
+            if (PixelOps::SetActiveIsa(isa)) {
+                check(isa);
+            }
+        }
+        PixelOps::SetActiveIsa(detected);
+    }
+    
+    uint32_t Channel(uint32_t pixel, int shift) {
+        return (pixel >> shift) & 0xFF;
+    }
+    
+    uint32_t RefMultiply(uint32_t c, uint32_t a) {
+        return (c * a + 127) / 255;
+    }
+    
+    uint32_t RefPremultiply(uint32_t pixel) {
+        uint32_t a = pixel >> 24;
+        return (a << 24) | (RefMultiply(Channel(pixel, 16), a) << 16) |
+               (RefMultiply(Channel(pixel, 8), a) << 8) | RefMultiply(Channel(pixel, 0), a);
+    }
+    
+    uint32_t RefUnpremultiply(uint32_t pixel) {
+        uint32_t a = pixel >> 24;
+        if (a == 0) {
+            return 0;
+        }
+        uint32_t result = a << 24;
+        for (int shift = 0; shift < 24; shift += 8) {
+            uint32_t c = (Channel(pixel, shift) * 255 + a / 2) / a;
+            result |= (c > 255 ? 255 : c) << shift;
+        }
+        return result;
+    }
+    
+    uint32_t RefBlend(uint32_t src, uint32_t dst, uint32_t opacity) {
+        uint32_t scaled = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            scaled |= RefMultiply(Channel(src, shift), opacity) << shift;
+        }
+        uint32_t inverse = 255 - (scaled >> 24);
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t c = Channel(scaled, shift) + RefMultiply(Channel(dst, shift), inverse);
+            result |= (c > 255 ? 255 : c) << shift;
+        }
+        return result;
+    }
+    
+    std::vector<uint32_t> RandomPixels(size_t count, uint32_t seed) {
+        std::mt19937 random(seed);
+        std::vector<uint32_t> pixels(count);
+        for (uint32_t& pixel : pixels) {
+            pixel = random();
+        }
+        return pixels;
+    }
+    
+    // Premultiplied pixels: no channel above alpha
+    std::vector<uint32_t> RandomPremultiplied(size_t count, uint32_t seed) {
+        std::vector<uint32_t> pixels = RandomPixels(count, seed);
+        for (uint32_t& pixel : pixels) {
+            pixel = RefPremultiply(pixel);
+        }
+        return pixels;
+    }
+    
+    // Every (channel, alpha) pair once, in all three color channels
+    std::vector<uint32_t> AllChannelAlphaPairs() {
+        std::vector<uint32_t> pixels;
+        for (uint32_t a = 0; a < 256; a++) {
+            for (uint32_t c = 0; c < 256; c++) {
+                pixels.push_back((a << 24) | (c << 16) | ((255 - c) << 8) | c);
+            }
+        }
+        return pixels;
+    }
+}
+
+TEST_CASE(PixelOps, MultiplyAlphaMatchesDivision) {
+    for (uint32_t a = 0; a < 256; a++) {
+        for (uint32_t c = 0; c < 256; c++) {
+            CHECK_EQ(PixelOps::MultiplyAlpha(c, a), RefMultiply(c, a));
+        }
+    }
+}
+
+TEST_CASE(PixelOps, PremultiplyIsExact) {
+    std::vector<uint32_t> src = AllChannelAlphaPairs();
+    ForEachIsa([&](PixelIsa) {
+        std::vector<uint32_t> dst(src.size());
+        PixelOps::Premultiply(src.data(), dst.data(), src.size());
+        for (size_t i = 0; i < src.size(); i++) {
+            CHECK_EQ(dst[i], RefPremultiply(src[i]));
+        }
+    });
+}
+
+TEST_CASE(PixelOps, UnpremultiplyIsExact) {
+    std::vector<uint32_t> src = AllChannelAlphaPairs();
+    ForEachIsa([&](PixelIsa) {
+        std::vector<uint32_t> dst(src.size());
+        PixelOps::Unpremultiply(src.data(), dst.data(), src.size());
+        for (size_t i = 0; i < src.size(); i++) {
+            CHECK_EQ(dst[i], RefUnpremultiply(src[i]));
+        }
+    });
+}
+
+TEST_CASE(PixelOps, UnpremultiplyUndoesPremultiplyWhenOpaque) {
+    std::vector<uint32_t> src = RandomPixels(1000, 1);
+    for (uint32_t& pixel : src) {
+        pixel |= 0xFF000000;
+    }
+    ForEachIsa([&](PixelIsa) {
+        std::vector<uint32_t> dst(src.size());
+        PixelOps::Premultiply(src.data(), dst.data(), dst.size());
+        PixelOps::Unpremultiply(dst.data(), dst.data(), dst.size());
+        CHECK(dst == src);
+    });
+}
+
+TEST_CASE(PixelOps, BlendOverIsExact) {
+    std::vector<uint32_t> src = RandomPremultiplied(4099, 2);
+    std::vector<uint32_t> background = RandomPremultiplied(4099, 3);
+    
+    // Fully transparent and fully opaque sources take their own shortcuts in some paths
+    for (size_t i = 0; i < src.size(); i += 7) {
+        src[i] = i % 2 ? 0 : src[i] | 0xFF000000;
+    }
+    
+    ForEachIsa([&](PixelIsa) {
+        std::vector<uint32_t> dst = background;
+        PixelOps::BlendOver(src.data(), dst.data(), dst.size());
+        for (size_t i = 0; i < dst.size(); i++) {
+            CHECK_EQ(dst[i], RefBlend(src[i], background[i], 255));
+        }
+    });
+}
+
+TEST_CASE(PixelOps, BlendOverOpacityIsExact) {
+    std::vector<uint32_t> src = RandomPremultiplied(1031, 4);
+    std::vector<uint32_t> background = RandomPremultiplied(1031, 5);
+    
+    for (uint32_t opacity : {0u, 1u, 64u, 128u, 200u, 254u, 255u}) {
+        ForEachIsa([&](PixelIsa) {
+            std::vector<uint32_t> dst = background;
+            PixelOps::BlendOverOpacity(src.data(), dst.data(), dst.size(), opacity);
+            for (size_t i = 0; i < dst.size(); i++) {
+                CHECK_EQ(dst[i], RefBlend(src[i], background[i], opacity));
+            }
+        });
+    }
+}
+
+TEST_CASE(PixelOps, KernelsStayInsideCount) {
+    // Every length through two AVX2 blocks, at every start offset within one: vector
+    // bodies and scalar tails must neither miss nor overrun a pixel
+    const uint32_t GUARD = 0xDEADBEEF;
+    std::vector<uint32_t> src = RandomPremultiplied(80, 6);
+    
+    ForEachIsa([&](PixelIsa isa) {
+        for (size_t offset = 0; offset < 8; offset++) {
+            for (size_t count = 0; count <= 40; count++) {
+                std::vector<uint32_t> dst(offset + count + 8, GUARD);
+                PixelOps::Fill(dst.data() + offset, 0x80402010, count);
+                PixelOps::BlendOver(src.data(), dst.data() + offset, count);
+                PixelOps::Premultiply(src.data(), dst.data() + offset, count);
+                
+                for (size_t i = 0; i < dst.size(); i++) {
+                    bool inside = i >= offset && i < offset + count;
+                    if (inside) {
+                        CHECK_EQ(dst[i], RefPremultiply(src[i - offset]));
+                    } else if (dst[i] != GUARD) {
+                        TestRegistry::Fail(__FILE__, __LINE__, std::string(PixelOps::GetIsaName(isa)) + " wrote outside count");
+                    }
+                }
+            }
+        }
+    });
+}
+
+TEST_CASE(PixelOps, InPlaceMatchesSeparateBuffers) {
+    std::vector<uint32_t> src = RandomPixels(515, 7);
+    ForEachIsa([&](PixelIsa) {
+        std::vector<uint32_t> separate(src.size());
+        std::vector<uint32_t> inPlace = src;
+        PixelOps::Premultiply(src.data(), separate.data(), src.size());
+        PixelOps::Premultiply(inPlace.data(), inPlace.data(), inPlace.size());
+        CHECK(inPlace == separate);
+    });
+}
+
+TEST_CASE(PixelOps, IsaSelection) {
+    CHECK(PixelOps::IsIsaSupported(PixelIsa::Scalar));
+    CHECK(PixelOps::IsIsaSupported(PixelOps::GetActiveIsa()));
+    
+    PixelIsa detected = PixelOps::GetActiveIsa();
+    CHECK(PixelOps::SetActiveIsa(PixelIsa::Scalar));
+    CHECK(PixelOps::GetActiveIsa() == PixelIsa::Scalar);
+    for (PixelIsa isa : ALL_ISAS) {
+        if (!PixelOps::IsIsaSupported(isa)) {
+            CHECK(!PixelOps::SetActiveIsa(isa));
+            CHECK(PixelOps::GetActiveIsa() == PixelIsa::Scalar);
+        }
+    }
+    PixelOps::SetActiveIsa(detected);
+}
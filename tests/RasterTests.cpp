@@ -0,0 +1,196 @@
+// RasterTests.cpp - Raster primitives against a per-pixel reference, on every PixelOps path
+#include "TestFramework.h"
+#include "PixelOps.h"
+#include "Raster.h"
+#include <random>
+#include <vector>
+
+namespace {
+    const PixelIsa ALL_ISAS[] = {PixelIsa::Scalar, PixelIsa::SSE2, PixelIsa::AVX2, PixelIsa::NEON};
+    
+    template <typename Check>
+    void ForEachIsa(Check check) {
+        PixelIsa detected = PixelOps::GetActiveIsa();
+        for (PixelIsa isa : ALL_ISAS) {
+            if (PixelOps::SetActiveIsa(isa)) {
+                check();
+            }
+        }
+        PixelOps::SetActiveIsa(detected);
+    }
+    
+    uint32_t RefMultiply(uint32_t c, uint32_t a) {
+        return (c * a + 127) / 255;
+    }
+    
+    uint32_t RefBlend(uint32_t src, uint32_t dst, uint32_t opacity) {
+        uint32_t scaled = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            scaled |= RefMultiply((src >> shift) & 0xFF, opacity) << shift;
+        }
+        uint32_t inverse = 255 - (scaled >> 24);
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t c = ((scaled >> shift) & 0xFF) + RefMultiply((dst >> shift) & 0xFF, inverse);
+            result |= (c > 255 ? 255 : c) << shift;
+        }
+        return result;
+    }
+    
+    // A surface with padding past its width, so writes beyond a row are caught too
+    struct TestSurface {
+        std::vector<uint32_t> pixels;
+        RasterSurface surface;
+        
+        TestSurface(int width, int height, uint32_t seed) {
+            int stride = width + 5;
+            std::mt19937 random(seed);
+            pixels.resize(static_cast<size_t>(stride) * height);
+            for (uint32_t& pixel : pixels) {
+                uint32_t a = random() & 0xFF;
+                uint32_t value = random();
+                pixel = (a << 24) | (RefMultiply((value >> 16) & 0xFF, a) << 16) |
+                        (RefMultiply((value >> 8) & 0xFF, a) << 8) | RefMultiply(value & 0xFF, a);
+            }
+            surface = RasterSurface{pixels.data(), width, height, stride};
+        }
+        
+        TestSurface(const TestSurface& other)
+            : pixels(other.pixels)
+            , surface(other.surface)
+        {
+            surface.pixels = pixels.data();
+        }
+    };
+    
+    bool Inside(const PixelRect& rect, int x, int y) {
+        return x >= rect.left && x < rect.right && y >= rect.top && y < rect.bottom;
+    }
+    
+    // Expected result of drawing src at (x, y): op 0 copies, otherwise blends at opacity
+    std::vector<uint32_t> RefDraw(const TestSurface& dst, int x, int y, const TestSurface& src, int op,
+                                  uint32_t opacity, const PixelRect& clip) {
+        std::vector<uint32_t> expected = dst.pixels;
+        for (int row = 0; row < dst.surface.height; row++) {
+            for (int column = 0; column < dst.surface.width; column++) {
+                int sx = column - x;
+                int sy = row - y;
+                if (!Inside(clip, column, row) || sx < 0 || sy < 0 || sx >= src.surface.width || sy >= src.surface.height) {
+                    continue;
+                }
+                uint32_t from = src.pixels[static_cast<size_t>(sy) * src.surface.stride + sx];
+                uint32_t& to = expected[static_cast<size_t>(row) * dst.surface.stride + column];
+                to = op == 0 ? from : RefBlend(from, to, opacity);
+            }
+        }
+        return expected;
+    }
+    
+    std::vector<uint32_t> RefFill(const TestSurface& dst, const PixelRect& rect, const PixelRect& hole,
+                                  uint32_t color, const PixelRect& clip) {
+        std::vector<uint32_t> expected = dst.pixels;
+        for (int row = 0; row < dst.surface.height; row++) {
+            for (int column = 0; column < dst.surface.width; column++) {
+                if (Inside(rect, column, row) && !Inside(hole, column, row) && Inside(clip, column, row)) {
+                    expected[static_cast<size_t>(row) * dst.surface.stride + column] = color;
+                }
+            }
+        }
+        return expected;
+    }
+    
+    // Placements that hang off every edge, sit inside, or miss the surface entirely
+    const int OFFSETS[] = {-40, -7, -1, 0, 3, 17, 38, 60};
+    const PixelRect CLIPS[] = {
+        PixelRect(-100, -100, 1000, 1000),
+        PixelRect(5, 3, 33, 27),
+        PixelRect(0, 0, 1, 1),
+        PixelRect(20, 20, 10, 10)   // Empty
+    };
+}
+
+TEST_CASE(Raster, FillRect) {
+    TestSurface original(41, 29, 1);
+    ForEachIsa([&]() {
+        for (const PixelRect& clip : CLIPS) {
+            for (int x : OFFSETS) {
+                PixelRect rect(x, x / 2, x + 23, x / 2 + 19);
+                TestSurface dst = original;
+                Raster::FillRect(dst.surface, rect, 0xC0102030, clip);
+                CHECK(dst.pixels == RefFill(original, rect, PixelRect(), 0xC0102030, clip));
+            }
+        }
+    });
+}
+
+TEST_CASE(Raster, OutlineRect) {
+    TestSurface original(41, 29, 2);
+    ForEachIsa([&]() {
+        for (const PixelRect& clip : CLIPS) {
+            for (int thickness : {1, 2, 5, 9, 12}) {
+                PixelRect rect(-3, 2, 30, 25);
+                PixelRect hole(rect.left + thickness, rect.top + thickness, rect.right - thickness, rect.bottom - thickness);
+                TestSurface dst = original;
+                Raster::OutlineRect(dst.surface, rect, thickness, 0xFFFFFFFF, clip);
+                CHECK(dst.pixels == RefFill(original, rect, hole, 0xFFFFFFFF, clip));
+            }
+        }
+    });
+}
+
+TEST_CASE(Raster, OutlineNeedsThickness) {
+    TestSurface original(16, 16, 3);
+    TestSurface dst = original;
+    Raster::OutlineRect(dst.surface, PixelRect(2, 2, 12, 12), 0, 0xFF000000, dst.surface.Bounds());
+    Raster::OutlineRect(dst.surface, PixelRect(12, 2, 2, 12), 2, 0xFF000000, dst.surface.Bounds());
+    CHECK(dst.pixels == original.pixels);
+}
+
+TEST_CASE(Raster, CopyAndBlend) {
+    TestSurface original(41, 29, 4);
+    TestSurface src(23, 17, 5);
+    ForEachIsa([&]() {
+        for (const PixelRect& clip : CLIPS) {
+            for (int x : OFFSETS) {
+                for (int y : {-9, 0, 6, 20}) {
+                    for (int op = 0; op < 3; op++) {
+                        uint32_t opacity = op == 2 ? 100 : 255;
+                        TestSurface dst = original;
+                        if (op == 0) {
+                            Raster::Copy(dst.surface, x, y, src.surface.AsImage(), clip);
+                        } else if (op == 1) {
+                            Raster::BlendOver(dst.surface, x, y, src.surface.AsImage(), clip);
+                        } else {
+                            Raster::BlendOpacity(dst.surface, x, y, src.surface.AsImage(), opacity, clip);
+                        }
+                        CHECK(dst.pixels == RefDraw(original, x, y, src, op, opacity, clip));
+                    }
+                }
+            }
+        }
+    });
+}
+
+TEST_CASE(Raster, OpacityEnds) {
+    TestSurface original(20, 20, 6);
+    TestSurface src(10, 10, 7);
+    
+    // Zero opacity draws nothing; full opacity is a plain blend
+    TestSurface dst = original;
+    Raster::BlendOpacity(dst.surface, 4, 4, src.surface.AsImage(), 0, dst.surface.Bounds());
+    CHECK(dst.pixels == original.pixels);
+    
+    Raster::BlendOpacity(dst.surface, 4, 4, src.surface.AsImage(), 255, dst.surface.Bounds());
+    CHECK(dst.pixels == RefDraw(original, 4, 4, src, 1, 255, dst.surface.Bounds()));
+}
+
+TEST_CASE(Raster, NullPixelsAreIgnored) {
+    TestSurface original(8, 8, 8);
+    TestSurface dst = original;
+    Raster::BlendOver(dst.surface, 0, 0, RasterImage{nullptr, 8, 8, 8}, dst.surface.Bounds());
+    CHECK(dst.pixels == original.pixels);
+    
+    RasterSurface empty;
+    Raster::FillRect(empty, PixelRect(0, 0, 4, 4), 0xFFFFFFFF, PixelRect(0, 0, 4, 4));
+    Raster::Copy(empty, 0, 0, original.surface.AsImage(), PixelRect(0, 0, 4, 4));
+}
@@ -0,0 +1,111 @@
+// ScrollBlitTests.cpp - Scrolled pixels against the area drawn directly at the new offset
+#include "TestFramework.h"
+#include "ScrollBlit.h"
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    const int WIDTH = 40;
+    const int HEIGHT = 50;
+    const int STRIDE = WIDTH + 3;           // Padding past each row catches overruns
+    const uint32_t OUTSIDE = 0xDEADBEEF;
+    
+    // Content row y of a tall document, different in every pixel
+    uint32_t ContentPixel(int x, int y) {
+        return 0xFF000000 | (static_cast<uint32_t>(y & 0xFFF) << 12) | static_cast<uint32_t>(x & 0xFFF);
+    }
+    
+    // A buffer whose area shows the document from scrollOffset on; the rest is OUTSIDE
+    std::vector<uint32_t> Draw(const PixelRect& area, int scrollOffset) {
+        std::vector<uint32_t> pixels(static_cast<size_t>(STRIDE) * HEIGHT, OUTSIDE);
+        for (int y = area.top; y < area.bottom; y++) {
+            for (int x = area.left; x < area.right; x++) {
+                pixels[y * STRIDE + x] = ContentPixel(x, scrollOffset + y - area.top);
+            }
+        }
+        return pixels;
+    }
+    
+    bool Inside(const PixelRect& rect, int x, int y) {
+        return x >= rect.left && x < rect.right && y >= rect.top && y < rect.bottom;
+    }
+    
+    // Scroll a drawn area by dy and compare with drawing it at the new offset: equal
+    // everywhere but the exposed band, which must be exactly what ExposedBand says
+    void CheckScroll(const PixelRect& area, int scrollOffset, int dy) {
+        std::vector<uint32_t> pixels = Draw(area, scrollOffset);
+        std::vector<uint32_t> golden = Draw(area, scrollOffset + dy);
+        PixelRect exposed = ScrollBlit::ScrollRows(pixels.data(), STRIDE, area, dy);
+        
+        PixelRect expected = ScrollBlit::ExposedBand(area, dy);
+        CHECK_EQ(exposed.top, expected.top);
+        CHECK_EQ(exposed.bottom, expected.bottom);
+        int expectedRows = std::min(std::abs(dy), area.Height());
+        CHECK_EQ(exposed.Area(), static_cast<int64_t>(expectedRows) * area.Width());
+        
+        int wrong = 0;
+        for (int y = 0; y < HEIGHT; y++) {
+            for (int x = 0; x < STRIDE; x++) {
+                if (!Inside(exposed, x, y)) {
+                    wrong += pixels[y * STRIDE + x] != golden[y * STRIDE + x];
+                }
+            }
+        }
+        CHECK_EQ(wrong, 0);
+    }
+}
+
+TEST_CASE(ScrollBlit, ExposedBand) {
+    PixelRect area(5, 10, 35, 40);
+    PixelRect down = ScrollBlit::ExposedBand(area, 4);
+    CHECK_EQ(down.top, 36);
+    CHECK_EQ(down.bottom, 40);
+    CHECK_EQ(down.left, 5);
+    CHECK_EQ(down.right, 35);
+    
+    PixelRect up = ScrollBlit::ExposedBand(area, -6);
+    CHECK_EQ(up.top, 10);
+    CHECK_EQ(up.bottom, 16);
+    
+    CHECK(ScrollBlit::ExposedBand(area, 0).IsEmpty());
+    CHECK(ScrollBlit::ExposedBand(PixelRect(), 5).IsEmpty());
+    CHECK_EQ(ScrollBlit::ExposedBand(area, 30).Area(), area.Area());
+    CHECK_EQ(ScrollBlit::ExposedBand(area, -100).Area(), area.Area());
+}
+
+TEST_CASE(ScrollBlit, MatchesDrawingAtTheNewOffset) {
+    // Every delta from a page up to a page down, in a full-width and an inset area
+    const PixelRect areas[] = {PixelRect(0, 0, WIDTH, HEIGHT), PixelRect(3, 7, 31, 44)};
+    for (const PixelRect& area : areas) {
+        for (int dy = -area.Height() - 2; dy <= area.Height() + 2; dy++) {
+            CheckScroll(area, 100, dy);
+        }
+    }
+}
+
+TEST_CASE(ScrollBlit, RandomScrollSequences) {
+    // Blits chained like wheel notches, each exposed band redrawn before the next
+    std::mt19937 random(17);
+    for (int round = 0; round < 50; round++) {
+        int left = random() % 10;
+        int top = random() % 10;
+        PixelRect area(left, top, left + 1 + random() % (WIDTH - left), top + 1 + random() % (HEIGHT - top));
+        int scrollOffset = 1000;
+        std::vector<uint32_t> pixels = Draw(area, scrollOffset);
+        
+        for (int step = 0; step < 20; step++) {
+            int dy = static_cast<int>(random() % 31) - 15;
+            PixelRect exposed = ScrollBlit::ScrollRows(pixels.data(), STRIDE, area, dy);
+            scrollOffset += dy;
+            std::vector<uint32_t> golden = Draw(area, scrollOffset);
+            for (int y = exposed.top; y < exposed.bottom; y++) {
+                for (int x = exposed.left; x < exposed.right; x++) {
+                    pixels[y * STRIDE + x] = golden[y * STRIDE + x];
+                }
+            }
+            CHECK(pixels == golden);
+        }
+    }
+}
@@ -0,0 +1,265 @@
+// ScrollPhysicsTests.cpp - Coasting, clamping and stick scrolling stepped on a fixed frame clock
+#include "TestFramework.h"
+#include "ScrollPhysics.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    const int64_t FRAME_120HZ = 8333;
+    const int64_t SMOOTHING = 120000;
+    
+    ScrollPhysics MakePhysics(int maxOffset, int offset, int64_t smoothing = SMOOTHING) {
+        ScrollPhysics physics;
+        physics.SetSmoothing(smoothing);
+        physics.SetRange(maxOffset);
+        physics.Reset(offset);
+        return physics;
+    }
+    
+    // Advance in frames of frameTime until the scroll stops; the frame count, or -1 if
+    // it still moves after maxFrames
+    int RunUntilStopped(ScrollPhysics& physics, int64_t frameTime, int maxFrames = 10000) {
+        for (int frame = 0; frame < maxFrames; frame++) {
+            if (!physics.IsMoving()) {
+                return frame;
+            }
+            physics.Advance(frameTime);
+        }
+        return physics.IsMoving() ? -1 : maxFrames;
+    }
+}
+
+TEST_CASE(ScrollPhysics, WheelCoastsTheAddedDistance) {
+    // Every notch lands exactly on the pixel nearest where it was heading, whatever
+    // the frame rate, and gets there without overshooting
+    const double distances[] = {48, -48, 144, -1, 7.25, -30.7, 1000};
+    const int64_t frameTimes[] = {FRAME_120HZ, 16667, 33333, 1000};
+    for (double distance : distances) {
+        for (int64_t frameTime : frameTimes) {
+            ScrollPhysics physics = MakePhysics(100000, 5000);
+            physics.AddDistance(distance);
+            CHECK(physics.IsMoving());
+            double target = std::round(5000 + distance);
+            double previousGap = std::fabs(target - physics.GetPosition());
+            int frames = 0;
+            while (physics.IsMoving() && frames < 10000) {
+                physics.Advance(frameTime);
+                double gap = std::fabs(target - physics.GetPosition());
+                CHECK(gap <= previousGap + 1e-9);
+                previousGap = gap;
+                frames++;
+            }
+            CHECK(!physics.IsMoving());
+            CHECK_EQ(physics.GetOffset(), static_cast<int>(target));
+            CHECK_EQ(physics.GetPosition(), target);
+            CHECK_EQ(physics.GetVelocity(), 0.0);
+            
+            // Coasting settles within a few dozen time constants
+            CHECK(frames * frameTime < 40 * SMOOTHING);
+        }
+    }
+    
+    // Notches during a coast add up
+    ScrollPhysics physics = MakePhysics(100000, 0);
+    for (int notch = 0; notch < 5; notch++) {
+        physics.AddDistance(48);
+        physics.Advance(FRAME_120HZ);
+        physics.Advance(FRAME_120HZ);
+    }
+    REQUIRE(RunUntilStopped(physics, FRAME_120HZ) >= 0);
+    CHECK_EQ(physics.GetOffset(), 240);
+}
+
+TEST_CASE(ScrollPhysics, FrameSplitDoesNotChangeThePath) {
+    // The same 0.4 s as 1 ms, 120 Hz and uneven frames: the positions agree at every
+    // common time up to the snap at the end of coasting, and they end on the same pixel
+    ScrollPhysics fine = MakePhysics(100000, 2000);
+    ScrollPhysics frames = MakePhysics(100000, 2000);
+    ScrollPhysics uneven = MakePhysics(100000, 2000);
+    fine.AddDistance(300);
+    frames.AddDistance(300);
+    uneven.AddDistance(300);
+    
+    const int64_t unevenSteps[] = {3000, 17000, 5000, 25000};
+    int64_t fineTime = 0;
+    int64_t framesTime = 0;
+    int64_t unevenTime = 0;
+    for (int i = 0; framesTime < 400000; i++) {
+        frames.Advance(FRAME_120HZ);
+        framesTime += FRAME_120HZ;
+        while (fineTime + 1000 <= framesTime) {
+            fine.Advance(1000);
+            fineTime += 1000;
+        }
+        while (unevenTime + unevenSteps[i % 4] <= framesTime) {
+            uneven.Advance(unevenSteps[i % 4]);
+            unevenTime += unevenSteps[i % 4];
+        }
+        if (fineTime == framesTime) {
+            CHECK(std::fabs(fine.GetPosition() - frames.GetPosition()) < 2.0);
+        }
+        if (unevenTime == framesTime) {
+            CHECK(std::fabs(uneven.GetPosition() - frames.GetPosition()) < 2.0);
+        }
+    }
+    REQUIRE(RunUntilStopped(fine, 1000) >= 0);
+    REQUIRE(RunUntilStopped(frames, FRAME_120HZ) >= 0);
+    REQUIRE(RunUntilStopped(uneven, 25000) >= 0);
+    CHECK_EQ(fine.GetOffset(), 2300);
+    CHECK_EQ(frames.GetOffset(), 2300);
+    CHECK_EQ(uneven.GetOffset(), 2300);
+    
+    // Before the snap the closed form agrees with itself to rounding error
+    ScrollPhysics once = MakePhysics(100000, 0);
+    ScrollPhysics twice = MakePhysics(100000, 0);
+    once.AddDistance(5000);
+    twice.AddDistance(5000);
+    once.Advance(40000);
+    twice.Advance(15000);
+    twice.Advance(25000);
+    CHECK(std::fabs(once.GetPosition() - twice.GetPosition()) < 1e-6);
+    CHECK(std::fabs(once.GetVelocity() - twice.GetVelocity()) < 1e-6);
+}
+
+TEST_CASE(ScrollPhysics, ClampsToTheRange) {
+    // Coasting past either end stops there, at rest
+    ScrollPhysics physics = MakePhysics(1000, 950);
+    physics.AddDistance(500);
+    REQUIRE(RunUntilStopped(physics, FRAME_120HZ) >= 0);
+    CHECK_EQ(physics.GetOffset(), 1000);
+    CHECK_EQ(physics.GetVelocity(), 0.0);
+    
+    physics.AddDistance(-5000);
+    int frames = 0;
+    while (physics.IsMoving() && frames++ < 10000) {
+        physics.Advance(FRAME_120HZ);
+        CHECK(physics.GetPosition() >= 0 && physics.GetPosition() <= 1000);
+    }
+    CHECK_EQ(physics.GetOffset(), 0);
+    CHECK(!physics.IsMoving());
+    
+    // Without smoothing the wheel jumps, clamped, and nothing is left to coast
+    ScrollPhysics instant = MakePhysics(1000, 100, 0);
+    instant.AddDistance(48);
+    CHECK_EQ(instant.GetOffset(), 148);
+    CHECK(!instant.IsMoving());
+    instant.AddDistance(5000);
+    CHECK_EQ(instant.GetOffset(), 1000);
+    instant.AddDistance(-5000);
+    CHECK_EQ(instant.GetOffset(), 0);
+    
+    // A shrinking range pulls the position in; Reset is left alone until the range is set
+    ScrollPhysics shrunk = MakePhysics(1000, 800);
+    shrunk.SetRange(500);
+    CHECK_EQ(shrunk.GetOffset(), 500);
+    shrunk.Reset(700);
+    CHECK_EQ(shrunk.GetOffset(), 700);
+    shrunk.SetRange(-20);
+    CHECK_EQ(shrunk.GetOffset(), 0);
+}
+
+TEST_CASE(ScrollPhysics, StickHoldsItsSpeed) {
+    // Without smoothing the stick moves at its speed from the first frame
+    ScrollPhysics instant = MakePhysics(100000, 1000, 0);
+    instant.SetStickVelocity(1200);
+    instant.Advance(FRAME_120HZ);
+    CHECK_EQ(instant.GetVelocity(), 1200.0);
+    CHECK(std::fabs(instant.GetPosition() - (1000 + 1200 * FRAME_120HZ / 1e6)) < 1e-9);
+    
+    // With smoothing the speed settles toward the stick's: within 1% after five time
+    // constants, and the position trails the unsmoothed one by about a time constant
+    ScrollPhysics physics = MakePhysics(100000, 1000);
+    physics.SetStickVelocity(-2000);
+    int frames = static_cast<int>(5 * SMOOTHING / FRAME_120HZ) + 1;
+    for (int frame = 0; frame < frames; frame++) {
+        physics.Advance(FRAME_120HZ);
+    }
+    CHECK(std::fabs(physics.GetVelocity() + 2000) < 20);
+    double unsmoothed = 1000 - 2000 * frames * FRAME_120HZ / 1e6;
+    CHECK(std::fabs(physics.GetPosition() - (unsmoothed + 2000 * SMOOTHING / 1e6)) < 20);
+    
+    // Let go: it coasts to a whole pixel and stops
+    physics.SetStickVelocity(0);
+    CHECK(physics.IsMoving());
+    REQUIRE(RunUntilStopped(physics, FRAME_120HZ) >= 0);
+    CHECK_EQ(physics.GetPosition(), std::round(physics.GetPosition()));
+    
+    // Held against the end it stays there
+    ScrollPhysics pinned = MakePhysics(500, 450);
+    pinned.SetStickVelocity(3000);
+    for (int frame = 0; frame < 200; frame++) {
+        pinned.Advance(FRAME_120HZ);
+    }
+    CHECK_EQ(pinned.GetOffset(), 500);
+    CHECK(!pinned.IsMoving());
+}
+
+TEST_CASE(ScrollPhysics, IsMovingEdgeCases) {
+    ScrollPhysics physics = MakePhysics(1000, 0);
+    CHECK(!physics.IsMoving());
+    
+    // A stick toward an end the position is already at goes nowhere; away from it does
+    physics.SetStickVelocity(-500);
+    CHECK(!physics.IsMoving());
+    physics.SetStickVelocity(500);
+    CHECK(physics.IsMoving());
+    physics.Reset(1000);
+    CHECK(!physics.IsMoving());
+    physics.SetStickVelocity(-500);
+    CHECK(physics.IsMoving());
+    
+    // No range at all: nothing can move it
+    ScrollPhysics empty = MakePhysics(0, 0);
+    empty.SetStickVelocity(500);
+    CHECK(!empty.IsMoving());
+    empty.AddDistance(100);
+    empty.Advance(FRAME_120HZ);
+    CHECK(!empty.IsMoving());
+    CHECK_EQ(empty.GetOffset(), 0);
+    
+    // Reset stops a coast
+    ScrollPhysics coasting = MakePhysics(1000, 100);
+    coasting.AddDistance(300);
+    coasting.Advance(FRAME_120HZ);
+    CHECK(coasting.IsMoving());
+    coasting.Reset(200);
+    CHECK(!coasting.IsMoving());
+    CHECK_EQ(coasting.GetOffset(), 200);
+    
+    // Zero and negative steps change nothing; a stall counts as MAX_STEP
+    ScrollPhysics stalled = MakePhysics(100000, 0);
+    ScrollPhysics capped = MakePhysics(100000, 0);
+    stalled.AddDistance(2000);
+    capped.AddDistance(2000);
+    stalled.Advance(0);
+    stalled.Advance(-5000);
+    CHECK_EQ(stalled.GetPosition(), 0.0);
+    stalled.Advance(3000000);
+    capped.Advance(ScrollPhysics::MAX_STEP);
+    CHECK_EQ(stalled.GetPosition(), capped.GetPosition());
+    CHECK(stalled.GetPosition() < 2000);
+}
+
+TEST_CASE(ScrollPhysics, FrameStepStaysWithinBudget) {
+    CHECK_EQ(ScrollPhysics::GetFrameBudget(1000), 500);
+    CHECK_EQ(ScrollPhysics::GetFrameBudget(1), 1);
+    CHECK_EQ(ScrollPhysics::GetFrameBudget(0), 1);
+    
+    ScrollPhysics physics = MakePhysics(100000, 5000);
+    CHECK_EQ(physics.GetFrameStep(4990, 100), 10);
+    CHECK_EQ(physics.GetFrameStep(4000, 100), 100);
+    CHECK_EQ(physics.GetFrameStep(6000, 100), -100);
+    
+    // A big jump is caught up over several frames, each within budget
+    int shown = 0;
+    int frames = 0;
+    while (shown != physics.GetOffset() && frames < 100) {
+        int step = physics.GetFrameStep(shown, 480);
+        CHECK(std::abs(step) <= 480);
+        shown += step;
+        frames++;
+    }
+    CHECK_EQ(shown, 5000);
+    CHECK_EQ(frames, 11);
+}
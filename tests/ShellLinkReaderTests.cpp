@@ -0,0 +1,336 @@
+// ShellLinkReaderTests.cpp - The data/ shortcuts, a synthetic ANSI link and rejection of damaged files
+#include "TestFramework.h"
+#include "ShellLinkReader.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Every data/ shortcut was made by Explorer on the same machine: notepad as the target,
+    // no arguments, and an icon file in its folder's icons/, named as below
+    struct ReferenceLink {
+        const char* path;
+        const char* icon;
+    };
+    
+    const ReferenceLink REFERENCE_LINKS[] = {
+        {u8"DOS/Epic Pinball.lnk", u8"Epic Pinball.ico"},
+        {u8"DOS/Master of Orion II.lnk", u8"Master of Orion II.ico"},
+        {u8"DOS/Solar Winds.lnk", u8"Solar Winds.ico"},
+        {u8"DOS/Star Trek - Judgment Rites.lnk", u8"Star Trek - Judgment Rites.ico"},
+        {u8"DOS/Syndicate.lnk", u8"Syndicate.ico"},
+        {u8"DOS/X-Wing.lnk", u8"X-Wing.ico"},
+        {u8"DOS/Zone 66.lnk", u8"Zone 66.ico"},
+        {u8"GAMES/Alien Isolation.lnk", u8"Alien Isolation.ico"},
+        {u8"GAMES/Assassin's Creed Black Flag.lnk", u8"AC Black Flag.ico"},
+        {u8"GAMES/Assassin's Creed Odyssey.lnk", u8"AC Odyssey.ico"},
+        {u8"GAMES/Book of Hours.lnk", u8"Book of Hours.ico"},
+        {u8"GAMES/Carmageddon Max Damage.lnk", u8"Carmageddon - Max Damage.ico"},
+        {u8"GAMES/Chorus.lnk", u8"Chorus.ico"},
+        {u8"GAMES/Disco Elysium.lnk", u8"Disco Elysium.ico"},
+        {u8"GAMES/Dishonored 2.lnk", u8"Dishonored 2.ico"},
+        {u8"GAMES/Fallout 4.lnk", u8"Fallout 4.ico"},
+        {u8"GAMES/Fallout New Vegas.lnk", u8"Fallout - New Vegas.ico"},
+        {u8"GAMES/Heaven's Vault.lnk", u8"Heaven's Vault.ico"},
+        {u8"GAMES/Mafia II.lnk", u8"Mafia II.ico"},
+        {u8"GAMES/Outer Wilds.lnk", u8"Outer Wilds.ico"},
+        {u8"GAMES/Red Dead Redemption 2.lnk", u8"Red Dead Redemption 2.ico"},
+        {u8"GAMES/Uncharted 2.lnk", u8"Uncharted 2.ico"},
+        {u8"GAMES/Under The Waves.lnk", u8"Under The Waves.ico"},
+        {u8"GAMES/Watch_Dogs.lnk", u8"Watch_Dogs.ico"},
+        {u8"SWITCH/A Highland Song.lnk", u8"A Highland Song.ico"},
+        {u8"SWITCH/Donkey Kong Country - Tropical Freeze.lnk", u8"Donkey Kong Country - Tropical Freeze.ico"},
+        {u8"SWITCH/Mario Kart 8 Deluxe.lnk", u8"Mario Kart 8 Deluxe.ico"},
+        {u8"SWITCH/Mario Tennis Aces.lnk", u8"Mario Tennis Aces.ico"},
+        {u8"SWITCH/New Super Mario Bros. U Deluxe.lnk", u8"New Super Mario Bros. U Deluxe.ico"},
+        {u8"SWITCH/Pokémon Legends - Arceus.lnk", u8"Pokémon Legends - Arceus.ico"},
+        {u8"SWITCH/Prince of Persia - The Lost Crown.lnk", u8"Prince of Persia - The Lost Crown.ico"},
+        {u8"SWITCH/Super Mario 3D World + Bowser's Fury.lnk", u8"Super Mario 3D World + Bowser's Fury.ico"},
+        {u8"SWITCH/Super Mario Bros. Wonder.lnk", u8"Super Mario Bros. Wonder.ico"},
+        {u8"SWITCH/Super Mario Galaxy 2.lnk", u8"Super Mario Galaxy 2.ico"},
+        {u8"SWITCH/Super Mario Galaxy.lnk", u8"Super Mario Galaxy.ico"},
+        {u8"SWITCH/Super Mario Party Jamboree.lnk", u8"Super Mario Party Jamboree.ico"},
+        {u8"SWITCH/The Legend of Zelda - Breath of the Wild.lnk", u8"The Legend of Zelda - Breath of the Wilds.ico"},
+        {u8"SWITCH/The Legend of Zelda - Tears of the Kingdom.lnk", u8"The Legend of Zelda - Tears of the Kingdom.ico"},
+    };
+    
+    std::vector<uint8_t> ReadFile(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    
+    fs::path DataDir() {
+        return fs::path(TestRegistry::GetSourceDir()) / "data";
+    }
+    
+    std::vector<uint8_t> ReadLink(const ReferenceLink& reference) {
+        return ReadFile(fs::u8path(DataDir().u8string() + "/" + reference.path));
+    }
+    
+    // The strings compare as UTF-8, since the wide conversions of fs::path depend on the
+    // locale outside Windows. Shortcut strings here are all in the BMP.
+    std::string ToUtf8(const LnkString& text) {
+        std::string utf8;
+        for (wchar_t c : text.ToWString()) {
+            uint32_t code = static_cast<uint32_t>(c);
+            if (code < 0x80) {
+                utf8 += static_cast<char>(code);
+            } else if (code < 0x800) {
+                utf8 += static_cast<char>(0xC0 | (code >> 6));
+                utf8 += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                utf8 += static_cast<char>(0xE0 | (code >> 12));
+                utf8 += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                utf8 += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+        return utf8;
+    }
+    
+    // Offset of a string's 16-bit count in the StringData section
+    size_t CountOffset(const std::vector<uint8_t>& data, const LnkString& text) {
+        return static_cast<size_t>(text.data - data.data()) - 2;
+    }
+    
+    // Where StringData ends: everything after it is ExtraData, which is optional
+    size_t StringDataEnd(const std::vector<uint8_t>& data, const LnkString& last) {
+        return static_cast<size_t>(last.data - data.data()) + last.length * (last.unicode ? 2 : 1);
+    }
+    
+    void PutLe16(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+    
+    void PutLe32(std::vector<uint8_t>& out, uint32_t value) {
+        PutLe16(out, value & 0xFFFF);
+        PutLe16(out, value >> 16);
+    }
+    
+    void SetLe32(std::vector<uint8_t>& data, size_t offset, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            data[offset + i] = static_cast<uint8_t>(value >> (i * 8));
+        }
+    }
+    
+    void PutAnsiString(std::vector<uint8_t>& out, const char* text) {
+        PutLe16(out, static_cast<uint32_t>(std::strlen(text)));
+        out.insert(out.end(), text, text + std::strlen(text));
+    }
+    
+    // A link as older tools write it: no ID list, code page strings, a LinkInfo that
+    // splits the target into a local base path and a suffix, arguments and a negative
+    // icon index, then an EnvironmentVariableDataBlock and the terminal block
+    std::vector<uint8_t> MakeAnsiLink() {
+        const uint32_t flags = ShellLinkReader::HAS_LINK_INFO | ShellLinkReader::HAS_NAME |
+                               ShellLinkReader::HAS_WORKING_DIR | ShellLinkReader::HAS_ARGUMENTS |
+                               ShellLinkReader::HAS_ICON_LOCATION | ShellLinkReader::HAS_EXP_STRING;
+        const uint8_t clsid[16] = {0x01, 0x14, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                   0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46};
+        std::vector<uint8_t> out;
+        PutLe32(out, 0x4C);
+        out.insert(out.end(), clsid, clsid + 16);
+        PutLe32(out, flags);
+        PutLe32(out, 0x20);                 // FILE_ATTRIBUTE_ARCHIVE
+        out.resize(0x34, 0);                // Creation, access and write times
+        PutLe32(out, 123456);
+        PutLe32(out, static_cast<uint32_t>(-3));
+        PutLe32(out, 3);                    // SW_SHOWMAXIMIZED
+        out.resize(0x4C, 0);
+        
+        // LinkInfo: 0x1C header, a 0x10 byte VolumeID, then the two strings
+        const char basePath[] = "D:\\Games\\Pok\xE9mon\\";
+        const char suffix[] = "game.exe";
+        uint32_t volumeIdOffset = 0x1C;
+        uint32_t basePathOffset = volumeIdOffset + 0x10;
+        uint32_t suffixOffset = basePathOffset + sizeof(basePath);
+        uint32_t linkInfoSize = suffixOffset + sizeof(suffix);
+        PutLe32(out, linkInfoSize);
+        PutLe32(out, 0x1C);
+        PutLe32(out, 1);                    // VolumeIDAndLocalBasePath
+        PutLe32(out, volumeIdOffset);
+        PutLe32(out, basePathOffset);
+        PutLe32(out, 0);
+        PutLe32(out, suffixOffset);
+        PutLe32(out, 0x10);
+        PutLe32(out, 3);                    // DRIVE_FIXED
+        PutLe32(out, 0x1234ABCD);
+        PutLe32(out, 0x10);
+        out.insert(out.end(), basePath, basePath + sizeof(basePath));
+        out.insert(out.end(), suffix, suffix + sizeof(suffix));
+        
+        PutAnsiString(out, "Play the game");
+        PutAnsiString(out, "D:\\Games\\Pok\xE9mon");
+        PutAnsiString(out, "-fullscreen -w 1920");
+        PutAnsiString(out, "D:\\Games\\Pok\xE9mon\\game.exe");
+        
+        // EnvironmentVariableDataBlock with only the ANSI target filled in
+        const char target[] = "%GAMES%\\Pok\xE9mon\\game.exe";
+        PutLe32(out, 0x314);
+        PutLe32(out, 0xA0000001);
+        size_t block = out.size();
+        out.resize(block + 260 + 520, 0);
+        std::memcpy(out.data() + block, target, sizeof(target));
+        PutLe32(out, 0);
+        return out;
+    }
+}
+
+TEST_CASE(ShellLinkReader, ParsesTheDataShortcuts) {
+    int count = 0;
+    for (const ReferenceLink& reference : REFERENCE_LINKS) {
+        std::vector<uint8_t> data = ReadLink(reference);
+        REQUIRE(!data.empty());
+        ShellLinkData link;
+        if (!ShellLinkReader::Parse(data.data(), data.size(), link)) {
+            TestRegistry::Fail(__FILE__, __LINE__, std::string("failed to parse ") + reference.path);
+            continue;
+        }
+        std::string folder(reference.path, std::strchr(reference.path, '/'));
+        std::string iconTail = "\\dev\\GameLauncher\\data\\" + folder + "\\icons\\" + reference.icon;
+        
+        // The target, as ShortcutParser puts it together from LinkInfo
+        CHECK(ToUtf8(link.localBasePath) + ToUtf8(link.commonPathSuffix) == std::string("C:\\Windows\\notepad.exe"));
+        CHECK(ToUtf8(link.relativePath) == std::string("..\\..\\..\\..\\Windows\\notepad.exe"));
+        CHECK(ToUtf8(link.workingDirectory) == std::string("C:\\Windows"));
+        CHECK(link.netName.empty());
+        CHECK(link.name.empty());
+        CHECK(link.arguments.empty());
+        CHECK(!(link.linkFlags & ShellLinkReader::HAS_ARGUMENTS));
+        CHECK(link.environmentTarget.empty());
+        
+        // The icon location and its unexpanded form, which ShortcutParser prefers
+        CHECK(link.iconLocation.unicode);
+        CHECK(ToUtf8(link.iconLocation) == "C:" + iconTail);
+        CHECK(link.linkFlags & ShellLinkReader::HAS_EXP_ICON);
+        CHECK(ToUtf8(link.iconEnvironmentPath) == "%SystemDrive%" + iconTail);
+        CHECK_EQ(link.iconIndex, 0);
+        CHECK(fs::exists(fs::u8path(DataDir().u8string() + "/" + folder + "/icons/" + reference.icon)));
+        count++;
+    }
+    
+    // Every shortcut in data/ is in the table above
+    int onDisk = 0;
+    for (const auto& folder : fs::directory_iterator(DataDir())) {
+        for (const auto& entry : fs::directory_iterator(folder.path())) {
+            onDisk += entry.path().extension() == ".lnk";
+        }
+    }
+    CHECK_EQ(count, onDisk);
+    CHECK_EQ(onDisk, static_cast<int>(std::size(REFERENCE_LINKS)));
+}
+
+TEST_CASE(ShellLinkReader, ParsesAnAnsiLink) {
+    std::vector<uint8_t> data = MakeAnsiLink();
+    ShellLinkData link;
+    REQUIRE(ShellLinkReader::Parse(data.data(), data.size(), link));
+    CHECK_EQ(link.fileAttributes, 0x20u);
+    CHECK_EQ(link.fileSize, 123456u);
+    CHECK_EQ(link.iconIndex, -3);
+    CHECK_EQ(link.showCommand, 3u);
+    
+    // Code page bytes widen as Latin-1
+    CHECK(!link.localBasePath.unicode);
+    CHECK(link.localBasePath.ToWString() + link.commonPathSuffix.ToWString() == L"D:\\Games\\Pok\u00E9mon\\game.exe");
+    CHECK(link.name.ToWString() == L"Play the game");
+    CHECK(link.workingDirectory.ToWString() == L"D:\\Games\\Pok\u00E9mon");
+    CHECK(link.arguments.ToWString() == L"-fullscreen -w 1920");
+    CHECK(link.iconLocation.ToWString() == L"D:\\Games\\Pok\u00E9mon\\game.exe");
+    CHECK(link.relativePath.empty());
+    CHECK(link.environmentTarget.ToWString() == L"%GAMES%\\Pok\u00E9mon\\game.exe");
+    CHECK(link.iconEnvironmentPath.empty());
+}
+
+TEST_CASE(ShellLinkReader, RejectsTruncatedLinks) {
+    // Cut anywhere before the end of StringData the link is refused; after it only
+    // ExtraData is lost, and the strings read the same as from the whole file
+    // ExtraData is optional. Epic Pinball, Pokemon (a non-ASCII path) and the ANSI link
+    std::vector<std::vector<uint8_t>> links = {ReadLink(REFERENCE_LINKS[0]), ReadLink(REFERENCE_LINKS[29]),
+                                               MakeAnsiLink()};
+    for (const std::vector<uint8_t>& data : links) {
+        ShellLinkData whole;
+        REQUIRE(ShellLinkReader::Parse(data.data(), data.size(), whole));
+        size_t end = StringDataEnd(data, whole.iconLocation);
+        CHECK(end < data.size());
+        
+        int accepted = 0;
+        int rejected = 0;
+        int differences = 0;
+        for (size_t size = 0; size < data.size(); size++) {
+            std::vector<uint8_t> truncated(data.begin(), data.begin() + size);
+            ShellLinkData link;
+            if (ShellLinkReader::Parse(truncated.data(), truncated.size(), link)) {
+                accepted += size < end;
+                differences += link.iconLocation.ToWString() != whole.iconLocation.ToWString() ||
+                               link.arguments.ToWString() != whole.arguments.ToWString() ||
+                               link.localBasePath.ToWString() != whole.localBasePath.ToWString();
+            } else {
+                rejected += size >= end;
+            }
+        }
+        CHECK_EQ(accepted, 0);
+        CHECK_EQ(rejected, 0);
+        CHECK_EQ(differences, 0);
+    }
+    
+    ShellLinkData link;
+    CHECK(!ShellLinkReader::Parse(nullptr, 0, link));
+}
+
+TEST_CASE(ShellLinkReader, RejectsCorruptedBlocks) {
+    std::vector<uint8_t> data = ReadLink(REFERENCE_LINKS[7]);
+    ShellLinkData whole;
+    REQUIRE(ShellLinkReader::Parse(data.data(), data.size(), whole));
+    ShellLinkData link;
+    
+    // Header: its size field and every byte of the CLSID are checked
+    std::vector<uint8_t> damaged = data;
+    damaged[0] = 0x4D;
+    CHECK(!ShellLinkReader::Parse(damaged.data(), damaged.size(), link));
+    for (size_t i = 4; i < 20; i++) {
+        damaged = data;
+        damaged[i] ^= 0x10;
+        CHECK(!ShellLinkReader::Parse(damaged.data(), damaged.size(), link));
+    }
+    
+    // An ID list that claims the rest of the file leaves no room for LinkInfo
+    damaged = data;
+    damaged[0x4C] = 0xFF;
+    damaged[0x4D] = 0xFF;
+    CHECK(!ShellLinkReader::Parse(damaged.data(), damaged.size(), link));
+    
+    // LinkInfo sizes past the end, below its own size field and below its header
+    size_t linkInfo = 0x4C + 2 + (data[0x4C] | (data[0x4D] << 8));
+    const uint32_t badSizes[] = {static_cast<uint32_t>(data.size() - linkInfo + 1), 0xFFFFFFF0u, 0, 3, 0x10};
+    for (uint32_t size : badSizes) {
+        damaged = data;
+        SetLe32(damaged, linkInfo, size);
+        CHECK(!ShellLinkReader::Parse(damaged.data(), damaged.size(), link));
+    }
+    
+    // String offsets outside LinkInfo read as empty rather than past it
+    damaged = data;
+    SetLe32(damaged, linkInfo + 16, 0x00FFFFFF);
+    REQUIRE(ShellLinkReader::Parse(damaged.data(), damaged.size(), link));
+    CHECK(link.localBasePath.empty());
+    
+    // StringData: each count running past the end is refused
+    const LnkString* strings[] = {&whole.relativePath, &whole.workingDirectory, &whole.iconLocation};
+    for (const LnkString* text : strings) {
+        damaged = data;
+        size_t offset = CountOffset(data, *text);
+        damaged[offset] = 0xFF;
+        damaged[offset + 1] = 0xFF;
+        CHECK(!ShellLinkReader::Parse(damaged.data(), damaged.size(), link));
+    }
+    
+    // A broken ExtraData block is skipped, not fatal
+    damaged = data;
+    SetLe32(damaged, StringDataEnd(data, whole.iconLocation), 0x7FFFFFFF);
+    REQUIRE(ShellLinkReader::Parse(damaged.data(), damaged.size(), link));
+    CHECK(link.iconEnvironmentPath.empty());
+    CHECK(link.iconLocation.ToWString() == whole.iconLocation.ToWString());
+}
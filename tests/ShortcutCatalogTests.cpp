@@ -0,0 +1,213 @@
+// ShortcutCatalogTests.cpp - Catalog round trips and rejection of damaged files
+#include "TestFramework.h"
+#include "ShortcutCatalog.h"
+#include <random>
+
+namespace {
+    struct TestTab {
+        std::wstring name;
+        std::wstring folderPath;
+        std::vector<CatalogShortcut> shortcuts;
+    };
+    
+    CatalogShortcut MakeShortcut(int n) {
+        CatalogShortcut shortcut;
+        shortcut.shortcutPath = L"C:\\Games\\Data\\Tab\\Game " + std::to_wstring(n) + L".lnk";
+        shortcut.displayName = L"Game " + std::to_wstring(n);
+        shortcut.targetPath = L"D:\\Games\\Game" + std::to_wstring(n) + L"\\game.exe";
+        shortcut.arguments = n % 3 == 0 ? L"-fullscreen -w 1920" : L"";
+        shortcut.workingDirectory = L"D:\\Games\\Game" + std::to_wstring(n);
+        shortcut.iconPath = n % 2 == 0 ? L"C:\\Games\\Data\\Tab\\icons\\Game.ico" : L"";
+        shortcut.iconIndex = n % 5 - 2;
+        shortcut.isValid = n % 4 != 1;
+        shortcut.fileSize = 1000 + n;
+        shortcut.lastWriteTime = 0x01D9ABCD00000000ULL + n;
+        shortcut.contentHash = 0xCBF29CE484222325ULL * (n + 1);
+        return shortcut;
+    }
+    
+    std::vector<TestTab> MakeModel() {
+        std::vector<TestTab> model(4);
+        model[0].name = L"GAMES";
+        model[0].folderPath = L"C:\\Games\\Data\\GAMES";
+        for (int i = 0; i < 20; i++) {
+            model[0].shortcuts.push_back(MakeShortcut(i));
+        }
+        
+        // Non-ASCII names, including a surrogate pair, and an empty tab in the middle
+        model[1].name = L"Pok\u00E9mon \u30B2\u30FC\u30E0 \xD83C\xDFAE";
+        model[1].folderPath = L"C:\\Games\\Data\\Pok\u00E9mon";
+        CatalogShortcut unicode = MakeShortcut(100);
+        unicode.displayName = L"Pok\u00E9mon Legends - Arceus";
+        model[1].shortcuts.push_back(unicode);
+        
+        model[2].name = L"EMPTY";
+        model[2].folderPath = L"C:\\Games\\Data\\EMPTY";
+        
+        model[3].name = L"DOS";
+        model[3].folderPath = L"";
+        CatalogShortcut blank;
+        model[3].shortcuts.push_back(blank);
+        return model;
+    }
+    
+    std::vector<uint8_t> Write(const std::vector<TestTab>& model) {
+        CatalogWriter writer;
+        for (const TestTab& tab : model) {
+            writer.AddTab(tab.name, tab.folderPath);
+            for (const CatalogShortcut& shortcut : tab.shortcuts) {
+                writer.AddShortcut(shortcut);
+            }
+        }
+        return writer.Finish();
+    }
+    
+    void CheckShortcut(const CatalogShortcutView& view, const CatalogShortcut& expected) {
+        CHECK(view.shortcutPath.ToWString() == expected.shortcutPath);
+        CHECK(view.displayName.ToWString() == expected.displayName);
+        CHECK(view.targetPath.ToWString() == expected.targetPath);
+        CHECK(view.arguments.ToWString() == expected.arguments);
+        CHECK(view.workingDirectory.ToWString() == expected.workingDirectory);
+        CHECK(view.iconPath.ToWString() == expected.iconPath);
+        CHECK_EQ(view.iconIndex, expected.iconIndex);
+        CHECK_EQ(view.isValid, expected.isValid);
+        CHECK_EQ(view.fileSize, expected.fileSize);
+        CHECK_EQ(view.lastWriteTime, expected.lastWriteTime);
+        CHECK_EQ(view.contentHash, expected.contentHash);
+    }
+    
+    void CheckModel(const ShortcutCatalog& catalog, const std::vector<TestTab>& model) {
+        REQUIRE(catalog.GetTabCount() == model.size());
+        uint32_t next = 0;
+        for (uint32_t t = 0; t < model.size(); t++) {
+            CatalogTabView tab = catalog.GetTab(t);
+            CHECK(tab.name.ToWString() == model[t].name);
+            CHECK(tab.folderPath.ToWString() == model[t].folderPath);
+            CHECK_EQ(tab.firstShortcut, next);
+            REQUIRE(tab.shortcutCount == model[t].shortcuts.size());
+            for (uint32_t i = 0; i < tab.shortcutCount; i++) {
+                CheckShortcut(catalog.GetShortcut(tab.firstShortcut + i), model[t].shortcuts[i]);
+            }
+            next += tab.shortcutCount;
+        }
+        CHECK_EQ(catalog.GetShortcutCount(), next);
+    }
+}
+
+TEST_CASE(ShortcutCatalog, RoundTrip) {
+    std::vector<TestTab> model = MakeModel();
+    std::vector<uint8_t> file = Write(model);
+    CHECK_EQ(file.size() % 8, 0u);
+    
+    ShortcutCatalog catalog;
+    REQUIRE(catalog.Open(file.data(), file.size()));
+    CHECK(catalog.IsOpen());
+    CheckModel(catalog, model);
+}
+
+TEST_CASE(ShortcutCatalog, EmptyCatalog) {
+    std::vector<uint8_t> file = CatalogWriter().Finish();
+    ShortcutCatalog catalog;
+    REQUIRE(catalog.Open(file.data(), file.size()));
+    CHECK_EQ(catalog.GetTabCount(), 0u);
+    CHECK_EQ(catalog.GetShortcutCount(), 0u);
+}
+
+TEST_CASE(ShortcutCatalog, UnalignedBuffer) {
+    // Fields are read byte-wise, so a catalog at an odd address reads the same
+    std::vector<TestTab> model = MakeModel();
+    std::vector<uint8_t> file = Write(model);
+    std::vector<uint8_t> shifted(file.size() + 1);
+    std::copy(file.begin(), file.end(), shifted.begin() + 1);
+    
+    ShortcutCatalog catalog;
+    REQUIRE(catalog.Open(shifted.data() + 1, file.size()));
+    CheckModel(catalog, model);
+}
+
+TEST_CASE(ShortcutCatalog, StringsAreStoredOnce) {
+    std::vector<TestTab> same(1);
+    std::vector<TestTab> distinct(1);
+    for (int i = 0; i < 100; i++) {
+        same[0].shortcuts.push_back(MakeShortcut(7));
+        distinct[0].shortcuts.push_back(MakeShortcut(i));
+    }
+    size_t sameSize = Write(same).size();
+    size_t distinctSize = Write(distinct).size();
+    
+    // 100 records either way; only the distinct strings grow the table
+    CHECK(sameSize + 50 * 2 * 40 < distinctSize);
+}
+
+TEST_CASE(ShortcutCatalog, AccessorsOutOfRange) {
+    std::vector<uint8_t> file = Write(MakeModel());
+    ShortcutCatalog catalog;
+    REQUIRE(catalog.Open(file.data(), file.size()));
+    CHECK(catalog.GetTab(catalog.GetTabCount()).name.empty());
+    CHECK(catalog.GetShortcut(catalog.GetShortcutCount()).shortcutPath.empty());
+    
+    ShortcutCatalog closed;
+    CHECK(!closed.IsOpen());
+    CHECK(closed.GetTab(0).name.empty());
+}
+
+TEST_CASE(ShortcutCatalog, RejectsEveryFlippedByte) {
+    std::vector<uint8_t> file = Write(MakeModel());
+    for (size_t i = 0; i < file.size(); i++) {
+        for (uint8_t mask : {0x01, 0x80}) {
+            std::vector<uint8_t> damaged = file;
+            damaged[i] ^= mask;
+            ShortcutCatalog catalog;
+            if (catalog.Open(damaged.data(), damaged.size())) {
+                TestRegistry::Fail(__FILE__, __LINE__, "accepted a flip at byte " + std::to_string(i));
+            }
+            CHECK(!catalog.IsOpen());
+        }
+    }
+}
+
+TEST_CASE(ShortcutCatalog, RejectsTruncationAndPadding) {
+    std::vector<uint8_t> file = Write(MakeModel());
+    for (size_t size = 0; size < file.size(); size++) {
+        ShortcutCatalog catalog;
+        CHECK(!catalog.Open(file.data(), size));
+    }
+    
+    std::vector<uint8_t> padded = file;
+    padded.resize(file.size() + 8);
+    ShortcutCatalog catalog;
+    CHECK(!catalog.Open(padded.data(), padded.size()));
+    CHECK(!catalog.Open(nullptr, 0));
+}
+
+TEST_CASE(ShortcutCatalog, RejectsOtherVersions) {
+    std::vector<uint8_t> file = Write(MakeModel());
+    
+    // An older or newer layout is never read as this one
+    std::vector<uint8_t> older = file;
+    older[4] = static_cast<uint8_t>(ShortcutCatalog::VERSION - 1);
+    ShortcutCatalog catalog;
+    CHECK(!catalog.Open(older.data(), older.size()));
+    
+    std::vector<uint8_t> wrongMagic = file;
+    wrongMagic[0] = 'X';
+    CHECK(!catalog.Open(wrongMagic.data(), wrongMagic.size()));
+}
+
+TEST_CASE(ShortcutCatalog, SurvivesRandomDamage) {
+    // Damage that keeps the header plausible must be rejected by the checksum or the
+    // reference checks, never read out of bounds
+    std::vector<uint8_t> file = Write(MakeModel());
+    std::mt19937 random(1234);
+    for (int round = 0; round < 2000; round++) {
+        std::vector<uint8_t> damaged = file;
+        int flips = 1 + random() % 8;
+        for (int i = 0; i < flips; i++) {
+            damaged[random() % damaged.size()] = static_cast<uint8_t>(random());
+        }
+        ShortcutCatalog catalog;
+        if (damaged != file) {
+            CHECK(!catalog.Open(damaged.data(), damaged.size()));
+        }
+    }
+}
@@ -0,0 +1,123 @@
+// SpscRingTests.cpp - Queue semantics and a producer/consumer stress run on real threads
+#include "TestFramework.h"
+#include "SpscRing.h"
+#include "InputEvent.h"
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace {
+    // Every field derived from the sequence number, so a torn or stale slot shows up as
+    // a field that doesn't match the others
+    InputEvent MakeEvent(int64_t sequence) {
+        InputEvent event;
+        event.time = sequence;
+        event.type = static_cast<InputEventType>(sequence % 4);
+        event.button = static_cast<uint16_t>(sequence * 7);
+        event.dx = static_cast<int8_t>(sequence);
+        event.dy = static_cast<int8_t>(~sequence);
+        return event;
+    }
+    
+    bool Matches(const InputEvent& event, int64_t sequence) {
+        InputEvent expected = MakeEvent(sequence);
+        return event.time == expected.time && event.type == expected.type && event.button == expected.button &&
+               event.dx == expected.dx && event.dy == expected.dy;
+    }
+    
+    // The producer pushes count events, the consumer pops them on this thread. Either
+    // side yields when the ring is full or empty, which on a small ring is most of the
+    // time, so the indices wrap and the cached copies run out constantly.
+    template <size_t Capacity>
+    void RunProducerConsumer(int64_t count) {
+        std::unique_ptr<SpscRing<InputEvent, Capacity>> ring(new SpscRing<InputEvent, Capacity>());
+        int64_t fullCount = 0;
+        std::thread producer([&]() {
+            for (int64_t sequence = 0; sequence < count; sequence++) {
+                while (!ring->TryPush(MakeEvent(sequence))) {
+                    fullCount++;
+                    std::this_thread::yield();
+                }
+            }
+        });
+        
+        int64_t received = 0;
+        int64_t outOfOrder = 0;
+        InputEvent event;
+        while (received < count) {
+            if (!ring->TryPop(event)) {
+                std::this_thread::yield();
+                continue;
+            }
+            outOfOrder += !Matches(event, received);
+            received++;
+        }
+        producer.join();
+        
+        CHECK_EQ(received, count);
+        CHECK_EQ(outOfOrder, 0);
+        CHECK(!ring->TryPop(event));
+        CHECK_EQ(ring->GetSize(), 0u);
+        if (Capacity <= 8) {
+            CHECK(fullCount > 0);       // The full path really was exercised
+        }
+    }
+}
+
+TEST_CASE(SpscRing, FirstInFirstOut) {
+    SpscRing<InputEvent, 4> ring;
+    InputEvent event;
+    CHECK(!ring.TryPop(event));
+    CHECK_EQ(ring.GetSize(), 0u);
+    CHECK_EQ(ring.GetCapacity(), 4u);
+    
+    // Fill to capacity; one more is refused and the ring is unchanged
+    for (int i = 0; i < 4; i++) {
+        CHECK(ring.TryPush(MakeEvent(i)));
+    }
+    CHECK(!ring.TryPush(MakeEvent(99)));
+    CHECK_EQ(ring.GetSize(), 4u);
+    
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(ring.TryPop(event));
+        CHECK(Matches(event, i));
+    }
+    CHECK(!ring.TryPop(event));
+}
+
+TEST_CASE(SpscRing, WrapsAround) {
+    // Interleaved pushes and pops walk the indices far past the capacity
+    SpscRing<InputEvent, 8> ring;
+    int64_t pushed = 0;
+    int64_t popped = 0;
+    InputEvent event;
+    for (int round = 0; round < 1000; round++) {
+        int pushes = round % 9;
+        for (int i = 0; i < pushes; i++) {
+            if (ring.TryPush(MakeEvent(pushed))) {
+                pushed++;
+            }
+        }
+        CHECK(ring.GetSize() <= 8u);
+        CHECK_EQ(static_cast<int64_t>(ring.GetSize()), pushed - popped);
+        int pops = (round * 5) % 7;
+        for (int i = 0; i < pops && ring.TryPop(event); i++) {
+            CHECK(Matches(event, popped));
+            popped++;
+        }
+    }
+    while (ring.TryPop(event)) {
+        CHECK(Matches(event, popped));
+        popped++;
+    }
+    CHECK_EQ(popped, pushed);
+    CHECK(pushed > 1000);
+}
+
+TEST_CASE(SpscRing, ProducerConsumerStress) {
+    // A tiny ring keeps both sides at the full and empty edges; the input thread's
+    // size lets the producer run ahead in bursts
+    RunProducerConsumer<2>(200000);
+    RunProducerConsumer<8>(500000);
+    RunProducerConsumer<256>(2000000);
+}
@@ -0,0 +1,64 @@
+// TestFramework.h - Self-registering test cases for the portable modules (no dependencies)
+#pragma once
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// A test is a function registered under a suite name. CHECK records a failure and
+// carries on; REQUIRE stops the test, for when the rest of it would not make sense.
+struct TestCase {
+    const char* suite;
+    const char* name;
+    void (*run)();
+};
+
+class TestRegistry {
+public:
+    static std::vector<TestCase>& GetTests();
+    static int Register(const char* suite, const char* name, void (*run)());
+    
+    // Record a failure of the test that is running
+    static void Fail(const char* file, int line, const std::string& message);
+    
+    // Directory of the source tree, for tests that read files from data/
+    static std::string GetSourceDir();
+};
+
+// Thrown by REQUIRE to leave the failing test
+struct TestAbort {};
+
+template <typename A, typename B>
+std::string DescribeMismatch(const char* expression, const A& actual, const B& expected) {
+    std::ostringstream text;
+    text << expression << " (" << +actual << " vs " << +expected << ")";
+    return text.str();
+}
+
+#define TEST_CASE(suite, name) \
+    static void suite##_##name(); \
+    static const int suite##_##name##_registered = TestRegistry::Register(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+
+#define CHECK(expression) \
+    do { \
+        if (!(expression)) { \
+            TestRegistry::Fail(__FILE__, __LINE__, #expression); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        if (!((actual) == (expected))) { \
+            TestRegistry::Fail(__FILE__, __LINE__, DescribeMismatch(#actual " == " #expected, (actual), (expected))); \
+        } \
+    } while (0)
+
+#define REQUIRE(expression) \
+    do { \
+        if (!(expression)) { \
+            TestRegistry::Fail(__FILE__, __LINE__, #expression); \
+            throw TestAbort(); \
+        } \
+    } while (0)
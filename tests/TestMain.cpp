@@ -0,0 +1,67 @@
+// TestMain.cpp - Runs the registered tests, optionally only some suites
+//
+// Usage: launcher_tests [suite...]
+// Exits with 1 if any test failed.
+#include "TestFramework.h"
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+#ifndef LAUNCHER_SOURCE_DIR
+#define LAUNCHER_SOURCE_DIR "."
+#endif
+
+namespace {
+    int failures = 0;   // Failures of the running test
+}
+
+std::vector<TestCase>& TestRegistry::GetTests() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+int TestRegistry::Register(const char* suite, const char* name, void (*run)()) {
+    GetTests().push_back({suite, name, run});
+    return 0;
+}
+
+void TestRegistry::Fail(const char* file, int line, const std::string& message) {
+    std::printf("  %s:%d: %s\n", file, line, message.c_str());
+    failures++;
+}
+
+std::string TestRegistry::GetSourceDir() {
+    return LAUNCHER_SOURCE_DIR;
+}
+
+int main(int argc, char* argv[]) {
+    int run = 0;
+    int failed = 0;
+    
+    for (const TestCase& test : TestRegistry::GetTests()) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc && !selected; i++) {
+            selected = std::strcmp(argv[i], test.suite) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+        
+        failures = 0;
+        try {
+            test.run();
+        } catch (const TestAbort&) {
+        } catch (const std::exception& error) {
+            TestRegistry::Fail(__FILE__, __LINE__, std::string("exception: ") + error.what());
+        }
+        
+        run++;
+        if (failures > 0) {
+            failed++;
+        }
+        std::printf("%s %s.%s\n", failures > 0 ? "FAIL" : "ok  ", test.suite, test.name);
+    }
+    
+    std::printf("%d tests, %d failed\n", run, failed);
+    return run > 0 && failed == 0 ? 0 : 1;
+}
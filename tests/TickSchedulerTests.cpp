@@ -0,0 +1,176 @@
+// TickSchedulerTests.cpp - Tick deadlines, dropped ticks and wakeup counting on a fake clock
+#include "TestFramework.h"
+#include "TickScheduler.h"
+#include <vector>
+
+namespace {
+    const int64_t SECOND = TickScheduler::MICROSECONDS_PER_SECOND;
+    
+    // Microseconds that only move when the test says so
+    struct FakeClock {
+        int64_t now = 0;
+        void Advance(int64_t microseconds) { now += microseconds; }
+    };
+    
+    // Deadline of tick index counted from start, computed apart from the scheduler
+    int64_t ExpectedDeadline(int64_t start, int64_t index, int rate) {
+        int64_t exact = index * SECOND;
+        return start + exact / rate + (exact % rate != 0);
+    }
+}
+
+TEST_CASE(TickScheduler, FirstTickIsDueAtStart) {
+    FakeClock clock;
+    TickScheduler scheduler(120);
+    CHECK(!scheduler.IsRunning());
+    CHECK_EQ(scheduler.GetTimeout(clock.now), -1);
+    CHECK(!scheduler.Tick(clock.now));
+    
+    clock.now = 5000;
+    scheduler.Start(clock.now);
+    CHECK_EQ(scheduler.GetTimeout(clock.now), 0);
+    REQUIRE(scheduler.Tick(clock.now));
+    CHECK_EQ(scheduler.GetLastLateness(), 0);
+    
+    // The next one is a period later, rounded up to the microsecond; nothing is due before it
+    CHECK_EQ(scheduler.GetDeadline(), 5000 + 8334);
+    CHECK_EQ(scheduler.GetTimeout(clock.now), 8334);
+    clock.Advance(8333);
+    CHECK_EQ(scheduler.GetTimeout(clock.now), 1);
+    CHECK(!scheduler.Tick(clock.now));
+    clock.Advance(1);
+    CHECK(scheduler.Tick(clock.now));
+    CHECK_EQ(scheduler.GetMissedTicks(), 0);
+    
+    // Stopped, nothing is due and the wait has no limit
+    scheduler.Stop();
+    clock.Advance(SECOND);
+    CHECK(!scheduler.Tick(clock.now));
+    CHECK_EQ(scheduler.GetTimeout(clock.now), -1);
+}
+
+TEST_CASE(TickScheduler, DeadlinesDoNotDrift) {
+    // Waking up to most of a period late each time leaves the schedule where it was:
+    // ten seconds at 120 Hz are 1200 ticks, each due on its own deadline
+    FakeClock clock;
+    clock.now = 1000000007;
+    int64_t start = clock.now;
+    TickScheduler scheduler(120);
+    scheduler.Start(start);
+    
+    int ticks = 0;
+    int offSchedule = 0;
+    int wrongLateness = 0;
+    while (scheduler.GetDeadline() < start + 10 * SECOND) {
+        int64_t late = (ticks * 2711) % 8000;
+        int64_t deadline = scheduler.GetDeadline();
+        offSchedule += deadline != ExpectedDeadline(start, ticks, 120);
+        clock.now = deadline + late;
+        REQUIRE(scheduler.Tick(clock.now));
+        wrongLateness += scheduler.GetLastLateness() != late;
+        ticks++;
+    }
+    CHECK_EQ(ticks, 1200);
+    CHECK_EQ(offSchedule, 0);
+    CHECK_EQ(wrongLateness, 0);
+    CHECK_EQ(scheduler.GetMissedTicks(), 0);
+    
+    // A rate that doesn't divide a second still lands on the second
+    TickScheduler thirds(3);
+    thirds.Start(0);
+    std::vector<int64_t> deadlines;
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(thirds.Tick(thirds.GetDeadline()));
+        deadlines.push_back(thirds.GetDeadline());
+    }
+    CHECK_EQ(deadlines[0], 333334);
+    CHECK_EQ(deadlines[1], 666667);
+    CHECK_EQ(deadlines[2], SECOND);
+}
+
+TEST_CASE(TickScheduler, DropsTicksMissedByMoreThanAPeriod) {
+    FakeClock clock;
+    TickScheduler scheduler(100);
+    scheduler.Start(clock.now);
+    REQUIRE(scheduler.Tick(clock.now));
+    
+    // A 35 ms stall runs the tick due at 10 ms once, late, and drops those due at 20 and 30
+    clock.now = 35000;
+    REQUIRE(scheduler.Tick(clock.now));
+    CHECK_EQ(scheduler.GetLastLateness(), 25000);
+    CHECK_EQ(scheduler.GetMissedTicks(), 2);
+    CHECK_EQ(scheduler.GetDeadline(), 40000);
+    CHECK(!scheduler.Tick(clock.now));
+    
+    // Back on the original schedule afterwards
+    clock.now = 40000;
+    REQUIRE(scheduler.Tick(clock.now));
+    CHECK_EQ(scheduler.GetLastLateness(), 0);
+    CHECK_EQ(scheduler.GetDeadline(), 50000);
+    
+    // Late by exactly one period: the tick due now is dropped in favour of the late one
+    clock.now = 60000;
+    REQUIRE(scheduler.Tick(clock.now));
+    CHECK_EQ(scheduler.GetMissedTicks(), 3);
+    CHECK_EQ(scheduler.GetDeadline(), 70000);
+    
+    // Run and dropped ticks together account for every period, however the stalls fall
+    int ticks = 0;
+    for (int i = 1; i <= 500; i++) {
+        clock.now = 70000 + i * 7919;
+        ticks += scheduler.Tick(clock.now);
+    }
+    int64_t periodsStarted = clock.now / 10000 + 1;
+    CHECK_EQ(ticks + 4 + scheduler.GetMissedTicks(), periodsStarted);
+    CHECK(scheduler.GetDeadline() > clock.now);
+    CHECK(scheduler.GetDeadline() - clock.now <= 10000);
+}
+
+TEST_CASE(TickScheduler, RestartAndRate) {
+    FakeClock clock;
+    TickScheduler scheduler(60);
+    scheduler.Start(clock.now);
+    scheduler.Tick(clock.now);
+    
+    // Start counts the deadlines from the new start, at the new rate
+    clock.now = 123456;
+    scheduler.SetRate(250);
+    scheduler.Start(clock.now);
+    CHECK_EQ(scheduler.GetTimeout(clock.now), 0);
+    REQUIRE(scheduler.Tick(clock.now));
+    CHECK_EQ(scheduler.GetDeadline(), 123456 + 4000);
+    
+    // Rates outside 1 tick a second to one a microsecond are clamped
+    scheduler.SetRate(0);
+    CHECK_EQ(scheduler.GetRate(), 1);
+    scheduler.SetRate(-50);
+    CHECK_EQ(scheduler.GetRate(), 1);
+    scheduler.SetRate(5000000);
+    CHECK_EQ(scheduler.GetRate(), 1000000);
+}
+
+TEST_CASE(TickScheduler, CountsWakeupsPerSecond) {
+    FakeClock clock;
+    TickScheduler scheduler;
+    CHECK_EQ(scheduler.GetWakeupsPerSecond(), 0.0);
+    
+    // Nothing is reported until a second has passed
+    for (int i = 0; i < 100; i++) {
+        scheduler.CountWakeup(clock.now);
+        clock.Advance(10000);
+    }
+    CHECK_EQ(scheduler.GetWakeupsPerSecond(), 0.0);
+    
+    // 100 wakeups in the next second, one every 10 ms
+    for (int i = 0; i < 100; i++) {
+        scheduler.CountWakeup(clock.now);
+        clock.Advance(10000);
+    }
+    scheduler.CountWakeup(clock.now);
+    CHECK_EQ(scheduler.GetWakeupsPerSecond(), 100.0);
+    
+    // One wakeup after four seconds asleep counts as a quarter a second
+    clock.Advance(4 * SECOND);
+    scheduler.CountWakeup(clock.now);
+    CHECK_EQ(scheduler.GetWakeupsPerSecond(), 0.25);
+}